@@ -0,0 +1,2 @@
+#define INSTANCING
+#include "ModelVS.hlsl"
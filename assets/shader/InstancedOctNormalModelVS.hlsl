@@ -0,0 +1,3 @@
+#define INSTANCING
+#define OCTAHEDRAL_NORMAL
+#include "ModelVS.hlsl"
@@ -3,7 +3,11 @@
 struct VSInput
 {
     float32_t4 pos : POSITION0;
+#ifdef OCTAHEDRAL_NORMAL
+    float32_t2 normal : NORMAL0;
+#else
     float32_t3 normal : NORMAL0;
+#endif
     float32_t2 uv : TEXCOORD0;
 };
 
@@ -14,14 +18,42 @@ struct TransformationMatrix
     float32_t4x4 mWorldInvTranspose;
 };
 
+#ifdef INSTANCING
+// per-instance transforms (the root SRV points at the first instance of the draw)
+StructuredBuffer<TransformationMatrix> gInstances : register(t1);
+#else
 ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+#endif
 
+#ifdef OCTAHEDRAL_NORMAL
+// octahedral normal
+float32_t3 DecodeOctahedral(float32_t2 e)
+{
+    float32_t3 n = float32_t3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+    float32_t t = saturate(-n.z);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return normalize(n);
+}
+#endif
+
+#ifdef INSTANCING
+VSOutput main(VSInput input, uint32_t instanceId : SV_InstanceID)
+{
+    TransformationMatrix gTransformationMatrix = gInstances[instanceId];
+#else
 VSOutput main(VSInput input)
 {
+#endif
     VSOutput output;
+#ifdef OCTAHEDRAL_NORMAL
+    float32_t3 normal = DecodeOctahedral(input.normal);
+#else
+    float32_t3 normal = input.normal;
+#endif
     output.wpos = mul(input.pos, gTransformationMatrix.mWorld).xyz;
     output.svpos = mul(input.pos, gTransformationMatrix.mWVP);
-    output.normal = normalize(mul(input.normal, (float32_t3x3) gTransformationMatrix.mWorldInvTranspose));
+    output.normal = normalize(mul(normal, (float32_t3x3) gTransformationMatrix.mWorldInvTranspose));
     output.uv = input.uv;
     return output;
 }
@@ -0,0 +1,2 @@
+#define OCTAHEDRAL_NORMAL
+#include "ModelVS.hlsl"
@@ -11,9 +11,19 @@ struct TransformationMatrix
     float32_t4x4 mWorldInvTranspose;
 };
 
+#ifdef INSTANCING
+// per-instance transforms (the root SRV points at the first instance of the draw)
+StructuredBuffer<TransformationMatrix> gInstances : register(t1);
+
+float32_t4 main(VSInput input, uint32_t instanceId : SV_InstanceID) : SV_POSITION0
+{
+    return mul(input.pos, gInstances[instanceId].mWVP);
+}
+#else
 ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
 
 float32_t4 main(VSInput input) : SV_POSITION0
 {
     return mul(input.pos, gTransformationMatrix.mWVP);
 }
+#endif
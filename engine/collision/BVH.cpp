@@ -0,0 +1,219 @@
+#include "BVH.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// 表面積
+float SurfaceArea( const AABB3D& aabb )
+{
+    auto e = aabb.mMax - aabb.mMin;
+    return 2.0f * ( e.x * e.y + e.y * e.z + e.z * e.x );
+}
+
+// AABBを合成
+void Merge( AABB3D& dst, const AABB3D& src )
+{
+    dst.Update( src.mMin );
+    dst.Update( src.mMax );
+}
+
+// 軸の成分を取得
+float GetAxis( const Vector3& v, uint32_t axis )
+{
+    return axis == 0 ? v.x : ( axis == 1 ? v.y : v.z );
+}
+
+}  // namespace
+
+// コンストラクタ
+BVH::BVH()
+    : mNodes()
+    , mPrimIndices()
+{
+}
+
+// 構築
+bool BVH::Build( const std::vector<AABB3D>& bounds, uint32_t maxLeafSize )
+{
+    mNodes.clear();
+    mPrimIndices.clear();
+    if( bounds.empty() ) return false;
+
+    auto primCount = static_cast<uint32_t>( bounds.size() );
+    std::vector<Vector3> centers( primCount );
+    mPrimIndices.resize( primCount );
+    for( uint32_t i = 0; i < primCount; ++i )
+    {
+        centers[i] = ( bounds[i].mMin + bounds[i].mMax ) * 0.5f;
+        mPrimIndices[i] = i;
+    }
+
+    maxLeafSize = ( std::max )( maxLeafSize, 1u );
+    mNodes.reserve( primCount * 2 );
+    Node root = {};
+    root.mAABB.Reset();
+    for( const auto& aabb : bounds )
+    {
+        Merge( root.mAABB, aabb );
+    }
+    root.mLeftOrFirst = 0;
+    root.mCount = primCount;
+    mNodes.emplace_back( root );
+
+    // スタックで順に分割していく(探索スタックに収まるように深さの上限で止める)
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.emplace_back( 0, 0 );
+    while( !stack.empty() )
+    {
+        auto [nodeIdx, depth] = stack.back();
+        stack.pop_back();
+        if( depth + 1 >= kMaxDepth ) continue;
+        if( Split( nodeIdx, bounds, centers, maxLeafSize ) )
+        {
+            stack.emplace_back( mNodes[nodeIdx].mLeftOrFirst, depth + 1 );
+            stack.emplace_back( mNodes[nodeIdx].mLeftOrFirst + 1, depth + 1 );
+        }
+    }
+
+    mNodes.shrink_to_fit();
+    return true;
+}
+
+// 全体の境界を取得
+AABB3D BVH::GetBounds() const
+{
+    if( mNodes.empty() )
+    {
+        return AABB3D{ Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 0.0f, 0.0f, 0.0f ) };
+    }
+    return mNodes[0].mAABB;
+}
+
+// ノードを分割
+bool BVH::Split( uint32_t nodeIdx, const std::vector<AABB3D>& bounds, const std::vector<Vector3>& centers, uint32_t maxLeafSize )
+{
+    auto first = mNodes[nodeIdx].mLeftOrFirst;
+    auto count = mNodes[nodeIdx].mCount;
+    if( count <= maxLeafSize ) return false;
+
+    // 中心の範囲
+    AABB3D centerBounds = {};
+    centerBounds.Reset();
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        centerBounds.Update( centers[mPrimIndices[first + i]] );
+    }
+
+    // ビン分割でSAHが最小になる分割を探す
+    struct Bin
+    {
+        AABB3D mAABB;
+        uint32_t mCount;
+    };
+    auto bestCost = SurfaceArea( mNodes[nodeIdx].mAABB ) * count;
+    uint32_t bestAxis = 0;
+    float bestSplit = 0.0f;
+    auto isFound = false;
+    for( uint32_t axis = 0; axis < 3; ++axis )
+    {
+        auto minC = GetAxis( centerBounds.mMin, axis );
+        auto maxC = GetAxis( centerBounds.mMax, axis );
+        if( maxC - minC < MathUtil::kEpsilon ) continue;
+
+        Bin bins[kBinCount] = {};
+        for( auto& bin : bins )
+        {
+            bin.mAABB.Reset();
+        }
+        auto scale = kBinCount / ( maxC - minC );
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            auto prim = mPrimIndices[first + i];
+            auto b = ( std::min )( static_cast<uint32_t>( ( GetAxis( centers[prim], axis ) - minC ) * scale ), kBinCount - 1 );
+            Merge( bins[b].mAABB, bounds[prim] );
+            ++bins[b].mCount;
+        }
+
+        // 左右から累積
+        float leftArea[kBinCount - 1] = {};
+        uint32_t leftCount[kBinCount - 1] = {};
+        AABB3D acc = {};
+        acc.Reset();
+        uint32_t accCount = 0;
+        for( uint32_t i = 0; i < kBinCount - 1; ++i )
+        {
+            if( bins[i].mCount > 0 ) Merge( acc, bins[i].mAABB );
+            accCount += bins[i].mCount;
+            leftArea[i] = accCount > 0 ? SurfaceArea( acc ) : 0.0f;
+            leftCount[i] = accCount;
+        }
+        acc.Reset();
+        accCount = 0;
+        for( uint32_t i = kBinCount - 1; i > 0; --i )
+        {
+            if( bins[i].mCount > 0 ) Merge( acc, bins[i].mAABB );
+            accCount += bins[i].mCount;
+            auto rightArea = accCount > 0 ? SurfaceArea( acc ) : 0.0f;
+            auto cost = leftArea[i - 1] * leftCount[i - 1] + rightArea * accCount;
+            if( cost < bestCost )
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = minC + i / scale;
+                isFound = true;
+            }
+        }
+    }
+
+    // SAHで得をしない場合は中央値で分ける(葉が大きくなりすぎないように)
+    uint32_t leftCount = 0;
+    if( isFound )
+    {
+        auto* begin = mPrimIndices.data() + first;
+        auto* mid = std::partition(
+            begin, begin + count,
+            [&]( uint32_t prim )
+            {
+                return GetAxis( centers[prim], bestAxis ) < bestSplit;
+            } );
+        leftCount = static_cast<uint32_t>( mid - begin );
+    }
+    if( leftCount == 0 || leftCount == count )
+    {
+        auto extent = centerBounds.mMax - centerBounds.mMin;
+        uint32_t axis = extent.x > extent.y ? ( extent.x > extent.z ? 0 : 2 ) : ( extent.y > extent.z ? 1 : 2 );
+        auto* begin = mPrimIndices.data() + first;
+        leftCount = count / 2;
+        std::nth_element(
+            begin, begin + leftCount, begin + count,
+            [&]( uint32_t a, uint32_t b )
+            {
+                return GetAxis( centers[a], axis ) < GetAxis( centers[b], axis );
+            } );
+    }
+
+    // 子ノードを作成
+    auto leftIdx = static_cast<uint32_t>( mNodes.size() );
+    Node left = {};
+    left.mLeftOrFirst = first;
+    left.mCount = leftCount;
+    Node right = {};
+    right.mLeftOrFirst = first + leftCount;
+    right.mCount = count - leftCount;
+    for( auto* child : { &left, &right } )
+    {
+        child->mAABB.Reset();
+        for( uint32_t i = 0; i < child->mCount; ++i )
+        {
+            Merge( child->mAABB, bounds[mPrimIndices[child->mLeftOrFirst + i]] );
+        }
+    }
+    mNodes.emplace_back( left );
+    mNodes.emplace_back( right );
+
+    mNodes[nodeIdx].mLeftOrFirst = leftIdx;
+    mNodes[nodeIdx].mCount = 0;
+    return true;
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Collision.h"
+
+/// <summary>
+/// 境界ボリューム階層(プリミティブのAABBから構築)
+/// </summary>
+class BVH
+{
+   public:
+    /// <summary>
+    /// ノード(32バイト)
+    /// </summary>
+    struct Node
+    {
+        // 境界
+        AABB3D mAABB;
+        // 葉なら先頭プリミティブ、内部なら左の子のインデックス(右の子は+1)
+        uint32_t mLeftOrFirst;
+        // プリミティブ数(0なら内部ノード)
+        uint32_t mCount;
+
+        bool IsLeaf() const { return mCount > 0; }
+    };
+
+    // 木の深さの上限(ルートを0として葉の深さは kMaxDepth - 1 まで)
+    static constexpr uint32_t kMaxDepth = 64;
+
+   private:
+    // 分割に使うビンの数
+    static constexpr uint32_t kBinCount = 12;
+    // 探索スタックの深さ(深さ d の内部ノードを展開した後の要素数は d + 2 なので深さの上限で足りる)
+    static constexpr uint32_t kStackSize = kMaxDepth;
+
+    // ノード(0がルート)
+    std::vector<Node> mNodes;
+    // 葉から参照されるプリミティブのインデックス
+    std::vector<uint32_t> mPrimIndices;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    BVH();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~BVH() = default;
+
+    /// <summary>
+    /// 構築(深さが上限に達したノードは maxLeafSize を超えても葉にする)
+    /// </summary>
+    /// <param name="bounds">プリミティブのAABB</param>
+    /// <param name="maxLeafSize">葉に入れるプリミティブの最大数</param>
+    /// <returns>成否</returns>
+    bool Build( const std::vector<AABB3D>& bounds, uint32_t maxLeafSize = 4 );
+
+    /// <summary>
+    /// 半直線で探索(近い順)
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxT">最大距離</param>
+    /// <param name="inflate">ノードを膨らませる量(球の掃引用)</param>
+    /// <param name="func">プリミティブごとの判定 void(primIdx, float& maxT)。当たれば maxT を縮める</param>
+    template <class F>
+    void Raycast( const Vector3& origin, const Vector3& dir, float maxT, float inflate, F&& func ) const
+    {
+        if( mNodes.empty() ) return;
+
+        auto invDir = Vector3( 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z );
+        auto margin = Vector3( inflate, inflate, inflate );
+        uint32_t stack[kStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while( stackSize > 0 )
+        {
+            const auto& node = mNodes[stack[--stackSize]];
+            float t = 0.0f;
+            AABB3D aabb = { node.mAABB.mMin - margin, node.mAABB.mMax + margin };
+            if( !IntersectRay( origin, invDir, aabb, maxT, t ) ) continue;
+
+            if( node.IsLeaf() )
+            {
+                for( uint32_t i = 0; i < node.mCount; ++i )
+                {
+                    func( mPrimIndices[node.mLeftOrFirst + i], maxT );
+                }
+                continue;
+            }
+
+            // 近い子を後に積んで先に調べる
+            auto left = node.mLeftOrFirst;
+            auto right = left + 1;
+            auto leftCenter = mNodes[left].mAABB.mMin + mNodes[left].mAABB.mMax;
+            auto rightCenter = mNodes[right].mAABB.mMin + mNodes[right].mAABB.mMax;
+            if( Dot( rightCenter - leftCenter, dir ) < 0.0f )
+            {
+                std::swap( left, right );
+            }
+            assert( stackSize + 2 <= kStackSize );
+            stack[stackSize++] = right;
+            stack[stackSize++] = left;
+        }
+    }
+
+    /// <summary>
+    /// AABBと重なるプリミティブを探索
+    /// </summary>
+    /// <param name="aabb">範囲</param>
+    /// <param name="func">プリミティブごとの処理 void(primIdx)</param>
+    template <class F>
+    void Overlap( const AABB3D& aabb, F&& func ) const
+    {
+        if( mNodes.empty() ) return;
+
+        uint32_t stack[kStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while( stackSize > 0 )
+        {
+            const auto& node = mNodes[stack[--stackSize]];
+            if( !Intersect( node.mAABB, aabb ) ) continue;
+
+            if( node.IsLeaf() )
+            {
+                for( uint32_t i = 0; i < node.mCount; ++i )
+                {
+                    func( mPrimIndices[node.mLeftOrFirst + i] );
+                }
+                continue;
+            }
+
+            assert( stackSize + 2 <= kStackSize );
+            stack[stackSize++] = node.mLeftOrFirst + 1;
+            stack[stackSize++] = node.mLeftOrFirst;
+        }
+    }
+
+    /// <summary>全体の境界を取得</summary>
+    AABB3D GetBounds() const;
+
+    /// <summary>ノードを取得</summary>
+    const std::vector<Node>& GetNodes() const { return mNodes; }
+
+    /// <summary>プリミティブのインデックスを取得</summary>
+    const std::vector<uint32_t>& GetPrimIndices() const { return mPrimIndices; }
+
+    /// <summary>使用メモリ(バイト)を取得</summary>
+    size_t GetMemorySize() const { return mNodes.size() * sizeof( Node ) + mPrimIndices.size() * sizeof( uint32_t ); }
+
+   private:
+    /// <summary>
+    /// ノードを分割
+    /// </summary>
+    /// <param name="nodeIdx">ノードのインデックス</param>
+    /// <param name="bounds">プリミティブのAABB</param>
+    /// <param name="centers">プリミティブの中心</param>
+    /// <param name="maxLeafSize">葉に入れるプリミティブの最大数</param>
+    /// <returns>分割したか</returns>
+    bool Split( uint32_t nodeIdx, const std::vector<AABB3D>& bounds, const std::vector<Vector3>& centers, uint32_t maxLeafSize );
+};
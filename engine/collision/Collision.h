@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+
 #include "math/Primitive.h"
 
 /// <summary>
@@ -33,3 +36,337 @@ inline bool Intersect( const AABB3D& aabb, const Frustum& frustum )
     }
     return true;
 }
+
+/// <summary>
+/// 球が平面と衝突or内側か
+/// </summary>
+/// <param name="sphere"></param>
+/// <param name="plane"></param>
+/// <returns></returns>
+inline bool InsideOrIntersect( const Sphere& sphere, const Plane& plane )
+{
+    return Dot( plane.mNormal, sphere.mCenter ) + plane.mD >= -sphere.mRadius;
+}
+
+/// <summary>
+/// 球と視錐台の衝突判定
+/// </summary>
+/// <param name="sphere"></param>
+/// <param name="frustum"></param>
+/// <returns></returns>
+inline bool Intersect( const Sphere& sphere, const Frustum& frustum )
+{
+    for( auto plane : frustum.mPlanes )
+    {
+        if( !InsideOrIntersect( sphere, plane ) ) return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// 円錐が平面と衝突or内側か
+/// </summary>
+/// <param name="cone"></param>
+/// <param name="plane"></param>
+/// <returns></returns>
+inline bool InsideOrIntersect( const Cone& cone, const Plane& plane )
+{
+    // 頂点と底面の縁で平面の表側へ最も突き出た点を調べる
+    auto apexDist = Dot( plane.mNormal, cone.mApex ) + plane.mD;
+    auto nDotDir = Dot( plane.mNormal, cone.mDirection );
+    auto baseRadius = cone.mHeight * std::tan( cone.mAngle );
+    auto rimDist = apexDist + cone.mHeight * nDotDir + baseRadius * std::sqrt( ( std::max )( 0.0f, 1.0f - nDotDir * nDotDir ) );
+    return ( std::max )( apexDist, rimDist ) >= 0.0f;
+}
+
+/// <summary>
+/// 円錐と視錐台の衝突判定
+/// </summary>
+/// <param name="cone"></param>
+/// <param name="frustum"></param>
+/// <returns></returns>
+inline bool Intersect( const Cone& cone, const Frustum& frustum )
+{
+    for( auto plane : frustum.mPlanes )
+    {
+        if( !InsideOrIntersect( cone, plane ) ) return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// AABB同士の衝突判定
+/// </summary>
+/// <param name="a"></param>
+/// <param name="b"></param>
+/// <returns></returns>
+inline bool Intersect( const AABB3D& a, const AABB3D& b )
+{
+    return a.mMin.x <= b.mMax.x && a.mMax.x >= b.mMin.x &&
+           a.mMin.y <= b.mMax.y && a.mMax.y >= b.mMin.y &&
+           a.mMin.z <= b.mMax.z && a.mMax.z >= b.mMin.z;
+}
+
+/// <summary>
+/// 球とAABBの衝突判定
+/// </summary>
+/// <param name="sphere"></param>
+/// <param name="aabb"></param>
+/// <returns></returns>
+inline bool Intersect( const Sphere& sphere, const AABB3D& aabb )
+{
+    // AABB上の最近点との距離
+    auto x = std::clamp( sphere.mCenter.x, aabb.mMin.x, aabb.mMax.x );
+    auto y = std::clamp( sphere.mCenter.y, aabb.mMin.y, aabb.mMax.y );
+    auto z = std::clamp( sphere.mCenter.z, aabb.mMin.z, aabb.mMax.z );
+    return LengthSq( Vector3( x, y, z ) - sphere.mCenter ) <= sphere.mRadius * sphere.mRadius;
+}
+
+/// <summary>
+/// 球同士の衝突判定
+/// </summary>
+/// <param name="a"></param>
+/// <param name="b"></param>
+/// <returns></returns>
+inline bool Intersect( const Sphere& a, const Sphere& b )
+{
+    auto r = a.mRadius + b.mRadius;
+    return LengthSq( a.mCenter - b.mCenter ) <= r * r;
+}
+
+/// <summary>
+/// 半直線とAABBの交差判定(スラブ法)
+/// </summary>
+/// <param name="origin">始点</param>
+/// <param name="invDir">向きの逆数</param>
+/// <param name="aabb"></param>
+/// <param name="maxT">最大距離</param>
+/// <param name="t">交差距離(出力)</param>
+/// <returns></returns>
+inline bool IntersectRay( const Vector3& origin, const Vector3& invDir, const AABB3D& aabb, float maxT, float& t )
+{
+    auto tx1 = ( aabb.mMin.x - origin.x ) * invDir.x;
+    auto tx2 = ( aabb.mMax.x - origin.x ) * invDir.x;
+    auto tMin = ( std::min )( tx1, tx2 );
+    auto tMax = ( std::max )( tx1, tx2 );
+    auto ty1 = ( aabb.mMin.y - origin.y ) * invDir.y;
+    auto ty2 = ( aabb.mMax.y - origin.y ) * invDir.y;
+    tMin = ( std::max )( tMin, ( std::min )( ty1, ty2 ) );
+    tMax = ( std::min )( tMax, ( std::max )( ty1, ty2 ) );
+    auto tz1 = ( aabb.mMin.z - origin.z ) * invDir.z;
+    auto tz2 = ( aabb.mMax.z - origin.z ) * invDir.z;
+    tMin = ( std::max )( tMin, ( std::min )( tz1, tz2 ) );
+    tMax = ( std::min )( tMax, ( std::max )( tz1, tz2 ) );
+    t = ( std::max )( tMin, 0.0f );
+    return tMax >= t && t <= maxT;
+}
+
+/// <summary>
+/// 半直線と球の交差判定
+/// </summary>
+/// <param name="origin">始点</param>
+/// <param name="dir">向き(正規化済み)</param>
+/// <param name="sphere"></param>
+/// <param name="maxT">最大距離</param>
+/// <param name="t">交差距離(出力)</param>
+/// <returns></returns>
+inline bool IntersectRay( const Vector3& origin, const Vector3& dir, const Sphere& sphere, float maxT, float& t )
+{
+    auto m = origin - sphere.mCenter;
+    auto b = Dot( m, dir );
+    auto c = LengthSq( m ) - sphere.mRadius * sphere.mRadius;
+    // 外側にいて遠ざかっている
+    if( c > 0.0f && b > 0.0f ) return false;
+
+    auto discr = b * b - c;
+    if( discr < 0.0f ) return false;
+
+    t = ( std::max )( -b - std::sqrt( discr ), 0.0f );
+    return t <= maxT;
+}
+
+/// <summary>
+/// 半直線と三角形の交差判定
+/// </summary>
+/// <param name="origin">始点</param>
+/// <param name="dir">向き</param>
+/// <param name="v0"></param>
+/// <param name="v1"></param>
+/// <param name="v2"></param>
+/// <param name="maxT">最大距離</param>
+/// <param name="t">交差距離(出力)</param>
+/// <returns></returns>
+inline bool IntersectRay( const Vector3& origin, const Vector3& dir, const Vector3& v0, const Vector3& v1, const Vector3& v2, float maxT, float& t )
+{
+    // Möller–Trumbore
+    auto e1 = v1 - v0;
+    auto e2 = v2 - v0;
+    auto p = Cross( dir, e2 );
+    auto det = Dot( e1, p );
+    if( std::fabs( det ) < MathUtil::kEpsilon ) return false;
+
+    auto invDet = 1.0f / det;
+    auto s = origin - v0;
+    auto u = Dot( s, p ) * invDet;
+    if( u < 0.0f || u > 1.0f ) return false;
+
+    auto q = Cross( s, e1 );
+    auto v = Dot( dir, q ) * invDet;
+    if( v < 0.0f || u + v > 1.0f ) return false;
+
+    auto hitT = Dot( e2, q ) * invDet;
+    if( hitT < 0.0f || hitT > maxT ) return false;
+
+    t = hitT;
+    return true;
+}
+
+/// <summary>
+/// 三角形上の最近点
+/// </summary>
+/// <param name="p">点</param>
+/// <param name="a"></param>
+/// <param name="b"></param>
+/// <param name="c"></param>
+/// <returns>最近点</returns>
+inline Vector3 ClosestPoint( const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c )
+{
+    // 頂点・辺・面のどの領域にあるかで分ける
+    auto ab = b - a;
+    auto ac = c - a;
+    auto ap = p - a;
+    auto d1 = Dot( ab, ap );
+    auto d2 = Dot( ac, ap );
+    if( d1 <= 0.0f && d2 <= 0.0f ) return a;
+
+    auto bp = p - b;
+    auto d3 = Dot( ab, bp );
+    auto d4 = Dot( ac, bp );
+    if( d3 >= 0.0f && d4 <= d3 ) return b;
+
+    auto vc = d1 * d4 - d3 * d2;
+    if( vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f ) return a + ab * ( d1 / ( d1 - d3 ) );
+
+    auto cp = p - c;
+    auto d5 = Dot( ab, cp );
+    auto d6 = Dot( ac, cp );
+    if( d6 >= 0.0f && d5 <= d6 ) return c;
+
+    auto vb = d5 * d2 - d1 * d6;
+    if( vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f ) return a + ac * ( d2 / ( d2 - d6 ) );
+
+    auto va = d3 * d6 - d5 * d4;
+    if( va <= 0.0f && ( d4 - d3 ) >= 0.0f && ( d5 - d6 ) >= 0.0f ) return b + ( c - b ) * ( ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) ) );
+
+    auto denom = 1.0f / ( va + vb + vc );
+    return a + ab * ( vb * denom ) + ac * ( vc * denom );
+}
+
+/// <summary>
+/// 線分同士の最近点
+/// </summary>
+/// <param name="a">線分A</param>
+/// <param name="b">線分B</param>
+/// <param name="pointA">線分A上の最近点(出力)</param>
+/// <param name="pointB">線分B上の最近点(出力)</param>
+/// <returns>距離の2乗</returns>
+inline float ClosestPoints( const Segment3D& a, const Segment3D& b, Vector3& pointA, Vector3& pointB )
+{
+    auto d1 = a.mEnd - a.mStart;
+    auto d2 = b.mEnd - b.mStart;
+    auto r = a.mStart - b.mStart;
+    auto lenA = LengthSq( d1 );
+    auto lenB = LengthSq( d2 );
+    auto f = Dot( d2, r );
+    float s = 0.0f;
+    float t = 0.0f;
+    if( lenA <= MathUtil::kEpsilon && lenB <= MathUtil::kEpsilon )
+    {
+        // どちらも点
+    }
+    else if( lenA <= MathUtil::kEpsilon )
+    {
+        t = std::clamp( f / lenB, 0.0f, 1.0f );
+    }
+    else
+    {
+        auto c = Dot( d1, r );
+        if( lenB <= MathUtil::kEpsilon )
+        {
+            s = std::clamp( -c / lenA, 0.0f, 1.0f );
+        }
+        else
+        {
+            auto b2 = Dot( d1, d2 );
+            auto denom = lenA * lenB - b2 * b2;
+            // 平行なら任意の点から始める
+            s = denom != 0.0f ? std::clamp( ( b2 * f - c * lenB ) / denom, 0.0f, 1.0f ) : 0.0f;
+            t = ( b2 * s + f ) / lenB;
+            if( t < 0.0f )
+            {
+                t = 0.0f;
+                s = std::clamp( -c / lenA, 0.0f, 1.0f );
+            }
+            else if( t > 1.0f )
+            {
+                t = 1.0f;
+                s = std::clamp( ( b2 - c ) / lenA, 0.0f, 1.0f );
+            }
+        }
+    }
+    pointA = a.mStart + d1 * s;
+    pointB = b.mStart + d2 * t;
+    return LengthSq( pointA - pointB );
+}
+
+/// <summary>
+/// 線分と三角形の最近点
+/// </summary>
+/// <param name="segment">線分(始点と終点が同じなら点)</param>
+/// <param name="a"></param>
+/// <param name="b"></param>
+/// <param name="c"></param>
+/// <param name="pointSeg">線分上の最近点(出力)</param>
+/// <param name="pointTri">三角形上の最近点(出力)</param>
+/// <returns>距離の2乗</returns>
+inline float ClosestPoints( const Segment3D& segment, const Vector3& a, const Vector3& b, const Vector3& c, Vector3& pointSeg, Vector3& pointTri )
+{
+    // 貫通していれば距離0
+    auto dir = segment.mEnd - segment.mStart;
+    float t = 0.0f;
+    if( IntersectRay( segment.mStart, dir, a, b, c, 1.0f, t ) )
+    {
+        pointSeg = segment.mStart + dir * t;
+        pointTri = pointSeg;
+        return 0.0f;
+    }
+
+    // 端点と面
+    pointSeg = segment.mStart;
+    pointTri = ClosestPoint( segment.mStart, a, b, c );
+    auto best = LengthSq( pointTri - pointSeg );
+    auto endTri = ClosestPoint( segment.mEnd, a, b, c );
+    auto distSq = LengthSq( endTri - segment.mEnd );
+    if( distSq < best )
+    {
+        best = distSq;
+        pointSeg = segment.mEnd;
+        pointTri = endTri;
+    }
+
+    // 線分と辺
+    const Segment3D edges[3] = { { a, b }, { b, c }, { c, a } };
+    for( const auto& edge : edges )
+    {
+        Vector3 onSeg;
+        Vector3 onEdge;
+        distSq = ClosestPoints( segment, edge, onSeg, onEdge );
+        if( distSq < best )
+        {
+            best = distSq;
+            pointSeg = onSeg;
+            pointTri = onEdge;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,198 @@
+#include "CollisionScene.h"
+
+#include <cmath>
+
+namespace
+{
+
+// AABB上の点の法線(最も近い面)
+Vector3 GetAABBNormal( const AABB3D& aabb, const Vector3& p )
+{
+    float dists[6] = {
+        p.x - aabb.mMin.x, aabb.mMax.x - p.x,
+        p.y - aabb.mMin.y, aabb.mMax.y - p.y,
+        p.z - aabb.mMin.z, aabb.mMax.z - p.z,
+    };
+    const Vector3 normals[6] = {
+        Vector3( -1.0f, 0.0f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ),
+        Vector3( 0.0f, -1.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ),
+        Vector3( 0.0f, 0.0f, -1.0f ), Vector3( 0.0f, 0.0f, 1.0f ),
+    };
+    uint32_t best = 0;
+    for( uint32_t i = 1; i < 6; ++i )
+    {
+        if( std::fabs( dists[i] ) < std::fabs( dists[best] ) )
+        {
+            best = i;
+        }
+    }
+    return normals[best];
+}
+
+}  // namespace
+
+// コンストラクタ
+CollisionScene::CollisionScene()
+    : mColliders()
+    , mBVH()
+    , mIsBuilt( false )
+{
+}
+
+// AABBのコライダーを追加
+void CollisionScene::AddAABB( const AABB3D& aabb, uint32_t id )
+{
+    Collider collider = {};
+    collider.mType = ColliderType::kAABB;
+    collider.mAABB = aabb;
+    collider.mId = id;
+    mColliders.emplace_back( collider );
+    mIsBuilt = false;
+}
+
+// 球のコライダーを追加
+void CollisionScene::AddSphere( const Sphere& sphere, uint32_t id )
+{
+    Collider collider = {};
+    collider.mType = ColliderType::kSphere;
+    collider.mSphere = sphere;
+    auto r = Vector3( sphere.mRadius, sphere.mRadius, sphere.mRadius );
+    collider.mAABB = AABB3D{ sphere.mCenter - r, sphere.mCenter + r };
+    collider.mId = id;
+    mColliders.emplace_back( collider );
+    mIsBuilt = false;
+}
+
+// コライダーをすべて削除
+void CollisionScene::Clear()
+{
+    mColliders.clear();
+    mBVH = BVH();
+    mIsBuilt = false;
+}
+
+// BVHを構築
+bool CollisionScene::Build()
+{
+    std::vector<AABB3D> bounds( mColliders.size() );
+    for( size_t i = 0; i < mColliders.size(); ++i )
+    {
+        bounds[i] = mColliders[i].mAABB;
+    }
+    mIsBuilt = mBVH.Build( bounds );
+    return mIsBuilt;
+}
+
+// 半直線で判定
+bool CollisionScene::Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    return Cast( origin, dir, maxDist, 0.0f, hit );
+}
+
+// 球を掃引して判定
+bool CollisionScene::SweepSphere( const Sphere& sphere, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    return Cast( sphere.mCenter, dir, maxDist, sphere.mRadius, hit );
+}
+
+// 球と重なるコライダーを列挙
+uint32_t CollisionScene::OverlapSphere( const Sphere& sphere, std::vector<uint32_t>& ids ) const
+{
+    if( !mIsBuilt ) return 0;
+
+    auto r = Vector3( sphere.mRadius, sphere.mRadius, sphere.mRadius );
+    AABB3D range = { sphere.mCenter - r, sphere.mCenter + r };
+    uint32_t count = 0;
+    mBVH.Overlap(
+        range,
+        [&]( uint32_t prim )
+        {
+            const auto& collider = mColliders[prim];
+            auto isHit = collider.mType == ColliderType::kAABB ? Intersect( sphere, collider.mAABB ) : Intersect( sphere, collider.mSphere );
+            if( isHit )
+            {
+                ids.emplace_back( collider.mId );
+                ++count;
+            }
+        } );
+    return count;
+}
+
+// AABBと重なるコライダーを列挙
+uint32_t CollisionScene::OverlapAABB( const AABB3D& aabb, std::vector<uint32_t>& ids ) const
+{
+    if( !mIsBuilt ) return 0;
+
+    uint32_t count = 0;
+    mBVH.Overlap(
+        aabb,
+        [&]( uint32_t prim )
+        {
+            const auto& collider = mColliders[prim];
+            auto isHit = collider.mType == ColliderType::kAABB ? Intersect( aabb, collider.mAABB ) : Intersect( collider.mSphere, aabb );
+            if( isHit )
+            {
+                ids.emplace_back( collider.mId );
+                ++count;
+            }
+        } );
+    return count;
+}
+
+// 半直線または球の掃引で判定
+bool CollisionScene::Cast( const Vector3& origin, const Vector3& dir, float maxDist, float radius, RaycastHit& hit ) const
+{
+    hit = {};
+    if( !mIsBuilt ) return false;
+
+    auto invDir = Vector3( 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z );
+    auto margin = Vector3( radius, radius, radius );
+    const Collider* hitCollider = nullptr;
+    auto hitT = maxDist;
+    mBVH.Raycast(
+        origin, dir, maxDist, radius,
+        [&]( uint32_t prim, float& maxT )
+        {
+            const auto& collider = mColliders[prim];
+            float t = 0.0f;
+            auto isHit = false;
+            if( collider.mType == ColliderType::kAABB )
+            {
+                // 半径分広げた箱に対する半直線
+                AABB3D aabb = { collider.mAABB.mMin - margin, collider.mAABB.mMax + margin };
+                isHit = IntersectRay( origin, invDir, aabb, maxT, t );
+            }
+            else
+            {
+                // 半径を足した球に対する半直線
+                Sphere sphere = { collider.mSphere.mCenter, collider.mSphere.mRadius + radius };
+                isHit = IntersectRay( origin, dir, sphere, maxT, t );
+            }
+            if( isHit && t <= hitT )
+            {
+                // 以降はより近いものだけを探す
+                maxT = t;
+                hitT = t;
+                hitCollider = &collider;
+            }
+        } );
+    if( !hitCollider ) return false;
+
+    hit.mIsHit = true;
+    hit.mId = hitCollider->mId;
+    hit.mDistance = hitT;
+    auto center = origin + dir * hit.mDistance;
+    if( hitCollider->mType == ColliderType::kAABB )
+    {
+        AABB3D aabb = { hitCollider->mAABB.mMin - margin, hitCollider->mAABB.mMax + margin };
+        hit.mNormal = GetAABBNormal( aabb, center );
+    }
+    else
+    {
+        auto n = center - hitCollider->mSphere.mCenter;
+        hit.mNormal = LengthSq( n ) > MathUtil::kEpsilon ? Normalize( n ) : -dir;
+    }
+    // 接触点は球の表面
+    hit.mPoint = center - hit.mNormal * radius;
+    return true;
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "BVH.h"
+
+/// <summary>
+/// 半直線・掃引の判定結果
+/// </summary>
+struct RaycastHit
+{
+    // 当たったか
+    bool mIsHit;
+    // 当たったコライダーのID
+    uint32_t mId;
+    // 距離
+    float mDistance;
+    // 位置
+    Vector3 mPoint;
+    // 法線
+    Vector3 mNormal;
+};
+
+/// <summary>
+/// 静的なコライダーの集合(BVHで探索)
+/// </summary>
+class CollisionScene
+{
+   public:
+    /// <summary>
+    /// コライダーの種類
+    /// </summary>
+    enum class ColliderType : uint8_t
+    {
+        kAABB,
+        kSphere,
+    };
+
+    /// <summary>
+    /// コライダー
+    /// </summary>
+    struct Collider
+    {
+        ColliderType mType;
+        // 種類ごとの形状
+        AABB3D mAABB;
+        Sphere mSphere;
+        // ユーザー定義のID
+        uint32_t mId;
+    };
+
+   private:
+    // コライダー
+    std::vector<Collider> mColliders;
+    // コライダーのBVH
+    BVH mBVH;
+    // 構築済みか
+    bool mIsBuilt;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    CollisionScene();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~CollisionScene() = default;
+
+    /// <summary>
+    /// AABBのコライダーを追加
+    /// </summary>
+    /// <param name="aabb">形状</param>
+    /// <param name="id">ユーザー定義のID</param>
+    void AddAABB( const AABB3D& aabb, uint32_t id );
+
+    /// <summary>
+    /// 球のコライダーを追加
+    /// </summary>
+    /// <param name="sphere">形状</param>
+    /// <param name="id">ユーザー定義のID</param>
+    void AddSphere( const Sphere& sphere, uint32_t id );
+
+    /// <summary>
+    /// コライダーをすべて削除
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// BVHを構築(追加後、判定の前に呼ぶ)
+    /// </summary>
+    /// <returns>成否</returns>
+    bool Build();
+
+    /// <summary>
+    /// 半直線で判定(最も近いもの)
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力)</param>
+    /// <returns>当たったか</returns>
+    bool Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// 球を掃引して判定(最も近いもの)
+    /// AABBは半径分広げた箱で判定するため角の付近では保守的になる
+    /// </summary>
+    /// <param name="sphere">始点の球</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力)</param>
+    /// <returns>当たったか</returns>
+    bool SweepSphere( const Sphere& sphere, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// 球と重なるコライダーを列挙
+    /// </summary>
+    /// <param name="sphere">範囲</param>
+    /// <param name="ids">重なったコライダーのID(末尾に追加)</param>
+    /// <returns>見つかった数</returns>
+    uint32_t OverlapSphere( const Sphere& sphere, std::vector<uint32_t>& ids ) const;
+
+    /// <summary>
+    /// AABBと重なるコライダーを列挙
+    /// </summary>
+    /// <param name="aabb">範囲</param>
+    /// <param name="ids">重なったコライダーのID(末尾に追加)</param>
+    /// <returns>見つかった数</returns>
+    uint32_t OverlapAABB( const AABB3D& aabb, std::vector<uint32_t>& ids ) const;
+
+    /// <summary>コライダー数を取得</summary>
+    uint32_t GetColliderCount() const { return static_cast<uint32_t>( mColliders.size() ); }
+
+    /// <summary>全体の境界を取得</summary>
+    AABB3D GetBounds() const { return mBVH.GetBounds(); }
+
+   private:
+    /// <summary>
+    /// 半直線または球の掃引で判定
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="radius">半径(半直線なら0)</param>
+    /// <param name="hit">結果(出力)</param>
+    /// <returns>当たったか</returns>
+    bool Cast( const Vector3& origin, const Vector3& dir, float maxDist, float radius, RaycastHit& hit ) const;
+};
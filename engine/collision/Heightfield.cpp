@@ -0,0 +1,477 @@
+#include "Heightfield.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// 探索の単位(ピラミッドのノード)
+struct NodeRef
+{
+    uint32_t mLevel;
+    uint32_t mX;
+    uint32_t mZ;
+};
+
+// 1段の掃引で調べる最大距離(セル数)
+const float kSweepSearchCells = 8.0f;
+
+}  // namespace
+
+// コンストラクタ
+Heightfield::Heightfield()
+    : mWidth( 0 )
+    , mDepth( 0 )
+    , mOrigin()
+    , mCellSize( 1.0f )
+    , mHeights()
+    , mLevels()
+{
+}
+
+// 作成
+bool Heightfield::Create( uint32_t width, uint32_t depth, const std::vector<float>& heights, const Vector3& origin, float cellSize, float heightScale )
+{
+    if( width < 2 || depth < 2 || cellSize <= 0.0f ) return false;
+    if( heights.size() < static_cast<size_t>( width ) * depth ) return false;
+
+    mWidth = width;
+    mDepth = depth;
+    mOrigin = origin;
+    mCellSize = cellSize;
+    mHeights.resize( static_cast<size_t>( width ) * depth );
+    for( size_t i = 0; i < mHeights.size(); ++i )
+    {
+        mHeights[i] = origin.y + heights[i] * heightScale;
+    }
+
+    BuildLevels();
+    return true;
+}
+
+// 高さを取得
+bool Heightfield::GetHeight( float x, float z, float& height ) const
+{
+    if( mHeights.empty() ) return false;
+
+    auto fx = ( x - mOrigin.x ) / mCellSize;
+    auto fz = ( z - mOrigin.z ) / mCellSize;
+    if( fx < 0.0f || fz < 0.0f || fx > mWidth - 1 || fz > mDepth - 1 ) return false;
+
+    auto cx = ( std::min )( static_cast<uint32_t>( fx ), mWidth - 2 );
+    auto cz = ( std::min )( static_cast<uint32_t>( fz ), mDepth - 2 );
+    fx -= cx;
+    fz -= cz;
+    auto h00 = mHeights[cz * mWidth + cx];
+    auto h10 = mHeights[cz * mWidth + cx + 1];
+    auto h01 = mHeights[( cz + 1 ) * mWidth + cx];
+    auto h11 = mHeights[( cz + 1 ) * mWidth + cx + 1];
+    // 三角形の分割に合わせて補間
+    if( fx + fz <= 1.0f )
+    {
+        height = h00 + ( h10 - h00 ) * fx + ( h01 - h00 ) * fz;
+    }
+    else
+    {
+        height = h11 + ( h01 - h11 ) * ( 1.0f - fx ) + ( h10 - h11 ) * ( 1.0f - fz );
+    }
+    return true;
+}
+
+// 半直線で判定
+bool Heightfield::Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    hit = {};
+    if( mLevels.empty() ) return false;
+
+    auto invDir = Vector3( 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z );
+    auto maxT = maxDist;
+    auto hitTri = UINT32_MAX;
+    Vector3 hitNormal;
+
+    NodeRef stack[kStackSize];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = NodeRef{ static_cast<uint32_t>( mLevels.size() - 1 ), 0, 0 };
+    while( stackSize > 0 )
+    {
+        auto node = stack[--stackSize];
+        float t = 0.0f;
+        if( !IntersectRay( origin, invDir, GetNodeAABB( node.mLevel, node.mX, node.mZ ), maxT, t ) ) continue;
+
+        if( node.mLevel == 0 )
+        {
+            // セルの三角形
+            Vector3 v[6];
+            GetCellTriangles( node.mX, node.mZ, v );
+            for( uint32_t i = 0; i < 2; ++i )
+            {
+                if( IntersectRay( origin, dir, v[i * 3 + 0], v[i * 3 + 1], v[i * 3 + 2], maxT, t ) )
+                {
+                    maxT = t;
+                    hitTri = ( node.mZ * ( mWidth - 1 ) + node.mX ) * 2 + i;
+                    hitNormal = Normalize( Cross( v[i * 3 + 1] - v[i * 3 + 0], v[i * 3 + 2] - v[i * 3 + 0] ) );
+                }
+            }
+            continue;
+        }
+
+        // 子を遠い順に積む(近いものから調べる)
+        const auto& child = mLevels[node.mLevel - 1];
+        NodeRef children[4];
+        float childT[4];
+        uint32_t childCount = 0;
+        for( uint32_t dz = 0; dz < 2; ++dz )
+        {
+            for( uint32_t dx = 0; dx < 2; ++dx )
+            {
+                auto x = node.mX * 2 + dx;
+                auto z = node.mZ * 2 + dz;
+                if( x >= child.mWidth || z >= child.mDepth ) continue;
+
+                float ct = 0.0f;
+                if( !IntersectRay( origin, invDir, GetNodeAABB( node.mLevel - 1, x, z ), maxT, ct ) ) continue;
+
+                // 挿入ソート(遠い順)
+                auto pos = childCount;
+                while( pos > 0 && childT[pos - 1] < ct )
+                {
+                    children[pos] = children[pos - 1];
+                    childT[pos] = childT[pos - 1];
+                    --pos;
+                }
+                children[pos] = NodeRef{ node.mLevel - 1, x, z };
+                childT[pos] = ct;
+                ++childCount;
+            }
+        }
+        assert( stackSize + childCount <= kStackSize );
+        for( uint32_t i = 0; i < childCount; ++i )
+        {
+            stack[stackSize++] = children[i];
+        }
+    }
+    if( hitTri == UINT32_MAX ) return false;
+
+    hit.mIsHit = true;
+    hit.mId = hitTri;
+    hit.mDistance = maxT;
+    hit.mPoint = origin + dir * maxT;
+    hit.mNormal = hitNormal;
+    return true;
+}
+
+// 球と重なるか
+bool Heightfield::OverlapSphere( const Sphere& sphere ) const
+{
+    if( IsBelow( sphere.mCenter ) ) return true;
+
+    RaycastHit closest = {};
+    return ComputeDistance( Segment3D{ sphere.mCenter, sphere.mCenter }, sphere.mRadius, closest ) < sphere.mRadius;
+}
+
+// カプセルと重なるか
+bool Heightfield::OverlapCapsule( const Capsule3D& capsule ) const
+{
+    if( IsBelow( capsule.mSegment.mStart ) || IsBelow( capsule.mSegment.mEnd ) ) return true;
+
+    RaycastHit closest = {};
+    return ComputeDistance( capsule.mSegment, capsule.mRadius, closest ) < capsule.mRadius;
+}
+
+// 球を掃引して判定
+bool Heightfield::SweepSphere( const Sphere& sphere, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    return Sweep( Segment3D{ sphere.mCenter, sphere.mCenter }, sphere.mRadius, dir, maxDist, hit );
+}
+
+// カプセルを掃引して判定
+bool Heightfield::SweepCapsule( const Capsule3D& capsule, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    return Sweep( capsule.mSegment, capsule.mRadius, dir, maxDist, hit );
+}
+
+// 三角形を取得
+void Heightfield::GetTriangles( std::vector<Vector3>& positions, std::vector<uint32_t>& indices ) const
+{
+    positions.resize( mHeights.size() );
+    for( uint32_t z = 0; z < mDepth; ++z )
+    {
+        for( uint32_t x = 0; x < mWidth; ++x )
+        {
+            positions[z * mWidth + x] = GetVertex( x, z );
+        }
+    }
+
+    indices.clear();
+    if( mHeights.empty() ) return;
+
+    indices.reserve( static_cast<size_t>( mWidth - 1 ) * ( mDepth - 1 ) * 6 );
+    for( uint32_t z = 0; z < mDepth - 1; ++z )
+    {
+        for( uint32_t x = 0; x < mWidth - 1; ++x )
+        {
+            auto v00 = z * mWidth + x;
+            auto v10 = v00 + 1;
+            auto v01 = v00 + mWidth;
+            auto v11 = v01 + 1;
+            indices.insert( indices.end(), { v00, v01, v10, v10, v01, v11 } );
+        }
+    }
+}
+
+// 使用メモリ(バイト)を取得
+size_t Heightfield::GetMemorySize() const
+{
+    auto size = mHeights.size() * sizeof( float );
+    for( const auto& level : mLevels )
+    {
+        size += ( level.mMin.size() + level.mMax.size() ) * sizeof( float );
+    }
+    return size;
+}
+
+// ピラミッドを構築
+void Heightfield::BuildLevels()
+{
+    mLevels.clear();
+
+    // セル単位
+    Level base = {};
+    base.mWidth = mWidth - 1;
+    base.mDepth = mDepth - 1;
+    base.mMin.resize( static_cast<size_t>( base.mWidth ) * base.mDepth );
+    base.mMax.resize( base.mMin.size() );
+    for( uint32_t z = 0; z < base.mDepth; ++z )
+    {
+        for( uint32_t x = 0; x < base.mWidth; ++x )
+        {
+            auto h00 = mHeights[z * mWidth + x];
+            auto h10 = mHeights[z * mWidth + x + 1];
+            auto h01 = mHeights[( z + 1 ) * mWidth + x];
+            auto h11 = mHeights[( z + 1 ) * mWidth + x + 1];
+            base.mMin[z * base.mWidth + x] = ( std::min )( { h00, h10, h01, h11 } );
+            base.mMax[z * base.mWidth + x] = ( std::max )( { h00, h10, h01, h11 } );
+        }
+    }
+    mLevels.emplace_back( std::move( base ) );
+
+    // 2x2ずつまとめて1つになるまで
+    while( mLevels.back().mWidth > 1 || mLevels.back().mDepth > 1 )
+    {
+        const auto& prev = mLevels.back();
+        Level level = {};
+        level.mWidth = ( prev.mWidth + 1 ) / 2;
+        level.mDepth = ( prev.mDepth + 1 ) / 2;
+        level.mMin.assign( static_cast<size_t>( level.mWidth ) * level.mDepth, +FLT_MAX );
+        level.mMax.assign( level.mMin.size(), -FLT_MAX );
+        for( uint32_t z = 0; z < prev.mDepth; ++z )
+        {
+            for( uint32_t x = 0; x < prev.mWidth; ++x )
+            {
+                auto dst = ( z / 2 ) * level.mWidth + x / 2;
+                level.mMin[dst] = ( std::min )( level.mMin[dst], prev.mMin[z * prev.mWidth + x] );
+                level.mMax[dst] = ( std::max )( level.mMax[dst], prev.mMax[z * prev.mWidth + x] );
+            }
+        }
+        mLevels.emplace_back( std::move( level ) );
+    }
+    assert( mLevels.size() <= kMaxLevelCount );
+}
+
+// セルの三角形を取得
+void Heightfield::GetCellTriangles( uint32_t x, uint32_t z, Vector3 ( &vertices )[6] ) const
+{
+    auto v00 = GetVertex( x, z );
+    auto v10 = GetVertex( x + 1, z );
+    auto v01 = GetVertex( x, z + 1 );
+    auto v11 = GetVertex( x + 1, z + 1 );
+    vertices[0] = v00;
+    vertices[1] = v01;
+    vertices[2] = v10;
+    vertices[3] = v10;
+    vertices[4] = v01;
+    vertices[5] = v11;
+}
+
+// ピラミッドのノードの境界を取得
+AABB3D Heightfield::GetNodeAABB( uint32_t level, uint32_t x, uint32_t z ) const
+{
+    const auto& l = mLevels[level];
+    auto cellCount = static_cast<float>( 1u << level );
+    auto idx = z * l.mWidth + x;
+    AABB3D aabb = {};
+    aabb.mMin = Vector3( mOrigin.x + x * cellCount * mCellSize, l.mMin[idx], mOrigin.z + z * cellCount * mCellSize );
+    // 端のノードは範囲外まで広がるが、高さは中のセルだけで決まるので問題ない
+    aabb.mMax = Vector3( aabb.mMin.x + cellCount * mCellSize, l.mMax[idx], aabb.mMin.z + cellCount * mCellSize );
+    return aabb;
+}
+
+// 範囲と重なるセルを列挙
+template <class F>
+void Heightfield::ForEachCell( const AABB3D& range, F&& func ) const
+{
+    if( mLevels.empty() ) return;
+
+    NodeRef stack[kStackSize];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = NodeRef{ static_cast<uint32_t>( mLevels.size() - 1 ), 0, 0 };
+    while( stackSize > 0 )
+    {
+        auto node = stack[--stackSize];
+        if( !Intersect( GetNodeAABB( node.mLevel, node.mX, node.mZ ), range ) ) continue;
+
+        if( node.mLevel == 0 )
+        {
+            if( !func( node.mX, node.mZ ) ) return;
+            continue;
+        }
+
+        const auto& child = mLevels[node.mLevel - 1];
+        assert( stackSize + 4 <= kStackSize );
+        for( uint32_t dz = 0; dz < 2; ++dz )
+        {
+            for( uint32_t dx = 0; dx < 2; ++dx )
+            {
+                auto x = node.mX * 2 + dx;
+                auto z = node.mZ * 2 + dz;
+                if( x < child.mWidth && z < child.mDepth )
+                {
+                    stack[stackSize++] = NodeRef{ node.mLevel - 1, x, z };
+                }
+            }
+        }
+    }
+}
+
+// 線分と地形の最近点を求める
+float Heightfield::ComputeDistance( const Segment3D& segment, float searchDist, RaycastHit& closest ) const
+{
+    AABB3D range = {};
+    range.Reset();
+    range.Update( segment.mStart );
+    range.Update( segment.mEnd );
+    auto margin = Vector3( searchDist, searchDist, searchDist );
+    range.mMin -= margin;
+    range.mMax += margin;
+
+    auto bestSq = searchDist * searchDist;
+    auto isFound = false;
+    ForEachCell(
+        range,
+        [&]( uint32_t x, uint32_t z )
+        {
+            Vector3 v[6];
+            GetCellTriangles( x, z, v );
+            for( uint32_t i = 0; i < 2; ++i )
+            {
+                Vector3 onSeg;
+                Vector3 onTri;
+                auto distSq = ClosestPoints( segment, v[i * 3 + 0], v[i * 3 + 1], v[i * 3 + 2], onSeg, onTri );
+                if( distSq < bestSq )
+                {
+                    bestSq = distSq;
+                    isFound = true;
+                    auto triNormal = Normalize( Cross( v[i * 3 + 1] - v[i * 3 + 0], v[i * 3 + 2] - v[i * 3 + 0] ) );
+                    auto diff = onSeg - onTri;
+                    closest.mId = ( z * ( mWidth - 1 ) + x ) * 2 + i;
+                    closest.mPoint = onTri;
+                    closest.mNormal = distSq > MathUtil::kEpsilon ? diff / std::sqrt( distSq ) : triNormal;
+                }
+            }
+            // 接触していればそれ以上探さない
+            return bestSq > 0.0f;
+        } );
+    return isFound ? std::sqrt( bestSq ) : searchDist;
+}
+
+// 点が地面の下にあるか
+bool Heightfield::IsBelow( const Vector3& p ) const
+{
+    float height = 0.0f;
+    return GetHeight( p.x, p.z, height ) && p.y < height;
+}
+
+// 線分を掃引して判定
+bool Heightfield::Sweep( const Segment3D& segment, float radius, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    hit = {};
+    if( mLevels.empty() ) return false;
+
+    // 始めからめり込んでいる
+    if( IsBelow( segment.mStart ) || IsBelow( segment.mEnd ) )
+    {
+        hit.mIsHit = true;
+        hit.mPoint = segment.mStart;
+        hit.mNormal = Vector3( 0.0f, 1.0f, 0.0f );
+        return true;
+    }
+
+    // 地形の境界から出たら以降は当たらないので、そこまでに距離を絞る(無限の距離でも止まる)
+    if( !ClipToBounds( segment, radius, dir, maxDist ) ) return false;
+
+    // 保守的前進: 地形までの距離だけ進めば貫通しない(1回に許容距離より多く進む)
+    auto searchCap = kSweepSearchCells * mCellSize;
+    auto traveled = 0.0f;
+    RaycastHit closest = {};
+    for( uint32_t iteration = 0;; ++iteration )
+    {
+        auto offset = dir * traveled;
+        Segment3D current = { segment.mStart + offset, segment.mEnd + offset };
+        auto searchDist = radius + ( std::min )( maxDist - traveled, searchCap ) + kSweepTolerance;
+        auto dist = ComputeDistance( current, searchDist, closest );
+        auto gap = dist - radius;
+        // 探す距離の中に地形があり、許容距離まで近づいたときだけ接触とする
+        // なめるように進んで反復の上限に達したときは、貫通させないようにその場で接触とする
+        // (地形が探す距離の外なら1回に探す距離だけ進むので、上限がなくても終わる)
+        if( dist < searchDist && ( gap <= kSweepTolerance || iteration + 1 >= kMaxSweepIterations ) ) break;
+
+        traveled += gap;
+        if( traveled > maxDist ) return false;
+    }
+
+    hit = closest;
+    hit.mIsHit = true;
+    hit.mDistance = traveled;
+    return true;
+}
+
+// 掃引の距離を地形の境界で絞る
+bool Heightfield::ClipToBounds( const Segment3D& segment, float radius, const Vector3& dir, float& maxDist ) const
+{
+    // 形状のAABBの最小の角が、形状の大きさだけ広げた地形の境界の中にあるときだけ重なりうる
+    AABB3D shape = {};
+    shape.Reset();
+    shape.Update( segment.mStart );
+    shape.Update( segment.mEnd );
+    auto margin = Vector3( radius, radius, radius );
+    shape.mMin -= margin;
+    shape.mMax += margin;
+    auto bounds = GetNodeAABB( static_cast<uint32_t>( mLevels.size() - 1 ), 0, 0 );
+    bounds.mMin -= shape.mMax - shape.mMin;
+
+    float exitT = maxDist;
+    const float origin[3] = { shape.mMin.x, shape.mMin.y, shape.mMin.z };
+    const float d[3] = { dir.x, dir.y, dir.z };
+    const float minB[3] = { bounds.mMin.x, bounds.mMin.y, bounds.mMin.z };
+    const float maxB[3] = { bounds.mMax.x, bounds.mMax.y, bounds.mMax.z };
+    for( uint32_t axis = 0; axis < 3; ++axis )
+    {
+        if( d[axis] > 0.0f )
+        {
+            exitT = ( std::min )( exitT, ( maxB[axis] - origin[axis] ) / d[axis] );
+        }
+        else if( d[axis] < 0.0f )
+        {
+            exitT = ( std::min )( exitT, ( minB[axis] - origin[axis] ) / d[axis] );
+        }
+        else if( origin[axis] < minB[axis] || origin[axis] > maxB[axis] )
+        {
+            return false;
+        }
+    }
+    if( exitT < 0.0f ) return false;
+
+    maxDist = exitT;
+    return true;
+}
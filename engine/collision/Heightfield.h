@@ -0,0 +1,225 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CollisionScene.h"
+
+/// <summary>
+/// ハイトフィールドのコライダー(地形用)
+/// 格子状の高さと、セルの最小・最大高さのミップピラミッドを持つ
+/// 各セルは (x, z), (x, z+1), (x+1, z) と (x+1, z), (x, z+1), (x+1, z+1) の2枚の三角形
+/// </summary>
+class Heightfield
+{
+   private:
+    // 掃引で接触とみなす距離
+    static constexpr float kSweepTolerance = 1e-3f;
+    // 掃引の反復回数の上限(地形をなめるように進むと1回に許容距離ほどしか進まないため)
+    static constexpr uint32_t kMaxSweepIterations = 4096;
+    // ピラミッドの段数の上限(セル数は32ビットなので、1つになるまで最大32回半分にする)
+    static constexpr uint32_t kMaxLevelCount = 33;
+    // 探索スタックの深さ(1段下りるごとに兄弟を最大3つ残す)
+    static constexpr uint32_t kStackSize = kMaxLevelCount * 3 + 1;
+
+    /// <summary>
+    /// ミップの1段
+    /// </summary>
+    struct Level
+    {
+        uint32_t mWidth;
+        uint32_t mDepth;
+        // セル範囲の最小・最大高さ
+        std::vector<float> mMin;
+        std::vector<float> mMax;
+    };
+
+    // サンプル数
+    uint32_t mWidth;
+    uint32_t mDepth;
+    // 原点(サンプル(0, 0)の位置)
+    Vector3 mOrigin;
+    // サンプル間隔
+    float mCellSize;
+    // 高さ(ワールド座標、行優先)
+    std::vector<float> mHeights;
+    // 最小・最大高さのピラミッド(0がセル単位)
+    std::vector<Level> mLevels;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    Heightfield();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~Heightfield() = default;
+
+    /// <summary>
+    /// 作成
+    /// </summary>
+    /// <param name="width">X方向のサンプル数</param>
+    /// <param name="depth">Z方向のサンプル数</param>
+    /// <param name="heights">高さ(行優先、width * depth個)</param>
+    /// <param name="origin">原点</param>
+    /// <param name="cellSize">サンプル間隔</param>
+    /// <param name="heightScale">高さの倍率</param>
+    /// <returns>成否</returns>
+    bool Create( uint32_t width, uint32_t depth, const std::vector<float>& heights, const Vector3& origin, float cellSize, float heightScale = 1.0f );
+
+    /// <summary>
+    /// 画像から作成(テクスチャの読み込みを使うので HeightfieldImage.cpp に置く)
+    /// </summary>
+    /// <param name="path">ハイトマップのパス</param>
+    /// <param name="origin">原点</param>
+    /// <param name="cellSize">サンプル間隔</param>
+    /// <param name="heightScale">高さの倍率(画素値0～1に掛ける)</param>
+    /// <returns>成否</returns>
+    bool CreateFromImage( const std::string& path, const Vector3& origin, float cellSize, float heightScale );
+
+    /// <summary>
+    /// 高さを取得
+    /// </summary>
+    /// <param name="x">X座標</param>
+    /// <param name="z">Z座標</param>
+    /// <param name="height">高さ(出力)</param>
+    /// <returns>範囲内か</returns>
+    bool GetHeight( float x, float z, float& height ) const;
+
+    /// <summary>
+    /// 半直線で判定(ピラミッドで範囲を絞りながら近い順に進む)
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力、IDは三角形のインデックス)</param>
+    /// <returns>当たったか</returns>
+    bool Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// 球と重なるか(地面の下にめり込んでいる場合も含む)
+    /// </summary>
+    /// <param name="sphere">球</param>
+    /// <returns>重なるか</returns>
+    bool OverlapSphere( const Sphere& sphere ) const;
+
+    /// <summary>
+    /// カプセルと重なるか(地面の下にめり込んでいる場合も含む)
+    /// </summary>
+    /// <param name="capsule">カプセル</param>
+    /// <returns>重なるか</returns>
+    bool OverlapCapsule( const Capsule3D& capsule ) const;
+
+    /// <summary>
+    /// 球を掃引して判定
+    /// </summary>
+    /// <param name="sphere">始点の球</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力)</param>
+    /// <returns>当たったか</returns>
+    bool SweepSphere( const Sphere& sphere, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// カプセルを掃引して判定
+    /// </summary>
+    /// <param name="capsule">始点のカプセル</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力)</param>
+    /// <returns>当たったか</returns>
+    bool SweepCapsule( const Capsule3D& capsule, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// 三角形を取得(三角形メッシュとの比較・デバッグ用)
+    /// </summary>
+    /// <param name="positions">頂点座標(出力)</param>
+    /// <param name="indices">三角形の頂点インデックス(出力)</param>
+    void GetTriangles( std::vector<Vector3>& positions, std::vector<uint32_t>& indices ) const;
+
+    /// <summary>X方向のサンプル数を取得</summary>
+    uint32_t GetWidth() const { return mWidth; }
+
+    /// <summary>Z方向のサンプル数を取得</summary>
+    uint32_t GetDepth() const { return mDepth; }
+
+    /// <summary>使用メモリ(バイト)を取得</summary>
+    size_t GetMemorySize() const;
+
+   private:
+    /// <summary>
+    /// ピラミッドを構築
+    /// </summary>
+    void BuildLevels();
+
+    /// <summary>サンプルの位置を取得</summary>
+    Vector3 GetVertex( uint32_t x, uint32_t z ) const
+    {
+        return Vector3( mOrigin.x + x * mCellSize, mHeights[z * mWidth + x], mOrigin.z + z * mCellSize );
+    }
+
+    /// <summary>
+    /// セルの三角形を取得
+    /// </summary>
+    /// <param name="x">セルのX</param>
+    /// <param name="z">セルのZ</param>
+    /// <param name="vertices">2枚分の頂点(出力)</param>
+    void GetCellTriangles( uint32_t x, uint32_t z, Vector3 ( &vertices )[6] ) const;
+
+    /// <summary>
+    /// ピラミッドのノードの境界を取得
+    /// </summary>
+    /// <param name="level">段</param>
+    /// <param name="x">X</param>
+    /// <param name="z">Z</param>
+    /// <returns>境界</returns>
+    AABB3D GetNodeAABB( uint32_t level, uint32_t x, uint32_t z ) const;
+
+    /// <summary>
+    /// 範囲と重なるセルを列挙
+    /// </summary>
+    /// <param name="range">範囲</param>
+    /// <param name="func">セルごとの処理 bool(x, z)。falseで打ち切る</param>
+    template <class F>
+    void ForEachCell( const AABB3D& range, F&& func ) const;
+
+    /// <summary>
+    /// 線分と地形の最近点を求める
+    /// </summary>
+    /// <param name="segment">線分(始点と終点が同じなら点)</param>
+    /// <param name="searchDist">探す距離</param>
+    /// <param name="closest">地形上の最近点・法線・三角形(出力、見つかったときのみ)</param>
+    /// <returns>距離(searchDist以内に無ければsearchDist)</returns>
+    float ComputeDistance( const Segment3D& segment, float searchDist, RaycastHit& closest ) const;
+
+    /// <summary>
+    /// 点が地面の下にあるか
+    /// </summary>
+    /// <param name="p">点</param>
+    /// <returns>下にあるか</returns>
+    bool IsBelow( const Vector3& p ) const;
+
+    /// <summary>
+    /// 線分を掃引して判定(保守的前進、許容距離まで近づいたときだけ当たりとする)
+    /// </summary>
+    /// <param name="segment">始点の線分</param>
+    /// <param name="radius">半径</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力)</param>
+    /// <returns>当たったか</returns>
+    bool Sweep( const Segment3D& segment, float radius, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// 掃引の距離を地形の境界で絞る
+    /// </summary>
+    /// <param name="segment">始点の線分</param>
+    /// <param name="radius">半径</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離(入出力)</param>
+    /// <returns>境界と重なりうるか</returns>
+    bool ClipToBounds( const Segment3D& segment, float radius, const Vector3& dir, float& maxDist ) const;
+};
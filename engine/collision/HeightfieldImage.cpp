@@ -0,0 +1,13 @@
+#include "Heightfield.h"
+#include "graphics/Texture.h"
+
+// 画像から作成
+bool Heightfield::CreateFromImage( const std::string& path, const Vector3& origin, float cellSize, float heightScale )
+{
+    std::vector<float> values;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if( !Texture::LoadValues( path, values, width, height ) ) return false;
+
+    return Create( width, height, values, origin, cellSize, heightScale );
+}
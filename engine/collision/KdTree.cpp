@@ -0,0 +1,312 @@
+#include "KdTree.h"
+
+#include <algorithm>
+
+#include "utils/JobSystem.h"
+
+namespace
+{
+
+// 探索範囲
+struct Range
+{
+    uint32_t mBegin;
+    uint32_t mEnd;
+    // 範囲までの距離の2乗の下限
+    float mMinDistSq;
+};
+
+// 構築中の範囲
+struct BuildRange
+{
+    uint32_t mBegin;
+    uint32_t mEnd;
+    // 範囲の深さ(ルートが1)
+    uint32_t mDepth;
+};
+
+// 軸の成分を取得
+float GetAxis( const Vector3& v, uint32_t axis )
+{
+    return axis == 0 ? v.x : ( axis == 1 ? v.y : v.z );
+}
+
+}  // namespace
+
+// コンストラクタ
+KdTree::KdTree()
+    : mPoints()
+    , mIds()
+    , mAxes()
+    , mDepth( 0 )
+{
+}
+
+// 構築
+bool KdTree::Build( const std::vector<Vector3>& points )
+{
+    mPoints.clear();
+    mIds.clear();
+    mAxes.clear();
+    mDepth = 0;
+    if( points.empty() ) return false;
+
+    auto count = static_cast<uint32_t>( points.size() );
+    std::vector<uint32_t> order( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        order[i] = i;
+    }
+    mAxes.assign( count, 0 );
+
+    // 範囲の中央に中央値が来るように分割していく
+    std::vector<BuildRange> stack;
+    stack.emplace_back( BuildRange{ 0, count, 1 } );
+    while( !stack.empty() )
+    {
+        auto [begin, end, depth] = stack.back();
+        stack.pop_back();
+        mDepth = ( std::max )( mDepth, depth );
+        if( end - begin <= kLeafSize ) continue;
+
+        // 最も広がっている軸で分ける
+        Vector3 minP( +FLT_MAX, +FLT_MAX, +FLT_MAX );
+        Vector3 maxP( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+        for( auto i = begin; i < end; ++i )
+        {
+            const auto& p = points[order[i]];
+            minP = Vector3( ( std::min )( minP.x, p.x ), ( std::min )( minP.y, p.y ), ( std::min )( minP.z, p.z ) );
+            maxP = Vector3( ( std::max )( maxP.x, p.x ), ( std::max )( maxP.y, p.y ), ( std::max )( maxP.z, p.z ) );
+        }
+        auto extent = maxP - minP;
+        uint32_t axis = extent.x > extent.y ? ( extent.x > extent.z ? 0 : 2 ) : ( extent.y > extent.z ? 1 : 2 );
+
+        auto mid = ( begin + end ) / 2;
+        std::nth_element(
+            order.begin() + begin, order.begin() + mid, order.begin() + end,
+            [&]( uint32_t a, uint32_t b )
+            {
+                return GetAxis( points[a], axis ) < GetAxis( points[b], axis );
+            } );
+        mAxes[mid] = static_cast<uint8_t>( axis );
+
+        stack.emplace_back( BuildRange{ begin, mid, depth + 1 } );
+        stack.emplace_back( BuildRange{ mid + 1, end, depth + 1 } );
+    }
+    // 探索は1段下りるごとにスタックが1つ増えるだけなので、深さ+1あれば足りる
+    assert( mDepth + 1 <= kStackSize );
+
+    mPoints.resize( count );
+    mIds = std::move( order );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        mPoints[i] = points[mIds[i]];
+    }
+    return true;
+}
+
+// 最も近い点を探す
+uint32_t KdTree::FindNearest( const Vector3& p, float maxDist ) const
+{
+    thread_local std::vector<std::pair<float, uint32_t>> heap;
+    auto maxDistSq = maxDist < FLT_MAX ? maxDist * maxDist : FLT_MAX;
+    SearchKNearest( p, 1, maxDistSq, heap );
+    return heap.empty() ? kInvalidIndex : mIds[heap.front().second];
+}
+
+// 近い順にk個の点を探す
+uint32_t KdTree::FindKNearest( const Vector3& p, uint32_t k, std::vector<uint32_t>& indices, float maxDist ) const
+{
+    thread_local std::vector<std::pair<float, uint32_t>> heap;
+    auto maxDistSq = maxDist < FLT_MAX ? maxDist * maxDist : FLT_MAX;
+    SearchKNearest( p, k, maxDistSq, heap );
+
+    // ヒープを近い順に並べる
+    std::sort_heap( heap.begin(), heap.end() );
+    indices.resize( heap.size() );
+    for( size_t i = 0; i < heap.size(); ++i )
+    {
+        indices[i] = mIds[heap[i].second];
+    }
+    return static_cast<uint32_t>( heap.size() );
+}
+
+// 半径内の点を探す
+uint32_t KdTree::FindInRadius( const Vector3& p, float radius, std::vector<uint32_t>& indices ) const
+{
+    if( mPoints.empty() ) return 0;
+
+    auto radiusSq = radius * radius;
+    uint32_t found = 0;
+    uint32_t stack[kStackSize][2];
+    uint32_t stackSize = 0;
+    stack[stackSize][0] = 0;
+    stack[stackSize][1] = GetCount();
+    ++stackSize;
+    while( stackSize > 0 )
+    {
+        --stackSize;
+        auto begin = stack[stackSize][0];
+        auto end = stack[stackSize][1];
+        if( end - begin <= kLeafSize )
+        {
+            for( auto i = begin; i < end; ++i )
+            {
+                if( LengthSq( mPoints[i] - p ) <= radiusSq )
+                {
+                    indices.emplace_back( mIds[i] );
+                    ++found;
+                }
+            }
+            continue;
+        }
+
+        auto mid = ( begin + end ) / 2;
+        const auto& node = mPoints[mid];
+        if( LengthSq( node - p ) <= radiusSq )
+        {
+            indices.emplace_back( mIds[mid] );
+            ++found;
+        }
+
+        // 分割面から半径以内の側だけ調べる
+        auto diff = GetAxis( p, mAxes[mid] ) - GetAxis( node, mAxes[mid] );
+        assert( stackSize + 2 <= kStackSize );
+        if( diff - radius <= 0.0f )
+        {
+            stack[stackSize][0] = begin;
+            stack[stackSize][1] = mid;
+            ++stackSize;
+        }
+        if( diff + radius >= 0.0f )
+        {
+            stack[stackSize][0] = mid + 1;
+            stack[stackSize][1] = end;
+            ++stackSize;
+        }
+    }
+    return found;
+}
+
+// 最も近い点をまとめて探す
+void KdTree::FindNearestBatch( const std::vector<Vector3>& queries, std::vector<uint32_t>& results, float maxDist ) const
+{
+    auto queryCount = static_cast<uint32_t>( queries.size() );
+    results.resize( queryCount );
+    JobSystem::GetInstance().ParallelFor(
+        queryCount, kBatchSize,
+        [&]( uint32_t begin, uint32_t end )
+        {
+            for( auto i = begin; i < end; ++i )
+            {
+                results[i] = FindNearest( queries[i], maxDist );
+            }
+        } );
+}
+
+// 近い順にk個の点をまとめて探す
+void KdTree::FindKNearestBatch( const std::vector<Vector3>& queries, uint32_t k, std::vector<uint32_t>& results, float maxDist ) const
+{
+    auto queryCount = static_cast<uint32_t>( queries.size() );
+    results.assign( static_cast<size_t>( queryCount ) * k, kInvalidIndex );
+    JobSystem::GetInstance().ParallelFor(
+        queryCount, kBatchSize,
+        [&]( uint32_t begin, uint32_t end )
+        {
+            std::vector<uint32_t> indices;
+            indices.reserve( k );
+            for( auto i = begin; i < end; ++i )
+            {
+                auto found = FindKNearest( queries[i], k, indices, maxDist );
+                std::copy( indices.begin(), indices.begin() + found, results.begin() + static_cast<size_t>( i ) * k );
+            }
+        } );
+}
+
+// 半径内の点をまとめて探す
+void KdTree::FindInRadiusBatch( const std::vector<Vector3>& queries, float radius, std::vector<uint32_t>& indices, std::vector<uint32_t>& offsets ) const
+{
+    auto queryCount = static_cast<uint32_t>( queries.size() );
+    auto chunkCount = ( queryCount + kBatchSize - 1 ) / kBatchSize;
+    offsets.assign( queryCount + 1, 0 );
+    indices.clear();
+
+    // ジョブごとに集めてから連結する
+    std::vector<std::vector<uint32_t>> chunkIndices( chunkCount );
+    JobSystem::GetInstance().ParallelFor(
+        queryCount, kBatchSize,
+        [&]( uint32_t begin, uint32_t end )
+        {
+            auto& chunk = chunkIndices[begin / kBatchSize];
+            for( auto i = begin; i < end; ++i )
+            {
+                offsets[i + 1] = FindInRadius( queries[i], radius, chunk );
+            }
+        } );
+
+    for( uint32_t i = 0; i < queryCount; ++i )
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    indices.reserve( offsets[queryCount] );
+    for( const auto& chunk : chunkIndices )
+    {
+        indices.insert( indices.end(), chunk.begin(), chunk.end() );
+    }
+}
+
+// 近い順にk個の点を探す(木の順のインデックスと距離の2乗)
+void KdTree::SearchKNearest( const Vector3& p, uint32_t k, float maxDistSq, std::vector<std::pair<float, uint32_t>>& heap ) const
+{
+    heap.clear();
+    if( mPoints.empty() || k == 0 ) return;
+
+    // 見つかったk個のうち最も遠いもの(少なければ最大距離)より近い範囲だけを調べる
+    auto getWorst = [&]()
+    {
+        return heap.size() < k ? maxDistSq : heap.front().first;
+    };
+    auto push = [&]( float distSq, uint32_t idx )
+    {
+        if( distSq >= getWorst() ) return;
+
+        if( heap.size() == k )
+        {
+            std::pop_heap( heap.begin(), heap.end() );
+            heap.pop_back();
+        }
+        heap.emplace_back( distSq, idx );
+        std::push_heap( heap.begin(), heap.end() );
+    };
+
+    Range stack[kStackSize];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = Range{ 0, GetCount(), 0.0f };
+    while( stackSize > 0 )
+    {
+        auto range = stack[--stackSize];
+        if( range.mMinDistSq >= getWorst() ) continue;
+
+        if( range.mEnd - range.mBegin <= kLeafSize )
+        {
+            for( auto i = range.mBegin; i < range.mEnd; ++i )
+            {
+                push( LengthSq( mPoints[i] - p ), i );
+            }
+            continue;
+        }
+
+        auto mid = ( range.mBegin + range.mEnd ) / 2;
+        const auto& node = mPoints[mid];
+        push( LengthSq( node - p ), mid );
+
+        // 近い側を後に積んで先に調べる
+        auto diff = GetAxis( p, mAxes[mid] ) - GetAxis( node, mAxes[mid] );
+        auto nearRange = diff < 0.0f ? Range{ range.mBegin, mid, range.mMinDistSq } : Range{ mid + 1, range.mEnd, range.mMinDistSq };
+        auto farRange = diff < 0.0f ? Range{ mid + 1, range.mEnd, 0.0f } : Range{ range.mBegin, mid, 0.0f };
+        farRange.mMinDistSq = ( std::max )( range.mMinDistSq, diff * diff );
+        assert( stackSize + 2 <= kStackSize );
+        stack[stackSize++] = farRange;
+        stack[stackSize++] = nearRange;
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <cassert>
+#include <cfloat>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "math/Vector3.h"
+
+/// <summary>
+/// 点群のk-d木(静的、中央値分割の暗黙的な木)
+/// 点を木の順に並べ替えて1つの配列に持ち、範囲 [begin, end) の中央がその部分木の節になる
+/// </summary>
+class KdTree
+{
+   public:
+    // 見つからなかったときのインデックス
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+   private:
+    // これ以下の要素数の範囲は分割せずに総当たりする
+    static constexpr uint32_t kLeafSize = 8;
+    // 探索スタックの深さ(中央値分割の木は32ビットの要素数で深さ32を超えず、1段下りるごとに1つしか増えない)
+    static constexpr uint32_t kStackSize = 64;
+    // 1ジョブあたりのクエリ数
+    static constexpr uint32_t kBatchSize = 256;
+
+    // 点(木の順)
+    std::vector<Vector3> mPoints;
+    // 元のインデックス(木の順)
+    std::vector<uint32_t> mIds;
+    // 節の分割軸(木の順、節の位置のみ有効)
+    std::vector<uint8_t> mAxes;
+    // 木の深さ(葉の範囲を含む)
+    uint32_t mDepth;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    KdTree();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~KdTree() = default;
+
+    /// <summary>
+    /// 構築
+    /// </summary>
+    /// <param name="points">点</param>
+    /// <returns>成否</returns>
+    bool Build( const std::vector<Vector3>& points );
+
+    /// <summary>
+    /// 最も近い点を探す
+    /// </summary>
+    /// <param name="p">位置</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <returns>元のインデックス(無ければkInvalidIndex)</returns>
+    uint32_t FindNearest( const Vector3& p, float maxDist = FLT_MAX ) const;
+
+    /// <summary>
+    /// 近い順にk個の点を探す
+    /// </summary>
+    /// <param name="p">位置</param>
+    /// <param name="k">個数</param>
+    /// <param name="indices">元のインデックス(出力、近い順)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <returns>見つかった数</returns>
+    uint32_t FindKNearest( const Vector3& p, uint32_t k, std::vector<uint32_t>& indices, float maxDist = FLT_MAX ) const;
+
+    /// <summary>
+    /// 半径内の点を探す
+    /// </summary>
+    /// <param name="p">位置</param>
+    /// <param name="radius">半径</param>
+    /// <param name="indices">元のインデックス(末尾に追加、順不同)</param>
+    /// <returns>見つかった数</returns>
+    uint32_t FindInRadius( const Vector3& p, float radius, std::vector<uint32_t>& indices ) const;
+
+    /// <summary>
+    /// 最も近い点をまとめて探す(並列)
+    /// </summary>
+    /// <param name="queries">位置</param>
+    /// <param name="results">元のインデックス(出力、クエリ順)</param>
+    /// <param name="maxDist">最大距離</param>
+    void FindNearestBatch( const std::vector<Vector3>& queries, std::vector<uint32_t>& results, float maxDist = FLT_MAX ) const;
+
+    /// <summary>
+    /// 近い順にk個の点をまとめて探す(並列)
+    /// </summary>
+    /// <param name="queries">位置</param>
+    /// <param name="k">個数</param>
+    /// <param name="results">元のインデックス(出力、クエリごとにk個、足りなければkInvalidIndex)</param>
+    /// <param name="maxDist">最大距離</param>
+    void FindKNearestBatch( const std::vector<Vector3>& queries, uint32_t k, std::vector<uint32_t>& results, float maxDist = FLT_MAX ) const;
+
+    /// <summary>
+    /// 半径内の点をまとめて探す(並列)
+    /// </summary>
+    /// <param name="queries">位置</param>
+    /// <param name="radius">半径</param>
+    /// <param name="indices">元のインデックス(出力、全クエリ分を連続して格納)</param>
+    /// <param name="offsets">クエリごとの先頭(出力、クエリ数+1個)</param>
+    void FindInRadiusBatch( const std::vector<Vector3>& queries, float radius, std::vector<uint32_t>& indices, std::vector<uint32_t>& offsets ) const;
+
+    /// <summary>点の数を取得</summary>
+    uint32_t GetCount() const { return static_cast<uint32_t>( mPoints.size() ); }
+
+    /// <summary>木の深さを取得</summary>
+    uint32_t GetDepth() const { return mDepth; }
+
+    /// <summary>使用メモリ(バイト)を取得</summary>
+    size_t GetMemorySize() const { return mPoints.size() * sizeof( Vector3 ) + mIds.size() * sizeof( uint32_t ) + mAxes.size(); }
+
+   private:
+    /// <summary>
+    /// 近い順にk個の点を探す(木の順のインデックスと距離の2乗)
+    /// </summary>
+    /// <param name="p">位置</param>
+    /// <param name="k">個数</param>
+    /// <param name="maxDistSq">最大距離の2乗</param>
+    /// <param name="heap">距離の2乗と木の順のインデックスの最大ヒープ(出力)</param>
+    void SearchKNearest( const Vector3& p, uint32_t k, float maxDistSq, std::vector<std::pair<float, uint32_t>>& heap ) const;
+};
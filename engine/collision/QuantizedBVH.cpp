@@ -0,0 +1,340 @@
+#include "QuantizedBVH.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+
+// 量子化の最大値
+const float kQuantMax = 65535.0f;
+// 復元した境界が親の最大値に届くように刻みをわずかに大きくする
+const float kScaleBias = 1.0f + 1.0f / ( 1 << 20 );
+
+// 軸ごとの刻み
+Vector3 GetScale( const AABB3D& aabb )
+{
+    return ( aabb.mMax - aabb.mMin ) * ( kScaleBias / kQuantMax );
+}
+
+// 軸の成分を取得
+float GetAxis( const Vector3& v, uint32_t axis )
+{
+    return axis == 0 ? v.x : ( axis == 1 ? v.y : v.z );
+}
+
+// 最小値を量子化(復元値が元の値以下になるように)
+uint16_t QuantizeMin( float v, float parentMin, float scale )
+{
+    if( scale <= 0.0f ) return 0;
+
+    auto q = static_cast<int32_t>( std::floor( ( v - parentMin ) / scale ) );
+    q = std::clamp( q, 0, 65535 );
+    while( q > 0 && parentMin + q * scale > v )
+    {
+        --q;
+    }
+    return static_cast<uint16_t>( q );
+}
+
+// 最大値を量子化(復元値が元の値以上になるように)
+uint16_t QuantizeMax( float v, float parentMin, float scale )
+{
+    if( scale <= 0.0f ) return 0;
+
+    auto q = static_cast<int32_t>( std::ceil( ( v - parentMin ) / scale ) );
+    q = std::clamp( q, 0, 65535 );
+    while( q < 65535 && parentMin + q * scale < v )
+    {
+        ++q;
+    }
+    return static_cast<uint16_t>( q );
+}
+
+}  // namespace
+
+// コンストラクタ
+QuantizedBVH::QuantizedBVH()
+    : mNodes()
+    , mDepths()
+    , mRootAABB()
+    , mPositions()
+    , mIndices()
+    , mTriangleIds()
+{
+}
+
+// 構築
+bool QuantizedBVH::Build( const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, uint32_t maxLeafSize )
+{
+    mNodes.clear();
+    mDepths.clear();
+    mIndices.clear();
+    mTriangleIds.clear();
+
+    auto triCount = static_cast<uint32_t>( indices.size() / 3 );
+    if( triCount == 0 || triCount > kFirstMask + 1 ) return false;
+
+    // まず浮動小数点のBVHを作り、それを量子化する
+    std::vector<AABB3D> bounds( triCount );
+    for( uint32_t i = 0; i < triCount; ++i )
+    {
+        bounds[i].Reset();
+        bounds[i].Update( positions[indices[i * 3 + 0]] );
+        bounds[i].Update( positions[indices[i * 3 + 1]] );
+        bounds[i].Update( positions[indices[i * 3 + 2]] );
+    }
+    BVH bvh;
+    if( !bvh.Build( bounds, std::clamp( maxLeafSize, 1u, kCountMask ) ) ) return false;
+
+    mPositions = positions;
+    mRootAABB = bvh.GetBounds();
+    mNodes.reserve( bvh.GetNodes().size() );
+    mDepths.reserve( bvh.GetNodes().size() );
+    mIndices.reserve( triCount * 3 );
+    mTriangleIds.reserve( triCount );
+    if( !Emit( bvh, 0, mRootAABB, 0, indices ) )
+    {
+        mNodes.clear();
+        mDepths.clear();
+        return false;
+    }
+    return true;
+}
+
+// 半直線で判定(スタックを使い近い順に探索)
+bool QuantizedBVH::Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    hit = {};
+    if( mNodes.empty() ) return false;
+
+    struct Entry
+    {
+        uint32_t mIdx;
+        AABB3D mAABB;
+    };
+    auto invDir = Vector3( 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z );
+    auto maxT = maxDist;
+    auto hitTri = UINT32_MAX;
+    // 深さ d の内部ノードを展開した後の要素数は d + 2 なので深さの上限で足りる
+    Entry stack[kMaxDepth];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = Entry{ 0, Decode( mNodes[0], mRootAABB ) };
+    while( stackSize > 0 )
+    {
+        const auto entry = stack[--stackSize];
+        float t = 0.0f;
+        if( !IntersectRay( origin, invDir, entry.mAABB, maxT, t ) ) continue;
+
+        const auto& node = mNodes[entry.mIdx];
+        if( node.mData & kLeafFlag )
+        {
+            IntersectLeaf( node, origin, dir, maxT, hitTri );
+            continue;
+        }
+
+        // 子の境界はこのノードの境界から復元する
+        auto left = entry.mIdx + 1;
+        auto right = GetSkipIndex( left );
+        Entry nearEntry = { left, Decode( mNodes[left], entry.mAABB ) };
+        Entry farEntry = { right, Decode( mNodes[right], entry.mAABB ) };
+        auto leftCenter = nearEntry.mAABB.mMin + nearEntry.mAABB.mMax;
+        auto rightCenter = farEntry.mAABB.mMin + farEntry.mAABB.mMax;
+        if( Dot( rightCenter - leftCenter, dir ) < 0.0f )
+        {
+            std::swap( nearEntry, farEntry );
+        }
+        assert( stackSize + 2 <= kMaxDepth );
+        stack[stackSize++] = farEntry;
+        stack[stackSize++] = nearEntry;
+    }
+
+    return MakeHit( origin, dir, maxT, hitTri, hit );
+}
+
+// 半直線で判定(スタックなしで深さ優先順に探索)
+bool QuantizedBVH::RaycastStackless( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    hit = {};
+    if( mNodes.empty() ) return false;
+
+    auto invDir = Vector3( 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z );
+    auto maxT = maxDist;
+    auto hitTri = UINT32_MAX;
+    // 深さごとの親の境界(深さ優先順なので次のノードの親は常に今の経路上にある)
+    AABB3D parents[kMaxDepth + 1];
+    parents[0] = mRootAABB;
+    auto nodeCount = GetNodeCount();
+    uint32_t idx = 0;
+    while( idx < nodeCount )
+    {
+        const auto& node = mNodes[idx];
+        auto depth = mDepths[idx];
+        auto aabb = Decode( node, parents[depth] );
+        float t = 0.0f;
+        if( !IntersectRay( origin, invDir, aabb, maxT, t ) )
+        {
+            idx = GetSkipIndex( idx );
+            continue;
+        }
+
+        if( node.mData & kLeafFlag )
+        {
+            IntersectLeaf( node, origin, dir, maxT, hitTri );
+        }
+        else
+        {
+            parents[depth + 1] = aabb;
+        }
+        ++idx;
+    }
+
+    return MakeHit( origin, dir, maxT, hitTri, hit );
+}
+
+// AABBと境界が重なる三角形を列挙
+uint32_t QuantizedBVH::OverlapAABB( const AABB3D& aabb, std::vector<uint32_t>& triangles ) const
+{
+    if( mNodes.empty() ) return 0;
+
+    uint32_t count = 0;
+    AABB3D parents[kMaxDepth + 1];
+    parents[0] = mRootAABB;
+    auto nodeCount = GetNodeCount();
+    uint32_t idx = 0;
+    while( idx < nodeCount )
+    {
+        const auto& node = mNodes[idx];
+        auto depth = mDepths[idx];
+        auto nodeAABB = Decode( node, parents[depth] );
+        if( !Intersect( nodeAABB, aabb ) )
+        {
+            idx = GetSkipIndex( idx );
+            continue;
+        }
+
+        if( node.mData & kLeafFlag )
+        {
+            auto first = node.mData & kFirstMask;
+            auto triCount = ( node.mData >> kCountShift ) & kCountMask;
+            for( auto tri = first; tri < first + triCount; ++tri )
+            {
+                AABB3D bounds = {};
+                bounds.Reset();
+                bounds.Update( mPositions[mIndices[tri * 3 + 0]] );
+                bounds.Update( mPositions[mIndices[tri * 3 + 1]] );
+                bounds.Update( mPositions[mIndices[tri * 3 + 2]] );
+                if( Intersect( bounds, aabb ) )
+                {
+                    triangles.emplace_back( mTriangleIds[tri] );
+                    ++count;
+                }
+            }
+        }
+        else
+        {
+            parents[depth + 1] = nodeAABB;
+        }
+        ++idx;
+    }
+    return count;
+}
+
+// ノードを深さ優先順に書き出す
+bool QuantizedBVH::Emit( const BVH& bvh, uint32_t srcIdx, const AABB3D& parentAABB, uint32_t depth, const std::vector<uint32_t>& indices )
+{
+    // 元のBVHは深さの上限で葉にするので越えることはない
+    assert( depth < kMaxDepth );
+    if( depth >= kMaxDepth ) return false;
+
+    const auto& src = bvh.GetNodes()[srcIdx];
+    // 深さの上限で止めた葉は三角形数を持てないことがある(黙って切り捨てずに失敗にする)
+    if( src.IsLeaf() && src.mCount > kCountMask ) return false;
+    auto scale = GetScale( parentAABB );
+    Node node = {};
+    for( uint32_t axis = 0; axis < 3; ++axis )
+    {
+        auto parentMin = GetAxis( parentAABB.mMin, axis );
+        node.mMin[axis] = QuantizeMin( GetAxis( src.mAABB.mMin, axis ), parentMin, GetAxis( scale, axis ) );
+        node.mMax[axis] = QuantizeMax( GetAxis( src.mAABB.mMax, axis ), parentMin, GetAxis( scale, axis ) );
+    }
+
+    auto idx = static_cast<uint32_t>( mNodes.size() );
+    mNodes.emplace_back( node );
+    mDepths.emplace_back( static_cast<uint8_t>( depth ) );
+
+    if( src.IsLeaf() )
+    {
+        // 三角形を葉の順に並べ替えて連続させる
+        auto first = static_cast<uint32_t>( mTriangleIds.size() );
+        for( uint32_t i = 0; i < src.mCount; ++i )
+        {
+            auto tri = bvh.GetPrimIndices()[src.mLeftOrFirst + i];
+            mIndices.emplace_back( indices[tri * 3 + 0] );
+            mIndices.emplace_back( indices[tri * 3 + 1] );
+            mIndices.emplace_back( indices[tri * 3 + 2] );
+            mTriangleIds.emplace_back( tri );
+        }
+        mNodes[idx].mData = kLeafFlag | src.mCount << kCountShift | first;
+        return true;
+    }
+
+    // 子は復元した境界を親として量子化する(探索時と同じ値になる)
+    auto aabb = Decode( mNodes[idx], parentAABB );
+    if( !Emit( bvh, src.mLeftOrFirst, aabb, depth + 1, indices ) ) return false;
+    if( !Emit( bvh, src.mLeftOrFirst + 1, aabb, depth + 1, indices ) ) return false;
+
+    mNodes[idx].mData = static_cast<uint32_t>( mNodes.size() );
+    return true;
+}
+
+// 境界を復元
+AABB3D QuantizedBVH::Decode( const Node& node, const AABB3D& parentAABB )
+{
+    auto scale = GetScale( parentAABB );
+    AABB3D aabb = {};
+    aabb.mMin = Vector3(
+        parentAABB.mMin.x + node.mMin[0] * scale.x,
+        parentAABB.mMin.y + node.mMin[1] * scale.y,
+        parentAABB.mMin.z + node.mMin[2] * scale.z );
+    aabb.mMax = Vector3(
+        parentAABB.mMin.x + node.mMax[0] * scale.x,
+        parentAABB.mMin.y + node.mMax[1] * scale.y,
+        parentAABB.mMin.z + node.mMax[2] * scale.z );
+    return aabb;
+}
+
+// 葉の三角形と判定
+void QuantizedBVH::IntersectLeaf( const Node& node, const Vector3& origin, const Vector3& dir, float& maxT, uint32_t& hitTri ) const
+{
+    auto first = node.mData & kFirstMask;
+    auto triCount = ( node.mData >> kCountShift ) & kCountMask;
+    for( auto tri = first; tri < first + triCount; ++tri )
+    {
+        float t = 0.0f;
+        const auto& v0 = mPositions[mIndices[tri * 3 + 0]];
+        const auto& v1 = mPositions[mIndices[tri * 3 + 1]];
+        const auto& v2 = mPositions[mIndices[tri * 3 + 2]];
+        if( IntersectRay( origin, dir, v0, v1, v2, maxT, t ) )
+        {
+            maxT = t;
+            hitTri = tri;
+        }
+    }
+}
+
+// 結果を作成
+bool QuantizedBVH::MakeHit( const Vector3& origin, const Vector3& dir, float t, uint32_t tri, RaycastHit& hit ) const
+{
+    if( tri == UINT32_MAX ) return false;
+
+    const auto& v0 = mPositions[mIndices[tri * 3 + 0]];
+    const auto& v1 = mPositions[mIndices[tri * 3 + 1]];
+    const auto& v2 = mPositions[mIndices[tri * 3 + 2]];
+    hit.mIsHit = true;
+    hit.mId = mTriangleIds[tri];
+    hit.mDistance = t;
+    hit.mPoint = origin + dir * t;
+    hit.mNormal = Normalize( Cross( v1 - v0, v2 - v0 ) );
+    return true;
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "BVH.h"
+#include "CollisionScene.h"
+
+/// <summary>
+/// 量子化した三角形メッシュのBVH(大規模な静的コリジョン用)
+/// ノードの境界を親の境界に対する16ビットで持ち、深さ優先順に並べる
+/// 復元した境界は元の境界を必ず含み、各面の広がりは親の大きさの 2/65535 以内
+/// </summary>
+class QuantizedBVH
+{
+   public:
+    /// <summary>
+    /// ノード(16バイト)
+    /// </summary>
+    struct alignas( 8 ) Node
+    {
+        // 親の境界に対する量子化した境界
+        uint16_t mMin[3];
+        uint16_t mMax[3];
+        // 葉: kLeafFlag | 三角形数 << kCountShift | 先頭の三角形
+        // 内部: 部分木を飛ばした次のノード(左の子は直後)
+        uint32_t mData;
+    };
+    static_assert( sizeof( Node ) == 16, "QuantizedBVH::Node must be 16 bytes." );
+
+    // 木の深さの上限(元のBVHが構築時にこの深さで止める)
+    static constexpr uint32_t kMaxDepth = BVH::kMaxDepth;
+
+   private:
+    static constexpr uint32_t kLeafFlag = 0x80000000;
+    static constexpr uint32_t kCountShift = 24;
+    static constexpr uint32_t kCountMask = 0x7f;
+    static constexpr uint32_t kFirstMask = 0x00ffffff;
+
+    // ノード(深さ優先順、0がルート)
+    std::vector<Node> mNodes;
+    // ノードの深さ(スタックなしの探索用)
+    std::vector<uint8_t> mDepths;
+    // ルートの境界
+    AABB3D mRootAABB;
+    // 頂点座標
+    std::vector<Vector3> mPositions;
+    // 葉の順に並べた三角形の頂点インデックス
+    std::vector<uint32_t> mIndices;
+    // 並べ替え前の三角形のインデックス
+    std::vector<uint32_t> mTriangleIds;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    QuantizedBVH();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~QuantizedBVH() = default;
+
+    /// <summary>
+    /// 構築
+    /// </summary>
+    /// <param name="positions">頂点座標</param>
+    /// <param name="indices">三角形の頂点インデックス</param>
+    /// <param name="maxLeafSize">葉に入れる三角形の最大数</param>
+    /// <returns>成否</returns>
+    bool Build( const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, uint32_t maxLeafSize = 4 );
+
+    /// <summary>
+    /// 半直線で判定(スタックを使い近い順に探索)
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力、IDは三角形のインデックス)</param>
+    /// <returns>当たったか</returns>
+    bool Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// 半直線で判定(スタックなしで深さ優先順に探索)
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力、IDは三角形のインデックス)</param>
+    /// <returns>当たったか</returns>
+    bool RaycastStackless( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// AABBと境界が重なる三角形を列挙(スタックなし)
+    /// </summary>
+    /// <param name="aabb">範囲</param>
+    /// <param name="triangles">三角形のインデックス(末尾に追加)</param>
+    /// <returns>見つかった数</returns>
+    uint32_t OverlapAABB( const AABB3D& aabb, std::vector<uint32_t>& triangles ) const;
+
+    /// <summary>三角形数を取得</summary>
+    uint32_t GetTriangleCount() const { return static_cast<uint32_t>( mTriangleIds.size() ); }
+
+    /// <summary>ノード数を取得</summary>
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>( mNodes.size() ); }
+
+    /// <summary>階層の使用メモリ(バイト)を取得(頂点・インデックスを除く)</summary>
+    size_t GetMemorySize() const { return mNodes.size() * sizeof( Node ) + mDepths.size() + mTriangleIds.size() * sizeof( uint32_t ); }
+
+   private:
+    /// <summary>
+    /// ノードを深さ優先順に書き出す
+    /// </summary>
+    /// <param name="bvh">元のBVH</param>
+    /// <param name="srcIdx">元のノードのインデックス</param>
+    /// <param name="parentAABB">親の復元した境界</param>
+    /// <param name="depth">深さ</param>
+    /// <param name="indices">元の三角形の頂点インデックス</param>
+    /// <returns>成否</returns>
+    bool Emit( const BVH& bvh, uint32_t srcIdx, const AABB3D& parentAABB, uint32_t depth, const std::vector<uint32_t>& indices );
+
+    /// <summary>
+    /// 境界を復元
+    /// </summary>
+    /// <param name="node">ノード</param>
+    /// <param name="parentAABB">親の復元した境界</param>
+    /// <returns>境界</returns>
+    static AABB3D Decode( const Node& node, const AABB3D& parentAABB );
+
+    /// <summary>
+    /// 部分木を飛ばした次のノードを取得
+    /// </summary>
+    /// <param name="idx">ノードのインデックス</param>
+    /// <returns>次のノードのインデックス</returns>
+    uint32_t GetSkipIndex( uint32_t idx ) const
+    {
+        const auto& node = mNodes[idx];
+        return ( node.mData & kLeafFlag ) ? idx + 1 : node.mData;
+    }
+
+    /// <summary>
+    /// 葉の三角形と判定
+    /// </summary>
+    /// <param name="node">葉のノード</param>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き</param>
+    /// <param name="maxT">最大距離(当たれば縮める)</param>
+    /// <param name="hitTri">当たった三角形(出力)</param>
+    void IntersectLeaf( const Node& node, const Vector3& origin, const Vector3& dir, float& maxT, uint32_t& hitTri ) const;
+
+    /// <summary>
+    /// 結果を作成
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き</param>
+    /// <param name="t">距離</param>
+    /// <param name="tri">当たった三角形(葉の順)</param>
+    /// <param name="hit">結果(出力)</param>
+    /// <returns>当たったか</returns>
+    bool MakeHit( const Vector3& origin, const Vector3& dir, float t, uint32_t tri, RaycastHit& hit ) const;
+};
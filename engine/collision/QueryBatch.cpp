@@ -0,0 +1,202 @@
+#include "QueryBatch.h"
+
+#include <algorithm>
+
+#include "utils/JobSystem.h"
+
+namespace
+{
+
+// 10ビットを3ビット間隔に広げる
+uint32_t ExpandBits( uint32_t v )
+{
+    v = ( v | ( v << 16 ) ) & 0x030000ff;
+    v = ( v | ( v << 8 ) ) & 0x0300f00f;
+    v = ( v | ( v << 4 ) ) & 0x030c30c3;
+    v = ( v | ( v << 2 ) ) & 0x09249249;
+    return v;
+}
+
+// 0～1の値を10ビットに量子化
+uint32_t Quantize( float v )
+{
+    return static_cast<uint32_t>( std::clamp( v, 0.0f, 1.0f ) * 1023.0f );
+}
+
+}  // namespace
+
+// コンストラクタ
+QueryBatch::QueryBatch()
+    : mQueries()
+    , mOrder()
+    , mSortKeys()
+    , mResults()
+    , mOverlapIds()
+    , mChunkIds()
+    , mIsSortEnabled( true )
+{
+}
+
+// 半直線のクエリを追加
+uint32_t QueryBatch::AddRaycast( const Vector3& origin, const Vector3& dir, float maxDist )
+{
+    Query query = {};
+    query.mType = QueryType::kRaycast;
+    query.mOrigin = origin;
+    query.mDirection = Normalize( dir );
+    query.mMaxDist = maxDist;
+    mQueries.emplace_back( query );
+    return static_cast<uint32_t>( mQueries.size() - 1 );
+}
+
+// 球の掃引のクエリを追加
+uint32_t QueryBatch::AddSweepSphere( const Sphere& sphere, const Vector3& dir, float maxDist )
+{
+    Query query = {};
+    query.mType = QueryType::kSweepSphere;
+    query.mOrigin = sphere.mCenter;
+    query.mDirection = Normalize( dir );
+    query.mMaxDist = maxDist;
+    query.mRadius = sphere.mRadius;
+    mQueries.emplace_back( query );
+    return static_cast<uint32_t>( mQueries.size() - 1 );
+}
+
+// 球の重なりのクエリを追加
+uint32_t QueryBatch::AddOverlapSphere( const Sphere& sphere )
+{
+    Query query = {};
+    query.mType = QueryType::kOverlapSphere;
+    query.mOrigin = sphere.mCenter;
+    query.mRadius = sphere.mRadius;
+    mQueries.emplace_back( query );
+    return static_cast<uint32_t>( mQueries.size() - 1 );
+}
+
+// AABBの重なりのクエリを追加
+uint32_t QueryBatch::AddOverlapAABB( const AABB3D& aabb )
+{
+    Query query = {};
+    query.mType = QueryType::kOverlapAABB;
+    query.mOrigin = ( aabb.mMin + aabb.mMax ) * 0.5f;
+    query.mAABB = aabb;
+    mQueries.emplace_back( query );
+    return static_cast<uint32_t>( mQueries.size() - 1 );
+}
+
+// 溜めたクエリを並列に実行
+void QueryBatch::Execute( const CollisionScene& scene )
+{
+    auto queryCount = GetQueryCount();
+    mResults.resize( queryCount );
+    mOverlapIds.clear();
+    if( queryCount == 0 ) return;
+
+    mOrder.resize( queryCount );
+    for( uint32_t i = 0; i < queryCount; ++i )
+    {
+        mOrder[i] = i;
+    }
+    if( mIsSortEnabled )
+    {
+        SortQueries( scene.GetBounds() );
+    }
+
+    // ジョブごとに重なりの一時バッファを持つ
+    auto chunkCount = ( queryCount + kBatchSize - 1 ) / kBatchSize;
+    if( mChunkIds.size() < chunkCount )
+    {
+        mChunkIds.resize( chunkCount );
+    }
+
+    JobSystem::GetInstance().ParallelFor(
+        queryCount, kBatchSize,
+        [&]( uint32_t begin, uint32_t end )
+        {
+            // ワーカーがいないと範囲がまとめて渡されるので、一時バッファの単位に分けて実行する
+            for( uint32_t chunkBegin = begin; chunkBegin < end; chunkBegin += kBatchSize )
+            {
+                auto& ids = mChunkIds[chunkBegin / kBatchSize];
+                ids.clear();
+                auto chunkEnd = ( std::min )( chunkBegin + kBatchSize, end );
+                for( uint32_t i = chunkBegin; i < chunkEnd; ++i )
+                {
+                    auto idx = mOrder[i];
+                    ExecuteOne( scene, mQueries[idx], mResults[idx], ids );
+                }
+            }
+        } );
+
+    // 一時バッファを連結してオフセットを確定する
+    for( uint32_t chunk = 0; chunk < chunkCount; ++chunk )
+    {
+        auto base = static_cast<uint32_t>( mOverlapIds.size() );
+        auto begin = chunk * kBatchSize;
+        auto end = ( std::min )( begin + kBatchSize, queryCount );
+        for( uint32_t i = begin; i < end; ++i )
+        {
+            mResults[mOrder[i]].mOverlapOffset += base;
+        }
+        const auto& ids = mChunkIds[chunk];
+        mOverlapIds.insert( mOverlapIds.end(), ids.begin(), ids.end() );
+    }
+}
+
+// クエリと結果をすべて削除
+void QueryBatch::Clear()
+{
+    mQueries.clear();
+    mResults.clear();
+    mOverlapIds.clear();
+}
+
+// 実行順を空間的に近いものが並ぶように並べ替える
+void QueryBatch::SortQueries( const AABB3D& bounds )
+{
+    auto queryCount = GetQueryCount();
+    auto extent = bounds.mMax - bounds.mMin;
+    auto invExtent = Vector3(
+        extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+        extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+        extent.z > 0.0f ? 1.0f / extent.z : 0.0f );
+
+    // 種類 | モートン符号 | インデックス
+    mSortKeys.resize( queryCount );
+    for( uint32_t i = 0; i < queryCount; ++i )
+    {
+        const auto& query = mQueries[i];
+        auto p = query.mOrigin - bounds.mMin;
+        auto morton = ExpandBits( Quantize( p.x * invExtent.x ) ) << 2 |
+                      ExpandBits( Quantize( p.y * invExtent.y ) ) << 1 |
+                      ExpandBits( Quantize( p.z * invExtent.z ) );
+        mSortKeys[i] = static_cast<uint64_t>( query.mType ) << 62 | static_cast<uint64_t>( morton ) << 32 | i;
+    }
+    std::sort( mSortKeys.begin(), mSortKeys.end() );
+    for( uint32_t i = 0; i < queryCount; ++i )
+    {
+        mOrder[i] = static_cast<uint32_t>( mSortKeys[i] & 0xffffffff );
+    }
+}
+
+// クエリを1つ実行
+void QueryBatch::ExecuteOne( const CollisionScene& scene, const Query& query, Result& result, std::vector<uint32_t>& ids ) const
+{
+    result.mHit = {};
+    result.mOverlapOffset = static_cast<uint32_t>( ids.size() );
+    result.mOverlapCount = 0;
+    switch( query.mType )
+    {
+        case QueryType::kRaycast:
+            scene.Raycast( query.mOrigin, query.mDirection, query.mMaxDist, result.mHit );
+            break;
+        case QueryType::kSweepSphere:
+            scene.SweepSphere( Sphere{ query.mOrigin, query.mRadius }, query.mDirection, query.mMaxDist, result.mHit );
+            break;
+        case QueryType::kOverlapSphere:
+            result.mOverlapCount = scene.OverlapSphere( Sphere{ query.mOrigin, query.mRadius }, ids );
+            break;
+        case QueryType::kOverlapAABB:
+            result.mOverlapCount = scene.OverlapAABB( query.mAABB, ids );
+            break;
+    }
+}
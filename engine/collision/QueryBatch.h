@@ -0,0 +1,158 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "CollisionScene.h"
+
+/// <summary>
+/// シーンクエリの一括実行
+/// 要求を溜めておき、同期点で並列に実行して結果を連続したバッファへ書き出す
+/// </summary>
+class QueryBatch
+{
+   public:
+    /// <summary>
+    /// クエリの種類
+    /// </summary>
+    enum class QueryType : uint8_t
+    {
+        kRaycast,
+        kSweepSphere,
+        kOverlapSphere,
+        kOverlapAABB,
+    };
+
+    /// <summary>
+    /// クエリの結果
+    /// </summary>
+    struct Result
+    {
+        // 半直線・掃引の結果
+        RaycastHit mHit;
+        // 重なりの結果(GetOverlapIdsの範囲)
+        uint32_t mOverlapOffset;
+        uint32_t mOverlapCount;
+    };
+
+   private:
+    // 1ジョブあたりのクエリ数
+    static constexpr uint32_t kBatchSize = 64;
+
+    /// <summary>
+    /// クエリ
+    /// </summary>
+    struct Query
+    {
+        QueryType mType;
+        // 始点または中心
+        Vector3 mOrigin;
+        // 向き(正規化済み)
+        Vector3 mDirection;
+        // 最大距離
+        float mMaxDist;
+        // 半径
+        float mRadius;
+        // 範囲(AABBの重なり用)
+        AABB3D mAABB;
+    };
+
+    // 溜めたクエリ
+    std::vector<Query> mQueries;
+    // 実行順(空間的に近いものが並ぶように並べ替える)
+    std::vector<uint32_t> mOrder;
+    // 並べ替えのキー
+    std::vector<uint64_t> mSortKeys;
+    // 結果(クエリの追加順)
+    std::vector<Result> mResults;
+    // 重なったコライダーのID(全クエリ分を連続して格納)
+    std::vector<uint32_t> mOverlapIds;
+    // ジョブごとの重なりの一時バッファ
+    std::vector<std::vector<uint32_t>> mChunkIds;
+    // 空間順に並べ替えるか
+    bool mIsSortEnabled;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    QueryBatch();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~QueryBatch() = default;
+
+    /// <summary>
+    /// 半直線のクエリを追加
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <returns>結果のハンドル</returns>
+    uint32_t AddRaycast( const Vector3& origin, const Vector3& dir, float maxDist );
+
+    /// <summary>
+    /// 球の掃引のクエリを追加
+    /// </summary>
+    /// <param name="sphere">始点の球</param>
+    /// <param name="dir">向き</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <returns>結果のハンドル</returns>
+    uint32_t AddSweepSphere( const Sphere& sphere, const Vector3& dir, float maxDist );
+
+    /// <summary>
+    /// 球の重なりのクエリを追加
+    /// </summary>
+    /// <param name="sphere">範囲</param>
+    /// <returns>結果のハンドル</returns>
+    uint32_t AddOverlapSphere( const Sphere& sphere );
+
+    /// <summary>
+    /// AABBの重なりのクエリを追加
+    /// </summary>
+    /// <param name="aabb">範囲</param>
+    /// <returns>結果のハンドル</returns>
+    uint32_t AddOverlapAABB( const AABB3D& aabb );
+
+    /// <summary>
+    /// 溜めたクエリを並列に実行(同期点)
+    /// </summary>
+    /// <param name="scene">対象のシーン</param>
+    void Execute( const CollisionScene& scene );
+
+    /// <summary>
+    /// クエリと結果をすべて削除(確保したメモリは再利用する)
+    /// </summary>
+    void Clear();
+
+    /// <summary>結果を取得</summary>
+    const Result& GetResult( uint32_t handle ) const { return mResults[handle]; }
+
+    /// <summary>結果をすべて取得(ハンドル順)</summary>
+    const std::vector<Result>& GetResults() const { return mResults; }
+
+    /// <summary>重なったコライダーのIDを取得(Result::mOverlapOffsetから mOverlapCount 個)</summary>
+    const std::vector<uint32_t>& GetOverlapIds() const { return mOverlapIds; }
+
+    /// <summary>クエリ数を取得</summary>
+    uint32_t GetQueryCount() const { return static_cast<uint32_t>( mQueries.size() ); }
+
+    /// <summary>空間順の並べ替えを設定</summary>
+    void SetSortEnabled( bool isSortEnabled ) { mIsSortEnabled = isSortEnabled; }
+
+   private:
+    /// <summary>
+    /// 実行順を空間的に近いものが並ぶように並べ替える
+    /// </summary>
+    /// <param name="bounds">シーンの境界</param>
+    void SortQueries( const AABB3D& bounds );
+
+    /// <summary>
+    /// クエリを1つ実行
+    /// </summary>
+    /// <param name="scene">対象のシーン</param>
+    /// <param name="query">クエリ</param>
+    /// <param name="result">結果(出力)</param>
+    /// <param name="ids">重なったコライダーのID(末尾に追加)</param>
+    void ExecuteOne( const CollisionScene& scene, const Query& query, Result& result, std::vector<uint32_t>& ids ) const;
+};
@@ -0,0 +1,83 @@
+#include "TriangleMesh.h"
+
+// コンストラクタ
+TriangleMesh::TriangleMesh()
+    : mPositions()
+    , mIndices()
+    , mBVH()
+{
+}
+
+// 作成
+bool TriangleMesh::Create( const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, uint32_t maxLeafSize )
+{
+    mPositions = positions;
+    mIndices.assign( indices.begin(), indices.begin() + indices.size() / 3 * 3 );
+
+    auto triCount = GetTriangleCount();
+    std::vector<AABB3D> bounds( triCount );
+    for( uint32_t i = 0; i < triCount; ++i )
+    {
+        bounds[i].Reset();
+        bounds[i].Update( mPositions[mIndices[i * 3 + 0]] );
+        bounds[i].Update( mPositions[mIndices[i * 3 + 1]] );
+        bounds[i].Update( mPositions[mIndices[i * 3 + 2]] );
+    }
+    return mBVH.Build( bounds, maxLeafSize );
+}
+
+// 半直線で判定
+bool TriangleMesh::Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const
+{
+    hit = {};
+    auto hitT = maxDist;
+    auto hitTri = UINT32_MAX;
+    mBVH.Raycast(
+        origin, dir, maxDist, 0.0f,
+        [&]( uint32_t tri, float& maxT )
+        {
+            float t = 0.0f;
+            const auto& v0 = mPositions[mIndices[tri * 3 + 0]];
+            const auto& v1 = mPositions[mIndices[tri * 3 + 1]];
+            const auto& v2 = mPositions[mIndices[tri * 3 + 2]];
+            if( IntersectRay( origin, dir, v0, v1, v2, maxT, t ) )
+            {
+                maxT = t;
+                hitT = t;
+                hitTri = tri;
+            }
+        } );
+    if( hitTri == UINT32_MAX ) return false;
+
+    const auto& v0 = mPositions[mIndices[hitTri * 3 + 0]];
+    const auto& v1 = mPositions[mIndices[hitTri * 3 + 1]];
+    const auto& v2 = mPositions[mIndices[hitTri * 3 + 2]];
+    hit.mIsHit = true;
+    hit.mId = hitTri;
+    hit.mDistance = hitT;
+    hit.mPoint = origin + dir * hitT;
+    hit.mNormal = Normalize( Cross( v1 - v0, v2 - v0 ) );
+    return true;
+}
+
+// AABBと境界が重なる三角形を列挙
+uint32_t TriangleMesh::OverlapAABB( const AABB3D& aabb, std::vector<uint32_t>& triangles ) const
+{
+    uint32_t count = 0;
+    mBVH.Overlap(
+        aabb,
+        [&]( uint32_t tri )
+        {
+            AABB3D bounds = {};
+            bounds.Reset();
+            bounds.Update( mPositions[mIndices[tri * 3 + 0]] );
+            bounds.Update( mPositions[mIndices[tri * 3 + 1]] );
+            bounds.Update( mPositions[mIndices[tri * 3 + 2]] );
+            if( Intersect( bounds, aabb ) )
+            {
+                triangles.emplace_back( tri );
+                ++count;
+            }
+        } );
+    return count;
+}
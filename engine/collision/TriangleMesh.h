@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "BVH.h"
+#include "CollisionScene.h"
+
+/// <summary>
+/// 三角形メッシュのコライダー(浮動小数点のBVH)
+/// </summary>
+class TriangleMesh
+{
+   private:
+    // 頂点座標
+    std::vector<Vector3> mPositions;
+    // 三角形の頂点インデックス(3つで1枚)
+    std::vector<uint32_t> mIndices;
+    // 三角形のBVH
+    BVH mBVH;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    TriangleMesh();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~TriangleMesh() = default;
+
+    /// <summary>
+    /// 作成
+    /// </summary>
+    /// <param name="positions">頂点座標</param>
+    /// <param name="indices">三角形の頂点インデックス</param>
+    /// <param name="maxLeafSize">葉に入れる三角形の最大数</param>
+    /// <returns>成否</returns>
+    bool Create( const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, uint32_t maxLeafSize = 4 );
+
+    /// <summary>
+    /// 半直線で判定(最も近い三角形)
+    /// </summary>
+    /// <param name="origin">始点</param>
+    /// <param name="dir">向き(正規化済み)</param>
+    /// <param name="maxDist">最大距離</param>
+    /// <param name="hit">結果(出力、IDは三角形のインデックス)</param>
+    /// <returns>当たったか</returns>
+    bool Raycast( const Vector3& origin, const Vector3& dir, float maxDist, RaycastHit& hit ) const;
+
+    /// <summary>
+    /// AABBと境界が重なる三角形を列挙
+    /// </summary>
+    /// <param name="aabb">範囲</param>
+    /// <param name="triangles">三角形のインデックス(末尾に追加)</param>
+    /// <returns>見つかった数</returns>
+    uint32_t OverlapAABB( const AABB3D& aabb, std::vector<uint32_t>& triangles ) const;
+
+    /// <summary>三角形数を取得</summary>
+    uint32_t GetTriangleCount() const { return static_cast<uint32_t>( mIndices.size() / 3 ); }
+
+    /// <summary>頂点座標を取得</summary>
+    const std::vector<Vector3>& GetPositions() const { return mPositions; }
+
+    /// <summary>三角形の頂点インデックスを取得</summary>
+    const std::vector<uint32_t>& GetIndices() const { return mIndices; }
+
+    /// <summary>BVHを取得</summary>
+    const BVH& GetBVH() const { return mBVH; }
+};
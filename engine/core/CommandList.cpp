@@ -26,6 +26,7 @@ D3D12_COMMAND_LIST_TYPE CommandList::GetCommandListType( Type type )
 CommandList::CommandList()
     : mCmdAllocators()
     , mCmdList( nullptr )
+    , mState()
 {
 }
 
@@ -72,6 +73,19 @@ void CommandList::Reset( uint32_t idx )
 
     mCmdAllocators[idx]->Reset();
     mCmdList->Reset( mCmdAllocators[idx].Get(), nullptr );
+    mState.Reset();
+}
+
+// 記録の再開
+void CommandList::Resume( uint32_t idx )
+{
+    if( idx >= mCmdAllocators.size() ) return;
+
+    if( !mCmdAllocators[idx] || !mCmdList ) return;
+
+    // アロケーターのリセットはGPUが使い終わるまでできないが、コマンドリストは閉じて提出した直後から使える
+    mCmdList->Reset( mCmdAllocators[idx].Get(), nullptr );
+    mState.Invalidate();
 }
 
 #pragma region ID3D12GraphicsCommandListラッパー
@@ -117,19 +131,19 @@ void CommandList::Dispatch( uint32_t x, uint32_t y, uint32_t z )
 }
 
 // 描画
-void CommandList::DrawInstanced( uint32_t vertexCount )
+void CommandList::DrawInstanced( uint32_t vertexCount, uint32_t instanceCount )
 {
     if( !mCmdList ) return;
 
-    mCmdList->DrawInstanced( vertexCount, 1, 0, 0 );
+    mCmdList->DrawInstanced( vertexCount, instanceCount, 0, 0 );
 }
 
 // 描画
-void CommandList::DrawIndexedInstanced( uint32_t indexCount )
+void CommandList::DrawIndexedInstanced( uint32_t indexCount, uint32_t startIndex, uint32_t instanceCount )
 {
     if( !mCmdList ) return;
 
-    mCmdList->DrawIndexedInstanced( indexCount, 1, 0, 0, 0 );
+    mCmdList->DrawIndexedInstanced( indexCount, instanceCount, startIndex, 0, 0 );
 }
 
 // リソースバリアをセット
@@ -145,7 +159,10 @@ void CommandList::SetComputeConstantBuffer( uint32_t rootParamIdx, ConstantBuffe
 {
     if( !mCmdList || !constantBuffer ) return;
 
-    mCmdList->SetComputeRootConstantBufferView( rootParamIdx, constantBuffer->GetGPUVirtualAddress() );
+    auto gpuAddress = constantBuffer->GetGPUVirtualAddress();
+    if( !mState.SetComputeRootArgument( rootParamIdx, gpuAddress ) ) return;
+
+    mCmdList->SetComputeRootConstantBufferView( rootParamIdx, gpuAddress );
 }
 
 // 定数バッファをセット
@@ -153,7 +170,20 @@ void CommandList::SetGraphicsConstantBuffer( uint32_t rootParamIdx, ConstantBuff
 {
     if( !mCmdList || !constantBuffer ) return;
 
-    mCmdList->SetGraphicsRootConstantBufferView( rootParamIdx, constantBuffer->GetGPUVirtualAddress() );
+    auto gpuAddress = constantBuffer->GetGPUVirtualAddress();
+    if( !mState.SetGraphicsRootArgument( rootParamIdx, gpuAddress ) ) return;
+
+    mCmdList->SetGraphicsRootConstantBufferView( rootParamIdx, gpuAddress );
+}
+
+// 定数バッファをセット
+void CommandList::SetGraphicsConstantBuffer( uint32_t rootParamIdx, D3D12_GPU_VIRTUAL_ADDRESS gpuAddress )
+{
+    if( !mCmdList || gpuAddress == 0 ) return;
+
+    if( !mState.SetGraphicsRootArgument( rootParamIdx, gpuAddress ) ) return;
+
+    mCmdList->SetGraphicsRootConstantBufferView( rootParamIdx, gpuAddress );
 }
 
 // デスクリプタヒープをセット
@@ -161,6 +191,8 @@ void CommandList::SetDescriptorHeap( DescriptorHeap* descriptorHeap )
 {
     if( !mCmdList || !descriptorHeap ) return;
 
+    if( !mState.SetDescriptorHeap( descriptorHeap->GetDescriptorHeap().Get() ) ) return;
+
     ID3D12DescriptorHeap* descriptorHeaps[] = { descriptorHeap->GetDescriptorHeap().Get() };
     mCmdList->SetDescriptorHeaps( 1, descriptorHeaps );
 }
@@ -170,6 +202,8 @@ void CommandList::SetComputeRootDescriptorTable( uint32_t rootParamIdx, Descript
 {
     if( !mCmdList || !descriptorHandle ) return;
 
+    if( !mState.SetComputeRootArgument( rootParamIdx, descriptorHandle->mGPU.ptr ) ) return;
+
     mCmdList->SetComputeRootDescriptorTable( rootParamIdx, descriptorHandle->mGPU );
 }
 
@@ -178,6 +212,8 @@ void CommandList::SetGraphicsRootDescriptorTable( uint32_t rootParamIdx, Descrip
 {
     if( !mCmdList || !descriptorHandle ) return;
 
+    if( !mState.SetGraphicsRootArgument( rootParamIdx, descriptorHandle->mGPU.ptr ) ) return;
+
     mCmdList->SetGraphicsRootDescriptorTable( rootParamIdx, descriptorHandle->mGPU );
 }
 
@@ -186,6 +222,8 @@ void CommandList::SetComputeRootSignature( RootSignature* rootSignature )
 {
     if( !mCmdList || !rootSignature ) return;
 
+    if( !mState.SetComputeRootSignature( rootSignature->GetRootSignature().Get() ) ) return;
+
     mCmdList->SetComputeRootSignature( rootSignature->GetRootSignature().Get() );
 }
 
@@ -194,15 +232,30 @@ void CommandList::SetGraphicsRootSignature( RootSignature* rootSignature )
 {
     if( !mCmdList || !rootSignature ) return;
 
+    if( !mState.SetGraphicsRootSignature( rootSignature->GetRootSignature().Get() ) ) return;
+
     mCmdList->SetGraphicsRootSignature( rootSignature->GetRootSignature().Get() );
 }
 
+// シェーダーリソースをセット
+void CommandList::SetGraphicsShaderResource( uint32_t rootParamIdx, D3D12_GPU_VIRTUAL_ADDRESS gpuAddress )
+{
+    if( !mCmdList || gpuAddress == 0 ) return;
+
+    if( !mState.SetGraphicsRootArgument( rootParamIdx, gpuAddress ) ) return;
+
+    mCmdList->SetGraphicsRootShaderResourceView( rootParamIdx, gpuAddress );
+}
+
 // インデックスバッファをセット
 void CommandList::SetIndexBuffer( IndexBuffer* indexBuffer )
 {
     if( !mCmdList || !indexBuffer ) return;
 
-    mCmdList->IASetIndexBuffer( &indexBuffer->GetView() );
+    const auto& view = indexBuffer->GetView();
+    if( !mState.SetIndexBuffer( view.BufferLocation, view.SizeInBytes, static_cast<uint32_t>( view.Format ) ) ) return;
+
+    mCmdList->IASetIndexBuffer( &view );
 }
 
 // パイプラインステートをセット
@@ -210,6 +263,8 @@ void CommandList::SetPipelineState( ComputePSO* pso )
 {
     if( !mCmdList || !pso ) return;
 
+    if( !mState.SetPipelineState( pso->GetPipelineState().Get() ) ) return;
+
     mCmdList->SetPipelineState( pso->GetPipelineState().Get() );
 }
 
@@ -218,6 +273,8 @@ void CommandList::SetPipelineState( GraphicsPSO* pso )
 {
     if( !mCmdList || !pso ) return;
 
+    if( !mState.SetPipelineState( pso->GetPipelineState().Get() ) ) return;
+
     mCmdList->SetPipelineState( pso->GetPipelineState().Get() );
 }
 
@@ -226,6 +283,8 @@ void CommandList::SetPrimitiveTopology( D3D12_PRIMITIVE_TOPOLOGY primitiveTopolo
 {
     if( !mCmdList ) return;
 
+    if( !mState.SetPrimitiveTopology( static_cast<uint32_t>( primitiveTopology ) ) ) return;
+
     mCmdList->IASetPrimitiveTopology( primitiveTopology );
 }
 
@@ -259,7 +318,10 @@ void CommandList::SetVertexBuffer( VertexBuffer* vertexBuffer )
 {
     if( !mCmdList || !vertexBuffer ) return;
 
-    mCmdList->IASetVertexBuffers( 0, 1, &vertexBuffer->GetView() );
+    const auto& view = vertexBuffer->GetView();
+    if( !mState.SetVertexBuffer( view.BufferLocation, view.SizeInBytes, view.StrideInBytes ) ) return;
+
+    mCmdList->IASetVertexBuffers( 0, 1, &view );
 }
 
 // ビューポートをセット
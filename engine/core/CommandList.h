@@ -4,6 +4,7 @@
 
 #include <vector>
 
+#include "CommandListState.h"
 #include "DescriptorHeap.h"
 
 class ComputePSO;
@@ -33,6 +34,8 @@ class CommandList
     std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> mCmdAllocators;
     // コマンドリスト
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> mCmdList;
+    // 最後にセットしたステート(同じものをセットする呼び出しを捨てる)
+    CommandListState mState;
 
    public:
     /// <summary>
@@ -71,6 +74,12 @@ class CommandList
     /// <param name="idx">インデックス</param>
     void Reset( uint32_t idx = 0 );
 
+    /// <summary>
+    /// 記録の再開(実行中のコマンドが残っているのでアロケーターはリセットせず、ステートは全て忘れる)
+    /// </summary>
+    /// <param name="idx">インデックス</param>
+    void Resume( uint32_t idx = 0 );
+
 #pragma region ID3D12GraphicsCommandListラッパー
 
     /// <summary>
@@ -112,13 +121,16 @@ class CommandList
     /// 描画
     /// </summary>
     /// <param name="vertexCount">頂点数</param>
-    void DrawInstanced( uint32_t vertexCount );
+    /// <param name="instanceCount">インスタンス数</param>
+    void DrawInstanced( uint32_t vertexCount, uint32_t instanceCount = 1 );
 
     /// <summary>
     /// 描画
     /// </summary>
     /// <param name="indexCount">インデックス数</param>
-    void DrawIndexedInstanced( uint32_t indexCount );
+    /// <param name="startIndex">開始インデックス</param>
+    /// <param name="instanceCount">インスタンス数</param>
+    void DrawIndexedInstanced( uint32_t indexCount, uint32_t startIndex = 0, uint32_t instanceCount = 1 );
 
     /// <summary>
     /// リソースバリアをセット
@@ -140,6 +152,13 @@ class CommandList
     /// <param name="constantBuffer">定数バッファ</param>
     void SetGraphicsConstantBuffer( uint32_t rootParamIdx, ConstantBuffer* constantBuffer );
 
+    /// <summary>
+    /// 定数バッファをセット(プールのスロットなど)
+    /// </summary>
+    /// <param name="rootParamIdx">ルートパラメータのインデックス</param>
+    /// <param name="gpuAddress">GPU仮想アドレス</param>
+    void SetGraphicsConstantBuffer( uint32_t rootParamIdx, D3D12_GPU_VIRTUAL_ADDRESS gpuAddress );
+
     /// <summary>
     /// デスクリプタヒープをセット
     /// </summary>
@@ -172,6 +191,13 @@ class CommandList
     /// <param name="rootSignature">ルートシグネチャ</param>
     void SetGraphicsRootSignature( RootSignature* rootSignature );
 
+    /// <summary>
+    /// シェーダーリソースをルートデスクリプタとしてセット(構造化バッファなど)
+    /// </summary>
+    /// <param name="rootParamIdx">ルートパラメータのインデックス</param>
+    /// <param name="gpuAddress">GPU仮想アドレス</param>
+    void SetGraphicsShaderResource( uint32_t rootParamIdx, D3D12_GPU_VIRTUAL_ADDRESS gpuAddress );
+
     /// <summary>
     /// インデックスバッファをセット
     /// </summary>
@@ -246,6 +272,14 @@ class CommandList
 
 #pragma endregion
 
+    /// <summary>
+    /// 最後にセットしたステートを忘れる(コマンドリストを直接使ってステートを変えたあとに呼ぶ)
+    /// </summary>
+    void InvalidateState() { mState.Invalidate(); }
+
+    /// <summary>最後にセットしたステートを取得</summary>
+    CommandListState& GetState() { return mState; }
+
     /// <summary>コマンドリストを取得</summary>
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> GetCmdList() const { return mCmdList; }
 };
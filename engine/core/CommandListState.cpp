@@ -0,0 +1,146 @@
+#include "CommandListState.h"
+
+// コンストラクタ
+CommandListState::CommandListState()
+    : mIsEnabled( true )
+    , mGraphics()
+    , mCompute()
+    , mPipelineState( nullptr )
+    , mPrimitiveTopology( UINT32_MAX )
+    , mVertexBuffer()
+    , mIndexBuffer()
+    , mDescriptorHeap( nullptr )
+    , mCounters()
+    , mLastCounters()
+{
+}
+
+// コマンドリストのリセット
+void CommandListState::Reset()
+{
+    Invalidate();
+    mLastCounters = mCounters;
+    mCounters = {};
+}
+
+// ステートを全て忘れる
+void CommandListState::Invalidate()
+{
+    mGraphics = {};
+    mCompute = {};
+    mPipelineState = nullptr;
+    mPrimitiveTopology = UINT32_MAX;
+    mVertexBuffer = {};
+    mIndexBuffer = {};
+    mDescriptorHeap = nullptr;
+}
+
+// ルートシグネチャをセット
+bool CommandListState::SetGraphicsRootSignature( const void* rootSignature )
+{
+    return SetRootSignature( mGraphics, rootSignature );
+}
+
+// ルートシグネチャをセット
+bool CommandListState::SetComputeRootSignature( const void* rootSignature )
+{
+    return SetRootSignature( mCompute, rootSignature );
+}
+
+// ルートパラメータの値をセット
+bool CommandListState::SetGraphicsRootArgument( uint32_t rootParamIdx, uint64_t value )
+{
+    return SetRootArgument( mGraphics, rootParamIdx, value );
+}
+
+// ルートパラメータの値をセット
+bool CommandListState::SetComputeRootArgument( uint32_t rootParamIdx, uint64_t value )
+{
+    return SetRootArgument( mCompute, rootParamIdx, value );
+}
+
+// パイプラインステートをセット
+bool CommandListState::SetPipelineState( const void* pipelineState )
+{
+    auto isSame = pipelineState != nullptr && pipelineState == mPipelineState;
+    mPipelineState = pipelineState;
+    return Count( Category::PipelineState, isSame );
+}
+
+// プリミティブ型をセット
+bool CommandListState::SetPrimitiveTopology( uint32_t primitiveTopology )
+{
+    auto isSame = primitiveTopology == mPrimitiveTopology;
+    mPrimitiveTopology = primitiveTopology;
+    return Count( Category::PrimitiveTopology, isSame );
+}
+
+// 頂点バッファをセット
+bool CommandListState::SetVertexBuffer( uint64_t location, uint32_t size, uint32_t stride )
+{
+    std::array<uint64_t, 3> view = { location, size, stride };
+    auto isSame = location != 0 && view == mVertexBuffer;
+    mVertexBuffer = view;
+    return Count( Category::VertexBuffer, isSame );
+}
+
+// インデックスバッファをセット
+bool CommandListState::SetIndexBuffer( uint64_t location, uint32_t size, uint32_t format )
+{
+    std::array<uint64_t, 3> view = { location, size, format };
+    auto isSame = location != 0 && view == mIndexBuffer;
+    mIndexBuffer = view;
+    return Count( Category::IndexBuffer, isSame );
+}
+
+// デスクリプタヒープをセット
+bool CommandListState::SetDescriptorHeap( const void* descriptorHeap )
+{
+    auto isSame = descriptorHeap != nullptr && descriptorHeap == mDescriptorHeap;
+    if( !isSame )
+    {
+        // デスクリプタテーブルが前のヒープを指したままになるので、ルートパラメータの値を忘れる
+        mGraphics.mArguments = {};
+        mCompute.mArguments = {};
+    }
+    mDescriptorHeap = descriptorHeap;
+    return Count( Category::DescriptorHeap, isSame );
+}
+
+// 呼び出しを数えて、DirectX12へ渡すかを返す
+bool CommandListState::Count( Category category, bool isSame )
+{
+    auto idx = static_cast<size_t>( category );
+    if( mIsEnabled && isSame )
+    {
+        ++mCounters.mFiltered[idx];
+        return false;
+    }
+
+    ++mCounters.mIssued[idx];
+    return true;
+}
+
+// ルートシグネチャをセット
+bool CommandListState::SetRootSignature( RootState& root, const void* rootSignature )
+{
+    auto isSame = rootSignature != nullptr && rootSignature == root.mRootSignature;
+    if( !isSame )
+    {
+        // ルートシグネチャを変えるとルートパラメータの値は全て無効になる
+        root.mArguments = {};
+    }
+    root.mRootSignature = rootSignature;
+    return Count( Category::RootSignature, isSame );
+}
+
+// ルートパラメータの値をセット
+bool CommandListState::SetRootArgument( RootState& root, uint32_t rootParamIdx, uint64_t value )
+{
+    // 範囲外は覚えられないので必ず渡す
+    if( rootParamIdx >= kMaxRootParameters ) return Count( Category::RootArgument, false );
+
+    auto isSame = value != 0 && value == root.mArguments[rootParamIdx];
+    root.mArguments[rootParamIdx] = value;
+    return Count( Category::RootArgument, isSame );
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// コマンドリストに最後にセットしたステート(シャドウステート)
+/// 直前と同じものをセットする呼び出しを見つけて、DirectX12へ渡す前に捨てる
+/// DirectX12の型を使わないので、デバイスなしで確かめられる
+/// </summary>
+class CommandListState
+{
+   public:
+    /// <summary>
+    /// ステートの種類
+    /// </summary>
+    enum class Category
+    {
+        RootSignature,
+        PipelineState,
+        PrimitiveTopology,
+        VertexBuffer,
+        IndexBuffer,
+        RootArgument,  // ルートの定数バッファ・シェーダーリソース・デスクリプタテーブル
+        DescriptorHeap,
+        Count,
+    };
+
+    /// <summary>
+    /// 呼び出しの数(種類ごと)
+    /// </summary>
+    struct Counters
+    {
+        // DirectX12へ渡した数
+        std::array<uint32_t, static_cast<size_t>( Category::Count )> mIssued;
+        // 直前と同じで捨てた数
+        std::array<uint32_t, static_cast<size_t>( Category::Count )> mFiltered;
+    };
+
+    // ルートパラメータの最大数
+    static constexpr uint32_t kMaxRootParameters = 64;
+
+   private:
+    /// <summary>
+    /// グラフィックスかコンピュートのルートのステート
+    /// </summary>
+    struct RootState
+    {
+        const void* mRootSignature;
+        // ルートパラメータごとの値(GPU仮想アドレスかデスクリプタハンドル、0ならまだセットしていない)
+        std::array<uint64_t, kMaxRootParameters> mArguments;
+    };
+
+    // 捨てるか(捨てないときもステートは覚える)
+    bool mIsEnabled;
+    RootState mGraphics;
+    RootState mCompute;
+    const void* mPipelineState;
+    // まだセットしていなければUINT32_MAX
+    uint32_t mPrimitiveTopology;
+    // 頂点バッファ・インデックスバッファのビュー(位置・サイズ・ストライドか形式)
+    std::array<uint64_t, 3> mVertexBuffer;
+    std::array<uint64_t, 3> mIndexBuffer;
+    const void* mDescriptorHeap;
+    // 直前のリセットからの呼び出しの数と、その前のリセットまでの数
+    Counters mCounters;
+    Counters mLastCounters;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    CommandListState();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~CommandListState() = default;
+
+    /// <summary>
+    /// コマンドリストのリセット(ステートを全て忘れ、呼び出しの数を前回の分として残す)
+    /// </summary>
+    void Reset();
+
+    /// <summary>
+    /// ステートを全て忘れる(コマンドリストを直接使ってステートを変えたあとなど)
+    /// </summary>
+    void Invalidate();
+
+    /// <summary>
+    /// ルートシグネチャをセット(変わったらルートパラメータの値を忘れる)
+    /// </summary>
+    /// <param name="rootSignature">ルートシグネチャ</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetGraphicsRootSignature( const void* rootSignature );
+
+    /// <summary>
+    /// ルートシグネチャをセット(変わったらルートパラメータの値を忘れる)
+    /// </summary>
+    /// <param name="rootSignature">ルートシグネチャ</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetComputeRootSignature( const void* rootSignature );
+
+    /// <summary>
+    /// ルートパラメータの値をセット
+    /// </summary>
+    /// <param name="rootParamIdx">ルートパラメータのインデックス</param>
+    /// <param name="value">GPU仮想アドレスかデスクリプタハンドル</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetGraphicsRootArgument( uint32_t rootParamIdx, uint64_t value );
+
+    /// <summary>
+    /// ルートパラメータの値をセット
+    /// </summary>
+    /// <param name="rootParamIdx">ルートパラメータのインデックス</param>
+    /// <param name="value">GPU仮想アドレスかデスクリプタハンドル</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetComputeRootArgument( uint32_t rootParamIdx, uint64_t value );
+
+    /// <summary>
+    /// パイプラインステートをセット
+    /// </summary>
+    /// <param name="pipelineState">パイプラインステート</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetPipelineState( const void* pipelineState );
+
+    /// <summary>
+    /// プリミティブ型をセット
+    /// </summary>
+    /// <param name="primitiveTopology">プリミティブ型</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetPrimitiveTopology( uint32_t primitiveTopology );
+
+    /// <summary>
+    /// 頂点バッファをセット
+    /// </summary>
+    /// <param name="location">GPU仮想アドレス</param>
+    /// <param name="size">サイズ</param>
+    /// <param name="stride">ストライド</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetVertexBuffer( uint64_t location, uint32_t size, uint32_t stride );
+
+    /// <summary>
+    /// インデックスバッファをセット
+    /// </summary>
+    /// <param name="location">GPU仮想アドレス</param>
+    /// <param name="size">サイズ</param>
+    /// <param name="format">形式</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetIndexBuffer( uint64_t location, uint32_t size, uint32_t format );
+
+    /// <summary>
+    /// デスクリプタヒープをセット(変わったらルートパラメータの値を忘れる)
+    /// </summary>
+    /// <param name="descriptorHeap">デスクリプタヒープ</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetDescriptorHeap( const void* descriptorHeap );
+
+    /// <summary>捨てるかを設定</summary>
+    void SetEnabled( bool isEnabled ) { mIsEnabled = isEnabled; }
+
+    /// <summary>捨てるか</summary>
+    bool IsEnabled() const { return mIsEnabled; }
+
+    /// <summary>直前のリセットからの呼び出しの数を取得</summary>
+    const Counters& GetCounters() const { return mCounters; }
+
+    /// <summary>前回の記録(その前のリセットから直前のリセットまで)の呼び出しの数を取得</summary>
+    const Counters& GetLastCounters() const { return mLastCounters; }
+
+   private:
+    /// <summary>
+    /// 呼び出しを数えて、DirectX12へ渡すかを返す
+    /// </summary>
+    /// <param name="category">種類</param>
+    /// <param name="isSame">直前と同じか</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool Count( Category category, bool isSame );
+
+    /// <summary>
+    /// ルートシグネチャをセット
+    /// </summary>
+    /// <param name="root">グラフィックスかコンピュートのルートのステート</param>
+    /// <param name="rootSignature">ルートシグネチャ</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetRootSignature( RootState& root, const void* rootSignature );
+
+    /// <summary>
+    /// ルートパラメータの値をセット
+    /// </summary>
+    /// <param name="root">グラフィックスかコンピュートのルートのステート</param>
+    /// <param name="rootParamIdx">ルートパラメータのインデックス</param>
+    /// <param name="value">値</param>
+    /// <returns>DirectX12へ渡すならtrue</returns>
+    bool SetRootArgument( RootState& root, uint32_t rootParamIdx, uint64_t value );
+};
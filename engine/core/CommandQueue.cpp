@@ -50,10 +50,28 @@ bool CommandQueue::Create( CommandList::Type type )
 // コマンドリストを実行
 void CommandQueue::Execute( CommandList* cmdList )
 {
-    if( !mCmdQueue || !cmdList ) return;
+    if( !cmdList ) return;
 
-    ID3D12CommandList* cmdLists[] = { cmdList->GetCmdList().Get() };
-    mCmdQueue->ExecuteCommandLists( 1, cmdLists );
+    Execute( std::span<CommandList* const>( &cmdList, 1 ) );
+}
+
+// コマンドリストを並べた順に実行
+void CommandQueue::Execute( std::span<CommandList* const> cmdLists )
+{
+    if( !mCmdQueue || cmdLists.empty() ) return;
+
+    std::vector<ID3D12CommandList*> d3dCmdLists;
+    d3dCmdLists.reserve( cmdLists.size() );
+    for( auto cmdList : cmdLists )
+    {
+        if( !cmdList ) continue;
+
+        d3dCmdLists.emplace_back( cmdList->GetCmdList().Get() );
+    }
+    if( d3dCmdLists.empty() ) return;
+
+    // 1回の呼び出しで渡したコマンドリストは並べた順に実行される
+    mCmdQueue->ExecuteCommandLists( static_cast<UINT>( d3dCmdLists.size() ), d3dCmdLists.data() );
 
     mCmdQueue->Signal( mFence.Get(), ++mFenceValue );
 }
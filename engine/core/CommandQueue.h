@@ -3,6 +3,7 @@
 #include <wrl.h>
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
 #include "CommandList.h"
@@ -46,6 +47,12 @@ class CommandQueue
     /// <param name="cmdList">コマンドリスト</param>
     void Execute( CommandList* cmdList );
 
+    /// <summary>
+    /// コマンドリストを並べた順に実行
+    /// </summary>
+    /// <param name="cmdLists">コマンドリスト</param>
+    void Execute( std::span<CommandList* const> cmdLists );
+
     /// <summary>
     /// 指定したコマンドキューを待つ
     /// </summary>
@@ -43,4 +43,7 @@ class ConstantBuffer
 
     /// <summary>GPU仮想アドレスを取得</summary>
     D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const { return mResource->GetGPUVirtualAddress(); }
+
+    /// <summary>マップしたデータへのポインタを取得</summary>
+    void* GetData() const { return mData; }
 };
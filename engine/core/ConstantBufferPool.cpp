@@ -0,0 +1,121 @@
+#include "ConstantBufferPool.h"
+
+#include <algorithm>
+
+// コンストラクタ
+ConstantBufferPool::ConstantBufferPool()
+    : mPages()
+    , mUsedSlotCount( 0 )
+{
+}
+
+// 終了処理
+void ConstantBufferPool::Term()
+{
+    mPages.clear();
+    mUsedSlotCount = 0;
+}
+
+// 連続するスロットを借りる
+bool ConstantBufferPool::Allocate( uint32_t count, Slice& slice )
+{
+    if( count == 0 ) return false;
+
+    // 空いている範囲から先に見つかったものを使う
+    auto pageIdx = UINT32_MAX;
+    auto rangeIdx = UINT32_MAX;
+    for( uint32_t i = 0; i < mPages.size() && pageIdx == UINT32_MAX; ++i )
+    {
+        const auto& ranges = mPages[i].mFreeRanges;
+        for( uint32_t j = 0; j < ranges.size(); ++j )
+        {
+            if( ranges[j].mCount < count ) continue;
+
+            pageIdx = i;
+            rangeIdx = j;
+            break;
+        }
+    }
+
+    // 足りなければページを追加(1ページに収まらない大きさなら専用のページ)
+    if( pageIdx == UINT32_MAX )
+    {
+        Page page = {};
+        page.mSlotCount = ( std::max )( count, kPageSlotCount );
+        page.mBuffer = std::make_unique<ConstantBuffer>();
+        if( !page.mBuffer->Create( page.mSlotCount * kSlotSize ) ) return false;
+
+        page.mFreeRanges.emplace_back( FreeRange{ 0, page.mSlotCount } );
+        mPages.emplace_back( std::move( page ) );
+        pageIdx = static_cast<uint32_t>( mPages.size() - 1 );
+        rangeIdx = 0;
+    }
+
+    auto& page = mPages[pageIdx];
+    auto& range = page.mFreeRanges[rangeIdx];
+    slice.mPageIdx = pageIdx;
+    slice.mBegin = range.mBegin;
+    slice.mCount = count;
+    slice.mData = static_cast<uint8_t*>( page.mBuffer->GetData() ) + range.mBegin * kSlotSize;
+    slice.mGPUAddress = page.mBuffer->GetGPUVirtualAddress() + range.mBegin * kSlotSize;
+
+    range.mBegin += count;
+    range.mCount -= count;
+    if( range.mCount == 0 )
+    {
+        page.mFreeRanges.erase( page.mFreeRanges.begin() + rangeIdx );
+    }
+    mUsedSlotCount += count;
+    return true;
+}
+
+// スロットを返す
+void ConstantBufferPool::Free( Slice& slice )
+{
+    if( slice.mPageIdx >= mPages.size() || slice.mCount == 0 )
+    {
+        slice = {};
+        return;
+    }
+
+    // 先頭の順を保って挿入し、隣と繋がれば1つにまとめる
+    auto& ranges = mPages[slice.mPageIdx].mFreeRanges;
+    auto it = std::lower_bound(
+        ranges.begin(),
+        ranges.end(),
+        slice.mBegin,
+        []( const FreeRange& range, uint32_t begin )
+        {
+            return range.mBegin < begin;
+        } );
+    it = ranges.insert( it, FreeRange{ slice.mBegin, slice.mCount } );
+    auto next = it + 1;
+    if( next != ranges.end() && it->mBegin + it->mCount == next->mBegin )
+    {
+        it->mCount += next->mCount;
+        ranges.erase( next );
+    }
+    if( it != ranges.begin() )
+    {
+        auto prev = it - 1;
+        if( prev->mBegin + prev->mCount == it->mBegin )
+        {
+            prev->mCount += it->mCount;
+            ranges.erase( it );
+        }
+    }
+
+    mUsedSlotCount -= slice.mCount;
+    slice = {};
+}
+
+// ページの合計サイズを取得
+size_t ConstantBufferPool::GetReservedSize() const
+{
+    size_t size = 0;
+    for( const auto& page : mPages )
+    {
+        size += static_cast<size_t>( page.mSlotCount ) * kSlotSize;
+    }
+    return size;
+}
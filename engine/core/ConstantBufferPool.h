@@ -0,0 +1,132 @@
+#pragma once
+#include <d3d12.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ConstantBuffer.h"
+
+/// <summary>
+/// 定数バッファのプール
+/// 大きな定数バッファ(ページ)を256バイト単位のスロットに分けて貸し出す
+/// 小さな定数バッファごとにリソースを作らずに済む(コミットリソースは64KB単位で確保される)
+/// </summary>
+class ConstantBufferPool
+{
+   public:
+    // スロットのサイズ(定数バッファのアライメント)
+    static constexpr uint32_t kSlotSize = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+    // 1ページあたりのスロット数(64KB)
+    static constexpr uint32_t kPageSlotCount = 256;
+
+    /// <summary>
+    /// 貸し出した連続するスロット
+    /// </summary>
+    struct Slice
+    {
+        uint32_t mPageIdx = UINT32_MAX;
+        uint32_t mBegin = 0;
+        uint32_t mCount = 0;
+        // 先頭のスロットのデータ・GPU仮想アドレス
+        uint8_t* mData = nullptr;
+        D3D12_GPU_VIRTUAL_ADDRESS mGPUAddress = 0;
+    };
+
+   private:
+    /// <summary>
+    /// 空いているスロットの範囲
+    /// </summary>
+    struct FreeRange
+    {
+        uint32_t mBegin;
+        uint32_t mCount;
+    };
+
+    /// <summary>
+    /// ページ
+    /// </summary>
+    struct Page
+    {
+        std::unique_ptr<ConstantBuffer> mBuffer;
+        uint32_t mSlotCount;
+        // 空いている範囲(先頭の昇順)
+        std::vector<FreeRange> mFreeRanges;
+    };
+
+    // ページ
+    std::vector<Page> mPages;
+    // 貸し出し中のスロット数
+    uint32_t mUsedSlotCount;
+
+   public:
+    /// <summary>
+    /// インスタンスを取得
+    /// </summary>
+    /// <returns>インスタンス</returns>
+    static ConstantBufferPool& GetInstance()
+    {
+        static ConstantBufferPool instance;
+        return instance;
+    }
+
+   private:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    ConstantBufferPool();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~ConstantBufferPool() = default;
+
+   public:
+    /// <summary>
+    /// コピーコンストラクタ禁止
+    /// </summary>
+    ConstantBufferPool( const ConstantBufferPool& ) = delete;
+
+    /// <summary>
+    /// 代入演算子禁止
+    /// </summary>
+    ConstantBufferPool& operator=( const ConstantBufferPool& ) = delete;
+
+    /// <summary>
+    /// ムーブコンストラクタ禁止
+    /// </summary>
+    ConstantBufferPool( ConstantBufferPool&& ) = delete;
+
+    /// <summary>
+    /// ムーブ代入演算子禁止
+    /// </summary>
+    ConstantBufferPool& operator=( ConstantBufferPool&& ) = delete;
+
+    /// <summary>
+    /// 終了処理(ページをすべて解放する)
+    /// </summary>
+    void Term();
+
+    /// <summary>
+    /// 連続するスロットを借りる
+    /// </summary>
+    /// <param name="count">スロット数</param>
+    /// <param name="slice">スロット(出力)</param>
+    /// <returns>成否</returns>
+    bool Allocate( uint32_t count, Slice& slice );
+
+    /// <summary>
+    /// スロットを返す
+    /// </summary>
+    /// <param name="slice">スロット(返した後は空になる)</param>
+    void Free( Slice& slice );
+
+    /// <summary>ページ数を取得</summary>
+    uint32_t GetPageCount() const { return static_cast<uint32_t>( mPages.size() ); }
+
+    /// <summary>貸し出し中のスロット数を取得</summary>
+    uint32_t GetUsedSlotCount() const { return mUsedSlotCount; }
+
+    /// <summary>ページの合計サイズ(バイト)を取得</summary>
+    size_t GetReservedSize() const;
+};
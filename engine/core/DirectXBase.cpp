@@ -20,6 +20,8 @@ DirectXBase::DirectXBase()
     , mCmdQueue( nullptr )
     , mSwapChain( nullptr )
     , mCmdList( nullptr )
+    , mWorkerCmdLists()
+    , mSubmitCmdLists()
     , mRTVHeap()
     , mDSVHeap()
     , mSRVHeap()
@@ -128,6 +130,42 @@ void DirectXBase::BeginDraw()
     mCmdList->SetDescriptorHeap( mSRVHeap.get() );
 }
 
+// 並列記録用のコマンドリストの記録開始
+CommandList* DirectXBase::BeginWorkerCmdList( uint32_t idx )
+{
+    if( idx >= mWorkerCmdLists.size() ) return nullptr;
+
+    // 前に同じバックバッファで使ったアロケーターは、フレームの終わりにGPUを待っているので使い終わっている
+    auto cmdList = mWorkerCmdLists[idx].get();
+    cmdList->Reset( mBackBuffIdx );
+    cmdList->SetRenderTarget( 1, mRTVHdls[mBackBuffIdx], mDSVHdl );
+    cmdList->SetDescriptorHeap( mSRVHeap.get() );
+    return cmdList;
+}
+
+// 並列記録用のコマンドリストを並べた順に実行
+void DirectXBase::ExecuteWorkerCmdLists( std::span<const uint32_t> order )
+{
+    if( order.empty() ) return;
+
+    // ここまでの描画(クリアやバリアを含む)を先に実行する
+    mCmdList->Close();
+    mSubmitCmdLists.clear();
+    mSubmitCmdLists.emplace_back( mCmdList.get() );
+    for( auto idx : order )
+    {
+        if( idx >= mWorkerCmdLists.size() ) continue;
+
+        mSubmitCmdLists.emplace_back( mWorkerCmdLists[idx].get() );
+    }
+    mCmdQueue->Execute( mSubmitCmdLists );
+
+    // 続きを記録する
+    mCmdList->Resume( mBackBuffIdx );
+    mCmdList->SetRenderTarget( 1, mRTVHdls[mBackBuffIdx], mDSVHdl );
+    mCmdList->SetDescriptorHeap( mSRVHeap.get() );
+}
+
 // 描画終了
 void DirectXBase::EndDraw()
 {
@@ -312,6 +350,19 @@ bool DirectXBase::CreateCmdList()
         LOG_INFO( "CommandList created successfully." );
     }
 
+    // 並列記録用
+    mWorkerCmdLists.resize( kWorkerCmdListCount );
+    for( auto& workerCmdList : mWorkerCmdLists )
+    {
+        workerCmdList = std::make_unique<CommandList>();
+        if( !workerCmdList->Create( CommandList::Type::Direct, kBackBuffCount ) )
+        {
+            LOG_ERROR( "Failed to create worker CommandList." );
+            return false;
+        }
+    }
+    LOG_INFO( std::format( "Worker CommandList Count: {}", kWorkerCmdListCount ) );
+
     return true;
 }
 
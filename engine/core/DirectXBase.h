@@ -5,7 +5,9 @@
 #include <wrl.h>
 
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "CommandList.h"
 #include "CommandQueue.h"
@@ -25,6 +27,9 @@ class DirectXBase
 
     static const bool kUseZPrepass;
 
+    // 並列記録用のコマンドリストの数
+    static const uint32_t kWorkerCmdListCount = 8;
+
    private:
     // DXGIファクトリー
     Microsoft::WRL::ComPtr<IDXGIFactory7> mFactory;
@@ -36,6 +41,10 @@ class DirectXBase
     Microsoft::WRL::ComPtr<IDXGISwapChain4> mSwapChain;
     // コマンドリスト
     std::unique_ptr<CommandList> mCmdList;
+    // 並列記録用のコマンドリスト(スレッドごと、アロケーターはバックバッファごと)
+    std::vector<std::unique_ptr<CommandList>> mWorkerCmdLists;
+    // 提出用(作業用)
+    std::vector<CommandList*> mSubmitCmdLists;
     // デスクリプタヒープ
     std::unique_ptr<DescriptorHeap> mRTVHeap;
     std::unique_ptr<DescriptorHeap> mDSVHeap;
@@ -130,6 +139,21 @@ class DirectXBase
     /// </summary>
     void EndDraw();
 
+    /// <summary>
+    /// 並列記録用のコマンドリストの記録開始(描画開始と同じレンダーターゲットとデスクリプタヒープをセットする)
+    /// ワーカースレッドから呼べる(同じインデックスを同時に使わないこと)
+    /// </summary>
+    /// <param name="idx">インデックス</param>
+    /// <returns>コマンドリスト(インデックスが範囲外ならnullptr)</returns>
+    CommandList* BeginWorkerCmdList( uint32_t idx );
+
+    /// <summary>
+    /// ここまでのコマンドリストに続けて、並列記録用のコマンドリストを並べた順に実行し、コマンドリストの記録を再開する
+    /// 再開したコマンドリストにはレンダーターゲットとデスクリプタヒープだけをセットし直す
+    /// </summary>
+    /// <param name="order">閉じた並列記録用のコマンドリストのインデックス</param>
+    void ExecuteWorkerCmdLists( std::span<const uint32_t> order );
+
     /// <summary>デバイスを取得</summary>
     Microsoft::WRL::ComPtr<ID3D12Device> GetDevice() const { return mDevice.Get(); }
 
@@ -139,6 +163,9 @@ class DirectXBase
     /// <summary>コマンドリストを取得</summary>
     CommandList* GetCmdList() const { return mCmdList.get(); }
 
+    /// <summary>並列記録用のコマンドリストの数を取得</summary>
+    uint32_t GetWorkerCmdListCount() const { return static_cast<uint32_t>( mWorkerCmdLists.size() ); }
+
     /// <summary>RTVデスクリプタヒープを取得</summary>
     DescriptorHeap* GetRTVHeap() const { return mRTVHeap.get(); }
 
@@ -12,7 +12,7 @@ IndexBuffer::IndexBuffer()
 }
 
 // 作成
-bool IndexBuffer::Create( uint32_t size )
+bool IndexBuffer::Create( uint32_t size, DXGI_FORMAT format )
 {
     D3D12_RESOURCE_DESC desc = {};
     desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
@@ -36,7 +36,7 @@ bool IndexBuffer::Create( uint32_t size )
     // インデックスバッファビュー
     mView.BufferLocation = mResource->GetGPUVirtualAddress();
     mView.SizeInBytes = size;
-    mView.Format = DXGI_FORMAT_R32_UINT;
+    mView.Format = format;
 
     // 仮想アドレスをマッピング
     mResource->Map( 0, nullptr, &mData );
@@ -45,7 +45,7 @@ bool IndexBuffer::Create( uint32_t size )
 }
 
 // 更新
-void IndexBuffer::Update( void* data )
+void IndexBuffer::Update( const void* data )
 {
     if( !mData ) return;
 
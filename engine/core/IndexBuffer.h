@@ -32,14 +32,15 @@ class IndexBuffer
     /// 作成
     /// </summary>
     /// <param name="size">サイズ</param>
+    /// <param name="format">インデックスの形式(R16_UINTかR32_UINT)</param>
     /// <returns>成否</returns>
-    bool Create( uint32_t size );
+    bool Create( uint32_t size, DXGI_FORMAT format = DXGI_FORMAT_R32_UINT );
 
     /// <summary>
     /// 更新
     /// </summary>
     /// <param name="data">データ</param>
-    void Update( void* data );
+    void Update( const void* data );
 
     /// <summary>インデックスバッファビューを取得</summary>
     const D3D12_INDEX_BUFFER_VIEW& GetView() const { return mView; }
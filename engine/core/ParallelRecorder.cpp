@@ -0,0 +1,83 @@
+#include "ParallelRecorder.h"
+
+#include "utils/JobSystem.h"
+
+namespace
+{
+
+// 1チャンクの最小の数の既定値
+const uint32_t kDefaultMinChunkSize = 256;
+
+}  // namespace
+
+// コンストラクタ
+ParallelRecorder::ParallelRecorder()
+    : mMinChunkSize( kDefaultMinChunkSize )
+    , mMaxChunks( 0 )
+    , mChunks()
+    , mOrder()
+{
+}
+
+// 範囲を分けて並列に記録し、チャンクの順に提出する
+uint32_t ParallelRecorder::Record( uint32_t count, uint32_t contextCount, const RecordFunc& record, const SubmitFunc& submit )
+{
+    auto chunkCount = GetChunkCount( count, contextCount );
+    Split( count, chunkCount, mChunks );
+    if( chunkCount == 0 ) return 0;
+
+    // チャンクiは記録先iへ(1ジョブに1チャンクなので、記録先を取り合わない)
+    if( chunkCount == 1 )
+    {
+        record( 0, mChunks[0].mFirst, mChunks[0].mCount );
+    }
+    else
+    {
+        JobSystem::GetInstance().ParallelFor(
+            chunkCount,
+            1,
+            [&]( uint32_t begin, uint32_t end )
+            {
+                for( auto i = begin; i < end; ++i )
+                {
+                    record( i, mChunks[i].mFirst, mChunks[i].mCount );
+                }
+            } );
+    }
+
+    // 全て記録し終えてから、元の範囲の順に提出する
+    mOrder.resize( chunkCount );
+    for( uint32_t i = 0; i < chunkCount; ++i )
+    {
+        mOrder[i] = i;
+    }
+    submit( mOrder );
+    return chunkCount;
+}
+
+// チャンク数を取得
+uint32_t ParallelRecorder::GetChunkCount( uint32_t count, uint32_t contextCount ) const
+{
+    if( count == 0 || contextCount == 0 ) return 0;
+
+    auto maxChunks = mMaxChunks > 0 ? ( std::min )( mMaxChunks, contextCount ) : contextCount;
+    auto chunkCount = ( count + mMinChunkSize - 1 ) / mMinChunkSize;
+    return std::clamp( chunkCount, 1u, maxChunks );
+}
+
+// 範囲を連続したチャンクに均等に分ける
+void ParallelRecorder::Split( uint32_t count, uint32_t chunkCount, std::vector<Chunk>& chunks )
+{
+    chunks.clear();
+    if( chunkCount == 0 ) return;
+
+    auto base = count / chunkCount;
+    auto remainder = count % chunkCount;
+    uint32_t first = 0;
+    for( uint32_t i = 0; i < chunkCount; ++i )
+    {
+        auto chunkSize = base + ( i < remainder ? 1 : 0 );
+        chunks.emplace_back( Chunk{ first, chunkSize } );
+        first += chunkSize;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 並列記録の分け方と提出の順番
+/// 範囲を連続したチャンクに分けてチャンクごとに別の記録先(スレッドごとのコマンドリスト)へ並列に記録し、チャンクの順に提出する
+/// DirectX12の型を使わないので、呼び出しを覚えるだけの関数を渡せばデバイスなしで確かめられる
+/// </summary>
+class ParallelRecorder
+{
+   public:
+    // 範囲を記録する関数(ワーカースレッドから呼ぶ、1つの記録先を同時に2つのスレッドが使うことはない)
+    using RecordFunc = std::function<void( uint32_t contextIdx, uint32_t first, uint32_t count )>;
+    // 記録した記録先を並べた順に提出する関数(呼び出し元のスレッドから呼ぶ)
+    using SubmitFunc = std::function<void( std::span<const uint32_t> contextOrder )>;
+
+    /// <summary>
+    /// チャンク(連続した範囲)
+    /// </summary>
+    struct Chunk
+    {
+        uint32_t mFirst;
+        uint32_t mCount;
+    };
+
+   private:
+    // 1チャンクの最小の数(少なすぎるとコマンドリストの準備と提出のほうが重い)
+    uint32_t mMinChunkSize;
+    // 最大のチャンク数(0なら記録先の数まで)
+    uint32_t mMaxChunks;
+    // 直前の記録のチャンクと提出の順番
+    std::vector<Chunk> mChunks;
+    std::vector<uint32_t> mOrder;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    ParallelRecorder();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~ParallelRecorder() = default;
+
+    /// <summary>
+    /// 範囲を分けて並列に記録し、チャンクの順に提出する(チャンクが1つなら呼び出し元で記録)
+    /// </summary>
+    /// <param name="count">数</param>
+    /// <param name="contextCount">記録先の数</param>
+    /// <param name="record">範囲を記録する関数</param>
+    /// <param name="submit">提出する関数</param>
+    /// <returns>チャンク数(0なら記録していない)</returns>
+    uint32_t Record( uint32_t count, uint32_t contextCount, const RecordFunc& record, const SubmitFunc& submit );
+
+    /// <summary>
+    /// チャンク数を取得
+    /// </summary>
+    /// <param name="count">数</param>
+    /// <param name="contextCount">記録先の数</param>
+    /// <returns>チャンク数</returns>
+    uint32_t GetChunkCount( uint32_t count, uint32_t contextCount ) const;
+
+    /// <summary>
+    /// 範囲を連続したチャンクに均等に分ける(割り切れない分は前のチャンクから1つずつ多くする)
+    /// </summary>
+    /// <param name="count">数</param>
+    /// <param name="chunkCount">チャンク数</param>
+    /// <param name="chunks">チャンク</param>
+    static void Split( uint32_t count, uint32_t chunkCount, std::vector<Chunk>& chunks );
+
+    /// <summary>1チャンクの最小の数を設定</summary>
+    void SetMinChunkSize( uint32_t minChunkSize ) { mMinChunkSize = ( std::max )( minChunkSize, 1u ); }
+
+    /// <summary>最大のチャンク数を設定(0なら記録先の数まで)</summary>
+    void SetMaxChunks( uint32_t maxChunks ) { mMaxChunks = maxChunks; }
+
+    /// <summary>1チャンクの最小の数を取得</summary>
+    uint32_t GetMinChunkSize() const { return mMinChunkSize; }
+
+    /// <summary>最大のチャンク数を取得</summary>
+    uint32_t GetMaxChunks() const { return mMaxChunks; }
+
+    /// <summary>直前の記録のチャンクを取得</summary>
+    const std::vector<Chunk>& GetChunks() const { return mChunks; }
+};
@@ -1,5 +1,9 @@
 #include "ResourceManager.h"
 
+#include <format>
+
+#include "utils/Logger.h"
+
 #pragma comment( lib, "dxcompiler.lib" )
 
 // コンストラクタ
@@ -81,9 +85,24 @@ ModelData* ResourceManager::GetModel( const std::string& path )
     }
     else
     {
+        // クック済みで元より新しければassimpを使わずに読み込む
+        auto cookedPath = CookedModel::GetCookedPath( path );
         auto model = std::make_unique<ModelData>();
+        if( CookedModel::IsUpToDate( path, cookedPath ) && model->Load( cookedPath ) )
+        {
+            auto* ptr = model.get();
+            mModels.emplace( path, std::move( model ) );
+            return ptr;
+        }
+
+        model = std::make_unique<ModelData>();
         if( model->Build( path ) )
         {
+            // 次回からはクックしたものを読み込む
+            if( !model->Cook( cookedPath ) )
+            {
+                LOG_WARN( std::format( "Failed to cook model: {}", path ) );
+            }
             auto* ptr = model.get();
             mModels.emplace( path, std::move( model ) );
             return ptr;
@@ -16,6 +16,15 @@ void RootParameter::InitAsCBV( uint32_t shaderRegister, D3D12_SHADER_VISIBILITY
     mRootParameter.ShaderVisibility = shaderVisibility;
 }
 
+// シェーダーリソースビューとして初期化
+void RootParameter::InitAsSRV( uint32_t shaderRegister, D3D12_SHADER_VISIBILITY shaderVisibility )
+{
+    mRootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    mRootParameter.Descriptor.ShaderRegister = shaderRegister;
+    mRootParameter.Descriptor.RegisterSpace = 0;
+    mRootParameter.ShaderVisibility = shaderVisibility;
+}
+
 // デスクリプタテーブルとして初期化
 void RootParameter::InitAsDescriptorTable( uint32_t numDescriptorRanges, D3D12_SHADER_VISIBILITY shaderVisibility )
 {
@@ -33,6 +33,14 @@ class RootParameter
     /// <param name="shaderVisibility">使用されるシェーダーステージ</param>
     void InitAsCBV( uint32_t shaderRegister, D3D12_SHADER_VISIBILITY shaderVisibility = D3D12_SHADER_VISIBILITY_ALL );
 
+    /// <summary>
+    /// シェーダーリソースビュー(ルートデスクリプタ)として初期化
+    /// 構造化バッファなどをデスクリプタヒープを使わずにGPU仮想アドレスで渡す
+    /// </summary>
+    /// <param name="shaderRegister">レジスタ番号</param>
+    /// <param name="shaderVisibility">使用されるシェーダーステージ</param>
+    void InitAsSRV( uint32_t shaderRegister, D3D12_SHADER_VISIBILITY shaderVisibility = D3D12_SHADER_VISIBILITY_ALL );
+
     /// <summary>
     /// デスクリプタテーブルとして初期化
     /// </summary>
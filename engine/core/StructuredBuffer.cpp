@@ -1,5 +1,7 @@
 #include "StructuredBuffer.h"
 
+#include <algorithm>
+
 #include "core/DirectXBase.h"
 #include "core/DirectXCommonSettings.h"
 
@@ -63,3 +65,11 @@ void StructuredBuffer::Update( const void* data )
 
     memcpy( mData, data, mSize );
 }
+
+// 先頭から一部の要素を更新
+void StructuredBuffer::Update( const void* data, uint32_t count )
+{
+    if( !mData ) return;
+
+    memcpy( mData, data, static_cast<size_t>( ( std::min )( count, mCount ) ) * mStrideSize );
+}
@@ -48,6 +48,19 @@ class StructuredBuffer
     /// <param name="data">データ</param>
     void Update( const void* data );
 
+    /// <summary>
+    /// 先頭から一部の要素を更新
+    /// </summary>
+    /// <param name="data">データ</param>
+    /// <param name="count">要素数</param>
+    void Update( const void* data, uint32_t count );
+
+    /// <summary>要素数を取得</summary>
+    uint32_t GetCount() const { return mCount; }
+
+    /// <summary>GPU仮想アドレスを取得</summary>
+    D3D12_GPU_VIRTUAL_ADDRESS GetGPUAddress() const { return mResource ? mResource->GetGPUVirtualAddress() : 0; }
+
     /// <summary>リソースを取得</summary>
     Microsoft::WRL::ComPtr<ID3D12Resource> GetResource() const { return mResource; }
 };
@@ -44,7 +44,7 @@ bool VertexBuffer::Create( uint32_t size, uint32_t strideSize )
 }
 
 // 更新
-void VertexBuffer::Update( void* data )
+void VertexBuffer::Update( const void* data )
 {
     if( !mData ) return;
 
@@ -40,7 +40,7 @@ class VertexBuffer
     /// 更新
     /// </summary>
     /// <param name="data">データ</param>
-    void Update( void* data );
+    void Update( const void* data );
 
     /// <summary>頂点バッファビューを取得</summary>
     const D3D12_VERTEX_BUFFER_VIEW& GetView() const { return mView; }
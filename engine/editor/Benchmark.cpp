@@ -0,0 +1,102 @@
+#include "Benchmark.h"
+
+#include <format>
+
+#include "benchmark/BenchmarkCases.h"
+#include "imgui/imgui.h"
+#include "utils/Logger.h"
+
+namespace
+{
+
+// 計測した処理の結果の書き込み先
+volatile uint64_t sResultSink = 0;
+
+}  // namespace
+
+// 計測した処理の結果を使ったことにする
+void Benchmark::KeepResult( uint64_t value )
+{
+    sResultSink = value;
+}
+
+// コンストラクタ
+Benchmark::Benchmark()
+    : mCases()
+{
+}
+
+// 初期化
+void Benchmark::Init()
+{
+    mCases.clear();
+
+    for( const auto& entry : BenchmarkCases::kEntries )
+    {
+        Register( entry.mName, entry.mFunc );
+    }
+}
+
+// 終了処理
+void Benchmark::Term()
+{
+    mCases.clear();
+}
+
+// ケースを登録
+void Benchmark::Register( const std::string& name, Func func )
+{
+    Case c = {};
+    c.mName = name;
+    c.mFunc = std::move( func );
+    mCases.emplace_back( std::move( c ) );
+}
+
+// ケースを実行
+void Benchmark::Run( uint32_t idx )
+{
+    if( idx >= mCases.size() ) return;
+
+    auto& c = mCases[idx];
+    c.mResult = c.mFunc();
+    LOG_INFO( std::format( "[Benchmark] {}\n{}", c.mName, c.mResult ) );
+}
+
+// すべてのケースを実行
+void Benchmark::RunAll()
+{
+    for( uint32_t i = 0; i < mCases.size(); ++i )
+    {
+        Run( i );
+    }
+}
+
+// GUIの更新
+void Benchmark::UpdateGUI()
+{
+    ImGui::Begin( "Benchmark" );
+
+    if( ImGui::Button( "Run All" ) )
+    {
+        RunAll();
+    }
+
+    for( uint32_t i = 0; i < mCases.size(); ++i )
+    {
+        auto& c = mCases[i];
+        ImGui::PushID( i );
+        if( ImGui::Button( "Run" ) )
+        {
+            Run( i );
+        }
+        ImGui::SameLine();
+        ImGui::Text( c.mName.c_str() );
+        if( !c.mResult.empty() )
+        {
+            ImGui::TextUnformatted( c.mResult.c_str() );
+        }
+        ImGui::PopID();
+    }
+
+    ImGui::End();
+}
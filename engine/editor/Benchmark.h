@@ -0,0 +1,138 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// ベンチマーク
+/// </summary>
+class Benchmark
+{
+   public:
+    // ベンチマーク関数(結果の文字列を返す)
+    using Func = std::function<std::string()>;
+
+   private:
+    /// <summary>
+    /// ベンチマークケース
+    /// </summary>
+    struct Case
+    {
+        // 名前
+        std::string mName;
+        // 関数
+        Func mFunc;
+        // 前回の結果
+        std::string mResult;
+    };
+
+    // ケースリスト
+    std::vector<Case> mCases;
+
+   public:
+    /// <summary>
+    /// インスタンスを取得
+    /// </summary>
+    /// <returns>インスタンス</returns>
+    static Benchmark& GetInstance()
+    {
+        static Benchmark instance;
+        return instance;
+    }
+
+    /// <summary>
+    /// 処理時間を計測
+    /// </summary>
+    /// <param name="iterations">繰り返し回数</param>
+    /// <param name="func">計測する処理</param>
+    /// <returns>1回あたりの処理時間(マイクロ秒)</returns>
+    template <typename F>
+    static double Measure( uint32_t iterations, F&& func )
+    {
+        if( iterations == 0 ) return 0.0;
+
+        // ウォームアップ
+        func();
+
+        auto start = std::chrono::steady_clock::now();
+        for( uint32_t i = 0; i < iterations; ++i )
+        {
+            func();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>( end - start ).count() / iterations;
+    }
+
+    /// <summary>
+    /// 計測した処理の結果を使ったことにする(使わない結果を求める処理が最適化で消えないように)
+    /// </summary>
+    /// <param name="value">結果</param>
+    static void KeepResult( uint64_t value );
+
+   private:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    Benchmark();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~Benchmark() = default;
+
+   public:
+    /// <summary>
+    /// コピーコンストラクタ禁止
+    /// </summary>
+    Benchmark( const Benchmark& ) = delete;
+
+    /// <summary>
+    /// 代入演算子禁止
+    /// </summary>
+    Benchmark& operator=( const Benchmark& ) = delete;
+
+    /// <summary>
+    /// ムーブコンストラクタ禁止
+    /// </summary>
+    Benchmark( Benchmark&& ) = delete;
+
+    /// <summary>
+    /// ムーブ代入演算子禁止
+    /// </summary>
+    Benchmark& operator=( Benchmark&& ) = delete;
+
+    /// <summary>
+    /// 初期化
+    /// </summary>
+    void Init();
+
+    /// <summary>
+    /// 終了処理
+    /// </summary>
+    void Term();
+
+    /// <summary>
+    /// ケースを登録
+    /// </summary>
+    /// <param name="name">名前</param>
+    /// <param name="func">関数</param>
+    void Register( const std::string& name, Func func );
+
+    /// <summary>
+    /// ケースを実行
+    /// </summary>
+    /// <param name="idx">インデックス</param>
+    void Run( uint32_t idx );
+
+    /// <summary>
+    /// すべてのケースを実行
+    /// </summary>
+    void RunAll();
+
+    /// <summary>
+    /// GUIの更新
+    /// </summary>
+    void UpdateGUI();
+};
@@ -79,4 +79,6 @@ void EditorBase::End()
 void EditorBase::Draw( CommandList* cmdList )
 {
     ImGui_ImplDX12_RenderDrawData( ImGui::GetDrawData(), cmdList->GetCmdList().Get() );
+    // ImGuiが直接セットしたステートは分からない
+    cmdList->InvalidateState();
 }
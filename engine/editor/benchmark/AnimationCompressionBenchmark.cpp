@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <format>
+
+#include "BenchmarkAnimation.h"
+#include "BenchmarkCases.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/animation/AnimationSampler.h"
+#include "graphics/model/ModelData.h"
+
+namespace
+{
+
+const std::string kModelPaths[] = {
+    "assets/model/bot/x_bot.fbx",
+    "assets/model/bot/y_bot.fbx",
+};
+const float kTolerances[] = { 0.001f, 0.01f, 0.1f };
+const uint32_t kIterations = 20;
+const float kDeltaTime = 1.0f / 60.0f;
+
+// クリップ全体をサンプリングしてモデル行列まで更新する
+// positions にはフレームごとのノードの位置を並べる
+template <class Clip>
+void SampleAll( const NodeHierarchy& nodes, const Clip& clip, std::vector<Vector3>& positions )
+{
+    NodePose pose;
+    nodes.CreatePose( pose );
+    AnimationSampler sampler;
+    sampler.SetClip( &clip );
+    positions.clear();
+    for( auto time = 0.0f; time <= clip.GetDuration(); time += kDeltaTime )
+    {
+        sampler.Sample( time, pose );
+        nodes.UpdateModelMatrices( pose );
+        for( const auto& mat : pose.mModelMats )
+        {
+            positions.emplace_back( mat.m[3][0], mat.m[3][1], mat.m[3][2] );
+        }
+    }
+}
+
+// サンプリングの時間(ボーンあたりのns)
+template <class Clip>
+double MeasureSample( const NodeHierarchy& nodes, const Clip& clip )
+{
+    NodePose pose;
+    nodes.CreatePose( pose );
+    AnimationSampler sampler;
+    sampler.SetClip( &clip );
+    auto frameCount = static_cast<uint32_t>( clip.GetDuration() / kDeltaTime ) + 1;
+    auto time = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            for( uint32_t i = 0; i < frameCount; ++i )
+            {
+                sampler.Sample( i * kDeltaTime, pose );
+            }
+        } );
+    return time * 1000.0 / ( static_cast<double>( frameCount ) * clip.GetChannels().size() );
+}
+
+}  // namespace
+
+// アニメーションの圧縮
+std::string BenchmarkCases::AnimationCompression()
+{
+    std::string result;
+    for( const auto& path : kModelPaths )
+    {
+        auto model = ResourceManager::GetInstance().GetModel( path );
+        if( !model )
+        {
+            result += "Failed to load " + path + "\n";
+            continue;
+        }
+
+        AnimationClip syntheticClip;
+        auto clip = BenchmarkAnimation::GetClip( *model, syntheticClip );
+        const auto& nodes = model->GetNodes();
+        std::vector<Vector3> reference;
+        SampleAll( nodes, *clip, reference );
+
+        uint32_t rawKeys = 0;
+        for( const auto& channel : clip->GetChannels() )
+        {
+            rawKeys += static_cast<uint32_t>( channel.mPositionTimes.size() + channel.mRotationTimes.size() + channel.mScaleTimes.size() );
+        }
+        result += std::format(
+            "{} / {} ({:.2f} s, {} bones)\n"
+            "  Raw      : {} keys, {} bytes, {:.1f} ns/bone\n",
+            path, clip->GetName(), clip->GetDuration(), clip->GetChannels().size(),
+            rawKeys, clip->GetMemorySize(), MeasureSample( nodes, *clip ) );
+
+        for( auto tolerance : kTolerances )
+        {
+            AnimationCompressionSettings settings = {};
+            settings.mTolerance = tolerance;
+            CompressedAnimationClip compressed;
+            compressed.Create( *clip, nodes, settings );
+
+            // フレームごとのノードの位置の誤差
+            std::vector<Vector3> positions;
+            SampleAll( nodes, compressed, positions );
+            auto maxError = 0.0f;
+            for( size_t i = 0; i < positions.size(); ++i )
+            {
+                maxError = ( std::max )( maxError, Length( positions[i] - reference[i] ) );
+            }
+
+            result += std::format(
+                "  Tol {:.3f}: {} keys, {} bytes ({:.1f}x), {:.1f} ns/bone, Max error: {:.2e}\n",
+                tolerance, compressed.GetKeyCount(), compressed.GetMemorySize(),
+                static_cast<double>( clip->GetMemorySize() ) / compressed.GetMemorySize(),
+                MeasureSample( nodes, compressed ), maxError );
+        }
+    }
+    return result;
+}
@@ -0,0 +1,171 @@
+#include <cmath>
+#include <format>
+#include <random>
+
+#include "BenchmarkAnimation.h"
+#include "BenchmarkCases.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/animation/AnimationGraphBatch.h"
+#include "graphics/model/ModelData.h"
+#include "math/MathUtil.h"
+
+namespace
+{
+
+const std::string kModelPath = "assets/model/bot/x_bot.fbx";
+const std::string kUpperBodyNode = "mixamorig:Spine1";
+const uint32_t kCharacterCount = 200;
+const uint32_t kClipCount = 8;
+const uint32_t kIterations = 20;
+const uint32_t kCrossFadeInterval = 30;
+const float kCrossFadeDuration = 0.3f;
+const float kDeltaTime = 1.0f / 60.0f;
+
+// キャラクター1体分の状態
+struct Character
+{
+    AnimationGraph mGraph;
+    NodePose mPose;
+    // 移動速度・方向・上半身・加算の重みのパラメータ
+    uint32_t mSpeedParam;
+    uint32_t mDirXParam;
+    uint32_t mDirYParam;
+    uint32_t mUpperParam;
+    uint32_t mAdditiveParam;
+    // 移動と向きを切り替えるクロスフェード
+    uint32_t mLocomotion;
+    float mPhase;
+};
+
+// 3層のグラフを作る(移動のブレンドスペース、上半身の上書き、全身の加算)
+void BuildGraph( Character& character, const NodeHierarchy& nodes, const CompressedAnimationClip* clips, int32_t upperBodyNode, float speed )
+{
+    auto& graph = character.mGraph;
+    graph.Create( &nodes );
+    character.mSpeedParam = graph.AddParameter( 0.0f );
+    character.mDirXParam = graph.AddParameter( 0.0f );
+    character.mDirYParam = graph.AddParameter( 0.0f );
+    character.mUpperParam = graph.AddParameter( 0.0f );
+    character.mAdditiveParam = graph.AddParameter( 0.0f );
+
+    // 基本の層: 1次元(待機・歩き・走り)と2次元(4方向)をクロスフェード
+    auto blend1D = graph.AddBlend1D(
+        character.mSpeedParam,
+        { graph.AddClip( &clips[0], speed ), graph.AddClip( &clips[1], speed ), graph.AddClip( &clips[2], speed ) },
+        { 0.0f, 0.5f, 1.0f } );
+    auto blend2D = graph.AddBlend2D(
+        character.mDirXParam, character.mDirYParam,
+        { graph.AddClip( &clips[3], speed ), graph.AddClip( &clips[4], speed ), graph.AddClip( &clips[5], speed ), graph.AddClip( &clips[6], speed ) },
+        { -1.0f, 1.0f }, { -1.0f, 1.0f } );
+    character.mLocomotion = graph.AddCrossfade( { blend1D, blend2D } );
+
+    // 上半身の層
+    auto upperMask = upperBodyNode != NodeHierarchy::kInvalidIndex ? graph.AddMask( upperBodyNode ) : AnimationGraph::kInvalidIndex;
+    auto layer = graph.AddLayer( character.mLocomotion, graph.AddClip( &clips[7], speed ), character.mUpperParam, upperMask );
+
+    // 加算の層
+    graph.AddAdditive( layer, graph.AddClip( &clips[1], speed * 1.5f ), character.mAdditiveParam );
+}
+
+}  // namespace
+
+// アニメーションのブレンドグラフ
+std::string BenchmarkCases::AnimationGraphs()
+{
+    auto model = ResourceManager::GetInstance().GetModel( kModelPath );
+    if( !model ) return "Failed to load " + kModelPath;
+
+    // 動きの違うクリップ(モデルのクリップがあれば最初のものに使う)
+    const auto& nodes = model->GetNodes();
+    std::vector<AnimationClip> rawClips( kClipCount );
+    std::vector<CompressedAnimationClip> clips( kClipCount );
+    for( uint32_t i = 0; i < kClipCount; ++i )
+    {
+        const AnimationClip* clip = nullptr;
+        if( i == 0 )
+        {
+            clip = BenchmarkAnimation::GetClip( *model, rawClips[i] );
+        }
+        else
+        {
+            BenchmarkAnimation::CreateSyntheticClip( *model, rawClips[i], i );
+            clip = &rawClips[i];
+        }
+        clips[i].Create( *clip, nodes );
+    }
+    auto upperBodyNode = nodes.FindNode( kUpperBodyNode );
+
+    // 再生速度と位相をずらしたキャラクター
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> speedDist( 0.8f, 1.2f );
+    std::uniform_real_distribution<float> phaseDist( 0.0f, MathUtil::kTwoPi );
+    std::vector<Character> characters( kCharacterCount );
+    AnimationGraphBatch batch;
+    for( auto& character : characters )
+    {
+        BuildGraph( character, nodes, clips.data(), upperBodyNode, speedDist( engine ) );
+        nodes.CreatePose( character.mPose );
+        character.mPhase = phaseDist( engine );
+        batch.Add( &character.mGraph, &character.mPose );
+    }
+
+    // パラメータを揺らし、一定間隔でクロスフェードする
+    uint32_t frame = 0;
+    auto updateParams = [&]()
+    {
+        auto time = frame * kDeltaTime;
+        for( uint32_t i = 0; i < kCharacterCount; ++i )
+        {
+            auto& character = characters[i];
+            auto& graph = character.mGraph;
+            auto phase = time + character.mPhase;
+            graph.SetParameter( character.mSpeedParam, 0.5f + 0.5f * std::sin( phase ) );
+            graph.SetParameter( character.mDirXParam, std::cos( phase * 0.7f ) );
+            graph.SetParameter( character.mDirYParam, std::sin( phase * 0.9f ) );
+            graph.SetParameter( character.mUpperParam, 0.5f + 0.5f * std::sin( phase * 1.3f ) );
+            graph.SetParameter( character.mAdditiveParam, 0.5f + 0.5f * std::cos( phase * 0.5f ) );
+            if( ( frame + i ) % kCrossFadeInterval == 0 )
+            {
+                graph.CrossFade( character.mLocomotion, ( frame / kCrossFadeInterval + i ) % 2, kCrossFadeDuration );
+            }
+        }
+        ++frame;
+    };
+
+    // 1フレーム回してプールを温める
+    updateParams();
+    batch.Execute( kDeltaTime );
+    auto warmPoses = batch.GetPooledPoseCount();
+
+    auto serialTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            updateParams();
+            batch.Execute( kDeltaTime, false );
+        } );
+    auto parallelTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            updateParams();
+            batch.Execute( kDeltaTime );
+        } );
+
+    size_t clipMemory = 0;
+    for( const auto& clip : clips )
+    {
+        clipMemory += clip.GetMemorySize();
+    }
+    return std::format(
+        "Characters: {}, Nodes: {}, Clips: {} ({} KB compressed), Upper body mask: {}\n"
+        "Graph: Crossfade(Blend1D x3, Blend2D 2x2) -> Layer(upper body) -> Additive (9 clips per character)\n"
+        "Serial  : {:.2f} ms ({:.1f} us per character)\n"
+        "Parallel: {:.2f} ms ({:.1f} us per character, {:.2f}x)\n"
+        "Pooled poses: {} after warmup, {} after {} frames",
+        kCharacterCount, nodes.GetCount(), kClipCount, clipMemory / 1024, upperBodyNode != NodeHierarchy::kInvalidIndex ? kUpperBodyNode : "none",
+        serialTime / 1000.0, serialTime / kCharacterCount,
+        parallelTime / 1000.0, parallelTime / kCharacterCount, serialTime / parallelTime,
+        warmPoses, batch.GetPooledPoseCount(), frame );
+}
@@ -0,0 +1,71 @@
+#include "BenchmarkAnimation.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "graphics/model/ModelData.h"
+#include "math/MathUtil.h"
+
+namespace
+{
+
+const float kSyntheticDuration = 2.0f;
+const uint32_t kSyntheticKeyCount = 61;
+const float kSyntheticAmplitude = 0.3f;
+const float kSyntheticJitter = 0.002f;
+
+}  // namespace
+
+// スキンのボーンを揺らすクリップを作る
+void BenchmarkAnimation::CreateSyntheticClip( const ModelData& model, AnimationClip& clip, uint32_t variant )
+{
+    const auto& bindPose = model.GetNodes().GetBindPose();
+    std::vector<uint8_t> isBone( model.GetNodes().GetCount(), 0 );
+    for( uint32_t i = 0; i < model.GetMeshCount(); ++i )
+    {
+        auto skin = model.GetSkin( i );
+        if( !skin ) continue;
+
+        for( auto nodeIdx : skin->mBoneNodes )
+        {
+            isBone[nodeIdx] = 1;
+        }
+    }
+
+    std::mt19937 engine( 12345 + variant );
+    std::uniform_real_distribution<float> jitterDist( -kSyntheticJitter, kSyntheticJitter );
+    std::vector<AnimationChannel> channels;
+    for( uint32_t nodeIdx = 0; nodeIdx < isBone.size(); ++nodeIdx )
+    {
+        if( !isBone[nodeIdx] ) continue;
+
+        AnimationChannel channel = {};
+        channel.mNodeIdx = static_cast<int32_t>( nodeIdx );
+        auto axis = Normalize( Vector3( std::sin( nodeIdx * 1.3f + variant ), std::cos( nodeIdx * 0.7f + variant ), 0.5f ) );
+        auto phase = nodeIdx * 0.37f + variant * 1.1f;
+        for( uint32_t k = 0; k < kSyntheticKeyCount; ++k )
+        {
+            auto time = kSyntheticDuration * k / ( kSyntheticKeyCount - 1 );
+            auto angle = kSyntheticAmplitude * std::sin( MathUtil::kTwoPi * time / kSyntheticDuration + phase ) + jitterDist( engine );
+            channel.mPositionTimes.emplace_back( time );
+            channel.mPositions.emplace_back( bindPose.mTranslates[nodeIdx] );
+            channel.mRotationTimes.emplace_back( time );
+            channel.mRotations.emplace_back( Quaternion( axis, angle ) * bindPose.mRotates[nodeIdx] );
+            channel.mScaleTimes.emplace_back( time );
+            channel.mScales.emplace_back( bindPose.mScales[nodeIdx] );
+        }
+        channels.emplace_back( std::move( channel ) );
+    }
+    clip.Create( variant == 0 ? "synthetic" : "synthetic" + std::to_string( variant ), kSyntheticDuration, std::move( channels ) );
+}
+
+// モデルの最初のクリップを取得
+const AnimationClip* BenchmarkAnimation::GetClip( const ModelData& model, AnimationClip& synthetic )
+{
+    auto clip = model.GetAnimation( 0 );
+    if( clip && clip->GetDuration() > 0.0f ) return clip;
+
+    CreateSyntheticClip( model, synthetic );
+    return &synthetic;
+}
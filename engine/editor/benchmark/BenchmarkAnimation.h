@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+#include "graphics/animation/AnimationClip.h"
+
+class ModelData;
+
+/// <summary>
+/// ベンチマーク用のアニメーション
+/// </summary>
+namespace BenchmarkAnimation
+{
+
+/// <summary>
+/// スキンのボーンを揺らすクリップを作る(モーションキャプチャ程度の揺らぎを含む)
+/// </summary>
+/// <param name="model">モデルデータ</param>
+/// <param name="clip">クリップ(出力)</param>
+/// <param name="variant">動きの種類(位相と回転軸を変える)</param>
+void CreateSyntheticClip( const ModelData& model, AnimationClip& clip, uint32_t variant = 0 );
+
+/// <summary>
+/// モデルの最初のクリップを取得(無ければ作る)
+/// </summary>
+/// <param name="model">モデルデータ</param>
+/// <param name="synthetic">作ったクリップの置き場所</param>
+/// <returns>クリップ</returns>
+const AnimationClip* GetClip( const ModelData& model, AnimationClip& synthetic );
+
+}  // namespace BenchmarkAnimation
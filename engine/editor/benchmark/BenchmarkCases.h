@@ -0,0 +1,186 @@
+#pragma once
+#include <string>
+
+/// <summary>
+/// ベンチマークケース
+/// </summary>
+namespace BenchmarkCases
+{
+
+/// <summary>
+/// ライトカリング(点光源・スポットライト各1万個)
+/// </summary>
+/// <returns>結果</returns>
+std::string LightCulling();
+
+/// <summary>
+/// シーンクエリ(即時実行と一括実行の比較)
+/// </summary>
+/// <returns>結果</returns>
+std::string SceneQuery();
+
+/// <summary>
+/// 量子化BVH(浮動小数点のBVHとのメモリ・速度の比較)
+/// </summary>
+/// <returns>結果</returns>
+std::string CompressedBVH();
+
+/// <summary>
+/// ハイトフィールド(同じ地形の三角形BVHとの比較)
+/// </summary>
+/// <returns>結果</returns>
+std::string TerrainQuery();
+
+/// <summary>
+/// k-d木(10万～100万点の構築・近傍探索)
+/// </summary>
+/// <returns>結果</returns>
+std::string KdTreeQuery();
+
+/// <summary>
+/// ノード階層の更新(1万ノード)
+/// </summary>
+/// <returns>結果</returns>
+std::string HierarchyUpdate();
+
+/// <summary>
+/// スケルタルアニメーション(ボット100体のサンプリング・CPUスキニング)
+/// </summary>
+/// <returns>結果</returns>
+std::string SkinnedBots();
+
+/// <summary>
+/// アニメーションの圧縮(ボットのクリップのサイズ・サンプリング速度・誤差)
+/// </summary>
+/// <returns>結果</returns>
+std::string AnimationCompression();
+
+/// <summary>
+/// アニメーションのブレンドグラフ(200体の3層のグラフを並列に評価)
+/// </summary>
+/// <returns>結果</returns>
+std::string AnimationGraphs();
+
+/// <summary>
+/// モデルインスタンスのメモリ(900個の箱のインスタンスあたりのメモリ・作成時間)
+/// </summary>
+/// <returns>結果</returns>
+std::string ModelInstances();
+
+/// <summary>
+/// モデルの読み込み(assimpとクックしたファイルの比較)
+/// </summary>
+/// <returns>結果</returns>
+std::string ModelLoad();
+
+/// <summary>
+/// 読み込み時のメッシュの最適化(メッシュごとのACMR・ATVRと、三角形の順を崩した入力の最適化時間)
+/// </summary>
+/// <returns>結果</returns>
+std::string MeshOptimization();
+
+/// <summary>
+/// メッシュの詳細度(生成したLODと時間、距離ごとに描画する三角形数)
+/// </summary>
+/// <returns>結果</returns>
+std::string MeshLods();
+
+/// <summary>
+/// メッシュレット(構築した数と時間、視点ごとにカリングした三角形数)
+/// </summary>
+/// <returns>結果</returns>
+std::string Meshlets();
+
+/// <summary>
+/// 頂点・インデックスの圧縮(モデルごとのバッファのサイズと、圧縮したときの誤差)
+/// </summary>
+/// <returns>結果</returns>
+std::string VertexFormats();
+
+/// <summary>
+/// 静的バッチ(セルの大きさごとの構築時間と、視点ごとのドローコール数)
+/// </summary>
+/// <returns>結果</returns>
+std::string StaticBatching();
+
+/// <summary>
+/// インスタンシング(箱と球を並べたときのドローコール数と、登録からソートまでの時間)
+/// </summary>
+/// <returns>結果</returns>
+std::string Instancing();
+
+/// <summary>
+/// 描画キーのソート(アイテム数ごとの比較関数でのソートと、64bitキーの基数ソートの時間)
+/// </summary>
+/// <returns>結果</returns>
+std::string DrawKeySort();
+
+/// <summary>
+/// 描画アイテムの配置(アイテム数ごとの、構造体の配列と、キーとアイテムを分けた配列でのソートと描画の走査の時間)
+/// </summary>
+/// <returns>結果</returns>
+std::string SortItemLayout();
+
+/// <summary>
+/// 前フレームの並びを使うソート(デバッグカメラを回したときの、回転の速さごとの基数ソートとの時間と並びの乱れ)
+/// </summary>
+/// <returns>結果</returns>
+std::string CoherentSort();
+
+/// <summary>
+/// 不透明の距離の段階の分け方(分け方ごとのPSOの切り替えとFront-to-Backの崩れ、ソートの時間)
+/// </summary>
+/// <returns>結果</returns>
+std::string DepthBucketing();
+
+/// <summary>
+/// コマンドリストのステートの重複の除去(ソーターと同じ呼び出しをデバイスなしで流したときの、種類ごとの捨てた数)
+/// </summary>
+/// <returns>結果</returns>
+std::string StateFiltering();
+
+/// <summary>
+/// スレッドごとのコマンドリストへの並列記録(1万ドローコールを分けるコマンドリストの数ごとの記録時間)
+/// </summary>
+/// <returns>結果</returns>
+std::string ParallelRecording();
+
+/// <summary>
+/// 登録するケース
+/// </summary>
+struct Entry
+{
+    // 名前
+    const char* mName;
+    // 関数
+    std::string ( *mFunc )();
+};
+
+// 登録するケース(この順にGUIへ並ぶ、ケースを足すときは宣言とここに1行足す)
+inline constexpr Entry kEntries[] = {
+    { "Light Culling (10k)", &LightCulling },
+    { "Scene Query (10k)", &SceneQuery },
+    { "Quantized BVH (grid, models)", &CompressedBVH },
+    { "Heightfield (1025x1025)", &TerrainQuery },
+    { "k-d Tree (100k-1M)", &KdTreeQuery },
+    { "Node Hierarchy (10k)", &HierarchyUpdate },
+    { "Skinned Animation (100 bots)", &SkinnedBots },
+    { "Animation Compression (bots)", &AnimationCompression },
+    { "Animation Graph (200 characters)", &AnimationGraphs },
+    { "Model Instances (900 boxes)", &ModelInstances },
+    { "Model Load (assimp vs cooked)", &ModelLoad },
+    { "Mesh Optimization (sphere, bots)", &MeshOptimization },
+    { "Mesh LOD (sphere, bots)", &MeshLods },
+    { "Meshlet Culling (sphere, bots)", &Meshlets },
+    { "Vertex Compression (all models)", &VertexFormats },
+    { "Static Batching (box grid)", &StaticBatching },
+    { "GPU Instancing (box grid)", &Instancing },
+    { "Draw Key Sort (1k-100k)", &DrawKeySort },
+    { "Sort Item Layout (1k-100k)", &SortItemLayout },
+    { "Coherent Sort (orbiting camera)", &CoherentSort },
+    { "Depth Bucketing (mixed grid)", &DepthBucketing },
+    { "State Filtering (10k items)", &StateFiltering },
+    { "Parallel Recording (10k draws)", &ParallelRecording },
+};
+
+}  // namespace BenchmarkCases
@@ -0,0 +1,61 @@
+#include "BenchmarkScene.h"
+
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/Camera.h"
+#include "graphics/model/MeshSorter.h"
+#include "graphics/model/ModelInstance.h"
+#include "math/MathUtil.h"
+
+// レンダラーと同じ視野角のカメラにする
+void BenchmarkScene::SetupCamera( Camera& camera, const Vector3& position, float pitch, float nearZ )
+{
+    camera.mPosition = position;
+    camera.mRotate = Quaternion( Vector3::kUnitX, pitch );
+    camera.mFov = MathUtil::kPi / 4.0f;
+    camera.mNearZ = nearZ;
+    camera.Update();
+}
+
+// 格子の位置を取得
+Vector3 BenchmarkScene::GetGridPosition( uint32_t idx, uint32_t gridSize, float interval )
+{
+    auto x = ( idx % gridSize - ( gridSize - 1 ) / 2.0f ) * interval;
+    auto z = ( idx / gridSize - ( gridSize - 1 ) / 2.0f ) * interval;
+    return Vector3( x, 0.0f, z );
+}
+
+// 箱と球を格子に並べたインスタンスを作る
+bool BenchmarkScene::CreateBoxGrid( uint32_t gridSize, float interval, float scale, uint32_t sphereInterval, std::vector<std::unique_ptr<ModelInstance>>& instances )
+{
+    auto& resMgr = ResourceManager::GetInstance();
+    auto box = resMgr.GetModel( "assets/model/box/box.obj" );
+    auto sphere = resMgr.GetModel( "assets/model/sphere/sphere.obj" );
+    if( !box || !sphere ) return false;
+
+    instances.resize( gridSize * gridSize );
+    for( uint32_t i = 0; i < gridSize * gridSize; ++i )
+    {
+        instances[i] = std::make_unique<ModelInstance>();
+        instances[i]->Create( i % sphereInterval == 0 ? sphere : box );
+        instances[i]->SetWorldMatrix( CreateScale( Vector3::kOne * scale ) * CreateTranslate( GetGridPosition( i, gridSize, interval ) ) );
+    }
+    return true;
+}
+
+// ソーターを空にしてインスタンスを登録し、ソートする
+void BenchmarkScene::AddAndSort( MeshSorter& sorter, const std::vector<std::unique_ptr<ModelInstance>>& instances )
+{
+    sorter.Clear();
+    for( auto& instance : instances )
+    {
+        instance->Draw( &sorter );
+    }
+    sorter.Sort();
+}
+
+// 登録からソートまでの処理時間を計測
+double BenchmarkScene::MeasureAddAndSort( MeshSorter& sorter, const std::vector<std::unique_ptr<ModelInstance>>& instances, uint32_t iterations )
+{
+    return Benchmark::Measure( iterations, [&]() { AddAndSort( sorter, instances ); } );
+}
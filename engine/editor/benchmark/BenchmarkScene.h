@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "math/Vector3.h"
+
+class Camera;
+class MeshSorter;
+class ModelInstance;
+
+/// <summary>
+/// ベンチマーク用のシーン(カメラと、原点を中心にXZ平面へ並べたモデルの格子)
+/// </summary>
+namespace BenchmarkScene
+{
+
+// レンダラーと同じ近平面
+constexpr float kNearZ = 10.0f;
+
+/// <summary>
+/// レンダラーと同じ視野角のカメラにする
+/// </summary>
+/// <param name="camera">カメラ</param>
+/// <param name="position">位置</param>
+/// <param name="pitch">X軸回りの回転(正で見下ろす)</param>
+/// <param name="nearZ">近平面</param>
+void SetupCamera( Camera& camera, const Vector3& position, float pitch = 0.0f, float nearZ = kNearZ );
+
+/// <summary>
+/// 格子の位置を取得(X方向に並べてから次の行へ)
+/// </summary>
+/// <param name="idx">インデックス</param>
+/// <param name="gridSize">1辺の数</param>
+/// <param name="interval">間隔</param>
+/// <returns>位置</returns>
+Vector3 GetGridPosition( uint32_t idx, uint32_t gridSize, float interval );
+
+/// <summary>
+/// 箱と球を格子に並べたインスタンスを作る(同じメッシュの連続を途切れさせる)
+/// </summary>
+/// <param name="gridSize">1辺の数</param>
+/// <param name="interval">間隔</param>
+/// <param name="scale">スケール</param>
+/// <param name="sphereInterval">この数に1つを球にする</param>
+/// <param name="instances">インスタンス(出力)</param>
+/// <returns>成否(モデルを読み込めなかったらfalse)</returns>
+bool CreateBoxGrid( uint32_t gridSize, float interval, float scale, uint32_t sphereInterval, std::vector<std::unique_ptr<ModelInstance>>& instances );
+
+/// <summary>
+/// ソーターを空にしてインスタンスを登録し、ソートする
+/// </summary>
+/// <param name="sorter">ソーター</param>
+/// <param name="instances">インスタンス</param>
+void AddAndSort( MeshSorter& sorter, const std::vector<std::unique_ptr<ModelInstance>>& instances );
+
+/// <summary>
+/// 登録からソートまでの処理時間を計測
+/// </summary>
+/// <param name="sorter">ソーター</param>
+/// <param name="instances">インスタンス</param>
+/// <param name="iterations">繰り返し回数</param>
+/// <returns>1回あたりの処理時間(マイクロ秒)</returns>
+double MeasureAddAndSort( MeshSorter& sorter, const std::vector<std::unique_ptr<ModelInstance>>& instances, uint32_t iterations );
+
+}  // namespace BenchmarkScene
@@ -0,0 +1,81 @@
+#include <format>
+#include <memory>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "BenchmarkScene.h"
+#include "editor/Benchmark.h"
+#include "graphics/DebugCamera.h"
+#include "graphics/model/MeshSorter.h"
+#include "graphics/model/ModelInstance.h"
+#include "math/MathUtil.h"
+
+namespace
+{
+
+// 箱と球を並べる
+const uint32_t kGridSize = 60;
+const float kGridInterval = 20.0f;
+const float kBoxScale = 5.0f;
+const uint32_t kSphereInterval = 7;
+// フレームごとのヨーの回転量(度)
+const float kOrbitSpeeds[] = { 0.25f, 2.0f, 20.0f };
+const uint32_t kFrames = 120;
+
+}  // namespace
+
+// 前フレームの並びを使うソート
+std::string BenchmarkCases::CoherentSort()
+{
+    DebugCamera debugCamera;
+    auto camera = debugCamera.GetCamera();
+    camera->mFov = MathUtil::kPi / 4.0f;
+    camera->mNearZ = BenchmarkScene::kNearZ;
+    MeshSorter sorter;
+    if( !sorter.Init( camera ) ) return "Failed to create the sorter\n";
+    sorter.SetFrustumCamera( camera );
+    // ソートだけを比べる
+    sorter.SetUseInstancing( false );
+
+    std::vector<std::unique_ptr<ModelInstance>> instances;
+    if( !BenchmarkScene::CreateBoxGrid( kGridSize, kGridInterval, kBoxScale, kSphereInterval, instances ) ) return "Failed to load the models\n";
+
+    std::string result = std::format( "{} instances, {} frames orbiting the debug camera\n", instances.size(), kFrames );
+    for( auto orbitSpeed : kOrbitSpeeds )
+    {
+        for( auto useCoherentSort : { false, true } )
+        {
+            // 1フレームごとにカメラを回して、登録からソートまで
+            sorter.SetUseCoherentSort( useCoherentSort );
+            uint32_t items = 0;
+            uint32_t coherentFrames = 0;
+            uint64_t descents = 0;
+            uint64_t moves = 0;
+            auto time = Benchmark::Measure(
+                kFrames,
+                [&]()
+                {
+                    debugCamera.Orbit( orbitSpeed * MathUtil::kDegToRad, 0.0f );
+                    debugCamera.Update();
+                    BenchmarkScene::AddAndSort( sorter, instances );
+
+                    const auto& stats = sorter.GetStats();
+                    items = stats.mItems;
+                    coherentFrames += stats.mCoherentSort ? 1 : 0;
+                    descents += stats.mSortDescents;
+                    moves += stats.mSortMoves;
+                } );
+            result += std::format(
+                "{:.2f} deg/frame, {}: {} items, add + sort {:.2f} us",
+                orbitSpeed, useCoherentSort ? "coherent" : "radix", items, time );
+            if( useCoherentSort )
+            {
+                // ウォームアップの1フレームを含む
+                result += std::format( ", insertion {} / {} frames, avg descents {}, avg moves {}", coherentFrames, kFrames + 1, descents / ( kFrames + 1 ), moves / ( kFrames + 1 ) );
+            }
+            result += "\n";
+        }
+    }
+    sorter.Clear();
+    return result;
+}
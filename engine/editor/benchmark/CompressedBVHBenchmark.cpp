@@ -0,0 +1,181 @@
+#include <cmath>
+#include <format>
+#include <random>
+
+#include "BenchmarkCases.h"
+#include "collision/QuantizedBVH.h"
+#include "collision/TriangleMesh.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+
+namespace
+{
+
+const uint32_t kGridSize = 512;
+const uint32_t kRayCount = 10000;
+const uint32_t kIterations = 5;
+const float kCellSize = 2.0f;
+const std::string kModelPaths[] = {
+    "assets/model/sphere/sphere.obj",
+    "assets/model/bot/x_bot.fbx",
+    "assets/model/bot/y_bot.fbx",
+};
+
+// 浮動小数点のBVHと量子化BVHを構築して半直線の判定を計測
+std::string MeasureMesh( const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, const std::vector<Vector3>& origins, const std::vector<Vector3>& dirs, float maxDist )
+{
+    TriangleMesh floatMesh;
+    QuantizedBVH quantized;
+    auto floatBuildTime = Benchmark::Measure(
+        1,
+        [&]()
+        {
+            floatMesh.Create( positions, indices );
+        } );
+    auto quantizedBuildTime = Benchmark::Measure(
+        1,
+        [&]()
+        {
+            quantized.Build( positions, indices );
+        } );
+
+    auto rayCount = static_cast<uint32_t>( origins.size() );
+    auto measure = [&]( auto&& raycast )
+    {
+        uint32_t hitCount = 0;
+        auto time = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                hitCount = 0;
+                RaycastHit hit = {};
+                for( uint32_t i = 0; i < rayCount; ++i )
+                {
+                    hitCount += raycast( origins[i], dirs[i], hit ) ? 1 : 0;
+                }
+            } );
+        return std::make_pair( time, hitCount );
+    };
+    auto floatResult = measure(
+        [&]( const Vector3& origin, const Vector3& dir, RaycastHit& hit )
+        {
+            return floatMesh.Raycast( origin, dir, maxDist, hit );
+        } );
+    auto quantizedResult = measure(
+        [&]( const Vector3& origin, const Vector3& dir, RaycastHit& hit )
+        {
+            return quantized.Raycast( origin, dir, maxDist, hit );
+        } );
+    auto stacklessResult = measure(
+        [&]( const Vector3& origin, const Vector3& dir, RaycastHit& hit )
+        {
+            return quantized.RaycastStackless( origin, dir, maxDist, hit );
+        } );
+
+    auto triCount = static_cast<double>( floatMesh.GetTriangleCount() );
+    return std::format(
+        "Triangles: {}, Rays: {}\n"
+        "Float BVH    : {:.2f} bytes/tri, build {:.1f} ms\n"
+        "Quantized BVH: {:.2f} bytes/tri, build {:.1f} ms\n"
+        "Raycast float    : {:.1f} us ({} hits)\n"
+        "Raycast quantized: {:.1f} us ({} hits)\n"
+        "Raycast stackless: {:.1f} us ({} hits)\n",
+        floatMesh.GetTriangleCount(), rayCount,
+        floatMesh.GetBVH().GetMemorySize() / triCount, floatBuildTime / 1000.0,
+        quantized.GetMemorySize() / triCount, quantizedBuildTime / 1000.0,
+        floatResult.first, floatResult.second,
+        quantizedResult.first, quantizedResult.second,
+        stacklessResult.first, stacklessResult.second );
+}
+
+}  // namespace
+
+// 量子化BVH
+std::string BenchmarkCases::CompressedBVH()
+{
+    // 起伏のある地形のメッシュ
+    std::vector<Vector3> positions;
+    positions.reserve( ( kGridSize + 1 ) * ( kGridSize + 1 ) );
+    for( uint32_t z = 0; z <= kGridSize; ++z )
+    {
+        for( uint32_t x = 0; x <= kGridSize; ++x )
+        {
+            auto height = std::sin( x * 0.05f ) * 20.0f + std::cos( z * 0.07f ) * 15.0f;
+            positions.emplace_back( Vector3( x * kCellSize, height, z * kCellSize ) );
+        }
+    }
+    std::vector<uint32_t> indices;
+    indices.reserve( kGridSize * kGridSize * 6 );
+    for( uint32_t z = 0; z < kGridSize; ++z )
+    {
+        for( uint32_t x = 0; x < kGridSize; ++x )
+        {
+            auto v0 = z * ( kGridSize + 1 ) + x;
+            auto v1 = v0 + 1;
+            auto v2 = v0 + kGridSize + 1;
+            auto v3 = v2 + 1;
+            indices.insert( indices.end(), { v0, v2, v1, v1, v2, v3 } );
+        }
+    }
+
+    // 上から斜めに落とす半直線
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> posDist( 0.0f, kGridSize * kCellSize );
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+    std::vector<Vector3> origins( kRayCount );
+    std::vector<Vector3> dirs( kRayCount );
+    for( uint32_t i = 0; i < kRayCount; ++i )
+    {
+        origins[i] = Vector3( posDist( engine ), 60.0f, posDist( engine ) );
+        dirs[i] = Normalize( Vector3( dirDist( engine ), -1.0f, dirDist( engine ) ) );
+    }
+    const auto maxDist = 500.0f;
+
+    std::string result = "Terrain grid\n" + MeasureMesh( positions, indices, origins, dirs, maxDist );
+
+    // 読み込んだモデルのメッシュ(全メッシュを1つにまとめる)
+    positions.clear();
+    indices.clear();
+    std::vector<Vector3> meshPositions;
+    std::vector<uint32_t> meshIndices;
+    for( const auto& path : kModelPaths )
+    {
+        auto model = ResourceManager::GetInstance().GetModel( path );
+        if( !model )
+        {
+            result += "Failed to load " + path + "\n";
+            continue;
+        }
+        for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+        {
+            model->GetMesh( i )->GetTriangles( meshPositions, meshIndices );
+            auto base = static_cast<uint32_t>( positions.size() );
+            positions.insert( positions.end(), meshPositions.begin(), meshPositions.end() );
+            for( auto idx : meshIndices )
+            {
+                indices.emplace_back( base + idx );
+            }
+        }
+    }
+    if( indices.empty() ) return result;
+
+    // 境界を囲む球面から内側へ向かう半直線
+    AABB3D bounds = {};
+    bounds.Reset();
+    for( const auto& p : positions )
+    {
+        bounds.Update( p );
+    }
+    auto center = ( bounds.mMin + bounds.mMax ) * 0.5f;
+    auto extent = bounds.mMax - bounds.mMin;
+    auto radius = Length( extent );
+    std::uniform_real_distribution<float> unitDist( -1.0f, 1.0f );
+    for( uint32_t i = 0; i < kRayCount; ++i )
+    {
+        origins[i] = center + Normalize( Vector3( unitDist( engine ), unitDist( engine ), unitDist( engine ) ) + Vector3( 0.0f, 0.0f, 0.01f ) ) * radius;
+        auto target = center + Vector3( unitDist( engine ) * extent.x, unitDist( engine ) * extent.y, unitDist( engine ) * extent.z ) * 0.5f;
+        dirs[i] = Normalize( target - origins[i] );
+    }
+    result += "Model meshes\n" + MeasureMesh( positions, indices, origins, dirs, radius * 2.0f );
+    return result;
+}
@@ -0,0 +1,92 @@
+#include <format>
+#include <memory>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "BenchmarkScene.h"
+#include "core/ResourceManager.h"
+#include "graphics/Camera.h"
+#include "graphics/model/MeshSorter.h"
+#include "graphics/model/ModelInstance.h"
+
+namespace
+{
+
+// 箱・球・床のモデルを交互に並べる(PSOが混ざる)
+const char* kModelPaths[] = {
+    "assets/model/box/box.obj",
+    "assets/model/sphere/sphere.obj",
+    "assets/model/floor/floor.glb",
+};
+const float kModelScales[] = { 5.0f, 5.0f, 0.1f };
+const uint32_t kGridSize = 60;
+const float kGridInterval = 20.0f;
+const uint32_t kIterations = 20;
+
+/// <summary>
+/// 分け方の設定
+/// </summary>
+struct BucketingDesc
+{
+    const char* mName;
+    DrawKey::DepthBucketing mBucketing;
+    float mBucketSize;
+    uint32_t mBucketCount;
+};
+const BucketingDesc kBucketings[] = {
+    { "linear 1m", DrawKey::DepthBucketing::Linear, 1.0f, 0 },
+    { "linear 50m", DrawKey::DepthBucketing::Linear, 50.0f, 0 },
+    { "log 16", DrawKey::DepthBucketing::Logarithmic, 0.0f, 16 },
+    { "log 64", DrawKey::DepthBucketing::Logarithmic, 0.0f, 64 },
+    { "adaptive 16", DrawKey::DepthBucketing::Adaptive, 0.0f, 16 },
+    { "adaptive 64", DrawKey::DepthBucketing::Adaptive, 0.0f, 64 },
+    { "fixed 16", DrawKey::DepthBucketing::FixedCount, 0.0f, 16 },
+    { "fixed 64", DrawKey::DepthBucketing::FixedCount, 0.0f, 64 },
+};
+
+}  // namespace
+
+// 不透明の距離の段階の分け方
+std::string BenchmarkCases::DepthBucketing()
+{
+    auto& resMgr = ResourceManager::GetInstance();
+    std::vector<ModelData*> models;
+    for( auto path : kModelPaths )
+    {
+        auto model = resMgr.GetModel( path );
+        if( !model ) return std::format( "Failed to load {}\n", path );
+
+        models.emplace_back( model );
+    }
+
+    // レンダラーと同じ視野角で、格子を斜めに見下ろす
+    Camera camera;
+    BenchmarkScene::SetupCamera( camera, Vector3( 0.0f, 80.0f, -700.0f ), 0.15f );
+    MeshSorter sorter;
+    if( !sorter.Init( &camera ) ) return "Failed to create the sorter\n";
+    sorter.SetFrustumCamera( &camera );
+    sorter.SetUseCoherentSort( false );
+
+    std::vector<std::unique_ptr<ModelInstance>> instances( kGridSize * kGridSize );
+    for( uint32_t i = 0; i < kGridSize * kGridSize; ++i )
+    {
+        auto modelIdx = ( i * 7 + i / kGridSize ) % models.size();
+        instances[i] = std::make_unique<ModelInstance>();
+        instances[i]->Create( models[modelIdx] );
+        instances[i]->SetWorldMatrix( CreateScale( Vector3::kOne * kModelScales[modelIdx] ) * CreateTranslate( BenchmarkScene::GetGridPosition( i, kGridSize, kGridInterval ) ) );
+    }
+
+    std::string result = std::format( "{} instances, near {} far {}\n", instances.size(), camera.mNearZ, camera.mFarZ );
+    for( const auto& desc : kBucketings )
+    {
+        sorter.SetDepthBucketing( desc.mBucketing, desc.mBucketSize, desc.mBucketCount );
+        auto time = BenchmarkScene::MeasureAddAndSort( sorter, instances, kIterations );
+        const auto& stats = sorter.GetStats();
+        result += std::format(
+            "{}: {} draws, PSO switches {}, depth inversions {} / {} ({:.1f}%), add + sort {:.2f} us\n",
+            desc.mName, stats.mDraws, stats.mPSOSwitches, stats.mDepthInversions, stats.mOpaqueItems,
+            stats.mOpaqueItems > 0 ? stats.mDepthInversions * 100.0 / stats.mOpaqueItems : 0.0, time );
+    }
+    sorter.Clear();
+    return result;
+}
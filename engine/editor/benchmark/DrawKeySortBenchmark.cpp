@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <format>
+#include <random>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "editor/Benchmark.h"
+#include "graphics/model/DrawKey.h"
+#include "graphics/model/Material.h"
+#include "graphics/model/MeshSorter.h"
+#include "graphics/model/PSOKey.h"
+
+namespace
+{
+
+const uint32_t kItemCounts[] = { 1000, 10000, 100000 };
+const uint32_t kMaterialCount = 64;
+const uint32_t kMeshCount = 32;
+// 半透明のマテリアルの割合(この数に1つ)
+const uint32_t kTransparentInterval = 8;
+const float kMaxDistance = 1000.0f;
+const uint32_t kIterations = 20;
+
+const uint64_t kPSOKeys[] = {
+    MakePSOKey( MeshFlags::Required, MaterialFlags::None ),
+    MakePSOKey( MeshFlags::Required, MaterialFlags::HasTexture ),
+    MakePSOKey( MeshFlags::Required | MeshFlags::Compact, MaterialFlags::None ),
+    MakePSOKey( MeshFlags::Required | MeshFlags::Compact, MaterialFlags::HasTexture ),
+    MakePSOKey( MeshFlags::Required, MaterialFlags::HasTexture | MaterialFlags::NoCulling ),
+};
+
+/// <summary>
+/// 比較関数でソートしていたときの描画アイテム
+/// </summary>
+struct ComparatorItem
+{
+    MeshSorter::SortItem mItem;
+    uint32_t mQuantizedDist;
+};
+
+// 比較関数でのソート(キーを作る前のソーターと同じ)
+void SortByComparator( std::vector<ComparatorItem>& items )
+{
+    std::sort(
+        items.begin(),
+        items.end(),
+        []( const ComparatorItem& a, const ComparatorItem& b )
+        {
+            auto rqA = a.mItem.mMaterial->GetRenderQueue();
+            auto rqB = b.mItem.mMaterial->GetRenderQueue();
+            if( rqA != rqB ) return rqA < rqB;
+
+            switch( rqA )
+            {
+                case RenderQueue::Opaque:
+                    if( a.mQuantizedDist != b.mQuantizedDist ) return a.mQuantizedDist < b.mQuantizedDist;
+
+                    if( a.mItem.mPSOKey != b.mItem.mPSOKey ) return a.mItem.mPSOKey < b.mItem.mPSOKey;
+
+                    return a.mItem.mDistance < b.mItem.mDistance;
+
+                case RenderQueue::Transparent:
+                    return a.mItem.mDistance > b.mItem.mDistance;
+
+                default:
+                    return false;
+            }
+        } );
+}
+
+}  // namespace
+
+// 描画キーのソート
+std::string BenchmarkCases::DrawKeySort()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> distanceDist( 0.0f, kMaxDistance );
+    std::uniform_int_distribution<uint32_t> materialDist( 0, kMaterialCount - 1 );
+    std::uniform_int_distribution<uint32_t> meshDist( 0, kMeshCount - 1 );
+    std::uniform_int_distribution<uint32_t> psoDist( 0, static_cast<uint32_t>( std::size( kPSOKeys ) ) - 1 );
+
+    // マテリアル(定数バッファは作らない)とメッシュの代わりのアドレス
+    std::vector<Material> materials( kMaterialCount );
+    for( uint32_t i = 0; i < kMaterialCount; i += kTransparentInterval )
+    {
+        materials[i].SetRenderQueue( RenderQueue::Transparent );
+    }
+    std::vector<uint64_t> meshes( kMeshCount );
+
+    std::string result;
+    for( auto itemCount : kItemCounts )
+    {
+        std::vector<MeshSorter::SortItem> items( itemCount );
+        std::vector<uint32_t> psoIds( itemCount );
+        for( uint32_t i = 0; i < itemCount; ++i )
+        {
+            auto psoIdx = psoDist( engine );
+            auto& item = items[i];
+            item.mPSOKey = kPSOKeys[psoIdx];
+            item.mDistance = distanceDist( engine );
+            item.mMesh = reinterpret_cast<Mesh*>( &meshes[meshDist( engine )] );
+            item.mMaterial = &materials[materialDist( engine )];
+            psoIds[i] = psoIdx;
+        }
+
+        // 比較関数(比較のたびにマテリアルを参照する)
+        std::vector<ComparatorItem> comparatorItems;
+        auto comparatorTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                comparatorItems.resize( itemCount );
+                for( uint32_t i = 0; i < itemCount; ++i )
+                {
+                    comparatorItems[i] = ComparatorItem{ items[i], static_cast<uint32_t>( items[i].mDistance ) };
+                }
+                SortByComparator( comparatorItems );
+            } );
+
+        // キーを作って基数ソートし、その順にアイテムを並べる
+        std::vector<DrawKey::Entry> entries;
+        std::vector<DrawKey::Entry> temp;
+        std::vector<MeshSorter::SortItem> sorted( itemCount );
+        auto radixTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                entries.resize( itemCount );
+                for( uint32_t i = 0; i < itemCount; ++i )
+                {
+                    const auto& item = items[i];
+                    entries[i] = DrawKey::Entry{ DrawKey::Make( item.mMaterial->GetRenderQueue(), item.mDistance, psoIds[i], item.mMaterial, item.mMesh ), i };
+                }
+                DrawKey::RadixSort( entries, temp );
+                for( uint32_t i = 0; i < itemCount; ++i )
+                {
+                    sorted[i] = items[entries[i].mIndex];
+                }
+            } );
+
+        // キーだけのソート(並べる前の組を写してから)を、基数ソートと比較関数で
+        std::vector<DrawKey::Entry> unsorted( itemCount );
+        for( uint32_t i = 0; i < itemCount; ++i )
+        {
+            const auto& item = items[i];
+            unsorted[i] = DrawKey::Entry{ DrawKey::Make( item.mMaterial->GetRenderQueue(), item.mDistance, psoIds[i], item.mMaterial, item.mMesh ), i };
+        }
+        auto radixOnlyTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                entries = unsorted;
+                DrawKey::RadixSort( entries, temp );
+            } );
+        auto keyLess = []( const DrawKey::Entry& a, const DrawKey::Entry& b ) { return a.mKey < b.mKey; };
+        auto keySortTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                entries = unsorted;
+                std::sort( entries.begin(), entries.end(), keyLess );
+            } );
+
+        result += std::format(
+            "{} items: comparator {:.1f} us, keys + radix + gather {:.1f} us (radix {:.1f} us, std::sort on keys {:.1f} us), x{:.2f}\n",
+            itemCount, comparatorTime, radixTime, radixOnlyTime, keySortTime, comparatorTime / radixTime );
+    }
+    return result;
+}
@@ -0,0 +1,157 @@
+#include <format>
+#include <optional>
+#include <random>
+
+#include "BenchmarkCases.h"
+#include "editor/Benchmark.h"
+#include "graphics/model/NodeHierarchy.h"
+
+namespace
+{
+
+const uint32_t kNodeCount = 10000;
+const uint32_t kMaxChildren = 4;
+const uint32_t kIterations = 100;
+const uint32_t kDirtyCount = 100;
+
+// 比較用の従来のノード(構造体の配列、子のリストを辿って再帰で更新)
+struct LegacyNode
+{
+    std::string mName;
+    Vector3 mScale;
+    Quaternion mRotate;
+    Vector3 mTranslate;
+    Matrix4 mLocalMat;
+    Matrix4 mModelMat;
+    int32_t mIndex;
+    std::optional<int32_t> mParent;
+    std::vector<int32_t> mChildren;
+};
+
+// 従来のノードを再帰で更新
+void UpdateLegacyNode( std::vector<LegacyNode>& nodes, int32_t idx )
+{
+    auto& node = nodes[idx];
+    node.mLocalMat = CreateAffine( node.mScale, node.mRotate, node.mTranslate );
+    node.mModelMat = node.mParent ? node.mLocalMat * nodes[*node.mParent].mModelMat : node.mLocalMat;
+    for( auto child : node.mChildren )
+    {
+        UpdateLegacyNode( nodes, child );
+    }
+}
+
+}  // namespace
+
+// ノード階層の更新
+std::string BenchmarkCases::HierarchyUpdate()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> posDist( -1.0f, 1.0f );
+    std::uniform_real_distribution<float> angleDist( -0.5f, 0.5f );
+
+    // 幅優先で子を付けた木(親は必ず先に並ぶ)
+    NodeHierarchy hierarchy;
+    std::vector<LegacyNode> legacyNodes;
+    legacyNodes.reserve( kNodeCount );
+    std::uniform_int_distribution<uint32_t> childDist( 1, kMaxChildren );
+    uint32_t nextParent = 0;
+    uint32_t childrenLeft = 0;
+    for( uint32_t i = 0; i < kNodeCount; ++i )
+    {
+        int32_t parent = NodeHierarchy::kInvalidIndex;
+        if( i > 0 )
+        {
+            if( childrenLeft == 0 )
+            {
+                childrenLeft = childDist( engine );
+                parent = static_cast<int32_t>( nextParent++ );
+            }
+            else
+            {
+                parent = static_cast<int32_t>( nextParent - 1 );
+            }
+            --childrenLeft;
+        }
+        auto name = std::format( "node_{}", i );
+        auto scale = Vector3( 1.0f, 1.0f, 1.0f );
+        auto rotate = Quaternion( Normalize( Vector3( posDist( engine ), posDist( engine ), posDist( engine ) ) ), angleDist( engine ) );
+        auto translate = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        hierarchy.AddNode( name, parent, scale, rotate, translate );
+
+        LegacyNode node = {};
+        node.mName = name;
+        node.mScale = scale;
+        node.mRotate = rotate;
+        node.mTranslate = translate;
+        node.mIndex = static_cast<int32_t>( i );
+        if( parent != NodeHierarchy::kInvalidIndex )
+        {
+            node.mParent = parent;
+            legacyNodes[parent].mChildren.emplace_back( node.mIndex );
+        }
+        legacyNodes.emplace_back( node );
+    }
+
+    // インスタンスの作成(ノードの複製)
+    std::vector<LegacyNode> legacyCopy;
+    auto legacyCreateTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            legacyCopy = legacyNodes;
+        } );
+    NodePose pose;
+    auto createTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            hierarchy.CreatePose( pose );
+        } );
+
+    // モデル行列の更新
+    auto legacyUpdateTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            UpdateLegacyNode( legacyCopy, 0 );
+        } );
+    auto updateTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            pose.MarkAllDirty();
+            hierarchy.UpdateModelMatrices( pose );
+        } );
+
+    // 一部のノードだけ変更した場合(子孫も更新される)
+    std::uniform_int_distribution<uint32_t> nodeDist( 0, kNodeCount - 1 );
+    uint32_t partialNodes = 0;
+    auto partialTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            for( uint32_t i = 0; i < kDirtyCount; ++i )
+            {
+                pose.MarkDirty( static_cast<int32_t>( nodeDist( engine ) ) );
+            }
+            partialNodes = hierarchy.UpdateModelMatrices( pose );
+        } );
+    auto cleanTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            hierarchy.UpdateModelMatrices( pose );
+        } );
+
+    return std::format(
+        "Nodes: {}\n"
+        "Create : {:.1f} us -> {:.1f} us\n"
+        "Update : {:.1f} us -> {:.1f} us ({:.2f}x)\n"
+        "Update ({} dirty): {:.1f} us ({} nodes)\n"
+        "Update (no change): {:.1f} us",
+        kNodeCount,
+        legacyCreateTime, createTime,
+        legacyUpdateTime, updateTime, legacyUpdateTime / updateTime,
+        kDirtyCount, partialTime, partialNodes,
+        cleanTime );
+}
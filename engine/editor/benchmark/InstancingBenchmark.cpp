@@ -0,0 +1,49 @@
+#include <format>
+#include <memory>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "BenchmarkScene.h"
+#include "graphics/Camera.h"
+#include "graphics/model/MeshSorter.h"
+#include "graphics/model/ModelInstance.h"
+
+namespace
+{
+
+// レンダラーと同じ箱の並び(いくつかを球に置き換えて、同じメッシュの連続を途切れさせる)
+const uint32_t kGridSize = 30;
+const float kGridInterval = 20.0f;
+const float kBoxScale = 5.0f;
+const uint32_t kSphereInterval = 7;
+const uint32_t kIterations = 20;
+
+}  // namespace
+
+// インスタンシング
+std::string BenchmarkCases::Instancing()
+{
+    // レンダラーと同じカメラ
+    Camera camera;
+    BenchmarkScene::SetupCamera( camera, Vector3( 0.0f, 30.0f, -200.0f ) );
+    MeshSorter sorter;
+    if( !sorter.Init( &camera ) ) return "Failed to create the sorter\n";
+    sorter.SetFrustumCamera( &camera );
+
+    std::vector<std::unique_ptr<ModelInstance>> instances;
+    if( !BenchmarkScene::CreateBoxGrid( kGridSize, kGridInterval, kBoxScale, kSphereInterval, instances ) ) return "Failed to load the models\n";
+
+    std::string result = std::format( "{} instances (every {}th is a sphere)\n", instances.size(), kSphereInterval );
+    for( auto useInstancing : { false, true } )
+    {
+        // 登録とソート(ドローコールをまとめるまで)
+        sorter.SetUseInstancing( useInstancing );
+        auto time = BenchmarkScene::MeasureAddAndSort( sorter, instances, kIterations );
+        const auto& stats = sorter.GetStats();
+        result += std::format(
+            "{}: {} items -> {} draws (instanced {} draws / {} instances), add + sort {:.2f} us\n",
+            useInstancing ? "instancing" : "no instancing", stats.mItems, stats.mDraws, stats.mInstancedDraws, stats.mInstances, time );
+    }
+    sorter.Clear();
+    return result;
+}
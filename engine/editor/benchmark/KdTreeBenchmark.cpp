@@ -0,0 +1,119 @@
+#include <cmath>
+#include <format>
+#include <random>
+
+#include "BenchmarkCases.h"
+#include "collision/KdTree.h"
+#include "editor/Benchmark.h"
+#include "utils/JobSystem.h"
+
+namespace
+{
+
+const uint32_t kPointCounts[] = { 100000, 1000000 };
+const uint32_t kQueryCount = 10000;
+const uint32_t kNeighborCount = 8;
+const uint32_t kIterations = 5;
+const float kWorldSize = 1000.0f;
+
+}  // namespace
+
+// k-d木
+std::string BenchmarkCases::KdTreeQuery()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> posDist( -kWorldSize, kWorldSize );
+
+    std::vector<Vector3> queries( kQueryCount );
+    for( auto& query : queries )
+    {
+        query = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+    }
+
+    std::string result = std::format( "Queries: {}, Threads: {}", kQueryCount, JobSystem::GetInstance().GetThreadCount() );
+    for( auto pointCount : kPointCounts )
+    {
+        std::vector<Vector3> points( pointCount );
+        for( auto& point : points )
+        {
+            point = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        }
+        // 平均で数個が入る半径
+        auto radius = kWorldSize * 2.0f * std::cbrt( 4.0f / pointCount );
+
+        KdTree tree;
+        auto buildTime = Benchmark::Measure(
+            1,
+            [&]()
+            {
+                tree.Build( points );
+            } );
+
+        auto nearestTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                uint64_t checksum = 0;
+                for( const auto& query : queries )
+                {
+                    checksum += tree.FindNearest( query );
+                }
+                Benchmark::KeepResult( checksum );
+            } );
+        std::vector<uint32_t> indices;
+        auto knnTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                for( const auto& query : queries )
+                {
+                    tree.FindKNearest( query, kNeighborCount, indices );
+                }
+            } );
+        uint64_t radiusTotal = 0;
+        auto radiusTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                indices.clear();
+                for( const auto& query : queries )
+                {
+                    tree.FindInRadius( query, radius, indices );
+                }
+                radiusTotal = indices.size();
+            } );
+
+        // 並列の一括実行
+        std::vector<uint32_t> results;
+        std::vector<uint32_t> offsets;
+        auto nearestBatchTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                tree.FindNearestBatch( queries, results );
+            } );
+        auto knnBatchTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                tree.FindKNearestBatch( queries, kNeighborCount, results );
+            } );
+        auto radiusBatchTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                tree.FindInRadiusBatch( queries, radius, indices, offsets );
+            } );
+
+        result += std::format(
+            "\n[{} points] build {:.1f} ms, {:.1f} MB\n"
+            "  Nearest  : {:.1f} us (batch {:.1f} us)\n"
+            "  {}-NN     : {:.1f} us (batch {:.1f} us)\n"
+            "  Radius {:.1f}: {:.1f} us (batch {:.1f} us, avg {:.1f} found)",
+            pointCount, buildTime / 1000.0, tree.GetMemorySize() / ( 1024.0 * 1024.0 ),
+            nearestTime, nearestBatchTime,
+            kNeighborCount, knnTime, knnBatchTime,
+            radius, radiusTime, radiusBatchTime, static_cast<double>( radiusTotal ) / kQueryCount );
+    }
+    return result;
+}
@@ -0,0 +1,152 @@
+#include <format>
+#include <memory>
+#include <random>
+
+#include "BenchmarkCases.h"
+#include "collision/Collision.h"
+#include "editor/Benchmark.h"
+#include "graphics/light/LightCuller.h"
+#include "graphics/light/PointLight.h"
+#include "graphics/light/SpotLight.h"
+
+namespace
+{
+
+const uint32_t kLightCount = 10000;
+const uint32_t kIterations = 100;
+const uint32_t kTileX = 16;
+const uint32_t kTileY = 9;
+
+}  // namespace
+
+// ライトカリング
+std::string BenchmarkCases::LightCulling()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> posDist( -1000.0f, 1000.0f );
+    std::uniform_real_distribution<float> radiusDist( 5.0f, 50.0f );
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+    std::uniform_real_distribution<float> angleDist( 10.0f, 60.0f );
+
+    // ライトを作成(個別に確保して従来のポインタ参照を再現)
+    std::vector<std::unique_ptr<PointLight>> pointLights( kLightCount );
+    std::vector<std::unique_ptr<SpotLight>> spotLights( kLightCount );
+    for( uint32_t i = 0; i < kLightCount; ++i )
+    {
+        pointLights[i] = std::make_unique<PointLight>();
+        pointLights[i]->mPosition = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        pointLights[i]->mRadius = radiusDist( engine );
+
+        spotLights[i] = std::make_unique<SpotLight>();
+        spotLights[i]->mPosition = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        spotLights[i]->mDirection = Normalize( Vector3( dirDist( engine ), dirDist( engine ), dirDist( engine ) ) );
+        spotLights[i]->mRadius = radiusDist( engine );
+        spotLights[i]->mOuterAngle = angleDist( engine );
+    }
+
+    // SoAへ変換
+    LightCuller::PointLightSoA pointSoA;
+    pointSoA.Resize( kLightCount );
+    LightCuller::SpotLightSoA spotSoA;
+    spotSoA.Resize( kLightCount );
+    for( uint32_t i = 0; i < kLightCount; ++i )
+    {
+        pointSoA.Set( i, pointLights[i]->mPosition, pointLights[i]->mRadius );
+        spotSoA.Set( i, spotLights[i]->mPosition, spotLights[i]->mDirection, spotLights[i]->mRadius, spotLights[i]->mOuterAngle * MathUtil::kDegToRad );
+    }
+
+    // 視錐台
+    auto view = InverseAffine( CreateTranslate( Vector3( 0.0f, 30.0f, -200.0f ) ) );
+    auto projection = CreatePerspectiveFovY( MathUtil::kPi / 4.0f, 16.0f / 9.0f, 0.1f, 1000.0f );
+    auto vpMat = view * projection;
+    Frustum frustum = {};
+    frustum.Build( vpMat, Vector3( -1.0f, -1.0f, 0.0f ), Vector3( 1.0f, 1.0f, 1.0f ) );
+
+    LightCuller culler;
+    std::vector<uint32_t> visiblePoint;
+    std::vector<uint32_t> visibleSpot;
+    uint32_t aosPointCount = 0;
+    uint32_t aosSpotCount = 0;
+
+    // 従来方式(AoS・1個ずつ判定)
+    auto aosPointTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            aosPointCount = 0;
+            for( auto& light : pointLights )
+            {
+                Sphere sphere = { light->mPosition, light->mRadius };
+                aosPointCount += Intersect( sphere, frustum ) ? 1 : 0;
+            }
+        } );
+    auto aosSpotTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            aosSpotCount = 0;
+            for( auto& light : spotLights )
+            {
+                Sphere sphere = { light->mPosition, light->mRadius };
+                Cone cone = { light->mPosition, Normalize( light->mDirection ), light->mRadius, light->mOuterAngle * MathUtil::kDegToRad };
+                aosSpotCount += Intersect( sphere, frustum ) && Intersect( cone, frustum ) ? 1 : 0;
+            }
+        } );
+
+    // SoA・一括判定
+    auto soaPointTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            culler.Cull( pointSoA, frustum, visiblePoint );
+        } );
+    auto soaSpotTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            culler.Cull( spotSoA, frustum, visibleSpot );
+        } );
+
+    // タイルごとの部分視錐台
+    std::vector<Frustum> tiles( kTileX * kTileY );
+    for( uint32_t y = 0; y < kTileY; ++y )
+    {
+        for( uint32_t x = 0; x < kTileX; ++x )
+        {
+            auto minX = -1.0f + 2.0f * x / kTileX;
+            auto minY = -1.0f + 2.0f * y / kTileY;
+            auto maxX = -1.0f + 2.0f * ( x + 1 ) / kTileX;
+            auto maxY = -1.0f + 2.0f * ( y + 1 ) / kTileY;
+            tiles[y * kTileX + x].Build( vpMat, Vector3( minX, minY, 0.0f ), Vector3( maxX, maxY, 1.0f ) );
+        }
+    }
+    std::vector<uint32_t> tileVisible;
+    uint64_t tileLightTotal = 0;
+    auto tileTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            tileLightTotal = 0;
+            culler.Cull( pointSoA, frustum, visiblePoint );
+            culler.Cull( spotSoA, frustum, visibleSpot );
+            for( auto& tile : tiles )
+            {
+                culler.Cull( pointSoA, visiblePoint, tile, tileVisible );
+                tileLightTotal += tileVisible.size();
+                culler.Cull( spotSoA, visibleSpot, tile, tileVisible );
+                tileLightTotal += tileVisible.size();
+            }
+        } );
+
+    return std::format(
+        "Point AoS: {:.1f} us ({} visible)\n"
+        "Point SoA: {:.1f} us ({} visible)\n"
+        "Spot AoS : {:.1f} us ({} visible)\n"
+        "Spot SoA : {:.1f} us ({} visible)\n"
+        "Tiles {}x{}: {:.1f} us (avg {:.1f} lights/tile)",
+        aosPointTime, aosPointCount,
+        soaPointTime, visiblePoint.size(),
+        aosSpotTime, aosSpotCount,
+        soaSpotTime, visibleSpot.size(),
+        kTileX, kTileY, tileTime, static_cast<double>( tileLightTotal ) / tiles.size() );
+}
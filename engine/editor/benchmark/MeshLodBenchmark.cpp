@@ -0,0 +1,95 @@
+#include <format>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "BenchmarkScene.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/Camera.h"
+#include "graphics/model/MeshSimplifier.h"
+#include "graphics/model/MeshSorter.h"
+#include "graphics/model/ModelInstance.h"
+
+namespace
+{
+
+// モデルと描画時のスケール
+struct ModelDesc
+{
+    std::string mPath;
+    float mScale;
+};
+const ModelDesc kModels[] = {
+    { "assets/model/sphere/sphere.obj", 1.0f },
+    { "assets/model/bot/x_bot.fbx", 0.1f },
+    { "assets/model/bot/y_bot.fbx", 0.1f },
+};
+// カメラからの距離(遠ざかってから戻る)
+const float kDistances[] = { 15.0f, 25.0f, 50.0f, 100.0f, 200.0f, 400.0f, 200.0f, 100.0f, 50.0f, 25.0f, 15.0f };
+const uint32_t kIterations = 3;
+
+}  // namespace
+
+// メッシュの詳細度
+std::string BenchmarkCases::MeshLods()
+{
+    // レンダラーと同じ視野角のカメラ(原点から+Z方向を見る)
+    Camera camera;
+    BenchmarkScene::SetupCamera( camera, Vector3::kZero );
+    MeshSorter sorter;
+    if( !sorter.Init( &camera ) ) return "Failed to create the sorter";
+    sorter.SetFrustumCamera( &camera );
+
+    std::string result;
+    for( const auto& desc : kModels )
+    {
+        auto model = ResourceManager::GetInstance().GetModel( desc.mPath );
+        if( !model )
+        {
+            result += "Failed to load " + desc.mPath + "\n";
+            continue;
+        }
+
+        // 生成したLOD
+        result += desc.mPath + "\n";
+        for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+        {
+            auto mesh = model->GetMesh( i );
+            result += std::format( "  mesh {}:", i );
+            for( uint32_t lod = 0; lod < mesh->GetLodCount(); ++lod )
+            {
+                const auto& range = mesh->GetLod( lod );
+                result += std::format( " LOD{} {} tris (error {:.3f})", lod, range.mIndexCount / 3, range.mError );
+            }
+            result += "\n";
+        }
+
+        // 生成時間(頂点キャッシュ順への並べ替えを含む)
+        auto generateTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                std::vector<MeshLod> lods;
+                std::vector<uint32_t> lodIndices;
+                for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+                {
+                    auto mesh = model->GetMesh( i );
+                    MeshSimplifier::GenerateLods( mesh->GetVertices(), mesh->GetIndices(), lods, lodIndices );
+                }
+            } );
+        result += std::format( "  generate: {:.2f} ms\n  drawn tris (without LOD):", generateTime / 1000.0 );
+
+        // 遠ざかってから戻る
+        ModelInstance instance;
+        if( !instance.Create( model ) ) continue;
+
+        for( auto distance : kDistances )
+        {
+            instance.Draw( &sorter, CreateScale( Vector3::kOne * desc.mScale ) * CreateTranslate( Vector3( 0.0f, 0.0f, distance ) ) );
+            const auto& stats = instance.GetUpdateStats();
+            result += std::format( " {}m {} ({})", distance, stats.mDrawnTriangles, stats.mFullDetailTriangles );
+        }
+        result += "\n";
+    }
+    return result;
+}
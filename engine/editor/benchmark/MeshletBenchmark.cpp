@@ -0,0 +1,147 @@
+#include <format>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "BenchmarkScene.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/Camera.h"
+#include "graphics/model/MeshletBuilder.h"
+#include "graphics/model/MeshletCuller.h"
+#include "math/MathUtil.h"
+
+namespace
+{
+
+// モデルと描画時のスケール・カメラからの距離
+struct ModelDesc
+{
+    std::string mPath;
+    float mScale;
+    float mDistance;
+};
+const ModelDesc kModels[] = {
+    { "assets/model/sphere/sphere.obj", 1.0f, 5.0f },
+    { "assets/model/bot/x_bot.fbx", 0.1f, 40.0f },
+    { "assets/model/bot/y_bot.fbx", 0.1f, 40.0f },
+};
+
+// 視点(モデルのY軸回転と、画面の横方向へのずらし量(距離に対する比))
+struct ViewDesc
+{
+    const char* mName;
+    float mRotateY;
+    float mShiftX;
+    bool mUseOccluder;
+};
+const ViewDesc kViews[] = {
+    { "front", 0.0f, 0.0f, false },
+    { "side", MathUtil::kPi * 0.5f, 0.0f, false },
+    { "back", MathUtil::kPi, 0.0f, false },
+    { "half off-screen", 0.0f, 0.4f, false },
+    { "front + occluder", 0.0f, 0.0f, true },
+};
+const uint32_t kBuildIterations = 5;
+const uint32_t kCullIterations = 100;
+
+}  // namespace
+
+// メッシュレット
+std::string BenchmarkCases::Meshlets()
+{
+    // レンダラーと同じ視野角のカメラ(原点から+Z方向を見る)
+    Camera camera;
+    BenchmarkScene::SetupCamera( camera, Vector3::kZero, 0.0f, 1.0f );
+
+    std::string result = std::format( "Meshlets: at most {} vertices / {} triangles\n", MeshletBuilder::kMaxVertices, MeshletBuilder::kMaxTriangles );
+    MeshletCuller culler;
+    std::vector<MeshletCuller::IndexRange> ranges;
+    for( const auto& desc : kModels )
+    {
+        auto model = ResourceManager::GetInstance().GetModel( desc.mPath );
+        if( !model )
+        {
+            result += "Failed to load " + desc.mPath + "\n";
+            continue;
+        }
+
+        // 構築した結果
+        result += desc.mPath + "\n";
+        uint32_t meshletCount = 0;
+        uint32_t vertexCount = 0;
+        uint32_t triangleCount = 0;
+        for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+        {
+            for( const auto& meshlet : model->GetMesh( i )->GetMeshlets() )
+            {
+                ++meshletCount;
+                vertexCount += meshlet.mVertexCount;
+                triangleCount += meshlet.mIndexCount / 3;
+            }
+        }
+        if( meshletCount == 0 ) continue;
+
+        // 構築時間(読み込み済みのインデックスから作り直す)
+        auto buildTime = Benchmark::Measure(
+            kBuildIterations,
+            [&]()
+            {
+                std::vector<Meshlet> meshlets;
+                for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+                {
+                    auto mesh = model->GetMesh( i );
+                    auto indices = mesh->GetIndices();
+                    MeshletBuilder::Build( mesh->GetVertices(), indices, meshlets );
+                }
+            } );
+        result += std::format(
+            "  {} meshlets, {:.1f} vertices / {:.1f} tris per meshlet, build {:.2f} ms\n",
+            meshletCount, static_cast<float>( vertexCount ) / meshletCount, static_cast<float>( triangleCount ) / meshletCount, buildTime / 1000.0 );
+
+        // 視点ごとのカリング
+        for( const auto& view : kViews )
+        {
+            auto worldMat =
+                CreateScale( Vector3::kOne * desc.mScale ) * CreateRotateY( view.mRotateY ) *
+                CreateTranslate( Vector3( desc.mDistance * view.mShiftX, 0.0f, desc.mDistance ) );
+            MeshletCuller::Params params = {};
+            params.Build( worldMat, camera.GetView(), camera.GetProjection() );
+            params.mUseCone = true;
+            if( view.mUseOccluder )
+            {
+                // カメラと距離の半分の間にある、画面の左半分を覆う板
+                params.mIsOccluded = [&]( const Sphere& bounds )
+                {
+                    auto center = bounds.mCenter * worldMat;
+                    auto radius = bounds.mRadius * desc.mScale;
+                    return center.x + radius < 0.0f && center.z - radius > desc.mDistance * 0.5f;
+                };
+            }
+
+            MeshletCuller::Stats total = {};
+            auto cullTime = Benchmark::Measure(
+                kCullIterations,
+                [&]()
+                {
+                    total = {};
+                    for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+                    {
+                        culler.Cull( model->GetMesh( i )->GetMeshlets(), params, ranges );
+                        const auto& stats = culler.GetStats();
+                        total.mVisibleMeshlets += stats.mVisibleMeshlets;
+                        total.mFrustumCulledMeshlets += stats.mFrustumCulledMeshlets;
+                        total.mConeCulledMeshlets += stats.mConeCulledMeshlets;
+                        total.mOcclusionCulledMeshlets += stats.mOcclusionCulledMeshlets;
+                        total.mVisibleTriangles += stats.mVisibleTriangles;
+                        total.mCulledTriangles += stats.mCulledTriangles;
+                    }
+                } );
+            auto allTriangles = total.mVisibleTriangles + total.mCulledTriangles;
+            result += std::format(
+                "  {}: culled {} / {} tris ({:.1f}%), meshlets visible {} frustum {} cone {} occlusion {}, {:.2f} us\n",
+                view.mName, total.mCulledTriangles, allTriangles, allTriangles > 0 ? 100.0f * total.mCulledTriangles / allTriangles : 0.0f,
+                total.mVisibleMeshlets, total.mFrustumCulledMeshlets, total.mConeCulledMeshlets, total.mOcclusionCulledMeshlets, cullTime );
+        }
+    }
+    return result;
+}
@@ -0,0 +1,93 @@
+#include <format>
+#include <memory>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "core/ConstantBufferPool.h"
+#include "core/DirectXBase.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/model/ModelInstance.h"
+
+namespace
+{
+
+const std::string kModelPath = "assets/model/box/box.obj";
+const uint32_t kInstanceCount = 30 * 30;
+const uint32_t kIterations = 5;
+// 変換行列(ワールド・WVP・法線用)のサイズ
+const uint32_t kTransMatSize = sizeof( Matrix4 ) * 3;
+
+}  // namespace
+
+// モデルインスタンスのメモリ
+std::string BenchmarkCases::ModelInstances()
+{
+    auto model = ResourceManager::GetInstance().GetModel( kModelPath );
+    if( !model ) return "Failed to load " + kModelPath;
+
+    auto meshCount = model->GetMeshCount();
+    auto& pool = ConstantBufferPool::GetInstance();
+    auto usedSlots = pool.GetUsedSlotCount();
+    auto reservedSize = pool.GetReservedSize();
+
+    // 従来: メッシュごとに定数バッファ(コミットリソース)を作る
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = ( kTransMatSize + 0xff ) & ~0xff;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    auto allocInfo = DirectXBase::GetInstance().GetDevice()->GetResourceAllocationInfo( 0, 1, &desc );
+    auto legacyTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            std::vector<std::unique_ptr<ConstantBuffer>> buffers( kInstanceCount * meshCount );
+            for( auto& buffer : buffers )
+            {
+                buffer = std::make_unique<ConstantBuffer>();
+                buffer->Create( kTransMatSize );
+            }
+        } );
+
+    // 現在: プールのスロットを借りる
+    std::vector<std::unique_ptr<ModelInstance>> instances( kInstanceCount );
+    for( auto& instance : instances )
+    {
+        instance = std::make_unique<ModelInstance>();
+    }
+    auto pooledTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            for( auto& instance : instances )
+            {
+                instance->Create( model );
+            }
+        } );
+    auto instanceSize = instances.front()->GetMemorySize();
+    auto slotSize = static_cast<size_t>( meshCount ) * ConstantBufferPool::kSlotSize;
+    auto addedPages = pool.GetReservedSize() - reservedSize;
+    auto addedSlots = pool.GetUsedSlotCount() - usedSlots;
+
+    // 従来のインスタンスはスロットの代わりにメッシュごとの定数バッファを持っていた
+    auto legacySize = instanceSize - slotSize + meshCount * ( allocInfo.SizeInBytes + sizeof( ConstantBuffer ) + sizeof( std::unique_ptr<ConstantBuffer> ) );
+    auto result = std::format(
+        "Instances: {}, Meshes: {} (per instance)\n"
+        "Per-mesh CB : {} resources, {} B each ({:.1f} MB), Create: {:.2f} ms\n"
+        "Pooled slots: {} slots, {} KB of pages, Create: {:.2f} ms\n"
+        "Per instance: {} B -> {} B ({:.1f}x)\n"
+        "Node hierarchy: shared ({} nodes), pose only per instance",
+        kInstanceCount, meshCount,
+        kInstanceCount * meshCount, allocInfo.SizeInBytes, kInstanceCount * meshCount * allocInfo.SizeInBytes / ( 1024.0 * 1024.0 ), legacyTime / 1000.0,
+        addedSlots, addedPages / 1024, pooledTime / 1000.0,
+        legacySize, instanceSize, static_cast<double>( legacySize ) / instanceSize,
+        model->GetNodes().GetCount() );
+
+    // スロットはインスタンスの破棄でプールへ返る
+    instances.clear();
+    return result;
+}
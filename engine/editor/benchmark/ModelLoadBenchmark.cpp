@@ -0,0 +1,98 @@
+#include <format>
+
+#include "BenchmarkCases.h"
+#include "editor/Benchmark.h"
+#include "graphics/model/CookedModel.h"
+#include "graphics/model/ModelData.h"
+
+namespace
+{
+
+const std::string kModelPaths[] = {
+    "assets/model/box/box.obj",
+    "assets/model/sphere/sphere.obj",
+    "assets/model/floor/floor.glb",
+    "assets/model/bot/x_bot.fbx",
+    "assets/model/bot/y_bot.fbx",
+};
+const uint32_t kIterations = 10;
+
+}  // namespace
+
+// モデルの読み込み
+std::string BenchmarkCases::ModelLoad()
+{
+    std::string result = "Cold: first load in this run (the OS file cache may already hold the file)\n";
+    for( const auto& path : kModelPaths )
+    {
+        auto cookedPath = CookedModel::GetCookedPath( path ) + ".bench";
+
+        // assimp
+        bool isBuilt = false;
+        auto assimpCold = Benchmark::Measure(
+            1,
+            [&]()
+            {
+                ModelData model;
+                isBuilt = model.Build( path );
+                if( isBuilt )
+                {
+                    model.Cook( cookedPath );
+                }
+            } );
+        if( !isBuilt )
+        {
+            result += "Failed to load " + path + "\n";
+            continue;
+        }
+        auto assimpWarm = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                ModelData model;
+                model.Build( path );
+            } );
+
+        // クックしたファイル
+        bool isLoaded = false;
+        auto cookedCold = Benchmark::Measure(
+            1,
+            [&]()
+            {
+                ModelData model;
+                isLoaded = model.Load( cookedPath );
+            } );
+        if( !isLoaded )
+        {
+            result += "Failed to load " + cookedPath + "\n";
+            continue;
+        }
+        auto cookedWarm = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                ModelData model;
+                model.Load( cookedPath );
+            } );
+
+        // マップと検証だけ
+        size_t fileSize = 0;
+        auto mapTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                CookedModel cooked;
+                cooked.Open( cookedPath );
+                fileSize = cooked.GetFileSize();
+            } );
+
+        result += std::format(
+            "{} ({} KB cooked)\n"
+            "  assimp: {:.2f} ms cold, {:.2f} ms warm\n"
+            "  cooked: {:.2f} ms cold, {:.2f} ms warm ({:.1f}x), map: {:.1f} us\n",
+            path, fileSize / 1024,
+            assimpCold / 1000.0, assimpWarm / 1000.0,
+            cookedCold / 1000.0, cookedWarm / 1000.0, assimpWarm / cookedWarm, mapTime );
+    }
+    return result;
+}
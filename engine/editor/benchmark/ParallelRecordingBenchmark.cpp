@@ -0,0 +1,94 @@
+#include <format>
+#include <memory>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "BenchmarkScene.h"
+#include "core/CommandList.h"
+#include "core/DirectXBase.h"
+#include "core/ParallelRecorder.h"
+#include "editor/Benchmark.h"
+#include "graphics/Camera.h"
+#include "graphics/model/MeshSorter.h"
+#include "graphics/model/ModelBase.h"
+#include "graphics/model/ModelInstance.h"
+#include "math/MathUtil.h"
+#include "utils/JobSystem.h"
+
+namespace
+{
+
+// 箱と球を並べて真上から見下ろす(全て視錐台に入る)
+const uint32_t kGridSize = 100;
+const float kGridInterval = 10.0f;
+const float kBoxScale = 2.0f;
+const uint32_t kSphereInterval = 7;
+const float kCameraHeight = 1400.0f;
+// 比べるコマンドリストの数
+const uint32_t kListCounts[] = { 1, 2, 4, 8 };
+const uint32_t kMaxListCount = 8;
+const uint32_t kIterations = 20;
+
+}  // namespace
+
+// スレッドごとのコマンドリストへの並列記録
+std::string BenchmarkCases::ParallelRecording()
+{
+    Camera camera;
+    BenchmarkScene::SetupCamera( camera, Vector3( 0.0f, kCameraHeight, 0.0f ), MathUtil::kPi / 2.0f );
+    MeshSorter sorter;
+    if( !sorter.Init( &camera ) ) return "Failed to create the sorter\n";
+    sorter.SetFrustumCamera( &camera );
+    // 1アイテム1ドローコールにする
+    sorter.SetUseInstancing( false );
+    sorter.SetUseCoherentSort( false );
+
+    std::vector<std::unique_ptr<ModelInstance>> instances;
+    if( !BenchmarkScene::CreateBoxGrid( kGridSize, kGridInterval, kBoxScale, kSphereInterval, instances ) ) return "Failed to load the models\n";
+    BenchmarkScene::AddAndSort( sorter, instances );
+    sorter.PrepareRecording();
+
+    // 記録するだけで実行はしない(描画に使うワーカーのコマンドリストはフレームの途中で触れないので、ベンチマーク用に作る)
+    auto& dxBase = DirectXBase::GetInstance();
+    auto& modelBase = ModelBase::GetInstance();
+    std::vector<std::unique_ptr<CommandList>> cmdLists( kMaxListCount );
+    for( auto& cmdList : cmdLists )
+    {
+        cmdList = std::make_unique<CommandList>();
+        if( !cmdList->Create( CommandList::Type::Direct ) ) return "Failed to create the command lists\n";
+    }
+
+    auto drawCount = sorter.GetDrawCallCount();
+    std::string result = std::format( "{} draws, {} threads\n", sorter.GetStats().mDraws, JobSystem::GetInstance().GetThreadCount() );
+    auto baseTime = 0.0;
+    for( auto listCount : kListCounts )
+    {
+        ParallelRecorder recorder;
+        recorder.SetMinChunkSize( 1 );
+        auto time = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                recorder.Record(
+                    drawCount,
+                    listCount,
+                    [&]( uint32_t contextIdx, uint32_t first, uint32_t count )
+                    {
+                        auto cmdList = cmdLists[contextIdx].get();
+                        cmdList->Reset();
+                        cmdList->SetDescriptorHeap( dxBase.GetSRVHeap() );
+                        modelBase.Bind( cmdList );
+                        sorter.RecordDraws( cmdList, first, count );
+                        cmdList->Close();
+                    },
+                    []( std::span<const uint32_t> ) {} );
+            } );
+        if( listCount == 1 )
+        {
+            baseTime = time;
+        }
+        result += std::format( "{} lists: record {:.1f} us ({:.2f}x)\n", listCount, time, time > 0.0 ? baseTime / time : 0.0 );
+    }
+    sorter.Clear();
+    return result;
+}
@@ -0,0 +1,138 @@
+#include <format>
+#include <random>
+
+#include "BenchmarkCases.h"
+#include "collision/CollisionScene.h"
+#include "collision/QueryBatch.h"
+#include "editor/Benchmark.h"
+#include "utils/JobSystem.h"
+
+namespace
+{
+
+const uint32_t kColliderCount = 10000;
+const uint32_t kQueryCount = 10000;
+const uint32_t kIterations = 10;
+const float kWorldSize = 1000.0f;
+
+}  // namespace
+
+// シーンクエリ
+std::string BenchmarkCases::SceneQuery()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> posDist( -kWorldSize, kWorldSize );
+    std::uniform_real_distribution<float> sizeDist( 1.0f, 10.0f );
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+
+    // コライダー(箱と球を半々)
+    CollisionScene scene;
+    for( uint32_t i = 0; i < kColliderCount; ++i )
+    {
+        auto center = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        auto size = sizeDist( engine );
+        if( i % 2 == 0 )
+        {
+            auto half = Vector3( size, size, size );
+            scene.AddAABB( AABB3D{ center - half, center + half }, i );
+        }
+        else
+        {
+            scene.AddSphere( Sphere{ center, size }, i );
+        }
+    }
+    scene.Build();
+
+    // クエリ(半直線・掃引・重なりを混在させる)
+    struct Request
+    {
+        Vector3 mOrigin;
+        Vector3 mDirection;
+        float mRadius;
+    };
+    std::vector<Request> requests( kQueryCount );
+    for( auto& request : requests )
+    {
+        request.mOrigin = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        request.mDirection = Normalize( Vector3( dirDist( engine ), dirDist( engine ), dirDist( engine ) ) );
+        request.mRadius = sizeDist( engine ) * 2.0f;
+    }
+    const auto maxDist = kWorldSize * 0.5f;
+
+    // 即時実行
+    uint32_t immediateHits = 0;
+    std::vector<uint32_t> ids;
+    auto immediateTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            immediateHits = 0;
+            RaycastHit hit = {};
+            for( uint32_t i = 0; i < kQueryCount; ++i )
+            {
+                const auto& request = requests[i];
+                switch( i % 3 )
+                {
+                    case 0:
+                        immediateHits += scene.Raycast( request.mOrigin, request.mDirection, maxDist, hit ) ? 1 : 0;
+                        break;
+                    case 1:
+                        immediateHits += scene.SweepSphere( Sphere{ request.mOrigin, request.mRadius }, request.mDirection, maxDist, hit ) ? 1 : 0;
+                        break;
+                    case 2:
+                        ids.clear();
+                        immediateHits += scene.OverlapSphere( Sphere{ request.mOrigin, request.mRadius * 5.0f }, ids );
+                        break;
+                }
+            }
+        } );
+
+    // 一括実行
+    QueryBatch batch;
+    uint32_t batchHits = 0;
+    auto measureBatch = [&]( bool isSortEnabled )
+    {
+        batch.SetSortEnabled( isSortEnabled );
+        return Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                batch.Clear();
+                for( uint32_t i = 0; i < kQueryCount; ++i )
+                {
+                    const auto& request = requests[i];
+                    switch( i % 3 )
+                    {
+                        case 0:
+                            batch.AddRaycast( request.mOrigin, request.mDirection, maxDist );
+                            break;
+                        case 1:
+                            batch.AddSweepSphere( Sphere{ request.mOrigin, request.mRadius }, request.mDirection, maxDist );
+                            break;
+                        case 2:
+                            batch.AddOverlapSphere( Sphere{ request.mOrigin, request.mRadius * 5.0f } );
+                            break;
+                    }
+                }
+                batch.Execute( scene );
+
+                batchHits = 0;
+                for( const auto& result : batch.GetResults() )
+                {
+                    batchHits += ( result.mHit.mIsHit ? 1 : 0 ) + result.mOverlapCount;
+                }
+            } );
+    };
+    auto batchTime = measureBatch( false );
+    auto sortedBatchTime = measureBatch( true );
+
+    return std::format(
+        "Colliders: {}, Queries: {}, Threads: {}\n"
+        "Immediate     : {:.1f} us ({} hits)\n"
+        "Batch         : {:.1f} us ({} hits)\n"
+        "Batch (sorted): {:.1f} us",
+        kColliderCount, kQueryCount, JobSystem::GetInstance().GetThreadCount(),
+        immediateTime, immediateHits,
+        batchTime, batchHits,
+        sortedBatchTime );
+}
@@ -0,0 +1,163 @@
+#include <cmath>
+#include <format>
+#include <random>
+
+#include "BenchmarkAnimation.h"
+#include "BenchmarkCases.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/animation/AnimationSampler.h"
+#include "graphics/animation/Skinning.h"
+#include "graphics/model/ModelData.h"
+
+namespace
+{
+
+const std::string kModelPath = "assets/model/bot/x_bot.fbx";
+const uint32_t kBotCount = 100;
+const uint32_t kIterations = 20;
+const float kDeltaTime = 1.0f / 60.0f;
+
+// ボット1体分の状態
+struct Bot
+{
+    NodePose mPose;
+    AnimationSampler mSampler;
+    float mTime;
+    // スキニング後の頂点(スキンを持つメッシュ順)
+    std::vector<std::vector<MeshVertex>> mVertices;
+    std::vector<AABB3D> mAABBs;
+};
+
+}  // namespace
+
+// スケルタルアニメーション
+std::string BenchmarkCases::SkinnedBots()
+{
+    auto model = ResourceManager::GetInstance().GetModel( kModelPath );
+    if( !model ) return "Failed to load " + kModelPath;
+
+    // クリップ(無ければ作る)
+    AnimationClip syntheticClip;
+    auto clip = BenchmarkAnimation::GetClip( *model, syntheticClip );
+
+    // スキンを持つメッシュ
+    std::vector<uint32_t> skinnedMeshes;
+    uint32_t vertexCount = 0;
+    uint32_t boneCount = 0;
+    for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+    {
+        auto skin = model->GetSkin( i );
+        if( !skin ) continue;
+
+        skinnedMeshes.emplace_back( i );
+        vertexCount += static_cast<uint32_t>( skin->mInfluences.size() );
+        boneCount += static_cast<uint32_t>( skin->mBoneNodes.size() );
+    }
+    if( skinnedMeshes.empty() ) return "No skinned mesh in " + kModelPath;
+
+    // 再生位置をずらしたボット
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> timeDist( 0.0f, clip->GetDuration() );
+    std::vector<Bot> bots( kBotCount );
+    for( auto& bot : bots )
+    {
+        model->GetNodes().CreatePose( bot.mPose );
+        bot.mSampler.SetClip( clip );
+        bot.mTime = timeDist( engine );
+        bot.mVertices.resize( skinnedMeshes.size() );
+        bot.mAABBs.resize( skinnedMeshes.size() );
+        for( size_t j = 0; j < skinnedMeshes.size(); ++j )
+        {
+            bot.mVertices[j].resize( model->GetSkin( skinnedMeshes[j] )->mInfluences.size() );
+        }
+    }
+
+    // サンプリング(前回のキー位置から進める)
+    auto sampleTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            for( auto& bot : bots )
+            {
+                bot.mTime = std::fmod( bot.mTime + kDeltaTime, clip->GetDuration() );
+                bot.mSampler.Sample( bot.mTime, bot.mPose );
+            }
+        } );
+    // サンプリング(毎回キーを二分探索)
+    auto seekTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            for( auto& bot : bots )
+            {
+                bot.mTime = std::fmod( bot.mTime + kDeltaTime, clip->GetDuration() );
+                bot.mSampler.SetClip( clip );
+                bot.mSampler.Sample( bot.mTime, bot.mPose );
+            }
+        } );
+
+    // ローカルからモデル空間へ
+    auto matrixTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            for( auto& bot : bots )
+            {
+                bot.mPose.MarkAllDirty();
+                model->GetNodes().UpdateModelMatrices( bot.mPose );
+            }
+        } );
+
+    // スキニング
+    std::vector<Matrix4> skinMats;
+    auto skinAll = [&]( bool isSimd )
+    {
+        for( auto& bot : bots )
+        {
+            for( size_t j = 0; j < skinnedMeshes.size(); ++j )
+            {
+                auto meshIdx = skinnedMeshes[j];
+                auto skin = model->GetSkin( meshIdx );
+                const auto& src = model->GetMesh( meshIdx )->GetVertices();
+                auto count = static_cast<uint32_t>( src.size() );
+                Skinning::ComputeSkinMatrices( *skin, bot.mPose.mModelMats, skinMats );
+                if( isSimd )
+                {
+                    Skinning::SkinVertices( src.data(), skin->mInfluences.data(), count, skinMats.data(), bot.mVertices[j].data(), bot.mAABBs[j] );
+                }
+                else
+                {
+                    Skinning::SkinVerticesScalar( src.data(), skin->mInfluences.data(), count, skinMats.data(), bot.mVertices[j].data(), bot.mAABBs[j] );
+                }
+            }
+        }
+    };
+    auto scalarTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            skinAll( false );
+        } );
+    auto simdTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            skinAll( true );
+        } );
+
+    auto frameTime = sampleTime + matrixTime + simdTime;
+    return std::format(
+        "Bots: {}, Clip: {} ({:.2f} s, {} channels, {} KB)\n"
+        "Skinned meshes: {}, Vertices: {}, Bones: {} (per bot)\n"
+        "Sample : {:.1f} us (seek every frame: {:.1f} us)\n"
+        "Matrices: {:.1f} us\n"
+        "Skinning: {:.1f} us -> {:.1f} us SIMD ({:.2f}x)\n"
+        "Frame : {:.2f} ms ({:.1f} us per bot)",
+        kBotCount, clip->GetName(), clip->GetDuration(), clip->GetChannels().size(), clip->GetMemorySize() / 1024,
+        skinnedMeshes.size(), vertexCount, boneCount,
+        sampleTime, seekTime,
+        matrixTime,
+        scalarTime, simdTime, scalarTime / simdTime,
+        frameTime / 1000.0, frameTime / kBotCount );
+}
@@ -0,0 +1,146 @@
+#include <format>
+#include <random>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "editor/Benchmark.h"
+#include "graphics/model/DrawKey.h"
+#include "graphics/model/MeshSorter.h"
+
+namespace
+{
+
+const uint32_t kItemCounts[] = { 1000, 10000, 100000 };
+const uint32_t kMaterialCount = 64;
+const uint32_t kMeshCount = 32;
+const uint32_t kPSOCount = 5;
+const float kMaxDistance = 1000.0f;
+const uint32_t kIterations = 20;
+
+/// <summary>
+/// 分ける前の描画アイテム(可視フラグも含めて1つの構造体に持ち、ソート後にまとめて並べ替える)
+/// </summary>
+struct AoSItem
+{
+    MeshSorter::SortItem mItem;
+    bool mIsVisible;
+};
+
+// 描画の走査で読むものを足し合わせる(PSOの切り替えと、アイテムの定数バッファ・メッシュ)
+template<typename F>
+uint64_t Traverse( uint32_t count, F&& getItem )
+{
+    uint64_t checksum = 0;
+    auto currPSOKey = UINT64_MAX;
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        bool isVisible = false;
+        const auto& item = getItem( i, isVisible );
+        if( !isVisible ) continue;
+
+        if( item.mPSOKey != currPSOKey )
+        {
+            currPSOKey = item.mPSOKey;
+            ++checksum;
+        }
+        checksum += item.mTransMatAddress + reinterpret_cast<uintptr_t>( item.mMesh ) + reinterpret_cast<uintptr_t>( item.mMaterial ) + item.mLod;
+    }
+    return checksum;
+}
+
+}  // namespace
+
+// 描画アイテムの配置
+std::string BenchmarkCases::SortItemLayout()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> distanceDist( 0.0f, kMaxDistance );
+    std::uniform_int_distribution<uint32_t> materialDist( 0, kMaterialCount - 1 );
+    std::uniform_int_distribution<uint32_t> meshDist( 0, kMeshCount - 1 );
+    std::uniform_int_distribution<uint32_t> psoDist( 0, kPSOCount - 1 );
+
+    // マテリアルとメッシュの代わりのアドレス(参照はしない)
+    std::vector<uint64_t> materials( kMaterialCount );
+    std::vector<uint64_t> meshes( kMeshCount );
+
+    std::string result = std::format( "SortItem {} bytes, AoS item {} bytes, hot {} + 1 bytes\n", sizeof( MeshSorter::SortItem ), sizeof( AoSItem ), sizeof( DrawKey::Entry ) );
+    for( auto itemCount : kItemCounts )
+    {
+        // 追加順のアイテムとキー
+        std::vector<MeshSorter::SortItem> items( itemCount );
+        std::vector<DrawKey::Entry> unsorted( itemCount );
+        for( uint32_t i = 0; i < itemCount; ++i )
+        {
+            auto& item = items[i];
+            item.mPSOKey = psoDist( engine );
+            item.mDistance = distanceDist( engine );
+            item.mTransMatAddress = 256ull * i;
+            item.mMesh = reinterpret_cast<Mesh*>( &meshes[meshDist( engine )] );
+            item.mMaterial = reinterpret_cast<Material*>( &materials[materialDist( engine )] );
+            unsorted[i] = DrawKey::Entry{ DrawKey::Make( RenderQueue::Opaque, item.mDistance, static_cast<uint32_t>( item.mPSOKey ), item.mMaterial, item.mMesh ), i };
+        }
+        std::vector<uint8_t> visibility( itemCount, 1 );
+
+        // AoS: キーをソートしてから、アイテムをその順に並べ替える
+        std::vector<DrawKey::Entry> entries;
+        std::vector<DrawKey::Entry> temp;
+        std::vector<AoSItem> aosItems( itemCount );
+        std::vector<AoSItem> aosSorted( itemCount );
+        for( uint32_t i = 0; i < itemCount; ++i )
+        {
+            aosItems[i] = AoSItem{ items[i], true };
+        }
+        auto aosSortTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                entries = unsorted;
+                DrawKey::RadixSort( entries, temp );
+                for( uint32_t i = 0; i < itemCount; ++i )
+                {
+                    aosSorted[i] = aosItems[entries[i].mIndex];
+                }
+            } );
+        auto aosTraverseTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                auto checksum = Traverse(
+                    itemCount,
+                    [&]( uint32_t i, bool& isVisible ) -> const MeshSorter::SortItem&
+                    {
+                        isVisible = aosSorted[i].mIsVisible;
+                        return aosSorted[i].mItem;
+                    } );
+                Benchmark::KeepResult( checksum );
+            } );
+
+        // SoA: キーと番号の組だけソートし、描画の走査で番号からアイテムを引く
+        auto soaSortTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                entries = unsorted;
+                DrawKey::RadixSort( entries, temp );
+            } );
+        auto soaTraverseTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                auto checksum = Traverse(
+                    itemCount,
+                    [&]( uint32_t i, bool& isVisible ) -> const MeshSorter::SortItem&
+                    {
+                        auto idx = entries[i].mIndex;
+                        isVisible = visibility[idx] != 0;
+                        return items[idx];
+                    } );
+                Benchmark::KeepResult( checksum );
+            } );
+
+        result += std::format(
+            "{} items: AoS sort {:.1f} us + render {:.1f} us, SoA sort {:.1f} us + render {:.1f} us\n",
+            itemCount, aosSortTime, aosTraverseTime, soaSortTime, soaTraverseTime );
+    }
+    return result;
+}
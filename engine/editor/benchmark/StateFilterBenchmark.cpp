@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <format>
+#include <random>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "core/CommandListState.h"
+#include "editor/Benchmark.h"
+
+namespace
+{
+
+const uint32_t kItemCount = 10000;
+const uint32_t kPSOCount = 6;
+const uint32_t kMaterialCount = 64;
+const uint32_t kMeshCount = 32;
+const uint32_t kIterations = 20;
+
+// ソーターと同じルートパラメータ
+const uint32_t kTransMatParam = 0;
+const uint32_t kMaterialParam = 1;
+const uint32_t kCameraParam = 2;
+const uint32_t kTextureParam = 3;
+
+const char* kCategoryNames[] = {
+    "root signature",
+    "pipeline state",
+    "topology",
+    "vertex buffer",
+    "index buffer",
+    "root argument",
+    "descriptor heap",
+};
+static_assert( std::size( kCategoryNames ) == static_cast<size_t>( CommandListState::Category::Count ) );
+
+/// <summary>
+/// ソート済みの描画アイテム(アドレスの代わりの番号だけ)
+/// </summary>
+struct Item
+{
+    uint32_t mPSO;
+    uint32_t mMaterial;
+    uint32_t mMesh;
+};
+
+// ソーターの描画と同じ順にステートをセットする(デバイスなし、捨てなかった数を返す)
+uint32_t Replay( CommandListState& state, const std::vector<Item>& items )
+{
+    // ポインタとGPU仮想アドレスの代わり(0は使わない)
+    auto address = []( uint64_t base, uint32_t idx ) { return ( base << 32 ) + ( idx + 1 ) * 256ull; };
+    auto pointer = []( uint64_t base, uint32_t idx ) { return reinterpret_cast<const void*>( ( base << 32 ) + ( idx + 1 ) * 16ull ); };
+
+    uint32_t issued = 0;
+    state.Reset();
+    issued += state.SetDescriptorHeap( pointer( 1, 0 ) ) ? 1 : 0;
+    issued += state.SetGraphicsRootSignature( pointer( 2, 0 ) ) ? 1 : 0;
+    issued += state.SetPrimitiveTopology( 4 ) ? 1 : 0;
+    for( uint32_t i = 0; i < static_cast<uint32_t>( items.size() ); ++i )
+    {
+        const auto& item = items[i];
+        issued += state.SetPipelineState( pointer( 3, item.mPSO ) ) ? 1 : 0;
+        issued += state.SetGraphicsRootArgument( kTransMatParam, address( 4, i ) ) ? 1 : 0;
+        issued += state.SetGraphicsRootArgument( kMaterialParam, address( 5, item.mMaterial ) ) ? 1 : 0;
+        issued += state.SetGraphicsRootArgument( kTextureParam, address( 6, item.mMaterial ) ) ? 1 : 0;
+        issued += state.SetGraphicsRootArgument( kCameraParam, address( 7, 0 ) ) ? 1 : 0;
+        issued += state.SetVertexBuffer( address( 8, item.mMesh ), 1024, 32 ) ? 1 : 0;
+        issued += state.SetIndexBuffer( address( 9, item.mMesh ), 1024, 42 ) ? 1 : 0;
+    }
+    return issued;
+}
+
+}  // namespace
+
+// コマンドリストのステートの重複の除去
+std::string BenchmarkCases::StateFiltering()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_int_distribution<uint32_t> psoDist( 0, kPSOCount - 1 );
+    std::uniform_int_distribution<uint32_t> materialDist( 0, kMaterialCount - 1 );
+    std::uniform_int_distribution<uint32_t> meshDist( 0, kMeshCount - 1 );
+
+    // PSO → マテリアル → メッシュの順に並んだアイテム
+    std::vector<Item> items( kItemCount );
+    for( auto& item : items )
+    {
+        item = Item{ psoDist( engine ), materialDist( engine ), meshDist( engine ) };
+    }
+    std::sort(
+        items.begin(),
+        items.end(),
+        []( const Item& a, const Item& b )
+        {
+            if( a.mPSO != b.mPSO ) return a.mPSO < b.mPSO;
+
+            if( a.mMaterial != b.mMaterial ) return a.mMaterial < b.mMaterial;
+
+            return a.mMesh < b.mMesh;
+        } );
+
+    std::string result = std::format( "{} sorted items, {} PSOs, {} materials, {} meshes\n", kItemCount, kPSOCount, kMaterialCount, kMeshCount );
+    CommandListState state;
+    for( auto isEnabled : { false, true } )
+    {
+        state.SetEnabled( isEnabled );
+        uint32_t issued = 0;
+        auto time = Benchmark::Measure( kIterations, [&]() { issued = Replay( state, items ); } );
+        const auto& counters = state.GetCounters();
+        result += std::format( "{}: {} calls issued, replay {:.1f} us\n", isEnabled ? "filtering" : "no filtering", issued, time );
+        if( !isEnabled ) continue;
+
+        for( size_t i = 0; i < std::size( kCategoryNames ); ++i )
+        {
+            result += std::format( "  {}: {} issued, {} filtered\n", kCategoryNames[i], counters.mIssued[i], counters.mFiltered[i] );
+        }
+    }
+    return result;
+}
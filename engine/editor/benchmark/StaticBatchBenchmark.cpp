@@ -0,0 +1,121 @@
+#include <format>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "BenchmarkScene.h"
+#include "collision/Collision.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/Camera.h"
+#include "graphics/model/StaticBatchBuilder.h"
+#include "math/MathUtil.h"
+
+namespace
+{
+
+// レンダラーと同じ箱の並び
+const uint32_t kGridSize = 30;
+const float kGridInterval = 20.0f;
+const float kBoxScale = 5.0f;
+
+// セルの1辺の長さ
+const float kCellSizes[] = { 50.0f, 100.0f, 200.0f };
+
+// 視点
+struct ViewDesc
+{
+    const char* mName;
+    Vector3 mPosition;
+    float mPitch;
+};
+const ViewDesc kViews[] = {
+    { "default", Vector3( 0.0f, 30.0f, -200.0f ), 0.0f },
+    { "inside", Vector3( 0.0f, 10.0f, 0.0f ), 0.0f },
+    { "overview", Vector3( 0.0f, 900.0f, 0.0f ), MathUtil::kPi * 0.5f },
+};
+const uint32_t kBuildIterations = 10;
+const uint32_t kCullIterations = 1000;
+
+}  // namespace
+
+// 静的バッチ
+std::string BenchmarkCases::StaticBatching()
+{
+    std::string path = "assets/model/box/box.obj";
+    auto model = ResourceManager::GetInstance().GetModel( path );
+    if( !model ) return "Failed to load " + path + "\n";
+
+    // 箱のメッシュを並べる(マテリアルごとにまとめる)
+    std::vector<StaticBatchBuilder::Source> sources;
+    for( uint32_t i = 0; i < kGridSize * kGridSize; ++i )
+    {
+        auto worldMat = CreateScale( Vector3::kOne * kBoxScale ) * CreateTranslate( BenchmarkScene::GetGridPosition( i, kGridSize, kGridInterval ) );
+        for( uint32_t j = 0; j < model->GetMeshCount(); ++j )
+        {
+            auto mesh = model->GetMesh( j );
+            sources.emplace_back( StaticBatchBuilder::Source{ mesh->GetVertices(), mesh->GetIndices(), worldMat, mesh->GetMaterialIdx() } );
+        }
+    }
+
+    // バッチにしないときのメッシュごとのAABB
+    std::vector<AABB3D> sourceAABBs;
+    for( const auto& source : sources )
+    {
+        auto& aabb = sourceAABBs.emplace_back();
+        aabb.Reset();
+        for( const auto& vertex : source.mVertices )
+        {
+            aabb.Update( Vector3( vertex.mPosition.x, vertex.mPosition.y, vertex.mPosition.z ) * source.mWorldMat );
+        }
+    }
+
+    std::string result = std::format( "{} x {} boxes, {} meshes\n", kGridSize, kGridSize, sources.size() );
+    std::vector<StaticBatchBuilder::Batch> batches;
+    std::vector<StaticBatchBuilder::IndexRange> ranges;
+    for( auto cellSize : kCellSizes )
+    {
+        auto buildTime = Benchmark::Measure( kBuildIterations, [&]() { StaticBatchBuilder::Build( sources, cellSize, batches ); } );
+        size_t cellCount = 0;
+        size_t vertexCount = 0;
+        for( const auto& batch : batches )
+        {
+            cellCount += batch.mCells.size();
+            vertexCount += batch.mVertices.size();
+        }
+        result += std::format( "cell {:.0f}: {} batches, {} cells, {} vertices, build {:.2f} ms\n", cellSize, batches.size(), cellCount, vertexCount, buildTime / 1000.0 );
+
+        for( const auto& view : kViews )
+        {
+            Camera camera;
+            BenchmarkScene::SetupCamera( camera, view.mPosition, view.mPitch );
+            const auto& frustum = camera.GetFrustum();
+
+            // バッチにしないときはメッシュごとに1回
+            uint32_t instanceDraws = 0;
+            for( const auto& aabb : sourceAABBs )
+            {
+                instanceDraws += Intersect( aabb, frustum ) ? 1 : 0;
+            }
+
+            // バッチは可視なセルの連続する範囲ごとに1回
+            uint32_t visibleCells = 0;
+            uint32_t batchDraws = 0;
+            auto cullTime = Benchmark::Measure(
+                kCullIterations,
+                [&]()
+                {
+                    visibleCells = 0;
+                    batchDraws = 0;
+                    for( const auto& batch : batches )
+                    {
+                        visibleCells += StaticBatchBuilder::Cull( batch.mCells, frustum, ranges );
+                        batchDraws += static_cast<uint32_t>( ranges.size() );
+                    }
+                } );
+            result += std::format(
+                "  {}: draws {} -> {}, visible cells {} / {}, cull {:.2f} us\n",
+                view.mName, instanceDraws, batchDraws, visibleCells, cellCount, cullTime );
+        }
+    }
+    return result;
+}
@@ -0,0 +1,112 @@
+#include <cmath>
+#include <format>
+#include <random>
+
+#include "BenchmarkCases.h"
+#include "collision/Heightfield.h"
+#include "collision/TriangleMesh.h"
+#include "editor/Benchmark.h"
+
+namespace
+{
+
+const uint32_t kSampleCount = 1025;
+const uint32_t kRayCount = 10000;
+const uint32_t kSweepCount = 1000;
+const uint32_t kIterations = 5;
+const float kCellSize = 1.0f;
+
+}  // namespace
+
+// ハイトフィールド
+std::string BenchmarkCases::TerrainQuery()
+{
+    // 起伏のある地形
+    std::vector<float> heights( kSampleCount * kSampleCount );
+    for( uint32_t z = 0; z < kSampleCount; ++z )
+    {
+        for( uint32_t x = 0; x < kSampleCount; ++x )
+        {
+            heights[z * kSampleCount + x] = std::sin( x * 0.03f ) * std::cos( z * 0.02f ) * 30.0f + std::sin( x * 0.3f + z * 0.2f ) * 2.0f;
+        }
+    }
+    auto halfSize = ( kSampleCount - 1 ) * kCellSize * 0.5f;
+    Heightfield heightfield;
+    heightfield.Create( kSampleCount, kSampleCount, heights, Vector3( -halfSize, 0.0f, -halfSize ), kCellSize );
+
+    // 同じ地形を三角形メッシュとして
+    std::vector<Vector3> positions;
+    std::vector<uint32_t> indices;
+    heightfield.GetTriangles( positions, indices );
+    TriangleMesh triangleMesh;
+    triangleMesh.Create( positions, indices );
+
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> posDist( -halfSize, halfSize );
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+    std::vector<Vector3> origins( kRayCount );
+    std::vector<Vector3> dirs( kRayCount );
+    for( uint32_t i = 0; i < kRayCount; ++i )
+    {
+        origins[i] = Vector3( posDist( engine ), 50.0f, posDist( engine ) );
+        dirs[i] = Normalize( Vector3( dirDist( engine ), -0.3f, dirDist( engine ) ) );
+    }
+    const auto maxDist = 2000.0f;
+
+    uint32_t heightfieldHits = 0;
+    auto heightfieldTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            heightfieldHits = 0;
+            RaycastHit hit = {};
+            for( uint32_t i = 0; i < kRayCount; ++i )
+            {
+                heightfieldHits += heightfield.Raycast( origins[i], dirs[i], maxDist, hit ) ? 1 : 0;
+            }
+        } );
+    uint32_t meshHits = 0;
+    auto meshTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            meshHits = 0;
+            RaycastHit hit = {};
+            for( uint32_t i = 0; i < kRayCount; ++i )
+            {
+                meshHits += triangleMesh.Raycast( origins[i], dirs[i], maxDist, hit ) ? 1 : 0;
+            }
+        } );
+
+    // 球・カプセルを落とす
+    uint32_t sweepHits = 0;
+    auto sweepTime = Benchmark::Measure(
+        kIterations,
+        [&]()
+        {
+            sweepHits = 0;
+            RaycastHit hit = {};
+            for( uint32_t i = 0; i < kSweepCount; ++i )
+            {
+                Sphere sphere = { origins[i], 1.0f };
+                sweepHits += heightfield.SweepSphere( sphere, dirs[i], maxDist, hit ) ? 1 : 0;
+                Capsule3D capsule = { Segment3D{ origins[i], origins[i] + Vector3( 0.0f, 2.0f, 0.0f ) }, 0.5f };
+                sweepHits += heightfield.SweepCapsule( capsule, dirs[i], maxDist, hit ) ? 1 : 0;
+            }
+        } );
+
+    auto raysPerSec = []( double us )
+    {
+        return us > 0.0 ? kRayCount / ( us * 1e-6 ) / 1e6 : 0.0;
+    };
+    auto triangleBytes = triangleMesh.GetBVH().GetMemorySize() + positions.size() * sizeof( Vector3 ) + indices.size() * sizeof( uint32_t );
+    return std::format(
+        "Samples: {}x{} ({} tris), Rays: {}\n"
+        "Heightfield  : {:.2f} MB, {:.2f} Mrays/s ({} hits)\n"
+        "Triangle BVH : {:.2f} MB, {:.2f} Mrays/s ({} hits)\n"
+        "Sphere+capsule sweeps x{}: {:.1f} us ({} hits)",
+        kSampleCount, kSampleCount, triangleMesh.GetTriangleCount(), kRayCount,
+        heightfield.GetMemorySize() / ( 1024.0 * 1024.0 ), raysPerSec( heightfieldTime ), heightfieldHits,
+        triangleBytes / ( 1024.0 * 1024.0 ), raysPerSec( meshTime ), meshHits,
+        kSweepCount, sweepTime, sweepHits );
+}
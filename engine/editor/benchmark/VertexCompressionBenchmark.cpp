@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <vector>
+
+#include "BenchmarkCases.h"
+#include "core/ResourceManager.h"
+#include "editor/Benchmark.h"
+#include "graphics/model/VertexCompression.h"
+#include "math/MathUtil.h"
+
+namespace
+{
+
+const std::string kModelPaths[] = {
+    "assets/model/box/box.obj",
+    "assets/model/sphere/sphere.obj",
+    "assets/model/floor/floor.glb",
+    "assets/model/bot/x_bot.fbx",
+    "assets/model/bot/y_bot.fbx",
+};
+const uint32_t kIterations = 5;
+
+// 圧縮前の形式
+const uint32_t kFullVertexStride = sizeof( MeshVertex );
+const uint32_t kFullIndexStride = sizeof( uint32_t );
+
+// 割合
+float Percent( uint64_t part, uint64_t total )
+{
+    return total > 0 ? 100.0f * static_cast<float>( part ) / static_cast<float>( total ) : 0.0f;
+}
+
+}  // namespace
+
+// 頂点・インデックスの圧縮
+std::string BenchmarkCases::VertexFormats()
+{
+    std::string result = std::format(
+        "Full: {} bytes/vertex, {} bytes/index. Compact: {} bytes/vertex (skinned meshes stay full)\n",
+        kFullVertexStride, kFullIndexStride, VertexCompression::GetStride( MeshFlags::Required | MeshFlags::Compact ) );
+    uint64_t totalFull = 0;
+    uint64_t totalCompact = 0;
+    for( const auto& path : kModelPaths )
+    {
+        auto model = ResourceManager::GetInstance().GetModel( path );
+        if( !model )
+        {
+            result += "Failed to load " + path + "\n";
+            continue;
+        }
+
+        // 実際のバッファのサイズ(インデックスはLOD1以降も含む)
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+        uint64_t vertexBytes = 0;
+        uint64_t indexBytes = 0;
+        for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+        {
+            auto mesh = model->GetMesh( i );
+            auto meshIndexCount = mesh->GetIndices().size() + mesh->GetLodIndices().size();
+            vertexCount += mesh->GetVertices().size();
+            indexCount += meshIndexCount;
+            vertexBytes += mesh->GetVertices().size() * mesh->GetVertexStride();
+            indexBytes += meshIndexCount * mesh->GetIndexStride();
+        }
+        auto fullVertexBytes = vertexCount * kFullVertexStride;
+        auto fullIndexBytes = indexCount * kFullIndexStride;
+        totalFull += fullVertexBytes + fullIndexBytes;
+        totalCompact += vertexBytes + indexBytes;
+        result += std::format(
+            "{}\n  vertices {}: {} -> {} bytes (-{:.1f}%), indices {}: {} -> {} bytes (-{:.1f}%)\n",
+            path, vertexCount, fullVertexBytes, vertexBytes, 100.0f - Percent( vertexBytes, fullVertexBytes ),
+            indexCount, fullIndexBytes, indexBytes, 100.0f - Percent( indexBytes, fullIndexBytes ) );
+
+        // 全てのメッシュを圧縮したときの誤差と時間
+        auto flags = MeshFlags::Required | MeshFlags::Compact;
+        auto stride = VertexCompression::GetStride( flags );
+        auto positionError = 0.0f;
+        auto normalError = 0.0f;
+        auto uvError = 0.0f;
+        std::vector<uint8_t> data;
+        Matrix4 dequantizeMat;
+        for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+        {
+            const auto& vertices = model->GetMesh( i )->GetVertices();
+            VertexCompression::Encode( flags, vertices, data, dequantizeMat );
+            for( size_t v = 0; v < vertices.size(); ++v )
+            {
+                auto decoded = VertexCompression::Decode( flags, &data[v * stride], dequantizeMat );
+                const auto& src = vertices[v];
+                auto d = Vector3( decoded.mPosition.x - src.mPosition.x, decoded.mPosition.y - src.mPosition.y, decoded.mPosition.z - src.mPosition.z );
+                positionError = ( std::max )( positionError, Length( d ) );
+                auto cosAngle = std::clamp( Dot( decoded.mNormal, Normalize( src.mNormal ) ), -1.0f, 1.0f );
+                normalError = ( std::max )( normalError, std::acos( cosAngle ) );
+                uvError = ( std::max )( uvError, ( std::max )( std::fabs( decoded.mUV.x - src.mUV.x ), std::fabs( decoded.mUV.y - src.mUV.y ) ) );
+            }
+        }
+        auto encodeTime = Benchmark::Measure(
+            kIterations,
+            [&]()
+            {
+                for( uint32_t i = 0; i < model->GetMeshCount(); ++i )
+                {
+                    VertexCompression::Encode( flags, model->GetMesh( i )->GetVertices(), data, dequantizeMat );
+                }
+            } );
+        result += std::format(
+            "  max error: position {:.5f}, normal {:.3f} deg, uv {:.5f}, encode {:.2f} ms\n",
+            positionError, normalError * MathUtil::kRadToDeg, uvError, encodeTime / 1000.0 );
+    }
+    result += std::format( "Total: {} -> {} bytes (-{:.1f}%)\n", totalFull, totalCompact, 100.0f - Percent( totalCompact, totalFull ) );
+    return result;
+}
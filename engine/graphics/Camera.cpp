@@ -1,5 +1,7 @@
 #include "Camera.h"
 
+#include <cstring>
+
 #include "core/Window.h"
 
 // コンストラクタ
@@ -12,12 +14,17 @@ Camera::Camera()
     , mFarZ( 10000.0f )
     , mView()
     , mProjection()
+    , mFrustum()
+    , mVersion( 0 )
 {
 }
 
 // 更新
 void Camera::Update()
 {
+    auto prevView = mView;
+    auto prevProjection = mProjection;
+
     // ビュー行列を更新
     auto worldMat = CreateRotate( mRotate ) * CreateTranslate( mPosition );
     mView = InverseAffine( worldMat );
@@ -47,5 +54,14 @@ void Camera::Update()
             break;
     }
 
+    // 変わっていなければ視錐台もそのまま
+    if( memcmp( &prevView, &mView, sizeof( Matrix4 ) ) == 0 &&
+        memcmp( &prevProjection, &mProjection, sizeof( Matrix4 ) ) == 0 &&
+        mVersion > 0 )
+    {
+        return;
+    }
+
     mFrustum.Build( mView * mProjection );
+    ++mVersion;
 }
@@ -39,6 +39,8 @@ class Camera
     Matrix4 mProjection;
 
     Frustum mFrustum;
+    // ビュー・プロジェクション行列が変わるたびに増える
+    uint32_t mVersion;
 
    public:
     /// <summary>
@@ -64,4 +66,7 @@ class Camera
 
     /// <summary>視錐台を取得</summary>
     const Frustum& GetFrustum() const { return mFrustum; }
+
+    /// <summary>バージョンを取得(行列が変わったかの判定用)</summary>
+    uint32_t GetVersion() const { return mVersion; }
 };
@@ -46,6 +46,13 @@ void DebugCamera::Input( const InputState& state )
     mDistance = std::clamp( mDistance, kMinDistance, kMaxDistance );
 }
 
+// 注視点の周りを回転
+void DebugCamera::Orbit( float yaw, float pitch )
+{
+    mYaw += yaw;
+    mPitch += pitch;
+}
+
 // 更新
 void DebugCamera::Update()
 {
@@ -40,6 +40,13 @@ class DebugCamera
     /// <param name="state">入力状態</param>
     void Input( const InputState& state );
 
+    /// <summary>
+    /// 注視点の周りを回転(入力を使わずに動かす)
+    /// </summary>
+    /// <param name="yaw">ヨーの回転量</param>
+    /// <param name="pitch">ピッチの回転量</param>
+    void Orbit( float yaw, float pitch );
+
     /// <summary>
     /// 更新
     /// </summary>
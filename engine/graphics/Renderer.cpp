@@ -4,6 +4,8 @@
 
 #include "SpriteBase.h"
 #include "core/CommandList.h"
+#include "core/ConstantBufferPool.h"
+#include "core/DirectXBase.h"
 #include "core/DirectXCommonSettings.h"
 #include "core/ResourceManager.h"
 #include "core/Window.h"
@@ -29,6 +31,13 @@ Renderer::Renderer()
     , mUseDebugCamera( false )
     , mDebugCamera( nullptr )
     , mSorter( nullptr )
+    , mItemCount( 0 )
+    , mUseParallelRecording( false )
+    , mRecorder()
+    , mRecordedCmdLists( 0 )
+    , mModelStats()
+    , mBoxBatch( nullptr )
+    , mUseStaticBatch( true )
 {
 }
 
@@ -183,11 +192,34 @@ bool Renderer::Init()
     }
     mSorter->SetFrustumCamera( mModelCamera.get() );
 
+    // ライトのカリング
+    mLightManager->SetFrustum( &mModelCamera->GetFrustum() );
+
     mBotModel1 = std::make_unique<ModelInstance>();
-    mBotModel1->Create( resMgr.GetModel( "assets/model/bot/y_bot.fbx" ) );
+    auto botData1 = resMgr.GetModel( "assets/model/bot/y_bot.fbx" );
+    mBotModel1->Create( botData1 );
+    if( botData1 )
+    {
+        // クリップがあれば最初のものをループ再生
+        mBotModel1->PlayAnimation( botData1->GetCompressedAnimation( 0 ) );
+    }
+    mBotModel1->SetWorldMatrix(
+        CreateScale( Vector3::kOne * 0.1f ) *
+        CreateRotate( Quaternion( Vector3::kUnitY, MathUtil::kPi ) ) *
+        CreateTranslate( Vector3( 10.0f, 0.0f, 0.0f ) ) );
 
     mBotModel2 = std::make_unique<ModelInstance>();
-    mBotModel2->Create( resMgr.GetModel( "assets/model/bot/x_bot.fbx" ) );
+    auto botData2 = resMgr.GetModel( "assets/model/bot/x_bot.fbx" );
+    mBotModel2->Create( botData2 );
+    if( botData2 )
+    {
+        // クリップがあれば最初のものをループ再生
+        mBotModel2->PlayAnimation( botData2->GetCompressedAnimation( 0 ) );
+    }
+    mBotModel2->SetWorldMatrix(
+        CreateScale( Vector3::kOne * 0.1f ) *
+        CreateRotate( Quaternion( Vector3::kUnitY, MathUtil::kPi ) ) *
+        CreateTranslate( Vector3( -10.0f, 0.0f, 0.0f ) ) );
     mRotate = 0.0f;
 
     mBoxModel = std::make_unique<ModelInstance>();
@@ -200,6 +232,23 @@ bool Renderer::Init()
         auto x = ( i % 30 - ( 30 - 1 ) / 2.0f ) * interval;
         auto z = ( i / 30 - ( 30 - 1 ) / 2.0f ) * interval;
         mBoxPosition[i] = Vector3( x, 0.0f, z );
+        // 動かないので一度だけ設定する
+        mBoxModels[i]->SetWorldMatrix(
+            CreateScale( Vector3( 5.0f, 5.0f, 5.0f ) ) *
+            CreateTranslate( mBoxPosition[i] ) );
+    }
+
+    // 並べた箱は動かないのでセルごとにまとめる
+    std::vector<ModelInstance*> boxInstances;
+    for( auto& boxModel : mBoxModels )
+    {
+        boxInstances.emplace_back( boxModel.get() );
+    }
+    mBoxBatch = std::make_unique<StaticBatch>();
+    if( !mBoxBatch->Create( boxInstances, kBoxBatchCellSize ) )
+    {
+        LOG_ERROR( "Failed to create static batch." );
+        mBoxBatch.reset();
     }
 
     mSphereModel = std::make_unique<ModelInstance>();
@@ -207,6 +256,7 @@ bool Renderer::Init()
 
     mFloorModel = std::make_unique<ModelInstance>();
     mFloorModel->Create( resMgr.GetModel( "assets/model/floor/floor.glb" ) );
+    mFloorModel->SetWorldMatrix( CreateScale( Vector3( 3.0f, 3.0f, 3.0f ) ) * CreateTranslate( Vector3( 0.0f, -0.2f, 0.0f ) ) );
 
     auto* primitiveVS = resMgr.GetShader( "assets/shader/PrimitiveVS.hlsl", "vs_6_0" );
     auto* primitivePS = resMgr.GetShader( "assets/shader/PrimitivePS.hlsl", "ps_6_0" );
@@ -230,6 +280,19 @@ bool Renderer::Init()
 // 終了処理
 void Renderer::Term()
 {
+    // モデル(定数バッファのスロットをプールへ返してから解放する)
+    mBotModel1.reset();
+    mBotModel2.reset();
+    mBoxModel.reset();
+    mBoxBatch.reset();
+    for( auto& boxModel : mBoxModels )
+    {
+        boxModel.reset();
+    }
+    mSphereModel.reset();
+    mFloorModel.reset();
+    ConstantBufferPool::GetInstance().Term();
+
     if( mModelBase )
     {
         mModelBase->Term();
@@ -277,6 +340,79 @@ void Renderer::UpdateGUI()
     ImGui::Begin( "Renderer" );
 
     ImGui::Text( std::format( "Mesh Count: {}", mItemCount ).c_str() );
+    const auto& sorterStats = mSorter->GetStats();
+    ImGui::Text( std::format( "Draw Calls: {} (instanced {} draws / {} instances)", sorterStats.mDraws, sorterStats.mInstancedDraws, sorterStats.mInstances ).c_str() );
+    auto useInstancing = mSorter->IsUsingInstancing();
+    if( ImGui::Checkbox( "GPU Instancing", &useInstancing ) )
+    {
+        mSorter->SetUseInstancing( useInstancing );
+    }
+    auto useCoherentSort = mSorter->IsUsingCoherentSort();
+    if( ImGui::Checkbox( "Coherent Sort", &useCoherentSort ) )
+    {
+        mSorter->SetUseCoherentSort( useCoherentSort );
+    }
+    ImGui::Text( std::format( "Sort: {} (descents {}, moves {})", sorterStats.mCoherentSort ? "insertion" : "radix", sorterStats.mSortDescents, sorterStats.mSortMoves ).c_str() );
+    auto depthBucketing = static_cast<int>( mSorter->GetDepthBucketing() );
+    auto depthBucketSize = mSorter->GetDepthBucketSize();
+    auto depthBucketCount = static_cast<int>( mSorter->GetDepthBucketCount() );
+    auto isDepthBucketChanged = ImGui::Combo( "Depth Buckets", &depthBucketing, "Linear\0Logarithmic\0Adaptive\0Fixed Count\0" );
+    if( depthBucketing == static_cast<int>( DrawKey::DepthBucketing::Linear ) )
+    {
+        isDepthBucketChanged |= ImGui::DragFloat( "Bucket Size", &depthBucketSize, 0.1f, 0.001f, 1000.0f );
+    }
+    else
+    {
+        isDepthBucketChanged |= ImGui::DragInt( "Bucket Count", &depthBucketCount, 1.0f, 1, 65536 );
+    }
+    if( isDepthBucketChanged )
+    {
+        mSorter->SetDepthBucketing( static_cast<DrawKey::DepthBucketing>( depthBucketing ), depthBucketSize, static_cast<uint32_t>( depthBucketCount ) );
+    }
+    ImGui::Text( std::format( "PSO Switches: {}, Depth Inversions: {} / {} opaque", sorterStats.mPSOSwitches, sorterStats.mDepthInversions, sorterStats.mOpaqueItems ).c_str() );
+    auto& cmdListState = DirectXBase::GetInstance().GetCmdList()->GetState();
+    auto isStateFiltering = cmdListState.IsEnabled();
+    if( ImGui::Checkbox( "State Filtering", &isStateFiltering ) )
+    {
+        cmdListState.SetEnabled( isStateFiltering );
+    }
+    const auto& counters = cmdListState.GetLastCounters();
+    uint32_t issuedCalls = 0;
+    uint32_t filteredCalls = 0;
+    for( size_t i = 0; i < counters.mIssued.size(); ++i )
+    {
+        issuedCalls += counters.mIssued[i];
+        filteredCalls += counters.mFiltered[i];
+    }
+    auto filteredPSOs = counters.mFiltered[static_cast<size_t>( CommandListState::Category::PipelineState )];
+    auto filteredRootArgs = counters.mFiltered[static_cast<size_t>( CommandListState::Category::RootArgument )];
+    ImGui::Text( std::format( "State Calls: {} issued, {} filtered (PSO {}, root args {})", issuedCalls, filteredCalls, filteredPSOs, filteredRootArgs ).c_str() );
+    ImGui::Checkbox( "Parallel Recording", &mUseParallelRecording );
+    if( mUseParallelRecording )
+    {
+        auto minChunkSize = static_cast<int>( mRecorder.GetMinChunkSize() );
+        if( ImGui::DragInt( "Min Draws per List", &minChunkSize, 1.0f, 1, 4096 ) )
+        {
+            mRecorder.SetMinChunkSize( static_cast<uint32_t>( minChunkSize ) );
+        }
+        ImGui::Text( std::format( "Worker Command Lists: {} / {}", mRecordedCmdLists, DirectXBase::GetInstance().GetWorkerCmdListCount() ).c_str() );
+    }
+    ImGui::Text( std::format( "Node Update: {} (skipped {})", mModelStats.mUpdatedNodes, mModelStats.mSkippedNodes ).c_str() );
+    ImGui::Text( std::format( "World Update: {} (skipped {})", mModelStats.mUpdatedMeshes, mModelStats.mSkippedMeshes ).c_str() );
+    ImGui::Text( std::format( "WVP Update: {} (skipped {})", mModelStats.mUpdatedWVPs, mModelStats.mSkippedWVPs ).c_str() );
+    ImGui::Text( std::format( "Skinned Vertices: {}", mModelStats.mSkinnedVertices ).c_str() );
+    ImGui::Text( std::format( "Triangles: {} (without LOD {})", mModelStats.mDrawnTriangles, mModelStats.mFullDetailTriangles ).c_str() );
+    ImGui::Text( std::format( "Culled Meshes: {} (nodes {})", mModelStats.mCulledMeshes, mModelStats.mCulledNodes ).c_str() );
+    if( mBoxBatch )
+    {
+        const auto& batchStats = mBoxBatch->GetStats();
+        ImGui::Checkbox( "Static Batching (boxes)", &mUseStaticBatch );
+        ImGui::Text( std::format( "Static Batch: {} draws, cells {} / {} ({} meshes in {} batches)", batchStats.mDraws, batchStats.mVisibleCells, batchStats.mCells, batchStats.mSourceMeshes, batchStats.mBatches ).c_str() );
+    }
+    auto& cbPool = ConstantBufferPool::GetInstance();
+    ImGui::Text( std::format( "Box Instance Memory: {} B (CB pool: {} slots, {} pages)", mBoxModels[0]->GetMemorySize(), cbPool.GetUsedSlotCount(), cbPool.GetPageCount() ).c_str() );
+    ImGui::Text( std::format( "Point Light: {} / {}", mLightManager->GetVisiblePointLightCount(), mLightManager->GetPointLightCount() ).c_str() );
+    ImGui::Text( std::format( "Spot Light: {} / {}", mLightManager->GetVisibleSpotLightCount(), mLightManager->GetSpotLightCount() ).c_str() );
 
     // カメラ
     ImGui::SetNextItemOpen( true, ImGuiCond_Once );
@@ -304,10 +440,15 @@ void Renderer::UpdateGUI()
     if( ImGui::TreeNode( "Point Light" ) )
     {
         ImGui::ColorEdit3( "Color", &mPointLight->mColor.r );
-        ImGui::DragFloat3( "Position", &mPointLight->mPosition.x, 0.01f );
+        auto changed = ImGui::DragFloat3( "Position", &mPointLight->mPosition.x, 0.01f );
         ImGui::DragFloat( "Intensity", &mPointLight->mIntensity, 0.01f, 0.0f, FLT_MAX );
-        ImGui::DragFloat( "Radius", &mPointLight->mRadius, 0.01f, 0.0f, FLT_MAX );
+        changed |= ImGui::DragFloat( "Radius", &mPointLight->mRadius, 0.01f, 0.0f, FLT_MAX );
         ImGui::DragFloat( "Decay", &mPointLight->mDecay, 0.01f, 0.0f, FLT_MAX );
+        if( changed )
+        {
+            // カリング用の位置と半径を更新
+            mLightManager->UpdatePointLight( mPointLight.get() );
+        }
         ImGui::TreePop();
     }
 
@@ -316,13 +457,18 @@ void Renderer::UpdateGUI()
     if( ImGui::TreeNode( "Spot Light" ) )
     {
         ImGui::ColorEdit3( "Color", &mSpotLight->mColor.r );
-        ImGui::DragFloat3( "Position", &mSpotLight->mPosition.x, 0.01f );
+        auto changed = ImGui::DragFloat3( "Position", &mSpotLight->mPosition.x, 0.01f );
         ImGui::DragFloat( "Intensity", &mSpotLight->mIntensity, 0.01f, 0.0f, FLT_MAX );
-        ImGui::DragFloat3( "Direction", &mSpotLight->mDirection.x, 0.01f );
-        ImGui::DragFloat( "Radius", &mSpotLight->mRadius, 0.01f, 0.0f, FLT_MAX );
+        changed |= ImGui::DragFloat3( "Direction", &mSpotLight->mDirection.x, 0.01f );
+        changed |= ImGui::DragFloat( "Radius", &mSpotLight->mRadius, 0.01f, 0.0f, FLT_MAX );
         ImGui::DragFloat( "Decay", &mSpotLight->mDecay, 0.01f, 0.0f, FLT_MAX );
         ImGui::DragFloat( "Inner Angle", &mSpotLight->mInnerAngle, 0.01f, 0.0f, mSpotLight->mOuterAngle );
-        ImGui::DragFloat( "Outer Angle", &mSpotLight->mOuterAngle, 0.01f, mSpotLight->mInnerAngle, 180.0f );
+        changed |= ImGui::DragFloat( "Outer Angle", &mSpotLight->mOuterAngle, 0.01f, mSpotLight->mInnerAngle, 180.0f );
+        if( changed )
+        {
+            // カリング用の位置・向き・範囲を更新
+            mLightManager->UpdateSpotLight( mSpotLight.get() );
+        }
         ImGui::TreePop();
     }
 
@@ -367,31 +513,27 @@ void Renderer::Update( float deltaTime )
 // モデル描画
 void Renderer::DrawModel()
 {
-    mFloorModel->Draw( mSorter.get(), CreateScale( Vector3( 3.0f, 3.0f, 3.0f ) ) * CreateTranslate( Vector3( 0.0f, -0.2f, 0.0f ) ) );
-
-    auto botWorld1 =
-        CreateScale( Vector3::kOne * 0.1f ) *
-        CreateRotate( Quaternion( Vector3::kUnitY, MathUtil::kPi ) ) *
-        CreateTranslate( Vector3( 10.0f, 0.0f, 0.0f ) );
-    mBotModel1->Draw( mSorter.get(), botWorld1 );
-
-    auto botWorld2 =
-        CreateScale( Vector3::kOne * 0.1f ) *
-        CreateRotate( Quaternion( Vector3::kUnitY, MathUtil::kPi ) ) *
-        CreateTranslate( Vector3( -10.0f, 0.0f, 0.0f ) );
-    mBotModel2->Draw( mSorter.get(), botWorld2 );
+    // 動かないモデルはワールド行列を設定済み
+    mFloorModel->Draw( mSorter.get() );
+    mBotModel1->Draw( mSorter.get() );
+    mBotModel2->Draw( mSorter.get() );
 
     auto boxWorld =
         CreateRotate( Quaternion( Vector3::kUnitY, mRotate ) ) *
         CreateTranslate( Vector3( 2.5f, 0.0f, 0.0f ) );
     mBoxModel->Draw( mSorter.get(), boxWorld );
 
-    for( uint32_t i = 0; i < 30 * 30; ++i )
+    auto useStaticBatch = mUseStaticBatch && mBoxBatch;
+    if( useStaticBatch )
     {
-        boxWorld =
-            CreateScale( Vector3( 5.0f, 5.0f, 5.0f ) ) *
-            CreateTranslate( mBoxPosition[i] );
-        mBoxModels[i]->Draw( mSorter.get(), boxWorld );
+        mBoxBatch->Draw( mSorter.get() );
+    }
+    else
+    {
+        for( uint32_t i = 0; i < 30 * 30; ++i )
+        {
+            mBoxModels[i]->Draw( mSorter.get() );
+        }
     }
 
     auto sphereWorld =
@@ -399,6 +541,33 @@ void Renderer::DrawModel()
         CreateTranslate( Vector3( -2.5f, 0.0f, 0.0f ) );
     mSphereModel->Draw( mSorter.get(), sphereWorld );
 
+    // 統計を集計
+    mModelStats = {};
+    auto addStats = [&]( const ModelInstance* model )
+    {
+        const auto& stats = model->GetUpdateStats();
+        mModelStats.mUpdatedNodes += stats.mUpdatedNodes;
+        mModelStats.mSkippedNodes += stats.mSkippedNodes;
+        mModelStats.mUpdatedMeshes += stats.mUpdatedMeshes;
+        mModelStats.mSkippedMeshes += stats.mSkippedMeshes;
+        mModelStats.mUpdatedWVPs += stats.mUpdatedWVPs;
+        mModelStats.mSkippedWVPs += stats.mSkippedWVPs;
+        mModelStats.mSkinnedVertices += stats.mSkinnedVertices;
+        mModelStats.mDrawnTriangles += stats.mDrawnTriangles;
+        mModelStats.mFullDetailTriangles += stats.mFullDetailTriangles;
+        mModelStats.mCulledMeshes += stats.mCulledMeshes;
+        mModelStats.mCulledNodes += stats.mCulledNodes;
+    };
+    addStats( mFloorModel.get() );
+    addStats( mBotModel1.get() );
+    addStats( mBotModel2.get() );
+    addStats( mBoxModel.get() );
+    for( uint32_t i = 0; i < 30 * 30 && !useStaticBatch; ++i )
+    {
+        addStats( mBoxModels[i].get() );
+    }
+    addStats( mSphereModel.get() );
+
     mSorter->Sort();
 
     mItemCount = mSorter->GetItemCount();
@@ -407,11 +576,7 @@ void Renderer::DrawModel()
 // z-prepass描画
 void Renderer::RenderZPrepass( CommandList* cmdList )
 {
-    auto& window = Window::GetInstance();
-    auto windowWidth = static_cast<float>( window.GetWidth() );
-    auto windowHeight = static_cast<float>( window.GetHeight() );
-    cmdList->SetViewport( 0.0f, 0.0f, windowWidth, windowHeight );
-    cmdList->SetScissorRect( 0.0f, 0.0f, windowWidth, windowHeight );
+    SetViewport( cmdList );
 
     mModelBase->BeginZPrepass( cmdList );
 
@@ -423,11 +588,7 @@ void Renderer::RenderZPrepass( CommandList* cmdList )
 // 描画
 void Renderer::RenderMain( CommandList* cmdList )
 {
-    auto& window = Window::GetInstance();
-    auto windowWidth = static_cast<float>( window.GetWidth() );
-    auto windowHeight = static_cast<float>( window.GetHeight() );
-    cmdList->SetViewport( 0.0f, 0.0f, windowWidth, windowHeight );
-    cmdList->SetScissorRect( 0.0f, 0.0f, windowWidth, windowHeight );
+    SetViewport( cmdList );
 
     RenderSprite( cmdList );
 
@@ -502,6 +663,16 @@ void Renderer::RenderMain( CommandList* cmdList )
     mPrimitiveRenderer->Render2D( cmdList );
 }
 
+// ビューポートとシザー矩形をウィンドウ全体にセット
+void Renderer::SetViewport( CommandList* cmdList )
+{
+    auto& window = Window::GetInstance();
+    auto windowWidth = static_cast<float>( window.GetWidth() );
+    auto windowHeight = static_cast<float>( window.GetHeight() );
+    cmdList->SetViewport( 0.0f, 0.0f, windowWidth, windowHeight );
+    cmdList->SetScissorRect( 0.0f, 0.0f, windowWidth, windowHeight );
+}
+
 // モデルを描画
 void Renderer::RenderModel( CommandList* cmdList )
 {
@@ -511,7 +682,27 @@ void Renderer::RenderModel( CommandList* cmdList )
 
     mLightManager->Bind( cmdList, 4 );
 
-    mSorter->Render( cmdList );
+    if( mUseParallelRecording )
+    {
+        // ワーカーのコマンドリストには、ここまでにセットしたものを同じようにセットする
+        mRecordedCmdLists = mSorter->RenderParallel(
+            cmdList,
+            mRecorder,
+            [this]( CommandList* workerCmdList )
+            {
+                SetViewport( workerCmdList );
+                mModelBase->Bind( workerCmdList );
+                workerCmdList->SetGraphicsConstantBuffer( 4, mLightManager->GetCB() );
+            } );
+
+        // 記録を再開したコマンドリストはビューポートとシザー矩形を忘れている
+        SetViewport( cmdList );
+    }
+    else
+    {
+        mSorter->Render( cmdList );
+        mRecordedCmdLists = 0;
+    }
 
     mModelBase->End();
 }
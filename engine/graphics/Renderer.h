@@ -9,12 +9,14 @@
 #include "PrimitiveRenderer.h"
 #include "Sprite.h"
 #include "core/GraphicsPSO.h"
+#include "core/ParallelRecorder.h"
 #include "core/RootSignature.h"
 #include "light/DirectionalLight.h"
 #include "light/PointLight.h"
 #include "light/SpotLight.h"
 #include "model/MeshSorter.h"
 #include "model/ModelInstance.h"
+#include "model/StaticBatch.h"
 
 class CommandList;
 class LightManager;
@@ -51,6 +53,13 @@ class Renderer
     // ソーター
     std::unique_ptr<MeshSorter> mSorter;
     uint32_t mItemCount;
+    // ソーターの描画をワーカーのコマンドリストへ並列に記録するかと、その分け方
+    bool mUseParallelRecording;
+    ParallelRecorder mRecorder;
+    // 直前の描画で記録したワーカーのコマンドリストの数
+    uint32_t mRecordedCmdLists;
+    // モデルの更新の統計(全インスタンスの合計)
+    ModelInstance::UpdateStats mModelStats;
 
     // スプライト
     std::unique_ptr<Sprite> mOwlSprite;
@@ -64,6 +73,10 @@ class Renderer
     std::unique_ptr<ModelInstance> mFloorModel;
     std::unique_ptr<ModelInstance> mBoxModels[30 * 30];
     Vector3 mBoxPosition[30 * 30];
+    // 並べた箱をまとめた静的バッチ(有効ならインスタンスの代わりに描画する)
+    static constexpr float kBoxBatchCellSize = 100.0f;
+    std::unique_ptr<StaticBatch> mBoxBatch;
+    bool mUseStaticBatch;
 
     float mRotate;
 
@@ -161,6 +174,12 @@ class Renderer
     void RenderMain( CommandList* cmdList );
 
    private:
+    /// <summary>
+    /// ビューポートとシザー矩形をウィンドウ全体にセット
+    /// </summary>
+    /// <param name="cmdList">コマンドリスト</param>
+    void SetViewport( CommandList* cmdList );
+
     /// <summary>
     /// モデルを描画
     /// </summary>
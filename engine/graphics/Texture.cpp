@@ -1,5 +1,6 @@
 #include "Texture.h"
 
+#include <cstring>
 #include <format>
 
 #include "DirectXTex/d3dx12.h"
@@ -45,6 +46,31 @@ bool Texture::Create( const std::string& path )
     return true;
 }
 
+// 画像を1チャンネルの値としてCPU側に読み込む
+bool Texture::LoadValues( const std::string& path, std::vector<float>& values, uint32_t& width, uint32_t& height )
+{
+    auto wpath = StringHelper::Convert( path );
+    DirectX::ScratchImage image = {};
+    auto hr = DirectX::LoadFromWICFile( wpath.c_str(), DirectX::WIC_FLAGS_IGNORE_SRGB, nullptr, image );
+    if( FAILED( hr ) ) return false;
+
+    // 赤チャンネルを32ビット浮動小数点に変換
+    DirectX::ScratchImage converted = {};
+    hr = DirectX::Convert( *image.GetImage( 0, 0, 0 ), DXGI_FORMAT_R32_FLOAT, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted );
+    if( FAILED( hr ) ) return false;
+
+    const auto* src = converted.GetImage( 0, 0, 0 );
+    width = static_cast<uint32_t>( src->width );
+    height = static_cast<uint32_t>( src->height );
+    values.resize( static_cast<size_t>( width ) * height );
+    for( uint32_t y = 0; y < height; ++y )
+    {
+        std::memcpy( values.data() + static_cast<size_t>( y ) * width, src->pixels + y * src->rowPitch, width * sizeof( float ) );
+    }
+
+    return true;
+}
+
 // テクスチャを読み込む
 bool Texture::Load( const std::string& path, DirectX::ScratchImage& image, DirectX::ScratchImage& mipChain )
 {
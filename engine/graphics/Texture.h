@@ -3,6 +3,7 @@
 #include <wrl.h>
 
 #include <string>
+#include <vector>
 
 #include "DirectXTex/DirectXTex.h"
 #include "core/DescriptorHeap.h"
@@ -45,6 +46,16 @@ class Texture
     /// <returns>成否</returns>
     bool Create( const std::string& path );
 
+    /// <summary>
+    /// 画像を1チャンネルの値としてCPU側に読み込む(ハイトマップなど)
+    /// </summary>
+    /// <param name="path">画像のパス</param>
+    /// <param name="values">0～1の値(出力、行優先)</param>
+    /// <param name="width">幅(出力)</param>
+    /// <param name="height">高さ(出力)</param>
+    /// <returns>成否</returns>
+    static bool LoadValues( const std::string& path, std::vector<float>& values, uint32_t& width, uint32_t& height );
+
     /// <summary>テクスチャのパスを取得</summary>
     const std::string& GetPath() const { return mPath; }
 
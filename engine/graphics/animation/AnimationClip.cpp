@@ -0,0 +1,45 @@
+#include "AnimationClip.h"
+
+// コンストラクタ
+AnimationClip::AnimationClip()
+    : mName()
+    , mDuration( 0.0f )
+    , mChannels()
+{
+}
+
+// 作成
+bool AnimationClip::Create( const std::string& name, float duration, std::vector<AnimationChannel>&& channels )
+{
+    if( duration < 0.0f ) return false;
+
+    // キーの数と時間の数が揃っていること
+    for( const auto& channel : channels )
+    {
+        if( channel.mPositionTimes.size() != channel.mPositions.size() ||
+            channel.mRotationTimes.size() != channel.mRotations.size() ||
+            channel.mScaleTimes.size() != channel.mScales.size() )
+        {
+            return false;
+        }
+    }
+
+    mName = name;
+    mDuration = duration;
+    mChannels = std::move( channels );
+    return true;
+}
+
+// 使用メモリを取得
+size_t AnimationClip::GetMemorySize() const
+{
+    size_t size = 0;
+    for( const auto& channel : mChannels )
+    {
+        size += sizeof( AnimationChannel );
+        size += channel.mPositionTimes.size() * ( sizeof( float ) + sizeof( Vector3 ) );
+        size += channel.mRotationTimes.size() * ( sizeof( float ) + sizeof( Quaternion ) );
+        size += channel.mScaleTimes.size() * ( sizeof( float ) + sizeof( Vector3 ) );
+    }
+    return size;
+}
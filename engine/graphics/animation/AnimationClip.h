@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "math/Quaternion.h"
+#include "math/Vector3.h"
+
+/// <summary>
+/// ノード1つ分のアニメーション(キーの時間は秒、昇順)
+/// </summary>
+struct AnimationChannel
+{
+    // 対象のノードのインデックス
+    int32_t mNodeIdx;
+    // 座標
+    std::vector<float> mPositionTimes;
+    std::vector<Vector3> mPositions;
+    // 回転
+    std::vector<float> mRotationTimes;
+    std::vector<Quaternion> mRotations;
+    // スケール
+    std::vector<float> mScaleTimes;
+    std::vector<Vector3> mScales;
+};
+
+/// <summary>
+/// アニメーションクリップ
+/// </summary>
+class AnimationClip
+{
+   private:
+    // クリップ名
+    std::string mName;
+    // 長さ(秒)
+    float mDuration;
+    // チャンネル
+    std::vector<AnimationChannel> mChannels;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    AnimationClip();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~AnimationClip() = default;
+
+    /// <summary>
+    /// 作成
+    /// </summary>
+    /// <param name="name">クリップ名</param>
+    /// <param name="duration">長さ(秒)</param>
+    /// <param name="channels">チャンネル</param>
+    /// <returns>成否</returns>
+    bool Create( const std::string& name, float duration, std::vector<AnimationChannel>&& channels );
+
+    /// <summary>クリップ名を取得</summary>
+    const std::string& GetName() const { return mName; }
+
+    /// <summary>長さ(秒)を取得</summary>
+    float GetDuration() const { return mDuration; }
+
+    /// <summary>チャンネルを取得</summary>
+    const std::vector<AnimationChannel>& GetChannels() const { return mChannels; }
+
+    /// <summary>使用メモリ(バイト)を取得</summary>
+    size_t GetMemorySize() const;
+};
@@ -0,0 +1,397 @@
+#include "AnimationGraph.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// ローカルのトランスフォームをコピー
+void CopyLocal( const NodePose& src, NodePose& dst )
+{
+    dst.mScales = src.mScales;
+    dst.mRotates = src.mRotates;
+    dst.mTranslates = src.mTranslates;
+}
+
+// 回転の補間(近い向きを通る正規化線形補間)
+Quaternion BlendRotate( const Quaternion& a, const Quaternion& b, float t )
+{
+    if( Dot( a, b ) < 0.0f )
+    {
+        return Lerp( a, Quaternion( -b.w, -b.x, -b.y, -b.z ), t );
+    }
+    return Lerp( a, b, t );
+}
+
+// 2つの姿勢を補間して a へ書き込む(マスクがあればノードごとの重みを掛ける)
+void BlendPose( NodePose& a, const NodePose& b, float t, const std::vector<float>* mask )
+{
+    auto count = a.mTranslates.size();
+    for( size_t i = 0; i < count; ++i )
+    {
+        auto w = mask ? t * ( *mask )[i] : t;
+        if( w <= 0.0f ) continue;
+
+        a.mScales[i] += ( b.mScales[i] - a.mScales[i] ) * w;
+        a.mRotates[i] = BlendRotate( a.mRotates[i], b.mRotates[i], w );
+        a.mTranslates[i] += ( b.mTranslates[i] - a.mTranslates[i] ) * w;
+    }
+}
+
+// 基準の姿勢との差分を重みを付けて足す
+void AddPose( NodePose& base, const NodePose& additive, const NodePose& reference, float weight, const std::vector<float>* mask )
+{
+    const Quaternion identity;
+    auto count = base.mTranslates.size();
+    for( size_t i = 0; i < count; ++i )
+    {
+        auto w = mask ? weight * ( *mask )[i] : weight;
+        if( w == 0.0f ) continue;
+
+        // 基準から加算する姿勢への回転を、元の姿勢の回転の後に掛ける
+        auto delta = additive.mRotates[i] * Conjugate( reference.mRotates[i] );
+        base.mRotates[i] = BlendRotate( identity, delta, w ) * base.mRotates[i];
+        base.mScales[i] += ( additive.mScales[i] - reference.mScales[i] ) * w;
+        base.mTranslates[i] += ( additive.mTranslates[i] - reference.mTranslates[i] ) * w;
+    }
+}
+
+// 昇順の位置の中で x を挟む区間と割合を探す
+void FindSegment( const std::vector<float>& points, float x, uint32_t& idx0, uint32_t& idx1, float& t )
+{
+    auto count = static_cast<uint32_t>( points.size() );
+    auto it = std::upper_bound( points.begin(), points.end(), x );
+    if( it == points.begin() )
+    {
+        idx0 = idx1 = 0;
+        t = 0.0f;
+        return;
+    }
+    if( it == points.end() )
+    {
+        idx0 = idx1 = count - 1;
+        t = 0.0f;
+        return;
+    }
+
+    idx1 = static_cast<uint32_t>( it - points.begin() );
+    idx0 = idx1 - 1;
+    auto span = points[idx1] - points[idx0];
+    t = span > 0.0f ? ( x - points[idx0] ) / span : 0.0f;
+}
+
+}  // namespace
+
+// コンストラクタ
+AnimationGraph::AnimationGraph()
+    : mHierarchy( nullptr )
+    , mNodes()
+    , mRoot( kInvalidIndex )
+    , mParams()
+    , mMasks()
+{
+}
+
+// 作成
+bool AnimationGraph::Create( const NodeHierarchy* hierarchy )
+{
+    mNodes.clear();
+    mParams.clear();
+    mMasks.clear();
+    mRoot = kInvalidIndex;
+    mHierarchy = hierarchy;
+    return mHierarchy != nullptr;
+}
+
+// パラメータを追加
+uint32_t AnimationGraph::AddParameter( float value )
+{
+    mParams.emplace_back( value );
+    return static_cast<uint32_t>( mParams.size() - 1 );
+}
+
+// マスクを追加
+uint32_t AnimationGraph::AddMask( int32_t rootNodeIdx, float weight )
+{
+    // 親は必ず先に並ぶので、親がマスク内なら子もマスク内
+    const auto& parents = mHierarchy->GetParents();
+    std::vector<float> mask( mHierarchy->GetCount(), 0.0f );
+    std::vector<uint8_t> isInside( mHierarchy->GetCount(), 0 );
+    for( uint32_t i = 0; i < mHierarchy->GetCount(); ++i )
+    {
+        auto parent = parents[i];
+        if( static_cast<int32_t>( i ) == rootNodeIdx || ( parent != NodeHierarchy::kInvalidIndex && isInside[parent] ) )
+        {
+            isInside[i] = 1;
+            mask[i] = weight;
+        }
+    }
+    mMasks.emplace_back( std::move( mask ) );
+    return static_cast<uint32_t>( mMasks.size() - 1 );
+}
+
+// クリップのノードを追加
+uint32_t AnimationGraph::AddClip( const CompressedAnimationClip* clip, float speed, bool isLoop )
+{
+    if( !clip ) return kInvalidIndex;
+
+    auto nodeIdx = AddNode( NodeType::kClip, {} );
+    auto& node = mNodes[nodeIdx];
+    node.mSampler.SetClip( clip );
+    node.mSpeed = speed;
+    node.mIsLoop = isLoop;
+    return nodeIdx;
+}
+
+// 1次元のブレンドスペースを追加
+uint32_t AnimationGraph::AddBlend1D( uint32_t param, const std::vector<uint32_t>& inputs, const std::vector<float>& points )
+{
+    if( param >= mParams.size() || inputs.empty() || inputs.size() != points.size() ) return kInvalidIndex;
+
+    auto nodeIdx = AddNode( NodeType::kBlend1D, inputs );
+    if( nodeIdx == kInvalidIndex ) return kInvalidIndex;
+
+    auto& node = mNodes[nodeIdx];
+    node.mParamX = param;
+    node.mPointsX = points;
+    return nodeIdx;
+}
+
+// 2次元のブレンドスペースを追加
+uint32_t AnimationGraph::AddBlend2D( uint32_t paramX, uint32_t paramY, const std::vector<uint32_t>& inputs, const std::vector<float>& pointsX, const std::vector<float>& pointsY )
+{
+    if( paramX >= mParams.size() || paramY >= mParams.size() ) return kInvalidIndex;
+    if( inputs.empty() || inputs.size() != pointsX.size() * pointsY.size() ) return kInvalidIndex;
+
+    auto nodeIdx = AddNode( NodeType::kBlend2D, inputs );
+    if( nodeIdx == kInvalidIndex ) return kInvalidIndex;
+
+    auto& node = mNodes[nodeIdx];
+    node.mParamX = paramX;
+    node.mParamY = paramY;
+    node.mPointsX = pointsX;
+    node.mPointsY = pointsY;
+    return nodeIdx;
+}
+
+// クロスフェードのノードを追加
+uint32_t AnimationGraph::AddCrossfade( const std::vector<uint32_t>& inputs )
+{
+    if( inputs.empty() ) return kInvalidIndex;
+
+    return AddNode( NodeType::kCrossfade, inputs );
+}
+
+// 加算レイヤーを追加
+uint32_t AnimationGraph::AddAdditive( uint32_t base, uint32_t additive, uint32_t weightParam, uint32_t maskIdx )
+{
+    if( weightParam >= mParams.size() || ( maskIdx != kInvalidIndex && maskIdx >= mMasks.size() ) ) return kInvalidIndex;
+
+    auto nodeIdx = AddNode( NodeType::kAdditive, { base, additive } );
+    if( nodeIdx == kInvalidIndex ) return kInvalidIndex;
+
+    mNodes[nodeIdx].mWeightParam = weightParam;
+    mNodes[nodeIdx].mMaskIdx = maskIdx;
+    return nodeIdx;
+}
+
+// 上書きレイヤーを追加
+uint32_t AnimationGraph::AddLayer( uint32_t base, uint32_t overlay, uint32_t weightParam, uint32_t maskIdx )
+{
+    if( weightParam >= mParams.size() || ( maskIdx != kInvalidIndex && maskIdx >= mMasks.size() ) ) return kInvalidIndex;
+
+    auto nodeIdx = AddNode( NodeType::kLayer, { base, overlay } );
+    if( nodeIdx == kInvalidIndex ) return kInvalidIndex;
+
+    mNodes[nodeIdx].mWeightParam = weightParam;
+    mNodes[nodeIdx].mMaskIdx = maskIdx;
+    return nodeIdx;
+}
+
+// クロスフェードを開始
+void AnimationGraph::CrossFade( uint32_t nodeIdx, uint32_t input, float duration )
+{
+    if( nodeIdx >= mNodes.size() ) return;
+
+    auto& node = mNodes[nodeIdx];
+    if( node.mType != NodeType::kCrossfade || input >= node.mInputs.size() || input == node.mActiveInput ) return;
+
+    // フェード中に切り替えたときは、それまでの切り替え先からフェードし直す
+    node.mPrevInput = duration > 0.0f ? node.mActiveInput : kInvalidIndex;
+    node.mActiveInput = input;
+    node.mFadeTime = 0.0f;
+    node.mFadeDuration = duration;
+}
+
+// 時間を進める
+void AnimationGraph::Update( float deltaTime )
+{
+    for( auto& node : mNodes )
+    {
+        if( node.mType == NodeType::kClip )
+        {
+            node.mTime += deltaTime * node.mSpeed;
+            auto duration = node.mSampler.GetDuration();
+            if( node.mIsLoop && duration > 0.0f )
+            {
+                node.mTime = std::fmod( node.mTime, duration );
+                if( node.mTime < 0.0f )
+                {
+                    node.mTime += duration;
+                }
+            }
+            else
+            {
+                node.mTime = std::clamp( node.mTime, 0.0f, duration );
+            }
+        }
+        else if( node.mType == NodeType::kCrossfade && node.mPrevInput != kInvalidIndex )
+        {
+            node.mFadeTime += deltaTime;
+            if( node.mFadeTime >= node.mFadeDuration )
+            {
+                node.mPrevInput = kInvalidIndex;
+            }
+        }
+    }
+}
+
+// 評価して姿勢へ書き込む
+void AnimationGraph::Evaluate( NodePose& pose, PosePool& pool )
+{
+    if( mRoot >= mNodes.size() ) return;
+
+    EvaluateNode( mRoot, pose, pool );
+    pose.MarkAllDirty();
+}
+
+// ノードを追加
+uint32_t AnimationGraph::AddNode( NodeType type, const std::vector<uint32_t>& inputs )
+{
+    // 入力は先に追加されたノードに限る(循環しない)
+    for( auto input : inputs )
+    {
+        if( input >= mNodes.size() ) return kInvalidIndex;
+    }
+
+    Node node = {};
+    node.mType = type;
+    node.mInputs = inputs;
+    node.mTime = 0.0f;
+    node.mSpeed = 1.0f;
+    node.mIsLoop = true;
+    node.mParamX = kInvalidIndex;
+    node.mParamY = kInvalidIndex;
+    node.mActiveInput = 0;
+    node.mPrevInput = kInvalidIndex;
+    node.mFadeTime = 0.0f;
+    node.mFadeDuration = 0.0f;
+    node.mWeightParam = kInvalidIndex;
+    node.mMaskIdx = kInvalidIndex;
+    mNodes.emplace_back( std::move( node ) );
+
+    // 最後に追加したノードをルートにしておく
+    mRoot = static_cast<uint32_t>( mNodes.size() - 1 );
+    return mRoot;
+}
+
+// ノードを評価
+void AnimationGraph::EvaluateNode( uint32_t nodeIdx, NodePose& pose, PosePool& pool )
+{
+    auto& node = mNodes[nodeIdx];
+    switch( node.mType )
+    {
+        case NodeType::kClip:
+            // チャンネルの無いノードはバインドポーズのまま
+            CopyLocal( mHierarchy->GetBindPose(), pose );
+            node.mSampler.Sample( node.mTime, pose );
+            break;
+
+        case NodeType::kBlend1D:
+        {
+            uint32_t idx0, idx1;
+            float t;
+            FindSegment( node.mPointsX, mParams[node.mParamX], idx0, idx1, t );
+            EvaluateBlend( node.mInputs[idx0], node.mInputs[idx1], t, nullptr, pose, pool );
+            break;
+        }
+
+        case NodeType::kBlend2D:
+        {
+            uint32_t x0, x1, y0, y1;
+            float tx, ty;
+            FindSegment( node.mPointsX, mParams[node.mParamX], x0, x1, tx );
+            FindSegment( node.mPointsY, mParams[node.mParamY], y0, y1, ty );
+            auto width = static_cast<uint32_t>( node.mPointsX.size() );
+
+            // 行ごとにX方向を補間してからY方向を補間する
+            auto row0 = ty < 1.0f - kMinWeight ? y0 : y1;
+            EvaluateBlend( node.mInputs[row0 * width + x0], node.mInputs[row0 * width + x1], tx, nullptr, pose, pool );
+            if( ty >= kMinWeight && ty < 1.0f - kMinWeight )
+            {
+                auto rowPose = pool.Acquire( mHierarchy->GetCount() );
+                EvaluateBlend( node.mInputs[y1 * width + x0], node.mInputs[y1 * width + x1], tx, nullptr, *rowPose, pool );
+                BlendPose( pose, *rowPose, ty, nullptr );
+                pool.Release( rowPose );
+            }
+            break;
+        }
+
+        case NodeType::kCrossfade:
+            if( node.mPrevInput == kInvalidIndex || node.mFadeDuration <= 0.0f )
+            {
+                EvaluateNode( node.mInputs[node.mActiveInput], pose, pool );
+            }
+            else
+            {
+                auto t = std::clamp( node.mFadeTime / node.mFadeDuration, 0.0f, 1.0f );
+                EvaluateBlend( node.mInputs[node.mPrevInput], node.mInputs[node.mActiveInput], t, nullptr, pose, pool );
+            }
+            break;
+
+        case NodeType::kAdditive:
+        {
+            EvaluateNode( node.mInputs[0], pose, pool );
+            auto weight = mParams[node.mWeightParam];
+            if( std::abs( weight ) < kMinWeight ) break;
+
+            auto mask = node.mMaskIdx != kInvalidIndex ? &mMasks[node.mMaskIdx] : nullptr;
+            auto additivePose = pool.Acquire( mHierarchy->GetCount() );
+            EvaluateNode( node.mInputs[1], *additivePose, pool );
+            AddPose( pose, *additivePose, mHierarchy->GetBindPose(), weight, mask );
+            pool.Release( additivePose );
+            break;
+        }
+
+        case NodeType::kLayer:
+        {
+            auto weight = std::clamp( mParams[node.mWeightParam], 0.0f, 1.0f );
+            auto mask = node.mMaskIdx != kInvalidIndex ? &mMasks[node.mMaskIdx] : nullptr;
+            EvaluateBlend( node.mInputs[0], node.mInputs[1], weight, mask, pose, pool );
+            break;
+        }
+    }
+}
+
+// 2つのノードを評価して補間
+void AnimationGraph::EvaluateBlend( uint32_t a, uint32_t b, float t, const std::vector<float>* mask, NodePose& pose, PosePool& pool )
+{
+    // 重みがほぼ0か1なら片方だけ評価する(マスクがあれば b だけにはできない)
+    if( a == b || t < kMinWeight )
+    {
+        EvaluateNode( a, pose, pool );
+        return;
+    }
+    if( !mask && t > 1.0f - kMinWeight )
+    {
+        EvaluateNode( b, pose, pool );
+        return;
+    }
+
+    EvaluateNode( a, pose, pool );
+    auto other = pool.Acquire( mHierarchy->GetCount() );
+    EvaluateNode( b, *other, pool );
+    BlendPose( pose, *other, t, mask );
+    pool.Release( other );
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "AnimationSampler.h"
+#include "PosePool.h"
+
+/// <summary>
+/// アニメーションのブレンドグラフ(キャラクターごとに1つ持つ)
+/// ノードは入力より後に追加し、ルートから再帰的に評価する
+/// 作業用の姿勢はプールから借りるので、評価中にメモリを確保しない
+/// </summary>
+class AnimationGraph
+{
+   public:
+    // 無効なインデックス
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    /// <summary>
+    /// ノードの種類
+    /// </summary>
+    enum class NodeType : uint8_t
+    {
+        // クリップの再生
+        kClip,
+        // 1次元のブレンドスペース
+        kBlend1D,
+        // 2次元のブレンドスペース(格子)
+        kBlend2D,
+        // 入力の切り替え(クロスフェード)
+        kCrossfade,
+        // 加算レイヤー(バインドポーズとの差分を足す)
+        kAdditive,
+        // 上書きレイヤー
+        kLayer,
+    };
+
+   private:
+    // これより小さい重みの入力は評価しない
+    static constexpr float kMinWeight = 1e-4f;
+
+    /// <summary>
+    /// グラフのノード
+    /// </summary>
+    struct Node
+    {
+        NodeType mType;
+        // 入力のノード
+        std::vector<uint32_t> mInputs;
+
+        // クリップ
+        AnimationSampler mSampler;
+        float mTime;
+        float mSpeed;
+        bool mIsLoop;
+
+        // ブレンドスペースのパラメータと入力の位置(2次元はX方向の位置、Y方向の位置の順)
+        uint32_t mParamX;
+        uint32_t mParamY;
+        std::vector<float> mPointsX;
+        std::vector<float> mPointsY;
+
+        // クロスフェード
+        uint32_t mActiveInput;
+        uint32_t mPrevInput;
+        float mFadeTime;
+        float mFadeDuration;
+
+        // レイヤーの重みのパラメータとマスク
+        uint32_t mWeightParam;
+        uint32_t mMaskIdx;
+    };
+
+    // ノードの階層
+    const NodeHierarchy* mHierarchy;
+    // グラフのノード
+    std::vector<Node> mNodes;
+    // ルートのノード
+    uint32_t mRoot;
+    // パラメータ
+    std::vector<float> mParams;
+    // マスク(ノードごとの重み)
+    std::vector<std::vector<float>> mMasks;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    AnimationGraph();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~AnimationGraph() = default;
+
+    /// <summary>
+    /// 作成
+    /// </summary>
+    /// <param name="hierarchy">ノードの階層</param>
+    /// <returns>成否</returns>
+    bool Create( const NodeHierarchy* hierarchy );
+
+    /// <summary>
+    /// パラメータを追加
+    /// </summary>
+    /// <param name="value">初期値</param>
+    /// <returns>パラメータのインデックス</returns>
+    uint32_t AddParameter( float value );
+
+    /// <summary>
+    /// マスクを追加(指定したノードとその子孫に重みを付ける)
+    /// </summary>
+    /// <param name="rootNodeIdx">ノードのインデックス</param>
+    /// <param name="weight">重み</param>
+    /// <returns>マスクのインデックス</returns>
+    uint32_t AddMask( int32_t rootNodeIdx, float weight = 1.0f );
+
+    /// <summary>
+    /// クリップのノードを追加
+    /// </summary>
+    /// <param name="clip">クリップ</param>
+    /// <param name="speed">再生速度</param>
+    /// <param name="isLoop">ループするか</param>
+    /// <returns>ノードのインデックス</returns>
+    uint32_t AddClip( const CompressedAnimationClip* clip, float speed = 1.0f, bool isLoop = true );
+
+    /// <summary>
+    /// 1次元のブレンドスペースを追加
+    /// </summary>
+    /// <param name="param">パラメータ</param>
+    /// <param name="inputs">入力のノード</param>
+    /// <param name="points">入力の位置(昇順)</param>
+    /// <returns>ノードのインデックス(失敗したらkInvalidIndex)</returns>
+    uint32_t AddBlend1D( uint32_t param, const std::vector<uint32_t>& inputs, const std::vector<float>& points );
+
+    /// <summary>
+    /// 2次元のブレンドスペースを追加(格子の4点を双線形補間)
+    /// </summary>
+    /// <param name="paramX">X方向のパラメータ</param>
+    /// <param name="paramY">Y方向のパラメータ</param>
+    /// <param name="inputs">入力のノード(Y方向の行ごとに、X方向に並べる)</param>
+    /// <param name="pointsX">X方向の位置(昇順)</param>
+    /// <param name="pointsY">Y方向の位置(昇順)</param>
+    /// <returns>ノードのインデックス(失敗したらkInvalidIndex)</returns>
+    uint32_t AddBlend2D( uint32_t paramX, uint32_t paramY, const std::vector<uint32_t>& inputs, const std::vector<float>& pointsX, const std::vector<float>& pointsY );
+
+    /// <summary>
+    /// クロスフェードのノードを追加
+    /// </summary>
+    /// <param name="inputs">切り替える入力のノード(最初のものが有効)</param>
+    /// <returns>ノードのインデックス(失敗したらkInvalidIndex)</returns>
+    uint32_t AddCrossfade( const std::vector<uint32_t>& inputs );
+
+    /// <summary>
+    /// 加算レイヤーを追加
+    /// </summary>
+    /// <param name="base">元のノード</param>
+    /// <param name="additive">加算するノード(バインドポーズとの差分を使う)</param>
+    /// <param name="weightParam">重みのパラメータ</param>
+    /// <param name="maskIdx">マスク(kInvalidIndexなら全身)</param>
+    /// <returns>ノードのインデックス(失敗したらkInvalidIndex)</returns>
+    uint32_t AddAdditive( uint32_t base, uint32_t additive, uint32_t weightParam, uint32_t maskIdx = kInvalidIndex );
+
+    /// <summary>
+    /// 上書きレイヤーを追加
+    /// </summary>
+    /// <param name="base">元のノード</param>
+    /// <param name="overlay">上書きするノード</param>
+    /// <param name="weightParam">重みのパラメータ</param>
+    /// <param name="maskIdx">マスク(kInvalidIndexなら全身)</param>
+    /// <returns>ノードのインデックス(失敗したらkInvalidIndex)</returns>
+    uint32_t AddLayer( uint32_t base, uint32_t overlay, uint32_t weightParam, uint32_t maskIdx = kInvalidIndex );
+
+    /// <summary>
+    /// クロスフェードを開始
+    /// </summary>
+    /// <param name="nodeIdx">クロスフェードのノード</param>
+    /// <param name="input">切り替え先(入力の番号)</param>
+    /// <param name="duration">時間(秒)</param>
+    void CrossFade( uint32_t nodeIdx, uint32_t input, float duration );
+
+    /// <summary>
+    /// 時間を進める
+    /// </summary>
+    /// <param name="deltaTime">デルタタイム</param>
+    void Update( float deltaTime );
+
+    /// <summary>
+    /// 評価して姿勢へ書き込む(すべてのノードの変更を通知する)
+    /// </summary>
+    /// <param name="pose">姿勢</param>
+    /// <param name="pool">作業用の姿勢のプール</param>
+    void Evaluate( NodePose& pose, PosePool& pool );
+
+    /// <summary>ルートのノードを設定</summary>
+    void SetRoot( uint32_t nodeIdx ) { mRoot = nodeIdx; }
+
+    /// <summary>パラメータを設定</summary>
+    void SetParameter( uint32_t param, float value ) { mParams[param] = value; }
+
+    /// <summary>パラメータを取得</summary>
+    float GetParameter( uint32_t param ) const { return mParams[param]; }
+
+    /// <summary>ノードの階層を取得</summary>
+    const NodeHierarchy* GetHierarchy() const { return mHierarchy; }
+
+   private:
+    /// <summary>
+    /// ノードを追加
+    /// </summary>
+    /// <param name="type">種類</param>
+    /// <param name="inputs">入力のノード</param>
+    /// <returns>ノードのインデックス(入力が不正ならkInvalidIndex)</returns>
+    uint32_t AddNode( NodeType type, const std::vector<uint32_t>& inputs );
+
+    /// <summary>
+    /// ノードを評価
+    /// </summary>
+    /// <param name="nodeIdx">ノードのインデックス</param>
+    /// <param name="pose">姿勢(出力)</param>
+    /// <param name="pool">作業用の姿勢のプール</param>
+    void EvaluateNode( uint32_t nodeIdx, NodePose& pose, PosePool& pool );
+
+    /// <summary>
+    /// 2つのノードを評価して補間
+    /// </summary>
+    /// <param name="a">ノード(割合0)</param>
+    /// <param name="b">ノード(割合1)</param>
+    /// <param name="t">割合</param>
+    /// <param name="mask">マスク(nullptrなら全身)</param>
+    /// <param name="pose">姿勢(出力)</param>
+    /// <param name="pool">作業用の姿勢のプール</param>
+    void EvaluateBlend( uint32_t a, uint32_t b, float t, const std::vector<float>* mask, NodePose& pose, PosePool& pool );
+};
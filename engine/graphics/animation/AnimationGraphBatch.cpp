@@ -0,0 +1,66 @@
+#include "AnimationGraphBatch.h"
+
+#include "utils/JobSystem.h"
+
+// コンストラクタ
+AnimationGraphBatch::AnimationGraphBatch()
+    : mItems()
+    , mChunkPools()
+{
+}
+
+// キャラクターを追加
+void AnimationGraphBatch::Add( AnimationGraph* graph, NodePose* pose )
+{
+    if( !graph || !pose || !graph->GetHierarchy() ) return;
+
+    mItems.emplace_back( Item{ graph, pose } );
+}
+
+// 時間を進めて評価し、モデル行列まで更新する
+void AnimationGraphBatch::Execute( float deltaTime, bool isParallel )
+{
+    auto count = static_cast<uint32_t>( mItems.size() );
+    auto chunkCount = ( count + kBatchSize - 1 ) / kBatchSize;
+    while( mChunkPools.size() < chunkCount )
+    {
+        mChunkPools.emplace_back( std::make_unique<PosePool>() );
+    }
+    if( count == 0 ) return;
+
+    if( !isParallel )
+    {
+        ExecuteRange( 0, count, deltaTime, *mChunkPools.front() );
+        return;
+    }
+
+    JobSystem::GetInstance().ParallelFor(
+        count, kBatchSize,
+        [&]( uint32_t begin, uint32_t end )
+        {
+            ExecuteRange( begin, end, deltaTime, *mChunkPools[begin / kBatchSize] );
+        } );
+}
+
+// プールが作成した姿勢の総数を取得
+uint32_t AnimationGraphBatch::GetPooledPoseCount() const
+{
+    uint32_t count = 0;
+    for( const auto& pool : mChunkPools )
+    {
+        count += pool->GetCreatedCount();
+    }
+    return count;
+}
+
+// 範囲のキャラクターを評価
+void AnimationGraphBatch::ExecuteRange( uint32_t begin, uint32_t end, float deltaTime, PosePool& pool )
+{
+    for( auto i = begin; i < end; ++i )
+    {
+        auto& item = mItems[i];
+        item.mGraph->Update( deltaTime );
+        item.mGraph->Evaluate( *item.mPose, pool );
+        item.mGraph->GetHierarchy()->UpdateModelMatrices( *item.mPose );
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "AnimationGraph.h"
+
+/// <summary>
+/// キャラクターのブレンドグラフの一括評価
+/// キャラクター単位でワーカースレッドへ振り分け、作業用の姿勢はジョブごとのプールを使い回す
+/// </summary>
+class AnimationGraphBatch
+{
+   private:
+    // 1ジョブあたりのキャラクター数
+    static constexpr uint32_t kBatchSize = 4;
+
+    /// <summary>
+    /// 評価するキャラクター
+    /// </summary>
+    struct Item
+    {
+        AnimationGraph* mGraph;
+        NodePose* mPose;
+    };
+
+    // 評価するキャラクター
+    std::vector<Item> mItems;
+    // ジョブごとの姿勢のプール(フレームをまたいで使い回す)
+    std::vector<std::unique_ptr<PosePool>> mChunkPools;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    AnimationGraphBatch();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~AnimationGraphBatch() = default;
+
+    /// <summary>
+    /// キャラクターを追加
+    /// </summary>
+    /// <param name="graph">ブレンドグラフ</param>
+    /// <param name="pose">書き込み先の姿勢</param>
+    void Add( AnimationGraph* graph, NodePose* pose );
+
+    /// <summary>
+    /// 時間を進めて評価し、モデル行列まで更新する(並列)
+    /// </summary>
+    /// <param name="deltaTime">デルタタイム</param>
+    /// <param name="isParallel">並列に実行するか</param>
+    void Execute( float deltaTime, bool isParallel = true );
+
+    /// <summary>
+    /// キャラクターをすべて削除(プールは残す)
+    /// </summary>
+    void Clear() { mItems.clear(); }
+
+    /// <summary>キャラクター数を取得</summary>
+    uint32_t GetCount() const { return static_cast<uint32_t>( mItems.size() ); }
+
+    /// <summary>プールが作成した姿勢の総数を取得</summary>
+    uint32_t GetPooledPoseCount() const;
+
+   private:
+    /// <summary>
+    /// 範囲のキャラクターを評価
+    /// </summary>
+    /// <param name="begin">先頭</param>
+    /// <param name="end">終端</param>
+    /// <param name="deltaTime">デルタタイム</param>
+    /// <param name="pool">姿勢のプール</param>
+    void ExecuteRange( uint32_t begin, uint32_t end, float deltaTime, PosePool& pool );
+};
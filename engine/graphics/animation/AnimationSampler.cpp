@@ -0,0 +1,140 @@
+#include "AnimationSampler.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// time を挟むキーの位置を探す(times[cursor] <= time < times[cursor + 1])
+// 前回より後ろの時間なら前回の位置から進めるだけ、戻ったときは二分探索
+float FindKey( const std::vector<float>& times, float time, uint32_t& cursor )
+{
+    auto count = static_cast<uint32_t>( times.size() );
+    if( cursor >= count || time < times[cursor] )
+    {
+        auto it = std::upper_bound( times.begin(), times.end(), time );
+        cursor = it == times.begin() ? 0 : static_cast<uint32_t>( it - times.begin() ) - 1;
+    }
+    else
+    {
+        while( cursor + 1 < count && times[cursor + 1] <= time )
+        {
+            ++cursor;
+        }
+    }
+
+    // 補間の割合
+    if( cursor + 1 >= count ) return 0.0f;
+
+    auto span = times[cursor + 1] - times[cursor];
+    if( span <= 0.0f ) return 0.0f;
+
+    return std::clamp( ( time - times[cursor] ) / span, 0.0f, 1.0f );
+}
+
+// Vector3の線形補間
+Vector3 LerpVector3( const Vector3& a, const Vector3& b, float t )
+{
+    return a + ( b - a ) * t;
+}
+
+}  // namespace
+
+// コンストラクタ
+AnimationSampler::AnimationSampler()
+    : mClip( nullptr )
+    , mCompressedClip( nullptr )
+    , mCursors()
+{
+}
+
+// クリップを設定
+void AnimationSampler::SetClip( const AnimationClip* clip )
+{
+    mClip = clip;
+    mCompressedClip = nullptr;
+    mCursors.assign( clip ? clip->GetChannels().size() : 0, Cursor{ 0, 0, 0 } );
+}
+
+// 圧縮したクリップを設定
+void AnimationSampler::SetClip( const CompressedAnimationClip* clip )
+{
+    mClip = nullptr;
+    mCompressedClip = clip;
+    mCursors.assign( clip ? clip->GetChannels().size() : 0, Cursor{ 0, 0, 0 } );
+}
+
+// クリップの長さを取得
+float AnimationSampler::GetDuration() const
+{
+    if( mClip ) return mClip->GetDuration();
+    if( mCompressedClip ) return mCompressedClip->GetDuration();
+    return 0.0f;
+}
+
+// サンプリング
+void AnimationSampler::Sample( float time, NodePose& pose )
+{
+    if( mCompressedClip )
+    {
+        SampleCompressed( time, pose );
+        return;
+    }
+    if( !mClip ) return;
+
+    const auto& channels = mClip->GetChannels();
+    for( size_t i = 0; i < channels.size(); ++i )
+    {
+        const auto& channel = channels[i];
+        auto& cursor = mCursors[i];
+        auto nodeIdx = channel.mNodeIdx;
+        if( nodeIdx < 0 || nodeIdx >= static_cast<int32_t>( pose.mModelMats.size() ) ) continue;
+
+        if( !channel.mPositions.empty() )
+        {
+            auto t = FindKey( channel.mPositionTimes, time, cursor.mPosition );
+            auto next = ( std::min )( cursor.mPosition + 1, static_cast<uint32_t>( channel.mPositions.size() ) - 1 );
+            pose.mTranslates[nodeIdx] = LerpVector3( channel.mPositions[cursor.mPosition], channel.mPositions[next], t );
+        }
+        if( !channel.mRotations.empty() )
+        {
+            auto t = FindKey( channel.mRotationTimes, time, cursor.mRotation );
+            auto next = ( std::min )( cursor.mRotation + 1, static_cast<uint32_t>( channel.mRotations.size() ) - 1 );
+            pose.mRotates[nodeIdx] = Slerp( channel.mRotations[cursor.mRotation], channel.mRotations[next], t );
+        }
+        if( !channel.mScales.empty() )
+        {
+            auto t = FindKey( channel.mScaleTimes, time, cursor.mScale );
+            auto next = ( std::min )( cursor.mScale + 1, static_cast<uint32_t>( channel.mScales.size() ) - 1 );
+            pose.mScales[nodeIdx] = LerpVector3( channel.mScales[cursor.mScale], channel.mScales[next], t );
+        }
+        pose.MarkDirty( nodeIdx );
+    }
+}
+
+// 圧縮したクリップをサンプリング
+void AnimationSampler::SampleCompressed( float time, NodePose& pose )
+{
+    const auto& channels = mCompressedClip->GetChannels();
+    for( size_t i = 0; i < channels.size(); ++i )
+    {
+        const auto& channel = channels[i];
+        auto& cursor = mCursors[i];
+        auto nodeIdx = channel.mNodeIdx;
+        if( nodeIdx < 0 || nodeIdx >= static_cast<int32_t>( pose.mModelMats.size() ) ) continue;
+
+        if( channel.mPosition.mKeyCount > 0 )
+        {
+            pose.mTranslates[nodeIdx] = mCompressedClip->SampleVector3( channel.mPosition, time, cursor.mPosition );
+        }
+        if( channel.mRotation.mKeyCount > 0 )
+        {
+            pose.mRotates[nodeIdx] = mCompressedClip->SampleRotation( channel.mRotation, time, cursor.mRotation );
+        }
+        if( channel.mScale.mKeyCount > 0 )
+        {
+            pose.mScales[nodeIdx] = mCompressedClip->SampleVector3( channel.mScale, time, cursor.mScale );
+        }
+        pose.MarkDirty( nodeIdx );
+    }
+}
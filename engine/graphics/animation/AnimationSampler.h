@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "AnimationClip.h"
+#include "CompressedAnimationClip.h"
+#include "graphics/model/NodeHierarchy.h"
+
+/// <summary>
+/// アニメーションクリップのサンプラー
+/// チャンネルごとに直前のキーの位置を覚えておき、順再生では前回の位置から進めるだけで済ませる
+/// 圧縮したクリップはキーを展開せずにそのままサンプリングする
+/// </summary>
+class AnimationSampler
+{
+   private:
+    /// <summary>
+    /// チャンネルごとのキーの位置
+    /// </summary>
+    struct Cursor
+    {
+        uint32_t mPosition;
+        uint32_t mRotation;
+        uint32_t mScale;
+    };
+
+    // クリップ
+    const AnimationClip* mClip;
+    // 圧縮したクリップ
+    const CompressedAnimationClip* mCompressedClip;
+    // キーの位置
+    std::vector<Cursor> mCursors;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    AnimationSampler();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~AnimationSampler() = default;
+
+    /// <summary>
+    /// クリップを設定
+    /// </summary>
+    /// <param name="clip">クリップ</param>
+    void SetClip( const AnimationClip* clip );
+
+    /// <summary>
+    /// 圧縮したクリップを設定
+    /// </summary>
+    /// <param name="clip">クリップ</param>
+    void SetClip( const CompressedAnimationClip* clip );
+
+    /// <summary>
+    /// サンプリングして姿勢へ書き込む(書き込んだノードは変更を通知する)
+    /// </summary>
+    /// <param name="time">時間(秒)</param>
+    /// <param name="pose">姿勢</param>
+    void Sample( float time, NodePose& pose );
+
+    /// <summary>クリップが設定されているか</summary>
+    bool HasClip() const { return mClip || mCompressedClip; }
+
+    /// <summary>クリップの長さ(秒)を取得</summary>
+    float GetDuration() const;
+
+   private:
+    /// <summary>
+    /// 圧縮したクリップをサンプリング
+    /// </summary>
+    /// <param name="time">時間(秒)</param>
+    /// <param name="pose">姿勢</param>
+    void SampleCompressed( float time, NodePose& pose );
+};
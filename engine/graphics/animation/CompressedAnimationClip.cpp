@@ -0,0 +1,399 @@
+#include "CompressedAnimationClip.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "graphics/model/NodeHierarchy.h"
+
+namespace
+{
+
+// 16bitの量子化の最大値
+const float kQuantizeMax16 = 65535.0f;
+// 15bitの量子化の最大値
+const float kQuantizeMax15 = 32767.0f;
+// 最大成分以外の成分の範囲(±1/√2)
+const float kSmallestThreeRange = 0.70710678f;
+
+// 範囲で量子化
+uint16_t Quantize( float v, float min, float extent )
+{
+    if( extent <= 0.0f ) return 0;
+
+    auto n = std::clamp( ( v - min ) / extent, 0.0f, 1.0f );
+    return static_cast<uint16_t>( n * kQuantizeMax16 + 0.5f );
+}
+
+// 回転の差(角度)
+float GetAngle( const Quaternion& a, const Quaternion& b )
+{
+    auto cos = ( std::min )( std::abs( Dot( a, b ) ), 1.0f );
+    return 2.0f * std::acos( cos );
+}
+
+// Vector3の線形補間
+Vector3 LerpVector3( const Vector3& a, const Vector3& b, float t )
+{
+    return a + ( b - a ) * t;
+}
+
+// 線形補間で再現できるキーを間引く
+// isSegmentValid( a, b ) は a と b の間のキーが a と b の補間で許容誤差内に収まるか
+template <class F>
+std::vector<uint32_t> ReduceKeys( uint32_t count, F&& isSegmentValid )
+{
+    std::vector<uint32_t> kept;
+    kept.emplace_back( 0 );
+
+    // 伸ばせるところまで区間を伸ばしていく
+    uint32_t a = 0;
+    while( a + 1 < count )
+    {
+        auto b = a + 1;
+        while( b + 1 < count && isSegmentValid( a, b + 1 ) )
+        {
+            ++b;
+        }
+        kept.emplace_back( b );
+        a = b;
+    }
+    return kept;
+}
+
+// 量子化した時間での補間の割合
+float GetSegmentT( const std::vector<uint16_t>& times, uint32_t a, uint32_t b, uint32_t i )
+{
+    auto span = static_cast<float>( times[b] ) - static_cast<float>( times[a] );
+    if( span <= 0.0f ) return 0.0f;
+
+    return ( static_cast<float>( times[i] ) - static_cast<float>( times[a] ) ) / span;
+}
+
+}  // namespace
+
+// コンストラクタ
+CompressedAnimationClip::CompressedAnimationClip()
+    : mName()
+    , mDuration( 0.0f )
+    , mTimeToKey( 0.0f )
+    , mChannels()
+    , mRanges()
+    , mTimes()
+    , mValues()
+{
+}
+
+// 回転を48bitに量子化(最大成分の番号2bitと、残り3成分を15bitずつ)
+void CompressedAnimationClip::EncodeRotation( const Quaternion& rotate, uint16_t* dst )
+{
+    auto q = rotate;
+    q.Normalize();
+    float c[4] = { q.w, q.x, q.y, q.z };
+    uint32_t largest = 0;
+    for( uint32_t i = 1; i < 4; ++i )
+    {
+        if( std::abs( c[i] ) > std::abs( c[largest] ) )
+        {
+            largest = i;
+        }
+    }
+
+    // 最大成分が正になる向きにそろえれば、残りの3成分から復元できる
+    auto sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+    uint64_t bits = largest;
+    for( uint32_t i = 0; i < 4; ++i )
+    {
+        if( i == largest ) continue;
+
+        auto n = std::clamp( ( c[i] * sign + kSmallestThreeRange ) / ( 2.0f * kSmallestThreeRange ), 0.0f, 1.0f );
+        bits = ( bits << 15 ) | static_cast<uint64_t>( n * kQuantizeMax15 + 0.5f );
+    }
+    dst[0] = static_cast<uint16_t>( bits >> 32 );
+    dst[1] = static_cast<uint16_t>( bits >> 16 );
+    dst[2] = static_cast<uint16_t>( bits );
+}
+
+// 48bitの回転を復元
+Quaternion CompressedAnimationClip::DecodeRotation( const uint16_t* src )
+{
+    auto bits = ( static_cast<uint64_t>( src[0] ) << 32 ) | ( static_cast<uint64_t>( src[1] ) << 16 ) | src[2];
+    auto scale = 2.0f * kSmallestThreeRange / kQuantizeMax15;
+    auto a = static_cast<float>( ( bits >> 30 ) & 0x7fff ) * scale - kSmallestThreeRange;
+    auto b = static_cast<float>( ( bits >> 15 ) & 0x7fff ) * scale - kSmallestThreeRange;
+    auto c = static_cast<float>( bits & 0x7fff ) * scale - kSmallestThreeRange;
+    // 残りの3成分から復元するので正規化済みになる
+    auto d = std::sqrt( ( std::max )( 1.0f - a * a - b * b - c * c, 0.0f ) );
+    switch( bits >> 45 )
+    {
+        case 0:
+            return Quaternion( d, a, b, c );
+        case 1:
+            return Quaternion( a, d, b, c );
+        case 2:
+            return Quaternion( a, b, d, c );
+        default:
+            return Quaternion( a, b, c, d );
+    }
+}
+
+// 圧縮して作成
+bool CompressedAnimationClip::Create( const AnimationClip& clip, const NodeHierarchy& nodes, const AnimationCompressionSettings& settings )
+{
+    mName = clip.GetName();
+    mDuration = clip.GetDuration();
+    mTimeToKey = mDuration > 0.0f ? kTimeScale / mDuration : 0.0f;
+    mChannels.clear();
+    mRanges.clear();
+    mTimes.clear();
+    mValues.clear();
+
+    for( const auto& channel : clip.GetChannels() )
+    {
+        if( channel.mPositionTimes.size() > UINT16_MAX ||
+            channel.mRotationTimes.size() > UINT16_MAX ||
+            channel.mScaleTimes.size() > UINT16_MAX )
+        {
+            return false;
+        }
+    }
+
+    // ボーンの先端までの長さ(子孫の中で最も遠いもの)
+    // 親は必ず先に並ぶので、後ろから子の長さを親へ伝える
+    const auto& parents = nodes.GetParents();
+    const auto& bindPose = nodes.GetBindPose();
+    std::vector<float> reach( nodes.GetCount(), 0.0f );
+    for( auto i = nodes.GetCount(); i-- > 0; )
+    {
+        auto parent = parents[i];
+        if( parent == NodeHierarchy::kInvalidIndex ) continue;
+
+        reach[parent] = ( std::max )( reach[parent], Length( bindPose.mTranslates[i] ) + reach[i] );
+    }
+
+    // 回転・スケールの誤差は先端の移動量で測る
+    for( const auto& channel : clip.GetChannels() )
+    {
+        auto length = settings.mMinBoneLength;
+        if( channel.mNodeIdx >= 0 && static_cast<uint32_t>( channel.mNodeIdx ) < reach.size() )
+        {
+            length = ( std::max )( length, reach[channel.mNodeIdx] );
+        }
+
+        Channel compressed = {};
+        compressed.mNodeIdx = channel.mNodeIdx;
+        compressed.mPosition = AddVector3Track( channel.mPositionTimes, channel.mPositions, settings.mTolerance );
+        compressed.mRotation = AddRotationTrack( channel.mRotationTimes, channel.mRotations, settings.mTolerance / length );
+        compressed.mScale = AddVector3Track( channel.mScaleTimes, channel.mScales, settings.mTolerance / length );
+        mChannels.emplace_back( compressed );
+    }
+    return true;
+}
+
+// トラックの座標・スケールをサンプリング
+Vector3 CompressedAnimationClip::SampleVector3( const Track& track, float time, uint32_t& cursor ) const
+{
+    const auto& range = mRanges[track.mRangeIdx];
+    auto decode = [&]( uint32_t key )
+    {
+        const auto* v = &mValues[( track.mKeyOffset + key ) * kValueStride];
+        auto scale = 1.0f / kQuantizeMax16;
+        return Vector3(
+            range.mMin.x + range.mExtent.x * ( v[0] * scale ),
+            range.mMin.y + range.mExtent.y * ( v[1] * scale ),
+            range.mMin.z + range.mExtent.z * ( v[2] * scale ) );
+    };
+    // 変化しないトラックはキーが1つだけ
+    if( track.mKeyCount == 1 ) return decode( 0 );
+
+    auto t = FindKey( track, time, cursor );
+    auto next = ( std::min )( cursor + 1, static_cast<uint32_t>( track.mKeyCount ) - 1 );
+    return LerpVector3( decode( cursor ), decode( next ), t );
+}
+
+// トラックの回転をサンプリング
+Quaternion CompressedAnimationClip::SampleRotation( const Track& track, float time, uint32_t& cursor ) const
+{
+    // 変化しないトラックはキーが1つだけ
+    if( track.mKeyCount == 1 ) return DecodeRotation( &mValues[track.mKeyOffset * kValueStride] );
+
+    auto t = FindKey( track, time, cursor );
+    auto next = ( std::min )( cursor + 1, static_cast<uint32_t>( track.mKeyCount ) - 1 );
+    auto a = DecodeRotation( &mValues[( track.mKeyOffset + cursor ) * kValueStride] );
+    auto b = DecodeRotation( &mValues[( track.mKeyOffset + next ) * kValueStride] );
+    return Slerp( a, b, t );
+}
+
+// 使用メモリを取得
+size_t CompressedAnimationClip::GetMemorySize() const
+{
+    return mChannels.size() * sizeof( Channel ) +
+           mRanges.size() * sizeof( Range ) +
+           mTimes.size() * sizeof( uint16_t ) +
+           mValues.size() * sizeof( uint16_t );
+}
+
+// 時間を挟むキーを探す
+float CompressedAnimationClip::FindKey( const Track& track, float time, uint32_t& cursor ) const
+{
+    auto times = mTimes.data() + track.mKeyOffset;
+    uint32_t count = track.mKeyCount;
+    auto u = time * mTimeToKey;
+
+    // 前回より後ろの時間なら前回の位置から進めるだけ、戻ったときは二分探索
+    if( cursor >= count || u < times[cursor] )
+    {
+        auto it = std::upper_bound( times, times + count, u );
+        cursor = it == times ? 0 : static_cast<uint32_t>( it - times ) - 1;
+    }
+    else
+    {
+        while( cursor + 1 < count && times[cursor + 1] <= u )
+        {
+            ++cursor;
+        }
+    }
+
+    // 補間の割合
+    if( cursor + 1 >= count ) return 0.0f;
+
+    auto span = static_cast<float>( times[cursor + 1] - times[cursor] );
+    if( span <= 0.0f ) return 0.0f;
+
+    return std::clamp( ( u - times[cursor] ) / span, 0.0f, 1.0f );
+}
+
+// 時間を量子化したキー列に変換
+std::vector<uint16_t> CompressedAnimationClip::QuantizeTimes( const std::vector<float>& times ) const
+{
+    std::vector<uint16_t> quantized( times.size() );
+    for( size_t i = 0; i < times.size(); ++i )
+    {
+        quantized[i] = Quantize( times[i], 0.0f, mDuration );
+    }
+    return quantized;
+}
+
+// 座標・スケールのトラックを作成
+CompressedAnimationClip::Track CompressedAnimationClip::AddVector3Track( const std::vector<float>& times, const std::vector<Vector3>& values, float tolerance )
+{
+    Track track = {};
+    track.mKeyOffset = static_cast<uint32_t>( mTimes.size() );
+    if( values.empty() ) return track;
+
+    // 範囲で量子化
+    Range range = {};
+    range.mMin = values[0];
+    auto max = values[0];
+    for( const auto& v : values )
+    {
+        range.mMin = Vector3( ( std::min )( range.mMin.x, v.x ), ( std::min )( range.mMin.y, v.y ), ( std::min )( range.mMin.z, v.z ) );
+        max = Vector3( ( std::max )( max.x, v.x ), ( std::max )( max.y, v.y ), ( std::max )( max.z, v.z ) );
+    }
+    range.mExtent = max - range.mMin;
+    track.mRangeIdx = static_cast<uint16_t>( mRanges.size() );
+    mRanges.emplace_back( range );
+
+    auto count = static_cast<uint32_t>( values.size() );
+    std::vector<uint16_t> quantized( count * kValueStride );
+    std::vector<Vector3> decoded( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        auto* q = &quantized[i * kValueStride];
+        q[0] = Quantize( values[i].x, range.mMin.x, range.mExtent.x );
+        q[1] = Quantize( values[i].y, range.mMin.y, range.mExtent.y );
+        q[2] = Quantize( values[i].z, range.mMin.z, range.mExtent.z );
+        decoded[i] = Vector3(
+            range.mMin.x + range.mExtent.x * ( q[0] / kQuantizeMax16 ),
+            range.mMin.y + range.mExtent.y * ( q[1] / kQuantizeMax16 ),
+            range.mMin.z + range.mExtent.z * ( q[2] / kQuantizeMax16 ) );
+    }
+
+    // 量子化した値同士の補間で元の値を再現できるキーを間引く
+    auto quantizedTimes = QuantizeTimes( times );
+    std::vector<uint32_t> kept;
+    auto isConstant = std::all_of(
+        values.begin(), values.end(),
+        [&]( const Vector3& v )
+        {
+            return Length( v - decoded[0] ) <= tolerance;
+        } );
+    if( isConstant )
+    {
+        kept.emplace_back( 0 );
+    }
+    else
+    {
+        kept = ReduceKeys(
+            count,
+            [&]( uint32_t a, uint32_t b )
+            {
+                for( auto i = a + 1; i < b; ++i )
+                {
+                    auto v = LerpVector3( decoded[a], decoded[b], GetSegmentT( quantizedTimes, a, b, i ) );
+                    if( Length( v - values[i] ) > tolerance ) return false;
+                }
+                return true;
+            } );
+    }
+
+    for( auto i : kept )
+    {
+        mTimes.emplace_back( quantizedTimes[i] );
+        mValues.insert( mValues.end(), quantized.begin() + i * kValueStride, quantized.begin() + ( i + 1 ) * kValueStride );
+    }
+    track.mKeyCount = static_cast<uint16_t>( kept.size() );
+    return track;
+}
+
+// 回転のトラックを作成
+CompressedAnimationClip::Track CompressedAnimationClip::AddRotationTrack( const std::vector<float>& times, const std::vector<Quaternion>& values, float tolerance )
+{
+    Track track = {};
+    track.mKeyOffset = static_cast<uint32_t>( mTimes.size() );
+    if( values.empty() ) return track;
+
+    auto count = static_cast<uint32_t>( values.size() );
+    std::vector<uint16_t> quantized( count * kValueStride );
+    std::vector<Quaternion> decoded( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        EncodeRotation( values[i], &quantized[i * kValueStride] );
+        decoded[i] = DecodeRotation( &quantized[i * kValueStride] );
+    }
+
+    // 量子化した値同士の補間で元の値を再現できるキーを間引く
+    auto quantizedTimes = QuantizeTimes( times );
+    std::vector<uint32_t> kept;
+    auto isConstant = std::all_of(
+        values.begin(), values.end(),
+        [&]( const Quaternion& q )
+        {
+            return GetAngle( q, decoded[0] ) <= tolerance;
+        } );
+    if( isConstant )
+    {
+        kept.emplace_back( 0 );
+    }
+    else
+    {
+        kept = ReduceKeys(
+            count,
+            [&]( uint32_t a, uint32_t b )
+            {
+                for( auto i = a + 1; i < b; ++i )
+                {
+                    auto q = Slerp( decoded[a], decoded[b], GetSegmentT( quantizedTimes, a, b, i ) );
+                    if( GetAngle( q, values[i] ) > tolerance ) return false;
+                }
+                return true;
+            } );
+    }
+
+    for( auto i : kept )
+    {
+        mTimes.emplace_back( quantizedTimes[i] );
+        mValues.insert( mValues.end(), quantized.begin() + i * kValueStride, quantized.begin() + ( i + 1 ) * kValueStride );
+    }
+    track.mKeyCount = static_cast<uint16_t>( kept.size() );
+    return track;
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AnimationClip.h"
+
+class NodeHierarchy;
+
+/// <summary>
+/// 圧縮の設定
+/// </summary>
+struct AnimationCompressionSettings
+{
+    // 許容誤差(ボーンの先端の移動量、モデル空間の単位)
+    float mTolerance = 0.01f;
+    // 回転・スケールの誤差を測るときの最小のボーンの長さ
+    float mMinBoneLength = 1.0f;
+};
+
+/// <summary>
+/// 圧縮したアニメーションクリップ
+/// キーは線形補間で再現できるものを間引き、時間は16bit、回転は最大成分を省いた48bit、
+/// 座標・スケールはトラックごとの範囲で量子化した48bitで持つ
+/// </summary>
+class CompressedAnimationClip
+{
+    friend class ModelData;
+
+   public:
+    /// <summary>
+    /// 1要素分のキー列(mTimes・mValuesの範囲)
+    /// </summary>
+    struct Track
+    {
+        uint32_t mKeyOffset;
+        uint16_t mKeyCount;
+        // 量子化の範囲のインデックス(回転は未使用)
+        uint16_t mRangeIdx;
+    };
+
+    /// <summary>
+    /// ノード1つ分のトラック
+    /// </summary>
+    struct Channel
+    {
+        int32_t mNodeIdx;
+        Track mPosition;
+        Track mRotation;
+        Track mScale;
+    };
+
+    // 1キーあたりの値の要素数(48bit)
+    static constexpr uint32_t kValueStride = 3;
+
+   private:
+    // 時間の量子化の最大値
+    static constexpr float kTimeScale = 65535.0f;
+
+    /// <summary>
+    /// 量子化の範囲
+    /// </summary>
+    struct Range
+    {
+        Vector3 mMin;
+        Vector3 mExtent;
+    };
+
+    // クリップ名
+    std::string mName;
+    // 長さ(秒)
+    float mDuration;
+    // 秒から量子化した時間への倍率
+    float mTimeToKey;
+    // チャンネル
+    std::vector<Channel> mChannels;
+    // 量子化の範囲
+    std::vector<Range> mRanges;
+    // キーの時間(長さを0～65535に量子化)
+    std::vector<uint16_t> mTimes;
+    // キーの値(1キーあたりkValueStride個)
+    std::vector<uint16_t> mValues;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    CompressedAnimationClip();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~CompressedAnimationClip() = default;
+
+    /// <summary>
+    /// 圧縮して作成
+    /// </summary>
+    /// <param name="clip">元のクリップ</param>
+    /// <param name="nodes">ノードの階層(ボーンの長さの計算用)</param>
+    /// <param name="settings">圧縮の設定</param>
+    /// <returns>成否</returns>
+    bool Create( const AnimationClip& clip, const NodeHierarchy& nodes, const AnimationCompressionSettings& settings = {} );
+
+    /// <summary>
+    /// トラックの座標・スケールをサンプリング
+    /// </summary>
+    /// <param name="track">トラック</param>
+    /// <param name="time">時間(秒)</param>
+    /// <param name="cursor">前回のキーの位置(入出力)</param>
+    /// <returns>値</returns>
+    Vector3 SampleVector3( const Track& track, float time, uint32_t& cursor ) const;
+
+    /// <summary>
+    /// トラックの回転をサンプリング
+    /// </summary>
+    /// <param name="track">トラック</param>
+    /// <param name="time">時間(秒)</param>
+    /// <param name="cursor">前回のキーの位置(入出力)</param>
+    /// <returns>回転</returns>
+    Quaternion SampleRotation( const Track& track, float time, uint32_t& cursor ) const;
+
+    /// <summary>
+    /// 回転を48bitに量子化(最大成分の番号2bitと、残り3成分を15bitずつ)
+    /// 最大成分が正になる向きにそろえるので、復元した回転は符号が反転していることがある
+    /// </summary>
+    /// <param name="rotate">回転</param>
+    /// <param name="dst">書き込み先(kValueStride個)</param>
+    static void EncodeRotation( const Quaternion& rotate, uint16_t* dst );
+
+    /// <summary>
+    /// 48bitの回転を復元
+    /// </summary>
+    /// <param name="src">量子化した回転(kValueStride個)</param>
+    /// <returns>回転(正規化済み)</returns>
+    static Quaternion DecodeRotation( const uint16_t* src );
+
+    /// <summary>クリップ名を取得</summary>
+    const std::string& GetName() const { return mName; }
+
+    /// <summary>長さ(秒)を取得</summary>
+    float GetDuration() const { return mDuration; }
+
+    /// <summary>チャンネルを取得</summary>
+    const std::vector<Channel>& GetChannels() const { return mChannels; }
+
+    /// <summary>キーの総数を取得</summary>
+    uint32_t GetKeyCount() const { return static_cast<uint32_t>( mTimes.size() ); }
+
+    /// <summary>使用メモリ(バイト)を取得</summary>
+    size_t GetMemorySize() const;
+
+   private:
+    /// <summary>
+    /// 時間を挟むキーを探す
+    /// </summary>
+    /// <param name="track">トラック</param>
+    /// <param name="time">時間(秒)</param>
+    /// <param name="cursor">前回のキーの位置(入出力、トラックの先頭から)</param>
+    /// <returns>補間の割合</returns>
+    float FindKey( const Track& track, float time, uint32_t& cursor ) const;
+
+    /// <summary>
+    /// 時間を量子化したキー列に変換
+    /// </summary>
+    /// <param name="times">時間(秒)</param>
+    /// <returns>量子化した時間</returns>
+    std::vector<uint16_t> QuantizeTimes( const std::vector<float>& times ) const;
+
+    /// <summary>
+    /// 座標・スケールのトラックを作成
+    /// </summary>
+    /// <param name="times">キーの時間</param>
+    /// <param name="values">キーの値</param>
+    /// <param name="tolerance">許容誤差(値の差)</param>
+    /// <returns>トラック</returns>
+    Track AddVector3Track( const std::vector<float>& times, const std::vector<Vector3>& values, float tolerance );
+
+    /// <summary>
+    /// 回転のトラックを作成
+    /// </summary>
+    /// <param name="times">キーの時間</param>
+    /// <param name="values">キーの値</param>
+    /// <param name="tolerance">許容誤差(角度、ラジアン)</param>
+    /// <returns>トラック</returns>
+    Track AddRotationTrack( const std::vector<float>& times, const std::vector<Quaternion>& values, float tolerance );
+};
@@ -0,0 +1,36 @@
+#include "PosePool.h"
+
+// コンストラクタ
+PosePool::PosePool()
+    : mPoses()
+    , mFreePoses()
+{
+}
+
+// 姿勢を借りる
+NodePose* PosePool::Acquire( uint32_t count )
+{
+    if( mFreePoses.empty() )
+    {
+        mPoses.emplace_back( std::make_unique<NodePose>() );
+        mFreePoses.emplace_back( mPoses.back().get() );
+    }
+    auto pose = mFreePoses.back();
+    mFreePoses.pop_back();
+
+    // 同じノード数なら確保し直さない
+    pose->mScales.resize( count );
+    pose->mRotates.resize( count );
+    pose->mTranslates.resize( count );
+    pose->mModelMats.resize( count );
+    pose->mIsDirty.resize( count );
+    return pose;
+}
+
+// 姿勢を返す
+void PosePool::Release( NodePose* pose )
+{
+    if( !pose ) return;
+
+    mFreePoses.emplace_back( pose );
+}
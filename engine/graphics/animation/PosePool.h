@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "graphics/model/NodeHierarchy.h"
+
+/// <summary>
+/// 作業用の姿勢のプール
+/// 返却された姿勢は配列の確保を残したまま使い回す(スレッドごとに1つ持つ)
+/// </summary>
+class PosePool
+{
+   private:
+    // 作成した姿勢
+    std::vector<std::unique_ptr<NodePose>> mPoses;
+    // 空いている姿勢
+    std::vector<NodePose*> mFreePoses;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    PosePool();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~PosePool() = default;
+
+    /// <summary>
+    /// 姿勢を借りる(中身は不定)
+    /// </summary>
+    /// <param name="count">ノード数</param>
+    /// <returns>姿勢</returns>
+    NodePose* Acquire( uint32_t count );
+
+    /// <summary>
+    /// 姿勢を返す
+    /// </summary>
+    /// <param name="pose">姿勢</param>
+    void Release( NodePose* pose );
+
+    /// <summary>作成した姿勢の数を取得</summary>
+    uint32_t GetCreatedCount() const { return static_cast<uint32_t>( mPoses.size() ); }
+
+    /// <summary>貸し出し中の姿勢の数を取得</summary>
+    uint32_t GetActiveCount() const { return static_cast<uint32_t>( mPoses.size() - mFreePoses.size() ); }
+};
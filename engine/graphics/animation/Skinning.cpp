@@ -0,0 +1,165 @@
+#include "Skinning.h"
+
+#include <xmmintrin.h>
+
+#include <cfloat>
+#include <utility>
+
+namespace Skinning
+{
+
+// 影響を追加
+void AddInfluence( SkinInfluence& influence, uint16_t bone, float weight )
+{
+    auto k = kMaxInfluences - 1;
+    if( weight <= influence.mWeights[k] ) return;
+
+    influence.mBones[k] = bone;
+    influence.mWeights[k] = weight;
+    for( ; k > 0 && influence.mWeights[k] > influence.mWeights[k - 1]; --k )
+    {
+        std::swap( influence.mBones[k], influence.mBones[k - 1] );
+        std::swap( influence.mWeights[k], influence.mWeights[k - 1] );
+    }
+}
+
+// 重みの合計を1にする
+void NormalizeInfluences( std::vector<SkinInfluence>& influences )
+{
+    for( auto& influence : influences )
+    {
+        auto sum = 0.0f;
+        for( auto weight : influence.mWeights )
+        {
+            sum += weight;
+        }
+        if( sum <= 0.0f ) continue;
+
+        for( auto& weight : influence.mWeights )
+        {
+            weight /= sum;
+        }
+    }
+}
+
+// スキニング行列を計算
+void ComputeSkinMatrices( const SkinData& skin, const std::vector<Matrix4>& modelMats, std::vector<Matrix4>& skinMats )
+{
+    auto boneCount = skin.mBoneNodes.size();
+    skinMats.resize( boneCount );
+    for( size_t i = 0; i < boneCount; ++i )
+    {
+        skinMats[i] = skin.mOffsetMats[i] * modelMats[skin.mBoneNodes[i]];
+    }
+}
+
+// 頂点をスキニング(SIMD)
+void SkinVertices( const MeshVertex* src, const SkinInfluence* influences, uint32_t count, const Matrix4* skinMats, MeshVertex* dst, AABB3D& aabb )
+{
+    auto minP = _mm_set1_ps( +FLT_MAX );
+    auto maxP = _mm_set1_ps( -FLT_MAX );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        const auto& vertex = src[i];
+        const auto& influence = influences[i];
+        auto& out = dst[i];
+
+        // 重みを掛けて行列を合成(行ベクトルなので4行をそれぞれ足し合わせる)
+        // 影響が無い頂点はそのまま
+        auto row0 = _mm_setr_ps( 1.0f, 0.0f, 0.0f, 0.0f );
+        auto row1 = _mm_setr_ps( 0.0f, 1.0f, 0.0f, 0.0f );
+        auto row2 = _mm_setr_ps( 0.0f, 0.0f, 1.0f, 0.0f );
+        auto row3 = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+        if( influence.mWeights[0] > 0.0f )
+        {
+            row0 = _mm_setzero_ps();
+            row1 = _mm_setzero_ps();
+            row2 = _mm_setzero_ps();
+            row3 = _mm_setzero_ps();
+            for( uint32_t k = 0; k < kMaxInfluences; ++k )
+            {
+                auto weight = influence.mWeights[k];
+                if( weight <= 0.0f ) break;
+
+                const auto* m = &skinMats[influence.mBones[k]].m[0][0];
+                auto w = _mm_set1_ps( weight );
+                row0 = _mm_add_ps( row0, _mm_mul_ps( w, _mm_loadu_ps( m + 0 ) ) );
+                row1 = _mm_add_ps( row1, _mm_mul_ps( w, _mm_loadu_ps( m + 4 ) ) );
+                row2 = _mm_add_ps( row2, _mm_mul_ps( w, _mm_loadu_ps( m + 8 ) ) );
+                row3 = _mm_add_ps( row3, _mm_mul_ps( w, _mm_loadu_ps( m + 12 ) ) );
+            }
+        }
+
+        // 座標
+        auto position = _mm_add_ps(
+            _mm_add_ps( _mm_mul_ps( _mm_set1_ps( vertex.mPosition.x ), row0 ), _mm_mul_ps( _mm_set1_ps( vertex.mPosition.y ), row1 ) ),
+            _mm_add_ps( _mm_mul_ps( _mm_set1_ps( vertex.mPosition.z ), row2 ), _mm_mul_ps( _mm_set1_ps( vertex.mPosition.w ), row3 ) ) );
+        _mm_storeu_ps( &out.mPosition.x, position );
+        minP = _mm_min_ps( minP, position );
+        maxP = _mm_max_ps( maxP, position );
+
+        // 法線(正規化はシェーダーで行う)
+        auto normal = _mm_add_ps(
+            _mm_add_ps( _mm_mul_ps( _mm_set1_ps( vertex.mNormal.x ), row0 ), _mm_mul_ps( _mm_set1_ps( vertex.mNormal.y ), row1 ) ),
+            _mm_mul_ps( _mm_set1_ps( vertex.mNormal.z ), row2 ) );
+        _mm_storel_pi( reinterpret_cast<__m64*>( &out.mNormal.x ), normal );
+        _mm_store_ss( &out.mNormal.z, _mm_movehl_ps( normal, normal ) );
+
+        out.mUV = vertex.mUV;
+    }
+
+    alignas( 16 ) float minF[4];
+    alignas( 16 ) float maxF[4];
+    _mm_store_ps( minF, minP );
+    _mm_store_ps( maxF, maxP );
+    aabb.mMin = Vector3( minF[0], minF[1], minF[2] );
+    aabb.mMax = Vector3( maxF[0], maxF[1], maxF[2] );
+}
+
+// 頂点をスキニング(スカラー)
+void SkinVerticesScalar( const MeshVertex* src, const SkinInfluence* influences, uint32_t count, const Matrix4* skinMats, MeshVertex* dst, AABB3D& aabb )
+{
+    aabb.Reset();
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        const auto& vertex = src[i];
+        const auto& influence = influences[i];
+
+        Matrix4 mat;
+        if( influence.mWeights[0] > 0.0f )
+        {
+            for( uint32_t r = 0; r < 4; ++r )
+            {
+                for( uint32_t c = 0; c < 4; ++c )
+                {
+                    mat.m[r][c] = 0.0f;
+                }
+            }
+            for( uint32_t k = 0; k < kMaxInfluences; ++k )
+            {
+                auto weight = influence.mWeights[k];
+                if( weight <= 0.0f ) break;
+
+                const auto& skinMat = skinMats[influence.mBones[k]];
+                for( uint32_t r = 0; r < 4; ++r )
+                {
+                    for( uint32_t c = 0; c < 4; ++c )
+                    {
+                        mat.m[r][c] += weight * skinMat.m[r][c];
+                    }
+                }
+            }
+        }
+
+        auto& out = dst[i];
+        out.mPosition = vertex.mPosition * mat;
+        out.mNormal = Vector3(
+            vertex.mNormal.x * mat.m[0][0] + vertex.mNormal.y * mat.m[1][0] + vertex.mNormal.z * mat.m[2][0],
+            vertex.mNormal.x * mat.m[0][1] + vertex.mNormal.y * mat.m[1][1] + vertex.mNormal.z * mat.m[2][1],
+            vertex.mNormal.x * mat.m[0][2] + vertex.mNormal.y * mat.m[1][2] + vertex.mNormal.z * mat.m[2][2] );
+        out.mUV = vertex.mUV;
+        aabb.Update( Vector3( out.mPosition.x, out.mPosition.y, out.mPosition.z ) );
+    }
+}
+
+}  // namespace Skinning
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "graphics/model/MeshVertex.h"
+#include "math/Matrix4.h"
+#include "math/Primitive.h"
+
+/// <summary>
+/// 頂点に影響するボーン(重みの大きい順、合計1、使わない枠は重み0)
+/// </summary>
+struct SkinInfluence
+{
+    uint16_t mBones[4];
+    float mWeights[4];
+};
+
+/// <summary>
+/// メッシュのスキン情報
+/// </summary>
+struct SkinData
+{
+    // ボーンのノードインデックス
+    std::vector<int32_t> mBoneNodes;
+    // オフセット行列(メッシュ空間からボーン空間へ)
+    std::vector<Matrix4> mOffsetMats;
+    // 頂点ごとの影響(頂点データと同じ順)
+    std::vector<SkinInfluence> mInfluences;
+};
+
+/// <summary>
+/// CPUスキニング(線形ブレンド)
+/// 出力の頂点はモデル空間(ノードの行列を掛けた後)になる
+/// </summary>
+namespace Skinning
+{
+
+// 1頂点に影響するボーンの最大数
+inline constexpr uint32_t kMaxInfluences = 4;
+
+/// <summary>
+/// 影響を追加(重みの大きい順に最大4本まで残す)
+/// </summary>
+/// <param name="influence">頂点の影響</param>
+/// <param name="bone">ボーンのインデックス</param>
+/// <param name="weight">重み</param>
+void AddInfluence( SkinInfluence& influence, uint16_t bone, float weight );
+
+/// <summary>
+/// 重みの合計を1にする(影響が無い頂点はそのまま)
+/// </summary>
+/// <param name="influences">頂点ごとの影響</param>
+void NormalizeInfluences( std::vector<SkinInfluence>& influences );
+
+/// <summary>
+/// ボーンごとのスキニング行列を計算
+/// </summary>
+/// <param name="skin">スキン情報</param>
+/// <param name="modelMats">ノードのモデル行列</param>
+/// <param name="skinMats">スキニング行列(出力、ボーン順)</param>
+void ComputeSkinMatrices( const SkinData& skin, const std::vector<Matrix4>& modelMats, std::vector<Matrix4>& skinMats );
+
+/// <summary>
+/// 頂点をスキニング(SIMD)
+/// </summary>
+/// <param name="src">元の頂点</param>
+/// <param name="influences">頂点ごとの影響</param>
+/// <param name="count">頂点数</param>
+/// <param name="skinMats">スキニング行列</param>
+/// <param name="dst">スキニング後の頂点(出力)</param>
+/// <param name="aabb">スキニング後の境界(出力)</param>
+void SkinVertices( const MeshVertex* src, const SkinInfluence* influences, uint32_t count, const Matrix4* skinMats, MeshVertex* dst, AABB3D& aabb );
+
+/// <summary>
+/// 頂点をスキニング(スカラー、検証用)
+/// </summary>
+/// <param name="src">元の頂点</param>
+/// <param name="influences">頂点ごとの影響</param>
+/// <param name="count">頂点数</param>
+/// <param name="skinMats">スキニング行列</param>
+/// <param name="dst">スキニング後の頂点(出力)</param>
+/// <param name="aabb">スキニング後の境界(出力)</param>
+void SkinVerticesScalar( const MeshVertex* src, const SkinInfluence* influences, uint32_t count, const Matrix4* skinMats, MeshVertex* dst, AABB3D& aabb );
+
+}  // namespace Skinning
@@ -0,0 +1,223 @@
+#include "LightCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// スポットライトが平面の表側にかかるか
+inline bool IsSpotInFront( float nx, float ny, float nz, float d, float x, float y, float z, float dx, float dy, float dz, float r, float br )
+{
+    // 頂点
+    auto apexDist = nx * x + ny * y + nz * z + d;
+    // 底面の縁で最も表側にある点
+    auto nDotDir = nx * dx + ny * dy + nz * dz;
+    auto sinSq = ( std::max )( 0.0f, 1.0f - nDotDir * nDotDir );
+    auto rimDist = apexDist + r * nDotDir + br * std::sqrt( sinSq );
+    auto coneHit = ( std::max )( apexDist, rimDist ) >= 0.0f;
+    auto sphereHit = apexDist >= -r;
+    // 影響範囲は球と円錐の共通部分なので両方を満たす必要がある
+    return sphereHit & ( br < 0.0f || coneHit );
+}
+
+// 要素を削除して後ろを詰める
+void EraseAt( std::vector<float>& values, uint32_t idx )
+{
+    values.erase( values.begin() + idx );
+}
+
+}  // namespace
+
+// 要素数を変更
+void LightCuller::PointLightSoA::Resize( uint32_t count )
+{
+    mX.resize( count );
+    mY.resize( count );
+    mZ.resize( count );
+    mRadius.resize( count );
+}
+
+// 要素を設定
+void LightCuller::PointLightSoA::Set( uint32_t idx, const Vector3& position, float radius )
+{
+    mX[idx] = position.x;
+    mY[idx] = position.y;
+    mZ[idx] = position.z;
+    mRadius[idx] = radius;
+}
+
+// 要素を削除
+void LightCuller::PointLightSoA::Erase( uint32_t idx )
+{
+    EraseAt( mX, idx );
+    EraseAt( mY, idx );
+    EraseAt( mZ, idx );
+    EraseAt( mRadius, idx );
+}
+
+// 要素数を変更
+void LightCuller::SpotLightSoA::Resize( uint32_t count )
+{
+    mX.resize( count );
+    mY.resize( count );
+    mZ.resize( count );
+    mDirX.resize( count );
+    mDirY.resize( count );
+    mDirZ.resize( count );
+    mRadius.resize( count );
+    mBaseRadius.resize( count );
+}
+
+// 要素を設定
+void LightCuller::SpotLightSoA::Set( uint32_t idx, const Vector3& position, const Vector3& direction, float radius, float outerAngle )
+{
+    auto dir = Normalize( direction );
+    mX[idx] = position.x;
+    mY[idx] = position.y;
+    mZ[idx] = position.z;
+    mDirX[idx] = dir.x;
+    mDirY[idx] = dir.y;
+    mDirZ[idx] = dir.z;
+    mRadius[idx] = radius;
+    // 広すぎる円錐は球として扱う
+    mBaseRadius[idx] = outerAngle < kMaxConeAngle ? radius * std::tan( outerAngle ) : -1.0f;
+}
+
+// 要素を削除
+void LightCuller::SpotLightSoA::Erase( uint32_t idx )
+{
+    EraseAt( mX, idx );
+    EraseAt( mY, idx );
+    EraseAt( mZ, idx );
+    EraseAt( mDirX, idx );
+    EraseAt( mDirY, idx );
+    EraseAt( mDirZ, idx );
+    EraseAt( mRadius, idx );
+    EraseAt( mBaseRadius, idx );
+}
+
+// コンストラクタ
+LightCuller::LightCuller()
+    : mMask()
+{
+}
+
+// 点光源を視錐台でカリング
+void LightCuller::Cull( const PointLightSoA& lights, const Frustum& frustum, std::vector<uint32_t>& visible )
+{
+    auto count = lights.GetCount();
+    mMask.assign( count, 1 );
+
+    const auto* x = lights.mX.data();
+    const auto* y = lights.mY.data();
+    const auto* z = lights.mZ.data();
+    const auto* r = lights.mRadius.data();
+    auto* mask = mMask.data();
+
+    // 平面ごとにまとめて判定(分岐なしでベクトル化させる)
+    for( const auto& plane : frustum.mPlanes )
+    {
+        auto nx = plane.mNormal.x;
+        auto ny = plane.mNormal.y;
+        auto nz = plane.mNormal.z;
+        auto d = plane.mD;
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            auto dist = nx * x[i] + ny * y[i] + nz * z[i] + d;
+            mask[i] &= static_cast<uint8_t>( dist >= -r[i] );
+        }
+    }
+
+    Compact( count, visible );
+}
+
+// スポットライトを視錐台でカリング
+void LightCuller::Cull( const SpotLightSoA& lights, const Frustum& frustum, std::vector<uint32_t>& visible )
+{
+    auto count = lights.GetCount();
+    mMask.assign( count, 1 );
+
+    const auto* x = lights.mX.data();
+    const auto* y = lights.mY.data();
+    const auto* z = lights.mZ.data();
+    const auto* dx = lights.mDirX.data();
+    const auto* dy = lights.mDirY.data();
+    const auto* dz = lights.mDirZ.data();
+    const auto* r = lights.mRadius.data();
+    const auto* br = lights.mBaseRadius.data();
+    auto* mask = mMask.data();
+
+    for( const auto& plane : frustum.mPlanes )
+    {
+        auto nx = plane.mNormal.x;
+        auto ny = plane.mNormal.y;
+        auto nz = plane.mNormal.z;
+        auto d = plane.mD;
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            mask[i] &= static_cast<uint8_t>( IsSpotInFront( nx, ny, nz, d, x[i], y[i], z[i], dx[i], dy[i], dz[i], r[i], br[i] ) );
+        }
+    }
+
+    Compact( count, visible );
+}
+
+// 可視なライトの部分集合をさらにカリング
+void LightCuller::Cull( const PointLightSoA& lights, const std::vector<uint32_t>& candidates, const Frustum& frustum, std::vector<uint32_t>& visible )
+{
+    visible.clear();
+    for( auto idx : candidates )
+    {
+        auto x = lights.mX[idx];
+        auto y = lights.mY[idx];
+        auto z = lights.mZ[idx];
+        auto r = lights.mRadius[idx];
+        auto inside = true;
+        for( const auto& plane : frustum.mPlanes )
+        {
+            auto dist = plane.mNormal.x * x + plane.mNormal.y * y + plane.mNormal.z * z + plane.mD;
+            inside &= dist >= -r;
+        }
+        if( inside )
+        {
+            visible.emplace_back( idx );
+        }
+    }
+}
+
+// 可視なスポットライトの部分集合をさらにカリング
+void LightCuller::Cull( const SpotLightSoA& lights, const std::vector<uint32_t>& candidates, const Frustum& frustum, std::vector<uint32_t>& visible )
+{
+    visible.clear();
+    for( auto idx : candidates )
+    {
+        auto inside = true;
+        for( const auto& plane : frustum.mPlanes )
+        {
+            inside &= IsSpotInFront(
+                plane.mNormal.x, plane.mNormal.y, plane.mNormal.z, plane.mD,
+                lights.mX[idx], lights.mY[idx], lights.mZ[idx],
+                lights.mDirX[idx], lights.mDirY[idx], lights.mDirZ[idx],
+                lights.mRadius[idx], lights.mBaseRadius[idx] );
+        }
+        if( inside )
+        {
+            visible.emplace_back( idx );
+        }
+    }
+}
+
+// 判定結果からインデックスを詰める
+void LightCuller::Compact( uint32_t count, std::vector<uint32_t>& visible )
+{
+    visible.resize( count );
+    uint32_t visibleCount = 0;
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        // 分岐せずに書き込んで、可視なときだけ進める
+        visible[visibleCount] = i;
+        visibleCount += mMask[i];
+    }
+    visible.resize( visibleCount );
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "math/Primitive.h"
+
+/// <summary>
+/// ライトのカリング
+/// </summary>
+class LightCuller
+{
+   public:
+    // 円錐として扱える外角の上限(これ以上は球で判定)
+    static constexpr float kMaxConeAngle = 89.0f * MathUtil::kDegToRad;
+
+    /// <summary>
+    /// 点光源(SoA)
+    /// </summary>
+    struct PointLightSoA
+    {
+        // 位置
+        std::vector<float> mX;
+        std::vector<float> mY;
+        std::vector<float> mZ;
+        // 半径
+        std::vector<float> mRadius;
+
+        /// <summary>要素数を変更</summary>
+        void Resize( uint32_t count );
+
+        /// <summary>要素数を取得</summary>
+        uint32_t GetCount() const { return static_cast<uint32_t>( mX.size() ); }
+
+        /// <summary>
+        /// 要素を設定
+        /// </summary>
+        /// <param name="idx">インデックス</param>
+        /// <param name="position">位置</param>
+        /// <param name="radius">半径</param>
+        void Set( uint32_t idx, const Vector3& position, float radius );
+
+        /// <summary>
+        /// 要素を削除(後ろの要素を詰める)
+        /// </summary>
+        /// <param name="idx">インデックス</param>
+        void Erase( uint32_t idx );
+    };
+
+    /// <summary>
+    /// スポットライト(SoA)
+    /// </summary>
+    struct SpotLightSoA
+    {
+        // 位置
+        std::vector<float> mX;
+        std::vector<float> mY;
+        std::vector<float> mZ;
+        // 向き(正規化済み)
+        std::vector<float> mDirX;
+        std::vector<float> mDirY;
+        std::vector<float> mDirZ;
+        // 半径
+        std::vector<float> mRadius;
+        // 底面の半径(半径 * tan(外角))。負なら球として判定する
+        std::vector<float> mBaseRadius;
+
+        /// <summary>要素数を変更</summary>
+        void Resize( uint32_t count );
+
+        /// <summary>要素数を取得</summary>
+        uint32_t GetCount() const { return static_cast<uint32_t>( mX.size() ); }
+
+        /// <summary>
+        /// 要素を設定
+        /// </summary>
+        /// <param name="idx">インデックス</param>
+        /// <param name="position">位置</param>
+        /// <param name="direction">向き</param>
+        /// <param name="radius">半径</param>
+        /// <param name="outerAngle">外角(ラジアン)</param>
+        void Set( uint32_t idx, const Vector3& position, const Vector3& direction, float radius, float outerAngle );
+
+        /// <summary>
+        /// 要素を削除(後ろの要素を詰める)
+        /// </summary>
+        /// <param name="idx">インデックス</param>
+        void Erase( uint32_t idx );
+    };
+
+   private:
+    // 判定結果(1:可視)
+    std::vector<uint8_t> mMask;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    LightCuller();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~LightCuller() = default;
+
+    /// <summary>
+    /// 点光源を視錐台でカリング
+    /// </summary>
+    /// <param name="lights">点光源</param>
+    /// <param name="frustum">視錐台(部分視錐台も可)</param>
+    /// <param name="visible">可視なライトのインデックス(出力)</param>
+    void Cull( const PointLightSoA& lights, const Frustum& frustum, std::vector<uint32_t>& visible );
+
+    /// <summary>
+    /// スポットライトを視錐台でカリング
+    /// </summary>
+    /// <param name="lights">スポットライト</param>
+    /// <param name="frustum">視錐台(部分視錐台も可)</param>
+    /// <param name="visible">可視なライトのインデックス(出力)</param>
+    void Cull( const SpotLightSoA& lights, const Frustum& frustum, std::vector<uint32_t>& visible );
+
+    /// <summary>
+    /// 可視なライトの部分集合をさらにカリング(タイル・クラスター用)
+    /// </summary>
+    /// <param name="lights">点光源</param>
+    /// <param name="candidates">候補のインデックス</param>
+    /// <param name="frustum">部分視錐台</param>
+    /// <param name="visible">可視なライトのインデックス(出力)</param>
+    void Cull( const PointLightSoA& lights, const std::vector<uint32_t>& candidates, const Frustum& frustum, std::vector<uint32_t>& visible );
+
+    /// <summary>
+    /// 可視なスポットライトの部分集合をさらにカリング(タイル・クラスター用)
+    /// </summary>
+    /// <param name="lights">スポットライト</param>
+    /// <param name="candidates">候補のインデックス</param>
+    /// <param name="frustum">部分視錐台</param>
+    /// <param name="visible">可視なライトのインデックス(出力)</param>
+    void Cull( const SpotLightSoA& lights, const std::vector<uint32_t>& candidates, const Frustum& frustum, std::vector<uint32_t>& visible );
+
+   private:
+    /// <summary>
+    /// 判定結果からインデックスを詰める
+    /// </summary>
+    /// <param name="count">要素数</param>
+    /// <param name="visible">可視なライトのインデックス(出力)</param>
+    void Compact( uint32_t count, std::vector<uint32_t>& visible );
+};
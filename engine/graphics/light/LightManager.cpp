@@ -9,6 +9,12 @@ LightManager::LightManager()
     , mDirectionalLights()
     , mPointLights()
     , mSpotLights()
+    , mCuller()
+    , mFrustum( nullptr )
+    , mPointLightSoA()
+    , mSpotLightSoA()
+    , mVisiblePointLights()
+    , mVisibleSpotLights()
 {
 }
 
@@ -35,6 +41,7 @@ void LightManager::Bind( CommandList* cmdList, uint32_t constIdx )
 {
     if( !cmdList ) return;
 
+    CullLights();
     UpdateCB();
 
     cmdList->SetGraphicsConstantBuffer( constIdx, mCB.get() );
@@ -66,6 +73,9 @@ void LightManager::AddPointLight( PointLight* pointLight )
     if( !pointLight ) return;
 
     mPointLights.push_back( pointLight );
+    auto idx = mPointLightSoA.GetCount();
+    mPointLightSoA.Resize( idx + 1 );
+    mPointLightSoA.Set( idx, pointLight->mPosition, pointLight->mRadius );
 }
 
 // 点光源を削除
@@ -76,16 +86,32 @@ void LightManager::RemovePointLight( PointLight* pointLight )
     auto it = std::find( mPointLights.begin(), mPointLights.end(), pointLight );
     if( it != mPointLights.end() )
     {
+        mPointLightSoA.Erase( static_cast<uint32_t>( it - mPointLights.begin() ) );
         mPointLights.erase( it );
     }
 }
 
+// 点光源の位置と半径の変更を反映
+void LightManager::UpdatePointLight( const PointLight* pointLight )
+{
+    if( !pointLight ) return;
+
+    auto it = std::find( mPointLights.begin(), mPointLights.end(), pointLight );
+    if( it != mPointLights.end() )
+    {
+        mPointLightSoA.Set( static_cast<uint32_t>( it - mPointLights.begin() ), pointLight->mPosition, pointLight->mRadius );
+    }
+}
+
 // スポットライトを追加
 void LightManager::AddSpotLight( SpotLight* spotLight )
 {
     if( !spotLight ) return;
 
     mSpotLights.push_back( spotLight );
+    auto idx = mSpotLightSoA.GetCount();
+    mSpotLightSoA.Resize( idx + 1 );
+    mSpotLightSoA.Set( idx, spotLight->mPosition, spotLight->mDirection, spotLight->mRadius, spotLight->mOuterAngle * MathUtil::kDegToRad );
 }
 
 // スポットライトを削除
@@ -96,10 +122,50 @@ void LightManager::RemoveSpotLight( SpotLight* spotLight )
     auto it = std::find( mSpotLights.begin(), mSpotLights.end(), spotLight );
     if( it != mSpotLights.end() )
     {
+        mSpotLightSoA.Erase( static_cast<uint32_t>( it - mSpotLights.begin() ) );
         mSpotLights.erase( it );
     }
 }
 
+// スポットライトの位置・向き・半径・外角の変更を反映
+void LightManager::UpdateSpotLight( const SpotLight* spotLight )
+{
+    if( !spotLight ) return;
+
+    auto it = std::find( mSpotLights.begin(), mSpotLights.end(), spotLight );
+    if( it != mSpotLights.end() )
+    {
+        auto idx = static_cast<uint32_t>( it - mSpotLights.begin() );
+        mSpotLightSoA.Set( idx, spotLight->mPosition, spotLight->mDirection, spotLight->mRadius, spotLight->mOuterAngle * MathUtil::kDegToRad );
+    }
+}
+
+// ライトをカリング
+void LightManager::CullLights()
+{
+    if( mFrustum )
+    {
+        mCuller.Cull( mPointLightSoA, *mFrustum, mVisiblePointLights );
+        mCuller.Cull( mSpotLightSoA, *mFrustum, mVisibleSpotLights );
+    }
+    else
+    {
+        // カリングしない
+        auto pointLightCount = mPointLightSoA.GetCount();
+        mVisiblePointLights.resize( pointLightCount );
+        for( uint32_t i = 0; i < pointLightCount; ++i )
+        {
+            mVisiblePointLights[i] = i;
+        }
+        auto spotLightCount = mSpotLightSoA.GetCount();
+        mVisibleSpotLights.resize( spotLightCount );
+        for( uint32_t i = 0; i < spotLightCount; ++i )
+        {
+            mVisibleSpotLights[i] = i;
+        }
+    }
+}
+
 // 定数バッファを更新
 void LightManager::UpdateCB()
 {
@@ -114,29 +180,31 @@ void LightManager::UpdateCB()
         c.mDirectionalLights[i].mIntensity = mDirectionalLights[i]->mIntensity;
     }
 
-    // 点光源
-    auto pointLightCount = std::min<uint32_t>( kMaxPointLightCount, static_cast<uint32_t>( mPointLights.size() ) );
+    // 点光源(可視なもののみ)
+    auto pointLightCount = std::min<uint32_t>( kMaxPointLightCount, static_cast<uint32_t>( mVisiblePointLights.size() ) );
     for( uint32_t i = 0; i < pointLightCount; ++i )
     {
-        c.mPointLights[i].mColor = mPointLights[i]->mColor;
-        c.mPointLights[i].mPosition = mPointLights[i]->mPosition;
-        c.mPointLights[i].mIntensity = mPointLights[i]->mIntensity;
-        c.mPointLights[i].mRadius = mPointLights[i]->mRadius;
-        c.mPointLights[i].mDecay = mPointLights[i]->mDecay;
+        auto* pointLight = mPointLights[mVisiblePointLights[i]];
+        c.mPointLights[i].mColor = pointLight->mColor;
+        c.mPointLights[i].mPosition = pointLight->mPosition;
+        c.mPointLights[i].mIntensity = pointLight->mIntensity;
+        c.mPointLights[i].mRadius = pointLight->mRadius;
+        c.mPointLights[i].mDecay = pointLight->mDecay;
     }
 
-    // スポットライト
-    auto spotLightCount = std::min<uint32_t>( kMaxSpotLightCount, static_cast<uint32_t>( mSpotLights.size() ) );
+    // スポットライト(可視なもののみ)
+    auto spotLightCount = std::min<uint32_t>( kMaxSpotLightCount, static_cast<uint32_t>( mVisibleSpotLights.size() ) );
     for( uint32_t i = 0; i < spotLightCount; ++i )
     {
-        c.mSpotLights[i].mColor = mSpotLights[i]->mColor;
-        c.mSpotLights[i].mDirection = Normalize( mSpotLights[i]->mDirection );
-        c.mSpotLights[i].mIntensity = mSpotLights[i]->mIntensity;
-        c.mSpotLights[i].mPosition = mSpotLights[i]->mPosition;
-        c.mSpotLights[i].mRadius = mSpotLights[i]->mRadius;
-        c.mSpotLights[i].mDecay = mSpotLights[i]->mDecay;
-        c.mSpotLights[i].mInnerCos = std::cosf( mSpotLights[i]->mInnerAngle * MathUtil::kDegToRad );
-        c.mSpotLights[i].mOuterCos = std::cosf( mSpotLights[i]->mOuterAngle * MathUtil::kDegToRad );
+        auto* spotLight = mSpotLights[mVisibleSpotLights[i]];
+        c.mSpotLights[i].mColor = spotLight->mColor;
+        c.mSpotLights[i].mDirection = Normalize( spotLight->mDirection );
+        c.mSpotLights[i].mIntensity = spotLight->mIntensity;
+        c.mSpotLights[i].mPosition = spotLight->mPosition;
+        c.mSpotLights[i].mRadius = spotLight->mRadius;
+        c.mSpotLights[i].mDecay = spotLight->mDecay;
+        c.mSpotLights[i].mInnerCos = std::cosf( spotLight->mInnerAngle * MathUtil::kDegToRad );
+        c.mSpotLights[i].mOuterCos = std::cosf( spotLight->mOuterAngle * MathUtil::kDegToRad );
     }
 
     c.mDirectionalLightCount = directionalLightCount;
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "DirectionalLight.h"
+#include "LightCuller.h"
 #include "PointLight.h"
 #include "SpotLight.h"
 #include "core/ConstantBuffer.h"
@@ -111,6 +112,19 @@ class LightManager
     // スポットライト
     std::vector<SpotLight*> mSpotLights;
 
+    // カリング
+    LightCuller mCuller;
+    // カリング用の視錐台(nullptrならカリングしない)
+    const Frustum* mFrustum;
+    // 点光源の位置と半径(SoA、mPointLightsと同じ並び)
+    LightCuller::PointLightSoA mPointLightSoA;
+    // スポットライトの位置・向き・範囲(SoA、mSpotLightsと同じ並び)
+    LightCuller::SpotLightSoA mSpotLightSoA;
+    // 可視な点光源のインデックス
+    std::vector<uint32_t> mVisiblePointLights;
+    // 可視なスポットライトのインデックス
+    std::vector<uint32_t> mVisibleSpotLights;
+
    public:
     /// <summary>
     /// インスタンスを取得
@@ -197,6 +211,12 @@ class LightManager
     /// <param name="pointLight">点光源</param>
     void RemovePointLight( PointLight* pointLight );
 
+    /// <summary>
+    /// 点光源の位置と半径の変更を反映
+    /// </summary>
+    /// <param name="pointLight">点光源</param>
+    void UpdatePointLight( const PointLight* pointLight );
+
     /// <summary>
     /// スポットライトを追加
     /// </summary>
@@ -209,7 +229,36 @@ class LightManager
     /// <param name="spotLight">スポットライト</param>
     void RemoveSpotLight( SpotLight* spotLight );
 
+    /// <summary>
+    /// スポットライトの位置・向き・半径・外角の変更を反映
+    /// </summary>
+    /// <param name="spotLight">スポットライト</param>
+    void UpdateSpotLight( const SpotLight* spotLight );
+
+    /// <summary>定数バッファを取得(バインドで更新したもの、並列記録のコマンドリストへセットする)</summary>
+    ConstantBuffer* GetCB() const { return mCB.get(); }
+
+    /// <summary>カリング用の視錐台を設定(nullptrでカリングしない)</summary>
+    void SetFrustum( const Frustum* frustum ) { mFrustum = frustum; }
+
+    /// <summary>登録されている点光源の数を取得</summary>
+    uint32_t GetPointLightCount() const { return static_cast<uint32_t>( mPointLights.size() ); }
+
+    /// <summary>登録されているスポットライトの数を取得</summary>
+    uint32_t GetSpotLightCount() const { return static_cast<uint32_t>( mSpotLights.size() ); }
+
+    /// <summary>可視な点光源の数を取得</summary>
+    uint32_t GetVisiblePointLightCount() const { return static_cast<uint32_t>( mVisiblePointLights.size() ); }
+
+    /// <summary>可視なスポットライトの数を取得</summary>
+    uint32_t GetVisibleSpotLightCount() const { return static_cast<uint32_t>( mVisibleSpotLights.size() ); }
+
    private:
+    /// <summary>
+    /// ライトをカリング
+    /// </summary>
+    void CullLights();
+
     /// <summary>
     /// 定数バッファを更新
     /// </summary>
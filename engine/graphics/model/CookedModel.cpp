@@ -0,0 +1,163 @@
+#include "CookedModel.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#include "math/Matrix4.h"
+
+namespace
+{
+
+// 配列のまま読み書きするのでコピーだけで済む型に限る
+static_assert( std::is_trivially_copyable_v<MeshVertex> );
+static_assert( std::is_trivially_copyable_v<MeshLod> );
+static_assert( std::is_trivially_copyable_v<Meshlet> );
+static_assert( std::is_trivially_copyable_v<SkinInfluence> );
+static_assert( std::is_trivially_copyable_v<Matrix4> );
+static_assert( std::is_trivially_copyable_v<CookedModelFormat::NodeRecord> );
+static_assert( std::is_trivially_copyable_v<CookedModelFormat::MeshRecord> );
+static_assert( std::is_trivially_copyable_v<CookedModelFormat::MaterialRecord> );
+static_assert( std::is_trivially_copyable_v<CookedModelFormat::ClipRecord> );
+
+// アライメントに切り上げ
+uint64_t AlignUp( uint64_t value )
+{
+    return ( value + CookedModelFormat::kAlignment - 1 ) & ~( CookedModelFormat::kAlignment - 1 );
+}
+
+}  // namespace
+
+// コンストラクタ
+CookedModel::CookedModel()
+    : mFile()
+    , mHeader( nullptr )
+{
+}
+
+// 開く
+bool CookedModel::Open( const std::string& path )
+{
+    using namespace CookedModelFormat;
+
+    Close();
+    if( !mFile.Open( path ) ) return false;
+
+    // 形式とバージョン
+    if( mFile.GetSize() < sizeof( Header ) )
+    {
+        Close();
+        return false;
+    }
+    auto header = reinterpret_cast<const Header*>( mFile.GetData() );
+    if( header->mMagic != kMagic ||
+        header->mVersion != kVersion ||
+        header->mVertexStride != sizeof( MeshVertex ) ||
+        header->mInfluenceStride != sizeof( SkinInfluence ) )
+    {
+        Close();
+        return false;
+    }
+
+    // ブロックがファイルに収まっているか(中身はここでは読まない)
+    for( const auto& blob : header->mBlobs )
+    {
+        if( blob.mOffset % kAlignment != 0 || blob.mOffset > mFile.GetSize() || blob.mSize > mFile.GetSize() - blob.mOffset )
+        {
+            Close();
+            return false;
+        }
+    }
+
+    mHeader = header;
+    return true;
+}
+
+// 閉じる
+void CookedModel::Close()
+{
+    mHeader = nullptr;
+    mFile.Close();
+}
+
+// 文字列を取得
+std::string_view CookedModel::GetString( const CookedModelFormat::StringRef& ref ) const
+{
+    auto chars = GetRange<char>( CookedModelFormat::BlobType::kStrings, { ref.mOffset, ref.mLength } );
+    return std::string_view( chars.data(), chars.size() );
+}
+
+// 元のモデルのパスからクックしたファイルのパスを取得
+std::string CookedModel::GetCookedPath( const std::string& sourcePath )
+{
+    return sourcePath + ".cooked";
+}
+
+// クックしたファイルが元のモデルより新しいか
+bool CookedModel::IsUpToDate( const std::string& sourcePath, const std::string& cookedPath )
+{
+    std::error_code ec;
+    auto cookedTime = std::filesystem::last_write_time( cookedPath, ec );
+    if( ec ) return false;
+
+    auto sourceTime = std::filesystem::last_write_time( sourcePath, ec );
+    if( ec ) return true;
+
+    return cookedTime >= sourceTime;
+}
+
+// コンストラクタ
+CookedModelWriter::CookedModelWriter()
+    : mBlobs()
+{
+}
+
+// 文字列を追加
+CookedModelFormat::StringRef CookedModelWriter::AddString( std::string_view str )
+{
+    auto range = Append( CookedModelFormat::BlobType::kStrings, std::span<const char>( str.data(), str.size() ) );
+    return { range.mOffset, range.mCount };
+}
+
+// ファイルへ書き出す
+bool CookedModelWriter::Write( const std::string& path ) const
+{
+    using namespace CookedModelFormat;
+
+    // ヘッダーの後ろにブロックをアライメントして並べる
+    Header header = {};
+    header.mMagic = kMagic;
+    header.mVersion = kVersion;
+    header.mVertexStride = sizeof( MeshVertex );
+    header.mInfluenceStride = sizeof( SkinInfluence );
+    auto offset = AlignUp( sizeof( Header ) );
+    for( uint32_t i = 0; i < static_cast<uint32_t>( BlobType::kCount ); ++i )
+    {
+        header.mBlobs[i].mOffset = offset;
+        header.mBlobs[i].mSize = mBlobs[i].size();
+        offset = AlignUp( offset + mBlobs[i].size() );
+    }
+
+    std::vector<uint8_t> file( offset, 0 );
+    memcpy( file.data(), &header, sizeof( Header ) );
+    for( uint32_t i = 0; i < static_cast<uint32_t>( BlobType::kCount ); ++i )
+    {
+        if( mBlobs[i].empty() ) continue;
+
+        memcpy( file.data() + header.mBlobs[i].mOffset, mBlobs[i].data(), mBlobs[i].size() );
+    }
+
+    // 書きかけのファイルを読まないように一時ファイルへ書いてから置き換える
+    auto tempPath = path + ".tmp";
+    {
+        std::ofstream stream( tempPath, std::ios::binary | std::ios::trunc );
+        if( !stream ) return false;
+
+        stream.write( reinterpret_cast<const char*>( file.data() ), static_cast<std::streamsize>( file.size() ) );
+        if( !stream ) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename( tempPath, path, ec );
+    return !ec;
+}
@@ -0,0 +1,374 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "MeshLod.h"
+#include "MeshVertex.h"
+#include "Meshlet.h"
+#include "graphics/animation/Skinning.h"
+#include "math/Color.h"
+#include "math/Matrix4.h"
+#include "math/Quaternion.h"
+#include "math/Vector3.h"
+#include "utils/MappedFile.h"
+
+/// <summary>
+/// クックしたモデルのファイル形式
+/// ヘッダーの後にエンジンのレイアウトそのままの配列(ブロック)を並べる
+/// レコードは他のブロックを要素のオフセットと数で参照する
+/// </summary>
+namespace CookedModelFormat
+{
+
+// 識別子("CMDL")
+constexpr uint32_t kMagic = 0x4c444d43;
+// 形式のバージョン(レイアウトや中身の作り方を変えたら上げる)
+constexpr uint32_t kVersion = 9;
+// ブロックのアライメント
+constexpr uint64_t kAlignment = 16;
+
+/// <summary>
+/// ブロックの種類
+/// </summary>
+enum class BlobType : uint32_t
+{
+    // 文字列(終端なしで連結)
+    kStrings,
+    // NodeRecord
+    kNodes,
+    // MeshRecord
+    kMeshes,
+    // MeshVertex
+    kVertices,
+    // uint32_t
+    kIndices,
+    // SkinRecord
+    kSkins,
+    // ボーンのノードインデックス(int32_t)とオフセット行列(Matrix4)は同じ並び
+    kBoneNodes,
+    kOffsetMats,
+    // SkinInfluence
+    kInfluences,
+    // MaterialRecord
+    kMaterials,
+    // ClipRecord
+    kClips,
+    // ChannelRecord
+    kChannels,
+    // 元のクリップのキー(float・Vector3・Quaternion)
+    kKeyTimes,
+    kKeyVectors,
+    kKeyRotations,
+    // 圧縮したクリップのチャンネル・量子化の範囲・キー
+    kCompressedChannels,
+    kCompressedRanges,
+    kCompressedTimes,
+    kCompressedValues,
+    // MeshLod(LOD1以降、範囲はメッシュのLOD1以降のインデックス内)
+    kLods,
+    // Meshlet(範囲はメッシュのメッシュレット用のインデックス内)
+    kMeshlets,
+    // 頂点バッファ・インデックスバッファにそのまま書き込むバイト列
+    kVertexData,
+    kIndexData,
+
+    kCount,
+};
+
+/// <summary>
+/// ブロックの位置
+/// </summary>
+struct Blob
+{
+    uint64_t mOffset;
+    uint64_t mSize;
+};
+
+/// <summary>
+/// ヘッダー
+/// </summary>
+struct Header
+{
+    uint32_t mMagic;
+    uint32_t mVersion;
+    // エンジンの構造体のサイズ(変わっていたらクックし直す)
+    uint32_t mVertexStride;
+    uint32_t mInfluenceStride;
+    Blob mBlobs[static_cast<uint32_t>( BlobType::kCount )];
+};
+
+/// <summary>
+/// 文字列の参照
+/// </summary>
+struct StringRef
+{
+    uint32_t mOffset;
+    uint32_t mLength;
+};
+
+/// <summary>
+/// ブロック内の要素の範囲
+/// </summary>
+struct Range
+{
+    uint32_t mOffset;
+    uint32_t mCount;
+};
+
+/// <summary>
+/// ノード(親が子より前に並ぶ)
+/// </summary>
+struct NodeRecord
+{
+    StringRef mName;
+    int32_t mParent;
+    Vector3 mScale;
+    Quaternion mRotate;
+    Vector3 mTranslate;
+};
+
+/// <summary>
+/// メッシュ
+/// </summary>
+struct MeshRecord
+{
+    StringRef mName;
+    int32_t mNodeIdx;
+    uint32_t mMaterialIdx;
+    uint32_t mFlags;
+    Range mVertices;
+    Range mIndices;
+    // LOD1以降のインデックス(kIndices)と詳細度(kLods)
+    Range mLodIndices;
+    Range mLods;
+    // メッシュレット(kMeshlets)と、メッシュレット順に並べたLOD0のインデックス(kIndices)
+    Range mMeshlets;
+    Range mMeshletIndices;
+    Vector3 mAABBMin;
+    Vector3 mAABBMax;
+    // 頂点バッファ(kVertexData、mFlagsの形式)と量子化した位置をモデル空間に戻す行列
+    Range mVertexData;
+    Matrix4 mDequantizeMat;
+    // インデックスバッファ(kIndexData、LOD0・LOD1以降・メッシュレット順のLOD0を連結)とインデックス1つのサイズ
+    Range mIndexData;
+    uint32_t mIndexStride;
+    // スキン(無ければUINT32_MAX)
+    uint32_t mSkinIdx;
+    // クック前の最適化の結果
+    MeshOptimizeStats mOptimizeStats;
+};
+
+/// <summary>
+/// スキン
+/// </summary>
+struct SkinRecord
+{
+    // kBoneNodesの範囲
+    Range mBones;
+    // kOffsetMatsの範囲(ボーンと同じ数)
+    Range mOffsetMats;
+    Range mInfluences;
+};
+
+/// <summary>
+/// マテリアル
+/// </summary>
+struct MaterialRecord
+{
+    StringRef mName;
+    // 解決済みのテクスチャのパス(無ければ空)
+    StringRef mTexturePath;
+    Color mColor;
+};
+
+/// <summary>
+/// 元のクリップのチャンネル(値は時間と同じ数だけ並ぶ)
+/// </summary>
+struct ChannelRecord
+{
+    int32_t mNodeIdx;
+    Range mPositionTimes;
+    uint32_t mPositionOffset;
+    Range mRotationTimes;
+    uint32_t mRotationOffset;
+    Range mScaleTimes;
+    uint32_t mScaleOffset;
+};
+
+/// <summary>
+/// クリップ(元のクリップと圧縮したクリップ)
+/// </summary>
+struct ClipRecord
+{
+    StringRef mName;
+    float mDuration;
+    Range mChannels;
+    float mTimeToKey;
+    Range mCompressedChannels;
+    Range mCompressedRanges;
+    Range mCompressedTimes;
+    Range mCompressedValues;
+};
+
+}  // namespace CookedModelFormat
+
+/// <summary>
+/// クックしたモデルの読み込み
+/// ファイルをメモリマップし、ヘッダーの範囲だけ検証してブロックをそのまま参照で渡す
+/// </summary>
+class CookedModel
+{
+   private:
+    // マップしたファイル
+    MappedFile mFile;
+    // ヘッダー
+    const CookedModelFormat::Header* mHeader;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    CookedModel();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~CookedModel() = default;
+
+    /// <summary>
+    /// 開く(形式・バージョン・ブロックの範囲を検証する)
+    /// </summary>
+    /// <param name="path">ファイルのパス</param>
+    /// <returns>成否</returns>
+    bool Open( const std::string& path );
+
+    /// <summary>
+    /// 閉じる(取得した参照は無効になる)
+    /// </summary>
+    void Close();
+
+    /// <summary>
+    /// ブロック全体を取得
+    /// </summary>
+    /// <param name="type">ブロックの種類</param>
+    /// <returns>要素の並び(不正なら空)</returns>
+    template <class T>
+    std::span<const T> GetBlob( CookedModelFormat::BlobType type ) const
+    {
+        if( !mHeader ) return {};
+
+        const auto& blob = mHeader->mBlobs[static_cast<uint32_t>( type )];
+        if( blob.mSize % sizeof( T ) != 0 ) return {};
+
+        return { reinterpret_cast<const T*>( mFile.GetData() + blob.mOffset ), static_cast<size_t>( blob.mSize / sizeof( T ) ) };
+    }
+
+    /// <summary>
+    /// ブロック内の範囲を取得
+    /// </summary>
+    /// <param name="type">ブロックの種類</param>
+    /// <param name="range">範囲</param>
+    /// <returns>要素の並び(範囲外なら空)</returns>
+    template <class T>
+    std::span<const T> GetRange( CookedModelFormat::BlobType type, const CookedModelFormat::Range& range ) const
+    {
+        auto all = GetBlob<T>( type );
+        if( static_cast<uint64_t>( range.mOffset ) + range.mCount > all.size() ) return {};
+
+        return all.subspan( range.mOffset, range.mCount );
+    }
+
+    /// <summary>
+    /// 文字列を取得
+    /// </summary>
+    /// <param name="ref">文字列の参照</param>
+    /// <returns>文字列(範囲外なら空)</returns>
+    std::string_view GetString( const CookedModelFormat::StringRef& ref ) const;
+
+    /// <summary>ファイルサイズを取得</summary>
+    size_t GetFileSize() const { return mFile.GetSize(); }
+
+    /// <summary>
+    /// 元のモデルのパスからクックしたファイルのパスを取得
+    /// </summary>
+    /// <param name="sourcePath">元のモデルのパス</param>
+    /// <returns>クックしたファイルのパス</returns>
+    static std::string GetCookedPath( const std::string& sourcePath );
+
+    /// <summary>
+    /// クックしたファイルが元のモデルより新しいか(元が無ければクックしたファイルがあるか)
+    /// </summary>
+    /// <param name="sourcePath">元のモデルのパス</param>
+    /// <param name="cookedPath">クックしたファイルのパス</param>
+    /// <returns>新しいか</returns>
+    static bool IsUpToDate( const std::string& sourcePath, const std::string& cookedPath );
+};
+
+/// <summary>
+/// クックしたモデルの書き出し
+/// </summary>
+class CookedModelWriter
+{
+   private:
+    // ブロック
+    std::vector<uint8_t> mBlobs[static_cast<uint32_t>( CookedModelFormat::BlobType::kCount )];
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    CookedModelWriter();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~CookedModelWriter() = default;
+
+    /// <summary>
+    /// ブロックの末尾へ要素を追加
+    /// </summary>
+    /// <param name="type">ブロックの種類</param>
+    /// <param name="elements">要素</param>
+    /// <returns>追加した範囲</returns>
+    template <class T>
+    CookedModelFormat::Range Append( CookedModelFormat::BlobType type, std::span<const T> elements )
+    {
+        auto& blob = mBlobs[static_cast<uint32_t>( type )];
+        CookedModelFormat::Range range = {};
+        range.mOffset = static_cast<uint32_t>( blob.size() / sizeof( T ) );
+        range.mCount = static_cast<uint32_t>( elements.size() );
+        auto bytes = std::as_bytes( elements );
+        blob.insert( blob.end(), reinterpret_cast<const uint8_t*>( bytes.data() ), reinterpret_cast<const uint8_t*>( bytes.data() ) + bytes.size() );
+        return range;
+    }
+
+    /// <summary>
+    /// ブロックの末尾へ要素を1つ追加
+    /// </summary>
+    /// <param name="type">ブロックの種類</param>
+    /// <param name="element">要素</param>
+    /// <returns>追加した要素のインデックス</returns>
+    template <class T>
+    uint32_t Add( CookedModelFormat::BlobType type, const T& element )
+    {
+        return Append( type, std::span<const T>( &element, 1 ) ).mOffset;
+    }
+
+    /// <summary>
+    /// 文字列を追加
+    /// </summary>
+    /// <param name="str">文字列</param>
+    /// <returns>文字列の参照</returns>
+    CookedModelFormat::StringRef AddString( std::string_view str );
+
+    /// <summary>
+    /// ファイルへ書き出す
+    /// </summary>
+    /// <param name="path">ファイルのパス</param>
+    /// <returns>成否</returns>
+    bool Write( const std::string& path ) const;
+};
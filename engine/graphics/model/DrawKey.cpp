@@ -0,0 +1,199 @@
+#include "DrawKey.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+
+// 桁(8bit)の数とその段階
+const uint32_t kRadixBits = 8;
+const uint32_t kRadixSize = 1u << kRadixBits;
+const uint32_t kPassCount = 64 / kRadixBits;
+
+// レンダーキューの順(2bit)
+uint64_t GetQueueBits( RenderQueue queue )
+{
+    switch( queue )
+    {
+        case RenderQueue::Opaque:
+            return 0;
+
+        case RenderQueue::Transparent:
+            return 1;
+
+        default:
+            return 2;
+    }
+}
+
+}  // namespace
+
+namespace DrawKey
+{
+
+// キーを作成
+uint64_t Make( RenderQueue queue, float distance, uint32_t psoId, const void* material, const void* mesh )
+{
+    auto key = GetQueueBits( queue ) << 62;
+    auto pso = static_cast<uint64_t>( psoId & ( ( 1u << kPSOIdBits ) - 1 ) );
+    auto materialId = static_cast<uint64_t>( HashPointer( material ) );
+    distance = ( std::max )( distance, 0.0f );
+
+    if( queue == RenderQueue::Transparent )
+    {
+        // Back-to-Front
+        // 正の浮動小数のビットは大小の順に並ぶので、反転すると遠い順になる
+        auto depth = static_cast<uint64_t>( ~std::bit_cast<uint32_t>( distance ) );
+        return key | ( depth << 30 ) | ( pso << 20 ) | ( materialId << 4 );
+    }
+
+    // Front-to-Back
+    // 量子化した距離 → PSO → マテリアル → メッシュ(同じものが続きやすい)
+    auto depth = static_cast<uint64_t>( ( std::min )( distance / kDepthUnit, static_cast<float>( kMaxQuantizedDepth ) ) );
+    return key | ( depth << kDepthShift ) | ( pso << 32 ) | ( materialId << 16 ) | static_cast<uint64_t>( HashPointer( mesh ) );
+}
+
+// 距離を段階にする変換を作成
+DepthBuckets MakeDepthBuckets( DepthBucketing bucketing, float bucketSize, uint32_t bucketCount, float minDistance, float maxDistance )
+{
+    DepthBuckets buckets = {};
+    if( bucketing == DepthBucketing::Linear )
+    {
+        buckets.mScale = 1.0f / ( std::max )( bucketSize, 1e-6f );
+        buckets.mMaxBucket = kMaxQuantizedDepth;
+        return buckets;
+    }
+
+    bucketCount = std::clamp( bucketCount, 1u, kMaxQuantizedDepth + 1 );
+    buckets.mMaxBucket = bucketCount - 1;
+    if( bucketing == DepthBucketing::Logarithmic )
+    {
+        // 0の対数はとれないので近い側は少し離す
+        minDistance = ( std::max )( minDistance, 1e-3f );
+        maxDistance = ( std::max )( maxDistance, minDistance );
+        buckets.mIsLogarithmic = true;
+        buckets.mMin = std::log( minDistance );
+        auto range = std::log( maxDistance ) - buckets.mMin;
+        buckets.mScale = range > 0.0f ? bucketCount / range : 0.0f;
+        return buckets;
+    }
+
+    buckets.mMin = minDistance;
+    auto range = maxDistance - minDistance;
+    buckets.mScale = range > 0.0f ? bucketCount / range : 0.0f;
+    return buckets;
+}
+
+// 距離を段階にする
+uint32_t QuantizeDepth( const DepthBuckets& buckets, float distance )
+{
+    auto value = buckets.mIsLogarithmic ? std::log( ( std::max )( distance, 1e-3f ) ) : distance;
+    auto bucket = ( value - buckets.mMin ) * buckets.mScale;
+    if( !( bucket > 0.0f ) ) return 0;
+
+    return static_cast<uint32_t>( ( std::min )( bucket, static_cast<float>( buckets.mMaxBucket ) ) );
+}
+
+// 不透明のキーの距離の段階を置き換える
+uint64_t SetDepthBucket( uint64_t key, uint32_t bucket )
+{
+    if( !IsOpaque( key ) ) return key;
+
+    const auto kDepthMask = static_cast<uint64_t>( kMaxQuantizedDepth ) << kDepthShift;
+    return ( key & ~kDepthMask ) | ( static_cast<uint64_t>( ( std::min )( bucket, kMaxQuantizedDepth ) ) << kDepthShift );
+}
+
+// ポインタを16bitの番号にする
+uint32_t HashPointer( const void* ptr )
+{
+    auto v = static_cast<uint64_t>( reinterpret_cast<uintptr_t>( ptr ) );
+    v ^= v >> 29;
+    v *= 0x9E3779B97F4A7C15ull;
+    return static_cast<uint32_t>( v >> 48 );
+}
+
+// キーの昇順に安定ソートする
+void RadixSort( std::vector<Entry>& entries, std::vector<Entry>& temp )
+{
+    auto count = static_cast<uint32_t>( entries.size() );
+    if( count < 2 ) return;
+
+    // 全ての桁のヒストグラムを1回で数える
+    uint32_t histograms[kPassCount][kRadixSize] = {};
+    for( const auto& entry : entries )
+    {
+        for( uint32_t pass = 0; pass < kPassCount; ++pass )
+        {
+            ++histograms[pass][( entry.mKey >> ( pass * kRadixBits ) ) & ( kRadixSize - 1 )];
+        }
+    }
+
+    temp.resize( count );
+    auto* src = &entries;
+    auto* dst = &temp;
+    for( uint32_t pass = 0; pass < kPassCount; ++pass )
+    {
+        // 全て同じ桁なら並びは変わらない
+        auto& histogram = histograms[pass];
+        auto shift = pass * kRadixBits;
+        if( histogram[( ( *src )[0].mKey >> shift ) & ( kRadixSize - 1 )] == count ) continue;
+
+        // 桁ごとの書き込み先
+        uint32_t offset = 0;
+        for( auto& bucket : histogram )
+        {
+            auto n = bucket;
+            bucket = offset;
+            offset += n;
+        }
+        for( const auto& entry : *src )
+        {
+            ( *dst )[histogram[( entry.mKey >> shift ) & ( kRadixSize - 1 )]++] = entry;
+        }
+        std::swap( src, dst );
+    }
+
+    // 奇数回入れ替えたら作業用に結果がある
+    if( src != &entries )
+    {
+        entries.swap( temp );
+    }
+}
+
+// キーが前より小さくなる位置の数を数える
+uint32_t CountDescents( std::span<const Entry> entries )
+{
+    uint32_t count = 0;
+    for( size_t i = 1; i < entries.size(); ++i )
+    {
+        count += entries[i].mKey < entries[i - 1].mKey ? 1 : 0;
+    }
+    return count;
+}
+
+// キーの昇順に挿入ソートする
+bool InsertionSort( std::span<Entry> entries, uint64_t maxMoves, uint64_t& moves )
+{
+    moves = 0;
+    for( size_t i = 1; i < entries.size(); ++i )
+    {
+        if( entries[i - 1].mKey <= entries[i].mKey ) continue;
+
+        // 前の大きいものをずらして入れる
+        auto entry = entries[i];
+        auto j = i;
+        for( ; j > 0 && entries[j - 1].mKey > entry.mKey; --j )
+        {
+            entries[j] = entries[j - 1];
+        }
+        entries[j] = entry;
+
+        moves += i - j;
+        if( moves > maxMoves ) return false;
+    }
+    return true;
+}
+
+}  // namespace DrawKey
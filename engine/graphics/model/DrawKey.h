@@ -0,0 +1,133 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "RenderQueue.h"
+
+/// <summary>
+/// 描画アイテムの並び順を1つの64bit整数に詰めたキーと、その基数ソート(CPUのみ)
+/// キーの昇順がそのまま描画順になる
+///   不透明: [63:62]キュー [61:42]量子化した距離(近い順) [41:32]PSO [31:16]マテリアル [15:0]メッシュ
+///   半透明: [63:62]キュー [61:30]距離(遠い順) [29:20]PSO [19:4]マテリアル
+/// </summary>
+namespace DrawKey
+{
+
+/// <summary>
+/// 不透明の距離の段階の分け方
+/// </summary>
+enum class DepthBucketing
+{
+    Linear,       // 決まった幅(近くも遠くも同じ幅)
+    Logarithmic,  // 近平面から遠平面までを対数で決まった数に(近いほど細かい)
+    Adaptive,     // そのフレームの不透明なアイテムの最も近い距離から遠い距離までを決まった数に
+    FixedCount,   // 近平面から遠平面までを決まった数に
+};
+
+/// <summary>
+/// 距離を段階にする変換(段階 = (距離か距離の対数 - 最小) * 倍率)
+/// </summary>
+struct DepthBuckets
+{
+    float mMin;
+    float mScale;
+    bool mIsLogarithmic;
+    // 最大の段階
+    uint32_t mMaxBucket;
+};
+
+/// <summary>
+/// キーと描画アイテムの番号の組
+/// </summary>
+struct Entry
+{
+    uint64_t mKey;
+    uint32_t mIndex;
+};
+
+// PSOの番号のビット数
+constexpr uint32_t kPSOIdBits = 10;
+// 不透明の距離の量子化の単位と、表せる最大の段階
+constexpr float kDepthUnit = 1.0f;
+constexpr uint32_t kMaxQuantizedDepth = ( 1u << 20 ) - 1;
+// 不透明の距離の段階の位置
+constexpr uint32_t kDepthShift = 42;
+
+/// <summary>
+/// キーを作成
+/// </summary>
+/// <param name="queue">レンダーキュー</param>
+/// <param name="distance">カメラからの距離</param>
+/// <param name="psoId">PSOの番号(下位kPSOIdBitsだけ使う)</param>
+/// <param name="material">マテリアル</param>
+/// <param name="mesh">メッシュ</param>
+/// <returns>キー</returns>
+uint64_t Make( RenderQueue queue, float distance, uint32_t psoId, const void* material, const void* mesh );
+
+/// <summary>
+/// 距離を段階にする変換を作成
+/// </summary>
+/// <param name="bucketing">分け方</param>
+/// <param name="bucketSize">段階の幅(Linear)</param>
+/// <param name="bucketCount">段階の数(Linear以外)</param>
+/// <param name="minDistance">最も近い距離(Linear以外、近平面かそのフレームの最小)</param>
+/// <param name="maxDistance">最も遠い距離(Linear以外、遠平面かそのフレームの最大)</param>
+/// <returns>変換</returns>
+DepthBuckets MakeDepthBuckets( DepthBucketing bucketing, float bucketSize, uint32_t bucketCount, float minDistance, float maxDistance );
+
+/// <summary>
+/// 距離を段階にする
+/// </summary>
+/// <param name="buckets">変換</param>
+/// <param name="distance">カメラからの距離</param>
+/// <returns>段階(範囲外は端の段階)</returns>
+uint32_t QuantizeDepth( const DepthBuckets& buckets, float distance );
+
+/// <summary>
+/// 不透明のキーの距離の段階を置き換える(不透明以外はそのまま)
+/// </summary>
+/// <param name="key">キー</param>
+/// <param name="bucket">段階</param>
+/// <returns>キー</returns>
+uint64_t SetDepthBucket( uint64_t key, uint32_t bucket );
+
+/// <summary>
+/// 不透明のキーか
+/// </summary>
+/// <param name="key">キー</param>
+/// <returns>不透明ならtrue</returns>
+constexpr bool IsOpaque( uint64_t key ) { return ( key >> 62 ) == 0; }
+
+/// <summary>
+/// ポインタを16bitの番号にする(同じポインタは同じ番号、衝突しても並びがまとまりにくくなるだけ)
+/// </summary>
+/// <param name="ptr">ポインタ</param>
+/// <returns>番号</returns>
+uint32_t HashPointer( const void* ptr );
+
+/// <summary>
+/// キーの昇順に安定ソートする(8bitずつのLSD基数ソート、全て同じ桁は飛ばす)
+/// </summary>
+/// <param name="entries">ソートする組</param>
+/// <param name="temp">作業用(容量は使い回す)</param>
+void RadixSort( std::vector<Entry>& entries, std::vector<Entry>& temp );
+
+/// <summary>
+/// キーが前より小さくなる位置の数を数える(0ならソート済み、並びの乱れの目安)
+/// </summary>
+/// <param name="entries">組</param>
+/// <returns>数</returns>
+uint32_t CountDescents( std::span<const Entry> entries );
+
+/// <summary>
+/// キーの昇順に挿入ソートする(ほぼ並んでいれば速い、安定)
+/// 動かした回数が上限を超えたら途中でやめる(組の並びは入れ替わったまま)
+/// </summary>
+/// <param name="entries">ソートする組</param>
+/// <param name="maxMoves">動かす回数の上限</param>
+/// <param name="moves">動かした回数(出力)</param>
+/// <returns>ソートし終えたか</returns>
+bool InsertionSort( std::span<Entry> entries, uint64_t maxMoves, uint64_t& moves );
+
+}  // namespace DrawKey
@@ -0,0 +1,39 @@
+#include "InstanceGrouping.h"
+
+namespace InstanceGrouping
+{
+
+// 同じものを描くか
+bool IsSameDraw( const Key& a, const Key& b )
+{
+    return a.mMesh == b.mMesh &&
+           a.mMaterial == b.mMaterial &&
+           a.mVB == b.mVB &&
+           a.mPSOKey == b.mPSOKey &&
+           a.mLod == b.mLod &&
+           a.mIndexOffset == b.mIndexOffset &&
+           a.mIndexCount == b.mIndexCount;
+}
+
+// 連続して同じものを描くアイテムをまとめる
+void Build( std::span<const Key> keys, uint32_t maxInstances, std::vector<Run>& runs )
+{
+    runs.clear();
+    for( uint32_t i = 0; i < static_cast<uint32_t>( keys.size() ); ++i )
+    {
+        // 直前の範囲に続けられればまとめる
+        if( !runs.empty() && keys[i].mCanInstance )
+        {
+            auto& run = runs.back();
+            const auto& first = keys[run.mFirst];
+            if( first.mCanInstance && run.mCount < maxInstances && IsSameDraw( first, keys[i] ) )
+            {
+                ++run.mCount;
+                continue;
+            }
+        }
+        runs.emplace_back( Run{ i, 1 } );
+    }
+}
+
+}  // namespace InstanceGrouping
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// インスタンシングでまとめる描画アイテムの判定(CPUのみ)
+/// ソート済みの並びで連続して同じものを描くアイテムを1回の描画にまとめる
+/// </summary>
+namespace InstanceGrouping
+{
+
+/// <summary>
+/// 描画アイテムのキー(すべて同じならまとめられる)
+/// </summary>
+struct Key
+{
+    const void* mMesh;
+    const void* mMaterial;
+    // 差し替える頂点バッファ
+    const void* mVB;
+    uint64_t mPSOKey;
+    uint32_t mLod;
+    // インデックスの範囲(数が0なら詳細度の範囲)
+    uint32_t mIndexOffset;
+    uint32_t mIndexCount;
+    // 変換行列を構造化バッファへ写せるか(できなければ単独で描画する)
+    bool mCanInstance;
+};
+
+/// <summary>
+/// 1回の描画でまとめて描くアイテムの範囲
+/// </summary>
+struct Run
+{
+    uint32_t mFirst;
+    uint32_t mCount;
+};
+
+/// <summary>
+/// 同じものを描くか
+/// </summary>
+/// <param name="a">キー</param>
+/// <param name="b">キー</param>
+/// <returns>同じならtrue</returns>
+bool IsSameDraw( const Key& a, const Key& b );
+
+/// <summary>
+/// 連続して同じものを描くアイテムをまとめる
+/// </summary>
+/// <param name="keys">ソート済みの描画アイテムのキー</param>
+/// <param name="maxInstances">1回の描画でまとめる最大数</param>
+/// <param name="runs">範囲(出力、並び順、全てのアイテムを含む)</param>
+void Build( std::span<const Key> keys, uint32_t maxInstances, std::vector<Run>& runs );
+
+}  // namespace InstanceGrouping
@@ -27,6 +27,7 @@ class Material
 {
     friend class ModelData;
     friend class ModelInstance;
+    friend class StaticBatch;
 
    private:
     /// <summary>
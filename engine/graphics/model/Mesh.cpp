@@ -1,5 +1,8 @@
 #include "Mesh.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "core/CommandList.h"
 
 // コンストラクタ
@@ -8,8 +11,14 @@ Mesh::Mesh()
     , mFlags( MeshFlags::Required )
     , mVertices()
     , mVB( nullptr )
+    , mDequantizeMat()
     , mIndices()
+    , mLodIndices()
+    , mLods()
+    , mMeshletIndices()
+    , mMeshlets()
     , mIB( nullptr )
+    , mIndexStride( 0 )
     , mMaterialIdx( 0 )
 {
 }
@@ -19,67 +28,194 @@ bool Mesh::Create( MeshFlags flags, const std::vector<Vertex>& vertices )
 {
     mFlags = flags;
     mVertices = vertices;
+    mLods.clear();
+    mMeshletIndices.clear();
+    mMeshlets.clear();
 
-    if( !CreateVB() ) return false;
+    std::vector<uint8_t> data;
+    EncodeVertices( data, mDequantizeMat );
+    if( !CreateVB( data ) ) return false;
 
     return true;
 }
 
 // 作成（頂点インデックスあり）
-bool Mesh::Create( MeshFlags flags, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices )
+bool Mesh::Create( MeshFlags flags, std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Lod> lods, std::span<const uint32_t> lodIndices, std::span<const Meshlet> meshlets, std::span<const uint32_t> meshletIndices )
 {
-    mFlags = flags;
-    mVertices = vertices;
-    mIndices = indices;
+    if( !SetData( flags, vertices, indices, lods, lodIndices, meshlets, meshletIndices ) ) return false;
 
-    if( !CreateVB() ) return false;
+    std::vector<uint8_t> data;
+    EncodeVertices( data, mDequantizeMat );
+    if( !CreateVB( data ) ) return false;
 
-    if( !CreateIB() ) return false;
+    auto indexStride = EncodeIndices( data );
+    if( !CreateIB( data, indexStride ) ) return false;
 
     return true;
 }
 
+// 作成（圧縮済みのバッファから）
+bool Mesh::Create( MeshFlags flags, std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Lod> lods, std::span<const uint32_t> lodIndices, std::span<const Meshlet> meshlets, std::span<const uint32_t> meshletIndices, const EncodedData& encoded )
+{
+    if( !SetData( flags, vertices, indices, lods, lodIndices, meshlets, meshletIndices ) ) return false;
+
+    // 作り直したときと同じ大きさ・形式か
+    auto indexCount = mIndices.size() + mLodIndices.size() + mMeshletIndices.size();
+    auto indexStride = static_cast<uint32_t>( mVertices.size() < VertexCompression::kMax16BitVertexCount ? sizeof( uint16_t ) : sizeof( uint32_t ) );
+    if( encoded.mVertexData.size() != mVertices.size() * GetVertexStride() ) return false;
+    if( encoded.mIndexStride != indexStride || encoded.mIndexData.size() != indexCount * indexStride ) return false;
+
+    mDequantizeMat = encoded.mDequantizeMat;
+    if( !CreateVB( encoded.mVertexData ) ) return false;
+
+    if( !CreateIB( encoded.mIndexData, encoded.mIndexStride ) ) return false;
+
+    return true;
+}
+
+// 頂点バッファに書き込むデータを作成
+void Mesh::EncodeVertices( std::vector<uint8_t>& data, Matrix4& dequantizeMat ) const
+{
+    // メッシュフラグの形式に詰める(圧縮しなければVertexのまま)
+    VertexCompression::Encode( mFlags, mVertices, data, dequantizeMat );
+}
+
+// インデックスバッファに書き込むデータを作成
+uint32_t Mesh::EncodeIndices( std::vector<uint8_t>& data ) const
+{
+    // LOD0の後ろにLOD1以降、メッシュレット順のLOD0を続ける
+    std::vector<uint32_t> indices;
+    indices.reserve( mIndices.size() + mLodIndices.size() + mMeshletIndices.size() );
+    indices.insert( indices.end(), mIndices.begin(), mIndices.end() );
+    indices.insert( indices.end(), mLodIndices.begin(), mLodIndices.end() );
+    indices.insert( indices.end(), mMeshletIndices.begin(), mMeshletIndices.end() );
+
+    if( mVertices.size() < VertexCompression::kMax16BitVertexCount )
+    {
+        // 16bitで足りる
+        std::vector<uint16_t> indices16( indices.begin(), indices.end() );
+        data.resize( indices16.size() * sizeof( uint16_t ) );
+        memcpy( data.data(), indices16.data(), data.size() );
+        return sizeof( uint16_t );
+    }
+
+    data.resize( indices.size() * sizeof( uint32_t ) );
+    memcpy( data.data(), indices.data(), data.size() );
+    return sizeof( uint32_t );
+}
+
 // 描画
-void Mesh::Draw( CommandList* cmdList )
+void Mesh::Draw( CommandList* cmdList, VertexBuffer* vb, uint32_t lod, uint32_t instanceCount )
 {
     if( !cmdList || !mVB ) return;
 
-    cmdList->SetVertexBuffer( mVB.get() );
+    cmdList->SetVertexBuffer( vb ? vb : mVB.get() );
     if( mIB )
     {
         // 頂点インデックスあり
+        const auto& range = mLods[( std::min )( lod, static_cast<uint32_t>( mLods.size() - 1 ) )];
         cmdList->SetIndexBuffer( mIB.get() );
-        cmdList->DrawIndexedInstanced( static_cast<uint32_t>( mIndices.size() ) );
+        cmdList->DrawIndexedInstanced( range.mIndexCount, range.mIndexOffset, instanceCount );
     }
     else
     {
         // 頂点インデックスなし
-        cmdList->DrawInstanced( static_cast<uint32_t>( mVertices.size() ) );
+        cmdList->DrawInstanced( static_cast<uint32_t>( mVertices.size() ), instanceCount );
+    }
+}
+
+// インデックスバッファの範囲を描画
+void Mesh::DrawRange( CommandList* cmdList, uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount )
+{
+    if( !cmdList || !mVB || !mIB || indexCount == 0 ) return;
+
+    cmdList->SetVertexBuffer( mVB.get() );
+    cmdList->SetIndexBuffer( mIB.get() );
+    cmdList->DrawIndexedInstanced( indexCount, indexOffset, instanceCount );
+}
+
+// 三角形を取得
+void Mesh::GetTriangles( std::vector<Vector3>& positions, std::vector<uint32_t>& indices ) const
+{
+    positions.resize( mVertices.size() );
+    for( size_t i = 0; i < mVertices.size(); ++i )
+    {
+        const auto& p = mVertices[i].mPosition;
+        positions[i] = Vector3( p.x, p.y, p.z );
+    }
+
+    if( !mIndices.empty() )
+    {
+        indices = mIndices;
+    }
+    else
+    {
+        // 頂点インデックスなしは頂点の並び順
+        indices.resize( mVertices.size() );
+        for( uint32_t i = 0; i < static_cast<uint32_t>( indices.size() ); ++i )
+        {
+            indices[i] = i;
+        }
+    }
+}
+
+// 頂点データとインデックスデータを設定
+bool Mesh::SetData( MeshFlags flags, std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Lod> lods, std::span<const uint32_t> lodIndices, std::span<const Meshlet> meshlets, std::span<const uint32_t> meshletIndices )
+{
+    mFlags = flags;
+    mVertices.assign( vertices.begin(), vertices.end() );
+    mIndices.assign( indices.begin(), indices.end() );
+    mLodIndices.assign( lodIndices.begin(), lodIndices.end() );
+    mMeshletIndices.assign( meshletIndices.begin(), meshletIndices.end() );
+
+    // LOD1以降はインデックスバッファ内の範囲に直す
+    auto indexCount = static_cast<uint32_t>( mIndices.size() );
+    mLods.clear();
+    mLods.emplace_back( Lod{ 0, indexCount, 0.0f, 0.0f } );
+    for( const auto& lod : lods )
+    {
+        if( static_cast<uint64_t>( lod.mIndexOffset ) + lod.mIndexCount > mLodIndices.size() ) return false;
+
+        auto& added = mLods.emplace_back( lod );
+        added.mIndexOffset += indexCount;
     }
+
+    // メッシュレットはLODの後ろに続くインデックスバッファ内の範囲に直す
+    auto meshletBase = indexCount + static_cast<uint32_t>( mLodIndices.size() );
+    mMeshlets.assign( meshlets.begin(), meshlets.end() );
+    for( auto& meshlet : mMeshlets )
+    {
+        if( static_cast<uint64_t>( meshlet.mIndexOffset ) + meshlet.mIndexCount > mMeshletIndices.size() ) return false;
+
+        meshlet.mIndexOffset += meshletBase;
+    }
+
+    return true;
 }
 
 // 頂点バッファを作成
-bool Mesh::CreateVB()
+bool Mesh::CreateVB( std::span<const uint8_t> data )
 {
     mVB = std::make_unique<VertexBuffer>();
-    if( !mVB->Create( static_cast<uint32_t>( mVertices.size() * sizeof( Vertex ) ), sizeof( Vertex ) ) )
+    if( !mVB->Create( static_cast<uint32_t>( data.size() ), GetVertexStride() ) )
     {
         return false;
     }
-    mVB->Update( mVertices.data() );
+    mVB->Update( data.data() );
 
     return true;
 }
 
 // インデックスバッファを作成
-bool Mesh::CreateIB()
+bool Mesh::CreateIB( std::span<const uint8_t> data, uint32_t indexStride )
 {
     mIB = std::make_unique<IndexBuffer>();
-    if( !mIB->Create( static_cast<uint32_t>( mIndices.size() * sizeof( uint32_t ) ) ) )
+    mIndexStride = indexStride;
+    if( !mIB->Create( static_cast<uint32_t>( data.size() ), indexStride == sizeof( uint16_t ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT ) )
     {
         return false;
     }
-    mIB->Update( mIndices.data() );
+    mIB->Update( data.data() );
 
     return true;
 }
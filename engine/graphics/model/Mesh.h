@@ -1,9 +1,14 @@
 #pragma once
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "MeshLod.h"
+#include "MeshVertex.h"
+#include "Meshlet.h"
 #include "PSOKey.h"
+#include "VertexCompression.h"
 #include "core/IndexBuffer.h"
 #include "core/VertexBuffer.h"
 #include "math/Primitive.h"
@@ -25,11 +30,26 @@ class Mesh
     /// <summary>
     /// 頂点データ
     /// </summary>
-    struct Vertex
+    using Vertex = MeshVertex;
+
+    /// <summary>
+    /// 詳細度
+    /// </summary>
+    using Lod = MeshLod;
+
+    /// <summary>
+    /// バッファにそのまま書き込める形式のデータ(クックしたファイルから読む)
+    /// </summary>
+    struct EncodedData
     {
-        Vector4 mPosition;
-        Vector3 mNormal;
-        Vector2 mUV;
+        // 頂点バッファ(メッシュフラグの形式に圧縮済み)
+        std::span<const uint8_t> mVertexData;
+        // 量子化した位置をモデル空間に戻す行列
+        Matrix4 mDequantizeMat;
+        // インデックスバッファ(LOD0・LOD1以降・メッシュレット順のLOD0を連結済み)
+        std::span<const uint8_t> mIndexData;
+        // インデックス1つのサイズ
+        uint32_t mIndexStride;
     };
 
    private:
@@ -40,12 +60,24 @@ class Mesh
     MeshFlags mFlags;
     // 頂点データ
     std::vector<Vertex> mVertices;
-    // 頂点バッファ
+    // 頂点バッファ(mFlagsの形式に圧縮)
     std::unique_ptr<VertexBuffer> mVB;
-    // 頂点インデックスデータ
+    // 量子化した位置をモデル空間に戻す行列(QuantizedPositionでなければ単位行列)
+    Matrix4 mDequantizeMat;
+    // 頂点インデックスデータ(LOD0)
     std::vector<uint32_t> mIndices;
-    // インデックスバッファ
+    // LOD1以降の頂点インデックスデータ(インデックスバッファではmIndicesの後ろに続く)
+    std::vector<uint32_t> mLodIndices;
+    // 詳細度(LOD0を含む、範囲はインデックスバッファ内)
+    std::vector<Lod> mLods;
+    // メッシュレット順に並べたLOD0の頂点インデックスデータ(インデックスバッファではLODの後ろに続く)
+    std::vector<uint32_t> mMeshletIndices;
+    // メッシュレット(範囲はインデックスバッファ内)
+    std::vector<Meshlet> mMeshlets;
+    // インデックスバッファ(頂点が65536未満なら16bit)
     std::unique_ptr<IndexBuffer> mIB;
+    // インデックス1つのサイズ(インデックスバッファが無ければ0)
+    uint32_t mIndexStride;
 
     AABB3D mAABB;
 
@@ -77,25 +109,121 @@ class Mesh
     /// <param name="flags">メッシュフラグ</param>
     /// <param name="vertices">頂点データ</param>
     /// <param name="indices">頂点インデックスデータ</param>
+    /// <param name="lods">LOD1以降(範囲はlodIndices内)</param>
+    /// <param name="lodIndices">LOD1以降の頂点インデックスデータ</param>
+    /// <param name="meshlets">メッシュレット(範囲はmeshletIndices内)</param>
+    /// <param name="meshletIndices">メッシュレット順に並べたLOD0の頂点インデックスデータ</param>
     /// <returns>成否</returns>
-    bool Create( MeshFlags flags, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices );
+    bool Create( MeshFlags flags, std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Lod> lods = {}, std::span<const uint32_t> lodIndices = {}, std::span<const Meshlet> meshlets = {}, std::span<const uint32_t> meshletIndices = {} );
+
+    /// <summary>
+    /// 作成(バッファは圧縮し直さずにそのまま書き込む)
+    /// </summary>
+    /// <param name="flags">メッシュフラグ</param>
+    /// <param name="vertices">頂点データ</param>
+    /// <param name="indices">頂点インデックスデータ</param>
+    /// <param name="lods">LOD1以降(範囲はlodIndices内)</param>
+    /// <param name="lodIndices">LOD1以降の頂点インデックスデータ</param>
+    /// <param name="meshlets">メッシュレット(範囲はmeshletIndices内)</param>
+    /// <param name="meshletIndices">メッシュレット順に並べたLOD0の頂点インデックスデータ</param>
+    /// <param name="encoded">バッファのデータ(flagsとインデックスに合っていなければ失敗)</param>
+    /// <returns>成否</returns>
+    bool Create( MeshFlags flags, std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Lod> lods, std::span<const uint32_t> lodIndices, std::span<const Meshlet> meshlets, std::span<const uint32_t> meshletIndices, const EncodedData& encoded );
+
+    /// <summary>
+    /// 頂点バッファに書き込むデータを作成(クック用)
+    /// </summary>
+    /// <param name="data">メッシュフラグの形式に圧縮した頂点(出力)</param>
+    /// <param name="dequantizeMat">量子化した位置をモデル空間に戻す行列(出力)</param>
+    void EncodeVertices( std::vector<uint8_t>& data, Matrix4& dequantizeMat ) const;
+
+    /// <summary>
+    /// インデックスバッファに書き込むデータを作成(クック用)
+    /// </summary>
+    /// <param name="data">LOD0・LOD1以降・メッシュレット順のLOD0を連結したインデックス(出力)</param>
+    /// <returns>インデックス1つのサイズ</returns>
+    uint32_t EncodeIndices( std::vector<uint8_t>& data ) const;
 
     /// <summary>
     /// 描画
     /// </summary>
     /// <param name="cmdList">コマンドリスト</param>
-    void Draw( CommandList* cmdList );
+    /// <param name="vb">頂点バッファ(スキニング済みなど、nullptrならメッシュのもの)</param>
+    /// <param name="lod">詳細度</param>
+    /// <param name="instanceCount">インスタンス数</param>
+    void Draw( CommandList* cmdList, VertexBuffer* vb = nullptr, uint32_t lod = 0, uint32_t instanceCount = 1 );
+
+    /// <summary>
+    /// インデックスバッファの範囲を描画(静的バッチのセルなど)
+    /// </summary>
+    /// <param name="cmdList">コマンドリスト</param>
+    /// <param name="indexOffset">先頭のインデックス</param>
+    /// <param name="indexCount">インデックス数</param>
+    /// <param name="instanceCount">インスタンス数</param>
+    void DrawRange( CommandList* cmdList, uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount = 1 );
+
+    /// <summary>
+    /// 三角形を取得(コリジョン用)
+    /// </summary>
+    /// <param name="positions">頂点座標(出力)</param>
+    /// <param name="indices">三角形の頂点インデックス(出力)</param>
+    void GetTriangles( std::vector<Vector3>& positions, std::vector<uint32_t>& indices ) const;
+
+    /// <summary>頂点データを取得</summary>
+    const std::vector<Vertex>& GetVertices() const { return mVertices; }
+
+    /// <summary>頂点インデックスデータを取得</summary>
+    const std::vector<uint32_t>& GetIndices() const { return mIndices; }
+
+    /// <summary>詳細度の数を取得(LOD0を含む)</summary>
+    uint32_t GetLodCount() const { return static_cast<uint32_t>( mLods.size() ); }
+
+    /// <summary>詳細度を取得</summary>
+    const Lod& GetLod( uint32_t lod ) const { return mLods[lod]; }
+
+    /// <summary>LOD1以降の頂点インデックスデータを取得</summary>
+    const std::vector<uint32_t>& GetLodIndices() const { return mLodIndices; }
+
+    /// <summary>メッシュレット順に並べたLOD0の頂点インデックスデータを取得</summary>
+    const std::vector<uint32_t>& GetMeshletIndices() const { return mMeshletIndices; }
+
+    /// <summary>メッシュレットを取得(範囲はインデックスバッファ内)</summary>
+    const std::vector<Meshlet>& GetMeshlets() const { return mMeshlets; }
+
+    /// <summary>メッシュフラグを取得</summary>
+    MeshFlags GetFlags() const { return mFlags; }
+
+    /// <summary>頂点バッファの1頂点のサイズを取得</summary>
+    uint32_t GetVertexStride() const { return VertexCompression::GetStride( mFlags ); }
+
+    /// <summary>インデックスバッファのインデックス1つのサイズを取得</summary>
+    uint32_t GetIndexStride() const { return mIndexStride; }
+
+    /// <summary>マテリアルのインデックスを取得</summary>
+    uint32_t GetMaterialIdx() const { return mMaterialIdx; }
+
+    /// <summary>量子化した位置をモデル空間に戻す行列を取得</summary>
+    const Matrix4& GetDequantizeMatrix() const { return mDequantizeMat; }
 
    private:
+    /// <summary>
+    /// 頂点データとインデックスデータを設定
+    /// </summary>
+    /// <returns>範囲が正しいか</returns>
+    bool SetData( MeshFlags flags, std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Lod> lods, std::span<const uint32_t> lodIndices, std::span<const Meshlet> meshlets, std::span<const uint32_t> meshletIndices );
+
     /// <summary>
     /// 頂点バッファを作成
     /// </summary>
+    /// <param name="data">メッシュフラグの形式に圧縮した頂点</param>
     /// <returns>成否</returns>
-    bool CreateVB();
+    bool CreateVB( std::span<const uint8_t> data );
 
     /// <summary>
     /// インデックスバッファを作成
     /// </summary>
+    /// <param name="data">連結したインデックス</param>
+    /// <param name="indexStride">インデックス1つのサイズ</param>
     /// <returns>成否</returns>
-    bool CreateIB();
+    bool CreateIB( std::span<const uint8_t> data, uint32_t indexStride );
 };
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// メッシュの詳細度(グラフィックスAPIに依存しない)
+/// 頂点はLOD0と共有し、インデックスバッファの範囲だけが異なる
+/// </summary>
+struct MeshLod
+{
+    // インデックスバッファ内の範囲
+    uint32_t mIndexOffset;
+    uint32_t mIndexCount;
+    // 元の形状からの誤差(モデル空間の距離)
+    float mError;
+    // 画面に占める大きさ(画面の高さに対する比)がこれを下回ったら使う
+    float mScreenSize;
+};
@@ -0,0 +1,449 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "math/Vector3.h"
+
+namespace
+{
+
+// 統合する頂点を探すハッシュの空き
+const uint32_t kEmptySlot = UINT32_MAX;
+// クラスタを細かく分けるACMRの閾値(これより良ければ区切っても損が小さい)
+const float kClusterACMR = 0.75f;
+// 細かく分けたクラスタの最小の三角形数
+const uint32_t kMinClusterSize = 16;
+
+// バイト列のハッシュ(FNV-1a)
+uint64_t HashBytes( const void* data, size_t size, uint64_t hash )
+{
+    auto bytes = static_cast<const uint8_t*>( data );
+    for( size_t i = 0; i < size; ++i )
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// 頂点(とスキンの影響)のハッシュ
+uint64_t HashVertex( const std::vector<MeshVertex>& vertices, const std::vector<SkinInfluence>* influences, uint32_t idx )
+{
+    auto hash = HashBytes( &vertices[idx], sizeof( MeshVertex ), 14695981039346656037ull );
+    if( influences )
+    {
+        hash = HashBytes( &( *influences )[idx], sizeof( SkinInfluence ), hash );
+    }
+    return hash;
+}
+
+// 頂点(とスキンの影響)がバイト単位で同じか
+bool IsSameVertex( const std::vector<MeshVertex>& vertices, const std::vector<SkinInfluence>* influences, uint32_t a, uint32_t b )
+{
+    if( memcmp( &vertices[a], &vertices[b], sizeof( MeshVertex ) ) != 0 ) return false;
+    if( influences && memcmp( &( *influences )[a], &( *influences )[b], sizeof( SkinInfluence ) ) != 0 ) return false;
+    return true;
+}
+
+// 頂点の並びを置き換える(remap[旧] = 新、UINT32_MAXは削除)
+template <class T>
+void RemapElements( std::vector<T>& elements, const std::vector<uint32_t>& remap, uint32_t newCount )
+{
+    std::vector<T> remapped( newCount );
+    for( size_t i = 0; i < remap.size(); ++i )
+    {
+        if( remap[i] == UINT32_MAX ) continue;
+
+        remapped[remap[i]] = elements[i];
+    }
+    elements = std::move( remapped );
+}
+
+// 頂点の位置
+Vector3 GetPosition( const MeshVertex& vertex )
+{
+    return Vector3( vertex.mPosition.x, vertex.mPosition.y, vertex.mPosition.z );
+}
+
+}  // namespace
+
+namespace MeshOptimizer
+{
+
+// 頂点キャッシュを再現して統計を求める
+VertexCacheStats AnalyzeVertexCache( const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize )
+{
+    VertexCacheStats stats = {};
+    auto triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+    if( triangleCount == 0 || vertexCount == 0 ) return stats;
+
+    // FIFO(頂点が入った時刻で判定する)
+    std::vector<uint32_t> timestamps( vertexCount, 0 );
+    std::vector<bool> isUsed( vertexCount, false );
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    uint32_t usedCount = 0;
+    for( uint32_t i = 0; i < triangleCount * 3; ++i )
+    {
+        auto v = indices[i];
+        if( v >= vertexCount ) continue;
+
+        if( time - timestamps[v] > cacheSize )
+        {
+            timestamps[v] = time++;
+            ++misses;
+        }
+        if( !isUsed[v] )
+        {
+            isUsed[v] = true;
+            ++usedCount;
+        }
+    }
+
+    stats.mACMR = static_cast<float>( misses ) / triangleCount;
+    stats.mATVR = usedCount > 0 ? static_cast<float>( misses ) / usedCount : 0.0f;
+    return stats;
+}
+
+// 四角形を短い方の対角線で分ける
+void TriangulateQuad( const std::vector<MeshVertex>& vertices, const uint32_t ( &quad )[4], std::vector<uint32_t>& indices )
+{
+    auto diagonal02 = LengthSq( GetPosition( vertices[quad[0]] ) - GetPosition( vertices[quad[2]] ) );
+    auto diagonal13 = LengthSq( GetPosition( vertices[quad[1]] ) - GetPosition( vertices[quad[3]] ) );
+    if( diagonal02 <= diagonal13 )
+    {
+        indices.insert( indices.end(), { quad[0], quad[1], quad[2], quad[2], quad[3], quad[0] } );
+    }
+    else
+    {
+        indices.insert( indices.end(), { quad[0], quad[1], quad[3], quad[1], quad[2], quad[3] } );
+    }
+}
+
+// 同じ頂点を統合
+uint32_t WeldVertices( std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<SkinInfluence>* influences )
+{
+    auto vertexCount = static_cast<uint32_t>( vertices.size() );
+    if( vertexCount == 0 ) return 0;
+    if( influences && influences->size() != vertices.size() )
+    {
+        influences = nullptr;
+    }
+
+    // オープンアドレスのハッシュで最初に現れた同じ頂点を探す
+    uint32_t tableSize = 1;
+    while( tableSize < vertexCount * 2 )
+    {
+        tableSize <<= 1;
+    }
+    std::vector<uint32_t> table( tableSize, kEmptySlot );
+    std::vector<uint32_t> remap( vertexCount );
+    uint32_t newCount = 0;
+    for( uint32_t i = 0; i < vertexCount; ++i )
+    {
+        auto slot = static_cast<uint32_t>( HashVertex( vertices, influences, i ) ) & ( tableSize - 1 );
+        while( table[slot] != kEmptySlot && !IsSameVertex( vertices, influences, table[slot], i ) )
+        {
+            slot = ( slot + 1 ) & ( tableSize - 1 );
+        }
+        if( table[slot] == kEmptySlot )
+        {
+            table[slot] = i;
+            remap[i] = newCount++;
+        }
+        else
+        {
+            remap[i] = remap[table[slot]];
+        }
+    }
+    if( newCount == vertexCount ) return 0;
+
+    for( auto& idx : indices )
+    {
+        idx = remap[idx];
+    }
+    RemapElements( vertices, remap, newCount );
+    if( influences )
+    {
+        RemapElements( *influences, remap, newCount );
+    }
+    return vertexCount - newCount;
+}
+
+// 頂点キャッシュのヒットが増えるように三角形を並び替える
+void OptimizeVertexCache( std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& clusters, uint32_t cacheSize )
+{
+    clusters.clear();
+    auto triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+    if( triangleCount == 0 ) return;
+
+    // 頂点から三角形への隣接(CSR)
+    std::vector<uint32_t> offsets( vertexCount + 1, 0 );
+    for( uint32_t i = 0; i < triangleCount * 3; ++i )
+    {
+        ++offsets[indices[i] + 1];
+    }
+    for( uint32_t v = 0; v < vertexCount; ++v )
+    {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint32_t> adjacency( triangleCount * 3 );
+    std::vector<uint32_t> cursor( offsets.begin(), offsets.end() - 1 );
+    for( uint32_t i = 0; i < triangleCount * 3; ++i )
+    {
+        adjacency[cursor[indices[i]]++] = i / 3;
+    }
+
+    // 頂点を使う残りの三角形数
+    std::vector<uint32_t> liveCounts( vertexCount );
+    for( uint32_t v = 0; v < vertexCount; ++v )
+    {
+        liveCounts[v] = offsets[v + 1] - offsets[v];
+    }
+
+    std::vector<uint32_t> timestamps( vertexCount, 0 );
+    std::vector<bool> isEmitted( triangleCount, false );
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve( triangleCount * 3 );
+    uint32_t time = cacheSize + 1;
+    uint32_t scanIdx = 0;
+
+    // 扇の中心の頂点
+    auto fanning = indices[0];
+    clusters.emplace_back( 0 );
+    while( true )
+    {
+        // 中心の頂点を使う三角形をすべて出力
+        candidates.clear();
+        for( auto i = offsets[fanning]; i < offsets[fanning + 1]; ++i )
+        {
+            auto t = adjacency[i];
+            if( isEmitted[t] ) continue;
+
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                auto v = indices[t * 3 + k];
+                output.emplace_back( v );
+                deadEnds.emplace_back( v );
+                candidates.emplace_back( v );
+                --liveCounts[v];
+                if( time - timestamps[v] > cacheSize )
+                {
+                    timestamps[v] = time++;
+                }
+            }
+            isEmitted[t] = true;
+        }
+
+        // 次の中心はキャッシュに残る候補から(出力中に追い出されないもの)
+        // 追い出される候補(優先度0)は選ばない。扇を続けてもミスになるので行き止まりとして探し直す
+        uint32_t next = UINT32_MAX;
+        uint32_t bestPriority = 0;
+        for( auto v : candidates )
+        {
+            if( liveCounts[v] == 0 ) continue;
+            if( time - timestamps[v] + 2 * liveCounts[v] > cacheSize ) continue;
+
+            auto priority = time - timestamps[v];
+            if( priority > bestPriority )
+            {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        // 候補が無ければ行き止まり(最近使った頂点から、無ければ入力順で探す)
+        if( next == UINT32_MAX )
+        {
+            while( !deadEnds.empty() && next == UINT32_MAX )
+            {
+                auto v = deadEnds.back();
+                deadEnds.pop_back();
+                if( liveCounts[v] > 0 )
+                {
+                    next = v;
+                }
+            }
+            while( scanIdx < triangleCount * 3 && next == UINT32_MAX )
+            {
+                auto v = indices[scanIdx++];
+                if( liveCounts[v] > 0 )
+                {
+                    next = v;
+                }
+            }
+            if( next == UINT32_MAX ) break;
+
+            // キャッシュの局所性が切れるのでクラスタを区切る
+            clusters.emplace_back( static_cast<uint32_t>( output.size() / 3 ) );
+        }
+        fanning = next;
+    }
+
+    indices = std::move( output );
+}
+
+// 外側を向いたクラスタが先に描かれるように並び替える
+void OptimizeOverdraw( std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& clusters, float threshold )
+{
+    auto triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+    auto vertexCount = static_cast<uint32_t>( vertices.size() );
+    if( triangleCount == 0 || clusters.empty() ) return;
+
+    // キャッシュの効きが良い位置でクラスタをさらに細かく区切る
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> timestamps( vertexCount, 0 );
+    uint32_t time = MeshOptimizer::kCacheSize + 1;
+    for( size_t c = 0; c < clusters.size(); ++c )
+    {
+        auto begin = clusters[c];
+        auto end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        starts.emplace_back( begin );
+        uint32_t start = begin;
+        uint32_t misses = 0;
+        for( auto t = begin; t < end; ++t )
+        {
+            uint32_t triangleMisses = 0;
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                auto v = indices[t * 3 + k];
+                if( time - timestamps[v] > MeshOptimizer::kCacheSize )
+                {
+                    timestamps[v] = time++;
+                    ++triangleMisses;
+                }
+            }
+            misses += triangleMisses;
+
+            auto size = t + 1 - start;
+            if( t + 1 < end && size >= kMinClusterSize && static_cast<float>( misses ) / size <= kClusterACMR )
+            {
+                start = t + 1;
+                misses = 0;
+                starts.emplace_back( start );
+            }
+        }
+    }
+
+    // メッシュの中心
+    Vector3 meshCenter = Vector3::kZero;
+    auto meshArea = 0.0f;
+    for( uint32_t t = 0; t < triangleCount; ++t )
+    {
+        auto p0 = GetPosition( vertices[indices[t * 3 + 0]] );
+        auto p1 = GetPosition( vertices[indices[t * 3 + 1]] );
+        auto p2 = GetPosition( vertices[indices[t * 3 + 2]] );
+        auto area = Length( Cross( p1 - p0, p2 - p0 ) );
+        meshCenter += ( p0 + p1 + p2 ) * area;
+        meshArea += area;
+    }
+    if( meshArea <= 0.0f ) return;
+    meshCenter /= meshArea * 3.0f;
+
+    // クラスタの中心から向きに沿ってどれだけ外側にあるか(巻き順によらないように頂点の法線を使う)
+    struct Cluster
+    {
+        uint32_t mBegin;
+        uint32_t mEnd;
+        float mSortKey;
+    };
+    std::vector<Cluster> sorted( starts.size() );
+    for( size_t c = 0; c < starts.size(); ++c )
+    {
+        auto& cluster = sorted[c];
+        cluster.mBegin = starts[c];
+        cluster.mEnd = c + 1 < starts.size() ? starts[c + 1] : triangleCount;
+
+        Vector3 center = Vector3::kZero;
+        Vector3 normal = Vector3::kZero;
+        auto clusterArea = 0.0f;
+        for( auto t = cluster.mBegin; t < cluster.mEnd; ++t )
+        {
+            const auto& v0 = vertices[indices[t * 3 + 0]];
+            const auto& v1 = vertices[indices[t * 3 + 1]];
+            const auto& v2 = vertices[indices[t * 3 + 2]];
+            auto p0 = GetPosition( v0 );
+            auto p1 = GetPosition( v1 );
+            auto p2 = GetPosition( v2 );
+            auto area = Length( Cross( p1 - p0, p2 - p0 ) );
+            center += ( p0 + p1 + p2 ) * area;
+            normal += ( v0.mNormal + v1.mNormal + v2.mNormal ) * area;
+            clusterArea += area;
+        }
+        cluster.mSortKey = 0.0f;
+        if( clusterArea > 0.0f && LengthSq( normal ) > 0.0f )
+        {
+            center /= clusterArea * 3.0f;
+            cluster.mSortKey = Dot( center - meshCenter, Normalize( normal ) );
+        }
+    }
+    std::stable_sort(
+        sorted.begin(), sorted.end(),
+        []( const Cluster& a, const Cluster& b )
+        {
+            return a.mSortKey > b.mSortKey;
+        } );
+
+    std::vector<uint32_t> output;
+    output.reserve( indices.size() );
+    for( const auto& cluster : sorted )
+    {
+        output.insert( output.end(), indices.begin() + cluster.mBegin * 3, indices.begin() + cluster.mEnd * 3 );
+    }
+
+    // 頂点キャッシュが悪くなりすぎるなら元の順のまま
+    auto before = AnalyzeVertexCache( indices, vertexCount );
+    auto after = AnalyzeVertexCache( output, vertexCount );
+    if( after.mACMR > before.mACMR * threshold ) return;
+
+    indices = std::move( output );
+}
+
+// 頂点を最初に使われる順へ並べ替える
+void OptimizeVertexFetch( std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<SkinInfluence>* influences )
+{
+    if( influences && influences->size() != vertices.size() )
+    {
+        influences = nullptr;
+    }
+
+    std::vector<uint32_t> remap( vertices.size(), UINT32_MAX );
+    uint32_t newCount = 0;
+    for( auto& idx : indices )
+    {
+        if( remap[idx] == UINT32_MAX )
+        {
+            remap[idx] = newCount++;
+        }
+        idx = remap[idx];
+    }
+
+    RemapElements( vertices, remap, newCount );
+    if( influences )
+    {
+        RemapElements( *influences, remap, newCount );
+    }
+}
+
+// すべての最適化を順に行う
+MeshOptimizeStats Optimize( std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<SkinInfluence>* influences )
+{
+    MeshOptimizeStats stats = {};
+    stats.mVertexCountBefore = static_cast<uint32_t>( vertices.size() );
+    stats.mBefore = AnalyzeVertexCache( indices, stats.mVertexCountBefore );
+
+    WeldVertices( vertices, indices, influences );
+    std::vector<uint32_t> clusters;
+    OptimizeVertexCache( indices, static_cast<uint32_t>( vertices.size() ), clusters );
+    OptimizeOverdraw( indices, vertices, clusters );
+    OptimizeVertexFetch( vertices, indices, influences );
+
+    stats.mVertexCountAfter = static_cast<uint32_t>( vertices.size() );
+    stats.mAfter = AnalyzeVertexCache( indices, stats.mVertexCountAfter );
+    return stats;
+}
+
+}  // namespace MeshOptimizer
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "MeshVertex.h"
+#include "graphics/animation/Skinning.h"
+
+/// <summary>
+/// 頂点キャッシュの統計
+/// </summary>
+struct VertexCacheStats
+{
+    // 三角形あたりのキャッシュミス(Average Cache Miss Ratio、0.5～3)
+    float mACMR;
+    // 頂点あたりのキャッシュミス(Average Transformed Vertex Ratio、1が最適)
+    float mATVR;
+};
+
+/// <summary>
+/// メッシュの最適化の結果
+/// </summary>
+struct MeshOptimizeStats
+{
+    uint32_t mVertexCountBefore;
+    uint32_t mVertexCountAfter;
+    VertexCacheStats mBefore;
+    VertexCacheStats mAfter;
+};
+
+/// <summary>
+/// 読み込み時のメッシュの最適化(CPUのみ)
+/// 重複頂点の統合 → 頂点キャッシュ順(Tipsify) → オーバードローを減らすクラスタの並び替え → 頂点フェッチ順
+/// </summary>
+namespace MeshOptimizer
+{
+
+// 統計に使うFIFOの頂点キャッシュのサイズ
+inline constexpr uint32_t kCacheSize = 16;
+// オーバードローの並び替えで許容するACMRの悪化(倍率)
+inline constexpr float kOverdrawThreshold = 1.05f;
+
+/// <summary>
+/// 頂点キャッシュを再現して統計を求める
+/// </summary>
+/// <param name="indices">三角形の頂点インデックス</param>
+/// <param name="vertexCount">頂点数</param>
+/// <param name="cacheSize">キャッシュのサイズ</param>
+/// <returns>統計</returns>
+VertexCacheStats AnalyzeVertexCache( const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kCacheSize );
+
+/// <summary>
+/// 四角形を短い方の対角線で2枚の三角形に分ける(細長い三角形を避ける)
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="quad">四角形の頂点インデックス(周回順)</param>
+/// <param name="indices">三角形の頂点インデックス(末尾に追加)</param>
+void TriangulateQuad( const std::vector<MeshVertex>& vertices, const uint32_t ( &quad )[4], std::vector<uint32_t>& indices );
+
+/// <summary>
+/// 同じ頂点を統合(スキンの影響も一致するものだけ)
+/// </summary>
+/// <param name="vertices">頂点(入出力)</param>
+/// <param name="indices">三角形の頂点インデックス(入出力)</param>
+/// <param name="influences">頂点ごとのスキンの影響(入出力、nullptrなら無し)</param>
+/// <returns>減った頂点数</returns>
+uint32_t WeldVertices( std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<SkinInfluence>* influences );
+
+/// <summary>
+/// 頂点キャッシュのヒットが増えるように三角形を並び替える(Tipsify)
+/// </summary>
+/// <param name="indices">三角形の頂点インデックス(入出力)</param>
+/// <param name="vertexCount">頂点数</param>
+/// <param name="clusters">クラスタの先頭の三角形(出力、扇が途切れた位置)</param>
+/// <param name="cacheSize">キャッシュのサイズ</param>
+void OptimizeVertexCache( std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& clusters, uint32_t cacheSize = kCacheSize );
+
+/// <summary>
+/// 外側を向いたクラスタが先に描かれるように並び替える
+/// ACMRの悪化が閾値を超えるときは並び替えない
+/// </summary>
+/// <param name="indices">三角形の頂点インデックス(入出力、頂点キャッシュ順)</param>
+/// <param name="vertices">頂点</param>
+/// <param name="clusters">クラスタの先頭の三角形</param>
+/// <param name="threshold">許容するACMRの悪化(倍率)</param>
+void OptimizeOverdraw( std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& clusters, float threshold = kOverdrawThreshold );
+
+/// <summary>
+/// 頂点を最初に使われる順へ並べ替える(使われない頂点は削除)
+/// </summary>
+/// <param name="vertices">頂点(入出力)</param>
+/// <param name="indices">三角形の頂点インデックス(入出力)</param>
+/// <param name="influences">頂点ごとのスキンの影響(入出力、nullptrなら無し)</param>
+void OptimizeVertexFetch( std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<SkinInfluence>* influences );
+
+/// <summary>
+/// すべての最適化を順に行う
+/// </summary>
+/// <param name="vertices">頂点(入出力)</param>
+/// <param name="indices">三角形の頂点インデックス(入出力)</param>
+/// <param name="influences">頂点ごとのスキンの影響(入出力、nullptrなら無し)</param>
+/// <returns>最適化の前後の統計</returns>
+MeshOptimizeStats Optimize( std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<SkinInfluence>* influences );
+
+}  // namespace MeshOptimizer
@@ -0,0 +1,425 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "MeshOptimizer.h"
+#include "math/Vector3.h"
+
+namespace
+{
+
+// 頂点の種類
+enum class VertexKind : uint8_t
+{
+    // 自由に縮約できる
+    kManifold,
+    // 開いた境界上(境界の辺に沿ってのみ縮約できる)
+    kBorder,
+    // 縫い目・非多様体(動かさない)
+    kLocked,
+};
+
+// 境界の辺を保つ平面の重み
+const double kBorderWeight = 2.0;
+// 縮約で三角形の向きがこれ(cos)より変わるなら縮約しない
+const float kMaxNormalChange = 0.25f;
+
+/// <summary>
+/// 二次誤差(平面までの距離の2乗の和)
+/// </summary>
+struct Quadric
+{
+    double mA00, mA01, mA02, mA11, mA12, mA22;
+    double mB0, mB1, mB2;
+    double mC;
+    // 重み(面積)の合計
+    double mWeight;
+};
+
+/// <summary>
+/// 縮約の候補
+/// </summary>
+struct Collapse
+{
+    uint32_t mFrom;
+    uint32_t mTo;
+    float mCost;
+};
+
+// 頂点の位置
+Vector3 GetPosition( const MeshVertex& vertex )
+{
+    return Vector3( vertex.mPosition.x, vertex.mPosition.y, vertex.mPosition.z );
+}
+
+// 平面(n・p + d = 0)を加える
+void AddPlane( Quadric& q, const Vector3& n, float d, double weight )
+{
+    q.mA00 += weight * n.x * n.x;
+    q.mA01 += weight * n.x * n.y;
+    q.mA02 += weight * n.x * n.z;
+    q.mA11 += weight * n.y * n.y;
+    q.mA12 += weight * n.y * n.z;
+    q.mA22 += weight * n.z * n.z;
+    q.mB0 += weight * n.x * d;
+    q.mB1 += weight * n.y * d;
+    q.mB2 += weight * n.z * d;
+    q.mC += weight * d * d;
+    q.mWeight += weight;
+}
+
+// 二次誤差を足し合わせる
+void AddQuadric( Quadric& q, const Quadric& r )
+{
+    q.mA00 += r.mA00;
+    q.mA01 += r.mA01;
+    q.mA02 += r.mA02;
+    q.mA11 += r.mA11;
+    q.mA12 += r.mA12;
+    q.mA22 += r.mA22;
+    q.mB0 += r.mB0;
+    q.mB1 += r.mB1;
+    q.mB2 += r.mB2;
+    q.mC += r.mC;
+    q.mWeight += r.mWeight;
+}
+
+// 位置での二次誤差(重みで割った距離の2乗)
+double EvaluateQuadric( const Quadric& q, const Vector3& p )
+{
+    auto value =
+        q.mA00 * p.x * p.x + q.mA11 * p.y * p.y + q.mA22 * p.z * p.z +
+        2.0 * ( q.mA01 * p.x * p.y + q.mA02 * p.x * p.z + q.mA12 * p.y * p.z ) +
+        2.0 * ( q.mB0 * p.x + q.mB1 * p.y + q.mB2 * p.z ) +
+        q.mC;
+    return q.mWeight > 0.0 ? ( std::max )( value, 0.0 ) / q.mWeight : 0.0;
+}
+
+// 2つの位置のグループの辺のキー
+uint64_t MakeEdgeKey( uint32_t a, uint32_t b )
+{
+    return a < b ? ( static_cast<uint64_t>( a ) << 32 ) | b : ( static_cast<uint64_t>( b ) << 32 ) | a;
+}
+
+// 同じ位置の頂点をまとめる(位置のグループのインデックス)
+uint32_t GroupPositions( const std::vector<MeshVertex>& vertices, std::vector<uint32_t>& groups )
+{
+    std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;
+    groups.resize( vertices.size() );
+    uint32_t groupCount = 0;
+    for( uint32_t i = 0; i < static_cast<uint32_t>( vertices.size() ); ++i )
+    {
+        const auto& p = vertices[i].mPosition;
+        uint32_t bits[3] = {};
+        memcpy( &bits[0], &p.x, sizeof( float ) );
+        memcpy( &bits[1], &p.y, sizeof( float ) );
+        memcpy( &bits[2], &p.z, sizeof( float ) );
+        auto hash = ( static_cast<uint64_t>( bits[0] ) * 73856093ull ) ^ ( static_cast<uint64_t>( bits[1] ) * 19349663ull ) ^ ( static_cast<uint64_t>( bits[2] ) * 83492791ull );
+
+        auto& bucket = buckets[hash];
+        groups[i] = UINT32_MAX;
+        for( auto other : bucket )
+        {
+            const auto& q = vertices[other].mPosition;
+            if( p.x == q.x && p.y == q.y && p.z == q.z )
+            {
+                groups[i] = groups[other];
+                break;
+            }
+        }
+        if( groups[i] == UINT32_MAX )
+        {
+            groups[i] = groupCount++;
+            bucket.emplace_back( i );
+        }
+    }
+    return groupCount;
+}
+
+}  // namespace
+
+namespace MeshSimplifier
+{
+
+// 三角形が目標の数になるまで簡略化する
+float Simplify( const std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, uint32_t targetIndexCount )
+{
+    auto vertexCount = static_cast<uint32_t>( vertices.size() );
+    indices.resize( indices.size() / 3 * 3 );
+    if( indices.size() <= targetIndexCount || vertexCount == 0 ) return 0.0f;
+
+    // 位置のグループ(同じ位置に複数の頂点があれば縫い目)
+    std::vector<uint32_t> groups;
+    auto groupCount = GroupPositions( vertices, groups );
+    std::vector<uint32_t> groupSizes( groupCount, 0 );
+    for( auto group : groups )
+    {
+        ++groupSizes[group];
+    }
+
+    // 辺を共有する三角形の数(1なら境界、3以上なら非多様体)
+    std::unordered_map<uint64_t, uint32_t> edgeCounts;
+    auto countEdges = [&]()
+    {
+        edgeCounts.clear();
+        edgeCounts.reserve( indices.size() );
+        for( size_t i = 0; i < indices.size(); i += 3 )
+        {
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                ++edgeCounts[MakeEdgeKey( groups[indices[i + k]], groups[indices[i + ( k + 1 ) % 3]] )];
+            }
+        }
+    };
+    countEdges();
+    auto isBorderEdge = [&]( uint32_t a, uint32_t b )
+    {
+        auto it = edgeCounts.find( MakeEdgeKey( groups[a], groups[b] ) );
+        return it != edgeCounts.end() && it->second == 1;
+    };
+
+    // 頂点の種類と二次誤差
+    std::vector<VertexKind> kinds( vertexCount, VertexKind::kManifold );
+    for( uint32_t v = 0; v < vertexCount; ++v )
+    {
+        if( groupSizes[groups[v]] > 1 )
+        {
+            kinds[v] = VertexKind::kLocked;
+        }
+    }
+    std::vector<Quadric> quadrics( vertexCount, Quadric{} );
+    for( size_t i = 0; i < indices.size(); i += 3 )
+    {
+        auto p0 = GetPosition( vertices[indices[i + 0]] );
+        auto p1 = GetPosition( vertices[indices[i + 1]] );
+        auto p2 = GetPosition( vertices[indices[i + 2]] );
+        auto normal = Cross( p1 - p0, p2 - p0 );
+        auto area = Length( normal );
+        if( area <= 0.0f ) continue;
+
+        normal /= area;
+        for( uint32_t k = 0; k < 3; ++k )
+        {
+            AddPlane( quadrics[indices[i + k]], normal, -Dot( normal, p0 ), area * 0.5 );
+        }
+
+        // 境界の辺は辺を含み面に垂直な平面で形を保つ
+        for( uint32_t k = 0; k < 3; ++k )
+        {
+            auto a = indices[i + k];
+            auto b = indices[i + ( k + 1 ) % 3];
+            auto it = edgeCounts.find( MakeEdgeKey( groups[a], groups[b] ) );
+            if( it->second == 1 || it->second > 2 )
+            {
+                auto kind = it->second == 1 ? VertexKind::kBorder : VertexKind::kLocked;
+                for( auto v : { a, b } )
+                {
+                    kinds[v] = ( std::max )( kinds[v], kind );
+                }
+            }
+            if( it->second != 1 ) continue;
+
+            auto pa = GetPosition( vertices[a] );
+            auto edge = GetPosition( vertices[b] ) - pa;
+            auto edgeLength = Length( edge );
+            if( edgeLength <= 0.0f ) continue;
+
+            auto plane = Normalize( Cross( edge, normal ) );
+            auto weight = kBorderWeight * edgeLength * edgeLength;
+            AddPlane( quadrics[a], plane, -Dot( plane, pa ), weight );
+            AddPlane( quadrics[b], plane, -Dot( plane, pa ), weight );
+        }
+    }
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapseTo( vertexCount );
+    std::vector<uint8_t> isTouched( vertexCount );
+    auto maxCost = 0.0f;
+    while( indices.size() > targetIndexCount )
+    {
+        auto triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+        // 境界に沿った縮約で境界の辺がつながり直すので数え直す
+        countEdges();
+
+        // 頂点から三角形への隣接(CSR)
+        offsets.assign( vertexCount + 1, 0 );
+        for( auto v : indices )
+        {
+            ++offsets[v + 1];
+        }
+        for( uint32_t v = 0; v < vertexCount; ++v )
+        {
+            offsets[v + 1] += offsets[v];
+        }
+        adjacency.resize( indices.size() );
+        {
+            std::vector<uint32_t> cursor( offsets.begin(), offsets.end() - 1 );
+            for( uint32_t i = 0; i < triangleCount * 3; ++i )
+            {
+                adjacency[cursor[indices[i]]++] = i / 3;
+            }
+        }
+
+        // 縮約の候補(辺の両方向)
+        collapses.clear();
+        for( uint32_t i = 0; i < triangleCount * 3; ++i )
+        {
+            auto from = indices[i];
+            auto to = indices[i / 3 * 3 + ( i + 1 ) % 3];
+            for( uint32_t dir = 0; dir < 2; ++dir )
+            {
+                if( dir == 1 )
+                {
+                    std::swap( from, to );
+                }
+                if( from == to || kinds[from] == VertexKind::kLocked ) continue;
+                if( kinds[from] == VertexKind::kBorder && !isBorderEdge( from, to ) ) continue;
+
+                auto q = quadrics[from];
+                AddQuadric( q, quadrics[to] );
+                collapses.emplace_back( Collapse{ from, to, static_cast<float>( EvaluateQuadric( q, GetPosition( vertices[to] ) ) ) } );
+            }
+        }
+        if( collapses.empty() ) break;
+
+        std::sort(
+            collapses.begin(), collapses.end(),
+            []( const Collapse& a, const Collapse& b )
+            {
+                return a.mCost < b.mCost;
+            } );
+
+        // 安い順に、周りの頂点が動いていないものだけ縮約する(1回に2三角形ずつ減る)
+        auto collapseLimit = ( std::max )( static_cast<uint32_t>( ( indices.size() - targetIndexCount ) / 6 ), 1u );
+        uint32_t collapseCount = 0;
+        for( uint32_t v = 0; v < vertexCount; ++v )
+        {
+            collapseTo[v] = v;
+        }
+        std::fill( isTouched.begin(), isTouched.end(), static_cast<uint8_t>( 0 ) );
+        for( const auto& collapse : collapses )
+        {
+            if( collapseCount >= collapseLimit ) break;
+            if( isTouched[collapse.mFrom] || isTouched[collapse.mTo] ) continue;
+
+            // 三角形が裏返るなら縮約しない
+            auto target = GetPosition( vertices[collapse.mTo] );
+            auto isFlipped = false;
+            for( auto i = offsets[collapse.mFrom]; i < offsets[collapse.mFrom + 1] && !isFlipped; ++i )
+            {
+                auto t = adjacency[i];
+                const auto* tri = &indices[t * 3];
+                if( tri[0] == collapse.mTo || tri[1] == collapse.mTo || tri[2] == collapse.mTo ) continue;
+
+                Vector3 before[3] = {};
+                Vector3 after[3] = {};
+                for( uint32_t k = 0; k < 3; ++k )
+                {
+                    before[k] = GetPosition( vertices[tri[k]] );
+                    after[k] = tri[k] == collapse.mFrom ? target : before[k];
+                }
+                auto n0 = Cross( before[1] - before[0], before[2] - before[0] );
+                auto n1 = Cross( after[1] - after[0], after[2] - after[0] );
+                isFlipped = Dot( n0, n1 ) < kMaxNormalChange * Length( n0 ) * Length( n1 ) || LengthSq( n1 ) <= 0.0f;
+            }
+            if( isFlipped ) continue;
+
+            // 周りの三角形の頂点はこの回では動かさない
+            for( auto i = offsets[collapse.mFrom]; i < offsets[collapse.mFrom + 1]; ++i )
+            {
+                auto t = adjacency[i];
+                for( uint32_t k = 0; k < 3; ++k )
+                {
+                    isTouched[indices[t * 3 + k]] = 1;
+                }
+            }
+            isTouched[collapse.mTo] = 1;
+            collapseTo[collapse.mFrom] = collapse.mTo;
+            AddQuadric( quadrics[collapse.mTo], quadrics[collapse.mFrom] );
+            maxCost = ( std::max )( maxCost, collapse.mCost );
+            ++collapseCount;
+        }
+        if( collapseCount == 0 ) break;
+
+        // 縮約を反映して潰れた三角形を取り除く
+        size_t writeIdx = 0;
+        for( size_t i = 0; i < indices.size(); i += 3 )
+        {
+            auto v0 = collapseTo[indices[i + 0]];
+            auto v1 = collapseTo[indices[i + 1]];
+            auto v2 = collapseTo[indices[i + 2]];
+            if( v0 == v1 || v1 == v2 || v2 == v0 ) continue;
+
+            indices[writeIdx++] = v0;
+            indices[writeIdx++] = v1;
+            indices[writeIdx++] = v2;
+        }
+        indices.resize( writeIdx );
+    }
+
+    return std::sqrt( maxCost );
+}
+
+// LODを生成する
+void GenerateLods( const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices, std::vector<MeshLod>& lods, std::vector<uint32_t>& lodIndices )
+{
+    lods.clear();
+    lodIndices.clear();
+    auto triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+    if( triangleCount < kMinTriangleCount ) return;
+
+    // SelectLodと同じくAABBの対角線の半分を半径とする
+    Vector3 aabbMin( FLT_MAX, FLT_MAX, FLT_MAX );
+    Vector3 aabbMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+    for( auto idx : indices )
+    {
+        auto p = GetPosition( vertices[idx] );
+        aabbMin = Vector3( ( std::min )( aabbMin.x, p.x ), ( std::min )( aabbMin.y, p.y ), ( std::min )( aabbMin.z, p.z ) );
+        aabbMax = Vector3( ( std::max )( aabbMax.x, p.x ), ( std::max )( aabbMax.y, p.y ), ( std::max )( aabbMax.z, p.z ) );
+    }
+    auto radius = Length( aabbMax - aabbMin ) * 0.5f;
+
+    // 誤差が積み重ならないようにどのLODも元の形状から作る
+    auto prevCount = triangleCount;
+    auto prevScreenSize = FLT_MAX;
+    for( uint32_t i = 0; i < kMaxLodCount; ++i )
+    {
+        auto lod = indices;
+        auto targetCount = ( std::max )( static_cast<uint32_t>( triangleCount * kLodRatios[i] ), 1u );
+        auto error = Simplify( vertices, lod, targetCount * 3 );
+        auto lodCount = static_cast<uint32_t>( lod.size() / 3 );
+        if( lodCount == 0 || lodCount > prevCount * kMinReduction ) break;
+
+        std::vector<uint32_t> clusters;
+        MeshOptimizer::OptimizeVertexCache( lod, static_cast<uint32_t>( vertices.size() ), clusters );
+
+        MeshLod meshLod = {};
+        meshLod.mIndexOffset = static_cast<uint32_t>( lodIndices.size() );
+        meshLod.mIndexCount = static_cast<uint32_t>( lod.size() );
+        meshLod.mError = error;
+        // 誤差が前のLODより小さくても、切り替える大きさは詳細度の順に小さくする
+        meshLod.mScreenSize = ( std::min )( ComputeScreenSize( error, radius ), prevScreenSize );
+        lods.emplace_back( meshLod );
+        lodIndices.insert( lodIndices.end(), lod.begin(), lod.end() );
+        prevCount = lodCount;
+        prevScreenSize = meshLod.mScreenSize;
+    }
+}
+
+// LODの誤差から切り替える画面上の大きさを求める
+float ComputeScreenSize( float error, float radius )
+{
+    // 誤差のない簡略化はどの大きさでも使える
+    if( error <= 0.0f ) return FLT_MAX;
+
+    // 画面の高さhに対して 2r/h = s のとき e/h = s * e / 2r なので、これが許容誤差になるs
+    return 2.0f * radius * kLodScreenError / error;
+}
+
+}  // namespace MeshSimplifier
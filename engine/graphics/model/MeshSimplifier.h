@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "MeshLod.h"
+#include "MeshVertex.h"
+
+/// <summary>
+/// 二次誤差(QEM)によるメッシュの簡略化とLODの生成(CPUのみ)
+/// 頂点を隣の頂点へ寄せる辺の縮約だけを行うので、どのLODもLOD0の頂点をそのまま使える
+/// </summary>
+namespace MeshSimplifier
+{
+
+// 生成するLODの最大数(LOD0を除く)
+inline constexpr uint32_t kMaxLodCount = 3;
+// LODごとの三角形数の比(LOD0に対して)
+inline constexpr float kLodRatios[kMaxLodCount] = { 0.5f, 0.25f, 0.125f };
+// 画面上で許す誤差(画面の高さに対する比、1080pで約1ピクセル)
+// LODの誤差が画面上でこれに収まる大きさまで小さくなったら切り替える
+inline constexpr float kLodScreenError = 1.0f / 1080.0f;
+// 1つ前のLODからこの比までも減らせなければ打ち切る
+inline constexpr float kMinReduction = 0.8f;
+// これより少ない三角形のメッシュはLODを作らない
+inline constexpr uint32_t kMinTriangleCount = 64;
+
+/// <summary>
+/// 三角形が目標の数になるまで簡略化する
+/// 縫い目(同じ位置の頂点が複数ある)は動かさず、開いた境界は境界に沿ってのみ縮める
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="indices">三角形の頂点インデックス(入出力)</param>
+/// <param name="targetIndexCount">目標のインデックス数</param>
+/// <returns>元の形状からの誤差(モデル空間の距離)</returns>
+float Simplify( const std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, uint32_t targetIndexCount );
+
+/// <summary>
+/// LODを生成する(頂点キャッシュ順に並べ替え済み)
+/// 切り替える大きさは各LODの誤差とメッシュのバウンディングスフィアから求める
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="indices">LOD0の三角形の頂点インデックス</param>
+/// <param name="lods">LOD1以降(出力、範囲はlodIndices内)</param>
+/// <param name="lodIndices">LOD1以降のインデックスを連結したもの(出力)</param>
+void GenerateLods( const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices, std::vector<MeshLod>& lods, std::vector<uint32_t>& lodIndices );
+
+/// <summary>
+/// LODの誤差から切り替える画面上の大きさを求める
+/// 画面の高さに対する直径の比がこれを下回ると、誤差の比が kLodScreenError に収まる
+/// </summary>
+/// <param name="error">元の形状からの誤差(モデル空間の距離)</param>
+/// <param name="radius">バウンディングスフィアの半径(モデル空間)</param>
+/// <returns>画面に占める大きさ(画面の高さに対する比)</returns>
+float ComputeScreenSize( float error, float radius );
+
+}  // namespace MeshSimplifier
@@ -1,20 +1,56 @@
 #include "MeshSorter.h"
 
 #include <algorithm>
+#include <cfloat>
 
 #include "Material.h"
 #include "Mesh.h"
 #include "ModelBase.h"
 #include "PSOKey.h"
 #include "core/CommandList.h"
+#include "core/DirectXBase.h"
+#include "core/ParallelRecorder.h"
 #include "graphics/Camera.h"
 #include "math/Vector3.h"
 
+namespace
+{
+
+// 識別子のハッシュ
+uint64_t HashIdentity( D3D12_GPU_VIRTUAL_ADDRESS transMatAddress, uint32_t indexOffset )
+{
+    auto hash = ( transMatAddress ^ ( static_cast<uint64_t>( indexOffset ) << 40 ) ) * 0x9e3779b97f4a7c15ull;
+    return hash ^ ( hash >> 32 );
+}
+
+}  // namespace
+
 // コンストラクタ
 MeshSorter::MeshSorter()
     : mCamera( nullptr )
     , mCameraCB( nullptr )
     , mSortItems()
+    , mSortEntries()
+    , mSortTemp()
+    , mDistances()
+    , mDepthBucketing( DrawKey::DepthBucketing::Linear )
+    , mDepthBucketSize( DrawKey::kDepthUnit )
+    , mDepthBucketCount( 256 )
+    , mPSOIds()
+    , mUseCoherentSort( true )
+    , mPrevIdentities()
+    , mPrevRanks()
+    , mPrevTable()
+    , mPrevSlots()
+    , mNewItems()
+    , mUseInstancing( true )
+    , mDrawCalls()
+    , mGroupKeys()
+    , mRuns()
+    , mInstanceData()
+    , mInstanceBuffer( nullptr )
+    , mDrawPSOs()
+    , mStats()
 {
 }
 
@@ -34,52 +70,58 @@ bool MeshSorter::Init( Camera* camera )
 }
 
 // 描画アイテムの追加
-void MeshSorter::Add( uint64_t psoKey, float distance, ConstantBuffer* transMatCB, Mesh* mesh, Material* material, const AABB3D& aabb )
+void MeshSorter::Add( uint64_t psoKey, float distance, D3D12_GPU_VIRTUAL_ADDRESS transMatAddress, Mesh* mesh, Material* material, const AABB3D& aabb, VertexBuffer* vb, uint32_t lod, const TransformationMatrix* transMat )
 {
-    if( !transMatCB || !mesh || !material ) return;
+    if( transMatAddress == 0 || !mesh || !material ) return;
 
     SortItem item = {};
     item.mPSOKey = psoKey;
     item.mDistance = distance;
-    item.mQuantizedDist = QuantizeDist( distance );
-    item.mTransMatCB = transMatCB;
+    item.mTransMatAddress = transMatAddress;
     item.mMesh = mesh;
     item.mMaterial = material;
+    item.mVB = vb;
+    item.mLod = lod;
     item.mWorldAABB = aabb;
+    item.mTransMat = transMat;
+
+    // 並び順のキー(ソート時にマテリアルを参照しない)
+    auto key = DrawKey::Make( material->GetRenderQueue(), distance, GetPSOId( psoKey ), material, mesh );
+    mSortEntries.emplace_back( DrawKey::Entry{ key, static_cast<uint32_t>( mSortItems.size() ) } );
+    mDistances.emplace_back( distance );
     mSortItems.emplace_back( item );
 }
 
-// ソート
-void MeshSorter::Sort()
+// インデックスバッファの範囲を描画するアイテムの追加
+void MeshSorter::AddRange( uint64_t psoKey, float distance, D3D12_GPU_VIRTUAL_ADDRESS transMatAddress, Mesh* mesh, Material* material, const AABB3D& aabb, uint32_t indexOffset, uint32_t indexCount )
 {
-    std::sort(
-        mSortItems.begin(),
-        mSortItems.end(),
-        []( const SortItem& a, const SortItem& b )
-        {
-            auto rqA = a.mMaterial->GetRenderQueue();
-            auto rqB = b.mMaterial->GetRenderQueue();
-            if( rqA != rqB ) return rqA < rqB;
+    if( indexCount == 0 || transMatAddress == 0 || !mesh || !material ) return;
 
-            switch( rqA )
-            {
-                case RenderQueue::Opaque:
-                    // Front-to-Back
-                    // 量子化距離 → PSOキー → 距離
-                    if( a.mQuantizedDist != b.mQuantizedDist ) return a.mQuantizedDist < b.mQuantizedDist;
+    Add( psoKey, distance, transMatAddress, mesh, material, aabb );
+    auto& item = mSortItems.back();
+    item.mIndexOffset = indexOffset;
+    item.mIndexCount = indexCount;
+}
 
-                    if( a.mPSOKey != b.mPSOKey ) return a.mPSOKey < b.mPSOKey;
+// ソート
+void MeshSorter::Sort()
+{
+    mStats = {};
+    mStats.mItems = static_cast<uint32_t>( mSortItems.size() );
 
-                    return a.mDistance < b.mDistance;
+    ApplyDepthBuckets();
 
-                case RenderQueue::Transparent:
-                    // Back-to-Front
-                    return a.mDistance > b.mDistance;
+    // アイテムは動かさず、キーと番号の組だけ並べ替える
+    if( !mUseCoherentSort || !SortCoherent() )
+    {
+        DrawKey::RadixSort( mSortEntries, mSortTemp );
+    }
+    if( mUseCoherentSort )
+    {
+        SaveOrder();
+    }
 
-                default:
-                    return false;
-            }
-        } );
+    BuildDrawCalls();
 }
 
 // z-prepass描画
@@ -90,19 +132,30 @@ void MeshSorter::RenderZPrepass( CommandList* cmdList )
         return;
     }
 
-    for( auto& item : mSortItems )
+    // 位置の形式かインスタンシングの有無が変わったときだけパイプラインステートを切り替える
+    auto currPSOFlags = MeshFlags::None;
+    auto& modelBase = ModelBase::GetInstance();
+    for( const auto& draw : mDrawCalls )
     {
-        if( !item.mIsVisible ) continue;
+        auto& item = GetSortedItem( draw.mFirstItem );
+        if( !item.mMesh ) continue;
 
-        if( item.mTransMatCB )
+        auto psoFlags = GetMeshFlags( GetPSOKey( draw ) ) & ( MeshFlags::QuantizedPosition | MeshFlags::Instanced );
+        if( psoFlags != currPSOFlags )
         {
-            cmdList->SetGraphicsConstantBuffer( 0, item.mTransMatCB );
+            modelBase.SetZPrepassPSO( psoFlags );
+            currPSOFlags = psoFlags;
         }
 
-        if( item.mMesh )
+        if( draw.mFirstInstance != UINT32_MAX )
+        {
+            cmdList->SetGraphicsShaderResource( 1, mInstanceBuffer->GetGPUAddress() + draw.mFirstInstance * sizeof( TransformationMatrix ) );
+        }
+        else
         {
-            item.mMesh->Draw( cmdList );
+            cmdList->SetGraphicsConstantBuffer( 0, item.mTransMatAddress );
         }
+        DrawItem( cmdList, item, draw.mInstanceCount );
     }
 }
 
@@ -114,25 +167,97 @@ void MeshSorter::Render( CommandList* cmdList )
         return;
     }
 
+    PrepareRecording();
+    RecordDraws( cmdList, 0, GetDrawCallCount() );
+
+    Clear();
+}
+
+// 並列描画
+uint32_t MeshSorter::RenderParallel( CommandList* cmdList, ParallelRecorder& recorder, const SetupFunc& setup )
+{
+    if( !cmdList || mSortItems.empty() )
+    {
+        return 0;
+    }
+
+    PrepareRecording();
+
+    // チャンクが1つ以下なら、コマンドリストを閉じて提出し直すより、そのまま記録するほうが速い
+    auto& dxBase = DirectXBase::GetInstance();
+    if( recorder.GetChunkCount( GetDrawCallCount(), dxBase.GetWorkerCmdListCount() ) < 2 )
+    {
+        RecordDraws( cmdList, 0, GetDrawCallCount() );
+        Clear();
+        return 0;
+    }
+
+    // チャンクごとにワーカーのコマンドリストへ記録し、ここまでの描画に続けて元の順に実行する
+    auto chunkCount = recorder.Record(
+        GetDrawCallCount(),
+        dxBase.GetWorkerCmdListCount(),
+        [&]( uint32_t contextIdx, uint32_t first, uint32_t count )
+        {
+            auto workerCmdList = dxBase.BeginWorkerCmdList( contextIdx );
+            if( !workerCmdList ) return;
+
+            if( setup )
+            {
+                setup( workerCmdList );
+            }
+            RecordDraws( workerCmdList, first, count );
+            workerCmdList->Close();
+        },
+        [&]( std::span<const uint32_t> contextOrder )
+        {
+            dxBase.ExecuteWorkerCmdLists( contextOrder );
+        } );
+
+    Clear();
+    return chunkCount;
+}
+
+// 記録の準備
+void MeshSorter::PrepareRecording()
+{
     mCameraCB->Update( &mCamera->mPosition );
 
-    auto currPSOKey = UINT64_MAX;
+    // PSOの作成はワーカーではできないので、ここで全て引いておく
     auto& modelBase = ModelBase::GetInstance();
-    for( auto& item : mSortItems )
+    mDrawPSOs.resize( mDrawCalls.size() );
+    for( size_t i = 0; i < mDrawCalls.size(); ++i )
+    {
+        const auto& draw = mDrawCalls[i];
+        mDrawPSOs[i] = modelBase.GetGraphicsPSO( GetPSOKey( draw ) );
+    }
+}
+
+// ドローコールの範囲を記録
+void MeshSorter::RecordDraws( CommandList* cmdList, uint32_t firstDraw, uint32_t drawCount ) const
+{
+    if( !cmdList ) return;
+
+    auto endDraw = ( std::min )( firstDraw + drawCount, static_cast<uint32_t>( mDrawPSOs.size() ) );
+    for( auto i = firstDraw; i < endDraw; ++i )
     {
-        if( !item.mIsVisible ) continue;
+        // パイプラインステートを作れなかった
+        auto pso = mDrawPSOs[i];
+        if( !pso ) continue;
 
-        // パイプラインステート
-        if( currPSOKey != item.mPSOKey )
+        const auto& draw = mDrawCalls[i];
+        auto& item = GetSortedItem( draw.mFirstItem );
+
+        // パイプラインステート(同じならコマンドリストが捨てる)
+        cmdList->SetPipelineState( pso );
+
+        // 変換行列(インスタンシングなら構造化バッファ内のこの描画の先頭)
+        if( draw.mFirstInstance != UINT32_MAX )
         {
-            modelBase.SetGraphicsPSO( item.mPSOKey );
-            currPSOKey = item.mPSOKey;
+            cmdList->SetGraphicsShaderResource( 5, mInstanceBuffer->GetGPUAddress() + draw.mFirstInstance * sizeof( TransformationMatrix ) );
         }
-
-        // 変換行列
-        if( item.mTransMatCB )
+        else
         {
-            cmdList->SetGraphicsConstantBuffer( 0, item.mTransMatCB );
+            cmdList->SetGraphicsConstantBuffer( 0, item.mTransMatAddress );
         }
 
         // マテリアル
@@ -146,15 +271,281 @@ void MeshSorter::Render( CommandList* cmdList )
 
         if( item.mMesh )
         {
-            item.mMesh->Draw( cmdList );
+            DrawItem( cmdList, item, draw.mInstanceCount );
         }
     }
+}
 
+// アイテムを捨てる
+void MeshSorter::Clear()
+{
     mSortItems.clear();
+    mSortEntries.clear();
+    mDistances.clear();
+    mDrawCalls.clear();
+    mDrawPSOs.clear();
+}
+
+// 不透明の距離の段階の分け方を設定
+void MeshSorter::SetDepthBucketing( DrawKey::DepthBucketing bucketing, float bucketSize, uint32_t bucketCount )
+{
+    mDepthBucketing = bucketing;
+    mDepthBucketSize = ( std::max )( bucketSize, 0.001f );
+    mDepthBucketCount = std::clamp( bucketCount, 1u, DrawKey::kMaxQuantizedDepth + 1 );
+}
+
+// 不透明のキーに距離の段階を入れる
+void MeshSorter::ApplyDepthBuckets()
+{
+    if( mSortEntries.empty() ) return;
+
+    // 範囲は近平面から遠平面まで(Adaptiveはそのフレームの不透明なアイテムの範囲)
+    auto minDistance = mCamera ? mCamera->mNearZ : 0.0f;
+    auto maxDistance = mCamera ? mCamera->mFarZ : 0.0f;
+    if( mDepthBucketing == DrawKey::DepthBucketing::Adaptive )
+    {
+        minDistance = FLT_MAX;
+        maxDistance = -FLT_MAX;
+        for( const auto& entry : mSortEntries )
+        {
+            if( !DrawKey::IsOpaque( entry.mKey ) ) continue;
+
+            minDistance = ( std::min )( minDistance, mDistances[entry.mIndex] );
+            maxDistance = ( std::max )( maxDistance, mDistances[entry.mIndex] );
+        }
+        if( minDistance > maxDistance ) return;
+    }
+
+    auto buckets = DrawKey::MakeDepthBuckets( mDepthBucketing, mDepthBucketSize, mDepthBucketCount, minDistance, maxDistance );
+    for( auto& entry : mSortEntries )
+    {
+        entry.mKey = DrawKey::SetDepthBucket( entry.mKey, DrawKey::QuantizeDepth( buckets, mDistances[entry.mIndex] ) );
+    }
+}
+
+// 前フレームの並びから挿入ソートする
+bool MeshSorter::SortCoherent()
+{
+    auto count = static_cast<uint32_t>( mSortItems.size() );
+    auto prevCount = static_cast<uint32_t>( mPrevIdentities.size() );
+    if( count == 0 || prevCount == 0 ) return false;
+
+    // 前フレームの並びでの位置にアイテムを置く(追加順が同じなら表は引かない)
+    mPrevSlots.assign( prevCount, UINT32_MAX );
+    mNewItems.clear();
+    auto isTableBuilt = false;
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        const auto& item = mSortItems[i];
+        ItemIdentity identity = { item.mTransMatAddress, item.mIndexOffset };
+        auto prevIdx = i < prevCount && mPrevIdentities[i] == identity ? i : UINT32_MAX;
+        if( prevIdx == UINT32_MAX )
+        {
+            if( !isTableBuilt )
+            {
+                BuildPrevTable();
+                isTableBuilt = true;
+            }
+            prevIdx = FindPrevItem( identity );
+        }
+
+        // 前フレームに無かったか、同じ識別子が既に置かれていたら後ろに回す
+        if( prevIdx != UINT32_MAX && mPrevSlots[mPrevRanks[prevIdx]] == UINT32_MAX )
+        {
+            mPrevSlots[mPrevRanks[prevIdx]] = i;
+        }
+        else
+        {
+            mNewItems.emplace_back( i );
+        }
+    }
+    if( mNewItems.size() > count / kMaxDescentRatio ) return false;
+
+    // 前フレームの並びにする(追加時の組は追加順)
+    mSortTemp.clear();
+    for( auto itemIdx : mPrevSlots )
+    {
+        if( itemIdx == UINT32_MAX ) continue;
+
+        mSortTemp.emplace_back( mSortEntries[itemIdx] );
+    }
+    for( auto itemIdx : mNewItems )
+    {
+        mSortTemp.emplace_back( mSortEntries[itemIdx] );
+    }
+    mSortEntries.swap( mSortTemp );
+
+    // 乱れすぎていたら基数ソート
+    mStats.mSortDescents = DrawKey::CountDescents( mSortEntries );
+    if( mStats.mSortDescents > count / kMaxDescentRatio ) return false;
+
+    uint64_t moves = 0;
+    mStats.mCoherentSort = DrawKey::InsertionSort( mSortEntries, static_cast<uint64_t>( count ) * kMaxMovesPerItem, moves );
+    mStats.mSortMoves = static_cast<uint32_t>( moves );
+    return mStats.mCoherentSort;
+}
+
+// 次のフレームのために並びを覚える
+void MeshSorter::SaveOrder()
+{
+    auto count = mSortEntries.size();
+    mPrevIdentities.resize( count );
+    mPrevRanks.resize( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        mPrevIdentities[i] = ItemIdentity{ mSortItems[i].mTransMatAddress, mSortItems[i].mIndexOffset };
+        mPrevRanks[mSortEntries[i].mIndex] = static_cast<uint32_t>( i );
+    }
+}
+
+// 識別子から前フレームのアイテムの番号を引く表を作る
+void MeshSorter::BuildPrevTable()
+{
+    // 埋まるのが半分以下になる2のべき乗
+    size_t tableSize = 1;
+    while( tableSize < mPrevIdentities.size() * 2 )
+    {
+        tableSize <<= 1;
+    }
+    mPrevTable.assign( tableSize, UINT32_MAX );
+
+    auto mask = tableSize - 1;
+    for( uint32_t i = 0; i < static_cast<uint32_t>( mPrevIdentities.size() ); ++i )
+    {
+        const auto& identity = mPrevIdentities[i];
+        auto slot = HashIdentity( identity.mTransMatAddress, identity.mIndexOffset ) & mask;
+        while( mPrevTable[slot] != UINT32_MAX )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+        mPrevTable[slot] = i;
+    }
+}
+
+// 前フレームのアイテムの番号を探す
+uint32_t MeshSorter::FindPrevItem( const ItemIdentity& identity ) const
+{
+    if( mPrevTable.empty() ) return UINT32_MAX;
+
+    auto mask = mPrevTable.size() - 1;
+    auto slot = HashIdentity( identity.mTransMatAddress, identity.mIndexOffset ) & mask;
+    for( ; mPrevTable[slot] != UINT32_MAX; slot = ( slot + 1 ) & mask )
+    {
+        if( mPrevIdentities[mPrevTable[slot]] == identity ) return mPrevTable[slot];
+    }
+    return UINT32_MAX;
+}
+
+// ドローコールを作る
+void MeshSorter::BuildDrawCalls()
+{
+    mStats.mDraws = 0;
+    mStats.mInstancedDraws = 0;
+    mStats.mInstances = 0;
+    mStats.mPSOSwitches = 0;
+    mStats.mOpaqueItems = 0;
+    mStats.mDepthInversions = 0;
+
+    // 連続して同じものを描くアイテムをまとめる
+    mGroupKeys.resize( mSortEntries.size() );
+    for( uint32_t i = 0; i < static_cast<uint32_t>( mSortEntries.size() ); ++i )
+    {
+        const auto& item = GetSortedItem( i );
+        auto& key = mGroupKeys[i];
+        key.mMesh = item.mMesh;
+        key.mMaterial = item.mMaterial;
+        key.mVB = item.mVB;
+        key.mPSOKey = item.mPSOKey;
+        key.mLod = item.mLod;
+        key.mIndexOffset = item.mIndexOffset;
+        key.mIndexCount = item.mIndexCount;
+        key.mCanInstance = mUseInstancing && item.mTransMat != nullptr;
+    }
+
+    // Front-to-Backになっているか(不透明なアイテムだけ)
+    auto prevDistance = -FLT_MAX;
+    for( const auto& entry : mSortEntries )
+    {
+        if( !DrawKey::IsOpaque( entry.mKey ) ) continue;
+
+        auto distance = mDistances[entry.mIndex];
+        ++mStats.mOpaqueItems;
+        mStats.mDepthInversions += distance < prevDistance ? 1 : 0;
+        prevDistance = distance;
+    }
+    InstanceGrouping::Build( mGroupKeys, kMaxInstances, mRuns );
+
+    // 2つ以上まとめたものだけ変換行列を構造化バッファへ写す
+    mDrawCalls.clear();
+    mInstanceData.clear();
+    for( const auto& run : mRuns )
+    {
+        auto& draw = mDrawCalls.emplace_back( DrawCall{ run.mFirst, run.mCount, UINT32_MAX } );
+        if( run.mCount > 1 )
+        {
+            draw.mFirstInstance = static_cast<uint32_t>( mInstanceData.size() );
+            for( uint32_t i = run.mFirst; i < run.mFirst + run.mCount; ++i )
+            {
+                mInstanceData.emplace_back( *GetSortedItem( i ).mTransMat );
+            }
+            ++mStats.mInstancedDraws;
+            mStats.mInstances += run.mCount;
+        }
+        ++mStats.mDraws;
+    }
+
+    // 描画と同じようにPSOの切り替えを数える
+    auto currPSOKey = UINT64_MAX;
+    for( const auto& draw : mDrawCalls )
+    {
+        auto psoKey = GetPSOKey( draw );
+        mStats.mPSOSwitches += psoKey != currPSOKey ? 1 : 0;
+        currPSOKey = psoKey;
+    }
+    if( mInstanceData.empty() ) return;
+
+    // 足りなければ倍に広げて作り直す
+    auto count = static_cast<uint32_t>( mInstanceData.size() );
+    if( !mInstanceBuffer || mInstanceBuffer->GetCount() < count )
+    {
+        auto capacity = mInstanceBuffer ? mInstanceBuffer->GetCount() : 0;
+        mInstanceBuffer = std::make_unique<StructuredBuffer>();
+        if( !mInstanceBuffer->Create( ( std::max )( count, capacity * 2 ), sizeof( TransformationMatrix ) ) )
+        {
+            // 作れなければインスタンシングをやめる
+            mInstanceBuffer.reset();
+            mUseInstancing = false;
+            BuildDrawCalls();
+            return;
+        }
+    }
+    mInstanceBuffer->Update( mInstanceData.data(), count );
+}
+
+// ドローコールのパイプラインステートのキーを取得
+uint64_t MeshSorter::GetPSOKey( const DrawCall& draw ) const
+{
+    auto psoKey = GetSortedItem( draw.mFirstItem ).mPSOKey;
+    if( draw.mFirstInstance == UINT32_MAX ) return psoKey;
+
+    return MakePSOKey( GetMeshFlags( psoKey ) | MeshFlags::Instanced, GetMaterialFlags( psoKey ) );
+}
+
+// アイテムのメッシュを描画
+void MeshSorter::DrawItem( CommandList* cmdList, const SortItem& item, uint32_t instanceCount ) const
+{
+    if( item.mIndexCount > 0 )
+    {
+        item.mMesh->DrawRange( cmdList, item.mIndexOffset, item.mIndexCount, instanceCount );
+    }
+    else
+    {
+        item.mMesh->Draw( cmdList, item.mVB, item.mLod, instanceCount );
+    }
 }
 
-// 距離を量子化
-uint32_t MeshSorter::QuantizeDist( float distance )
+// PSOキーの番号を取得
+uint32_t MeshSorter::GetPSOId( uint64_t psoKey )
 {
-    return static_cast<uint32_t>( distance / 1.0f );  // 1m単位
+    return mPSOIds.try_emplace( psoKey, static_cast<uint32_t>( mPSOIds.size() ) ).first->second;
 }
@@ -1,14 +1,23 @@
 #pragma once
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "DrawKey.h"
+#include "InstanceGrouping.h"
+#include "TransformationMatrix.h"
 #include "core/ConstantBuffer.h"
+#include "core/StructuredBuffer.h"
 #include "math/Primitive.h"
 
 class Camera;
 class CommandList;
+class GraphicsPSO;
 class Material;
 class Mesh;
+class ParallelRecorder;
+class VertexBuffer;
 
 /// <summary>
 /// メッシュのソーター
@@ -17,18 +26,79 @@ class MeshSorter
 {
    public:
     /// <summary>
-    /// 描画アイテム
+    /// 描画アイテム(描画時にだけ読む部分、ソートでは動かさず番号で参照する)
     /// </summary>
     struct SortItem
     {
         uint64_t mPSOKey;
         float mDistance;
-        uint32_t mQuantizedDist;
-        ConstantBuffer* mTransMatCB;
+        // 変換行列の定数バッファのGPU仮想アドレス
+        D3D12_GPU_VIRTUAL_ADDRESS mTransMatAddress;
         Mesh* mMesh;
         Material* mMaterial;
+        // 差し替える頂点バッファ(nullptrならメッシュのもの)
+        VertexBuffer* mVB;
+        // 詳細度
+        uint32_t mLod;
+        // 描画するインデックスの範囲(数が0なら詳細度の範囲)
+        uint32_t mIndexOffset;
+        uint32_t mIndexCount;
         AABB3D mWorldAABB;
-        bool mIsVisible = true;
+        // 変換行列のCPU側の写し(nullptrならインスタンシングしない)
+        const TransformationMatrix* mTransMat;
+    };
+
+    /// <summary>
+    /// ドローコール(ソート済みのアイテムの範囲)
+    /// </summary>
+    struct DrawCall
+    {
+        // ソート済みの並びでの先頭
+        uint32_t mFirstItem;
+        uint32_t mInstanceCount;
+        // インスタンシングの構造化バッファ内の先頭(UINT32_MAXならアイテムの定数バッファで描く)
+        uint32_t mFirstInstance;
+    };
+
+    /// <summary>
+    /// 直前のソートの統計
+    /// </summary>
+    struct Stats
+    {
+        uint32_t mItems;
+        // 前フレームの並びから挿入ソートできたか(できなければ基数ソート)と、そのときの並びの乱れと動かした回数
+        bool mCoherentSort;
+        uint32_t mSortDescents;
+        uint32_t mSortMoves;
+        // ドローコールと、そのうちインスタンシングしたものとインスタンス数
+        uint32_t mDraws;
+        uint32_t mInstancedDraws;
+        uint32_t mInstances;
+        // ドローコールの間でPSOを切り替えた回数
+        uint32_t mPSOSwitches;
+        // 不透明なアイテムの数と、ソート済みの並びで直前より近いもの(Front-to-Backになっていない)の数
+        uint32_t mOpaqueItems;
+        uint32_t mDepthInversions;
+    };
+
+    // 並列記録でワーカーのコマンドリストを準備する関数(ビューポートやルートシグネチャなど、描画の前にセットするもの)
+    using SetupFunc = std::function<void( CommandList* cmdList )>;
+
+    // 1回の描画でまとめる最大のインスタンス数
+    static constexpr uint32_t kMaxInstances = 1024;
+    // 前フレームの並びから挿入ソートする上限(前フレームに無かったアイテムか乱れた位置がアイテム数のこの数分の1を超えるか、動かす回数がアイテムあたりこの数を超えたら基数ソート)
+    static constexpr uint32_t kMaxDescentRatio = 8;
+    static constexpr uint32_t kMaxMovesPerItem = 4;
+
+    /// <summary>
+    /// フレームをまたいで同じアイテムかを判定する識別子
+    /// </summary>
+    struct ItemIdentity
+    {
+        D3D12_GPU_VIRTUAL_ADDRESS mTransMatAddress;
+        uint32_t mIndexOffset;
+
+        bool operator==( const ItemIdentity& other ) const = default;
     };
 
     // カメラ
@@ -37,8 +107,48 @@ class MeshSorter
     // カメラ用定数バッファ
     std::unique_ptr<ConstantBuffer> mCameraCB;
 
-    // 描画アイテムリスト
+    // 描画アイテムリスト(追加順、容量はフレームをまたいで使い回す)
+    // ソートで読むのはキーの配列だけで、アイテムはソート済みの番号から引く
+    // 視錐台のカリングは登録する側で済ませ、可視なアイテムだけを追加する
     std::vector<SortItem> mSortItems;
+    // 並び順のキーとアイテムの番号(追加時に作り、ソートで並べ替える)と、ソート用の作業領域
+    std::vector<DrawKey::Entry> mSortEntries;
+    std::vector<DrawKey::Entry> mSortTemp;
+    // カメラからの距離(アイテムの番号順)
+    std::vector<float> mDistances;
+
+    // 不透明の距離の段階の分け方と、段階の幅(Linear)・数(Linear以外)
+    DrawKey::DepthBucketing mDepthBucketing;
+    float mDepthBucketSize;
+    uint32_t mDepthBucketCount;
+    // PSOキーごとの番号(最初に現れた順)
+    std::unordered_map<uint64_t, uint32_t> mPSOIds;
+
+    // 前フレームの並びを使うか
+    bool mUseCoherentSort;
+    // 前フレームの追加順のアイテムの識別子と、ソート済みの並びでの位置
+    std::vector<ItemIdentity> mPrevIdentities;
+    std::vector<uint32_t> mPrevRanks;
+    // 識別子から前フレームのアイテムの番号を引く表(オープンアドレス、追加順が変わったフレームだけ作る)
+    std::vector<uint32_t> mPrevTable;
+    // 前フレームの並びでの位置ごとの今フレームのアイテムの番号と、前フレームに無かったアイテムの番号(作業用)
+    std::vector<uint32_t> mPrevSlots;
+    std::vector<uint32_t> mNewItems;
+
+    // インスタンシングするか
+    bool mUseInstancing;
+    // ドローコール(ソート後にまとめる)
+    std::vector<DrawCall> mDrawCalls;
+    // まとめる判定のキーと範囲(作業用)
+    std::vector<InstanceGrouping::Key> mGroupKeys;
+    std::vector<InstanceGrouping::Run> mRuns;
+    // インスタンスごとの変換行列(作業用)とその構造化バッファ(足りなくなったら作り直す)
+    std::vector<TransformationMatrix> mInstanceData;
+    std::unique_ptr<StructuredBuffer> mInstanceBuffer;
+    // ドローコールごとのパイプラインステート(記録の準備で引いておき、並列記録中はPSOの表を触らない)
+    std::vector<GraphicsPSO*> mDrawPSOs;
+    // 直前のソートの統計
+    Stats mStats;
 
    public:
     /// <summary>
@@ -63,13 +173,33 @@ class MeshSorter
     /// </summary>
     /// <param name="psoKey">PSOキー</param>
     /// <param name="distance">カメラからの距離</param>
-    /// <param name="transMatCB">変換行列用定数バッファ</param>
+    /// <param name="transMatAddress">変換行列用定数バッファのGPU仮想アドレス</param>
     /// <param name="mesh">メッシュ</param>
     /// <param name="material">マテリアル</param>
-    void Add( uint64_t psoKey, float distance, ConstantBuffer* transMatCB, Mesh* mesh, Material* material, const AABB3D& aabb );
+    /// <param name="aabb">ワールド空間のAABB</param>
+    /// <param name="vb">差し替える頂点バッファ(スキニング済みの頂点など)</param>
+    /// <param name="lod">詳細度</param>
+    /// <param name="transMat">変換行列のCPU側の写し(インスタンシングで構造化バッファへ写す、nullptrならまとめない)</param>
+    void Add( uint64_t psoKey, float distance, D3D12_GPU_VIRTUAL_ADDRESS transMatAddress, Mesh* mesh, Material* material, const AABB3D& aabb, VertexBuffer* vb = nullptr, uint32_t lod = 0, const TransformationMatrix* transMat = nullptr );
+
+    /// <summary>
+    /// インデックスバッファの範囲を描画するアイテムの追加(静的バッチのセルなど)
+    /// </summary>
+    /// <param name="psoKey">PSOキー</param>
+    /// <param name="distance">カメラからの距離</param>
+    /// <param name="transMatAddress">変換行列用定数バッファのGPU仮想アドレス</param>
+    /// <param name="mesh">メッシュ</param>
+    /// <param name="material">マテリアル</param>
+    /// <param name="aabb">ワールド空間のAABB</param>
+    /// <param name="indexOffset">先頭のインデックス</param>
+    /// <param name="indexCount">インデックス数</param>
+    void AddRange( uint64_t psoKey, float distance, D3D12_GPU_VIRTUAL_ADDRESS transMatAddress, Mesh* mesh, Material* material, const AABB3D& aabb, uint32_t indexOffset, uint32_t indexCount );
 
     /// <summary>
     /// ソート
+    /// 追加時に作った64bitのキーとアイテムの番号の組を基数ソートする(アイテム自体は動かさない)
+    /// 前フレームにもあったアイテムは前フレームの並びに、無かったアイテムは後ろに置いて挿入ソートする
+    /// 続けて、連続して同じメッシュ・マテリアル・PSOを描くアイテムを1回のインスタンシング描画にまとめる
     /// </summary>
     void Sort();
 
@@ -85,6 +215,36 @@ class MeshSorter
     /// <param name="cmdList">コマンドリスト</param>
     void Render( CommandList* cmdList );
 
+    /// <summary>
+    /// 並列描画
+    /// ドローコールを連続したチャンクに分けてワーカーのコマンドリストへ並列に記録し、元の順に実行する
+    /// チャンクが1つ以下ならコマンドリストへそのまま記録する
+    /// </summary>
+    /// <param name="cmdList">コマンドリスト(描画開始済み)</param>
+    /// <param name="recorder">分け方</param>
+    /// <param name="setup">ワーカーのコマンドリストの準備</param>
+    /// <returns>記録したワーカーのコマンドリストの数</returns>
+    uint32_t RenderParallel( CommandList* cmdList, ParallelRecorder& recorder, const SetupFunc& setup );
+
+    /// <summary>
+    /// 記録の準備(カメラの定数バッファの更新と、ドローコールのパイプラインステートの取得)
+    /// 記録の前に描画スレッドで1回呼ぶ
+    /// </summary>
+    void PrepareRecording();
+
+    /// <summary>
+    /// ドローコールの範囲を記録(準備のあとなら、範囲が重ならない限り別々のスレッドから呼べる)
+    /// </summary>
+    /// <param name="cmdList">コマンドリスト</param>
+    /// <param name="firstDraw">先頭のドローコール</param>
+    /// <param name="drawCount">ドローコールの数</param>
+    void RecordDraws( CommandList* cmdList, uint32_t firstDraw, uint32_t drawCount ) const;
+
+    /// <summary>
+    /// 描画せずにアイテムを捨てる(描画すると自動で捨てる)
+    /// </summary>
+    void Clear();
+
     /// <summary>カメラを取得</summary>
     Camera* GetCamera() const { return mCamera; }
 
@@ -92,6 +252,39 @@ class MeshSorter
 
     uint32_t GetItemCount() const { return static_cast<uint32_t>( mSortItems.size() ); }
 
+    /// <summary>ドローコールの数を取得</summary>
+    uint32_t GetDrawCallCount() const { return static_cast<uint32_t>( mDrawCalls.size() ); }
+
+    /// <summary>直前のソートの統計を取得</summary>
+    const Stats& GetStats() const { return mStats; }
+
+    /// <summary>インスタンシングするかを設定(次のソートから)</summary>
+    void SetUseInstancing( bool useInstancing ) { mUseInstancing = useInstancing; }
+
+    /// <summary>インスタンシングするか</summary>
+    bool IsUsingInstancing() const { return mUseInstancing; }
+
+    /// <summary>
+    /// 不透明の距離の段階の分け方を設定(次のソートから)
+    /// </summary>
+    /// <param name="bucketing">分け方</param>
+    /// <param name="bucketSize">段階の幅(Linear)</param>
+    /// <param name="bucketCount">段階の数(Linear以外)</param>
+    void SetDepthBucketing( DrawKey::DepthBucketing bucketing, float bucketSize, uint32_t bucketCount );
+
+    /// <summary>不透明の距離の段階の分け方を取得</summary>
+    DrawKey::DepthBucketing GetDepthBucketing() const { return mDepthBucketing; }
+
+    float GetDepthBucketSize() const { return mDepthBucketSize; }
+
+    uint32_t GetDepthBucketCount() const { return mDepthBucketCount; }
+
+    /// <summary>前フレームの並びを使ってソートするかを設定</summary>
+    void SetUseCoherentSort( bool useCoherentSort ) { mUseCoherentSort = useCoherentSort; }
+
+    /// <summary>前フレームの並びを使ってソートするか</summary>
+    bool IsUsingCoherentSort() const { return mUseCoherentSort; }
+
     /// <summary>カメラを設定</summary>
     void SetCamera( Camera* camera ) { mCamera = camera; }
 
@@ -99,9 +292,64 @@ class MeshSorter
 
    private:
     /// <summary>
-    /// 距離を量子化
+    /// ソート済みの並びでのアイテムを取得
+    /// </summary>
+    /// <param name="sortedIdx">ソート済みの並びでの位置</param>
+    /// <returns>描画アイテム</returns>
+    const SortItem& GetSortedItem( uint32_t sortedIdx ) const { return mSortItems[mSortEntries[sortedIdx].mIndex]; }
+
+    /// <summary>
+    /// 不透明のキーに距離の段階を入れる(追加順の組に対して)
+    /// </summary>
+    void ApplyDepthBuckets();
+
+    /// <summary>
+    /// 前フレームの並びから挿入ソートする
+    /// </summary>
+    /// <returns>ソートし終えたか(falseなら組は並び替え途中で、基数ソートが要る)</returns>
+    bool SortCoherent();
+
+    /// <summary>
+    /// 次のフレームのために並びとアイテムの識別子を覚える
     /// </summary>
-    /// <param name="distance">距離</param>
-    /// <returns>量子化された距離</returns>
-    uint32_t QuantizeDist( float distance );
+    void SaveOrder();
+
+    /// <summary>
+    /// 識別子から前フレームのアイテムの番号を引く表を作る
+    /// </summary>
+    void BuildPrevTable();
+
+    /// <summary>
+    /// 前フレームのアイテムの番号を探す
+    /// </summary>
+    /// <param name="identity">識別子</param>
+    /// <returns>番号(無ければUINT32_MAX)</returns>
+    uint32_t FindPrevItem( const ItemIdentity& identity ) const;
+
+    /// <summary>
+    /// ソート済みのアイテムからドローコールを作り、インスタンスの変換行列を構造化バッファへ書き込む
+    /// </summary>
+    void BuildDrawCalls();
+
+    /// <summary>
+    /// ドローコールのパイプラインステートのキーを取得(インスタンシングならメッシュフラグを足す)
+    /// </summary>
+    /// <param name="draw">ドローコール</param>
+    /// <returns>PSOキー</returns>
+    uint64_t GetPSOKey( const DrawCall& draw ) const;
+
+    /// <summary>
+    /// アイテムのメッシュを描画(範囲があれば範囲だけ)
+    /// </summary>
+    /// <param name="cmdList">コマンドリスト</param>
+    /// <param name="item">描画アイテム</param>
+    /// <param name="instanceCount">インスタンス数</param>
+    void DrawItem( CommandList* cmdList, const SortItem& item, uint32_t instanceCount ) const;
+
+    /// <summary>
+    /// PSOキーの番号を取得(初めてのキーなら番号を振る)
+    /// </summary>
+    /// <param name="psoKey">PSOキー</param>
+    /// <returns>番号</returns>
+    uint32_t GetPSOId( uint64_t psoKey );
 };
@@ -0,0 +1,14 @@
+#pragma once
+#include "math/Vector2.h"
+#include "math/Vector3.h"
+#include "math/Vector4.h"
+
+/// <summary>
+/// メッシュの頂点データ(グラフィックスAPIに依存しない)
+/// </summary>
+struct MeshVertex
+{
+    Vector4 mPosition;
+    Vector3 mNormal;
+    Vector2 mUV;
+};
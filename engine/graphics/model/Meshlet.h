@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+#include "math/Primitive.h"
+#include "math/Vector3.h"
+
+/// <summary>
+/// メッシュを細かく分けたクラスタ(グラフィックスAPIに依存しない)
+/// 三角形はインデックスバッファ内に連続して並ぶので、範囲だけで描画できる
+/// </summary>
+struct Meshlet
+{
+    // インデックスバッファ内の範囲
+    uint32_t mIndexOffset;
+    uint32_t mIndexCount;
+    // 使う頂点の数
+    uint32_t mVertexCount;
+    // バウンディングスフィア(モデル空間)
+    Sphere mBounds;
+    // 法線の円錐(カメラが頂点から軸の逆方向に開いた円錐の内側にあれば全ての三角形が裏向き)
+    Vector3 mConeApex;
+    Vector3 mConeAxis;
+    // 円錐の半頂角のcos(1なら裏向きの判定をしない)
+    float mConeCutoff;
+};
@@ -0,0 +1,290 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "MeshOptimizer.h"
+
+namespace
+{
+
+// 法線がこれ(cos)より軸から開いていたら裏向きの判定をしない
+const float kMinConeSpread = 0.1f;
+
+// 頂点の位置
+Vector3 GetPosition( const MeshVertex& vertex )
+{
+    return Vector3( vertex.mPosition.x, vertex.mPosition.y, vertex.mPosition.z );
+}
+
+// 三角形の重心
+Vector3 GetCentroid( const std::vector<MeshVertex>& vertices, const uint32_t* tri )
+{
+    return ( GetPosition( vertices[tri[0]] ) + GetPosition( vertices[tri[1]] ) + GetPosition( vertices[tri[2]] ) ) / 3.0f;
+}
+
+}  // namespace
+
+namespace MeshletBuilder
+{
+
+// メッシュレットを構築する
+void Build( const std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<Meshlet>& meshlets )
+{
+    meshlets.clear();
+    auto vertexCount = static_cast<uint32_t>( vertices.size() );
+    auto triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+    if( triangleCount == 0 ) return;
+
+    // 頂点から三角形への隣接(CSR)
+    std::vector<uint32_t> offsets( vertexCount + 1, 0 );
+    for( uint32_t i = 0; i < triangleCount * 3; ++i )
+    {
+        ++offsets[indices[i] + 1];
+    }
+    for( uint32_t v = 0; v < vertexCount; ++v )
+    {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint32_t> adjacency( triangleCount * 3 );
+    {
+        std::vector<uint32_t> cursor( offsets.begin(), offsets.end() - 1 );
+        for( uint32_t i = 0; i < triangleCount * 3; ++i )
+        {
+            adjacency[cursor[indices[i]]++] = i / 3;
+        }
+    }
+
+    // 頂点・候補の三角形が今のメッシュレットに入っているか(メッシュレットの番号で判定)
+    std::vector<uint32_t> vertexOwners( vertexCount, UINT32_MAX );
+    std::vector<uint32_t> candidateOwners( triangleCount, UINT32_MAX );
+    std::vector<bool> isEmitted( triangleCount, false );
+    // 頂点ごとの残っている三角形の数
+    std::vector<uint32_t> liveCounts( vertexCount );
+    for( uint32_t v = 0; v < vertexCount; ++v )
+    {
+        liveCounts[v] = offsets[v + 1] - offsets[v];
+    }
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve( triangleCount * 3 );
+    uint32_t scanIdx = 0;
+    while( true )
+    {
+        // 直前のメッシュレットの周りで最も取り残されそうな三角形から始める(無ければ元の順で最初に残っているもの)
+        auto seed = UINT32_MAX;
+        auto seedLiveCount = UINT32_MAX;
+        for( auto t : candidates )
+        {
+            if( isEmitted[t] ) continue;
+
+            auto liveCount = liveCounts[indices[t * 3 + 0]] + liveCounts[indices[t * 3 + 1]] + liveCounts[indices[t * 3 + 2]];
+            if( liveCount < seedLiveCount )
+            {
+                seed = t;
+                seedLiveCount = liveCount;
+            }
+        }
+        if( seed == UINT32_MAX )
+        {
+            while( scanIdx < triangleCount && isEmitted[scanIdx] )
+            {
+                ++scanIdx;
+            }
+            if( scanIdx == triangleCount ) break;
+
+            seed = scanIdx;
+        }
+
+        auto meshletIdx = static_cast<uint32_t>( meshlets.size() );
+        Meshlet meshlet = {};
+        meshlet.mIndexOffset = static_cast<uint32_t>( output.size() );
+        candidates.clear();
+        candidates.emplace_back( seed );
+        candidateOwners[seed] = meshletIdx;
+        Vector3 centroidSum = Vector3::kZero;
+        uint32_t meshletTriangles = 0;
+        while( meshletTriangles < kMaxTriangles )
+        {
+            // 新しい頂点が少なく、中心に近い三角形を選ぶ
+            auto center = meshletTriangles > 0 ? centroidSum / static_cast<float>( meshletTriangles ) : GetCentroid( vertices, &indices[seed * 3] );
+            uint32_t best = UINT32_MAX;
+            uint32_t bestNewVertices = 4;
+            uint32_t bestLastVertices = 0;
+            auto bestDistance = FLT_MAX;
+            for( size_t c = 0; c < candidates.size(); )
+            {
+                auto t = candidates[c];
+                if( isEmitted[t] )
+                {
+                    candidates[c] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                ++c;
+
+                uint32_t newVertices = 0;
+                uint32_t lastVertices = 0;
+                for( uint32_t k = 0; k < 3; ++k )
+                {
+                    auto v = indices[t * 3 + k];
+                    newVertices += vertexOwners[v] != meshletIdx ? 1 : 0;
+                    lastVertices += liveCounts[v] == 1 ? 1 : 0;
+                }
+                if( meshlet.mVertexCount + newVertices > kMaxVertices ) continue;
+
+                // 最後の三角形になる頂点が多いものを優先して穴を残さない
+                auto distance = LengthSq( GetCentroid( vertices, &indices[t * 3] ) - center );
+                if( newVertices < bestNewVertices ||
+                    ( newVertices == bestNewVertices && lastVertices > bestLastVertices ) ||
+                    ( newVertices == bestNewVertices && lastVertices == bestLastVertices && distance < bestDistance ) )
+                {
+                    best = t;
+                    bestNewVertices = newVertices;
+                    bestLastVertices = lastVertices;
+                    bestDistance = distance;
+                }
+            }
+            if( best == UINT32_MAX ) break;
+
+            // 追加して、隣の三角形を候補にする
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                auto v = indices[best * 3 + k];
+                output.emplace_back( v );
+                --liveCounts[v];
+                if( vertexOwners[v] != meshletIdx )
+                {
+                    vertexOwners[v] = meshletIdx;
+                    ++meshlet.mVertexCount;
+                }
+                for( auto i = offsets[v]; i < offsets[v + 1]; ++i )
+                {
+                    auto t = adjacency[i];
+                    if( isEmitted[t] || candidateOwners[t] == meshletIdx ) continue;
+
+                    candidateOwners[t] = meshletIdx;
+                    candidates.emplace_back( t );
+                }
+            }
+            isEmitted[best] = true;
+            centroidSum += GetCentroid( vertices, &indices[best * 3] );
+            ++meshletTriangles;
+        }
+
+        meshlet.mIndexCount = meshletTriangles * 3;
+        meshlets.emplace_back( meshlet );
+    }
+
+    indices = std::move( output );
+
+    // メッシュレット内は頂点キャッシュ順に並べ直す(メッシュレット内の頂点番号で並べ替えて戻す)
+    std::vector<uint32_t> localToGlobal;
+    std::vector<uint32_t> localIndices;
+    std::vector<uint32_t> clusters;
+    std::vector<uint32_t> globalToLocal( vertexCount, UINT32_MAX );
+    for( auto& meshlet : meshlets )
+    {
+        localToGlobal.clear();
+        localIndices.resize( meshlet.mIndexCount );
+        for( uint32_t i = 0; i < meshlet.mIndexCount; ++i )
+        {
+            auto v = indices[meshlet.mIndexOffset + i];
+            if( globalToLocal[v] == UINT32_MAX )
+            {
+                globalToLocal[v] = static_cast<uint32_t>( localToGlobal.size() );
+                localToGlobal.emplace_back( v );
+            }
+            localIndices[i] = globalToLocal[v];
+        }
+        MeshOptimizer::OptimizeVertexCache( localIndices, meshlet.mVertexCount, clusters );
+        for( uint32_t i = 0; i < meshlet.mIndexCount; ++i )
+        {
+            indices[meshlet.mIndexOffset + i] = localToGlobal[localIndices[i]];
+        }
+        for( auto v : localToGlobal )
+        {
+            globalToLocal[v] = UINT32_MAX;
+        }
+
+        ComputeBounds( vertices, indices, meshlet );
+    }
+}
+
+// メッシュレットのバウンディングスフィアと法線の円錐を計算する
+void ComputeBounds( const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices, Meshlet& meshlet )
+{
+    auto begin = meshlet.mIndexOffset;
+    auto end = meshlet.mIndexOffset + meshlet.mIndexCount;
+
+    // AABBの中心から最も遠い頂点までの球
+    AABB3D aabb;
+    aabb.Reset();
+    for( auto i = begin; i < end; ++i )
+    {
+        aabb.Update( GetPosition( vertices[indices[i]] ) );
+    }
+    auto center = ( aabb.mMin + aabb.mMax ) * 0.5f;
+    auto radiusSq = 0.0f;
+    for( auto i = begin; i < end; ++i )
+    {
+        radiusSq = ( std::max )( radiusSq, LengthSq( GetPosition( vertices[indices[i]] ) - center ) );
+    }
+    meshlet.mBounds.mCenter = center;
+    meshlet.mBounds.mRadius = std::sqrt( radiusSq );
+
+    // 面の法線(巻き順ではなく頂点の法線と同じ側を表とする)
+    std::vector<Vector3> normals;
+    normals.reserve( meshlet.mIndexCount / 3 );
+    Vector3 axis = Vector3::kZero;
+    for( auto i = begin; i + 2 < end; i += 3 )
+    {
+        const auto& v0 = vertices[indices[i + 0]];
+        const auto& v1 = vertices[indices[i + 1]];
+        const auto& v2 = vertices[indices[i + 2]];
+        auto p0 = GetPosition( v0 );
+        auto normal = Cross( GetPosition( v1 ) - p0, GetPosition( v2 ) - p0 );
+        if( LengthSq( normal ) <= 0.0f ) continue;
+
+        normal = Normalize( normal );
+        if( Dot( normal, v0.mNormal + v1.mNormal + v2.mNormal ) < 0.0f )
+        {
+            normal = -normal;
+        }
+        normals.emplace_back( normal );
+        axis += normal;
+    }
+
+    meshlet.mConeApex = center;
+    meshlet.mConeAxis = Vector3::kUnitY;
+    meshlet.mConeCutoff = 1.0f;
+    if( normals.empty() || LengthSq( axis ) <= 0.0f ) return;
+
+    axis = Normalize( axis );
+    auto minDot = 1.0f;
+    for( const auto& normal : normals )
+    {
+        minDot = ( std::min )( minDot, Dot( normal, axis ) );
+    }
+    meshlet.mConeAxis = axis;
+    if( minDot <= kMinConeSpread ) return;
+
+    // 頂点は全ての三角形の裏側に置く(軸に沿って中心から下げる)
+    auto maxT = 0.0f;
+    size_t n = 0;
+    for( auto i = begin; i + 2 < end; i += 3 )
+    {
+        auto p0 = GetPosition( vertices[indices[i + 0]] );
+        auto p1 = GetPosition( vertices[indices[i + 1]] );
+        auto p2 = GetPosition( vertices[indices[i + 2]] );
+        if( LengthSq( Cross( p1 - p0, p2 - p0 ) ) <= 0.0f ) continue;
+
+        const auto& normal = normals[n++];
+        maxT = ( std::max )( maxT, Dot( normal, center - p0 ) / Dot( normal, axis ) );
+    }
+    meshlet.mConeApex = center - axis * maxT;
+    meshlet.mConeCutoff = std::sqrt( 1.0f - minDot * minDot );
+}
+
+}  // namespace MeshletBuilder
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "MeshVertex.h"
+#include "Meshlet.h"
+
+/// <summary>
+/// メッシュレットの構築(CPUのみ)
+/// 隣接する三角形を貪欲に集め、メッシュレットごとに三角形が連続するようにインデックスを並べ替える
+/// </summary>
+namespace MeshletBuilder
+{
+
+// メッシュレットの最大の頂点数
+inline constexpr uint32_t kMaxVertices = 64;
+// メッシュレットの最大の三角形数
+inline constexpr uint32_t kMaxTriangles = 124;
+
+/// <summary>
+/// メッシュレットを構築する
+/// 新しいメッシュレットは直前のメッシュレットの周りから広げるので、取り残された小さな穴ができにくい
+/// メッシュレット内の三角形は頂点キャッシュ順に並べ直す
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="indices">三角形の頂点インデックス(入出力、メッシュレット順に並べ替える)</param>
+/// <param name="meshlets">メッシュレット(出力)</param>
+void Build( const std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices, std::vector<Meshlet>& meshlets );
+
+/// <summary>
+/// メッシュレットのバウンディングスフィアと法線の円錐を計算する
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="indices">三角形の頂点インデックス</param>
+/// <param name="meshlet">メッシュレット(入出力、範囲と頂点数は設定済み)</param>
+void ComputeBounds( const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices, Meshlet& meshlet );
+
+}  // namespace MeshletBuilder
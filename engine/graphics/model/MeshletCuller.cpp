@@ -0,0 +1,67 @@
+#include "MeshletCuller.h"
+
+#include "collision/Collision.h"
+
+// ワールド行列とカメラから設定
+void MeshletCuller::Params::Build( const Matrix4& worldMat, const Matrix4& viewMat, const Matrix4& projMat )
+{
+    // モデル空間で判定すればメッシュレットの境界を変換しなくてよい
+    auto worldView = worldMat * viewMat;
+    mFrustum.Build( worldView * projMat );
+    mCameraPosition = GetTranslate( InverseAffine( worldView ) );
+}
+
+// コンストラクタ
+MeshletCuller::MeshletCuller()
+    : mStats()
+{
+}
+
+// カリング
+void MeshletCuller::Cull( std::span<const Meshlet> meshlets, const Params& params, std::vector<IndexRange>& ranges )
+{
+    mStats = {};
+    ranges.clear();
+    for( const auto& meshlet : meshlets )
+    {
+        auto triangles = meshlet.mIndexCount / 3;
+
+        // 視錐台
+        if( !Intersect( meshlet.mBounds, params.mFrustum ) )
+        {
+            ++mStats.mFrustumCulledMeshlets;
+            mStats.mCulledTriangles += triangles;
+            continue;
+        }
+
+        // 全ての三角形が裏向き
+        if( params.mUseCone && meshlet.mConeCutoff < 1.0f &&
+            Dot( Normalize( meshlet.mConeApex - params.mCameraPosition ), meshlet.mConeAxis ) >= meshlet.mConeCutoff )
+        {
+            ++mStats.mConeCulledMeshlets;
+            mStats.mCulledTriangles += triangles;
+            continue;
+        }
+
+        // 遮蔽
+        if( params.mIsOccluded && params.mIsOccluded( meshlet.mBounds ) )
+        {
+            ++mStats.mOcclusionCulledMeshlets;
+            mStats.mCulledTriangles += triangles;
+            continue;
+        }
+
+        ++mStats.mVisibleMeshlets;
+        mStats.mVisibleTriangles += triangles;
+
+        // 直前の範囲に続いていればまとめる
+        if( !ranges.empty() && ranges.back().mIndexOffset + ranges.back().mIndexCount == meshlet.mIndexOffset )
+        {
+            ranges.back().mIndexCount += meshlet.mIndexCount;
+        }
+        else
+        {
+            ranges.emplace_back( IndexRange{ meshlet.mIndexOffset, meshlet.mIndexCount } );
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "Meshlet.h"
+#include "math/Matrix4.h"
+#include "math/Primitive.h"
+
+/// <summary>
+/// メッシュレットのカリング(CPUのみ)
+/// 視錐台・法線の円錐・遮蔽(任意)で判定し、描画するインデックスの範囲を出力する
+/// </summary>
+class MeshletCuller
+{
+   public:
+    /// <summary>
+    /// インデックスバッファ内の範囲
+    /// </summary>
+    struct IndexRange
+    {
+        uint32_t mIndexOffset;
+        uint32_t mIndexCount;
+    };
+
+    /// <summary>
+    /// カリングの設定
+    /// </summary>
+    struct Params
+    {
+        // 視錐台(モデル空間)
+        Frustum mFrustum;
+        // カメラの位置(モデル空間)
+        Vector3 mCameraPosition;
+        // 法線の円錐で裏向きを判定するか(両面描画なら無効にする)
+        bool mUseCone;
+        // 遮蔽されているか(モデル空間の球、空なら判定しない)
+        std::function<bool( const Sphere& )> mIsOccluded;
+
+        /// <summary>
+        /// ワールド行列とカメラから設定
+        /// </summary>
+        /// <param name="worldMat">ワールド行列</param>
+        /// <param name="viewMat">ビュー行列</param>
+        /// <param name="projMat">プロジェクション行列</param>
+        void Build( const Matrix4& worldMat, const Matrix4& viewMat, const Matrix4& projMat );
+    };
+
+    /// <summary>
+    /// 統計
+    /// </summary>
+    struct Stats
+    {
+        uint32_t mVisibleMeshlets;
+        uint32_t mFrustumCulledMeshlets;
+        uint32_t mConeCulledMeshlets;
+        uint32_t mOcclusionCulledMeshlets;
+        uint32_t mVisibleTriangles;
+        uint32_t mCulledTriangles;
+    };
+
+   private:
+    // 直前のカリングの統計
+    Stats mStats;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    MeshletCuller();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~MeshletCuller() = default;
+
+    /// <summary>
+    /// カリング
+    /// インデックスが連続する可視なメッシュレットは1つの範囲にまとめる
+    /// </summary>
+    /// <param name="meshlets">メッシュレット</param>
+    /// <param name="params">設定</param>
+    /// <param name="ranges">描画するインデックスの範囲(出力)</param>
+    void Cull( std::span<const Meshlet> meshlets, const Params& params, std::vector<IndexRange>& ranges );
+
+    /// <summary>
+    /// 直前のカリングの統計を取得
+    /// </summary>
+    const Stats& GetStats() const { return mStats; }
+};
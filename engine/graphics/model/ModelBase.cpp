@@ -8,10 +8,27 @@
 #include "core/ResourceManager.h"
 #include "utils/Logger.h"
 
+namespace
+{
+
+// 位置の形式(SNORMはシェーダーで[-1,1]のfloatになる)
+DXGI_FORMAT GetPositionFormat( MeshFlags meshFlags )
+{
+    if( ( meshFlags & MeshFlags::QuantizedPosition ) == MeshFlags::QuantizedPosition )
+    {
+        return DXGI_FORMAT_R16G16B16A16_SNORM;
+    }
+    return DXGI_FORMAT_R32G32B32A32_FLOAT;
+}
+
+}  // namespace
+
 // コンストラクタ
 ModelBase::ModelBase()
     : mRS( nullptr )
     , mPSO()
+    , mLastPSOKey( 0 )
+    , mLastPSO( nullptr )
     , mCmdList( nullptr )
 {
 }
@@ -20,13 +37,14 @@ ModelBase::ModelBase()
 bool ModelBase::Init()
 {
     mRS = std::make_unique<RootSignature>();
-    mRS->Init( 5, 1 );
+    mRS->Init( 6, 1 );
     mRS->GetParameter( 0 ).InitAsCBV( 0, D3D12_SHADER_VISIBILITY_VERTEX );
     mRS->GetParameter( 1 ).InitAsCBV( 0, D3D12_SHADER_VISIBILITY_PIXEL );
     mRS->GetParameter( 2 ).InitAsCBV( 1, D3D12_SHADER_VISIBILITY_PIXEL );
     mRS->GetParameter( 3 ).InitAsDescriptorTable( 1 );
     mRS->GetParameter( 3 ).SetDescriptorRange( 0, D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0 );
     mRS->GetParameter( 4 ).InitAsCBV( 2, D3D12_SHADER_VISIBILITY_PIXEL );
+    mRS->GetParameter( 5 ).InitAsSRV( 1, D3D12_SHADER_VISIBILITY_VERTEX );  // インスタンシングの変換行列
     mRS->GetSampler( 0 ) = DirectXCommonSettings::gSamplerLinearWrap;
     // ルートシグネチャの作成
     if( !mRS->Create() )
@@ -60,8 +78,7 @@ void ModelBase::Begin( CommandList* cmdList )
     if( !cmdList ) return;
 
     mCmdList = cmdList;
-    mCmdList->SetGraphicsRootSignature( mRS.get() );
-    mCmdList->SetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    Bind( mCmdList );
 }
 
 // 描画終了
@@ -70,18 +87,41 @@ void ModelBase::End()
     mCmdList = nullptr;
 }
 
+// ルートシグネチャとプリミティブ型をセット
+void ModelBase::Bind( CommandList* cmdList ) const
+{
+    if( !cmdList ) return;
+
+    cmdList->SetGraphicsRootSignature( mRS.get() );
+    cmdList->SetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+}
+
 // パイプラインステートの設定
 void ModelBase::SetGraphicsPSO( uint64_t psoKey )
 {
-    auto it = mPSO.find( psoKey );
-    if( it == mPSO.end() )
+    auto pso = GetGraphicsPSO( psoKey );
+    if( !pso ) return;
+
+    // 同じパイプラインステートならコマンドリストが捨てる
+    mCmdList->SetPipelineState( pso );
+}
+
+// パイプラインステートを取得
+GraphicsPSO* ModelBase::GetGraphicsPSO( uint64_t psoKey )
+{
+    if( !mLastPSO || psoKey != mLastPSOKey )
     {
-        CreateGraphicsPSO( psoKey );
-        it = mPSO.find( psoKey );
-        if( it == mPSO.end() ) return;
+        auto it = mPSO.find( psoKey );
+        if( it == mPSO.end() )
+        {
+            CreateGraphicsPSO( psoKey );
+            it = mPSO.find( psoKey );
+            if( it == mPSO.end() ) return nullptr;
+        }
+        mLastPSOKey = psoKey;
+        mLastPSO = it->second.get();
     }
-
-    mCmdList->SetPipelineState( it->second.get() );
+    return mLastPSO;
 }
 
 // z-prepass開始
@@ -91,10 +131,18 @@ void ModelBase::BeginZPrepass( CommandList* cmdList )
 
     mCmdList = cmdList;
     mCmdList->SetGraphicsRootSignature( mZPrepassRS.get() );
-    mCmdList->SetPipelineState( mZPrepassPSO.get() );
+    mCmdList->SetPipelineState( mZPrepassPSOs[0].get() );
     mCmdList->SetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
 }
 
+// z-prepassのパイプラインステートの設定
+void ModelBase::SetZPrepassPSO( MeshFlags meshFlags )
+{
+    auto isQuantized = ( meshFlags & MeshFlags::QuantizedPosition ) == MeshFlags::QuantizedPosition;
+    auto isInstanced = ( meshFlags & MeshFlags::Instanced ) == MeshFlags::Instanced;
+    mCmdList->SetPipelineState( mZPrepassPSOs[( isQuantized ? 1 : 0 ) + ( isInstanced ? 2 : 0 )].get() );
+}
+
 // z-prepass終了
 void ModelBase::EndZPrepass()
 {
@@ -105,14 +153,26 @@ void ModelBase::EndZPrepass()
 void ModelBase::CreateGraphicsPSO( uint64_t psoKey )
 {
     auto& resMgr = ResourceManager::GetInstance();
-    // auto meshFlags = GetMeshFlags( psoKey );
+    auto meshFlags = GetMeshFlags( psoKey );
     auto materialFlags = GetMaterialFlags( psoKey );
 
     GraphicsPSOInit init = {};
     init.mRootSignature = mRS.get();
 
-    // 頂点シェーダー
-    init.mVS = resMgr.GetShader( "assets/shader/ModelVS.hlsl", "vs_6_0" );
+    // 頂点シェーダー(八面体写像の法線はシェーダーで戻す、インスタンシングは変換行列を構造化バッファから読む)
+    auto isOctNormal = ( meshFlags & MeshFlags::OctahedralNormal ) == MeshFlags::OctahedralNormal;
+    if( ( meshFlags & MeshFlags::Instanced ) == MeshFlags::Instanced )
+    {
+        init.mVS = resMgr.GetShader( isOctNormal ? "assets/shader/InstancedOctNormalModelVS.hlsl" : "assets/shader/InstancedModelVS.hlsl", "vs_6_0" );
+    }
+    else if( isOctNormal )
+    {
+        init.mVS = resMgr.GetShader( "assets/shader/OctNormalModelVS.hlsl", "vs_6_0" );
+    }
+    else
+    {
+        init.mVS = resMgr.GetShader( "assets/shader/ModelVS.hlsl", "vs_6_0" );
+    }
 
     // ピクセルシェーダー
     if( ( materialFlags & MaterialFlags::HasTexture ) == MaterialFlags::HasTexture )
@@ -149,16 +209,30 @@ void ModelBase::CreateGraphicsPSO( uint64_t psoKey )
         init.mDepthStencilState = DirectXCommonSettings::gDepthLess;
     }
 
-    // 頂点レイアウト
+    // 頂点レイアウト(メッシュフラグで選んだ形式)
     init.mInputLayouts.resize( 3 );
     init.mInputLayouts[0].SemanticName = "POSITION";
-    init.mInputLayouts[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    init.mInputLayouts[0].Format = GetPositionFormat( meshFlags );
     init.mInputLayouts[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
     init.mInputLayouts[1].SemanticName = "NORMAL";
-    init.mInputLayouts[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+    if( ( meshFlags & MeshFlags::OctahedralNormal ) == MeshFlags::OctahedralNormal )
+    {
+        init.mInputLayouts[1].Format = DXGI_FORMAT_R16G16_SNORM;
+    }
+    else
+    {
+        init.mInputLayouts[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+    }
     init.mInputLayouts[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
     init.mInputLayouts[2].SemanticName = "TEXCOORD";
-    init.mInputLayouts[2].Format = DXGI_FORMAT_R32G32_FLOAT;
+    if( ( meshFlags & MeshFlags::HalfUV ) == MeshFlags::HalfUV )
+    {
+        init.mInputLayouts[2].Format = DXGI_FORMAT_R16G16_FLOAT;
+    }
+    else
+    {
+        init.mInputLayouts[2].Format = DXGI_FORMAT_R32G32_FLOAT;
+    }
     init.mInputLayouts[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 
     auto pso = std::make_unique<GraphicsPSO>();
@@ -176,8 +250,9 @@ bool ModelBase::InitZPrepass()
     auto& resMgr = ResourceManager::GetInstance();
 
     mZPrepassRS = std::make_unique<RootSignature>();
-    mZPrepassRS->Init( 1, 0 );
+    mZPrepassRS->Init( 2, 0 );
     mZPrepassRS->GetParameter( 0 ).InitAsCBV( 0, D3D12_SHADER_VISIBILITY_VERTEX );
+    mZPrepassRS->GetParameter( 1 ).InitAsSRV( 1, D3D12_SHADER_VISIBILITY_VERTEX );  // インスタンシングの変換行列
     if( !mZPrepassRS->Create() )
     {
         return false;
@@ -185,22 +260,29 @@ bool ModelBase::InitZPrepass()
 
     GraphicsPSOInit init = {};
     init.mRootSignature = mZPrepassRS.get();
-    init.mVS = resMgr.GetShader( "assets/shader/ZPrepassVS.hlsl", "vs_6_0" );
     init.mPS = nullptr;
     init.mBlendState = DirectXCommonSettings::gBlendNone;
     init.mRasterizerState = DirectXCommonSettings::gRasterizerDefault;
     init.mDepthStencilState = DirectXCommonSettings::gDepthLess;
     init.mInputLayouts.resize( 1 );
     init.mInputLayouts[0].SemanticName = "POSITION";
-    init.mInputLayouts[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
     init.mInputLayouts[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
     init.mNumRenderTargets = 0;
     init.mRTVFormats[0] = DXGI_FORMAT_UNKNOWN;
 
-    mZPrepassPSO = std::make_unique<GraphicsPSO>();
-    if( !mZPrepassPSO->Create( init ) )
+    // 位置の形式ごと(位置は頂点の先頭なので残りの形式は関係ない)とインスタンシングの有無ごと
+    const MeshFlags positionFlags[] = { MeshFlags::None, MeshFlags::QuantizedPosition };
+    auto* vs = resMgr.GetShader( "assets/shader/ZPrepassVS.hlsl", "vs_6_0" );
+    auto* instancedVS = resMgr.GetShader( "assets/shader/InstancedZPrepassVS.hlsl", "vs_6_0" );
+    for( uint32_t i = 0; i < mZPrepassPSOs.size(); ++i )
     {
-        return false;
+        init.mVS = i < 2 ? vs : instancedVS;
+        init.mInputLayouts[0].Format = GetPositionFormat( positionFlags[i % 2] );
+        mZPrepassPSOs[i] = std::make_unique<GraphicsPSO>();
+        if( !mZPrepassPSOs[i]->Create( init ) )
+        {
+            return false;
+        }
     }
 
     return true;
@@ -19,10 +19,14 @@ class ModelBase
     std::unique_ptr<RootSignature> mRS;
     // パイプラインステート
     std::unordered_map<uint64_t, std::unique_ptr<GraphicsPSO>> mPSO;
+    // 直前に引いたパイプラインステート(同じキーなら探さない)
+    uint64_t mLastPSOKey;
+    GraphicsPSO* mLastPSO;
 
     // z-prepass
     std::unique_ptr<RootSignature> mZPrepassRS;
-    std::unique_ptr<GraphicsPSO> mZPrepassPSO;
+    // 位置の形式とインスタンシングの有無ごと(0:float 1:量子化 2:float・インスタンシング 3:量子化・インスタンシング)
+    std::array<std::unique_ptr<GraphicsPSO>, 4> mZPrepassPSOs;
 
     // コマンドリスト
     CommandList* mCmdList;
@@ -93,6 +97,12 @@ class ModelBase
     /// </summary>
     void End();
 
+    /// <summary>
+    /// ルートシグネチャとプリミティブ型をセット(描画開始のコマンドリストを変えないので、並列記録にも使える)
+    /// </summary>
+    /// <param name="cmdList">コマンドリスト</param>
+    void Bind( CommandList* cmdList ) const;
+
     /// <summary>
     /// z-prepass開始
     /// </summary>
@@ -104,12 +114,25 @@ class ModelBase
     /// </summary>
     void EndZPrepass();
 
+    /// <summary>
+    /// z-prepassのパイプラインステートの設定(位置の形式とインスタンシングの有無に合わせる)
+    /// </summary>
+    /// <param name="meshFlags">メッシュフラグ</param>
+    void SetZPrepassPSO( MeshFlags meshFlags );
+
     /// <summary>
     /// パイプラインステートの設定
     /// </summary>
     /// <param name="psoKey">PSOキー</param>
     void SetGraphicsPSO( uint64_t psoKey );
 
+    /// <summary>
+    /// パイプラインステートを取得(なければ作成するので、描画スレッドから呼ぶ)
+    /// </summary>
+    /// <param name="psoKey">PSOキー</param>
+    /// <returns>パイプラインステート(作れなければnullptr)</returns>
+    GraphicsPSO* GetGraphicsPSO( uint64_t psoKey );
+
    private:
     /// <summary>
     /// パイプラインステートの作成
@@ -2,6 +2,8 @@
 
 #include <format>
 
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
 #include "core/ResourceManager.h"
 #include "utils/StringHelper.h"
 
@@ -12,6 +14,27 @@ namespace
 const bool kIsOutput = false;
 #endif
 const std::string kErrorTex = "assets/texture/error.png";
+// キーの時間の単位が指定されていないときの1秒あたりのティック数
+const double kDefaultTicksPerSecond = 25.0;
+// スキンを持たないメッシュの頂点バッファの圧縮(MeshFlags::Compactの一部だけでもよい)
+const MeshFlags kCompactMeshFlags = MeshFlags::Compact;
+
+// assimpの行列(列ベクトル)を左手系の行列(行ベクトル)に変換
+Matrix4 ConvertMatrix( const aiMatrix4x4& m )
+{
+    Matrix4 mat;
+    const ai_real* src[4] = { m[0], m[1], m[2], m[3] };
+    for( uint32_t r = 0; r < 4; ++r )
+    {
+        for( uint32_t c = 0; c < 4; ++c )
+        {
+            // 転置してX軸を反転
+            auto sign = ( r == 0 ) != ( c == 0 ) ? -1.0f : 1.0f;
+            mat.m[r][c] = sign * static_cast<float>( src[c][r] );
+        }
+    }
+    return mat;
+}
 
 }  // namespace
 
@@ -23,11 +46,12 @@ ModelData::ModelData()
     , mNodeNameToNodeIdx()
     , mPath()
     , mNodes()
-    , mRootNodeIdx( 0 )
     , mMeshCount( 0 )
     , mMeshes()
     , mMaterialCount( 0 )
     , mMaterials()
+    , mAnimations()
+    , mCompressedAnimations()
 {
 }
 
@@ -44,17 +68,19 @@ bool ModelData::Build( const std::string& path )
     }
 
     // ノードを構築
-    mRootNodeIdx = BuildNode( mAssimpScene->mRootNode, {} );
+    BuildNode();
     // メッシュを構築
-    BuildMesh( &mNodes[mRootNodeIdx] );
+    BuildMesh();
     // マテリアルを構築
     BuildMaterial();
+    // アニメーションを構築
+    BuildAnimation();
 
 #ifdef _DEBUG
     if( kIsOutput )
     {
         // ノードの階層をデバッグ表示
-        OutputNodeInfo( &mNodes[mRootNodeIdx] );
+        OutputNodeInfo();
     }
 #endif
 
@@ -69,126 +95,381 @@ bool ModelData::Build( const std::string& path )
     return true;
 }
 
-// ノードを構築
-int32_t ModelData::BuildNode( aiNode* assimpNode, const std::optional<int32_t>& parent )
+// クックしたモデルを読み込む
+bool ModelData::Load( const std::string& cookedPath )
 {
-    ModelNode node = {};
-    node.mName = assimpNode->mName.C_Str();  // ノード名
-
-    // ノードのトランスフォーム
-    aiVector3D scale;
-    aiQuaternion rotate;
-    aiVector3D translate;
-    assimpNode->mTransformation.Decompose( scale, rotate, translate );
-    node.mScale = Vector3( scale.x, scale.y, scale.z );
-    node.mRotate = Quaternion( rotate.w, rotate.x, -rotate.y, -rotate.z );
-    node.mTranslate = Vector3( -translate.x, translate.y, translate.z );
-    node.mLocalMat = CreateAffine( node.mScale, node.mRotate, node.mTranslate );  // ローカル行列
-    // モデル行列を計算
-    if( parent )
+    using namespace CookedModelFormat;
+
+    CookedModel cooked;
+    if( !cooked.Open( cookedPath ) ) return false;
+
+    mPath = cookedPath;
+
+    // ノード(親が先に並んでいること)
+    mNodes.Clear();
+    for( const auto& record : cooked.GetBlob<NodeRecord>( BlobType::kNodes ) )
     {
-        node.mModelMat = node.mLocalMat * mNodes[*parent].mModelMat;
+        if( record.mParent < NodeHierarchy::kInvalidIndex || record.mParent >= static_cast<int32_t>( mNodes.GetCount() ) ) return false;
+
+        mNodes.AddNode( std::string( cooked.GetString( record.mName ) ), record.mParent, record.mScale, record.mRotate, record.mTranslate );
     }
-    else
+
+    // メッシュ(頂点・インデックスはエンジンのレイアウトのまま)
+    for( const auto& record : cooked.GetBlob<MeshRecord>( BlobType::kMeshes ) )
     {
-        node.mModelMat = node.mLocalMat;
+        auto vertices = cooked.GetRange<MeshVertex>( BlobType::kVertices, record.mVertices );
+        auto indices = cooked.GetRange<uint32_t>( BlobType::kIndices, record.mIndices );
+        auto lodIndices = cooked.GetRange<uint32_t>( BlobType::kIndices, record.mLodIndices );
+        auto lods = cooked.GetRange<MeshLod>( BlobType::kLods, record.mLods );
+        auto meshlets = cooked.GetRange<Meshlet>( BlobType::kMeshlets, record.mMeshlets );
+        auto meshletIndices = cooked.GetRange<uint32_t>( BlobType::kIndices, record.mMeshletIndices );
+        auto vertexData = cooked.GetRange<uint8_t>( BlobType::kVertexData, record.mVertexData );
+        auto indexData = cooked.GetRange<uint8_t>( BlobType::kIndexData, record.mIndexData );
+        if( vertices.size() != record.mVertices.mCount || indices.size() != record.mIndices.mCount ) return false;
+        if( lodIndices.size() != record.mLodIndices.mCount || lods.size() != record.mLods.mCount ) return false;
+        if( meshlets.size() != record.mMeshlets.mCount || meshletIndices.size() != record.mMeshletIndices.mCount ) return false;
+        if( vertexData.size() != record.mVertexData.mCount || indexData.size() != record.mIndexData.mCount ) return false;
+        if( record.mNodeIdx < 0 || record.mNodeIdx >= static_cast<int32_t>( mNodes.GetCount() ) ) return false;
+
+        auto mesh = std::make_unique<Mesh>();
+        mesh->mName = cooked.GetString( record.mName );
+        mesh->mAABB.mMin = record.mAABBMin;
+        mesh->mAABB.mMax = record.mAABBMax;
+        mesh->mMaterialIdx = record.mMaterialIdx;
+        // バッファはクック時に圧縮したものをそのまま書き込む
+        Mesh::EncodedData encoded = {};
+        encoded.mVertexData = vertexData;
+        encoded.mDequantizeMat = record.mDequantizeMat;
+        encoded.mIndexData = indexData;
+        encoded.mIndexStride = record.mIndexStride;
+        if( !mesh->Create( static_cast<MeshFlags>( record.mFlags ), vertices, indices, lods, lodIndices, meshlets, meshletIndices, encoded ) ) return false;
+
+        MeshData meshData = {};
+        meshData.mNodeIdx = record.mNodeIdx;
+        meshData.mMesh = std::move( mesh );
+        meshData.mOptimizeStats = record.mOptimizeStats;
+        if( record.mSkinIdx != UINT32_MAX )
+        {
+            meshData.mSkin = LoadSkin( cooked, record.mSkinIdx );
+            if( !meshData.mSkin ) return false;
+        }
+        mMeshes.push_back( std::move( meshData ) );
+        ++mMeshCount;
     }
 
-    // 親子構造
-    node.mIndex = static_cast<uint32_t>( mNodes.size() );
-    node.mParent = parent;
-    mNodes.push_back( node );
-    // ヘルパーに追加
-    mNodeIdxToAssimpNode.emplace( node.mIndex, assimpNode );
-    mNodeNameToNodeIdx.emplace( node.mName, node.mIndex );
-    // 再帰で子ノードを構築
-    mNodes[node.mIndex].mChildren.resize( assimpNode->mNumChildren );
-    for( uint32_t i = 0; i < assimpNode->mNumChildren; ++i )
+    // マテリアル(テクスチャのパスはクック時に解決済み)
+    ResourceManager& resMgr = ResourceManager::GetInstance();
+    for( const auto& record : cooked.GetBlob<MaterialRecord>( BlobType::kMaterials ) )
     {
-        mNodes[node.mIndex].mChildren[i] = BuildNode( assimpNode->mChildren[i], node.mIndex );
+        auto material = std::make_unique<Material>();
+        material->mName = cooked.GetString( record.mName );
+        material->mColor = record.mColor;
+
+        Texture* texture = nullptr;
+        auto texturePath = cooked.GetString( record.mTexturePath );
+        if( !texturePath.empty() )
+        {
+            texture = resMgr.GetTexture( std::string( texturePath ) );
+            if( !texture )
+            {
+                texture = resMgr.GetTexture( kErrorTex );
+            }
+        }
+
+        material->Create( texture );
+        mMaterials.emplace_back( std::move( material ) );
+        ++mMaterialCount;
     }
 
-    return node.mIndex;
+    // アニメーション
+    if( !LoadAnimation( cooked ) ) return false;
+
+    mIsBuilt = true;
+    return true;
 }
 
-// メッシュを構築
-void ModelData::BuildMesh( ModelNode* node )
+// クックしたモデルを書き出す
+bool ModelData::Cook( const std::string& cookedPath ) const
 {
-    auto assimpNode = mNodeIdxToAssimpNode[node->mIndex];
-    for( uint32_t meshIdx = 0; meshIdx < assimpNode->mNumMeshes; ++meshIdx )
+    using namespace CookedModelFormat;
+
+    if( !mIsBuilt ) return false;
+
+    CookedModelWriter writer;
+
+    // ノード
+    const auto& bindPose = mNodes.GetBindPose();
+    for( uint32_t i = 0; i < mNodes.GetCount(); ++i )
     {
-        aiMesh* assimpMesh = mAssimpScene->mMeshes[assimpNode->mMeshes[meshIdx]];
-        if( !assimpMesh->HasPositions() ||
-            !assimpMesh->HasNormals() ||
-            !assimpMesh->HasTextureCoords( 0 ) )
+        NodeRecord record = {};
+        record.mName = writer.AddString( mNodes.GetName( i ) );
+        record.mParent = mNodes.GetParent( i );
+        record.mScale = bindPose.mScales[i];
+        record.mRotate = bindPose.mRotates[i];
+        record.mTranslate = bindPose.mTranslates[i];
+        writer.Add( BlobType::kNodes, record );
+    }
+
+    // メッシュ
+    for( const auto& meshData : mMeshes )
+    {
+        const auto& mesh = *meshData.mMesh;
+        MeshRecord record = {};
+        record.mName = writer.AddString( mesh.mName );
+        record.mNodeIdx = meshData.mNodeIdx;
+        record.mMaterialIdx = mesh.mMaterialIdx;
+        record.mFlags = static_cast<uint32_t>( mesh.mFlags );
+        record.mVertices = writer.Append( BlobType::kVertices, std::span<const MeshVertex>( mesh.mVertices ) );
+        record.mIndices = writer.Append( BlobType::kIndices, std::span<const uint32_t>( mesh.mIndices ) );
+        record.mLodIndices = writer.Append( BlobType::kIndices, std::span<const uint32_t>( mesh.mLodIndices ) );
+        // LOD1以降(範囲はLOD1以降のインデックス内に戻す)
+        std::vector<MeshLod> lods;
+        if( mesh.mLods.size() > 1 )
+        {
+            lods.assign( mesh.mLods.begin() + 1, mesh.mLods.end() );
+        }
+        for( auto& lod : lods )
+        {
+            lod.mIndexOffset -= static_cast<uint32_t>( mesh.mIndices.size() );
+        }
+        record.mLods = writer.Append( BlobType::kLods, std::span<const MeshLod>( lods ) );
+        // メッシュレット(範囲はメッシュレット用のインデックス内に戻す)
+        std::vector<Meshlet> meshlets( mesh.mMeshlets.begin(), mesh.mMeshlets.end() );
+        for( auto& meshlet : meshlets )
+        {
+            meshlet.mIndexOffset -= static_cast<uint32_t>( mesh.mIndices.size() + mesh.mLodIndices.size() );
+        }
+        record.mMeshlets = writer.Append( BlobType::kMeshlets, std::span<const Meshlet>( meshlets ) );
+        record.mMeshletIndices = writer.Append( BlobType::kIndices, std::span<const uint32_t>( mesh.mMeshletIndices ) );
+        // 頂点バッファ・インデックスバッファ(読み込み時に圧縮し直さない)
+        std::vector<uint8_t> data;
+        mesh.EncodeVertices( data, record.mDequantizeMat );
+        record.mVertexData = writer.Append( BlobType::kVertexData, std::span<const uint8_t>( data ) );
+        record.mIndexStride = mesh.EncodeIndices( data );
+        record.mIndexData = writer.Append( BlobType::kIndexData, std::span<const uint8_t>( data ) );
+        record.mAABBMin = mesh.mAABB.mMin;
+        record.mAABBMax = mesh.mAABB.mMax;
+        record.mSkinIdx = UINT32_MAX;
+        record.mOptimizeStats = meshData.mOptimizeStats;
+        if( meshData.mSkin )
         {
-            continue;
+            const auto& skin = *meshData.mSkin;
+            SkinRecord skinRecord = {};
+            skinRecord.mBones = writer.Append( BlobType::kBoneNodes, std::span<const int32_t>( skin.mBoneNodes ) );
+            skinRecord.mOffsetMats = writer.Append( BlobType::kOffsetMats, std::span<const Matrix4>( skin.mOffsetMats ) );
+            skinRecord.mInfluences = writer.Append( BlobType::kInfluences, std::span<const SkinInfluence>( skin.mInfluences ) );
+            record.mSkinIdx = writer.Add( BlobType::kSkins, skinRecord );
         }
+        writer.Add( BlobType::kMeshes, record );
+    }
 
-        std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>();
-        auto meshFlags = MeshFlags::Required;
-        // メッシュ名
-        mesh->mName = assimpMesh->mName.C_Str();
-        mesh->mAABB.Reset();
+    // マテリアル
+    for( const auto& material : mMaterials )
+    {
+        MaterialRecord record = {};
+        record.mName = writer.AddString( material->mName );
+        record.mTexturePath = writer.AddString( material->mTexture ? material->mTexture->GetPath() : std::string() );
+        record.mColor = material->mColor;
+        writer.Add( BlobType::kMaterials, record );
+    }
 
-        // 頂点データ
-        std::vector<Mesh::Vertex> vertices( assimpMesh->mNumVertices );
-        for( uint32_t vertexIdx = 0; vertexIdx < assimpMesh->mNumVertices; ++vertexIdx )
+    // アニメーション(元のクリップと圧縮したクリップ)
+    for( size_t i = 0; i < mAnimations.size(); ++i )
+    {
+        const auto& clip = *mAnimations[i];
+        const auto& compressed = *mCompressedAnimations[i];
+        std::vector<ChannelRecord> channels;
+        for( const auto& channel : clip.GetChannels() )
         {
-            auto& position = assimpMesh->mVertices[vertexIdx];
-            auto& normal = assimpMesh->mNormals[vertexIdx];
-            auto& uv = assimpMesh->mTextureCoords[0][vertexIdx];
-            vertices[vertexIdx] = Mesh::Vertex{
-                Vector4( -position.x, position.y, position.z, 1.0f ),
-                Vector3( -normal.x, normal.y, normal.z ),
-                Vector2( uv.x, uv.y ) };
-
-            mesh->mAABB.Update( Vector3( -position.x, position.y, position.z ) );
+            ChannelRecord channelRecord = {};
+            channelRecord.mNodeIdx = channel.mNodeIdx;
+            channelRecord.mPositionTimes = writer.Append( BlobType::kKeyTimes, std::span<const float>( channel.mPositionTimes ) );
+            channelRecord.mPositionOffset = writer.Append( BlobType::kKeyVectors, std::span<const Vector3>( channel.mPositions ) ).mOffset;
+            channelRecord.mRotationTimes = writer.Append( BlobType::kKeyTimes, std::span<const float>( channel.mRotationTimes ) );
+            channelRecord.mRotationOffset = writer.Append( BlobType::kKeyRotations, std::span<const Quaternion>( channel.mRotations ) ).mOffset;
+            channelRecord.mScaleTimes = writer.Append( BlobType::kKeyTimes, std::span<const float>( channel.mScaleTimes ) );
+            channelRecord.mScaleOffset = writer.Append( BlobType::kKeyVectors, std::span<const Vector3>( channel.mScales ) ).mOffset;
+            channels.emplace_back( channelRecord );
         }
 
-        // 頂点インデックスデータ
-        std::vector<uint32_t> indices;
-        for( uint32_t faceIdx = 0; faceIdx < assimpMesh->mNumFaces; ++faceIdx )
+        ClipRecord record = {};
+        record.mName = writer.AddString( clip.GetName() );
+        record.mDuration = clip.GetDuration();
+        record.mChannels = writer.Append( BlobType::kChannels, std::span<const ChannelRecord>( channels ) );
+        record.mTimeToKey = compressed.mTimeToKey;
+        record.mCompressedChannels = writer.Append( BlobType::kCompressedChannels, std::span<const CompressedAnimationClip::Channel>( compressed.mChannels ) );
+        record.mCompressedRanges = writer.Append( BlobType::kCompressedRanges, std::span<const CompressedAnimationClip::Range>( compressed.mRanges ) );
+        record.mCompressedTimes = writer.Append( BlobType::kCompressedTimes, std::span<const uint16_t>( compressed.mTimes ) );
+        record.mCompressedValues = writer.Append( BlobType::kCompressedValues, std::span<const uint16_t>( compressed.mValues ) );
+        writer.Add( BlobType::kClips, record );
+    }
+
+    return writer.Write( cookedPath );
+}
+
+// ノードを構築
+void ModelData::BuildNode()
+{
+    mNodes.Clear();
+    mNodeIdxToAssimpNode.clear();
+
+    // assimpノードと親のインデックス
+    std::vector<std::pair<aiNode*, int32_t>> stack;
+    stack.emplace_back( mAssimpScene->mRootNode, NodeHierarchy::kInvalidIndex );
+    while( !stack.empty() )
+    {
+        auto [assimpNode, parent] = stack.back();
+        stack.pop_back();
+
+        // ノードのトランスフォーム
+        aiVector3D scale;
+        aiQuaternion rotate;
+        aiVector3D translate;
+        assimpNode->mTransformation.Decompose( scale, rotate, translate );
+        auto idx = mNodes.AddNode(
+            assimpNode->mName.C_Str(),
+            parent,
+            Vector3( scale.x, scale.y, scale.z ),
+            Quaternion( rotate.w, rotate.x, -rotate.y, -rotate.z ),
+            Vector3( -translate.x, translate.y, translate.z ) );
+
+        // ヘルパーに追加
+        mNodeIdxToAssimpNode.emplace_back( assimpNode );
+        mNodeNameToNodeIdx.emplace( mNodes.GetName( idx ), idx );
+        // 子ノードは先頭の子から取り出されるように逆順に積む
+        for( auto i = assimpNode->mNumChildren; i > 0; --i )
+        {
+            stack.emplace_back( assimpNode->mChildren[i - 1], idx );
+        }
+    }
+}
+
+// メッシュを構築
+void ModelData::BuildMesh()
+{
+    for( uint32_t nodeIdx = 0; nodeIdx < mNodes.GetCount(); ++nodeIdx )
+    {
+        auto assimpNode = mNodeIdxToAssimpNode[nodeIdx];
+        for( uint32_t meshIdx = 0; meshIdx < assimpNode->mNumMeshes; ++meshIdx )
         {
-            auto& face = assimpMesh->mFaces[faceIdx];
-            if( face.mNumIndices > 4 )  // 五角形以上は無視
+            aiMesh* assimpMesh = mAssimpScene->mMeshes[assimpNode->mMeshes[meshIdx]];
+            if( !assimpMesh->HasPositions() ||
+                !assimpMesh->HasNormals() ||
+                !assimpMesh->HasTextureCoords( 0 ) )
             {
                 continue;
             }
-            for( uint32_t i = 0; i < face.mNumIndices; ++i )
+
+            std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>();
+            auto meshFlags = MeshFlags::Required;
+            // メッシュ名
+            mesh->mName = assimpMesh->mName.C_Str();
+            mesh->mAABB.Reset();
+
+            // 頂点データ
+            std::vector<Mesh::Vertex> vertices( assimpMesh->mNumVertices );
+            for( uint32_t vertexIdx = 0; vertexIdx < assimpMesh->mNumVertices; ++vertexIdx )
             {
-                if( i == 3 )
+                auto& position = assimpMesh->mVertices[vertexIdx];
+                auto& normal = assimpMesh->mNormals[vertexIdx];
+                auto& uv = assimpMesh->mTextureCoords[0][vertexIdx];
+                vertices[vertexIdx] = Mesh::Vertex{
+                    Vector4( -position.x, position.y, position.z, 1.0f ),
+                    Vector3( -normal.x, normal.y, normal.z ),
+                    Vector2( uv.x, uv.y ) };
+
+                mesh->mAABB.Update( Vector3( -position.x, position.y, position.z ) );
+            }
+
+            // 頂点インデックスデータ
+            std::vector<uint32_t> indices;
+            for( uint32_t faceIdx = 0; faceIdx < assimpMesh->mNumFaces; ++faceIdx )
+            {
+                auto& face = assimpMesh->mFaces[faceIdx];
+                if( face.mNumIndices == 3 )
                 {
-                    indices.emplace_back( face.mIndices[i - 1] );
-                    indices.emplace_back( face.mIndices[i] );
-                    indices.emplace_back( face.mIndices[i - 3] );
+                    indices.insert( indices.end(), face.mIndices, face.mIndices + 3 );
                 }
-                else
+                else if( face.mNumIndices == 4 )  // 四角形は短い方の対角線で分ける
                 {
-                    indices.emplace_back( face.mIndices[i] );
+                    const uint32_t quad[4] = { face.mIndices[0], face.mIndices[1], face.mIndices[2], face.mIndices[3] };
+                    MeshOptimizer::TriangulateQuad( vertices, quad, indices );
                 }
+                // 点・線・五角形以上は無視
             }
-        }
 
-        // マテリアルのインデックス
-        mesh->mMaterialIdx = assimpMesh->mMaterialIndex;
+            // マテリアルのインデックス
+            mesh->mMaterialIdx = assimpMesh->mMaterialIndex;
 
-        // 作成
-        mesh->Create( meshFlags, vertices, indices );
+            // スキン情報(頂点と一緒に並び替えるので先に構築)
+            std::unique_ptr<SkinData> skin;
+            if( assimpMesh->HasBones() )
+            {
+                skin = BuildSkin( assimpMesh );
+            }
 
-        // ノードとメッシュを紐付ける
-        MeshData meshData = {};
-        meshData.mNodeIdx = node->mIndex;
-        meshData.mMesh = std::move( mesh );
-        mMeshes.push_back( std::move( meshData ) );
-        ++mMeshCount;
+            // 最適化
+            auto* influences = skin ? &skin->mInfluences : nullptr;
+            auto stats = MeshOptimizer::Optimize( vertices, indices, influences );
+
+            // メッシュレット(三角形の順が変わるので、通常の描画の順を崩さないように別のインデックスで持つ)
+            std::vector<Meshlet> meshlets;
+            auto meshletIndices = indices;
+            MeshletBuilder::Build( vertices, meshletIndices, meshlets );
+
+            // 詳細度(頂点は共有してインデックスだけ作る)
+            std::vector<MeshLod> lods;
+            std::vector<uint32_t> lodIndices;
+            MeshSimplifier::GenerateLods( vertices, indices, lods, lodIndices );
+
+            // 作成(スキニングする頂点バッファはインスタンスごとにfloatのまま書き換えるので圧縮しない)
+            if( !skin )
+            {
+                meshFlags |= kCompactMeshFlags;
+            }
+            mesh->Create( meshFlags, vertices, indices, lods, lodIndices, meshlets, meshletIndices );
+
+            // ノードとメッシュを紐付ける
+            MeshData meshData = {};
+            meshData.mNodeIdx = nodeIdx;
+            meshData.mMesh = std::move( mesh );
+            meshData.mSkin = std::move( skin );
+            meshData.mOptimizeStats = stats;
+            mMeshes.push_back( std::move( meshData ) );
+            ++mMeshCount;
+        }
     }
+}
 
-    // 子メッシュを構築
-    for( uint32_t i = 0; i < node->mChildren.size(); ++i )
+// スキン情報を構築
+std::unique_ptr<SkinData> ModelData::BuildSkin( const aiMesh* assimpMesh )
+{
+    auto skin = std::make_unique<SkinData>();
+    skin->mInfluences.assign( assimpMesh->mNumVertices, SkinInfluence{} );
+    for( uint32_t boneIdx = 0; boneIdx < assimpMesh->mNumBones; ++boneIdx )
     {
-        BuildMesh( &mNodes[node->mChildren[i]] );
+        const aiBone* assimpBone = assimpMesh->mBones[boneIdx];
+        auto it = mNodeNameToNodeIdx.find( assimpBone->mName.C_Str() );
+        if( it == mNodeNameToNodeIdx.end() ) continue;
+
+        auto skinBoneIdx = static_cast<uint16_t>( skin->mBoneNodes.size() );
+        skin->mBoneNodes.emplace_back( it->second );
+        skin->mOffsetMats.emplace_back( ConvertMatrix( assimpBone->mOffsetMatrix ) );
+
+        // 重みの大きい順に最大4本まで残す
+        for( uint32_t i = 0; i < assimpBone->mNumWeights; ++i )
+        {
+            const auto& assimpWeight = assimpBone->mWeights[i];
+            if( assimpWeight.mVertexId >= assimpMesh->mNumVertices ) continue;
+
+            Skinning::AddInfluence( skin->mInfluences[assimpWeight.mVertexId], skinBoneIdx, assimpWeight.mWeight );
+        }
     }
+
+    // 重みの合計を1にする
+    Skinning::NormalizeInfluences( skin->mInfluences );
+
+    return skin;
 }
 
 // マテリアルを構築
@@ -239,6 +520,192 @@ void ModelData::BuildMaterial()
     }
 }
 
+// アニメーションを構築
+void ModelData::BuildAnimation()
+{
+    for( uint32_t animIdx = 0; animIdx < mAssimpScene->mNumAnimations; ++animIdx )
+    {
+        const aiAnimation* assimpAnim = mAssimpScene->mAnimations[animIdx];
+        auto ticksPerSecond = assimpAnim->mTicksPerSecond != 0.0 ? assimpAnim->mTicksPerSecond : kDefaultTicksPerSecond;
+
+        std::vector<AnimationChannel> channels;
+        channels.reserve( assimpAnim->mNumChannels );
+        for( uint32_t channelIdx = 0; channelIdx < assimpAnim->mNumChannels; ++channelIdx )
+        {
+            const aiNodeAnim* assimpChannel = assimpAnim->mChannels[channelIdx];
+            auto it = mNodeNameToNodeIdx.find( assimpChannel->mNodeName.C_Str() );
+            if( it == mNodeNameToNodeIdx.end() ) continue;
+
+            // ノードと同じように左手系へ変換
+            AnimationChannel channel = {};
+            channel.mNodeIdx = it->second;
+            for( uint32_t i = 0; i < assimpChannel->mNumPositionKeys; ++i )
+            {
+                const auto& key = assimpChannel->mPositionKeys[i];
+                channel.mPositionTimes.emplace_back( static_cast<float>( key.mTime / ticksPerSecond ) );
+                channel.mPositions.emplace_back( -key.mValue.x, key.mValue.y, key.mValue.z );
+            }
+            for( uint32_t i = 0; i < assimpChannel->mNumRotationKeys; ++i )
+            {
+                const auto& key = assimpChannel->mRotationKeys[i];
+                channel.mRotationTimes.emplace_back( static_cast<float>( key.mTime / ticksPerSecond ) );
+                channel.mRotations.emplace_back( key.mValue.w, key.mValue.x, -key.mValue.y, -key.mValue.z );
+            }
+            for( uint32_t i = 0; i < assimpChannel->mNumScalingKeys; ++i )
+            {
+                const auto& key = assimpChannel->mScalingKeys[i];
+                channel.mScaleTimes.emplace_back( static_cast<float>( key.mTime / ticksPerSecond ) );
+                channel.mScales.emplace_back( key.mValue.x, key.mValue.y, key.mValue.z );
+            }
+            channels.emplace_back( std::move( channel ) );
+        }
+
+        auto clip = std::make_unique<AnimationClip>();
+        if( !clip->Create( assimpAnim->mName.C_Str(), static_cast<float>( assimpAnim->mDuration / ticksPerSecond ), std::move( channels ) ) ) continue;
+
+        // 再生用に圧縮する
+        auto compressed = std::make_unique<CompressedAnimationClip>();
+        if( !compressed->Create( *clip, mNodes ) ) continue;
+
+        mAnimations.emplace_back( std::move( clip ) );
+        mCompressedAnimations.emplace_back( std::move( compressed ) );
+    }
+}
+
+// クックしたスキン情報を読み込む
+std::unique_ptr<SkinData> ModelData::LoadSkin( const CookedModel& cooked, uint32_t skinIdx ) const
+{
+    using namespace CookedModelFormat;
+
+    auto skins = cooked.GetBlob<SkinRecord>( BlobType::kSkins );
+    if( skinIdx >= skins.size() ) return nullptr;
+
+    const auto& record = skins[skinIdx];
+    auto boneNodes = cooked.GetRange<int32_t>( BlobType::kBoneNodes, record.mBones );
+    auto offsetMats = cooked.GetRange<Matrix4>( BlobType::kOffsetMats, record.mOffsetMats );
+    auto influences = cooked.GetRange<SkinInfluence>( BlobType::kInfluences, record.mInfluences );
+    if( boneNodes.size() != record.mBones.mCount || offsetMats.size() != record.mOffsetMats.mCount || influences.size() != record.mInfluences.mCount ) return nullptr;
+    // オフセット行列はボーンと1対1
+    if( record.mOffsetMats.mCount != record.mBones.mCount ) return nullptr;
+
+    for( auto nodeIdx : boneNodes )
+    {
+        if( nodeIdx < 0 || nodeIdx >= static_cast<int32_t>( mNodes.GetCount() ) ) return nullptr;
+    }
+
+    auto skin = std::make_unique<SkinData>();
+    skin->mBoneNodes.assign( boneNodes.begin(), boneNodes.end() );
+    skin->mOffsetMats.assign( offsetMats.begin(), offsetMats.end() );
+    skin->mInfluences.assign( influences.begin(), influences.end() );
+    return skin;
+}
+
+// クックしたアニメーションを読み込む
+bool ModelData::LoadAnimation( const CookedModel& cooked )
+{
+    using namespace CookedModelFormat;
+
+    auto nodeCount = static_cast<int32_t>( mNodes.GetCount() );
+    for( const auto& record : cooked.GetBlob<ClipRecord>( BlobType::kClips ) )
+    {
+        // 元のクリップ
+        auto channelRecords = cooked.GetRange<ChannelRecord>( BlobType::kChannels, record.mChannels );
+        if( channelRecords.size() != record.mChannels.mCount ) return false;
+
+        std::vector<AnimationChannel> channels;
+        channels.reserve( channelRecords.size() );
+        for( const auto& channelRecord : channelRecords )
+        {
+            if( channelRecord.mNodeIdx < 0 || channelRecord.mNodeIdx >= nodeCount ) return false;
+
+            auto positionTimes = cooked.GetRange<float>( BlobType::kKeyTimes, channelRecord.mPositionTimes );
+            auto positions = cooked.GetRange<Vector3>( BlobType::kKeyVectors, { channelRecord.mPositionOffset, channelRecord.mPositionTimes.mCount } );
+            auto rotationTimes = cooked.GetRange<float>( BlobType::kKeyTimes, channelRecord.mRotationTimes );
+            auto rotations = cooked.GetRange<Quaternion>( BlobType::kKeyRotations, { channelRecord.mRotationOffset, channelRecord.mRotationTimes.mCount } );
+            auto scaleTimes = cooked.GetRange<float>( BlobType::kKeyTimes, channelRecord.mScaleTimes );
+            auto scales = cooked.GetRange<Vector3>( BlobType::kKeyVectors, { channelRecord.mScaleOffset, channelRecord.mScaleTimes.mCount } );
+            if( positionTimes.size() != channelRecord.mPositionTimes.mCount || positions.size() != positionTimes.size() ||
+                rotationTimes.size() != channelRecord.mRotationTimes.mCount || rotations.size() != rotationTimes.size() ||
+                scaleTimes.size() != channelRecord.mScaleTimes.mCount || scales.size() != scaleTimes.size() )
+            {
+                return false;
+            }
+
+            AnimationChannel channel = {};
+            channel.mNodeIdx = channelRecord.mNodeIdx;
+            channel.mPositionTimes.assign( positionTimes.begin(), positionTimes.end() );
+            channel.mPositions.assign( positions.begin(), positions.end() );
+            channel.mRotationTimes.assign( rotationTimes.begin(), rotationTimes.end() );
+            channel.mRotations.assign( rotations.begin(), rotations.end() );
+            channel.mScaleTimes.assign( scaleTimes.begin(), scaleTimes.end() );
+            channel.mScales.assign( scales.begin(), scales.end() );
+            channels.emplace_back( std::move( channel ) );
+        }
+
+        auto clip = std::make_unique<AnimationClip>();
+        if( !clip->Create( std::string( cooked.GetString( record.mName ) ), record.mDuration, std::move( channels ) ) ) return false;
+
+        // 圧縮したクリップは圧縮し直さずにそのまま使う
+        auto compressedChannels = cooked.GetRange<CompressedAnimationClip::Channel>( BlobType::kCompressedChannels, record.mCompressedChannels );
+        auto ranges = cooked.GetRange<CompressedAnimationClip::Range>( BlobType::kCompressedRanges, record.mCompressedRanges );
+        auto times = cooked.GetRange<uint16_t>( BlobType::kCompressedTimes, record.mCompressedTimes );
+        auto values = cooked.GetRange<uint16_t>( BlobType::kCompressedValues, record.mCompressedValues );
+        if( compressedChannels.size() != record.mCompressedChannels.mCount || ranges.size() != record.mCompressedRanges.mCount ||
+            times.size() != record.mCompressedTimes.mCount || values.size() != record.mCompressedValues.mCount ||
+            values.size() != times.size() * CompressedAnimationClip::kValueStride )
+        {
+            return false;
+        }
+        for( const auto& channel : compressedChannels )
+        {
+            if( channel.mNodeIdx < 0 || channel.mNodeIdx >= nodeCount ) return false;
+
+            for( const auto* track : { &channel.mPosition, &channel.mRotation, &channel.mScale } )
+            {
+                if( static_cast<size_t>( track->mKeyOffset ) + track->mKeyCount > times.size() ) return false;
+            }
+            for( const auto* track : { &channel.mPosition, &channel.mScale } )
+            {
+                if( track->mKeyCount > 0 && track->mRangeIdx >= ranges.size() ) return false;
+            }
+        }
+
+        auto compressed = std::make_unique<CompressedAnimationClip>();
+        compressed->mName = clip->GetName();
+        compressed->mDuration = clip->GetDuration();
+        compressed->mTimeToKey = record.mTimeToKey;
+        compressed->mChannels.assign( compressedChannels.begin(), compressedChannels.end() );
+        compressed->mRanges.assign( ranges.begin(), ranges.end() );
+        compressed->mTimes.assign( times.begin(), times.end() );
+        compressed->mValues.assign( values.begin(), values.end() );
+
+        mAnimations.emplace_back( std::move( clip ) );
+        mCompressedAnimations.emplace_back( std::move( compressed ) );
+    }
+
+    return true;
+}
+
+// アニメーションクリップを名前で探す
+const AnimationClip* ModelData::FindAnimation( const std::string& name ) const
+{
+    for( const auto& animation : mAnimations )
+    {
+        if( animation->GetName() == name ) return animation.get();
+    }
+    return nullptr;
+}
+
+// 圧縮したアニメーションクリップを名前で探す
+const CompressedAnimationClip* ModelData::FindCompressedAnimation( const std::string& name ) const
+{
+    for( const auto& animation : mCompressedAnimations )
+    {
+        if( animation->GetName() == name ) return animation.get();
+    }
+    return nullptr;
+}
+
 // 更新
 void ModelData::Update()
 {
@@ -252,12 +719,15 @@ void ModelData::Update()
 #ifdef _DEBUG
 
 // ノードの階層をデバッグ表示
-void ModelData::OutputNodeInfo( ModelNode* node, uint32_t depth )
+void ModelData::OutputNodeInfo()
 {
-    OutputDebugStringA( std::format( "{}{}\n", std::string( depth, '\t' ), node->mName ).c_str() );
-    for( auto idx : node->mChildren )
+    // 親が先に並ぶので深さも先頭から求まる
+    std::vector<uint32_t> depths( mNodes.GetCount() );
+    for( uint32_t i = 0; i < mNodes.GetCount(); ++i )
     {
-        OutputNodeInfo( &mNodes[idx], depth + 1 );
+        auto parent = mNodes.GetParent( i );
+        depths[i] = parent == NodeHierarchy::kInvalidIndex ? 0 : depths[parent] + 1;
+        OutputDebugStringA( std::format( "{}{}\n", std::string( depths[i], '\t' ), mNodes.GetName( i ) ).c_str() );
     }
 }
 
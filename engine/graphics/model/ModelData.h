@@ -3,43 +3,18 @@
 #include <assimp/scene.h>
 
 #include <assimp/Importer.hpp>
-#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "CookedModel.h"
 #include "Material.h"
 #include "Mesh.h"
-#include "math/Matrix4.h"
-#include "math/Quaternion.h"
-#include "math/Vector3.h"
-
-/// <summary>
-/// モデルノード
-/// </summary>
-struct ModelNode
-{
-    // ノード名
-    std::string mName;
-    // トランスフォーム
-    // スケール
-    Vector3 mScale;
-    // 回転
-    Quaternion mRotate;
-    // 座標
-    Vector3 mTranslate;
-    // ローカル行列
-    Matrix4 mLocalMat;
-    // モデル行列
-    Matrix4 mModelMat;
-    // 親子構造
-    // 自分のインデックス
-    int32_t mIndex;
-    // 親のインデックス
-    std::optional<int32_t> mParent;
-    // 子のインデックス
-    std::vector<int32_t> mChildren;
-};
+#include "MeshOptimizer.h"
+#include "NodeHierarchy.h"
+#include "graphics/animation/AnimationClip.h"
+#include "graphics/animation/CompressedAnimationClip.h"
+#include "graphics/animation/Skinning.h"
 
 /// <summary>
 /// モデルデータ
@@ -58,6 +33,10 @@ class ModelData
         int32_t mNodeIdx;
         // メッシュ
         std::unique_ptr<Mesh> mMesh;
+        // スキン情報(ボーンが無ければnullptr)
+        std::unique_ptr<SkinData> mSkin;
+        // 読み込み時の最適化の結果
+        MeshOptimizeStats mOptimizeStats;
     };
 
     // ビルド済みか
@@ -66,16 +45,14 @@ class ModelData
     const aiScene* mAssimpScene;
     // ヘルパー変数
     // ノードインデックス to assimpノード
-    std::unordered_map<int32_t, aiNode*> mNodeIdxToAssimpNode;
+    std::vector<aiNode*> mNodeIdxToAssimpNode;
     // ノード名 to ノードインデックス
     std::unordered_map<std::string, int32_t> mNodeNameToNodeIdx;
 
     // モデルパス
     std::string mPath;
-    // ノードリスト
-    std::vector<ModelNode> mNodes;
-    // ルートノードのインデックス
-    int32_t mRootNodeIdx;
+    // ノードの階層
+    NodeHierarchy mNodes;
     // メッシュ数
     uint32_t mMeshCount;
     // メッシュデータ
@@ -84,6 +61,10 @@ class ModelData
     uint32_t mMaterialCount;
     // マテリアルリスト
     std::vector<std::unique_ptr<Material>> mMaterials;
+    // アニメーションクリップ
+    std::vector<std::unique_ptr<AnimationClip>> mAnimations;
+    // 圧縮したアニメーションクリップ(mAnimationsと同じ順)
+    std::vector<std::unique_ptr<CompressedAnimationClip>> mCompressedAnimations;
 
    public:
     /// <summary>
@@ -103,26 +84,104 @@ class ModelData
     /// <returns>成否</returns>
     bool Build( const std::string& path );
 
+    /// <summary>
+    /// クックしたモデルを読み込む(assimpを使わず、ファイルの配列をそのまま渡す)
+    /// </summary>
+    /// <param name="cookedPath">クックしたファイルのパス</param>
+    /// <returns>成否</returns>
+    bool Load( const std::string& cookedPath );
+
+    /// <summary>
+    /// クックしたモデルを書き出す(構築・読み込み後)
+    /// </summary>
+    /// <param name="cookedPath">クックしたファイルのパス</param>
+    /// <returns>成否</returns>
+    bool Cook( const std::string& cookedPath ) const;
+
+    /// <summary>ノードの階層を取得</summary>
+    const NodeHierarchy& GetNodes() const { return mNodes; }
+
+    /// <summary>メッシュ数を取得</summary>
+    uint32_t GetMeshCount() const { return mMeshCount; }
+
+    /// <summary>メッシュを取得</summary>
+    const Mesh* GetMesh( uint32_t idx ) const { return mMeshes[idx].mMesh.get(); }
+
+    /// <summary>メッシュのノードのインデックスを取得</summary>
+    int32_t GetMeshNodeIdx( uint32_t idx ) const { return mMeshes[idx].mNodeIdx; }
+
+    /// <summary>メッシュのスキン情報を取得(ボーンが無ければnullptr)</summary>
+    const SkinData* GetSkin( uint32_t idx ) const { return mMeshes[idx].mSkin.get(); }
+
+    /// <summary>メッシュの読み込み時の最適化の結果を取得</summary>
+    const MeshOptimizeStats& GetOptimizeStats( uint32_t idx ) const { return mMeshes[idx].mOptimizeStats; }
+
+    /// <summary>アニメーションクリップ数を取得</summary>
+    uint32_t GetAnimationCount() const { return static_cast<uint32_t>( mAnimations.size() ); }
+
+    /// <summary>アニメーションクリップを取得</summary>
+    const AnimationClip* GetAnimation( uint32_t idx ) const { return idx < mAnimations.size() ? mAnimations[idx].get() : nullptr; }
+
+    /// <summary>圧縮したアニメーションクリップを取得</summary>
+    const CompressedAnimationClip* GetCompressedAnimation( uint32_t idx ) const { return idx < mCompressedAnimations.size() ? mCompressedAnimations[idx].get() : nullptr; }
+
+    /// <summary>
+    /// アニメーションクリップを名前で探す
+    /// </summary>
+    /// <param name="name">クリップ名</param>
+    /// <returns>クリップ(無ければnullptr)</returns>
+    const AnimationClip* FindAnimation( const std::string& name ) const;
+
+    /// <summary>
+    /// 圧縮したアニメーションクリップを名前で探す
+    /// </summary>
+    /// <param name="name">クリップ名</param>
+    /// <returns>クリップ(無ければnullptr)</returns>
+    const CompressedAnimationClip* FindCompressedAnimation( const std::string& name ) const;
+
    private:
     /// <summary>
-    /// ノードを構築(再帰)
+    /// ノードを構築(親が子より前に並ぶ深さ優先順)
+    /// </summary>
+    void BuildNode();
+
+    /// <summary>
+    /// メッシュを構築
     /// </summary>
-    /// <param name="assimpNode">assimpノード</param>
-    /// <param name="parent">親のインデックス</param>
-    /// <returns>自分のインデックス</returns>
-    int32_t BuildNode( aiNode* assimpNode, const std::optional<int32_t>& parent );
+    void BuildMesh();
 
     /// <summary>
-    /// メッシュを構築(再帰)
+    /// スキン情報を構築
     /// </summary>
-    /// <param name="node">ノード</param>
-    void BuildMesh( ModelNode* node );
+    /// <param name="assimpMesh">assimpメッシュ</param>
+    /// <returns>スキン情報</returns>
+    std::unique_ptr<SkinData> BuildSkin( const aiMesh* assimpMesh );
 
     /// <summary>
     /// マテリアルを構築
     /// </summary>
     void BuildMaterial();
 
+    /// <summary>
+    /// アニメーションを構築(読み込み時に圧縮も行う)
+    /// </summary>
+    void BuildAnimation();
+
+    /// <summary>
+    /// クックしたスキン情報を読み込む
+    /// </summary>
+    /// <param name="cooked">クックしたモデル</param>
+    /// <param name="skinIdx">スキンのインデックス</param>
+    /// <returns>スキン情報(不正ならnullptr)</returns>
+    std::unique_ptr<SkinData> LoadSkin( const CookedModel& cooked, uint32_t skinIdx ) const;
+
+    /// <summary>
+    /// クックしたアニメーションを読み込む
+    /// </summary>
+    /// <param name="cooked">クックしたモデル</param>
+    /// <returns>成否</returns>
+    bool LoadAnimation( const CookedModel& cooked );
+
     /// <summary>
     /// 更新
     /// </summary>
@@ -132,8 +191,6 @@ class ModelData
     /// <summary>
     /// ノードの階層をデバッグ表示
     /// </summary>
-    /// <param name="node">ノード</param>
-    /// <param name="depth">インデント用深度</param>
-    void OutputNodeInfo( ModelNode* node, uint32_t depth = 0 );
+    void OutputNodeInfo();
 #endif
 };
@@ -1,5 +1,10 @@
 #include "ModelInstance.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
 #include "MeshSorter.h"
 #include "collision/Collision.h"
 #include "core/CommandList.h"
@@ -7,37 +12,106 @@
 #include "graphics/PrimitiveRenderer.h"
 #include "graphics/Renderer.h"
 #include "graphics/Texture.h"
+#include "graphics/animation/Skinning.h"
+
+namespace
+{
+
+// 詳細度を切り替える大きさの幅(境目で行き来しないように粗くするときは小さく、細かくするときは大きく判定する)
+const float kLodHysteresis = 0.1f;
+
+}  // namespace
 
 // コンストラクタ
 ModelInstance::ModelInstance()
     : mModelData( nullptr )
-    , mNodes()
-    , mTransMatCBs()
+    , mPose()
+    , mTransMatSlice()
     , mMaterials()
+    , mWorldMat()
+    , mWorldVersion( 0 )
+    , mIsWorldDirty( true )
+    , mCachedPoseVersion( 0 )
+    , mCachedCamera( nullptr )
+    , mCachedCameraVersion( 0 )
+    , mIsWVPDirty( true )
+    , mMeshCaches()
+    , mMeshGroups()
+    , mMeshVisibility()
+    , mWorldAABB()
+    , mStats()
+    , mSampler()
+    , mIsAnimationPlaying( false )
+    , mAnimationTime( 0.0f )
+    , mAnimationSpeed( 1.0f )
+    , mIsAnimationLoop( true )
+    , mSkinnedMeshes()
+    , mSkinMats()
+{
+}
+
+// デストラクタ
+ModelInstance::~ModelInstance()
 {
+    ConstantBufferPool::GetInstance().Free( mTransMatSlice );
 }
 
 // 作成
 bool ModelInstance::Create( ModelData* modelData )
 {
     // クリア
-    mNodes.clear();
-    mTransMatCBs.clear();
+    mPose = {};
+    ConstantBufferPool::GetInstance().Free( mTransMatSlice );
     mMaterials.clear();
+    mMeshCaches.clear();
+    mMeshGroups.clear();
+    mMeshVisibility.clear();
+    mSkinnedMeshes.clear();
+    mSampler = {};
+    mIsAnimationPlaying = false;
+    mAnimationTime = 0.0f;
+    mIsWorldDirty = true;
+    mIsWVPDirty = true;
+    mCachedCamera = nullptr;
 
     mModelData = modelData;
     if( mModelData )
     {
-        // ノードリスト
-        mNodes = mModelData->mNodes;
+        // ノードの姿勢(階層は共有し、変化する配列だけを持つ)
+        mModelData->mNodes.CreatePose( mPose );
+        mCachedPoseVersion = mPose.mVersion;
 
-        // 変換行列
-        mTransMatCBs.resize( mModelData->mMeshCount );
+        // 変換行列(リソースは作らず、プールからメッシュ数分のスロットを借りる)
+        static_assert( sizeof( TransformationMatrix ) <= ConstantBufferPool::kSlotSize );
+        if( mModelData->mMeshCount > 0 && !ConstantBufferPool::GetInstance().Allocate( mModelData->mMeshCount, mTransMatSlice ) ) return false;
+        mMeshCaches.resize( mModelData->mMeshCount );
+        mMeshVisibility.resize( mModelData->mMeshCount );
+
+        // 同じノードに続けて付いたメッシュをまとめる
+        for( uint32_t i = 0; i < mModelData->mMeshCount; ++i )
+        {
+            auto nodeIdx = mModelData->mMeshes[i].mNodeIdx;
+            if( mMeshGroups.empty() || mModelData->mMeshes[mMeshGroups.back().mFirstMesh].mNodeIdx != nodeIdx )
+            {
+                mMeshGroups.emplace_back( MeshGroup{ i, 0, {} } );
+            }
+            ++mMeshGroups.back().mMeshCount;
+        }
+
+        // スキンを持つメッシュはインスタンスごとに頂点バッファを持つ
+        mSkinnedMeshes.resize( mModelData->mMeshCount );
         for( uint32_t i = 0; i < mModelData->mMeshCount; ++i )
         {
-            mTransMatCBs[i] = std::make_unique<ConstantBuffer>();
-            if( !mTransMatCBs[i]->Create( sizeof( TransformationMatrix ) ) ) return false;
+            auto& meshData = mModelData->mMeshes[i];
+            if( !meshData.mSkin ) continue;
+
+            auto& skinned = mSkinnedMeshes[i];
+            skinned.mVertices = meshData.mMesh->mVertices;
+            skinned.mVB = std::make_unique<VertexBuffer>();
+            auto size = static_cast<uint32_t>( skinned.mVertices.size() * sizeof( Mesh::Vertex ) );
+            if( !skinned.mVB->Create( size, sizeof( Mesh::Vertex ) ) ) return false;
         }
+        UpdateSkinning();
 
         // マテリアルリスト
         mMaterials.resize( mModelData->mMaterialCount );
@@ -51,21 +125,41 @@ bool ModelInstance::Create( ModelData* modelData )
 }
 
 // 更新
-void ModelInstance::Update( float )
+void ModelInstance::Update( float deltaTime )
 {
     if( !mModelData ) return;
 
     // 共通マテリアルの更新
     mModelData->Update();
 
-    // TODO: アニメーション
+    // アニメーション
+    if( mIsAnimationPlaying )
+    {
+        mAnimationTime += deltaTime * mAnimationSpeed;
+        auto duration = mSampler.GetDuration();
+        if( mIsAnimationLoop && duration > 0.0f )
+        {
+            mAnimationTime = std::fmod( mAnimationTime, duration );
+            if( mAnimationTime < 0.0f )
+            {
+                mAnimationTime += duration;
+            }
+        }
+        else
+        {
+            mAnimationTime = std::clamp( mAnimationTime, 0.0f, duration );
+        }
+        mSampler.Sample( mAnimationTime, mPose );
+    }
 }
 
 // 描画
-void ModelInstance::Draw( MeshSorter* sorter, const Matrix4& worldMat )
+void ModelInstance::Draw( MeshSorter* sorter )
 {
     if( !sorter || !mModelData ) return;
 
+    mStats = {};
+
     // マテリアルを更新
     for( auto material : mMaterials )
     {
@@ -77,8 +171,24 @@ void ModelInstance::Draw( MeshSorter* sorter, const Matrix4& worldMat )
     auto camera = sorter->GetCamera();
     if( !camera ) return;
 
-    // AABB構築
-    UpdateAABB( worldMat );
+    // 変更されたノードだけ再計算
+    UpdateModelMatrices();
+    if( mPose.mVersion != mCachedPoseVersion )
+    {
+        // 姿勢が変わったときだけスキニング
+        UpdateSkinning();
+        mIsWorldDirty = true;
+    }
+
+    // ワールド行列・AABBは動いたときだけ
+    if( mIsWorldDirty )
+    {
+        UpdateWorld();
+    }
+    else
+    {
+        mStats.mSkippedMeshes = mModelData->mMeshCount;
+    }
 
     // デバッグ描画
     auto& pr = PrimitiveRenderer::GetInstance();
@@ -86,37 +196,77 @@ void ModelInstance::Draw( MeshSorter* sorter, const Matrix4& worldMat )
 
     auto& frustum = sorter->GetFrustumCamera()->GetFrustum();
     // フラスタムの外側はスキップ
-    if( !Intersect( mWorldAABB, frustum ) ) return;
+    if( !Intersect( mWorldAABB, frustum ) )
+    {
+        mStats.mCulledMeshes = mModelData->mMeshCount;
+        mStats.mCulledNodes = static_cast<uint32_t>( mMeshGroups.size() );
+        return;
+    }
+
+    // ノード・メッシュごと(登録の前にまとめて判定する)
+    CullMeshes( frustum );
+
+    // WVP行列は動いたときかカメラが変わったときだけ
+    if( mIsWVPDirty || camera != mCachedCamera || camera->GetVersion() != mCachedCameraVersion )
+    {
+        UpdateWVP( camera );
+    }
+    else
+    {
+        mStats.mSkippedWVPs = mModelData->mMeshCount;
+    }
 
     // メッシュごと描画
     for( uint32_t i = 0; i < mModelData->mMeshCount; ++i )
     {
-        auto& meshData = mModelData->mMeshes[i];
-        auto mesh = meshData.mMesh.get();
+        if( !mMeshVisibility[i] ) continue;
+
+        auto mesh = mModelData->mMeshes[i].mMesh.get();
         auto material = mMaterials[mesh->mMaterialIdx];
         if( !material )
         {
             material = mModelData->mMaterials[mesh->mMaterialIdx].get();
         }
 
-        TransformationMatrix c = {};
-        c.mWorld = mNodes[meshData.mNodeIdx].mModelMat * worldMat;
-        auto wvMat = c.mWorld * camera->GetView();
-        c.mWVP = wvMat * camera->GetProjection();
-        c.mWorldInvTranspose = Transpose( InverseAffine( c.mWorld ) );
-        mTransMatCBs[i]->Update( &c );
+        // 詳細度
+        auto lod = SelectLod( i, camera );
+        if( mesh->GetLodCount() > 0 )
+        {
+            mStats.mDrawnTriangles += mesh->GetLod( lod ).mIndexCount / 3;
+            mStats.mFullDetailTriangles += mesh->GetLod( 0 ).mIndexCount / 3;
+        }
 
         // ソーターへ登録
         sorter->Add(
             MakePSOKey( mesh->mFlags, material->mFlags ),
-            wvMat.m[3][2],  // Z値(カメラからの距離)
-            mTransMatCBs[i].get(),
+            mMeshCaches[i].mDepth,
+            mTransMatSlice.mGPUAddress + i * ConstantBufferPool::kSlotSize,
             mesh,
             material,
-            mWorldAABB );
+            mMeshCaches[i].mWorldAABB,
+            mSkinnedMeshes[i].mVB.get(),
+            lod,
+            &mMeshCaches[i].mTransMat );
     }
 }
 
+// ワールド行列を設定して描画
+void ModelInstance::Draw( MeshSorter* sorter, const Matrix4& worldMat )
+{
+    SetWorldMatrix( worldMat );
+    Draw( sorter );
+}
+
+// ワールド行列を設定
+void ModelInstance::SetWorldMatrix( const Matrix4& worldMat )
+{
+    if( memcmp( &mWorldMat, &worldMat, sizeof( Matrix4 ) ) == 0 ) return;
+
+    mWorldMat = worldMat;
+    ++mWorldVersion;
+    mIsWorldDirty = true;
+}
+
 // マテリアルを取得
 Material* ModelInstance::GetMaterial( uint32_t idx )
 {
@@ -141,13 +291,106 @@ void ModelInstance::SetMaterial( uint32_t idx, Material* material )
     mMaterials[idx] = material;
 }
 
-// AABBの更新
-void ModelInstance::UpdateAABB( const Matrix4& worldMat )
+// アニメーションを再生
+bool ModelInstance::PlayAnimation( const std::string& name, bool isLoop )
+{
+    if( !mModelData ) return false;
+
+    return PlayAnimation( mModelData->FindCompressedAnimation( name ), isLoop );
+}
+
+// アニメーションを再生
+bool ModelInstance::PlayAnimation( const AnimationClip* clip, bool isLoop )
+{
+    if( !clip ) return false;
+
+    mSampler.SetClip( clip );
+    mIsAnimationPlaying = true;
+    mAnimationTime = 0.0f;
+    mIsAnimationLoop = isLoop;
+    return true;
+}
+
+// 圧縮したアニメーションを再生
+bool ModelInstance::PlayAnimation( const CompressedAnimationClip* clip, bool isLoop )
+{
+    if( !clip ) return false;
+
+    mSampler.SetClip( clip );
+    mIsAnimationPlaying = true;
+    mAnimationTime = 0.0f;
+    mIsAnimationLoop = isLoop;
+    return true;
+}
+
+// インスタンスが使用するメモリを取得
+size_t ModelInstance::GetMemorySize() const
+{
+    size_t size = sizeof( *this );
+    size += mPose.mScales.capacity() * sizeof( Vector3 );
+    size += mPose.mRotates.capacity() * sizeof( Quaternion );
+    size += mPose.mTranslates.capacity() * sizeof( Vector3 );
+    size += mPose.mModelMats.capacity() * sizeof( Matrix4 );
+    size += mPose.mIsDirty.capacity() * sizeof( uint8_t );
+    size += mMaterials.capacity() * sizeof( Material* );
+    size += mMeshCaches.capacity() * sizeof( MeshCache );
+    size += mMeshGroups.capacity() * sizeof( MeshGroup );
+    size += mMeshVisibility.capacity() * sizeof( uint8_t );
+    size += mSkinnedMeshes.capacity() * sizeof( SkinnedMesh );
+    for( const auto& skinned : mSkinnedMeshes )
+    {
+        // CPU側の頂点と頂点バッファ
+        size += skinned.mVertices.capacity() * sizeof( Mesh::Vertex ) * ( skinned.mVB ? 2 : 1 );
+    }
+    size += mSkinMats.capacity() * sizeof( Matrix4 );
+    size += static_cast<size_t>( mTransMatSlice.mCount ) * ConstantBufferPool::kSlotSize;
+    return size;
+}
+
+// スキンを持つメッシュの頂点をスキニング
+void ModelInstance::UpdateSkinning()
+{
+    if( !mModelData ) return;
+
+    for( uint32_t i = 0; i < mModelData->mMeshCount; ++i )
+    {
+        auto& meshData = mModelData->mMeshes[i];
+        auto& skinned = mSkinnedMeshes[i];
+        if( !meshData.mSkin || !skinned.mVB ) continue;
+
+        auto& vertices = meshData.mMesh->mVertices;
+        auto count = static_cast<uint32_t>( vertices.size() );
+        Skinning::ComputeSkinMatrices( *meshData.mSkin, mPose.mModelMats, mSkinMats );
+        Skinning::SkinVertices( vertices.data(), meshData.mSkin->mInfluences.data(), count, mSkinMats.data(), skinned.mVertices.data(), skinned.mAABB );
+        skinned.mVB->Update( skinned.mVertices.data() );
+        mStats.mSkinnedVertices += count;
+    }
+}
+
+// 変更されたノードのモデル行列を再計算
+void ModelInstance::UpdateModelMatrices()
+{
+    if( !mModelData ) return;
+
+    auto updated = mModelData->mNodes.UpdateModelMatrices( mPose );
+    mStats.mUpdatedNodes += updated;
+    mStats.mSkippedNodes += mModelData->mNodes.GetCount() - updated;
+}
+
+// メッシュのワールド行列・法線行列・AABBを更新
+void ModelInstance::UpdateWorld()
 {
     mWorldAABB.Reset();
     for( uint32_t i = 0; i < mModelData->mMeshCount; ++i )
     {
-        auto local = mModelData->mMeshes[i].mMesh->mAABB;
+        auto& meshData = mModelData->mMeshes[i];
+        auto& cache = mMeshCaches[i];
+        // スキニング済みの頂点はモデル空間なのでノードの行列は掛けない
+        auto isSkinned = mSkinnedMeshes[i].mVB != nullptr;
+        cache.mWorld = isSkinned ? mWorldMat : mPose.mModelMats[meshData.mNodeIdx] * mWorldMat;
+        cache.mWorldInvTranspose = Transpose( InverseAffine( cache.mWorld ) );
+
+        auto local = isSkinned ? mSkinnedMeshes[i].mAABB : meshData.mMesh->mAABB;
         auto min = local.mMin;
         auto max = local.mMax;
 
@@ -161,11 +404,120 @@ void ModelInstance::UpdateAABB( const Matrix4& worldMat )
         v[6] = max;
         v[7] = Vector3( min.x, max.y, max.z );
 
-        auto mat = mNodes[mModelData->mMeshes[i].mNodeIdx].mModelMat * worldMat;
+        cache.mWorldAABB.Reset();
         for( uint32_t j = 0; j < 8; ++j )
         {
-            auto p = v[j] * mat;
-            mWorldAABB.Update( p );
+            cache.mWorldAABB.Update( v[j] * cache.mWorld );
+        }
+        mWorldAABB.Update( cache.mWorldAABB.mMin );
+        mWorldAABB.Update( cache.mWorldAABB.mMax );
+    }
+
+    // ノードのAABBはメッシュのAABBの和
+    for( auto& group : mMeshGroups )
+    {
+        group.mWorldAABB.Reset();
+        for( uint32_t i = group.mFirstMesh; i < group.mFirstMesh + group.mMeshCount; ++i )
+        {
+            group.mWorldAABB.Update( mMeshCaches[i].mWorldAABB.mMin );
+            group.mWorldAABB.Update( mMeshCaches[i].mWorldAABB.mMax );
+        }
+    }
+
+    mStats.mUpdatedMeshes = mModelData->mMeshCount;
+    mCachedPoseVersion = mPose.mVersion;
+    mIsWorldDirty = false;
+    mIsWVPDirty = true;
+}
+
+// ノード・メッシュの順に視錐台でカリング
+void ModelInstance::CullMeshes( const Frustum& frustum )
+{
+    for( const auto& group : mMeshGroups )
+    {
+        auto* visibility = mMeshVisibility.data() + group.mFirstMesh;
+        // メッシュが1つならノードの判定は省く
+        if( group.mMeshCount > 1 && !Intersect( group.mWorldAABB, frustum ) )
+        {
+            std::fill_n( visibility, group.mMeshCount, static_cast<uint8_t>( 0 ) );
+            mStats.mCulledMeshes += group.mMeshCount;
+            ++mStats.mCulledNodes;
+            continue;
+        }
+
+        for( uint32_t i = 0; i < group.mMeshCount; ++i )
+        {
+            visibility[i] = static_cast<uint8_t>( Intersect( mMeshCaches[group.mFirstMesh + i].mWorldAABB, frustum ) );
+            mStats.mCulledMeshes += visibility[i] ? 0 : 1;
+        }
+    }
+}
+
+// メッシュのWVP行列を更新して定数バッファへ書き込む
+void ModelInstance::UpdateWVP( const Camera* camera )
+{
+    for( uint32_t i = 0; i < mModelData->mMeshCount; ++i )
+    {
+        auto& cache = mMeshCaches[i];
+        auto mesh = mModelData->mMeshes[i].mMesh.get();
+        auto& c = cache.mTransMat;
+        auto wvMat = cache.mWorld * camera->GetView();
+        if( ( mesh->mFlags & MeshFlags::QuantizedPosition ) == MeshFlags::QuantizedPosition )
+        {
+            // 量子化した位置を戻す行列を前に掛ける(法線には影響しない)
+            const auto& dequantizeMat = mesh->GetDequantizeMatrix();
+            c.mWorld = dequantizeMat * cache.mWorld;
+            c.mWVP = dequantizeMat * wvMat * camera->GetProjection();
         }
+        else
+        {
+            c.mWorld = cache.mWorld;
+            c.mWVP = wvMat * camera->GetProjection();
+        }
+        c.mWorldInvTranspose = cache.mWorldInvTranspose;
+        memcpy( mTransMatSlice.mData + i * ConstantBufferPool::kSlotSize, &c, sizeof( c ) );
+        cache.mDepth = wvMat.m[3][2];
+    }
+
+    mStats.mUpdatedWVPs = mModelData->mMeshCount;
+    mCachedCamera = camera;
+    mCachedCameraVersion = camera->GetVersion();
+    mIsWVPDirty = false;
+}
+
+// 画面に占めるバウンディングスフィアの大きさからメッシュの詳細度を選ぶ
+uint32_t ModelInstance::SelectLod( uint32_t meshIdx, const Camera* camera )
+{
+    auto mesh = mModelData->mMeshes[meshIdx].mMesh.get();
+    auto& cache = mMeshCaches[meshIdx];
+    auto lodCount = mesh->GetLodCount();
+    if( lodCount <= 1 )
+    {
+        cache.mLod = 0;
+        return 0;
+    }
+
+    // 画面の高さに対するバウンディングスフィアの直径の比
+    const auto& aabb = cache.mWorldAABB;
+    auto center = ( aabb.mMin + aabb.mMax ) * 0.5f;
+    auto radius = Length( aabb.mMax - aabb.mMin ) * 0.5f;
+    auto screenSize = radius * camera->GetProjection().m[1][1];
+    if( camera->mProjectionMode == Camera::ProjectionMode::Perspective )
+    {
+        auto distance = Length( center - camera->mPosition );
+        screenSize = distance > radius ? screenSize / distance : FLT_MAX;
+    }
+
+    // 前回の詳細度から、境目を幅の分だけ越えたときに切り替える
+    auto lod = ( std::min )( cache.mLod, lodCount - 1 );
+    while( lod + 1 < lodCount && screenSize < mesh->GetLod( lod + 1 ).mScreenSize * ( 1.0f - kLodHysteresis ) )
+    {
+        ++lod;
+    }
+    while( lod > 0 && screenSize > mesh->GetLod( lod ).mScreenSize * ( 1.0f + kLodHysteresis ) )
+    {
+        --lod;
     }
+    cache.mLod = lod;
+    return lod;
 }
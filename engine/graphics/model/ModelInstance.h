@@ -1,5 +1,8 @@
 #pragma once
 #include "ModelData.h"
+#include "TransformationMatrix.h"
+#include "core/ConstantBufferPool.h"
+#include "graphics/animation/AnimationSampler.h"
 
 class Camera;
 class MeshSorter;
@@ -9,27 +12,122 @@ class MeshSorter;
 /// </summary>
 class ModelInstance
 {
+   public:
+    /// <summary>
+    /// 直前の描画で計算した・省略した数
+    /// </summary>
+    struct UpdateStats
+    {
+        // ノードのモデル行列
+        uint32_t mUpdatedNodes;
+        uint32_t mSkippedNodes;
+        // メッシュのワールド行列・法線行列・AABB
+        uint32_t mUpdatedMeshes;
+        uint32_t mSkippedMeshes;
+        // メッシュのWVP行列(定数バッファの書き込み)
+        uint32_t mUpdatedWVPs;
+        uint32_t mSkippedWVPs;
+        // CPUスキニングした頂点
+        uint32_t mSkinnedVertices;
+        // 描画した三角形(選んだ詳細度)とすべてLOD0で描いた場合の三角形
+        uint32_t mDrawnTriangles;
+        uint32_t mFullDetailTriangles;
+        // 視錐台の外でソーターに登録しなかったメッシュと、まとめて判定で外れたノード
+        uint32_t mCulledMeshes;
+        uint32_t mCulledNodes;
+    };
+
    private:
     /// <summary>
-    /// 変換行列
+    /// メッシュごとのキャッシュ
     /// </summary>
-    struct TransformationMatrix
+    struct MeshCache
     {
+        // ワールド行列
         Matrix4 mWorld;
-        Matrix4 mWVP;
+        // 法線用の行列
         Matrix4 mWorldInvTranspose;
+        // 定数バッファへ書き込んだ変換行列の写し(インスタンシングでソーターが読む)
+        TransformationMatrix mTransMat;
+        // ワールド空間のAABB
+        AABB3D mWorldAABB;
+        // Z値(カメラからの距離)
+        float mDepth;
+        // 選んでいる詳細度(ヒステリシスのため前回の値から切り替える)
+        uint32_t mLod;
+    };
+
+    /// <summary>
+    /// 同じノードに付いたメッシュのまとまり(メッシュ順に連続、カリング用)
+    /// </summary>
+    struct MeshGroup
+    {
+        uint32_t mFirstMesh;
+        uint32_t mMeshCount;
+        // ワールド空間のAABB(メッシュのAABBの和)
+        AABB3D mWorldAABB;
+    };
+
+    /// <summary>
+    /// スキニング済みのメッシュ(インスタンスごと)
+    /// </summary>
+    struct SkinnedMesh
+    {
+        // スキニング後の頂点(モデル空間)
+        std::vector<Mesh::Vertex> mVertices;
+        // 頂点バッファ(スキンが無いメッシュはnullptr)
+        std::unique_ptr<VertexBuffer> mVB;
+        // モデル空間のAABB
+        AABB3D mAABB;
     };
 
     // モデルデータ
     ModelData* mModelData;
-    // ノードリスト
-    std::vector<ModelNode> mNodes;
-    // 変換行列
-    std::vector<std::unique_ptr<ConstantBuffer>> mTransMatCBs;
+    // ノードの姿勢(階層はモデルデータと共有)
+    NodePose mPose;
+    // 変換行列(プールのスロットをメッシュ順に1つずつ)
+    ConstantBufferPool::Slice mTransMatSlice;
     // マテリアルリスト
     std::vector<Material*> mMaterials;
 
+    // ワールド行列
+    Matrix4 mWorldMat;
+    // ワールド行列が変わるたびに増える
+    uint32_t mWorldVersion;
+    // ワールド行列か姿勢が変わり、キャッシュの再計算が必要か
+    bool mIsWorldDirty;
+    // キャッシュ計算時の姿勢のバージョン
+    uint32_t mCachedPoseVersion;
+    // WVP行列の計算に使ったカメラとそのバージョン
+    const Camera* mCachedCamera;
+    uint32_t mCachedCameraVersion;
+    // WVP行列の再計算が必要か
+    bool mIsWVPDirty;
+    // メッシュごとのキャッシュ
+    std::vector<MeshCache> mMeshCaches;
+    // ノードごとのメッシュのまとまり
+    std::vector<MeshGroup> mMeshGroups;
+    // メッシュが視錐台と交差するか(カリングの作業用、メッシュ順)
+    std::vector<uint8_t> mMeshVisibility;
+    // ワールド空間のAABB(全メッシュ)
     AABB3D mWorldAABB;
+    // 直前の描画の統計
+    UpdateStats mStats;
+
+    // アニメーションのサンプラー
+    AnimationSampler mSampler;
+    // アニメーションを再生中か
+    bool mIsAnimationPlaying;
+    // 再生位置(秒)
+    float mAnimationTime;
+    // 再生速度
+    float mAnimationSpeed;
+    // ループするか
+    bool mIsAnimationLoop;
+    // スキニング済みのメッシュ(メッシュ順)
+    std::vector<SkinnedMesh> mSkinnedMeshes;
+    // スキニング行列(作業用)
+    std::vector<Matrix4> mSkinMats;
 
    public:
     /// <summary>
@@ -40,7 +138,27 @@ class ModelInstance
     /// <summary>
     /// デストラクタ
     /// </summary>
-    ~ModelInstance() = default;
+    ~ModelInstance();
+
+    /// <summary>
+    /// コピーコンストラクタ禁止(変換行列のスロットを二重に解放しないように)
+    /// </summary>
+    ModelInstance( const ModelInstance& ) = delete;
+
+    /// <summary>
+    /// 代入演算子禁止
+    /// </summary>
+    ModelInstance& operator=( const ModelInstance& ) = delete;
+
+    /// <summary>
+    /// ムーブコンストラクタ禁止
+    /// </summary>
+    ModelInstance( ModelInstance&& ) = delete;
+
+    /// <summary>
+    /// ムーブ代入演算子禁止
+    /// </summary>
+    ModelInstance& operator=( ModelInstance&& ) = delete;
 
     /// <summary>
     /// 作成
@@ -59,9 +177,21 @@ class ModelInstance
     /// 描画
     /// </summary>
     /// <param name="sorter">ソーター</param>
+    void Draw( MeshSorter* sorter );
+
+    /// <summary>
+    /// ワールド行列を設定して描画
+    /// </summary>
+    /// <param name="sorter">ソーター</param>
     /// <param name="worldMat">ワールド行列</param>
     void Draw( MeshSorter* sorter, const Matrix4& worldMat );
 
+    /// <summary>
+    /// ワールド行列を設定(変わったときのみキャッシュを無効にする)
+    /// </summary>
+    /// <param name="worldMat">ワールド行列</param>
+    void SetWorldMatrix( const Matrix4& worldMat );
+
     /// <summary>
     /// マテリアルを取得
     /// </summary>
@@ -76,9 +206,108 @@ class ModelInstance
     /// <param name="material">マテリアル</param>
     void SetMaterial( uint32_t idx, Material* material );
 
+    /// <summary>
+    /// アニメーションを再生
+    /// </summary>
+    /// <param name="name">クリップ名(圧縮したクリップを再生する)</param>
+    /// <param name="isLoop">ループするか</param>
+    /// <returns>成否</returns>
+    bool PlayAnimation( const std::string& name, bool isLoop = true );
+
+    /// <summary>
+    /// アニメーションを再生
+    /// </summary>
+    /// <param name="clip">クリップ</param>
+    /// <param name="isLoop">ループするか</param>
+    /// <returns>成否</returns>
+    bool PlayAnimation( const AnimationClip* clip, bool isLoop = true );
+
+    /// <summary>
+    /// 圧縮したアニメーションを再生
+    /// </summary>
+    /// <param name="clip">クリップ</param>
+    /// <param name="isLoop">ループするか</param>
+    /// <returns>成否</returns>
+    bool PlayAnimation( const CompressedAnimationClip* clip, bool isLoop = true );
+
+    /// <summary>
+    /// アニメーションを停止(姿勢はそのまま)
+    /// </summary>
+    void StopAnimation() { mIsAnimationPlaying = false; }
+
+    /// <summary>アニメーションの再生速度を設定</summary>
+    void SetAnimationSpeed( float speed ) { mAnimationSpeed = speed; }
+
+    /// <summary>アニメーションを再生中か</summary>
+    bool IsAnimationPlaying() const { return mIsAnimationPlaying; }
+
+    /// <summary>再生位置(秒)を取得</summary>
+    float GetAnimationTime() const { return mAnimationTime; }
+
+    /// <summary>
+    /// スキンを持つメッシュの頂点をスキニング(姿勢が変わったときに描画時に呼ばれる)
+    /// </summary>
+    void UpdateSkinning();
+
+    /// <summary>スキニング済みの頂点を取得(スキンが無いメッシュは空)</summary>
+    const std::vector<Mesh::Vertex>& GetSkinnedVertices( uint32_t idx ) const { return mSkinnedMeshes[idx].mVertices; }
+
+    /// <summary>ノードの姿勢を取得(変更したノードはNodePose::MarkDirtyで通知する)</summary>
+    NodePose& GetPose() { return mPose; }
+
+    /// <summary>
+    /// 変更されたノードのモデル行列を再計算(描画時にも呼ばれる)
+    /// </summary>
+    void UpdateModelMatrices();
+
+    /// <summary>モデルデータを取得</summary>
+    ModelData* GetModelData() const { return mModelData; }
+
+    /// <summary>ワールド行列を取得</summary>
+    const Matrix4& GetWorldMatrix() const { return mWorldMat; }
+
+    /// <summary>ワールド行列のバージョンを取得</summary>
+    uint32_t GetWorldVersion() const { return mWorldVersion; }
+
+    /// <summary>ワールド空間のAABBを取得</summary>
+    const AABB3D& GetWorldAABB() const { return mWorldAABB; }
+
+    /// <summary>直前の描画の統計を取得</summary>
+    const UpdateStats& GetUpdateStats() const { return mStats; }
+
     /// <summary>マテリアル数を取得</summary>
     uint32_t GetMaterialCount() const { return static_cast<uint32_t>( mMaterials.size() ); }
 
+    /// <summary>
+    /// インスタンスが使用するメモリ(バイト)を取得
+    /// 共有するモデルデータは含まず、定数バッファのスロットとスキニング用の頂点バッファを含む
+    /// </summary>
+    /// <returns>サイズ</returns>
+    size_t GetMemorySize() const;
+
    private:
-    void UpdateAABB( const Matrix4& worldMat );
+    /// <summary>
+    /// メッシュのワールド行列・法線行列・AABBを更新
+    /// </summary>
+    void UpdateWorld();
+
+    /// <summary>
+    /// ノード・メッシュの順に視錐台でカリングしてmMeshVisibilityに書き込む
+    /// </summary>
+    /// <param name="frustum">視錐台</param>
+    void CullMeshes( const Frustum& frustum );
+
+    /// <summary>
+    /// メッシュのWVP行列を更新して定数バッファへ書き込む
+    /// </summary>
+    /// <param name="camera">カメラ</param>
+    void UpdateWVP( const Camera* camera );
+
+    /// <summary>
+    /// 画面に占めるバウンディングスフィアの大きさからメッシュの詳細度を選ぶ
+    /// </summary>
+    /// <param name="meshIdx">メッシュのインデックス</param>
+    /// <param name="camera">カメラ</param>
+    /// <returns>詳細度</returns>
+    uint32_t SelectLod( uint32_t meshIdx, const Camera* camera );
 };
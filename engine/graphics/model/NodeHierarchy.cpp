@@ -0,0 +1,82 @@
+#include "NodeHierarchy.h"
+
+#include <algorithm>
+
+// コンストラクタ
+NodeHierarchy::NodeHierarchy()
+    : mNames()
+    , mParents()
+    , mBindPose()
+{
+}
+
+// ノードをすべて削除
+void NodeHierarchy::Clear()
+{
+    mNames.clear();
+    mParents.clear();
+    mBindPose = {};
+}
+
+// ノードを追加
+int32_t NodeHierarchy::AddNode( const std::string& name, int32_t parent, const Vector3& scale, const Quaternion& rotate, const Vector3& translate )
+{
+    auto idx = static_cast<int32_t>( mParents.size() );
+    // 親は先に追加されている必要がある
+    if( parent < kInvalidIndex || parent >= idx ) return kInvalidIndex;
+
+    mNames.emplace_back( name );
+    mParents.emplace_back( parent );
+    mBindPose.mScales.emplace_back( scale );
+    mBindPose.mRotates.emplace_back( rotate );
+    mBindPose.mTranslates.emplace_back( translate );
+    auto localMat = CreateAffine( scale, rotate, translate );
+    mBindPose.mModelMats.emplace_back( parent == kInvalidIndex ? localMat : localMat * mBindPose.mModelMats[parent] );
+    mBindPose.mIsDirty.emplace_back( static_cast<uint8_t>( 0 ) );
+    return idx;
+}
+
+// ノードを名前で探す
+int32_t NodeHierarchy::FindNode( const std::string& name ) const
+{
+    for( size_t i = 0; i < mNames.size(); ++i )
+    {
+        if( mNames[i] == name ) return static_cast<int32_t>( i );
+    }
+    return kInvalidIndex;
+}
+
+// 初期姿勢で姿勢を作成
+void NodeHierarchy::CreatePose( NodePose& pose ) const
+{
+    pose = mBindPose;
+}
+
+// 変更されたノードとその子孫のモデル行列を計算
+uint32_t NodeHierarchy::UpdateModelMatrices( NodePose& pose ) const
+{
+    // 親は必ず先に処理済みなので、親の変更フラグを子へ伝えながら先頭から1回なめるだけでよい
+    uint32_t updated = 0;
+    auto count = mParents.size();
+    for( size_t i = 0; i < count; ++i )
+    {
+        auto parent = mParents[i];
+        if( !pose.mIsDirty[i] )
+        {
+            if( parent == kInvalidIndex || !pose.mIsDirty[parent] ) continue;
+
+            pose.mIsDirty[i] = 1;
+        }
+
+        auto localMat = CreateAffine( pose.mScales[i], pose.mRotates[i], pose.mTranslates[i] );
+        pose.mModelMats[i] = parent == kInvalidIndex ? localMat : localMat * pose.mModelMats[parent];
+        ++updated;
+    }
+
+    if( updated > 0 )
+    {
+        std::fill( pose.mIsDirty.begin(), pose.mIsDirty.end(), static_cast<uint8_t>( 0 ) );
+        ++pose.mVersion;
+    }
+    return updated;
+}
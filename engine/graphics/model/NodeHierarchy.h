@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "math/Matrix4.h"
+#include "math/Quaternion.h"
+#include "math/Vector3.h"
+
+/// <summary>
+/// ノードの姿勢(インスタンスごとに変化するトランスフォーム)
+/// 配列はすべてノードのインデックス順
+/// </summary>
+struct NodePose
+{
+    // スケール
+    std::vector<Vector3> mScales;
+    // 回転
+    std::vector<Quaternion> mRotates;
+    // 座標
+    std::vector<Vector3> mTranslates;
+    // モデル行列
+    std::vector<Matrix4> mModelMats;
+    // ローカルのトランスフォームを変更したか
+    std::vector<uint8_t> mIsDirty;
+    // モデル行列を更新するたびに増える
+    uint32_t mVersion = 0;
+
+    /// <summary>ノードの変更を通知(子も更新される)</summary>
+    void MarkDirty( int32_t idx ) { mIsDirty[idx] = 1; }
+
+    /// <summary>すべてのノードの変更を通知</summary>
+    void MarkAllDirty() { mIsDirty.assign( mIsDirty.size(), 1 ); }
+};
+
+/// <summary>
+/// ノードの階層(モデル間で共有する不変のデータ)
+/// 親が必ず子より前に並ぶ平坦な配列で持ち、モデル行列を先頭から1回なめるだけで計算できる
+/// </summary>
+class NodeHierarchy
+{
+   public:
+    // 親がいないときのインデックス
+    static constexpr int32_t kInvalidIndex = -1;
+
+   private:
+    // ノード名
+    std::vector<std::string> mNames;
+    // 親のインデックス
+    std::vector<int32_t> mParents;
+    // 初期姿勢
+    NodePose mBindPose;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    NodeHierarchy();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~NodeHierarchy() = default;
+
+    /// <summary>
+    /// ノードをすべて削除
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// ノードを追加
+    /// </summary>
+    /// <param name="name">ノード名</param>
+    /// <param name="parent">親のインデックス(追加済みのノードのみ)</param>
+    /// <param name="scale">スケール</param>
+    /// <param name="rotate">回転</param>
+    /// <param name="translate">座標</param>
+    /// <returns>自分のインデックス(親が不正ならkInvalidIndex)</returns>
+    int32_t AddNode( const std::string& name, int32_t parent, const Vector3& scale, const Quaternion& rotate, const Vector3& translate );
+
+    /// <summary>
+    /// ノードを名前で探す
+    /// </summary>
+    /// <param name="name">ノード名</param>
+    /// <returns>インデックス(無ければkInvalidIndex)</returns>
+    int32_t FindNode( const std::string& name ) const;
+
+    /// <summary>
+    /// 初期姿勢で姿勢を作成
+    /// </summary>
+    /// <param name="pose">姿勢(出力)</param>
+    void CreatePose( NodePose& pose ) const;
+
+    /// <summary>
+    /// 変更されたノードとその子孫のモデル行列を計算
+    /// </summary>
+    /// <param name="pose">姿勢</param>
+    /// <returns>計算したノード数</returns>
+    uint32_t UpdateModelMatrices( NodePose& pose ) const;
+
+    /// <summary>ノード数を取得</summary>
+    uint32_t GetCount() const { return static_cast<uint32_t>( mParents.size() ); }
+
+    /// <summary>ノード名を取得</summary>
+    const std::string& GetName( int32_t idx ) const { return mNames[idx]; }
+
+    /// <summary>親のインデックスを取得</summary>
+    int32_t GetParent( int32_t idx ) const { return mParents[idx]; }
+
+    /// <summary>親のインデックスをすべて取得</summary>
+    const std::vector<int32_t>& GetParents() const { return mParents; }
+
+    /// <summary>初期姿勢を取得</summary>
+    const NodePose& GetBindPose() const { return mBindPose; }
+};
@@ -11,7 +11,16 @@ enum class MeshFlags : uint32_t
     Normal = 1 << 1,
     UV = 1 << 2,
 
-    Required = Position | Normal | UV,  // 必須
+    // 頂点バッファの圧縮(CPU側の頂点データはそのまま、スキニングするメッシュには使わない)
+    QuantizedPosition = 1 << 3,  // AABBで正規化した16bit SNORM
+    OctahedralNormal = 1 << 4,   // 八面体写像の16bit SNORM x2
+    HalfUV = 1 << 5,             // 16bit浮動小数
+
+    // 変換行列を構造化バッファからインスタンスごとに読む(メッシュには付けず、ソーターが描画時に付ける)
+    Instanced = 1 << 6,
+
+    Required = Position | Normal | UV,                        // 必須
+    Compact = QuantizedPosition | OctahedralNormal | HalfUV,  // 全ての圧縮
 };
 ENABLE_ENUM_FLAGS( MeshFlags )
 
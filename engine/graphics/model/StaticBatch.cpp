@@ -0,0 +1,156 @@
+#include "StaticBatch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "Material.h"
+#include "MeshSorter.h"
+#include "ModelInstance.h"
+#include "PSOKey.h"
+#include "graphics/Camera.h"
+
+// コンストラクタ
+StaticBatch::StaticBatch()
+    : mBatches()
+    , mTransMatSlice()
+    , mCachedCamera( nullptr )
+    , mCachedCameraVersion( 0 )
+    , mRanges()
+    , mStats()
+{
+}
+
+// デストラクタ
+StaticBatch::~StaticBatch()
+{
+    ConstantBufferPool::GetInstance().Free( mTransMatSlice );
+}
+
+// 作成
+bool StaticBatch::Create( std::span<ModelInstance* const> instances, float cellSize )
+{
+    // クリア
+    ConstantBufferPool::GetInstance().Free( mTransMatSlice );
+    mBatches.clear();
+    mCachedCamera = nullptr;
+    mStats = {};
+
+    // バッチのキーはマテリアルとメッシュフラグの組の番号
+    std::vector<std::pair<Material*, MeshFlags>> keys;
+    std::vector<StaticBatchBuilder::Source> sources;
+    for( auto instance : instances )
+    {
+        if( !instance || !instance->GetModelData() ) continue;
+
+        auto modelData = instance->GetModelData();
+        instance->UpdateModelMatrices();
+        const auto& pose = instance->GetPose();
+        for( uint32_t i = 0; i < modelData->GetMeshCount(); ++i )
+        {
+            // スキニングする頂点はまとめられない
+            if( modelData->GetSkin( i ) ) continue;
+
+            auto mesh = modelData->GetMesh( i );
+            auto material = instance->GetMaterial( mesh->GetMaterialIdx() );
+            if( !material || mesh->GetIndices().empty() ) continue;
+
+            auto key = std::make_pair( material, mesh->GetFlags() );
+            auto it = std::find( keys.begin(), keys.end(), key );
+            auto keyIdx = static_cast<uint32_t>( it - keys.begin() );
+            if( it == keys.end() )
+            {
+                keys.emplace_back( key );
+            }
+
+            StaticBatchBuilder::Source source = {};
+            source.mVertices = mesh->GetVertices();
+            source.mIndices = mesh->GetIndices();
+            source.mWorldMat = pose.mModelMats[modelData->GetMeshNodeIdx( i )] * instance->GetWorldMatrix();
+            source.mBatchKey = keyIdx;
+            sources.emplace_back( source );
+        }
+    }
+    mStats.mSourceMeshes = static_cast<uint32_t>( sources.size() );
+
+    std::vector<StaticBatchBuilder::Batch> built;
+    StaticBatchBuilder::Build( sources, cellSize, built );
+    if( built.empty() ) return true;
+
+    // 変換行列(リソースは作らず、プールからバッチ数分のスロットを借りる)
+    static_assert( sizeof( TransformationMatrix ) <= ConstantBufferPool::kSlotSize );
+    if( !ConstantBufferPool::GetInstance().Allocate( static_cast<uint32_t>( built.size() ), mTransMatSlice ) ) return false;
+
+    for( auto& src : built )
+    {
+        const auto& key = keys[src.mBatchKey];
+        auto& batch = mBatches.emplace_back();
+        batch.mMesh = std::make_unique<Mesh>();
+        if( !batch.mMesh->Create( key.second, src.mVertices, src.mIndices ) ) return false;
+
+        batch.mMaterial = key.first;
+        batch.mCells = std::move( src.mCells );
+        mStats.mCells += static_cast<uint32_t>( batch.mCells.size() );
+    }
+    mStats.mBatches = static_cast<uint32_t>( mBatches.size() );
+
+    return true;
+}
+
+// 描画
+void StaticBatch::Draw( MeshSorter* sorter )
+{
+    mStats.mVisibleCells = 0;
+    mStats.mDraws = 0;
+    if( !sorter || mBatches.empty() ) return;
+
+    auto camera = sorter->GetCamera();
+    if( !camera ) return;
+
+    // WVP行列はカメラが変わったときだけ
+    if( camera != mCachedCamera || camera->GetVersion() != mCachedCameraVersion )
+    {
+        UpdateWVP( camera );
+    }
+
+    auto& frustum = sorter->GetFrustumCamera()->GetFrustum();
+    for( uint32_t i = 0; i < static_cast<uint32_t>( mBatches.size() ); ++i )
+    {
+        auto& batch = mBatches[i];
+        batch.mMaterial->Update();
+
+        // 可視なセルの範囲だけ登録
+        mStats.mVisibleCells += StaticBatchBuilder::Cull( batch.mCells, frustum, mRanges );
+        for( const auto& range : mRanges )
+        {
+            auto center = ( range.mAABB.mMin + range.mAABB.mMax ) * 0.5f;
+            sorter->AddRange(
+                MakePSOKey( batch.mMesh->GetFlags(), batch.mMaterial->mFlags ),
+                ( center * camera->GetView() ).z,
+                mTransMatSlice.mGPUAddress + i * ConstantBufferPool::kSlotSize,
+                batch.mMesh.get(),
+                batch.mMaterial,
+                range.mAABB,
+                range.mIndexOffset,
+                range.mIndexCount );
+            ++mStats.mDraws;
+        }
+    }
+}
+
+// WVP行列を更新して定数バッファへ書き込む
+void StaticBatch::UpdateWVP( const Camera* camera )
+{
+    for( uint32_t i = 0; i < static_cast<uint32_t>( mBatches.size() ); ++i )
+    {
+        // 頂点はワールド空間なので、量子化した位置を戻す行列がワールド行列になる
+        const auto& dequantizeMat = mBatches[i].mMesh->GetDequantizeMatrix();
+        TransformationMatrix c = {};
+        c.mWorld = dequantizeMat;
+        c.mWVP = dequantizeMat * camera->GetView() * camera->GetProjection();
+        memcpy( mTransMatSlice.mData + i * ConstantBufferPool::kSlotSize, &c, sizeof( c ) );
+    }
+
+    mCachedCamera = camera;
+    mCachedCameraVersion = camera->GetVersion();
+}
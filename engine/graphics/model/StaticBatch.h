@@ -0,0 +1,98 @@
+#pragma once
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Mesh.h"
+#include "StaticBatchBuilder.h"
+#include "TransformationMatrix.h"
+#include "core/ConstantBufferPool.h"
+
+class Camera;
+class Material;
+class MeshSorter;
+class ModelInstance;
+
+/// <summary>
+/// 静的バッチ
+/// 動かないモデルインスタンスのメッシュを、マテリアルとメッシュフラグごとに1つのメッシュへまとめて描画する
+/// セルごとにカリングし、可視なセルのインデックスの範囲だけソーターへ登録する
+/// </summary>
+class StaticBatch
+{
+   public:
+    /// <summary>
+    /// 統計
+    /// </summary>
+    struct Stats
+    {
+        // まとめたメッシュ・バッチ・セルの数
+        uint32_t mSourceMeshes;
+        uint32_t mBatches;
+        uint32_t mCells;
+        // 直前の描画で可視だったセルと、ソーターへ登録した範囲(ドローコール)の数
+        uint32_t mVisibleCells;
+        uint32_t mDraws;
+    };
+
+   private:
+    /// <summary>
+    /// バッチ
+    /// </summary>
+    struct Batch
+    {
+        // ワールド空間の頂点をまとめたメッシュ
+        std::unique_ptr<Mesh> mMesh;
+        Material* mMaterial;
+        // セル(インデックス順)
+        std::vector<StaticBatchBuilder::Cell> mCells;
+    };
+
+    // バッチ
+    std::vector<Batch> mBatches;
+    // 変換行列(プールのスロットをバッチ順に1つずつ)
+    ConstantBufferPool::Slice mTransMatSlice;
+    // WVP行列の計算に使ったカメラとそのバージョン
+    const Camera* mCachedCamera;
+    uint32_t mCachedCameraVersion;
+    // 描画する範囲(作業用)
+    std::vector<StaticBatchBuilder::IndexRange> mRanges;
+    // 統計
+    Stats mStats;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    StaticBatch();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~StaticBatch();
+
+    /// <summary>
+    /// 作成
+    /// 作成後にインスタンスを動かしても反映されない(スキンを持つメッシュはまとめない)
+    /// </summary>
+    /// <param name="instances">まとめるモデルインスタンス</param>
+    /// <param name="cellSize">セルの1辺の長さ</param>
+    /// <returns>成否</returns>
+    bool Create( std::span<ModelInstance* const> instances, float cellSize );
+
+    /// <summary>
+    /// 描画
+    /// </summary>
+    /// <param name="sorter">ソーター</param>
+    void Draw( MeshSorter* sorter );
+
+    /// <summary>統計を取得</summary>
+    const Stats& GetStats() const { return mStats; }
+
+   private:
+    /// <summary>
+    /// WVP行列を更新して定数バッファへ書き込む
+    /// </summary>
+    /// <param name="camera">カメラ</param>
+    void UpdateWVP( const Camera* camera );
+};
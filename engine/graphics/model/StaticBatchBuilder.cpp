@@ -0,0 +1,149 @@
+#include "StaticBatchBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "collision/Collision.h"
+
+namespace
+{
+
+/// <summary>
+/// メッシュの並び替え用
+/// </summary>
+struct SourceOrder
+{
+    uint32_t mSourceIdx;
+    uint32_t mBatchKey;
+    // セルの座標
+    int32_t mCell[3];
+    // ワールド空間のAABB
+    AABB3D mAABB;
+};
+
+// 同じセルか
+bool IsSameCell( const SourceOrder& a, const SourceOrder& b )
+{
+    return a.mCell[0] == b.mCell[0] && a.mCell[1] == b.mCell[1] && a.mCell[2] == b.mCell[2];
+}
+
+}  // namespace
+
+namespace StaticBatchBuilder
+{
+
+// バッチを構築する
+void Build( std::span<const Source> sources, float cellSize, std::vector<Batch>& batches )
+{
+    batches.clear();
+    if( sources.empty() || cellSize <= 0.0f ) return;
+
+    // ワールド空間のAABBからセルを決める
+    std::vector<SourceOrder> orders;
+    orders.reserve( sources.size() );
+    for( uint32_t i = 0; i < static_cast<uint32_t>( sources.size() ); ++i )
+    {
+        const auto& source = sources[i];
+        if( source.mIndices.empty() ) continue;
+
+        SourceOrder order = {};
+        order.mSourceIdx = i;
+        order.mBatchKey = source.mBatchKey;
+        order.mAABB.Reset();
+        for( const auto& vertex : source.mVertices )
+        {
+            order.mAABB.Update( Vector3( vertex.mPosition.x, vertex.mPosition.y, vertex.mPosition.z ) * source.mWorldMat );
+        }
+        auto center = ( order.mAABB.mMin + order.mAABB.mMax ) * 0.5f;
+        order.mCell[0] = static_cast<int32_t>( std::floor( center.x / cellSize ) );
+        order.mCell[1] = static_cast<int32_t>( std::floor( center.y / cellSize ) );
+        order.mCell[2] = static_cast<int32_t>( std::floor( center.z / cellSize ) );
+        orders.emplace_back( order );
+    }
+
+    // キー → セル(Z・Y・X) → 元の順
+    std::stable_sort(
+        orders.begin(),
+        orders.end(),
+        []( const SourceOrder& a, const SourceOrder& b )
+        {
+            if( a.mBatchKey != b.mBatchKey ) return a.mBatchKey < b.mBatchKey;
+
+            if( a.mCell[2] != b.mCell[2] ) return a.mCell[2] < b.mCell[2];
+
+            if( a.mCell[1] != b.mCell[1] ) return a.mCell[1] < b.mCell[1];
+
+            return a.mCell[0] < b.mCell[0];
+        } );
+
+    for( size_t i = 0; i < orders.size(); ++i )
+    {
+        const auto& order = orders[i];
+        const auto& source = sources[order.mSourceIdx];
+        if( i == 0 || order.mBatchKey != orders[i - 1].mBatchKey )
+        {
+            auto& batch = batches.emplace_back();
+            batch.mBatchKey = order.mBatchKey;
+        }
+        auto& batch = batches.back();
+        if( i == 0 || order.mBatchKey != orders[i - 1].mBatchKey || !IsSameCell( order, orders[i - 1] ) )
+        {
+            auto& cell = batch.mCells.emplace_back();
+            cell.mIndexOffset = static_cast<uint32_t>( batch.mIndices.size() );
+            cell.mAABB.Reset();
+        }
+        auto& cell = batch.mCells.back();
+
+        // 頂点をワールド空間へ(法線は逆転置行列で変換)
+        auto baseVertex = static_cast<uint32_t>( batch.mVertices.size() );
+        auto invTranspose = Transpose( InverseAffine( source.mWorldMat ) );
+        for( const auto& vertex : source.mVertices )
+        {
+            auto& added = batch.mVertices.emplace_back( vertex );
+            auto position = Vector3( vertex.mPosition.x, vertex.mPosition.y, vertex.mPosition.z ) * source.mWorldMat;
+            added.mPosition = Vector4( position.x, position.y, position.z, vertex.mPosition.w );
+            auto normal = Vector4( vertex.mNormal.x, vertex.mNormal.y, vertex.mNormal.z, 0.0f ) * invTranspose;
+            added.mNormal = Normalize( Vector3( normal.x, normal.y, normal.z ) );
+        }
+        for( auto index : source.mIndices )
+        {
+            batch.mIndices.emplace_back( baseVertex + index );
+        }
+
+        cell.mIndexCount += static_cast<uint32_t>( source.mIndices.size() );
+        ++cell.mSourceCount;
+        cell.mAABB.Update( order.mAABB.mMin );
+        cell.mAABB.Update( order.mAABB.mMax );
+    }
+}
+
+// 視錐台でセルをカリングする
+uint32_t Cull( std::span<const Cell> cells, const Frustum& frustum, std::vector<IndexRange>& ranges )
+{
+    ranges.clear();
+    uint32_t visibleCount = 0;
+    for( uint32_t i = 0; i < static_cast<uint32_t>( cells.size() ); ++i )
+    {
+        const auto& cell = cells[i];
+        if( !Intersect( cell.mAABB, frustum ) ) continue;
+
+        ++visibleCount;
+
+        // 直前の範囲に続いていればまとめる
+        if( !ranges.empty() && ranges.back().mFirstCell + ranges.back().mCellCount == i )
+        {
+            auto& range = ranges.back();
+            range.mIndexCount += cell.mIndexCount;
+            ++range.mCellCount;
+            range.mAABB.Update( cell.mAABB.mMin );
+            range.mAABB.Update( cell.mAABB.mMax );
+        }
+        else
+        {
+            ranges.emplace_back( IndexRange{ cell.mIndexOffset, cell.mIndexCount, i, 1, cell.mAABB } );
+        }
+    }
+    return visibleCount;
+}
+
+}  // namespace StaticBatchBuilder
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "MeshVertex.h"
+#include "math/Matrix4.h"
+#include "math/Primitive.h"
+
+/// <summary>
+/// 静的バッチの構築(CPUのみ)
+/// 動かないメッシュをワールド空間に変換し、同じキー(マテリアルなど)ごとに1つの頂点・インデックスへまとめる
+/// インデックスは空間のセル順に並べ、セルごとの範囲で部分的に描画できるようにする
+/// </summary>
+namespace StaticBatchBuilder
+{
+
+/// <summary>
+/// まとめるメッシュ
+/// </summary>
+struct Source
+{
+    std::span<const MeshVertex> mVertices;
+    std::span<const uint32_t> mIndices;
+    Matrix4 mWorldMat;
+    // 同じキーのメッシュを1つのバッチにまとめる
+    uint32_t mBatchKey;
+};
+
+/// <summary>
+/// セル(バッチのインデックス内で連続する)
+/// </summary>
+struct Cell
+{
+    uint32_t mIndexOffset;
+    uint32_t mIndexCount;
+    // まとめたメッシュの数
+    uint32_t mSourceCount;
+    // ワールド空間のAABB
+    AABB3D mAABB;
+};
+
+/// <summary>
+/// バッチ
+/// </summary>
+struct Batch
+{
+    uint32_t mBatchKey;
+    // ワールド空間の頂点
+    std::vector<MeshVertex> mVertices;
+    std::vector<uint32_t> mIndices;
+    // セル(インデックス順)
+    std::vector<Cell> mCells;
+};
+
+/// <summary>
+/// 描画するインデックスの範囲(連続する可視なセルをまとめたもの)
+/// </summary>
+struct IndexRange
+{
+    uint32_t mIndexOffset;
+    uint32_t mIndexCount;
+    uint32_t mFirstCell;
+    uint32_t mCellCount;
+    // ワールド空間のAABB(セルのAABBの和)
+    AABB3D mAABB;
+};
+
+/// <summary>
+/// バッチを構築する
+/// メッシュはワールド空間のAABBの中心が入るセルに割り当て、セルはZ・Y・Xの順に並べる(隣り合うセルが連続しやすい)
+/// </summary>
+/// <param name="sources">まとめるメッシュ</param>
+/// <param name="cellSize">セルの1辺の長さ</param>
+/// <param name="batches">バッチ(出力、キーの昇順)</param>
+void Build( std::span<const Source> sources, float cellSize, std::vector<Batch>& batches );
+
+/// <summary>
+/// 視錐台でセルをカリングする
+/// インデックスが連続する可視なセルは1つの範囲にまとめる
+/// </summary>
+/// <param name="cells">バッチのセル</param>
+/// <param name="frustum">視錐台(ワールド空間)</param>
+/// <param name="ranges">描画するインデックスの範囲(出力)</param>
+/// <returns>可視なセルの数</returns>
+uint32_t Cull( std::span<const Cell> cells, const Frustum& frustum, std::vector<IndexRange>& ranges );
+
+}  // namespace StaticBatchBuilder
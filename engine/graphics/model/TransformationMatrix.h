@@ -0,0 +1,13 @@
+#pragma once
+#include "math/Matrix4.h"
+
+/// <summary>
+/// メッシュの変換行列(グラフィックスAPIに依存しない)
+/// 定数バッファとインスタンシングの構造化バッファで同じ配置(ModelVS.hlsl・ZPrepassVS.hlslと合わせる)
+/// </summary>
+struct TransformationMatrix
+{
+    Matrix4 mWorld;
+    Matrix4 mWVP;
+    Matrix4 mWorldInvTranspose;
+};
@@ -0,0 +1,246 @@
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "math/Primitive.h"
+
+namespace
+{
+
+// フラグが立っているか
+bool HasFlag( MeshFlags flags, MeshFlags flag )
+{
+    return ( flags & flag ) == flag;
+}
+
+// [-1,1]を16bit SNORMにする
+int16_t ToSnorm16( float value )
+{
+    return static_cast<int16_t>( std::lround( std::clamp( value, -1.0f, 1.0f ) * VertexCompression::kSnorm16Max ) );
+}
+
+// 16bit SNORMを[-1,1]に戻す
+float FromSnorm16( int16_t value )
+{
+    return ( std::max )( static_cast<float>( value ) / VertexCompression::kSnorm16Max, -1.0f );
+}
+
+// 書き込んで進める
+template <typename T>
+void Write( uint8_t*& dst, const T& value )
+{
+    memcpy( dst, &value, sizeof( T ) );
+    dst += sizeof( T );
+}
+
+// 読み込んで進める
+template <typename T>
+T Read( const uint8_t*& src )
+{
+    T value;
+    memcpy( &value, src, sizeof( T ) );
+    src += sizeof( T );
+    return value;
+}
+
+}  // namespace
+
+namespace VertexCompression
+{
+
+// 1頂点のサイズを取得
+uint32_t GetStride( MeshFlags flags )
+{
+    uint32_t stride = 0;
+    stride += HasFlag( flags, MeshFlags::QuantizedPosition ) ? sizeof( int16_t ) * 4 : sizeof( Vector4 );
+    stride += HasFlag( flags, MeshFlags::OctahedralNormal ) ? sizeof( int16_t ) * 2 : sizeof( Vector3 );
+    stride += HasFlag( flags, MeshFlags::HalfUV ) ? sizeof( uint16_t ) * 2 : sizeof( Vector2 );
+    return stride;
+}
+
+// 頂点を圧縮する
+void Encode( MeshFlags flags, std::span<const MeshVertex> vertices, std::vector<uint8_t>& data, Matrix4& dequantizeMat )
+{
+    // 位置はAABBの中心からの[-1,1]にする(幅が無い軸はそのまま)
+    dequantizeMat = Matrix4();
+    auto center = Vector3::kZero;
+    auto invHalfSize = Vector3::kOne;
+    auto isQuantized = HasFlag( flags, MeshFlags::QuantizedPosition );
+    if( isQuantized && !vertices.empty() )
+    {
+        AABB3D aabb;
+        aabb.Reset();
+        for( const auto& vertex : vertices )
+        {
+            aabb.Update( Vector3( vertex.mPosition.x, vertex.mPosition.y, vertex.mPosition.z ) );
+        }
+        center = ( aabb.mMin + aabb.mMax ) * 0.5f;
+        auto halfSize = ( aabb.mMax - aabb.mMin ) * 0.5f;
+        halfSize.x = halfSize.x > 0.0f ? halfSize.x : 1.0f;
+        halfSize.y = halfSize.y > 0.0f ? halfSize.y : 1.0f;
+        halfSize.z = halfSize.z > 0.0f ? halfSize.z : 1.0f;
+        invHalfSize = Vector3( 1.0f / halfSize.x, 1.0f / halfSize.y, 1.0f / halfSize.z );
+        dequantizeMat = CreateScale( halfSize ) * CreateTranslate( center );
+    }
+
+    auto stride = GetStride( flags );
+    data.resize( vertices.size() * stride );
+    auto* dst = data.data();
+    for( const auto& vertex : vertices )
+    {
+        // 位置(wは1)
+        if( isQuantized )
+        {
+            Write( dst, ToSnorm16( ( vertex.mPosition.x - center.x ) * invHalfSize.x ) );
+            Write( dst, ToSnorm16( ( vertex.mPosition.y - center.y ) * invHalfSize.y ) );
+            Write( dst, ToSnorm16( ( vertex.mPosition.z - center.z ) * invHalfSize.z ) );
+            Write( dst, ToSnorm16( 1.0f ) );
+        }
+        else
+        {
+            Write( dst, vertex.mPosition );
+        }
+
+        // 法線
+        if( HasFlag( flags, MeshFlags::OctahedralNormal ) )
+        {
+            int16_t encoded[2] = {};
+            EncodeOctahedral( vertex.mNormal, encoded );
+            Write( dst, encoded );
+        }
+        else
+        {
+            Write( dst, vertex.mNormal );
+        }
+
+        // UV
+        if( HasFlag( flags, MeshFlags::HalfUV ) )
+        {
+            Write( dst, FloatToHalf( vertex.mUV.x ) );
+            Write( dst, FloatToHalf( vertex.mUV.y ) );
+        }
+        else
+        {
+            Write( dst, vertex.mUV );
+        }
+    }
+}
+
+// 圧縮した頂点を戻す
+MeshVertex Decode( MeshFlags flags, const uint8_t* vertex, const Matrix4& dequantizeMat )
+{
+    MeshVertex result = {};
+    const auto* src = vertex;
+    if( HasFlag( flags, MeshFlags::QuantizedPosition ) )
+    {
+        auto x = FromSnorm16( Read<int16_t>( src ) );
+        auto y = FromSnorm16( Read<int16_t>( src ) );
+        auto z = FromSnorm16( Read<int16_t>( src ) );
+        auto w = FromSnorm16( Read<int16_t>( src ) );
+        auto position = Vector3( x, y, z ) * dequantizeMat;
+        result.mPosition = Vector4( position.x, position.y, position.z, w );
+    }
+    else
+    {
+        result.mPosition = Read<Vector4>( src );
+    }
+
+    if( HasFlag( flags, MeshFlags::OctahedralNormal ) )
+    {
+        int16_t encoded[2] = { Read<int16_t>( src ), Read<int16_t>( src ) };
+        result.mNormal = DecodeOctahedral( encoded );
+    }
+    else
+    {
+        result.mNormal = Read<Vector3>( src );
+    }
+
+    if( HasFlag( flags, MeshFlags::HalfUV ) )
+    {
+        auto u = HalfToFloat( Read<uint16_t>( src ) );
+        auto v = HalfToFloat( Read<uint16_t>( src ) );
+        result.mUV = Vector2( u, v );
+    }
+    else
+    {
+        result.mUV = Read<Vector2>( src );
+    }
+    return result;
+}
+
+// 法線を八面体写像で2成分にする
+void EncodeOctahedral( const Vector3& normal, int16_t encoded[2] )
+{
+    auto sum = std::fabs( normal.x ) + std::fabs( normal.y ) + std::fabs( normal.z );
+    auto n = sum > 0.0f ? normal / sum : Vector3::kUnitZ;
+    auto x = n.x;
+    auto y = n.y;
+    // 下半分は外側の三角形に折り返す
+    if( n.z < 0.0f )
+    {
+        x = ( 1.0f - std::fabs( n.y ) ) * ( n.x >= 0.0f ? 1.0f : -1.0f );
+        y = ( 1.0f - std::fabs( n.x ) ) * ( n.y >= 0.0f ? 1.0f : -1.0f );
+    }
+    encoded[0] = ToSnorm16( x );
+    encoded[1] = ToSnorm16( y );
+}
+
+// 八面体写像から法線に戻す(シェーダーと同じ計算)
+Vector3 DecodeOctahedral( const int16_t encoded[2] )
+{
+    auto n = Vector3( FromSnorm16( encoded[0] ), FromSnorm16( encoded[1] ), 0.0f );
+    n.z = 1.0f - std::fabs( n.x ) - std::fabs( n.y );
+    auto t = std::clamp( -n.z, 0.0f, 1.0f );
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return Normalize( n );
+}
+
+// 16bit浮動小数に変換(範囲外は無限大、非正規化数まで扱う)
+uint16_t FloatToHalf( float value )
+{
+    uint32_t bits = 0;
+    memcpy( &bits, &value, sizeof( bits ) );
+    auto sign = static_cast<uint16_t>( ( bits >> 16 ) & 0x8000 );
+    auto exponent = static_cast<int32_t>( ( bits >> 23 ) & 0xff );
+    auto mantissa = bits & 0x7fffff;
+
+    // 無限大・NaN
+    if( exponent == 0xff ) return static_cast<uint16_t>( sign | 0x7c00 | ( mantissa ? 0x200 : 0 ) );
+
+    exponent = exponent - 127 + 15;
+    if( exponent >= 31 ) return static_cast<uint16_t>( sign | 0x7c00 );
+
+    // 非正規化数(小さすぎれば0)
+    if( exponent <= 0 )
+    {
+        if( exponent < -10 ) return sign;
+
+        mantissa |= 0x800000;
+        auto shift = static_cast<uint32_t>( 14 - exponent );
+        auto half = mantissa >> shift;
+        half += ( mantissa >> ( shift - 1 ) ) & 1;
+        return static_cast<uint16_t>( sign | half );
+    }
+
+    // 四捨五入(仮数部の繰り上がりは指数部に入る)
+    auto half = static_cast<uint32_t>( ( exponent << 10 ) | ( mantissa >> 13 ) );
+    half += ( mantissa >> 12 ) & 1;
+    return static_cast<uint16_t>( sign | ( ( std::min )( half, 0x7c00u ) ) );
+}
+
+// 16bit浮動小数から変換
+float HalfToFloat( uint16_t value )
+{
+    auto sign = ( value & 0x8000 ) ? -1.0f : 1.0f;
+    auto exponent = ( value >> 10 ) & 0x1f;
+    auto mantissa = value & 0x3ff;
+    if( exponent == 0 ) return sign * std::ldexp( static_cast<float>( mantissa ), -24 );
+    if( exponent == 31 ) return mantissa ? NAN : sign * INFINITY;
+
+    return sign * std::ldexp( static_cast<float>( mantissa | 0x400 ), exponent - 25 );
+}
+
+}  // namespace VertexCompression
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "MeshVertex.h"
+#include "PSOKey.h"
+#include "math/Matrix4.h"
+
+/// <summary>
+/// 頂点バッファの圧縮(グラフィックスAPIに依存しない)
+/// 位置・法線・UVの順に、MeshFlagsで選んだ形式で詰める
+/// </summary>
+namespace VertexCompression
+{
+
+// 16bit SNORMの最大値
+inline constexpr float kSnorm16Max = 32767.0f;
+// 16bitインデックスを使える頂点数の上限(未満)
+inline constexpr uint32_t kMax16BitVertexCount = 65536;
+
+/// <summary>
+/// 1頂点のサイズを取得
+/// </summary>
+/// <param name="flags">メッシュフラグ</param>
+/// <returns>バイト数</returns>
+uint32_t GetStride( MeshFlags flags );
+
+/// <summary>
+/// 頂点を圧縮する
+/// </summary>
+/// <param name="flags">メッシュフラグ</param>
+/// <param name="vertices">頂点</param>
+/// <param name="data">圧縮した頂点(出力)</param>
+/// <param name="dequantizeMat">量子化した位置をモデル空間に戻す行列(出力、QuantizedPositionでなければ単位行列)</param>
+void Encode( MeshFlags flags, std::span<const MeshVertex> vertices, std::vector<uint8_t>& data, Matrix4& dequantizeMat );
+
+/// <summary>
+/// 圧縮した頂点を戻す(誤差の確認用)
+/// </summary>
+/// <param name="flags">メッシュフラグ</param>
+/// <param name="vertex">圧縮した頂点</param>
+/// <param name="dequantizeMat">量子化した位置をモデル空間に戻す行列</param>
+/// <returns>頂点</returns>
+MeshVertex Decode( MeshFlags flags, const uint8_t* vertex, const Matrix4& dequantizeMat );
+
+/// <summary>
+/// 法線を八面体写像で2成分にする
+/// </summary>
+/// <param name="normal">法線</param>
+/// <param name="encoded">[-1,1]の2成分(16bit SNORM、出力)</param>
+void EncodeOctahedral( const Vector3& normal, int16_t encoded[2] );
+
+/// <summary>
+/// 八面体写像から法線に戻す
+/// </summary>
+/// <param name="encoded">[-1,1]の2成分(16bit SNORM)</param>
+/// <returns>正規化した法線</returns>
+Vector3 DecodeOctahedral( const int16_t encoded[2] );
+
+/// <summary>
+/// 16bit浮動小数に変換
+/// </summary>
+uint16_t FloatToHalf( float value );
+
+/// <summary>
+/// 16bit浮動小数から変換
+/// </summary>
+float HalfToFloat( uint16_t value );
+
+}  // namespace VertexCompression
@@ -298,7 +298,21 @@ inline Matrix4 CreateTranslate( const Vector3& translate )
 /// </summary>
 inline Matrix4 CreateAffine( const Vector3& scale, const Quaternion& rotate, const Vector3& translate )
 {
-    return CreateScale( scale ) * CreateRotate( rotate ) * CreateTranslate( translate );
+    // スケール * 回転 * 平行移動を行列の積を使わずに組み立てる
+    Matrix4 mat = CreateRotate( rotate );
+    mat.m[0][0] *= scale.x;
+    mat.m[0][1] *= scale.x;
+    mat.m[0][2] *= scale.x;
+    mat.m[1][0] *= scale.y;
+    mat.m[1][1] *= scale.y;
+    mat.m[1][2] *= scale.y;
+    mat.m[2][0] *= scale.z;
+    mat.m[2][1] *= scale.z;
+    mat.m[2][2] *= scale.z;
+    mat.m[3][0] = translate.x;
+    mat.m[3][1] = translate.y;
+    mat.m[3][2] = translate.z;
+    return mat;
 }
 
 /// <summary>
@@ -1,4 +1,5 @@
 #pragma once
+#include <cfloat>
 #include <limits>
 
 #include "Matrix4.h"
@@ -161,6 +162,21 @@ struct Capsule3D
     float mRadius;
 };
 
+/// <summary>
+/// 円錐
+/// </summary>
+struct Cone
+{
+    // 頂点
+    Vector3 mApex;
+    // 向き(正規化済み)
+    Vector3 mDirection;
+    // 高さ
+    float mHeight;
+    // 半頂角(ラジアン)
+    float mAngle;
+};
+
 /// <summary>
 /// 平面
 /// </summary>
@@ -210,7 +226,47 @@ struct Frustum
         mPlanes[5].mNormal.z = vpMat.m[2][3] - vpMat.m[2][2];
         mPlanes[5].mD = vpMat.m[3][3] - vpMat.m[3][2];
 
-        // 正規化
+        Normalize();
+    }
+
+    /// <summary>
+    /// 正規化デバイス座標の部分範囲から構築(タイル・クラスター用)
+    /// </summary>
+    /// <param name="vpMat">ビュープロジェクション行列</param>
+    /// <param name="ndcMin">範囲の最小値(x,y:[-1,1] z:[0,1])</param>
+    /// <param name="ndcMax">範囲の最大値(x,y:[-1,1] z:[0,1])</param>
+    void Build( const Matrix4& vpMat, const Vector3& ndcMin, const Vector3& ndcMax )
+    {
+        // x >= min * w
+        auto setPlane = [&]( Plane& plane, uint32_t axis, float sign, float bound )
+        {
+            plane.mNormal.x = sign * ( vpMat.m[0][axis] - bound * vpMat.m[0][3] );
+            plane.mNormal.y = sign * ( vpMat.m[1][axis] - bound * vpMat.m[1][3] );
+            plane.mNormal.z = sign * ( vpMat.m[2][axis] - bound * vpMat.m[2][3] );
+            plane.mD = sign * ( vpMat.m[3][axis] - bound * vpMat.m[3][3] );
+        };
+        // 左
+        setPlane( mPlanes[0], 0, +1.0f, ndcMin.x );
+        // 右
+        setPlane( mPlanes[1], 0, -1.0f, ndcMax.x );
+        // 下
+        setPlane( mPlanes[2], 1, +1.0f, ndcMin.y );
+        // 上
+        setPlane( mPlanes[3], 1, -1.0f, ndcMax.y );
+        // near
+        setPlane( mPlanes[4], 2, +1.0f, ndcMin.z );
+        // far
+        setPlane( mPlanes[5], 2, -1.0f, ndcMax.z );
+
+        Normalize();
+    }
+
+   private:
+    /// <summary>
+    /// 平面を正規化
+    /// </summary>
+    void Normalize()
+    {
         for( auto& plane : mPlanes )
         {
             float len = Length( plane.mNormal );
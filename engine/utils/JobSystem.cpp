@@ -0,0 +1,140 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// コンストラクタ
+JobSystem::JobSystem()
+    : mWorkers()
+    , mJobs()
+    , mMutex()
+    , mCondition()
+    , mIsQuit( false )
+{
+}
+
+// デストラクタ
+JobSystem::~JobSystem()
+{
+    Term();
+}
+
+// 初期化
+bool JobSystem::Init( uint32_t workerCount )
+{
+    Term();
+
+    if( workerCount == 0 )
+    {
+        auto hardwareCount = std::thread::hardware_concurrency();
+        workerCount = hardwareCount > 1 ? hardwareCount - 1 : 0;
+    }
+
+    mIsQuit = false;
+    mWorkers.reserve( workerCount );
+    for( uint32_t i = 0; i < workerCount; ++i )
+    {
+        mWorkers.emplace_back( &JobSystem::WorkerLoop, this );
+    }
+
+    return true;
+}
+
+// 終了処理
+void JobSystem::Term()
+{
+    {
+        std::lock_guard<std::mutex> lock( mMutex );
+        mIsQuit = true;
+    }
+    mCondition.notify_all();
+
+    for( auto& worker : mWorkers )
+    {
+        if( worker.joinable() )
+        {
+            worker.join();
+        }
+    }
+    mWorkers.clear();
+    mJobs.clear();
+}
+
+// 範囲を分割して並列実行し、すべて終わるまで待つ
+void JobSystem::ParallelFor( uint32_t count, uint32_t batchSize, const RangeFunc& func )
+{
+    if( count == 0 ) return;
+
+    batchSize = ( std::max )( batchSize, 1u );
+    auto jobCount = ( count + batchSize - 1 ) / batchSize;
+
+    // ワーカーがいない、または分割する意味がなければその場で実行
+    if( mWorkers.empty() || jobCount == 1 )
+    {
+        func( 0, count );
+        return;
+    }
+
+    std::atomic<uint32_t> remaining( jobCount );
+    {
+        std::lock_guard<std::mutex> lock( mMutex );
+        for( uint32_t i = 0; i < jobCount; ++i )
+        {
+            auto begin = i * batchSize;
+            auto end = ( std::min )( begin + batchSize, count );
+            mJobs.emplace_back(
+                [&func, &remaining, begin, end]()
+                {
+                    func( begin, end );
+                    remaining.fetch_sub( 1, std::memory_order_release );
+                } );
+        }
+    }
+    mCondition.notify_all();
+
+    // 呼び出し元も手伝う
+    while( remaining.load( std::memory_order_acquire ) > 0 )
+    {
+        if( !RunOne() )
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ワーカーの処理
+void JobSystem::WorkerLoop()
+{
+    while( true )
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock( mMutex );
+            mCondition.wait(
+                lock,
+                [this]()
+                {
+                    return mIsQuit || !mJobs.empty();
+                } );
+            if( mIsQuit && mJobs.empty() ) return;
+
+            job = std::move( mJobs.front() );
+            mJobs.pop_front();
+        }
+        job();
+    }
+}
+
+// キューからジョブを1つ取り出して実行
+bool JobSystem::RunOne()
+{
+    std::function<void()> job;
+    {
+        std::lock_guard<std::mutex> lock( mMutex );
+        if( mJobs.empty() ) return false;
+
+        job = std::move( mJobs.front() );
+        mJobs.pop_front();
+    }
+    job();
+    return true;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ジョブシステム(ワーカースレッドによる並列実行)
+/// </summary>
+class JobSystem
+{
+   public:
+    // 範囲処理の関数 [begin, end)
+    using RangeFunc = std::function<void( uint32_t begin, uint32_t end )>;
+
+   private:
+    // ワーカースレッド
+    std::vector<std::thread> mWorkers;
+    // ジョブキュー
+    std::deque<std::function<void()>> mJobs;
+    // キューの排他制御
+    std::mutex mMutex;
+    // ジョブ追加の通知
+    std::condition_variable mCondition;
+    // 終了要求
+    bool mIsQuit;
+
+   public:
+    /// <summary>
+    /// インスタンスを取得
+    /// </summary>
+    /// <returns>インスタンス</returns>
+    static JobSystem& GetInstance()
+    {
+        static JobSystem instance;
+        return instance;
+    }
+
+   private:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    JobSystem();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~JobSystem();
+
+   public:
+    /// <summary>
+    /// コピーコンストラクタ禁止
+    /// </summary>
+    JobSystem( const JobSystem& ) = delete;
+
+    /// <summary>
+    /// 代入演算子禁止
+    /// </summary>
+    JobSystem& operator=( const JobSystem& ) = delete;
+
+    /// <summary>
+    /// ムーブコンストラクタ禁止
+    /// </summary>
+    JobSystem( JobSystem&& ) = delete;
+
+    /// <summary>
+    /// ムーブ代入演算子禁止
+    /// </summary>
+    JobSystem& operator=( JobSystem&& ) = delete;
+
+    /// <summary>
+    /// 初期化
+    /// </summary>
+    /// <param name="workerCount">ワーカー数(0ならコア数-1)</param>
+    /// <returns>成否</returns>
+    bool Init( uint32_t workerCount = 0 );
+
+    /// <summary>
+    /// 終了処理
+    /// </summary>
+    void Term();
+
+    /// <summary>
+    /// 範囲を分割して並列実行し、すべて終わるまで待つ
+    /// </summary>
+    /// <param name="count">要素数</param>
+    /// <param name="batchSize">1ジョブあたりの要素数</param>
+    /// <param name="func">範囲処理の関数</param>
+    void ParallelFor( uint32_t count, uint32_t batchSize, const RangeFunc& func );
+
+    /// <summary>ワーカー数を取得</summary>
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>( mWorkers.size() ); }
+
+    /// <summary>呼び出し元を含めた並列数を取得</summary>
+    uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }
+
+   private:
+    /// <summary>
+    /// ワーカーの処理
+    /// </summary>
+    void WorkerLoop();
+
+    /// <summary>
+    /// キューからジョブを1つ取り出して実行
+    /// </summary>
+    /// <returns>実行したか</returns>
+    bool RunOne();
+};
@@ -0,0 +1,74 @@
+#include "MappedFile.h"
+
+#include <Windows.h>
+
+#include "StringHelper.h"
+
+// コンストラクタ
+MappedFile::MappedFile()
+    : mFile( INVALID_HANDLE_VALUE )
+    , mMapping( nullptr )
+    , mData( nullptr )
+    , mSize( 0 )
+{
+}
+
+// デストラクタ
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+// 開く
+bool MappedFile::Open( const std::string& path )
+{
+    Close();
+
+    mFile = CreateFileW( StringHelper::Convert( path ).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+    if( mFile == INVALID_HANDLE_VALUE ) return false;
+
+    LARGE_INTEGER size = {};
+    if( !GetFileSizeEx( mFile, &size ) || size.QuadPart == 0 )
+    {
+        Close();
+        return false;
+    }
+
+    mMapping = CreateFileMappingW( mFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( !mMapping )
+    {
+        Close();
+        return false;
+    }
+
+    mData = static_cast<const uint8_t*>( MapViewOfFile( mMapping, FILE_MAP_READ, 0, 0, 0 ) );
+    if( !mData )
+    {
+        Close();
+        return false;
+    }
+    mSize = static_cast<size_t>( size.QuadPart );
+
+    return true;
+}
+
+// 閉じる
+void MappedFile::Close()
+{
+    if( mData )
+    {
+        UnmapViewOfFile( mData );
+        mData = nullptr;
+    }
+    if( mMapping )
+    {
+        CloseHandle( mMapping );
+        mMapping = nullptr;
+    }
+    if( mFile != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( mFile );
+        mFile = INVALID_HANDLE_VALUE;
+    }
+    mSize = 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// 読み取り専用でメモリマップしたファイル
+/// </summary>
+class MappedFile
+{
+   private:
+    // ファイルとマッピングのハンドル
+    void* mFile;
+    void* mMapping;
+    // マップしたデータ
+    const uint8_t* mData;
+    // サイズ
+    size_t mSize;
+
+   public:
+    /// <summary>
+    /// コンストラクタ
+    /// </summary>
+    MappedFile();
+
+    /// <summary>
+    /// デストラクタ
+    /// </summary>
+    ~MappedFile();
+
+    /// <summary>
+    /// コピーコンストラクタ禁止
+    /// </summary>
+    MappedFile( const MappedFile& ) = delete;
+
+    /// <summary>
+    /// 代入演算子禁止
+    /// </summary>
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    /// <summary>
+    /// 開く
+    /// </summary>
+    /// <param name="path">ファイルのパス</param>
+    /// <returns>成否</returns>
+    bool Open( const std::string& path );
+
+    /// <summary>
+    /// 閉じる
+    /// </summary>
+    void Close();
+
+    /// <summary>データを取得</summary>
+    const uint8_t* GetData() const { return mData; }
+
+    /// <summary>サイズを取得</summary>
+    size_t GetSize() const { return mSize; }
+
+    /// <summary>開いているか</summary>
+    bool IsOpen() const { return mData != nullptr; }
+};
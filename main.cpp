@@ -9,6 +9,7 @@
 #include "core/RootSignature.h"
 #include "core/VertexBuffer.h"
 #include "core/Window.h"
+#include "editor/Benchmark.h"
 #include "editor/EditorBase.h"
 #include "graphics/Renderer.h"
 #include "graphics/Texture.h"
@@ -16,6 +17,7 @@
 #include "input/InputBase.h"
 #include "math/Random.h"
 #include "math/Vector4.h"
+#include "utils/JobSystem.h"
 #include "utils/Logger.h"
 #include "utils/StringHelper.h"
 
@@ -28,6 +30,8 @@ int WINAPI WinMain( HINSTANCE, HINSTANCE, LPSTR, int )
     auto& resMgr = ResourceManager::GetInstance();
     auto& renderer = Renderer::GetInstance();
     auto& inputBase = InputBase::GetInstance();
+    auto& benchmark = Benchmark::GetInstance();
+    auto& jobSystem = JobSystem::GetInstance();
 
     // ウィンドウを作成
     if( !window.Create( 1920, 1080, L"Game" ) )
@@ -101,9 +105,24 @@ int WINAPI WinMain( HINSTANCE, HINSTANCE, LPSTR, int )
         LOG_INFO( "Input base initialized successfully." );
     }
 
+    // ジョブシステムを初期化
+    if( !jobSystem.Init() )
+    {
+        LOG_ERROR( "Failed to initialize job system." );
+        MessageBox( nullptr, L"Failed to initialize job system.", L"Error", MB_OK | MB_ICONERROR );
+        return -1;
+    }
+    else
+    {
+        LOG_INFO( std::format( "Job system initialized successfully. ({} workers)", jobSystem.GetWorkerCount() ) );
+    }
+
     // 乱数の初期化
     Random::Init();
 
+    // ベンチマークの初期化
+    benchmark.Init();
+
     std::chrono::steady_clock::time_point prevTime = std::chrono::steady_clock::now();
     auto deltaTime = 0.0f;
 
@@ -181,6 +200,8 @@ int WINAPI WinMain( HINSTANCE, HINSTANCE, LPSTR, int )
 
         renderer.UpdateGUI();
 
+        benchmark.UpdateGUI();
+
         renderer.Update( deltaTime );
 
         // レンダリング
@@ -208,6 +229,11 @@ int WINAPI WinMain( HINSTANCE, HINSTANCE, LPSTR, int )
         dxBase.EndDraw();
     }
 
+    benchmark.Term();
+
+    jobSystem.Term();
+    LOG_INFO( "Job system terminated." );
+
     inputBase.Term();
     LOG_INFO( "Input base terminated." );
 
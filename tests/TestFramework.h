@@ -0,0 +1,108 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// テスト(デバイスを使わないエンジンのコードを確かめる)
+/// </summary>
+namespace Test
+{
+
+// テスト関数
+using Func = void ( * )();
+
+/// <summary>
+/// テストケース
+/// </summary>
+struct Case
+{
+    // スイート名
+    const char* mSuite;
+    // 名前
+    const char* mName;
+    // 関数
+    Func mFunc;
+};
+
+/// <summary>
+/// 登録されたケースを取得
+/// </summary>
+/// <returns>ケースリスト</returns>
+std::vector<Case>& GetCases();
+
+/// <summary>
+/// 失敗を記録
+/// </summary>
+/// <param name="file">ファイル名</param>
+/// <param name="line">行番号</param>
+/// <param name="message">メッセージ</param>
+void Fail( const char* file, int line, const std::string& message );
+
+/// <summary>
+/// 実行中のケースの失敗数を取得
+/// </summary>
+/// <returns>失敗数</returns>
+uint32_t GetFailureCount();
+
+/// <summary>
+/// 失敗数をリセット
+/// </summary>
+void ResetFailureCount();
+
+/// <summary>
+/// 2つの値を並べたメッセージを作成
+/// </summary>
+template <typename A, typename B>
+std::string FormatPair( const char* expr, const A& a, const B& b )
+{
+    std::ostringstream stream;
+    stream << expr << " (" << a << " vs " << b << ")";
+    return stream.str();
+}
+
+/// <summary>
+/// 静的初期化でケースを登録する
+/// </summary>
+struct Registrar
+{
+    Registrar( const char* suite, const char* name, Func func )
+    {
+        GetCases().push_back( { suite, name, func } );
+    }
+};
+
+}  // namespace Test
+
+#define TEST( suite, name )                                                               \
+    static void suite##_##name();                                                         \
+    static const Test::Registrar suite##_##name##_registrar( #suite, #name, &suite##_##name ); \
+    static void suite##_##name()
+
+#define EXPECT_TRUE( cond )                                   \
+    do                                                        \
+    {                                                         \
+        if( !( cond ) ) Test::Fail( __FILE__, __LINE__, #cond ); \
+    } while( false )
+
+#define EXPECT_FALSE( cond ) EXPECT_TRUE( !( cond ) )
+
+#define EXPECT_EQ( a, b )                                                                                 \
+    do                                                                                                    \
+    {                                                                                                     \
+        const auto& testA = ( a );                                                                        \
+        const auto& testB = ( b );                                                                        \
+        if( !( testA == testB ) )                                                                         \
+            Test::Fail( __FILE__, __LINE__, Test::FormatPair( #a " == " #b, testA, testB ) ); \
+    } while( false )
+
+#define EXPECT_NEAR( a, b, tolerance )                                                                    \
+    do                                                                                                    \
+    {                                                                                                     \
+        const double testA = ( a );                                                                       \
+        const double testB = ( b );                                                                       \
+        if( !( std::abs( testA - testB ) <= ( tolerance ) ) )                                             \
+            Test::Fail( __FILE__, __LINE__, Test::FormatPair( #a " ~= " #b, testA, testB ) ); \
+    } while( false )
@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <cstring>
+
+#include "TestFramework.h"
+#include "utils/JobSystem.h"
+
+namespace
+{
+
+// 実行中のケースの失敗数
+uint32_t gFailureCount = 0;
+
+}  // namespace
+
+// 登録されたケースを取得
+std::vector<Test::Case>& Test::GetCases()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+// 失敗を記録
+void Test::Fail( const char* file, int line, const std::string& message )
+{
+    std::printf( "  %s(%d): %s\n", file, line, message.c_str() );
+    ++gFailureCount;
+}
+
+// 実行中のケースの失敗数を取得
+uint32_t Test::GetFailureCount()
+{
+    return gFailureCount;
+}
+
+// 失敗数をリセット
+void Test::ResetFailureCount()
+{
+    gFailureCount = 0;
+}
+
+// 引数にスイート名を渡すとそのスイートだけ実行する
+int main( int argc, char** argv )
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    JobSystem::GetInstance().Init();
+
+    uint32_t runCount = 0;
+    uint32_t failedCount = 0;
+    for( auto& c : Test::GetCases() )
+    {
+        if( filter && std::strcmp( filter, c.mSuite ) != 0 ) continue;
+
+        Test::ResetFailureCount();
+        c.mFunc();
+        ++runCount;
+        if( Test::GetFailureCount() > 0 )
+        {
+            ++failedCount;
+            std::printf( "[FAILED] %s.%s\n", c.mSuite, c.mName );
+        }
+        else
+        {
+            std::printf( "[OK] %s.%s\n", c.mSuite, c.mName );
+        }
+    }
+
+    JobSystem::GetInstance().Term();
+
+    // 1つも実行していなければスイート名の誤りとして失敗にする
+    if( runCount == 0 )
+    {
+        std::printf( "No tests matched '%s'\n", filter ? filter : "" );
+        return 1;
+    }
+    std::printf( "%u/%u passed\n", runCount - failedCount, runCount );
+    return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "TestFramework.h"
+#include "collision/BVH.h"
+#include "collision/QuantizedBVH.h"
+#include "collision/TriangleMesh.h"
+
+namespace
+{
+
+// 中心を指数的に離して並べる(ビン分割で上から数個ずつしか剥がれず木が深くなる)
+Vector3 GetDeepCenter( uint32_t i )
+{
+    return Vector3( std::exp2( i * 0.4f ), 0.0f, 0.0f );
+}
+
+// 深くなる並びのAABB
+std::vector<AABB3D> CreateDeepBounds( uint32_t count )
+{
+    std::vector<AABB3D> bounds( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        auto c = GetDeepCenter( i );
+        auto e = Vector3( c.x * 0.01f, 1.0f, 1.0f );
+        bounds[i] = { c - e, c + e };
+    }
+    return bounds;
+}
+
+// 深くなる並びの三角形
+void CreateDeepMesh( uint32_t count, std::vector<Vector3>& positions, std::vector<uint32_t>& indices )
+{
+    positions.clear();
+    indices.clear();
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        auto c = GetDeepCenter( i );
+        auto first = static_cast<uint32_t>( positions.size() );
+        positions.emplace_back( Vector3( c.x * 0.99f, -1.0f, 0.0f ) );
+        positions.emplace_back( Vector3( c.x * 1.01f, -1.0f, 0.0f ) );
+        positions.emplace_back( Vector3( c.x, 1.0f, 0.0f ) );
+        indices.emplace_back( first + 0 );
+        indices.emplace_back( first + 1 );
+        indices.emplace_back( first + 2 );
+    }
+}
+
+// 木の深さ
+uint32_t GetDepth( const BVH& bvh, uint32_t nodeIdx = 0 )
+{
+    const auto& node = bvh.GetNodes()[nodeIdx];
+    if( node.IsLeaf() ) return 0;
+    return 1 + ( std::max )( GetDepth( bvh, node.mLeftOrFirst ), GetDepth( bvh, node.mLeftOrFirst + 1 ) );
+}
+
+}  // namespace
+
+// 深くなる入力でも深さの上限を超えず、すべてのプリミティブが葉に入る
+TEST( BVH, BuildDepthIsBounded )
+{
+    const uint32_t count = 300;
+    BVH bvh;
+    EXPECT_TRUE( bvh.Build( CreateDeepBounds( count ), 1 ) );
+    auto depth = GetDepth( bvh );
+    EXPECT_TRUE( depth > 32 );
+    EXPECT_TRUE( depth < BVH::kMaxDepth );
+
+    uint32_t primCount = 0;
+    for( const auto& node : bvh.GetNodes() )
+    {
+        primCount += node.mCount;
+    }
+    EXPECT_EQ( primCount, count );
+}
+
+// 深さの上限まで積まれても探索でノードを落とさない
+TEST( BVH, DeepTraversalVisitsAll )
+{
+    const uint32_t count = 300;
+    BVH bvh;
+    bvh.Build( CreateDeepBounds( count ), 1 );
+
+    std::vector<uint32_t> visited( count, 0 );
+    bvh.Overlap( bvh.GetBounds(), [&]( uint32_t prim ) { ++visited[prim]; } );
+    EXPECT_TRUE( std::all_of( visited.begin(), visited.end(), []( uint32_t v ) { return v == 1; } ) );
+
+    // 当たっても距離を縮めなければすべて調べる
+    visited.assign( count, 0 );
+    bvh.Raycast( Vector3( -1.0f, 0.0f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ), 1e38f, 0.0f,
+        [&]( uint32_t prim, float& ) { ++visited[prim]; } );
+    EXPECT_TRUE( std::all_of( visited.begin(), visited.end(), []( uint32_t v ) { return v == 1; } ) );
+}
+
+// 量子化BVHも深い木の奥の三角形を見つける
+TEST( BVH, QuantizedDeepRaycast )
+{
+    std::vector<Vector3> positions;
+    std::vector<uint32_t> indices;
+    CreateDeepMesh( 300, positions, indices );
+    QuantizedBVH qbvh;
+    EXPECT_TRUE( qbvh.Build( positions, indices, 1 ) );
+
+    AABB3D all = {};
+    all.Reset();
+    for( const auto& p : positions )
+    {
+        all.Update( p );
+    }
+    std::vector<uint32_t> triangles;
+    EXPECT_EQ( qbvh.OverlapAABB( all, triangles ), 300u );
+
+    // 一番奥の三角形だけに当たる半直線
+    auto farX = GetDeepCenter( 299 ).x;
+    RaycastHit hit = {};
+    EXPECT_TRUE( qbvh.Raycast( Vector3( farX, 0.0f, -5.0f ), Vector3( 0.0f, 0.0f, 1.0f ), 10.0f, hit ) );
+    EXPECT_EQ( hit.mId, 299u );
+    EXPECT_TRUE( qbvh.RaycastStackless( Vector3( farX, 0.0f, -5.0f ), Vector3( 0.0f, 0.0f, 1.0f ), 10.0f, hit ) );
+    EXPECT_EQ( hit.mId, 299u );
+}
+
+// 量子化BVHは浮動小数点のBVHと同じ半直線で同じ三角形に当たる
+TEST( BVH, QuantizedMatchesFloat )
+{
+    // ばらまいた三角形
+    std::mt19937 engine( 1 );
+    std::uniform_real_distribution<float> posDist( -50.0f, 50.0f );
+    std::uniform_real_distribution<float> offsetDist( -3.0f, 3.0f );
+    std::vector<Vector3> positions;
+    std::vector<uint32_t> indices;
+    for( uint32_t i = 0; i < 5000; ++i )
+    {
+        auto c = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        for( uint32_t v = 0; v < 3; ++v )
+        {
+            indices.emplace_back( static_cast<uint32_t>( positions.size() ) );
+            positions.emplace_back( c + Vector3( offsetDist( engine ), offsetDist( engine ), offsetDist( engine ) ) );
+        }
+    }
+    TriangleMesh floatMesh;
+    EXPECT_TRUE( floatMesh.Create( positions, indices ) );
+    QuantizedBVH qbvh;
+    EXPECT_TRUE( qbvh.Build( positions, indices ) );
+
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+    uint32_t hitCount = 0;
+    uint32_t mismatchCount = 0;
+    for( uint32_t i = 0; i < 2000; ++i )
+    {
+        auto origin = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) ) * 1.5f;
+        auto dir = Normalize( Vector3( dirDist( engine ), dirDist( engine ), dirDist( engine ) ) + Vector3( 0.0f, 0.01f, 0.0f ) );
+        RaycastHit expected = {};
+        RaycastHit hit = {};
+        RaycastHit stacklessHit = {};
+        auto isHit = floatMesh.Raycast( origin, dir, 200.0f, expected );
+        hitCount += isHit ? 1 : 0;
+        mismatchCount += qbvh.Raycast( origin, dir, 200.0f, hit ) != isHit ? 1 : 0;
+        mismatchCount += qbvh.RaycastStackless( origin, dir, 200.0f, stacklessHit ) != isHit ? 1 : 0;
+        if( isHit )
+        {
+            mismatchCount += hit.mId != expected.mId || hit.mDistance != expected.mDistance ? 1 : 0;
+            mismatchCount += stacklessHit.mId != expected.mId || stacklessHit.mDistance != expected.mDistance ? 1 : 0;
+        }
+    }
+    EXPECT_TRUE( hitCount > 100 );
+    EXPECT_EQ( mismatchCount, 0u );
+}
@@ -0,0 +1,171 @@
+#include <cfloat>
+#include <cmath>
+#include <random>
+
+#include "TestFramework.h"
+#include "collision/Collision.h"
+#include "collision/Heightfield.h"
+
+namespace
+{
+
+// 高さ0の平らな地形
+Heightfield CreateFlat( uint32_t width, uint32_t depth )
+{
+    Heightfield heightfield;
+    std::vector<float> heights( static_cast<size_t>( width ) * depth, 0.0f );
+    heightfield.Create( width, depth, heights, Vector3( 0.0f, 0.0f, 0.0f ), 1.0f );
+    return heightfield;
+}
+
+}  // namespace
+
+// 平らな地形の上を長く掃引しても当たらない(反復回数で打ち切って当たりにしない)
+TEST( Heightfield, LongSweepOverFlatMisses )
+{
+    auto heightfield = CreateFlat( 1100, 8 );
+    Sphere sphere = { Vector3( 10.0f, 1.0f, 4.0f ), 0.5f };
+    RaycastHit hit = {};
+    EXPECT_FALSE( heightfield.SweepSphere( sphere, Vector3( 1.0f, 0.0f, 0.0f ), 1000.0f, hit ) );
+    EXPECT_FALSE( hit.mIsHit );
+
+    Capsule3D capsule = { { Vector3( 10.0f, 1.0f, 3.0f ), Vector3( 10.0f, 1.0f, 5.0f ) }, 0.5f };
+    EXPECT_FALSE( heightfield.SweepCapsule( capsule, Vector3( 1.0f, 0.0f, 0.0f ), 1000.0f, hit ) );
+}
+
+// 無限の距離でも地形の境界を出れば止まる
+TEST( Heightfield, UnboundedSweepTerminates )
+{
+    auto heightfield = CreateFlat( 64, 64 );
+    RaycastHit hit = {};
+    Sphere sphere = { Vector3( 32.0f, 1.0f, 32.0f ), 0.5f };
+    EXPECT_FALSE( heightfield.SweepSphere( sphere, Vector3( 1.0f, 0.0f, 0.0f ), FLT_MAX, hit ) );
+    EXPECT_FALSE( heightfield.SweepSphere( sphere, Vector3( 0.0f, 1.0f, 0.0f ), FLT_MAX, hit ) );
+    EXPECT_TRUE( heightfield.SweepSphere( sphere, Vector3( 0.0f, -1.0f, 0.0f ), FLT_MAX, hit ) );
+}
+
+// 下向きの掃引は地面に触れる距離で当たる
+TEST( Heightfield, DownwardSweepHits )
+{
+    auto heightfield = CreateFlat( 64, 64 );
+    Sphere sphere = { Vector3( 20.3f, 5.0f, 30.6f ), 1.0f };
+    RaycastHit hit = {};
+    EXPECT_TRUE( heightfield.SweepSphere( sphere, Vector3( 0.0f, -1.0f, 0.0f ), 10.0f, hit ) );
+    EXPECT_TRUE( hit.mIsHit );
+    EXPECT_NEAR( hit.mDistance, 4.0f, 2e-3f );
+    EXPECT_NEAR( hit.mNormal.y, 1.0f, 1e-3f );
+    EXPECT_NEAR( hit.mPoint.x, 20.3f, 1e-3f );
+    EXPECT_NEAR( hit.mPoint.z, 30.6f, 1e-3f );
+
+    // 届かない距離なら当たらない
+    EXPECT_FALSE( heightfield.SweepSphere( sphere, Vector3( 0.0f, -1.0f, 0.0f ), 3.5f, hit ) );
+}
+
+// 斜めに進んで斜面に当たる
+TEST( Heightfield, SweepIntoSlopeHits )
+{
+    // xに沿って上る斜面(高さ = x * 0.5)
+    const uint32_t size = 64;
+    std::vector<float> heights( size * size );
+    for( uint32_t z = 0; z < size; ++z )
+    {
+        for( uint32_t x = 0; x < size; ++x )
+        {
+            heights[z * size + x] = x * 0.5f;
+        }
+    }
+    Heightfield heightfield;
+    EXPECT_TRUE( heightfield.Create( size, size, heights, Vector3( 0.0f, 0.0f, 0.0f ), 1.0f ) );
+
+    Sphere sphere = { Vector3( 5.0f, 10.0f, 32.0f ), 1.0f };
+    RaycastHit hit = {};
+    EXPECT_TRUE( heightfield.SweepSphere( sphere, Vector3( 1.0f, 0.0f, 0.0f ), 100.0f, hit ) );
+    // 中心から斜面までの距離が半径になる位置
+    auto center = sphere.mCenter + Vector3( hit.mDistance, 0.0f, 0.0f );
+    auto distance = ( center.y - center.x * 0.5f ) / std::sqrt( 1.25f );
+    EXPECT_NEAR( distance, 1.0f, 2e-3f );
+}
+
+// 半直線の判定は全セルの三角形を総当たりした結果と一致する
+TEST( Heightfield, RaycastMatchesBruteForce )
+{
+    const uint32_t width = 65;
+    const uint32_t depth = 47;
+    std::vector<float> heights( width * depth );
+    for( uint32_t z = 0; z < depth; ++z )
+    {
+        for( uint32_t x = 0; x < width; ++x )
+        {
+            heights[z * width + x] = std::sin( x * 0.3f ) * 3.0f + std::cos( z * 0.2f ) * 2.0f;
+        }
+    }
+    Heightfield heightfield;
+    EXPECT_TRUE( heightfield.Create( width, depth, heights, Vector3( -10.0f, 0.0f, 5.0f ), 0.75f ) );
+    std::vector<Vector3> positions;
+    std::vector<uint32_t> indices;
+    heightfield.GetTriangles( positions, indices );
+
+    std::mt19937 engine( 1 );
+    std::uniform_real_distribution<float> xDist( -20.0f, 50.0f );
+    std::uniform_real_distribution<float> yDist( -8.0f, 12.0f );
+    std::uniform_real_distribution<float> zDist( -5.0f, 45.0f );
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+    uint32_t hitCount = 0;
+    uint32_t mismatchCount = 0;
+    for( uint32_t i = 0; i < 1000; ++i )
+    {
+        auto origin = Vector3( xDist( engine ), yDist( engine ), zDist( engine ) );
+        auto dir = Normalize( Vector3( dirDist( engine ), dirDist( engine ), dirDist( engine ) ) + Vector3( 0.0f, 0.0f, 0.01f ) );
+        const auto maxDist = 60.0f;
+
+        // 総当たり
+        auto expectedT = maxDist;
+        auto expectedHit = false;
+        for( size_t tri = 0; tri < indices.size() / 3; ++tri )
+        {
+            float t = 0.0f;
+            if( IntersectRay( origin, dir, positions[indices[tri * 3 + 0]], positions[indices[tri * 3 + 1]], positions[indices[tri * 3 + 2]], expectedT, t ) )
+            {
+                expectedT = t;
+                expectedHit = true;
+            }
+        }
+
+        RaycastHit hit = {};
+        auto isHit = heightfield.Raycast( origin, dir, maxDist, hit );
+        hitCount += isHit ? 1 : 0;
+        if( isHit != expectedHit || ( isHit && std::fabs( hit.mDistance - expectedT ) > 1e-4f ) )
+        {
+            ++mismatchCount;
+        }
+    }
+    EXPECT_TRUE( hitCount > 100 );
+    EXPECT_EQ( mismatchCount, 0u );
+}
+
+// 地形をなめるように掃引しても反復の上限で止まり、実際の接触より手前で接触とする
+TEST( Heightfield, GrazingSweepIsBounded )
+{
+    // ごくゆるい上り坂(隙間が少しずつしか縮まず、1回に隙間の分しか進めない)
+    const uint32_t width = 1100;
+    const uint32_t depth = 8;
+    const float slope = 1e-5f;
+    std::vector<float> heights( width * depth );
+    for( uint32_t z = 0; z < depth; ++z )
+    {
+        for( uint32_t x = 0; x < width; ++x )
+        {
+            heights[z * width + x] = x * slope;
+        }
+    }
+    Heightfield heightfield;
+    EXPECT_TRUE( heightfield.Create( width, depth, heights, Vector3( 0.0f, 0.0f, 0.0f ), 1.0f ) );
+
+    const float gap = 2e-3f;
+    Sphere sphere = { Vector3( 10.0f, 10.0f * slope + 0.5f + gap, 4.0f ), 0.5f };
+    RaycastHit hit = {};
+    EXPECT_TRUE( heightfield.SweepSphere( sphere, Vector3( 1.0f, 0.0f, 0.0f ), 1000.0f, hit ) );
+    // 坂が隙間の分だけ上がる距離より手前
+    EXPECT_TRUE( hit.mDistance <= gap / slope );
+    EXPECT_TRUE( hit.mPoint.y < 0.01f );
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "TestFramework.h"
+#include "collision/KdTree.h"
+
+namespace
+{
+
+const uint32_t kPointCount = 5000;
+const uint32_t kQueryCount = 100;
+
+// ばらまいた点
+std::vector<Vector3> CreatePoints( uint32_t count, uint32_t seed )
+{
+    std::mt19937 engine( seed );
+    std::uniform_real_distribution<float> posDist( -100.0f, 100.0f );
+    std::vector<Vector3> points( count );
+    for( auto& p : points )
+    {
+        p = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+    }
+    return points;
+}
+
+// 総当たりで近い順にk個
+std::vector<uint32_t> BruteKNearest( const std::vector<Vector3>& points, const Vector3& p, uint32_t k, float maxDist )
+{
+    std::vector<std::pair<float, uint32_t>> sorted;
+    for( uint32_t i = 0; i < static_cast<uint32_t>( points.size() ); ++i )
+    {
+        auto distSq = LengthSq( points[i] - p );
+        if( distSq < maxDist * maxDist ) sorted.emplace_back( distSq, i );
+    }
+    std::sort( sorted.begin(), sorted.end() );
+    std::vector<uint32_t> indices;
+    for( uint32_t i = 0; i < ( std::min )( k, static_cast<uint32_t>( sorted.size() ) ); ++i )
+    {
+        indices.emplace_back( sorted[i].second );
+    }
+    return indices;
+}
+
+// 総当たりで半径内(インデックス順)
+std::vector<uint32_t> BruteInRadius( const std::vector<Vector3>& points, const Vector3& p, float radius )
+{
+    std::vector<uint32_t> indices;
+    for( uint32_t i = 0; i < static_cast<uint32_t>( points.size() ); ++i )
+    {
+        if( LengthSq( points[i] - p ) <= radius * radius ) indices.emplace_back( i );
+    }
+    return indices;
+}
+
+}  // namespace
+
+// 木の深さは中央値分割の深さに収まる
+TEST( KdTree, DepthIsLogarithmic )
+{
+    KdTree tree;
+    EXPECT_TRUE( tree.Build( CreatePoints( kPointCount, 1 ) ) );
+    // 8個以下になるまで半分にする回数 + 葉
+    auto expected = static_cast<uint32_t>( std::ceil( std::log2( kPointCount / 8.0 ) ) ) + 1;
+    EXPECT_TRUE( tree.GetDepth() <= expected );
+
+    // 同じ位置の点ばかりでも深さは変わらない
+    std::vector<Vector3> same( kPointCount, Vector3( 1.0f, 2.0f, 3.0f ) );
+    EXPECT_TRUE( tree.Build( same ) );
+    EXPECT_TRUE( tree.GetDepth() <= expected );
+}
+
+// k近傍は総当たりと同じ点を近い順に返す
+TEST( KdTree, KNearestMatchesBruteForce )
+{
+    auto points = CreatePoints( kPointCount, 2 );
+    KdTree tree;
+    EXPECT_TRUE( tree.Build( points ) );
+
+    auto queries = CreatePoints( kQueryCount, 3 );
+    uint32_t mismatchCount = 0;
+    std::vector<uint32_t> indices;
+    for( const auto& q : queries )
+    {
+        for( uint32_t k : { 1u, 5u, 32u } )
+        {
+            tree.FindKNearest( q, k, indices );
+            mismatchCount += indices == BruteKNearest( points, q, k, FLT_MAX ) ? 0 : 1;
+        }
+        // 最大距離で絞ると足りない分は返さない
+        tree.FindKNearest( q, 32, indices, 15.0f );
+        mismatchCount += indices == BruteKNearest( points, q, 32, 15.0f ) ? 0 : 1;
+
+        auto nearest = tree.FindNearest( q );
+        mismatchCount += nearest == BruteKNearest( points, q, 1, FLT_MAX )[0] ? 0 : 1;
+    }
+    EXPECT_EQ( mismatchCount, 0u );
+}
+
+// 半径内の点は総当たりと同じ集合になる
+TEST( KdTree, InRadiusMatchesBruteForce )
+{
+    auto points = CreatePoints( kPointCount, 4 );
+    KdTree tree;
+    EXPECT_TRUE( tree.Build( points ) );
+
+    auto queries = CreatePoints( kQueryCount, 5 );
+    uint32_t foundTotal = 0;
+    uint32_t mismatchCount = 0;
+    std::vector<uint32_t> indices;
+    for( const auto& q : queries )
+    {
+        for( float radius : { 5.0f, 20.0f } )
+        {
+            indices.clear();
+            auto found = tree.FindInRadius( q, radius, indices );
+            foundTotal += found;
+            std::sort( indices.begin(), indices.end() );
+            mismatchCount += found == indices.size() && indices == BruteInRadius( points, q, radius ) ? 0 : 1;
+        }
+    }
+    EXPECT_TRUE( foundTotal > 0 );
+    EXPECT_EQ( mismatchCount, 0u );
+}
+
+// まとめて探した結果は1つずつ探した結果と一致する
+TEST( KdTree, BatchMatchesSingle )
+{
+    auto points = CreatePoints( kPointCount, 6 );
+    KdTree tree;
+    EXPECT_TRUE( tree.Build( points ) );
+    auto queries = CreatePoints( 1000, 7 );
+
+    std::vector<uint32_t> nearest;
+    tree.FindNearestBatch( queries, nearest );
+    const uint32_t k = 4;
+    std::vector<uint32_t> kNearest;
+    tree.FindKNearestBatch( queries, k, kNearest );
+    std::vector<uint32_t> inRadius;
+    std::vector<uint32_t> offsets;
+    tree.FindInRadiusBatch( queries, 10.0f, inRadius, offsets );
+    EXPECT_EQ( offsets.size(), queries.size() + 1 );
+
+    uint32_t mismatchCount = 0;
+    std::vector<uint32_t> indices;
+    for( uint32_t i = 0; i < static_cast<uint32_t>( queries.size() ); ++i )
+    {
+        mismatchCount += nearest[i] == tree.FindNearest( queries[i] ) ? 0 : 1;
+        tree.FindKNearest( queries[i], k, indices );
+        mismatchCount += std::equal( indices.begin(), indices.end(), kNearest.begin() + i * k ) ? 0 : 1;
+        indices.clear();
+        tree.FindInRadius( queries[i], 10.0f, indices );
+        mismatchCount += std::equal( indices.begin(), indices.end(), inRadius.begin() + offsets[i], inRadius.begin() + offsets[i + 1] ) ? 0 : 1;
+    }
+    EXPECT_EQ( mismatchCount, 0u );
+}
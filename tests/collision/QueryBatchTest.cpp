@@ -0,0 +1,145 @@
+#include <random>
+
+#include "TestFramework.h"
+#include "collision/QueryBatch.h"
+
+namespace
+{
+
+// テスト用のシーン(AABBと球をばらまく)
+void CreateScene( CollisionScene& scene )
+{
+    std::mt19937 engine( 1 );
+    std::uniform_real_distribution<float> posDist( -100.0f, 100.0f );
+    std::uniform_real_distribution<float> sizeDist( 0.5f, 4.0f );
+    for( uint32_t i = 0; i < 1000; ++i )
+    {
+        auto center = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        auto size = sizeDist( engine );
+        if( i % 2 == 0 )
+        {
+            auto extent = Vector3( size, size, size );
+            scene.AddAABB( AABB3D{ center - extent, center + extent }, i );
+        }
+        else
+        {
+            scene.AddSphere( Sphere{ center, size }, i );
+        }
+    }
+    scene.Build();
+}
+
+// 半直線・掃引の結果が一致するか
+bool IsSameHit( const RaycastHit& a, const RaycastHit& b )
+{
+    if( a.mIsHit != b.mIsHit ) return false;
+    if( !a.mIsHit ) return true;
+    return a.mId == b.mId && a.mDistance == b.mDistance;
+}
+
+// 一括実行の結果が1つずつ実行した結果と一致するか
+void CheckMatchesScene( bool isSortEnabled )
+{
+    CollisionScene scene;
+    CreateScene( scene );
+
+    std::mt19937 engine( 2 );
+    std::uniform_real_distribution<float> posDist( -120.0f, 120.0f );
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+    std::uniform_real_distribution<float> radiusDist( 1.0f, 10.0f );
+
+    // 種類を混ぜて追加する
+    const uint32_t queryCount = 2000;
+    std::vector<Vector3> origins( queryCount );
+    std::vector<Vector3> dirs( queryCount );
+    std::vector<float> radii( queryCount );
+    QueryBatch batch;
+    batch.SetSortEnabled( isSortEnabled );
+    for( uint32_t i = 0; i < queryCount; ++i )
+    {
+        origins[i] = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        dirs[i] = Normalize( Vector3( dirDist( engine ), dirDist( engine ), dirDist( engine ) ) + Vector3( 0.0f, 0.0f, 0.01f ) );
+        radii[i] = radiusDist( engine );
+        switch( i % 4 )
+        {
+            case 0: batch.AddRaycast( origins[i], dirs[i], 200.0f ); break;
+            case 1: batch.AddSweepSphere( Sphere{ origins[i], radii[i] }, dirs[i], 200.0f ); break;
+            case 2: batch.AddOverlapSphere( Sphere{ origins[i], radii[i] } ); break;
+            case 3: batch.AddOverlapAABB( AABB3D{ origins[i] - Vector3( radii[i], radii[i], radii[i] ), origins[i] + Vector3( radii[i], radii[i], radii[i] ) } ); break;
+        }
+    }
+    batch.Execute( scene );
+    EXPECT_EQ( batch.GetResults().size(), size_t( queryCount ) );
+
+    uint32_t hitCount = 0;
+    uint32_t overlapCount = 0;
+    uint32_t mismatchCount = 0;
+    std::vector<uint32_t> ids;
+    for( uint32_t i = 0; i < queryCount; ++i )
+    {
+        const auto& result = batch.GetResult( i );
+        RaycastHit hit = {};
+        ids.clear();
+        // 追加時と同じく正規化し直した向きで判定する
+        auto dir = Normalize( dirs[i] );
+        switch( i % 4 )
+        {
+            case 0: scene.Raycast( origins[i], dir, 200.0f, hit ); break;
+            case 1: scene.SweepSphere( Sphere{ origins[i], radii[i] }, dir, 200.0f, hit ); break;
+            case 2: scene.OverlapSphere( Sphere{ origins[i], radii[i] }, ids ); break;
+            case 3: scene.OverlapAABB( AABB3D{ origins[i] - Vector3( radii[i], radii[i], radii[i] ), origins[i] + Vector3( radii[i], radii[i], radii[i] ) }, ids ); break;
+        }
+        if( i % 4 < 2 )
+        {
+            hitCount += hit.mIsHit ? 1 : 0;
+            mismatchCount += IsSameHit( result.mHit, hit ) ? 0 : 1;
+        }
+        else
+        {
+            overlapCount += result.mOverlapCount;
+            std::vector<uint32_t> batchIds(
+                batch.GetOverlapIds().begin() + result.mOverlapOffset,
+                batch.GetOverlapIds().begin() + result.mOverlapOffset + result.mOverlapCount );
+            mismatchCount += batchIds == ids ? 0 : 1;
+        }
+    }
+    EXPECT_TRUE( hitCount > 0 );
+    EXPECT_TRUE( overlapCount > 0 );
+    EXPECT_EQ( mismatchCount, uint32_t( 0 ) );
+}
+
+}  // namespace
+
+// 空間順に並べ替えても結果は追加順で1つずつ実行したものと一致する
+TEST( QueryBatch, SortedMatchesScene )
+{
+    CheckMatchesScene( true );
+}
+
+// 並べ替えなしでも結果は1つずつ実行したものと一致する
+TEST( QueryBatch, UnsortedMatchesScene )
+{
+    CheckMatchesScene( false );
+}
+
+// クリアすると結果も空になり、再度実行できる
+TEST( QueryBatch, ClearAndReuse )
+{
+    CollisionScene scene;
+    CreateScene( scene );
+
+    QueryBatch batch;
+    batch.AddOverlapSphere( Sphere{ Vector3( 0.0f, 0.0f, 0.0f ), 50.0f } );
+    batch.Execute( scene );
+    auto firstCount = batch.GetResult( 0 ).mOverlapCount;
+    EXPECT_TRUE( firstCount > 0 );
+
+    batch.Clear();
+    EXPECT_EQ( batch.GetQueryCount(), uint32_t( 0 ) );
+    EXPECT_TRUE( batch.GetOverlapIds().empty() );
+
+    batch.AddOverlapSphere( Sphere{ Vector3( 0.0f, 0.0f, 0.0f ), 50.0f } );
+    batch.Execute( scene );
+    EXPECT_EQ( batch.GetResult( 0 ).mOverlapCount, firstCount );
+    EXPECT_EQ( batch.GetOverlapIds().size(), size_t( firstCount ) );
+}
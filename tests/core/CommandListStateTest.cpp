@@ -0,0 +1,136 @@
+#include "TestFramework.h"
+#include "core/CommandListState.h"
+
+namespace
+{
+
+// ダミーのオブジェクト(アドレスだけを比べる)
+const int kRootSignatureA = 0;
+const int kRootSignatureB = 0;
+const int kHeapA = 0;
+const int kHeapB = 0;
+
+// 種類ごとの数を取得
+uint32_t GetCount( const std::array<uint32_t, static_cast<size_t>( CommandListState::Category::Count )>& counts, CommandListState::Category category )
+{
+    return counts[static_cast<size_t>( category )];
+}
+
+}  // namespace
+
+// 同じルートパラメータの値を2回セットすると2回目を捨てる
+TEST( CommandListState, FiltersSameRootArgument )
+{
+    CommandListState state;
+    EXPECT_TRUE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_FALSE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x2000 ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 1, 0x2000 ) );
+
+    // グラフィックスとコンピュートは別に覚える
+    EXPECT_TRUE( state.SetComputeRootArgument( 0, 0x2000 ) );
+
+    const auto& counters = state.GetCounters();
+    EXPECT_EQ( GetCount( counters.mIssued, CommandListState::Category::RootArgument ), 4u );
+    EXPECT_EQ( GetCount( counters.mFiltered, CommandListState::Category::RootArgument ), 1u );
+}
+
+// 同じルートシグネチャならルートパラメータの値を残す
+TEST( CommandListState, SameRootSignatureKeepsArguments )
+{
+    CommandListState state;
+    EXPECT_TRUE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_FALSE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+    EXPECT_FALSE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+}
+
+// 違うルートシグネチャならルートパラメータの値を忘れる
+TEST( CommandListState, RootSignatureChangeDropsArguments )
+{
+    CommandListState state;
+    EXPECT_TRUE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_TRUE( state.SetComputeRootSignature( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetComputeRootArgument( 0, 0x1000 ) );
+
+    EXPECT_TRUE( state.SetGraphicsRootSignature( &kRootSignatureB ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+
+    // コンピュートのルートは変わっていない
+    EXPECT_FALSE( state.SetComputeRootArgument( 0, 0x1000 ) );
+}
+
+// デスクリプタヒープが変わるとルートパラメータの値を忘れる
+TEST( CommandListState, DescriptorHeapChangeDropsArguments )
+{
+    CommandListState state;
+    EXPECT_TRUE( state.SetDescriptorHeap( &kHeapA ) );
+    EXPECT_TRUE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_TRUE( state.SetComputeRootArgument( 0, 0x1000 ) );
+
+    EXPECT_FALSE( state.SetDescriptorHeap( &kHeapA ) );
+    EXPECT_FALSE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+
+    EXPECT_TRUE( state.SetDescriptorHeap( &kHeapB ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_TRUE( state.SetComputeRootArgument( 0, 0x1000 ) );
+
+    // ルートシグネチャは残る
+    EXPECT_FALSE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+}
+
+// リセットで呼び出しの数を前回の分として残し、ステートを忘れる
+TEST( CommandListState, ResetRollsCounters )
+{
+    CommandListState state;
+    state.SetPipelineState( &kRootSignatureA );
+    state.SetPipelineState( &kRootSignatureA );
+    state.SetPrimitiveTopology( 4 );
+    state.Reset();
+
+    const auto& last = state.GetLastCounters();
+    EXPECT_EQ( GetCount( last.mIssued, CommandListState::Category::PipelineState ), 1u );
+    EXPECT_EQ( GetCount( last.mFiltered, CommandListState::Category::PipelineState ), 1u );
+    EXPECT_EQ( GetCount( last.mIssued, CommandListState::Category::PrimitiveTopology ), 1u );
+
+    const auto& counters = state.GetCounters();
+    EXPECT_EQ( GetCount( counters.mIssued, CommandListState::Category::PipelineState ), 0u );
+    EXPECT_EQ( GetCount( counters.mFiltered, CommandListState::Category::PipelineState ), 0u );
+
+    EXPECT_TRUE( state.SetPipelineState( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetPrimitiveTopology( 4 ) );
+
+    state.Reset();
+    EXPECT_EQ( GetCount( state.GetLastCounters().mIssued, CommandListState::Category::PipelineState ), 1u );
+    EXPECT_EQ( GetCount( state.GetLastCounters().mFiltered, CommandListState::Category::PipelineState ), 0u );
+}
+
+// 無効なら同じステートでも捨てない
+TEST( CommandListState, DisabledNeverFilters )
+{
+    CommandListState state;
+    state.SetEnabled( false );
+    EXPECT_TRUE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetGraphicsRootSignature( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_TRUE( state.SetGraphicsRootArgument( 0, 0x1000 ) );
+    EXPECT_TRUE( state.SetPipelineState( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetPipelineState( &kRootSignatureA ) );
+    EXPECT_TRUE( state.SetVertexBuffer( 0x1000, 64, 16 ) );
+    EXPECT_TRUE( state.SetVertexBuffer( 0x1000, 64, 16 ) );
+    EXPECT_TRUE( state.SetDescriptorHeap( &kHeapA ) );
+    EXPECT_TRUE( state.SetDescriptorHeap( &kHeapA ) );
+
+    const auto& counters = state.GetCounters();
+    for( size_t i = 0; i < counters.mFiltered.size(); ++i )
+    {
+        EXPECT_EQ( counters.mFiltered[i], 0u );
+    }
+
+    // 有効に戻せば覚えていたステートで捨てる
+    state.SetEnabled( true );
+    EXPECT_FALSE( state.SetPipelineState( &kRootSignatureA ) );
+}
@@ -0,0 +1,138 @@
+#include "TestFramework.h"
+#include "core/ParallelRecorder.h"
+
+namespace
+{
+
+// 呼び出しを覚える記録先
+struct Recording
+{
+    std::vector<ParallelRecorder::Chunk> mChunks;
+    std::vector<uint32_t> mRecordCounts;
+    std::vector<uint32_t> mOrder;
+    uint32_t mSubmitCount = 0;
+};
+
+// 呼び出しを覚えながら記録する
+uint32_t RecordWith( ParallelRecorder& recorder, uint32_t count, uint32_t contextCount, Recording& recording )
+{
+    // 記録先ごとに別の要素へ書くので、ワーカーから呼ばれても取り合わない
+    recording.mChunks.assign( contextCount, ParallelRecorder::Chunk{ UINT32_MAX, 0 } );
+    recording.mRecordCounts.assign( contextCount, 0 );
+    return recorder.Record(
+        count,
+        contextCount,
+        [&]( uint32_t contextIdx, uint32_t first, uint32_t chunkSize )
+        {
+            recording.mChunks[contextIdx] = ParallelRecorder::Chunk{ first, chunkSize };
+            ++recording.mRecordCounts[contextIdx];
+        },
+        [&]( std::span<const uint32_t> contextOrder )
+        {
+            recording.mOrder.assign( contextOrder.begin(), contextOrder.end() );
+            ++recording.mSubmitCount;
+        } );
+}
+
+// チャンクを (先頭, 数) の並びで比べる
+bool IsChunks( const std::vector<ParallelRecorder::Chunk>& chunks, std::initializer_list<ParallelRecorder::Chunk> expected )
+{
+    if( chunks.size() != expected.size() ) return false;
+
+    size_t i = 0;
+    for( const auto& chunk : expected )
+    {
+        if( chunks[i].mFirst != chunk.mFirst || chunks[i].mCount != chunk.mCount ) return false;
+        ++i;
+    }
+    return true;
+}
+
+}  // namespace
+
+// 連続したチャンクに分け、割り切れない分は前のチャンクを多くする
+TEST( ParallelRecorder, SplitIsContiguous )
+{
+    std::vector<ParallelRecorder::Chunk> chunks;
+    ParallelRecorder::Split( 10, 4, chunks );
+    EXPECT_TRUE( IsChunks( chunks, { { 0, 3 }, { 3, 3 }, { 6, 2 }, { 8, 2 } } ) );
+
+    ParallelRecorder::Split( 8, 4, chunks );
+    EXPECT_TRUE( IsChunks( chunks, { { 0, 2 }, { 2, 2 }, { 4, 2 }, { 6, 2 } } ) );
+
+    ParallelRecorder::Split( 10, 1, chunks );
+    EXPECT_TRUE( IsChunks( chunks, { { 0, 10 } } ) );
+
+    ParallelRecorder::Split( 10, 0, chunks );
+    EXPECT_TRUE( chunks.empty() );
+}
+
+// チャンク数は最小の数と最大のチャンク数と記録先の数で決まる
+TEST( ParallelRecorder, ChunkCountIsClamped )
+{
+    ParallelRecorder recorder;
+    recorder.SetMinChunkSize( 100 );
+    EXPECT_EQ( recorder.GetChunkCount( 1000, 4 ), 4u );
+    EXPECT_EQ( recorder.GetChunkCount( 250, 4 ), 3u );
+    EXPECT_EQ( recorder.GetChunkCount( 50, 4 ), 1u );
+    EXPECT_EQ( recorder.GetChunkCount( 0, 4 ), 0u );
+    EXPECT_EQ( recorder.GetChunkCount( 1000, 0 ), 0u );
+
+    // 最大のチャンク数は記録先の数を超えない
+    recorder.SetMaxChunks( 2 );
+    EXPECT_EQ( recorder.GetChunkCount( 1000, 4 ), 2u );
+    recorder.SetMaxChunks( 16 );
+    EXPECT_EQ( recorder.GetChunkCount( 1000, 4 ), 4u );
+    recorder.SetMaxChunks( 0 );
+    EXPECT_EQ( recorder.GetChunkCount( 1000, 8 ), 8u );
+
+    // 最小の数は1より小さくしない
+    recorder.SetMinChunkSize( 0 );
+    EXPECT_EQ( recorder.GetMinChunkSize(), 1u );
+    EXPECT_EQ( recorder.GetChunkCount( 3, 8 ), 3u );
+}
+
+// 記録先がなければ何も呼ばない
+TEST( ParallelRecorder, NoContextsRecordsNothing )
+{
+    ParallelRecorder recorder;
+    recorder.SetMinChunkSize( 1 );
+    Recording recording;
+    EXPECT_EQ( RecordWith( recorder, 10, 0, recording ), 0u );
+    EXPECT_EQ( recording.mSubmitCount, 0u );
+    EXPECT_TRUE( recorder.GetChunks().empty() );
+
+    EXPECT_EQ( RecordWith( recorder, 0, 4, recording ), 0u );
+    EXPECT_EQ( recording.mSubmitCount, 0u );
+}
+
+// 記録先ごとに1チャンクを記録し、チャンクの順に提出する
+TEST( ParallelRecorder, SubmitsInChunkOrder )
+{
+    ParallelRecorder recorder;
+    recorder.SetMinChunkSize( 1 );
+    Recording recording;
+    EXPECT_EQ( RecordWith( recorder, 10, 4, recording ), 4u );
+    EXPECT_TRUE( IsChunks( recording.mChunks, { { 0, 3 }, { 3, 3 }, { 6, 2 }, { 8, 2 } } ) );
+    EXPECT_EQ( recording.mSubmitCount, 1u );
+    EXPECT_EQ( recording.mOrder.size(), size_t( 4 ) );
+
+    // 提出順に並べた記録先のチャンクが元の範囲を先頭から埋める
+    uint32_t next = 0;
+    for( size_t i = 0; i < recording.mOrder.size(); ++i )
+    {
+        auto contextIdx = recording.mOrder[i];
+        EXPECT_EQ( recording.mRecordCounts[contextIdx], 1u );
+        EXPECT_EQ( recording.mChunks[contextIdx].mFirst, next );
+        next += recording.mChunks[contextIdx].mCount;
+    }
+    EXPECT_EQ( next, 10u );
+
+    // チャンクが1つでも同じように呼ぶ
+    recorder.SetMaxChunks( 1 );
+    EXPECT_EQ( RecordWith( recorder, 10, 4, recording ), 1u );
+    EXPECT_TRUE( IsChunks( recorder.GetChunks(), { { 0, 10 } } ) );
+    EXPECT_EQ( recording.mRecordCounts[0], 1u );
+    EXPECT_EQ( recording.mSubmitCount, 2u );
+    EXPECT_EQ( recording.mOrder.size(), size_t( 1 ) );
+}
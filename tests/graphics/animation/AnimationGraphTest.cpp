@@ -0,0 +1,133 @@
+#include <cmath>
+
+#include "TestFramework.h"
+#include "graphics/animation/AnimationGraphBatch.h"
+
+namespace
+{
+
+const uint32_t kNodeCount = 4;
+const uint32_t kCharacterCount = 37;
+const uint32_t kFrames = 30;
+const float kDeltaTime = 1.0f / 60.0f;
+
+// 一列につないだノード
+void CreateChain( NodeHierarchy& nodes )
+{
+    for( uint32_t i = 0; i < kNodeCount; ++i )
+    {
+        auto parent = i == 0 ? NodeHierarchy::kInvalidIndex : static_cast<int32_t>( i - 1 );
+        nodes.AddNode( "node", parent, Vector3( 1.0f, 1.0f, 1.0f ), Quaternion(), Vector3( 0.0f, 1.0f, 0.0f ) );
+    }
+}
+
+// 全てのノードを揺らすクリップ
+void CreateClip( const NodeHierarchy& nodes, float axisX, CompressedAnimationClip& compressed )
+{
+    std::vector<AnimationChannel> channels;
+    for( uint32_t i = 0; i < kNodeCount; ++i )
+    {
+        AnimationChannel channel = {};
+        channel.mNodeIdx = static_cast<int32_t>( i );
+        auto axis = Normalize( Vector3( axisX, 1.0f, 0.5f ) );
+        for( uint32_t k = 0; k <= 10; ++k )
+        {
+            auto time = k * 0.1f;
+            channel.mPositionTimes.emplace_back( time );
+            channel.mPositions.emplace_back( Vector3( 0.0f, 1.0f, 0.0f ) );
+            channel.mRotationTimes.emplace_back( time );
+            channel.mRotations.emplace_back( Quaternion( axis, 0.5f * std::sin( MathUtil::kTwoPi * time + i ) ) );
+        }
+        channels.emplace_back( std::move( channel ) );
+    }
+    AnimationClip clip;
+    clip.Create( "test", 1.0f, std::move( channels ) );
+    compressed.Create( clip, nodes );
+}
+
+/// <summary>
+/// 同じグラフを持つキャラクターの集まり
+/// </summary>
+struct Crowd
+{
+    std::vector<AnimationGraph> mGraphs;
+    std::vector<NodePose> mPoses;
+    std::vector<uint32_t> mBlendParams;
+    AnimationGraphBatch mBatch;
+
+    // ブレンドと加算のグラフを作る
+    Crowd( const NodeHierarchy& nodes, const CompressedAnimationClip* clips )
+        : mGraphs( kCharacterCount )
+        , mPoses( kCharacterCount )
+        , mBlendParams( kCharacterCount )
+        , mBatch()
+    {
+        for( uint32_t i = 0; i < kCharacterCount; ++i )
+        {
+            auto& graph = mGraphs[i];
+            graph.Create( &nodes );
+            mBlendParams[i] = graph.AddParameter( 0.0f );
+            auto additiveParam = graph.AddParameter( 0.5f );
+            auto speed = 0.8f + 0.01f * i;
+            auto blend = graph.AddBlend1D( mBlendParams[i], { graph.AddClip( &clips[0], speed ), graph.AddClip( &clips[1], speed ) }, { 0.0f, 1.0f } );
+            graph.AddAdditive( blend, graph.AddClip( &clips[1], speed * 1.5f ), additiveParam );
+            nodes.CreatePose( mPoses[i] );
+            mBatch.Add( &graph, &mPoses[i] );
+        }
+    }
+
+    // パラメータを変えて1フレーム進める
+    void Step( uint32_t frame, bool isParallel )
+    {
+        for( uint32_t i = 0; i < kCharacterCount; ++i )
+        {
+            mGraphs[i].SetParameter( mBlendParams[i], 0.5f + 0.5f * std::sin( frame * 0.1f + i ) );
+        }
+        mBatch.Execute( kDeltaTime, isParallel );
+    }
+};
+
+}  // namespace
+
+// 並列に評価しても1つずつ評価した結果と同じで、有限の値になる
+TEST( AnimationGraph, ParallelBatchMatchesSerial )
+{
+    NodeHierarchy nodes;
+    CreateChain( nodes );
+    CompressedAnimationClip clips[2];
+    CreateClip( nodes, 0.0f, clips[0] );
+    CreateClip( nodes, 1.0f, clips[1] );
+
+    Crowd serial( nodes, clips );
+    Crowd parallel( nodes, clips );
+    for( uint32_t frame = 0; frame < kFrames; ++frame )
+    {
+        serial.Step( frame, false );
+        parallel.Step( frame, true );
+    }
+
+    auto isSame = true;
+    auto isFinite = true;
+    for( uint32_t i = 0; i < kCharacterCount; ++i )
+    {
+        for( uint32_t n = 0; n < kNodeCount; ++n )
+        {
+            const auto& a = serial.mPoses[i].mModelMats[n];
+            const auto& b = parallel.mPoses[i].mModelMats[n];
+            for( uint32_t r = 0; r < 4; ++r )
+            {
+                for( uint32_t c = 0; c < 4; ++c )
+                {
+                    isSame &= a.m[r][c] == b.m[r][c];
+                    isFinite &= std::isfinite( b.m[r][c] );
+                }
+            }
+        }
+    }
+    EXPECT_TRUE( isSame );
+    EXPECT_TRUE( isFinite );
+
+    // 根元から先端まで動いている
+    const auto& tip = serial.mPoses[0].mModelMats[kNodeCount - 1];
+    EXPECT_TRUE( std::abs( tip.m[3][0] ) + std::abs( tip.m[3][2] ) > 1e-3f );
+}
@@ -0,0 +1,72 @@
+#include "TestFramework.h"
+#include "graphics/animation/AnimationSampler.h"
+
+namespace
+{
+
+// 1ノードを動かすクリップ(座標は0秒から1秒ごとに x = 0, 10, 20, 30)
+AnimationClip CreateClip()
+{
+    AnimationChannel channel = {};
+    channel.mNodeIdx = 0;
+    channel.mPositionTimes = { 0.0f, 1.0f, 2.0f, 3.0f };
+    channel.mPositions = { Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 10.0f, 0.0f, 0.0f ), Vector3( 20.0f, 0.0f, 0.0f ), Vector3( 30.0f, 0.0f, 0.0f ) };
+    channel.mRotationTimes = { 0.0f, 3.0f };
+    channel.mRotations = { Quaternion(), Quaternion( Vector3( 0.0f, 1.0f, 0.0f ), MathUtil::kPi * 0.5f ) };
+
+    std::vector<AnimationChannel> channels;
+    channels.emplace_back( std::move( channel ) );
+    AnimationClip clip;
+    clip.Create( "test", 3.0f, std::move( channels ) );
+    return clip;
+}
+
+}  // namespace
+
+// キーの間を補間し、範囲外は端のキーになる
+TEST( AnimationSampler, InterpolatesKeys )
+{
+    auto clip = CreateClip();
+    NodeHierarchy nodes;
+    nodes.AddNode( "root", NodeHierarchy::kInvalidIndex, Vector3( 1.0f, 1.0f, 1.0f ), Quaternion(), Vector3( 0.0f, 0.0f, 0.0f ) );
+    NodePose pose;
+    nodes.CreatePose( pose );
+
+    AnimationSampler sampler;
+    sampler.SetClip( &clip );
+    sampler.Sample( 1.25f, pose );
+    EXPECT_NEAR( pose.mTranslates[0].x, 12.5f, 1e-4f );
+    EXPECT_TRUE( pose.mIsDirty[0] != 0 );
+
+    sampler.Sample( 5.0f, pose );
+    EXPECT_NEAR( pose.mTranslates[0].x, 30.0f, 1e-4f );
+    EXPECT_NEAR( GetRotate( pose.mRotates[0] ), MathUtil::kPi * 0.5f, 1e-3f );
+}
+
+// 順再生で進めた結果と、戻ってから求めた結果が同じ
+TEST( AnimationSampler, SeekMatchesSequential )
+{
+    auto clip = CreateClip();
+    NodeHierarchy nodes;
+    nodes.AddNode( "root", NodeHierarchy::kInvalidIndex, Vector3( 1.0f, 1.0f, 1.0f ), Quaternion(), Vector3( 0.0f, 0.0f, 0.0f ) );
+    NodePose sequential;
+    NodePose seek;
+    nodes.CreatePose( sequential );
+    nodes.CreatePose( seek );
+
+    AnimationSampler sequentialSampler;
+    sequentialSampler.SetClip( &clip );
+    AnimationSampler seekSampler;
+    seekSampler.SetClip( &clip );
+    for( uint32_t i = 0; i <= 30; ++i )
+    {
+        auto time = i * 0.1f;
+        sequentialSampler.Sample( time, sequential );
+        // 一度終端まで進めてから戻る
+        seekSampler.Sample( 3.0f, seek );
+        seekSampler.Sample( time, seek );
+        EXPECT_NEAR( sequential.mTranslates[0].x, seek.mTranslates[0].x, 1e-5f );
+        EXPECT_NEAR( sequential.mTranslates[0].x, time * 10.0f, 1e-3f );
+        EXPECT_NEAR( Dot( sequential.mRotates[0], seek.mRotates[0] ), 1.0f, 1e-5f );
+    }
+}
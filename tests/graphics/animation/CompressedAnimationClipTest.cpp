@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "TestFramework.h"
+#include "graphics/animation/AnimationSampler.h"
+#include "graphics/animation/CompressedAnimationClip.h"
+
+namespace
+{
+
+// 回転の誤差の上限(残りの3成分を±1/√2の範囲で15bitに量子化した分)
+const float kRotationErrorBound = 2e-4f;
+
+// 回転の差(角度、符号の反転は同じ回転とみなす)
+// 小さい角度をacosで求めると精度が足りないので、差の弦の長さから求める
+float GetAngle( const Quaternion& a, const Quaternion& b )
+{
+    auto s = Dot( a, b ) < 0.0f ? -1.0f : 1.0f;
+    auto dw = a.w - b.w * s;
+    auto dx = a.x - b.x * s;
+    auto dy = a.y - b.y * s;
+    auto dz = a.z - b.z * s;
+    auto chord = std::sqrt( dw * dw + dx * dx + dy * dy + dz * dz );
+    return 4.0f * std::asin( ( std::min )( chord * 0.5f, 1.0f ) );
+}
+
+// ランダムな回転
+Quaternion RandomRotation( std::mt19937& engine )
+{
+    std::uniform_real_distribution<float> dist( -1.0f, 1.0f );
+    Quaternion q( dist( engine ), dist( engine ), dist( engine ), dist( engine ) );
+    q.Normalize();
+    return q;
+}
+
+// 1ノードのクリップ(座標・回転・スケールがなめらかに動き、後半は直線になる)
+// 動きの速さは座標が最大 kMaxSpeed、回転が最大 kMaxAngularSpeed
+const float kMaxSpeed = 80.0f;
+const float kMaxAngularSpeed = 4.0f;
+AnimationClip CreateClip( uint32_t keyCount, float duration )
+{
+    AnimationChannel channel = {};
+    channel.mNodeIdx = 0;
+    auto half = duration * 0.5f;
+    for( uint32_t i = 0; i < keyCount; ++i )
+    {
+        auto t = duration * i / ( keyCount - 1 );
+        // 前半は曲線、後半は直線(間引ける)
+        auto s = t < half ? std::sin( t * 2.0f ) : std::sin( half * 2.0f ) + ( t - half ) * 0.5f;
+        channel.mPositionTimes.emplace_back( t );
+        channel.mPositions.emplace_back( Vector3( s * 40.0f, t * 3.0f, -20.0f + std::cos( t ) * 5.0f ) );
+        channel.mRotationTimes.emplace_back( t );
+        channel.mRotations.emplace_back( Quaternion( Normalize( Vector3( 0.2f, 1.0f, 0.1f ) ), s * 2.0f ) );
+        channel.mScaleTimes.emplace_back( t );
+        channel.mScales.emplace_back( Vector3( 1.0f + s * 0.2f, 1.0f, 1.0f - s * 0.1f ) );
+    }
+    std::vector<AnimationChannel> channels;
+    channels.emplace_back( std::move( channel ) );
+    AnimationClip clip;
+    clip.Create( "test", duration, std::move( channels ) );
+    return clip;
+}
+
+// 1ノードの階層
+NodeHierarchy CreateNodes()
+{
+    NodeHierarchy nodes;
+    nodes.AddNode( "root", NodeHierarchy::kInvalidIndex, Vector3( 1.0f, 1.0f, 1.0f ), Quaternion(), Vector3( 0.0f, 0.0f, 0.0f ) );
+    return nodes;
+}
+
+}  // namespace
+
+// 回転は最大成分を省いた15bitずつから誤差の上限以内で復元できる
+TEST( CompressedAnimationClip, RotationRoundTrip )
+{
+    std::mt19937 engine( 1 );
+    auto maxError = 0.0f;
+    for( uint32_t i = 0; i < 10000; ++i )
+    {
+        auto q = RandomRotation( engine );
+        uint16_t bits[CompressedAnimationClip::kValueStride];
+        CompressedAnimationClip::EncodeRotation( q, bits );
+        auto decoded = CompressedAnimationClip::DecodeRotation( bits );
+        maxError = ( std::max )( maxError, GetAngle( q, decoded ) );
+        // 正規化済みで復元される
+        EXPECT_NEAR( Dot( decoded, decoded ), 1.0f, 1e-4f );
+    }
+    EXPECT_NEAR( maxError, 0.0f, kRotationErrorBound );
+}
+
+// 最大成分が負の回転は符号を反転して復元されるが、同じ回転を表す
+TEST( CompressedAnimationClip, RotationSignFlip )
+{
+    std::mt19937 engine( 2 );
+    for( uint32_t i = 0; i < 1000; ++i )
+    {
+        auto q = RandomRotation( engine );
+        Quaternion negated( -q.w, -q.x, -q.y, -q.z );
+        uint16_t bits[CompressedAnimationClip::kValueStride];
+        uint16_t negatedBits[CompressedAnimationClip::kValueStride];
+        CompressedAnimationClip::EncodeRotation( q, bits );
+        CompressedAnimationClip::EncodeRotation( negated, negatedBits );
+        // 向きをそろえるので、どちらも同じビットになる
+        EXPECT_TRUE( std::equal( bits, bits + CompressedAnimationClip::kValueStride, negatedBits ) );
+
+        // 最大成分は正で復元され、負だった方とは内積が負になる
+        auto decoded = CompressedAnimationClip::DecodeRotation( negatedBits );
+        float c[4] = { negated.w, negated.x, negated.y, negated.z };
+        auto largest = *std::max_element( c, c + 4, []( float a, float b ) { return std::abs( a ) < std::abs( b ); } );
+        if( largest < 0.0f )
+        {
+            EXPECT_TRUE( Dot( decoded, negated ) < 0.0f );
+        }
+        EXPECT_TRUE( GetAngle( negated, decoded ) < kRotationErrorBound );
+    }
+
+    // 最大成分が複数あっても(±1/√2の端)復元できる
+    auto edge = Quaternion( -0.70710678f, 0.70710678f, 0.0f, 0.0f );
+    uint16_t bits[CompressedAnimationClip::kValueStride];
+    CompressedAnimationClip::EncodeRotation( edge, bits );
+    EXPECT_TRUE( GetAngle( edge, CompressedAnimationClip::DecodeRotation( bits ) ) < kRotationErrorBound );
+}
+
+// 座標・スケールはトラックの範囲で16bitに量子化され、キーの時刻では範囲/65535の半分以内で再現する
+TEST( CompressedAnimationClip, Vector3RangeQuantization )
+{
+    // キーの時刻がちょうど量子化した時間に乗る長さ(65535 / 3 = 21845)
+    AnimationChannel channel = {};
+    channel.mNodeIdx = 0;
+    std::mt19937 engine( 3 );
+    std::uniform_real_distribution<float> dist( -50.0f, 120.0f );
+    for( uint32_t i = 0; i < 4; ++i )
+    {
+        channel.mPositionTimes.emplace_back( static_cast<float>( i ) );
+        channel.mPositions.emplace_back( Vector3( dist( engine ), dist( engine ) * 0.01f, dist( engine ) ) );
+        channel.mScaleTimes.emplace_back( static_cast<float>( i ) );
+        channel.mScales.emplace_back( Vector3( 1.0f + i * 0.25f, 1.0f, 2.0f - i * 0.5f ) );
+    }
+    auto srcPositions = channel.mPositions;
+    auto srcScales = channel.mScales;
+    std::vector<AnimationChannel> channels;
+    channels.emplace_back( std::move( channel ) );
+    AnimationClip clip;
+    clip.Create( "test", 3.0f, std::move( channels ) );
+
+    // 間引かない
+    AnimationCompressionSettings settings = {};
+    settings.mTolerance = 0.0f;
+    CompressedAnimationClip compressed;
+    EXPECT_TRUE( compressed.Create( clip, CreateNodes(), settings ) );
+    const auto& track = compressed.GetChannels()[0];
+    EXPECT_EQ( track.mPosition.mKeyCount, uint16_t( 4 ) );
+
+    auto check = [&]( const CompressedAnimationClip::Track& t, const std::vector<Vector3>& values )
+    {
+        auto min = values[0];
+        auto max = values[0];
+        for( const auto& v : values )
+        {
+            min = Vector3( ( std::min )( min.x, v.x ), ( std::min )( min.y, v.y ), ( std::min )( min.z, v.z ) );
+            max = Vector3( ( std::max )( max.x, v.x ), ( std::max )( max.y, v.y ), ( std::max )( max.z, v.z ) );
+        }
+        auto bound = ( max - min ) * ( 0.5f / 65535.0f ) + Vector3( 1e-5f, 1e-5f, 1e-5f );
+        uint32_t cursor = 0;
+        for( uint32_t i = 0; i < 4; ++i )
+        {
+            auto v = compressed.SampleVector3( t, static_cast<float>( i ), cursor );
+            EXPECT_TRUE( std::abs( v.x - values[i].x ) <= bound.x );
+            EXPECT_TRUE( std::abs( v.y - values[i].y ) <= bound.y );
+            EXPECT_TRUE( std::abs( v.z - values[i].z ) <= bound.z );
+        }
+    };
+    check( track.mPosition, srcPositions );
+    check( track.mScale, srcScales );
+}
+
+// 間引いたクリップは元のクリップとの差が許容誤差(と量子化の誤差)以内に収まる
+TEST( CompressedAnimationClip, ReducedKeysStayWithinTolerance )
+{
+    const float duration = 4.0f;
+    auto clip = CreateClip( 121, duration );
+    auto nodes = CreateNodes();
+    AnimationCompressionSettings settings = {};
+    settings.mTolerance = 0.05f;
+    CompressedAnimationClip compressed;
+    EXPECT_TRUE( compressed.Create( clip, nodes, settings ) );
+    // 直線の後半が間引かれる
+    EXPECT_TRUE( compressed.GetKeyCount() < 121u * 3u / 2u );
+
+    NodePose expected;
+    NodePose actual;
+    nodes.CreatePose( expected );
+    nodes.CreatePose( actual );
+    AnimationSampler srcSampler;
+    srcSampler.SetClip( &clip );
+    AnimationSampler compressedSampler;
+    compressedSampler.SetClip( &compressed );
+
+    // キーの時間は長さ/65535に量子化されるので、その半分だけずれた分の動きと値の量子化の誤差を見込む
+    auto timeError = duration * 0.5f / 65535.0f;
+    auto positionBound = settings.mTolerance + kMaxSpeed * timeError + 2e-3f;
+    // ボーンの長さは最小の長さ(1)なので、回転の許容誤差は角度でそのまま
+    auto rotationBound = settings.mTolerance / settings.mMinBoneLength + kMaxAngularSpeed * timeError + kRotationErrorBound;
+    auto maxPositionError = 0.0f;
+    auto maxRotationError = 0.0f;
+    auto maxScaleError = 0.0f;
+    for( uint32_t i = 0; i <= 1000; ++i )
+    {
+        auto time = duration * i / 1000.0f;
+        srcSampler.Sample( time, expected );
+        compressedSampler.Sample( time, actual );
+        maxPositionError = ( std::max )( maxPositionError, Length( expected.mTranslates[0] - actual.mTranslates[0] ) );
+        maxRotationError = ( std::max )( maxRotationError, GetAngle( expected.mRotates[0], actual.mRotates[0] ) );
+        maxScaleError = ( std::max )( maxScaleError, Length( expected.mScales[0] - actual.mScales[0] ) );
+    }
+    EXPECT_NEAR( maxPositionError, 0.0f, positionBound );
+    EXPECT_NEAR( maxRotationError, 0.0f, rotationBound );
+    EXPECT_NEAR( maxScaleError, 0.0f, positionBound );
+}
@@ -0,0 +1,144 @@
+#include <random>
+
+#include "TestFramework.h"
+#include "graphics/animation/Skinning.h"
+
+namespace
+{
+
+// テスト用のランダムなスキン
+struct TestSkin
+{
+    std::vector<MeshVertex> mVertices;
+    std::vector<SkinInfluence> mInfluences;
+    std::vector<Matrix4> mSkinMats;
+};
+
+TestSkin CreateRandomSkin( uint32_t vertexCount, uint32_t boneCount )
+{
+    std::mt19937 engine( 7 );
+    std::uniform_real_distribution<float> posDist( -2.0f, 2.0f );
+    std::uniform_real_distribution<float> angleDist( -MathUtil::kPi, MathUtil::kPi );
+    std::uniform_real_distribution<float> weightDist( 0.0f, 1.0f );
+    std::uniform_int_distribution<uint32_t> boneDist( 0, boneCount - 1 );
+    std::uniform_int_distribution<uint32_t> countDist( 0, 6 );
+
+    TestSkin skin;
+    skin.mSkinMats.resize( boneCount );
+    for( auto& mat : skin.mSkinMats )
+    {
+        auto axis = Normalize( Vector3( posDist( engine ), posDist( engine ), posDist( engine ) ) + Vector3( 0.0f, 0.1f, 0.0f ) );
+        mat = CreateAffine( Vector3( 1.0f, 1.0f, 1.0f ), Quaternion( axis, angleDist( engine ) ), Vector3( posDist( engine ), posDist( engine ), posDist( engine ) ) );
+    }
+
+    skin.mVertices.resize( vertexCount );
+    skin.mInfluences.assign( vertexCount, SkinInfluence{} );
+    for( uint32_t i = 0; i < vertexCount; ++i )
+    {
+        auto& vertex = skin.mVertices[i];
+        vertex.mPosition = Vector4( posDist( engine ), posDist( engine ), posDist( engine ), 1.0f );
+        vertex.mNormal = Normalize( Vector3( posDist( engine ), posDist( engine ), posDist( engine ) ) );
+        vertex.mUV = Vector2( weightDist( engine ), weightDist( engine ) );
+        // 0本(スキンなし)から4本を超える影響まで混ぜる
+        auto count = countDist( engine );
+        for( uint32_t k = 0; k < count; ++k )
+        {
+            Skinning::AddInfluence( skin.mInfluences[i], static_cast<uint16_t>( boneDist( engine ) ), weightDist( engine ) + 0.01f );
+        }
+    }
+    Skinning::NormalizeInfluences( skin.mInfluences );
+    return skin;
+}
+
+}  // namespace
+
+// 影響は重みの大きい順に4本まで残り、小さいものは捨てられる
+TEST( Skinning, AddInfluenceKeepsTopFour )
+{
+    SkinInfluence influence = {};
+    const float weights[6] = { 0.1f, 0.5f, 0.05f, 0.3f, 0.2f, 0.4f };
+    for( uint16_t bone = 0; bone < 6; ++bone )
+    {
+        Skinning::AddInfluence( influence, bone, weights[bone] );
+    }
+    const uint16_t expectedBones[4] = { 1, 5, 3, 4 };
+    for( uint32_t k = 0; k < Skinning::kMaxInfluences; ++k )
+    {
+        EXPECT_EQ( influence.mBones[k], expectedBones[k] );
+        EXPECT_NEAR( influence.mWeights[k], weights[expectedBones[k]], 0.0f );
+    }
+
+    // 一番小さい重み以下は入らない
+    Skinning::AddInfluence( influence, 9, 0.2f );
+    EXPECT_EQ( influence.mBones[3], uint16_t( 4 ) );
+}
+
+// 正規化すると合計が1になり、影響の無い頂点はそのまま
+TEST( Skinning, NormalizeInfluences )
+{
+    std::vector<SkinInfluence> influences( 3, SkinInfluence{} );
+    Skinning::AddInfluence( influences[0], 2, 3.0f );
+    Skinning::AddInfluence( influences[0], 1, 1.0f );
+    Skinning::AddInfluence( influences[1], 0, 0.25f );
+    Skinning::NormalizeInfluences( influences );
+
+    EXPECT_NEAR( influences[0].mWeights[0], 0.75f, 1e-6f );
+    EXPECT_NEAR( influences[0].mWeights[1], 0.25f, 1e-6f );
+    EXPECT_NEAR( influences[0].mWeights[2], 0.0f, 0.0f );
+    EXPECT_NEAR( influences[1].mWeights[0], 1.0f, 1e-6f );
+    for( auto weight : influences[2].mWeights )
+    {
+        EXPECT_NEAR( weight, 0.0f, 0.0f );
+    }
+}
+
+// SIMD版とスカラー版の結果が一致する
+TEST( Skinning, SimdMatchesScalar )
+{
+    const uint32_t vertexCount = 1000;
+    auto skin = CreateRandomSkin( vertexCount, 16 );
+
+    std::vector<MeshVertex> simd( vertexCount );
+    std::vector<MeshVertex> scalar( vertexCount );
+    AABB3D simdAABB = {};
+    AABB3D scalarAABB = {};
+    Skinning::SkinVertices( skin.mVertices.data(), skin.mInfluences.data(), vertexCount, skin.mSkinMats.data(), simd.data(), simdAABB );
+    Skinning::SkinVerticesScalar( skin.mVertices.data(), skin.mInfluences.data(), vertexCount, skin.mSkinMats.data(), scalar.data(), scalarAABB );
+
+    const float tolerance = 1e-4f;
+    uint32_t mismatch = 0;
+    for( uint32_t i = 0; i < vertexCount; ++i )
+    {
+        auto dp = simd[i].mPosition - scalar[i].mPosition;
+        auto dn = simd[i].mNormal - scalar[i].mNormal;
+        if( std::abs( dp.x ) > tolerance || std::abs( dp.y ) > tolerance || std::abs( dp.z ) > tolerance || std::abs( dp.w ) > tolerance ||
+            std::abs( dn.x ) > tolerance || std::abs( dn.y ) > tolerance || std::abs( dn.z ) > tolerance ||
+            simd[i].mUV.x != scalar[i].mUV.x || simd[i].mUV.y != scalar[i].mUV.y )
+        {
+            ++mismatch;
+        }
+    }
+    EXPECT_EQ( mismatch, 0u );
+    EXPECT_NEAR( simdAABB.mMin.x, scalarAABB.mMin.x, tolerance );
+    EXPECT_NEAR( simdAABB.mMin.y, scalarAABB.mMin.y, tolerance );
+    EXPECT_NEAR( simdAABB.mMin.z, scalarAABB.mMin.z, tolerance );
+    EXPECT_NEAR( simdAABB.mMax.x, scalarAABB.mMax.x, tolerance );
+    EXPECT_NEAR( simdAABB.mMax.y, scalarAABB.mMax.y, tolerance );
+    EXPECT_NEAR( simdAABB.mMax.z, scalarAABB.mMax.z, tolerance );
+}
+
+// 1本のボーンに全部の重みがあれば、その行列を掛けたのと同じ
+TEST( Skinning, SingleBoneMatchesMatrix )
+{
+    auto skin = CreateRandomSkin( 1, 2 );
+    skin.mInfluences[0] = SkinInfluence{};
+    Skinning::AddInfluence( skin.mInfluences[0], 1, 1.0f );
+
+    MeshVertex out = {};
+    AABB3D aabb = {};
+    Skinning::SkinVertices( skin.mVertices.data(), skin.mInfluences.data(), 1, skin.mSkinMats.data(), &out, aabb );
+    auto expected = skin.mVertices[0].mPosition * skin.mSkinMats[1];
+    EXPECT_NEAR( out.mPosition.x, expected.x, 1e-5f );
+    EXPECT_NEAR( out.mPosition.y, expected.y, 1e-5f );
+    EXPECT_NEAR( out.mPosition.z, expected.z, 1e-5f );
+}
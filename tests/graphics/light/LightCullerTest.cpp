@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <random>
+
+#include "TestFramework.h"
+#include "collision/Collision.h"
+#include "graphics/light/LightCuller.h"
+
+namespace
+{
+
+// テスト用の視錐台
+Frustum CreateFrustum()
+{
+    auto view = InverseAffine( CreateTranslate( Vector3( 0.0f, 0.0f, -50.0f ) ) );
+    auto projection = CreatePerspectiveFovY( MathUtil::kPi / 4.0f, 16.0f / 9.0f, 0.1f, 200.0f );
+    Frustum frustum = {};
+    frustum.Build( view * projection, Vector3( -1.0f, -1.0f, 0.0f ), Vector3( 1.0f, 1.0f, 1.0f ) );
+    return frustum;
+}
+
+}  // namespace
+
+// SoAの一括判定は球と視錐台の判定と同じ結果になる
+TEST( LightCuller, PointMatchesSphereTest )
+{
+    std::mt19937 engine( 1 );
+    std::uniform_real_distribution<float> posDist( -300.0f, 300.0f );
+    std::uniform_real_distribution<float> radiusDist( 1.0f, 30.0f );
+
+    const uint32_t count = 2000;
+    LightCuller::PointLightSoA lights;
+    lights.Resize( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        lights.mX[i] = posDist( engine );
+        lights.mY[i] = posDist( engine );
+        lights.mZ[i] = posDist( engine );
+        lights.mRadius[i] = radiusDist( engine );
+    }
+
+    auto frustum = CreateFrustum();
+    LightCuller culler;
+    std::vector<uint32_t> visible;
+    culler.Cull( lights, frustum, visible );
+
+    std::vector<uint32_t> expected;
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        Sphere sphere = { Vector3( lights.mX[i], lights.mY[i], lights.mZ[i] ), lights.mRadius[i] };
+        if( Intersect( sphere, frustum ) ) expected.emplace_back( i );
+    }
+    EXPECT_TRUE( !expected.empty() );
+    EXPECT_TRUE( visible == expected );
+}
+
+// 視錐台の後ろを向いたスポットライトは球が入っていても除外される
+TEST( LightCuller, SpotFacingAwayIsCulled )
+{
+    LightCuller::SpotLightSoA lights;
+    lights.Resize( 2 );
+    // カメラの後ろ(視錐台のnearの手前)から前を向く
+    lights.Set( 0, Vector3( 0.0f, 0.0f, -60.0f ), Vector3( 0.0f, 0.0f, 1.0f ), 20.0f, 20.0f * MathUtil::kDegToRad );
+    // 同じ位置から後ろを向く
+    lights.Set( 1, Vector3( 0.0f, 0.0f, -60.0f ), Vector3( 0.0f, 0.0f, -1.0f ), 20.0f, 20.0f * MathUtil::kDegToRad );
+
+    LightCuller culler;
+    std::vector<uint32_t> visible;
+    culler.Cull( lights, CreateFrustum(), visible );
+    EXPECT_EQ( visible.size(), size_t( 1 ) );
+    EXPECT_TRUE( !visible.empty() && visible[0] == 0 );
+}
+
+// 部分視錐台の判定は可視なライトの部分集合を返す
+TEST( LightCuller, TileIsSubsetOfVisible )
+{
+    std::mt19937 engine( 2 );
+    std::uniform_real_distribution<float> posDist( -100.0f, 100.0f );
+
+    const uint32_t count = 500;
+    LightCuller::PointLightSoA lights;
+    lights.Resize( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        lights.mX[i] = posDist( engine );
+        lights.mY[i] = posDist( engine );
+        lights.mZ[i] = posDist( engine );
+        lights.mRadius[i] = 5.0f;
+    }
+
+    auto view = InverseAffine( CreateTranslate( Vector3( 0.0f, 0.0f, -50.0f ) ) );
+    auto projection = CreatePerspectiveFovY( MathUtil::kPi / 4.0f, 16.0f / 9.0f, 0.1f, 200.0f );
+    auto vpMat = view * projection;
+    auto frustum = CreateFrustum();
+    Frustum tile = {};
+    tile.Build( vpMat, Vector3( -1.0f, -1.0f, 0.0f ), Vector3( 0.0f, 0.0f, 1.0f ) );
+
+    LightCuller culler;
+    std::vector<uint32_t> visible;
+    culler.Cull( lights, frustum, visible );
+    std::vector<uint32_t> tileVisible;
+    culler.Cull( lights, visible, tile, tileVisible );
+
+    EXPECT_TRUE( !tileVisible.empty() );
+    EXPECT_TRUE( tileVisible.size() < visible.size() );
+    for( auto idx : tileVisible )
+    {
+        EXPECT_TRUE( std::find( visible.begin(), visible.end(), idx ) != visible.end() );
+    }
+}
+
+// スポットライトの部分集合の判定は部分視錐台で全体を判定した結果に一致する
+TEST( LightCuller, SpotTileMatchesFullCull )
+{
+    std::mt19937 engine( 3 );
+    std::uniform_real_distribution<float> posDist( -100.0f, 100.0f );
+    std::uniform_real_distribution<float> dirDist( -1.0f, 1.0f );
+    std::uniform_real_distribution<float> angleDist( 10.0f, 60.0f );
+
+    const uint32_t count = 500;
+    LightCuller::SpotLightSoA lights;
+    lights.Resize( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        auto position = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        auto direction = Vector3( dirDist( engine ), dirDist( engine ), dirDist( engine ) ) + Vector3( 0.0f, 0.0f, 0.01f );
+        lights.Set( i, position, direction, 20.0f, angleDist( engine ) * MathUtil::kDegToRad );
+    }
+
+    auto view = InverseAffine( CreateTranslate( Vector3( 0.0f, 0.0f, -50.0f ) ) );
+    auto projection = CreatePerspectiveFovY( MathUtil::kPi / 4.0f, 16.0f / 9.0f, 0.1f, 200.0f );
+    Frustum tile = {};
+    tile.Build( view * projection, Vector3( 0.0f, -1.0f, 0.0f ), Vector3( 1.0f, 0.0f, 1.0f ) );
+
+    LightCuller culler;
+    std::vector<uint32_t> visible;
+    culler.Cull( lights, CreateFrustum(), visible );
+    std::vector<uint32_t> tileVisible;
+    culler.Cull( lights, visible, tile, tileVisible );
+
+    // 部分視錐台の平面は視錐台の内側にあるので、全体を部分視錐台で判定しても同じになる
+    std::vector<uint32_t> expected;
+    culler.Cull( lights, tile, expected );
+    std::vector<uint32_t> expectedInVisible;
+    for( auto idx : expected )
+    {
+        if( std::find( visible.begin(), visible.end(), idx ) != visible.end() ) expectedInVisible.emplace_back( idx );
+    }
+    EXPECT_TRUE( !tileVisible.empty() );
+    EXPECT_TRUE( tileVisible.size() < visible.size() );
+    EXPECT_TRUE( tileVisible == expectedInVisible );
+}
+
+// 削除すると後ろの要素が詰められる
+TEST( LightCuller, EraseKeepsOrder )
+{
+    LightCuller::PointLightSoA lights;
+    lights.Resize( 3 );
+    for( uint32_t i = 0; i < 3; ++i )
+    {
+        lights.Set( i, Vector3( static_cast<float>( i ), 0.0f, 0.0f ), 1.0f + i );
+    }
+    lights.Erase( 1 );
+    EXPECT_EQ( lights.GetCount(), uint32_t( 2 ) );
+    EXPECT_EQ( lights.mX[0], 0.0f );
+    EXPECT_EQ( lights.mX[1], 2.0f );
+    EXPECT_EQ( lights.mRadius[1], 3.0f );
+
+    LightCuller::SpotLightSoA spots;
+    spots.Resize( 3 );
+    for( uint32_t i = 0; i < 3; ++i )
+    {
+        spots.Set( i, Vector3( static_cast<float>( i ), 0.0f, 0.0f ), Vector3( 0.0f, 0.0f, 1.0f ), 1.0f + i, 0.5f );
+    }
+    spots.Erase( 0 );
+    EXPECT_EQ( spots.GetCount(), uint32_t( 2 ) );
+    EXPECT_EQ( spots.mX[0], 1.0f );
+    EXPECT_EQ( spots.mRadius[1], 3.0f );
+    EXPECT_EQ( spots.mDirZ[1], 1.0f );
+}
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <cfloat>
+#include <random>
+
+#include "TestFramework.h"
+#include "graphics/model/DrawKey.h"
+
+namespace
+{
+
+const uint32_t kEntryCount = 5000;
+const uint32_t kMaterialCount = 64;
+const uint32_t kMeshCount = 32;
+const uint32_t kPSOCount = 5;
+// 半透明のマテリアルの割合(この数に1つ)
+const uint32_t kTransparentInterval = 8;
+
+// 比較関数でのソートと同じ並びの元になるアイテム
+struct Item
+{
+    RenderQueue mQueue;
+    float mDistance;
+    uint32_t mPSOId;
+    uint32_t mMaterial;
+    uint32_t mMesh;
+};
+
+// ばらばらのアイテムのキー
+void CreateEntries( std::vector<Item>& items, std::vector<DrawKey::Entry>& entries )
+{
+    // マテリアルとメッシュの代わりのアドレス(参照はしない)
+    static uint64_t materials[kMaterialCount];
+    static uint64_t meshes[kMeshCount];
+
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> distanceDist( 0.0f, 1000.0f );
+    std::uniform_int_distribution<uint32_t> materialDist( 0, kMaterialCount - 1 );
+    std::uniform_int_distribution<uint32_t> meshDist( 0, kMeshCount - 1 );
+    std::uniform_int_distribution<uint32_t> psoDist( 0, kPSOCount - 1 );
+    items.resize( kEntryCount );
+    entries.resize( kEntryCount );
+    for( uint32_t i = 0; i < kEntryCount; ++i )
+    {
+        auto& item = items[i];
+        item.mMaterial = materialDist( engine );
+        item.mMesh = meshDist( engine );
+        item.mQueue = item.mMaterial % kTransparentInterval == 0 ? RenderQueue::Transparent : RenderQueue::Opaque;
+        item.mDistance = distanceDist( engine );
+        item.mPSOId = psoDist( engine );
+        entries[i] = DrawKey::Entry{ DrawKey::Make( item.mQueue, item.mDistance, item.mPSOId, &materials[item.mMaterial], &meshes[item.mMesh] ), i };
+    }
+}
+
+}  // namespace
+
+// 基数ソートはキーの安定ソートと同じ並びになる
+TEST( DrawKey, RadixSortMatchesStableSort )
+{
+    std::vector<Item> items;
+    std::vector<DrawKey::Entry> entries;
+    CreateEntries( items, entries );
+
+    auto expected = entries;
+    std::stable_sort( expected.begin(), expected.end(), []( const DrawKey::Entry& a, const DrawKey::Entry& b ) { return a.mKey < b.mKey; } );
+    std::vector<DrawKey::Entry> temp;
+    DrawKey::RadixSort( entries, temp );
+
+    auto isSame = true;
+    for( uint32_t i = 0; i < kEntryCount; ++i )
+    {
+        isSame &= entries[i].mKey == expected[i].mKey && entries[i].mIndex == expected[i].mIndex;
+    }
+    EXPECT_TRUE( isSame );
+    EXPECT_EQ( DrawKey::CountDescents( entries ), 0u );
+}
+
+// キーの順はレンダーキューの順で、不透明は手前から、半透明は奥から
+TEST( DrawKey, KeyOrderFollowsRenderQueue )
+{
+    std::vector<Item> items;
+    std::vector<DrawKey::Entry> entries;
+    CreateEntries( items, entries );
+    std::vector<DrawKey::Entry> temp;
+    DrawKey::RadixSort( entries, temp );
+
+    auto isQueueSorted = true;
+    auto isOpaqueFrontToBack = true;
+    auto isTransparentBackToFront = true;
+    for( uint32_t i = 1; i < kEntryCount; ++i )
+    {
+        const auto& prev = items[entries[i - 1].mIndex];
+        const auto& curr = items[entries[i].mIndex];
+        isQueueSorted &= prev.mQueue <= curr.mQueue;
+        if( prev.mQueue != curr.mQueue ) continue;
+
+        if( curr.mQueue == RenderQueue::Opaque )
+        {
+            // 同じ段階の中はPSOなどでまとめるので、段階の単位まで
+            isOpaqueFrontToBack &= static_cast<uint32_t>( prev.mDistance / DrawKey::kDepthUnit ) <= static_cast<uint32_t>( curr.mDistance / DrawKey::kDepthUnit );
+            EXPECT_TRUE( DrawKey::IsOpaque( entries[i].mKey ) );
+        }
+        else
+        {
+            isTransparentBackToFront &= prev.mDistance >= curr.mDistance;
+            EXPECT_FALSE( DrawKey::IsOpaque( entries[i].mKey ) );
+        }
+    }
+    EXPECT_TRUE( isQueueSorted );
+    EXPECT_TRUE( isOpaqueFrontToBack );
+    EXPECT_TRUE( isTransparentBackToFront );
+}
+
+// 並びの乱れは前より小さくなる位置の数
+TEST( DrawKey, CountDescents )
+{
+    std::vector<DrawKey::Entry> entries;
+    EXPECT_EQ( DrawKey::CountDescents( entries ), 0u );
+
+    for( uint64_t key : { 1, 3, 3, 2, 5, 4, 4, 0 } )
+    {
+        entries.emplace_back( DrawKey::Entry{ key, static_cast<uint32_t>( entries.size() ) } );
+    }
+    // 3→2、5→4、4→0 の3か所(同じキーは乱れではない)
+    EXPECT_EQ( DrawKey::CountDescents( entries ), 3u );
+
+    // 逆順なら全ての位置
+    std::vector<DrawKey::Entry> reversed;
+    for( uint32_t i = 0; i < 100; ++i )
+    {
+        reversed.emplace_back( DrawKey::Entry{ 100 - i, i } );
+    }
+    EXPECT_EQ( DrawKey::CountDescents( reversed ), 99u );
+}
+
+// ほぼ並んだ組の挿入ソートは安定ソートと同じ並びになり、動かした回数は転倒の数
+TEST( DrawKey, InsertionSortMatchesStableSort )
+{
+    std::vector<Item> items;
+    std::vector<DrawKey::Entry> entries;
+    CreateEntries( items, entries );
+    std::vector<DrawKey::Entry> temp;
+    DrawKey::RadixSort( entries, temp );
+
+    // 前フレームの並びで距離が少し変わったように、隣どうしを入れ替える
+    std::mt19937 engine( 54321 );
+    std::uniform_int_distribution<uint32_t> posDist( 0, kEntryCount - 2 );
+    for( uint32_t i = 0; i < kEntryCount / 20; ++i )
+    {
+        auto pos = posDist( engine );
+        std::swap( entries[pos], entries[pos + 1] );
+    }
+    // 同じキーが並ぶ位置も作る(安定かどうか)
+    entries[10].mKey = entries[11].mKey;
+
+    auto expected = entries;
+    std::stable_sort( expected.begin(), expected.end(), []( const DrawKey::Entry& a, const DrawKey::Entry& b ) { return a.mKey < b.mKey; } );
+    uint64_t inversions = 0;
+    for( uint32_t i = 0; i < kEntryCount; ++i )
+    {
+        for( uint32_t j = i + 1; j < kEntryCount; ++j )
+        {
+            inversions += entries[i].mKey > entries[j].mKey ? 1 : 0;
+        }
+    }
+
+    uint64_t moves = 0;
+    EXPECT_TRUE( DrawKey::InsertionSort( entries, UINT64_MAX, moves ) );
+    EXPECT_EQ( moves, inversions );
+    auto isSame = true;
+    for( uint32_t i = 0; i < kEntryCount; ++i )
+    {
+        isSame &= entries[i].mKey == expected[i].mKey && entries[i].mIndex == expected[i].mIndex;
+    }
+    EXPECT_TRUE( isSame );
+    EXPECT_EQ( DrawKey::CountDescents( entries ), 0u );
+}
+
+// 動かす回数が上限を超えたら途中でやめ、組は入れ替わっただけで欠けない
+TEST( DrawKey, InsertionSortStopsAtMoveLimit )
+{
+    std::vector<DrawKey::Entry> entries;
+    for( uint32_t i = 0; i < 100; ++i )
+    {
+        entries.emplace_back( DrawKey::Entry{ 100 - i, i } );
+    }
+
+    uint64_t moves = 0;
+    EXPECT_FALSE( DrawKey::InsertionSort( entries, 50, moves ) );
+    EXPECT_TRUE( moves > 50 );
+    EXPECT_TRUE( moves < 100 );
+    EXPECT_TRUE( DrawKey::CountDescents( entries ) > 0 );
+
+    std::vector<uint32_t> indices;
+    for( const auto& entry : entries )
+    {
+        EXPECT_EQ( entry.mKey, uint64_t( 100 - entry.mIndex ) );
+        indices.emplace_back( entry.mIndex );
+    }
+    std::sort( indices.begin(), indices.end() );
+    auto isPermutation = true;
+    for( uint32_t i = 0; i < 100; ++i )
+    {
+        isPermutation &= indices[i] == i;
+    }
+    EXPECT_TRUE( isPermutation );
+
+    // 上限が十分なら並び終える
+    EXPECT_TRUE( DrawKey::InsertionSort( entries, UINT64_MAX, moves ) );
+    EXPECT_EQ( DrawKey::CountDescents( entries ), 0u );
+}
+
+// 距離の段階はどの分け方でも距離について単調で、近平面・遠平面の外は端の段階になる
+TEST( DrawKey, DepthBucketsAreMonotonicAndClamped )
+{
+    const float kNear = 0.1f;
+    const float kFar = 1000.0f;
+    const uint32_t kBucketCount = 256;
+    const DrawKey::DepthBucketing kBucketings[] = {
+        DrawKey::DepthBucketing::Linear,
+        DrawKey::DepthBucketing::Logarithmic,
+        DrawKey::DepthBucketing::Adaptive,
+        DrawKey::DepthBucketing::FixedCount,
+    };
+    for( auto bucketing : kBucketings )
+    {
+        // Adaptiveはそのフレームの最も近い・遠い距離を渡す
+        auto isAdaptive = bucketing == DrawKey::DepthBucketing::Adaptive;
+        auto minDistance = isAdaptive ? 20.0f : kNear;
+        auto maxDistance = isAdaptive ? 300.0f : kFar;
+        auto buckets = DrawKey::MakeDepthBuckets( bucketing, 2.0f, kBucketCount, minDistance, maxDistance );
+        auto maxBucket = bucketing == DrawKey::DepthBucketing::Linear ? DrawKey::kMaxQuantizedDepth : kBucketCount - 1;
+        EXPECT_EQ( buckets.mMaxBucket, maxBucket );
+
+        // 単調
+        auto isMonotonic = true;
+        uint32_t prevBucket = 0;
+        for( auto distance = 0.0f; distance < kFar * 2.0f; distance = distance * 1.01f + 0.01f )
+        {
+            auto bucket = DrawKey::QuantizeDepth( buckets, distance );
+            isMonotonic &= bucket >= prevBucket && bucket <= maxBucket;
+            prevBucket = bucket;
+        }
+        EXPECT_TRUE( isMonotonic );
+
+        // 範囲外は端
+        EXPECT_EQ( DrawKey::QuantizeDepth( buckets, -5.0f ), 0u );
+        EXPECT_EQ( DrawKey::QuantizeDepth( buckets, 0.0f ), 0u );
+        EXPECT_EQ( DrawKey::QuantizeDepth( buckets, FLT_MAX ), maxBucket );
+        if( bucketing != DrawKey::DepthBucketing::Linear )
+        {
+            EXPECT_EQ( DrawKey::QuantizeDepth( buckets, minDistance * 0.5f ), 0u );
+            EXPECT_EQ( DrawKey::QuantizeDepth( buckets, maxDistance ), maxBucket );
+            EXPECT_EQ( DrawKey::QuantizeDepth( buckets, maxDistance * 2.0f ), maxBucket );
+        }
+    }
+}
+
+// 分け方ごとの段階の幅
+TEST( DrawKey, DepthBucketWidths )
+{
+    // Linearは決まった幅
+    auto linear = DrawKey::MakeDepthBuckets( DrawKey::DepthBucketing::Linear, 2.0f, 0, 0.0f, 0.0f );
+    EXPECT_EQ( DrawKey::QuantizeDepth( linear, 1.9f ), 0u );
+    EXPECT_EQ( DrawKey::QuantizeDepth( linear, 2.1f ), 1u );
+    EXPECT_EQ( DrawKey::QuantizeDepth( linear, 101.0f ), 50u );
+
+    // 近平面から遠平面までを等分(中央は半分の段階)
+    auto fixed = DrawKey::MakeDepthBuckets( DrawKey::DepthBucketing::FixedCount, 0.0f, 100, 10.0f, 110.0f );
+    EXPECT_EQ( DrawKey::QuantizeDepth( fixed, 60.5f ), 50u );
+
+    // 対数は近いほど細かい(近平面と遠平面の相乗平均が半分の段階)
+    auto log = DrawKey::MakeDepthBuckets( DrawKey::DepthBucketing::Logarithmic, 0.0f, 100, 1.0f, 10000.0f );
+    EXPECT_EQ( DrawKey::QuantizeDepth( log, 100.5f ), 50u );
+    EXPECT_TRUE( DrawKey::QuantizeDepth( log, 11.0f ) - DrawKey::QuantizeDepth( log, 1.0f ) > DrawKey::QuantizeDepth( log, 1010.0f ) - DrawKey::QuantizeDepth( log, 1000.0f ) );
+
+    // 範囲が無ければ全て同じ段階
+    auto empty = DrawKey::MakeDepthBuckets( DrawKey::DepthBucketing::Adaptive, 0.0f, 100, 50.0f, 50.0f );
+    EXPECT_EQ( DrawKey::QuantizeDepth( empty, 10.0f ), 0u );
+    EXPECT_EQ( DrawKey::QuantizeDepth( empty, 90.0f ), 0u );
+}
+
+// 段階の置き換えは距離のビットだけを変え、半透明のキーは変えない
+TEST( DrawKey, SetDepthBucketKeepsOtherFields )
+{
+    std::vector<Item> items;
+    std::vector<DrawKey::Entry> entries;
+    CreateEntries( items, entries );
+
+    const auto kDepthMask = static_cast<uint64_t>( DrawKey::kMaxQuantizedDepth ) << DrawKey::kDepthShift;
+    const uint32_t kBuckets[] = { 0, 1, 12345, DrawKey::kMaxQuantizedDepth, DrawKey::kMaxQuantizedDepth + 1, UINT32_MAX };
+    auto isKept = true;
+    auto isTransparentSame = true;
+    for( const auto& entry : entries )
+    {
+        for( auto bucket : kBuckets )
+        {
+            auto key = DrawKey::SetDepthBucket( entry.mKey, bucket );
+            if( !DrawKey::IsOpaque( entry.mKey ) )
+            {
+                isTransparentSame &= key == entry.mKey;
+                continue;
+            }
+
+            isKept &= ( key & ~kDepthMask ) == ( entry.mKey & ~kDepthMask );
+            isKept &= DrawKey::IsOpaque( key );
+            isKept &= ( ( key & kDepthMask ) >> DrawKey::kDepthShift ) == ( std::min )( bucket, DrawKey::kMaxQuantizedDepth );
+        }
+    }
+    EXPECT_TRUE( isKept );
+    EXPECT_TRUE( isTransparentSame );
+
+    // 段階を入れたキーは段階の順に並ぶ(同じ段階の中は元のPSO・マテリアル・メッシュの順)
+    auto a = DrawKey::SetDepthBucket( DrawKey::Make( RenderQueue::Opaque, 0.0f, 1023, nullptr, nullptr ), 3 );
+    auto b = DrawKey::SetDepthBucket( DrawKey::Make( RenderQueue::Opaque, 900.0f, 0, nullptr, nullptr ), 4 );
+    EXPECT_TRUE( a < b );
+}
@@ -0,0 +1,108 @@
+#include "TestFramework.h"
+#include "graphics/model/InstanceGrouping.h"
+
+namespace
+{
+
+// ダミーのリソース(アドレスだけを比べる)
+const int kMeshA = 0;
+const int kMaterialA = 0;
+const int kVBA = 0;
+const int kVBB = 0;
+
+// まとめられるキー
+InstanceGrouping::Key MakeKey()
+{
+    InstanceGrouping::Key key = {};
+    key.mMesh = &kMeshA;
+    key.mMaterial = &kMaterialA;
+    key.mVB = &kVBA;
+    key.mPSOKey = 1;
+    key.mLod = 0;
+    key.mIndexOffset = 0;
+    key.mIndexCount = 0;
+    key.mCanInstance = true;
+    return key;
+}
+
+// 範囲を (先頭, 数) の並びで比べる
+bool IsRuns( const std::vector<InstanceGrouping::Run>& runs, std::initializer_list<InstanceGrouping::Run> expected )
+{
+    if( runs.size() != expected.size() ) return false;
+
+    size_t i = 0;
+    for( const auto& run : expected )
+    {
+        if( runs[i].mFirst != run.mFirst || runs[i].mCount != run.mCount ) return false;
+        ++i;
+    }
+    return true;
+}
+
+}  // namespace
+
+// 同じキーが続けば1つにまとめる
+TEST( InstanceGrouping, MergesIdenticalKeys )
+{
+    std::vector<InstanceGrouping::Key> keys( 5, MakeKey() );
+    std::vector<InstanceGrouping::Run> runs;
+    InstanceGrouping::Build( keys, 64, runs );
+    EXPECT_TRUE( IsRuns( runs, { { 0, 5 } } ) );
+
+    InstanceGrouping::Build( {}, 64, runs );
+    EXPECT_TRUE( runs.empty() );
+}
+
+// まとめられないアイテムで区切る
+TEST( InstanceGrouping, SplitsAtNonInstanceable )
+{
+    std::vector<InstanceGrouping::Key> keys( 5, MakeKey() );
+    keys[2].mCanInstance = false;
+    std::vector<InstanceGrouping::Run> runs;
+    InstanceGrouping::Build( keys, 64, runs );
+    EXPECT_TRUE( IsRuns( runs, { { 0, 2 }, { 2, 1 }, { 3, 2 } } ) );
+}
+
+// まとめられないアイテムが先頭の範囲に他のアイテムは続かない
+TEST( InstanceGrouping, NonInstanceableNeverStartsRun )
+{
+    std::vector<InstanceGrouping::Key> keys( 4, MakeKey() );
+    keys[0].mCanInstance = false;
+    keys[1].mCanInstance = false;
+    std::vector<InstanceGrouping::Run> runs;
+    InstanceGrouping::Build( keys, 64, runs );
+    EXPECT_TRUE( IsRuns( runs, { { 0, 1 }, { 1, 1 }, { 2, 2 } } ) );
+}
+
+// 最大数で区切る
+TEST( InstanceGrouping, SplitsAtMaxInstances )
+{
+    std::vector<InstanceGrouping::Key> keys( 7, MakeKey() );
+    std::vector<InstanceGrouping::Run> runs;
+    InstanceGrouping::Build( keys, 3, runs );
+    EXPECT_TRUE( IsRuns( runs, { { 0, 3 }, { 3, 3 }, { 6, 1 } } ) );
+
+    InstanceGrouping::Build( keys, 1, runs );
+    EXPECT_EQ( runs.size(), size_t( 7 ) );
+}
+
+// キーのどれか1つでも違えば区切る
+TEST( InstanceGrouping, SplitsOnAnyKeyField )
+{
+    std::vector<InstanceGrouping::Key> variants( 7, MakeKey() );
+    variants[0].mLod = 1;
+    variants[1].mIndexOffset = 6;
+    variants[2].mIndexCount = 36;
+    variants[3].mVB = &kVBB;
+    variants[4].mPSOKey = 2;
+    variants[5].mMesh = &kVBB;
+    variants[6].mMaterial = &kVBB;
+    for( const auto& variant : variants )
+    {
+        std::vector<InstanceGrouping::Key> keys = { MakeKey(), MakeKey(), variant, variant, MakeKey() };
+        std::vector<InstanceGrouping::Run> runs;
+        InstanceGrouping::Build( keys, 64, runs );
+        EXPECT_TRUE( IsRuns( runs, { { 0, 2 }, { 2, 2 }, { 4, 1 } } ) );
+        EXPECT_FALSE( InstanceGrouping::IsSameDraw( keys[0], variant ) );
+    }
+}
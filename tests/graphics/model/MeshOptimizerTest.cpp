@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include "TestFramework.h"
+#include "graphics/model/MeshOptimizer.h"
+
+namespace
+{
+
+// 頂点を作成
+MeshVertex MakeVertex( const Vector3& p, const Vector3& n )
+{
+    return MeshVertex{ Vector4( p.x, p.y, p.z, 1.0f ), n, Vector2( 0.0f, 0.0f ) };
+}
+
+// 三角形ごとに頂点を持つ(統合前の)UV球
+void CreateUnweldedSphere( uint32_t slices, uint32_t stacks, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices )
+{
+    auto point = [&]( uint32_t s, uint32_t t )
+    {
+        // 極は1点にまとめる(浮動小数点の誤差で別の頂点にならないように)
+        if( t == 0 ) return Vector3( 0.0f, 1.0f, 0.0f );
+        if( t == stacks ) return Vector3( 0.0f, -1.0f, 0.0f );
+        auto theta = MathUtil::kPi * t / stacks;
+        auto phi = 2.0f * MathUtil::kPi * ( s % slices ) / slices;
+        return Vector3( std::sin( theta ) * std::cos( phi ), std::cos( theta ), std::sin( theta ) * std::sin( phi ) );
+    };
+    vertices.clear();
+    indices.clear();
+    for( uint32_t t = 0; t < stacks; ++t )
+    {
+        for( uint32_t s = 0; s < slices; ++s )
+        {
+            Vector3 quad[4] = { point( s, t ), point( s + 1, t ), point( s + 1, t + 1 ), point( s, t + 1 ) };
+            const uint32_t tri[6] = { 0, 1, 2, 0, 2, 3 };
+            for( auto k : tri )
+            {
+                // 極の退化した三角形も含めてそのまま残す
+                indices.emplace_back( static_cast<uint32_t>( vertices.size() ) );
+                vertices.emplace_back( MakeVertex( quad[k], quad[k] ) );
+            }
+        }
+    }
+}
+
+// 巻き順を保ったまま先頭を最小の頂点にそろえた三角形の一覧(並び順によらない比較用)
+using Triangle = std::array<std::array<float, 3>, 3>;
+std::vector<Triangle> GetTriangleSet( const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices )
+{
+    std::vector<Triangle> triangles;
+    for( size_t i = 0; i + 2 < indices.size(); i += 3 )
+    {
+        Triangle tri = {};
+        for( uint32_t k = 0; k < 3; ++k )
+        {
+            const auto& p = vertices[indices[i + k]].mPosition;
+            tri[k] = { p.x, p.y, p.z };
+        }
+        auto first = std::min_element( tri.begin(), tri.end() ) - tri.begin();
+        std::rotate( tri.begin(), tri.begin() + first, tri.end() );
+        triangles.emplace_back( tri );
+    }
+    std::sort( triangles.begin(), triangles.end() );
+    return triangles;
+}
+
+}  // namespace
+
+// 位置・法線・UVがすべて同じ頂点だけが統合される
+TEST( MeshOptimizer, WeldCount )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateUnweldedSphere( 8, 4, vertices, indices );
+    // 球面上の格子点は (stacks - 1) * slices + 極2つ
+    auto expected = static_cast<uint32_t>( vertices.size() ) - ( 3 * 8 + 2 );
+    EXPECT_EQ( MeshOptimizer::WeldVertices( vertices, indices, nullptr ), expected );
+    EXPECT_EQ( vertices.size(), size_t( 3 * 8 + 2 ) );
+
+    // 法線が違えば統合しない
+    std::vector<MeshVertex> split = {
+        MakeVertex( Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ) ),
+        MakeVertex( Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ) ),
+        MakeVertex( Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ) ),
+    };
+    std::vector<uint32_t> splitIndices = { 0, 1, 2 };
+    EXPECT_EQ( MeshOptimizer::WeldVertices( split, splitIndices, nullptr ), 1u );
+    EXPECT_EQ( splitIndices[2], 0u );
+
+    // スキンの影響が違えば統合しない
+    std::vector<MeshVertex> skinned( 2, MakeVertex( Vector3( 1.0f, 2.0f, 3.0f ), Vector3( 0.0f, 1.0f, 0.0f ) ) );
+    std::vector<SkinInfluence> influences( 2, SkinInfluence{} );
+    Skinning::AddInfluence( influences[0], 0, 1.0f );
+    Skinning::AddInfluence( influences[1], 1, 1.0f );
+    std::vector<uint32_t> skinnedIndices = { 0, 1, 0 };
+    EXPECT_EQ( MeshOptimizer::WeldVertices( skinned, skinnedIndices, &influences ), 0u );
+}
+
+// 各段の並び替えは三角形の集合(巻き順を含む)を変えない
+TEST( MeshOptimizer, ReorderKeepsTriangles )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateUnweldedSphere( 24, 16, vertices, indices );
+    MeshOptimizer::WeldVertices( vertices, indices, nullptr );
+
+    // 入力順の局所性をなくす
+    std::mt19937 engine( 3 );
+    std::vector<uint32_t> order( indices.size() / 3 );
+    for( uint32_t i = 0; i < order.size(); ++i )
+    {
+        order[i] = i;
+    }
+    std::shuffle( order.begin(), order.end(), engine );
+    std::vector<uint32_t> shuffled;
+    for( auto t : order )
+    {
+        shuffled.insert( shuffled.end(), indices.begin() + t * 3, indices.begin() + t * 3 + 3 );
+    }
+    indices = std::move( shuffled );
+    auto expected = GetTriangleSet( vertices, indices );
+    auto vertexCount = static_cast<uint32_t>( vertices.size() );
+    auto before = MeshOptimizer::AnalyzeVertexCache( indices, vertexCount );
+
+    std::vector<uint32_t> clusters;
+    MeshOptimizer::OptimizeVertexCache( indices, vertexCount, clusters );
+    EXPECT_TRUE( GetTriangleSet( vertices, indices ) == expected );
+    EXPECT_TRUE( !clusters.empty() && clusters[0] == 0 );
+    EXPECT_TRUE( std::is_sorted( clusters.begin(), clusters.end() ) );
+    auto afterCache = MeshOptimizer::AnalyzeVertexCache( indices, vertexCount );
+    EXPECT_TRUE( afterCache.mACMR < before.mACMR );
+
+    MeshOptimizer::OptimizeOverdraw( indices, vertices, clusters );
+    EXPECT_TRUE( GetTriangleSet( vertices, indices ) == expected );
+    auto afterOverdraw = MeshOptimizer::AnalyzeVertexCache( indices, vertexCount );
+    EXPECT_TRUE( afterOverdraw.mACMR <= afterCache.mACMR * MeshOptimizer::kOverdrawThreshold );
+
+    MeshOptimizer::OptimizeVertexFetch( vertices, indices, nullptr );
+    EXPECT_TRUE( GetTriangleSet( vertices, indices ) == expected );
+    // 頂点は最初に使われる順
+    uint32_t nextNew = 0;
+    for( auto idx : indices )
+    {
+        EXPECT_TRUE( idx <= nextNew );
+        if( idx == nextNew ) ++nextNew;
+    }
+    EXPECT_EQ( nextNew, static_cast<uint32_t>( vertices.size() ) );
+}
+
+// 四角形は短い方の対角線で分ける
+TEST( MeshOptimizer, QuadSplitsShorterDiagonal )
+{
+    auto up = Vector3( 0.0f, 1.0f, 0.0f );
+    // 0-2 が短い(横に潰れたひし形)
+    std::vector<MeshVertex> vertices = {
+        MakeVertex( Vector3( -1.0f, 0.0f, 0.0f ), up ),
+        MakeVertex( Vector3( 0.0f, 0.0f, 3.0f ), up ),
+        MakeVertex( Vector3( 1.0f, 0.0f, 0.0f ), up ),
+        MakeVertex( Vector3( 0.0f, 0.0f, -3.0f ), up ),
+    };
+    const uint32_t quad[4] = { 0, 1, 2, 3 };
+    std::vector<uint32_t> indices;
+    MeshOptimizer::TriangulateQuad( vertices, quad, indices );
+    EXPECT_TRUE( ( indices == std::vector<uint32_t>{ 0, 1, 2, 2, 3, 0 } ) );
+
+    // 1-3 が短い
+    vertices[1].mPosition = Vector4( 0.0f, 0.0f, 0.5f, 1.0f );
+    vertices[3].mPosition = Vector4( 0.0f, 0.0f, -0.5f, 1.0f );
+    indices.clear();
+    MeshOptimizer::TriangulateQuad( vertices, quad, indices );
+    EXPECT_TRUE( ( indices == std::vector<uint32_t>{ 0, 1, 3, 1, 2, 3 } ) );
+}
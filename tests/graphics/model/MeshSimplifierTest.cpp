@@ -0,0 +1,199 @@
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "TestFramework.h"
+#include "graphics/model/MeshSimplifier.h"
+
+namespace
+{
+
+// 頂点を作成
+MeshVertex MakeVertex( const Vector3& p, const Vector3& n )
+{
+    return MeshVertex{ Vector4( p.x, p.y, p.z, 1.0f ), n, Vector2( 0.0f, 0.0f ) };
+}
+
+// 頂点を共有するUV球(縫い目・極の重複なし)
+void CreateSphere( uint32_t slices, uint32_t stacks, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices )
+{
+    vertices.clear();
+    indices.clear();
+    vertices.emplace_back( MakeVertex( Vector3( 0.0f, 1.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ) ) );
+    for( uint32_t t = 1; t < stacks; ++t )
+    {
+        for( uint32_t s = 0; s < slices; ++s )
+        {
+            auto theta = MathUtil::kPi * t / stacks;
+            auto phi = 2.0f * MathUtil::kPi * s / slices;
+            auto p = Vector3( std::sin( theta ) * std::cos( phi ), std::cos( theta ), std::sin( theta ) * std::sin( phi ) );
+            vertices.emplace_back( MakeVertex( p, p ) );
+        }
+    }
+    vertices.emplace_back( MakeVertex( Vector3( 0.0f, -1.0f, 0.0f ), Vector3( 0.0f, -1.0f, 0.0f ) ) );
+    auto south = static_cast<uint32_t>( vertices.size() - 1 );
+
+    auto ring = [&]( uint32_t t, uint32_t s )
+    {
+        return 1 + ( t - 1 ) * slices + s % slices;
+    };
+    for( uint32_t s = 0; s < slices; ++s )
+    {
+        indices.insert( indices.end(), { 0, ring( 1, s + 1 ), ring( 1, s ) } );
+        indices.insert( indices.end(), { south, ring( stacks - 1, s ), ring( stacks - 1, s + 1 ) } );
+    }
+    for( uint32_t t = 1; t + 1 < stacks; ++t )
+    {
+        for( uint32_t s = 0; s < slices; ++s )
+        {
+            indices.insert( indices.end(), { ring( t, s ), ring( t, s + 1 ), ring( t + 1, s + 1 ) } );
+            indices.insert( indices.end(), { ring( t, s ), ring( t + 1, s + 1 ), ring( t + 1, s ) } );
+        }
+    }
+}
+
+// XZ平面上の格子(開いた境界を持つ)
+void CreatePlane( uint32_t size, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices )
+{
+    vertices.clear();
+    indices.clear();
+    for( uint32_t z = 0; z <= size; ++z )
+    {
+        for( uint32_t x = 0; x <= size; ++x )
+        {
+            vertices.emplace_back( MakeVertex( Vector3( static_cast<float>( x ), 0.0f, static_cast<float>( z ) ), Vector3( 0.0f, 1.0f, 0.0f ) ) );
+        }
+    }
+    for( uint32_t z = 0; z < size; ++z )
+    {
+        for( uint32_t x = 0; x < size; ++x )
+        {
+            auto v = z * ( size + 1 ) + x;
+            indices.insert( indices.end(), { v, v + size + 1, v + 1 } );
+            indices.insert( indices.end(), { v + 1, v + size + 1, v + size + 2 } );
+        }
+    }
+}
+
+// インデックスが頂点の範囲内で、潰れた三角形が無いか
+bool IsValidIndices( const std::vector<uint32_t>& indices, size_t begin, size_t count, size_t vertexCount )
+{
+    if( count % 3 != 0 || begin + count > indices.size() ) return false;
+    for( size_t i = begin; i < begin + count; i += 3 )
+    {
+        auto a = indices[i];
+        auto b = indices[i + 1];
+        auto c = indices[i + 2];
+        if( a >= vertexCount || b >= vertexCount || c >= vertexCount ) return false;
+        if( a == b || b == c || c == a ) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+// 目標の数まで三角形が減り、インデックスは有効なまま
+TEST( MeshSimplifier, ReducesTriangles )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateSphere( 32, 16, vertices, indices );
+    auto originalCount = indices.size();
+
+    auto target = static_cast<uint32_t>( originalCount / 4 / 3 * 3 );
+    MeshSimplifier::Simplify( vertices, indices, target );
+    EXPECT_TRUE( indices.size() <= target );
+    EXPECT_TRUE( indices.size() > 0 );
+    EXPECT_TRUE( IsValidIndices( indices, 0, indices.size(), vertices.size() ) );
+}
+
+// 平面はどれだけ減らしても形が変わらないので誤差は0
+TEST( MeshSimplifier, PlanarErrorIsZero )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreatePlane( 16, vertices, indices );
+    auto originalCount = indices.size();
+
+    auto error = MeshSimplifier::Simplify( vertices, indices, static_cast<uint32_t>( originalCount / 4 / 3 * 3 ) );
+    EXPECT_TRUE( indices.size() < originalCount / 2 );
+    EXPECT_NEAR( error, 0.0f, 1e-5f );
+    EXPECT_TRUE( IsValidIndices( indices, 0, indices.size(), vertices.size() ) );
+}
+
+// 曲面は減らすほど誤差が大きくなり、形状の大きさは超えない
+TEST( MeshSimplifier, ErrorGrowsWithReduction )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> original;
+    CreateSphere( 32, 16, vertices, original );
+
+    auto prevError = 0.0f;
+    for( auto ratio : { 0.5f, 0.25f, 0.125f } )
+    {
+        auto indices = original;
+        auto target = static_cast<uint32_t>( original.size() / 3 * ratio ) * 3;
+        auto error = MeshSimplifier::Simplify( vertices, indices, target );
+        EXPECT_TRUE( error > 0.0f );
+        EXPECT_TRUE( error >= prevError );
+        EXPECT_TRUE( error < 1.0f );
+        prevError = error;
+    }
+}
+
+// LODは詳細度の順に三角形が減り、範囲とインデックスが有効
+TEST( MeshSimplifier, LodRangesAreValid )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateSphere( 32, 16, vertices, indices );
+
+    std::vector<MeshLod> lods;
+    std::vector<uint32_t> lodIndices;
+    MeshSimplifier::GenerateLods( vertices, indices, lods, lodIndices );
+    EXPECT_TRUE( !lods.empty() );
+
+    auto prevCount = static_cast<uint32_t>( indices.size() );
+    uint32_t offset = 0;
+    for( const auto& lod : lods )
+    {
+        EXPECT_EQ( lod.mIndexOffset, offset );
+        EXPECT_TRUE( lod.mIndexCount < prevCount );
+        EXPECT_TRUE( IsValidIndices( lodIndices, lod.mIndexOffset, lod.mIndexCount, vertices.size() ) );
+        prevCount = lod.mIndexCount;
+        offset += lod.mIndexCount;
+    }
+    EXPECT_EQ( offset, static_cast<uint32_t>( lodIndices.size() ) );
+}
+
+// 切り替える大きさは誤差から求まり、そこでの画面上の誤差が許容誤差になる
+TEST( MeshSimplifier, ScreenSizeFollowsError )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateSphere( 32, 16, vertices, indices );
+
+    std::vector<MeshLod> lods;
+    std::vector<uint32_t> lodIndices;
+    MeshSimplifier::GenerateLods( vertices, indices, lods, lodIndices );
+    EXPECT_TRUE( !lods.empty() );
+
+    // 単位球のAABBの対角線の半分
+    auto radius = std::sqrt( 3.0f );
+    auto prevScreenSize = FLT_MAX;
+    for( const auto& lod : lods )
+    {
+        EXPECT_TRUE( lod.mError > 0.0f );
+        EXPECT_TRUE( lod.mScreenSize <= prevScreenSize );
+        EXPECT_TRUE( lod.mScreenSize <= MeshSimplifier::ComputeScreenSize( lod.mError, radius ) * 1.0001f );
+        prevScreenSize = lod.mScreenSize;
+    }
+
+    // 直径の比sで表示したとき、誤差の比は s * e / 2r
+    auto error = 0.01f;
+    auto screenSize = MeshSimplifier::ComputeScreenSize( error, radius );
+    EXPECT_NEAR( screenSize * error / ( 2.0f * radius ), MeshSimplifier::kLodScreenError, 1e-7f );
+    // 誤差が倍になれば半分の大きさまで待つ
+    EXPECT_NEAR( MeshSimplifier::ComputeScreenSize( error * 2.0f, radius ), screenSize * 0.5f, 1e-5f );
+    EXPECT_TRUE( MeshSimplifier::ComputeScreenSize( 0.0f, radius ) == FLT_MAX );
+}
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "TestFramework.h"
+#include "graphics/model/MeshletBuilder.h"
+#include "graphics/model/MeshletCuller.h"
+
+namespace
+{
+
+// y = 0 の平面の格子(法線は+y)
+void CreateGrid( uint32_t size, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices )
+{
+    vertices.clear();
+    indices.clear();
+    for( uint32_t z = 0; z <= size; ++z )
+    {
+        for( uint32_t x = 0; x <= size; ++x )
+        {
+            vertices.emplace_back( MeshVertex{ Vector4( float( x ), 0.0f, float( z ), 1.0f ), Vector3::kUnitY, Vector2( 0.0f, 0.0f ) } );
+        }
+    }
+    for( uint32_t z = 0; z < size; ++z )
+    {
+        for( uint32_t x = 0; x < size; ++x )
+        {
+            auto v00 = z * ( size + 1 ) + x;
+            auto v10 = v00 + 1;
+            auto v01 = v00 + size + 1;
+            auto v11 = v01 + 1;
+            indices.insert( indices.end(), { v00, v01, v10, v10, v01, v11 } );
+        }
+    }
+}
+
+// UV球
+void CreateSphere( uint32_t slices, uint32_t stacks, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices )
+{
+    vertices.clear();
+    indices.clear();
+    for( uint32_t t = 0; t <= stacks; ++t )
+    {
+        for( uint32_t s = 0; s <= slices; ++s )
+        {
+            auto theta = MathUtil::kPi * t / stacks;
+            auto phi = 2.0f * MathUtil::kPi * s / slices;
+            auto p = Vector3( std::sin( theta ) * std::cos( phi ), std::cos( theta ), std::sin( theta ) * std::sin( phi ) );
+            vertices.emplace_back( MeshVertex{ Vector4( p.x, p.y, p.z, 1.0f ), p, Vector2( 0.0f, 0.0f ) } );
+        }
+    }
+    for( uint32_t t = 0; t < stacks; ++t )
+    {
+        for( uint32_t s = 0; s < slices; ++s )
+        {
+            auto v00 = t * ( slices + 1 ) + s;
+            auto v10 = v00 + 1;
+            auto v01 = v00 + slices + 1;
+            auto v11 = v01 + 1;
+            indices.insert( indices.end(), { v00, v10, v01, v10, v11, v01 } );
+        }
+    }
+}
+
+// 巻き順を保ったまま先頭を最小のインデックスにそろえた三角形
+std::vector<std::array<uint32_t, 3>> GetTriangleSet( const std::vector<uint32_t>& indices )
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for( size_t i = 0; i + 2 < indices.size(); i += 3 )
+    {
+        std::array<uint32_t, 3> tri = { indices[i], indices[i + 1], indices[i + 2] };
+        auto first = std::min_element( tri.begin(), tri.end() ) - tri.begin();
+        std::rotate( tri.begin(), tri.begin() + first, tri.end() );
+        triangles.emplace_back( tri );
+    }
+    std::sort( triangles.begin(), triangles.end() );
+    return triangles;
+}
+
+// カメラからの設定
+MeshletCuller::Params CreateParams( const Vector3& eye, const Vector3& target, const Vector3& up )
+{
+    MeshletCuller::Params params = {};
+    auto view = CreateLookAt( eye, target, up );
+    auto projection = CreatePerspectiveFovY( MathUtil::kPi / 2.0f, 1.0f, 0.1f, 1000.0f );
+    params.Build( Matrix4(), view, projection );
+    params.mUseCone = true;
+    return params;
+}
+
+}  // namespace
+
+// 頂点数と三角形数の上限を守り、範囲は連続してすべてのインデックスを覆う
+TEST( Meshlet, RespectsLimits )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateSphere( 48, 32, vertices, indices );
+
+    std::vector<Meshlet> meshlets;
+    MeshletBuilder::Build( vertices, indices, meshlets );
+    EXPECT_TRUE( meshlets.size() > 1 );
+
+    uint32_t offset = 0;
+    for( const auto& meshlet : meshlets )
+    {
+        EXPECT_EQ( meshlet.mIndexOffset, offset );
+        EXPECT_EQ( meshlet.mIndexCount % 3, 0u );
+        EXPECT_TRUE( meshlet.mIndexCount > 0 );
+        EXPECT_TRUE( meshlet.mIndexCount / 3 <= MeshletBuilder::kMaxTriangles );
+
+        std::vector<uint32_t> used( indices.begin() + meshlet.mIndexOffset, indices.begin() + meshlet.mIndexOffset + meshlet.mIndexCount );
+        std::sort( used.begin(), used.end() );
+        auto uniqueCount = static_cast<uint32_t>( std::unique( used.begin(), used.end() ) - used.begin() );
+        EXPECT_EQ( meshlet.mVertexCount, uniqueCount );
+        EXPECT_TRUE( uniqueCount <= MeshletBuilder::kMaxVertices );
+        offset += meshlet.mIndexCount;
+    }
+    EXPECT_EQ( offset, static_cast<uint32_t>( indices.size() ) );
+}
+
+// すべての三角形がちょうど1回ずつ出力される
+TEST( Meshlet, EmitsEveryTriangleOnce )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateSphere( 40, 20, vertices, indices );
+    auto expected = GetTriangleSet( indices );
+
+    std::vector<Meshlet> meshlets;
+    MeshletBuilder::Build( vertices, indices, meshlets );
+    EXPECT_TRUE( GetTriangleSet( indices ) == expected );
+}
+
+// 平面の裏側から見るとメッシュレットは円錐で除外され、表側からは残る
+TEST( Meshlet, ConeRejectsBackFacing )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateGrid( 4, vertices, indices );
+    std::vector<Meshlet> meshlets;
+    MeshletBuilder::Build( vertices, indices, meshlets );
+    EXPECT_EQ( meshlets.size(), size_t( 1 ) );
+    EXPECT_TRUE( meshlets[0].mConeCutoff < 1.0f );
+    EXPECT_NEAR( meshlets[0].mConeAxis.y, 1.0f, 1e-5f );
+
+    MeshletCuller culler;
+    std::vector<MeshletCuller::IndexRange> ranges;
+
+    // 下(裏側)から見上げる
+    culler.Cull( meshlets, CreateParams( Vector3( 2.0f, -5.0f, 2.0f ), Vector3( 2.0f, 0.0f, 2.0f ), Vector3::kUnitZ ), ranges );
+    EXPECT_TRUE( ranges.empty() );
+    EXPECT_EQ( culler.GetStats().mConeCulledMeshlets, 1u );
+
+    // 上(表側)から見下ろす
+    culler.Cull( meshlets, CreateParams( Vector3( 2.0f, 5.0f, 2.0f ), Vector3( 2.0f, 0.0f, 2.0f ), Vector3::kUnitZ ), ranges );
+    EXPECT_EQ( ranges.size(), size_t( 1 ) );
+    EXPECT_EQ( culler.GetStats().mVisibleMeshlets, 1u );
+
+    // 両面描画なら裏側からでも残る
+    auto params = CreateParams( Vector3( 2.0f, -5.0f, 2.0f ), Vector3( 2.0f, 0.0f, 2.0f ), Vector3::kUnitZ );
+    params.mUseCone = false;
+    culler.Cull( meshlets, params, ranges );
+    EXPECT_EQ( ranges.size(), size_t( 1 ) );
+}
+
+// 球の裏半分のメッシュレットは円錐で除外され、表の三角形はすべて残る
+TEST( Meshlet, SphereBackHalfIsConeCulled )
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    CreateSphere( 48, 32, vertices, indices );
+    std::vector<Meshlet> meshlets;
+    MeshletBuilder::Build( vertices, indices, meshlets );
+
+    auto eye = Vector3( 0.0f, 0.0f, -20.0f );
+    MeshletCuller culler;
+    std::vector<MeshletCuller::IndexRange> ranges;
+    culler.Cull( meshlets, CreateParams( eye, Vector3::kZero, Vector3::kUnitY ), ranges );
+    EXPECT_TRUE( culler.GetStats().mConeCulledMeshlets > 0 );
+
+    // 表向きの三角形は可視な範囲に含まれる(保守的)
+    std::vector<uint8_t> isVisible( indices.size() / 3, 0 );
+    for( const auto& range : ranges )
+    {
+        for( auto i = range.mIndexOffset; i < range.mIndexOffset + range.mIndexCount; i += 3 )
+        {
+            isVisible[i / 3] = 1;
+        }
+    }
+    uint32_t missing = 0;
+    for( size_t t = 0; t < indices.size() / 3; ++t )
+    {
+        auto p0 = vertices[indices[t * 3 + 0]].mPosition;
+        auto p1 = vertices[indices[t * 3 + 1]].mPosition;
+        auto p2 = vertices[indices[t * 3 + 2]].mPosition;
+        auto a = Vector3( p0.x, p0.y, p0.z );
+        auto normal = Cross( Vector3( p1.x, p1.y, p1.z ) - a, Vector3( p2.x, p2.y, p2.z ) - a );
+        if( LengthSq( normal ) <= 0.0f ) continue;
+        // 頂点の法線の側を表とする(ComputeBoundsと同じ)
+        if( Dot( normal, vertices[indices[t * 3]].mNormal ) < 0.0f ) normal = -normal;
+        if( Dot( normal, a - eye ) < 0.0f && !isVisible[t] ) ++missing;
+    }
+    EXPECT_EQ( missing, 0u );
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "TestFramework.h"
+#include "graphics/model/NodeHierarchy.h"
+
+namespace
+{
+
+const uint32_t kNodeCount = 500;
+const uint32_t kMaxChildren = 4;
+
+// 幅優先で子を付けた木(親は必ず先に並ぶ)
+void CreateTree( NodeHierarchy& hierarchy )
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<float> posDist( -1.0f, 1.0f );
+    std::uniform_real_distribution<float> angleDist( -0.5f, 0.5f );
+    std::uniform_int_distribution<uint32_t> childDist( 1, kMaxChildren );
+    uint32_t nextParent = 0;
+    uint32_t childrenLeft = 0;
+    for( uint32_t i = 0; i < kNodeCount; ++i )
+    {
+        int32_t parent = NodeHierarchy::kInvalidIndex;
+        if( i > 0 )
+        {
+            if( childrenLeft == 0 )
+            {
+                childrenLeft = childDist( engine );
+                ++nextParent;
+            }
+            parent = static_cast<int32_t>( nextParent - 1 );
+            --childrenLeft;
+        }
+        auto rotate = Quaternion( Normalize( Vector3( posDist( engine ), posDist( engine ), posDist( engine ) ) ), angleDist( engine ) );
+        auto translate = Vector3( posDist( engine ), posDist( engine ), posDist( engine ) );
+        hierarchy.AddNode( "node", parent, Vector3( 1.0f, 1.0f, 1.0f ), rotate, translate );
+    }
+}
+
+// 親を辿ってモデル行列を求める
+Matrix4 ComputeModelMatrix( const NodeHierarchy& hierarchy, const NodePose& pose, int32_t idx )
+{
+    auto localMat = CreateAffine( pose.mScales[idx], pose.mRotates[idx], pose.mTranslates[idx] );
+    auto parent = hierarchy.GetParent( idx );
+    return parent == NodeHierarchy::kInvalidIndex ? localMat : localMat * ComputeModelMatrix( hierarchy, pose, parent );
+}
+
+// 全てのノードのモデル行列の最大の誤差
+float GetMaxError( const NodeHierarchy& hierarchy, const NodePose& pose )
+{
+    auto maxError = 0.0f;
+    for( uint32_t i = 0; i < hierarchy.GetCount(); ++i )
+    {
+        auto expected = ComputeModelMatrix( hierarchy, pose, static_cast<int32_t>( i ) );
+        for( uint32_t r = 0; r < 4; ++r )
+        {
+            for( uint32_t c = 0; c < 4; ++c )
+            {
+                maxError = ( std::max )( maxError, std::abs( pose.mModelMats[i].m[r][c] - expected.m[r][c] ) );
+            }
+        }
+    }
+    return maxError;
+}
+
+}  // namespace
+
+// 先頭から1回なめた結果が、親を辿って掛けた結果と一致する
+TEST( NodeHierarchy, MatchesRecursiveUpdate )
+{
+    NodeHierarchy hierarchy;
+    CreateTree( hierarchy );
+    NodePose pose;
+    hierarchy.CreatePose( pose );
+    pose.MarkAllDirty();
+    EXPECT_EQ( hierarchy.UpdateModelMatrices( pose ), kNodeCount );
+    EXPECT_TRUE( GetMaxError( hierarchy, pose ) < 1e-4f );
+}
+
+// 変更したノードの子孫だけを更新する
+TEST( NodeHierarchy, UpdatesDirtySubtree )
+{
+    NodeHierarchy hierarchy;
+    CreateTree( hierarchy );
+    NodePose pose;
+    hierarchy.CreatePose( pose );
+    pose.MarkAllDirty();
+    hierarchy.UpdateModelMatrices( pose );
+
+    // 変更がなければ何もしない
+    auto version = pose.mVersion;
+    EXPECT_EQ( hierarchy.UpdateModelMatrices( pose ), 0u );
+    EXPECT_EQ( pose.mVersion, version );
+
+    // ノード1とその子孫の数
+    const int32_t dirtyIdx = 1;
+    std::vector<uint8_t> isDescendant( kNodeCount, 0 );
+    uint32_t subtreeCount = 0;
+    for( uint32_t i = 0; i < kNodeCount; ++i )
+    {
+        auto parent = hierarchy.GetParent( static_cast<int32_t>( i ) );
+        isDescendant[i] = static_cast<int32_t>( i ) == dirtyIdx || ( parent != NodeHierarchy::kInvalidIndex && isDescendant[parent] );
+        subtreeCount += isDescendant[i];
+    }
+
+    pose.mTranslates[dirtyIdx] = pose.mTranslates[dirtyIdx] + Vector3( 5.0f, 0.0f, 0.0f );
+    pose.MarkDirty( dirtyIdx );
+    EXPECT_EQ( hierarchy.UpdateModelMatrices( pose ), subtreeCount );
+    EXPECT_EQ( pose.mVersion, version + 1 );
+    EXPECT_TRUE( GetMaxError( hierarchy, pose ) < 1e-4f );
+}
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <random>
+
+#include "TestFramework.h"
+#include "graphics/model/StaticBatchBuilder.h"
+
+namespace
+{
+
+// 原点を中心とする1辺1の四角形(y = 0 の平面)
+const std::vector<MeshVertex> kQuadVertices = {
+    MeshVertex{ Vector4( -0.5f, 0.0f, -0.5f, 1.0f ), Vector3::kUnitY, Vector2( 0.0f, 0.0f ) },
+    MeshVertex{ Vector4( -0.5f, 0.0f, 0.5f, 1.0f ), Vector3::kUnitY, Vector2( 0.0f, 1.0f ) },
+    MeshVertex{ Vector4( 0.5f, 0.0f, -0.5f, 1.0f ), Vector3::kUnitY, Vector2( 1.0f, 0.0f ) },
+    MeshVertex{ Vector4( 0.5f, 0.0f, 0.5f, 1.0f ), Vector3::kUnitY, Vector2( 1.0f, 1.0f ) },
+};
+const std::vector<uint32_t> kQuadIndices = { 0, 1, 2, 2, 1, 3 };
+
+// 軸に沿った箱の視錐台(内側を向いた6枚の平面)
+Frustum CreateBoxFrustum( const Vector3& minP, const Vector3& maxP )
+{
+    Frustum frustum = {};
+    frustum.mPlanes[0] = Plane{ Vector3( 1.0f, 0.0f, 0.0f ), -minP.x };
+    frustum.mPlanes[1] = Plane{ Vector3( -1.0f, 0.0f, 0.0f ), maxP.x };
+    frustum.mPlanes[2] = Plane{ Vector3( 0.0f, 1.0f, 0.0f ), -minP.y };
+    frustum.mPlanes[3] = Plane{ Vector3( 0.0f, -1.0f, 0.0f ), maxP.y };
+    frustum.mPlanes[4] = Plane{ Vector3( 0.0f, 0.0f, 1.0f ), -minP.z };
+    frustum.mPlanes[5] = Plane{ Vector3( 0.0f, 0.0f, -1.0f ), maxP.z };
+    return frustum;
+}
+
+// セル(10単位)の中心に四角形を置いた 3x3 のバッチ(入力順はばらばら)
+StaticBatchBuilder::Batch CreateGridBatch()
+{
+    std::vector<StaticBatchBuilder::Source> sources;
+    for( uint32_t z = 0; z < 3; ++z )
+    {
+        for( uint32_t x = 0; x < 3; ++x )
+        {
+            StaticBatchBuilder::Source source = {};
+            source.mVertices = kQuadVertices;
+            source.mIndices = kQuadIndices;
+            source.mWorldMat = CreateTranslate( Vector3( x * 10.0f + 5.0f, 0.0f, z * 10.0f + 5.0f ) );
+            source.mBatchKey = 0;
+            sources.emplace_back( source );
+        }
+    }
+    std::mt19937 engine( 5 );
+    std::shuffle( sources.begin(), sources.end(), engine );
+
+    std::vector<StaticBatchBuilder::Batch> batches;
+    StaticBatchBuilder::Build( sources, 10.0f, batches );
+    return batches.empty() ? StaticBatchBuilder::Batch{} : std::move( batches[0] );
+}
+
+}  // namespace
+
+// セルはZ・Y・Xの順に並び、インデックスが連続する
+TEST( StaticBatchBuilder, CellsInZYXOrder )
+{
+    auto batch = CreateGridBatch();
+    EXPECT_EQ( batch.mCells.size(), size_t( 9 ) );
+
+    uint32_t offset = 0;
+    for( uint32_t i = 0; i < batch.mCells.size(); ++i )
+    {
+        const auto& cell = batch.mCells[i];
+        auto center = ( cell.mAABB.mMin + cell.mAABB.mMax ) * 0.5f;
+        EXPECT_NEAR( center.x, ( i % 3 ) * 10.0f + 5.0f, 1e-4f );
+        EXPECT_NEAR( center.z, ( i / 3 ) * 10.0f + 5.0f, 1e-4f );
+        EXPECT_EQ( cell.mIndexOffset, offset );
+        EXPECT_EQ( cell.mIndexCount, 6u );
+        offset += cell.mIndexCount;
+    }
+    EXPECT_EQ( offset, static_cast<uint32_t>( batch.mIndices.size() ) );
+}
+
+// インデックスが隣り合う可視なセルは1つの範囲にまとめる
+TEST( StaticBatchBuilder, CullMergesAdjacentCells )
+{
+    auto batch = CreateGridBatch();
+
+    // z の2行すべて(セル0～5)
+    std::vector<StaticBatchBuilder::IndexRange> ranges;
+    auto visible = StaticBatchBuilder::Cull( batch.mCells, CreateBoxFrustum( Vector3( -1.0f, -1.0f, -1.0f ), Vector3( 31.0f, 1.0f, 19.0f ) ), ranges );
+    EXPECT_EQ( visible, 6u );
+    EXPECT_EQ( ranges.size(), size_t( 1 ) );
+    if( ranges.size() == 1 )
+    {
+        EXPECT_EQ( ranges[0].mIndexOffset, 0u );
+        EXPECT_EQ( ranges[0].mIndexCount, 36u );
+        EXPECT_EQ( ranges[0].mFirstCell, 0u );
+        EXPECT_EQ( ranges[0].mCellCount, 6u );
+        // 範囲のAABBはセルのAABBの和
+        EXPECT_NEAR( ranges[0].mAABB.mMin.x, 4.5f, 1e-4f );
+        EXPECT_NEAR( ranges[0].mAABB.mMax.x, 25.5f, 1e-4f );
+        EXPECT_NEAR( ranges[0].mAABB.mMax.z, 15.5f, 1e-4f );
+    }
+}
+
+// インデックスが離れたセルはまとめない
+TEST( StaticBatchBuilder, CullKeepsNonAdjacentCellsApart )
+{
+    auto batch = CreateGridBatch();
+
+    // x の真ん中の列(セル1, 4, 7)
+    std::vector<StaticBatchBuilder::IndexRange> ranges;
+    auto visible = StaticBatchBuilder::Cull( batch.mCells, CreateBoxFrustum( Vector3( 11.0f, -1.0f, -1.0f ), Vector3( 19.0f, 1.0f, 31.0f ) ), ranges );
+    EXPECT_EQ( visible, 3u );
+    EXPECT_EQ( ranges.size(), size_t( 3 ) );
+    for( uint32_t i = 0; i < ranges.size(); ++i )
+    {
+        EXPECT_EQ( ranges[i].mFirstCell, 1 + i * 3 );
+        EXPECT_EQ( ranges[i].mCellCount, 1u );
+        EXPECT_EQ( ranges[i].mIndexOffset, batch.mCells[1 + i * 3].mIndexOffset );
+        EXPECT_EQ( ranges[i].mIndexCount, 6u );
+    }
+
+    // 何も見えなければ範囲なし
+    visible = StaticBatchBuilder::Cull( batch.mCells, CreateBoxFrustum( Vector3( 100.0f, -1.0f, -1.0f ), Vector3( 110.0f, 1.0f, 1.0f ) ), ranges );
+    EXPECT_EQ( visible, 0u );
+    EXPECT_TRUE( ranges.empty() );
+}
@@ -0,0 +1,215 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "TestFramework.h"
+#include "graphics/model/VertexCompression.h"
+
+namespace
+{
+
+// 球面上に一様な単位ベクトル
+Vector3 RandomUnitVector( std::mt19937& rng )
+{
+    std::uniform_real_distribution<float> dist( -1.0f, 1.0f );
+    for( ;; )
+    {
+        auto v = Vector3( dist( rng ), dist( rng ), dist( rng ) );
+        auto lengthSq = LengthSq( v );
+        if( lengthSq > 1e-4f && lengthSq <= 1.0f ) return v / std::sqrt( lengthSq );
+    }
+}
+
+// 2つの単位ベクトルのなす角(弦の長さから求めるので小さな角でも精度が落ちない)
+float AngleBetween( const Vector3& a, const Vector3& b )
+{
+    return 2.0f * std::asin( ( std::min )( Length( a - b ) * 0.5f, 1.0f ) );
+}
+
+// 箱の中にばらまいた頂点
+std::vector<MeshVertex> CreateVertices( uint32_t count, const Vector3& center, const Vector3& halfSize, std::mt19937& rng )
+{
+    std::uniform_real_distribution<float> dist( -1.0f, 1.0f );
+    std::uniform_real_distribution<float> uvDist( -4.0f, 4.0f );
+    std::vector<MeshVertex> vertices( count );
+    for( auto& vertex : vertices )
+    {
+        auto p = center + Vector3( dist( rng ) * halfSize.x, dist( rng ) * halfSize.y, dist( rng ) * halfSize.z );
+        vertex.mPosition = Vector4( p.x, p.y, p.z, 1.0f );
+        vertex.mNormal = RandomUnitVector( rng );
+        vertex.mUV = Vector2( uvDist( rng ), uvDist( rng ) );
+    }
+    return vertices;
+}
+
+// 16bit浮動小数の丸め誤差の上限(正規化数は相対で2^-11、非正規化数は絶対で2^-25)
+float HalfError( float value )
+{
+    return ( std::max )( std::fabs( value ) * std::ldexp( 1.0f, -11 ), std::ldexp( 1.0f, -25 ) );
+}
+
+}  // namespace
+
+// 1頂点のサイズはフラグの組み合わせどおり
+TEST( VertexCompression, Stride )
+{
+    EXPECT_EQ( VertexCompression::GetStride( MeshFlags::Required ), uint32_t( sizeof( MeshVertex ) ) );
+    EXPECT_EQ( VertexCompression::GetStride( MeshFlags::Required | MeshFlags::Compact ), uint32_t( 8 + 4 + 4 ) );
+    EXPECT_EQ( VertexCompression::GetStride( MeshFlags::Required | MeshFlags::QuantizedPosition ), uint32_t( 8 + 12 + 8 ) );
+}
+
+// 圧縮しなければそのまま戻る
+TEST( VertexCompression, UncompressedIsExact )
+{
+    std::mt19937 rng( 1 );
+    auto vertices = CreateVertices( 100, Vector3( 3.0f, -2.0f, 5.0f ), Vector3( 10.0f, 1.0f, 4.0f ), rng );
+    std::vector<uint8_t> data;
+    Matrix4 dequantizeMat;
+    VertexCompression::Encode( MeshFlags::Required, vertices, data, dequantizeMat );
+    EXPECT_EQ( data.size(), vertices.size() * sizeof( MeshVertex ) );
+
+    for( size_t i = 0; i < vertices.size(); ++i )
+    {
+        auto decoded = VertexCompression::Decode( MeshFlags::Required, data.data() + i * sizeof( MeshVertex ), dequantizeMat );
+        EXPECT_TRUE( decoded.mPosition.x == vertices[i].mPosition.x && decoded.mPosition.y == vertices[i].mPosition.y && decoded.mPosition.z == vertices[i].mPosition.z );
+        EXPECT_TRUE( decoded.mNormal.x == vertices[i].mNormal.x && decoded.mNormal.y == vertices[i].mNormal.y && decoded.mNormal.z == vertices[i].mNormal.z );
+        EXPECT_TRUE( decoded.mUV.x == vertices[i].mUV.x && decoded.mUV.y == vertices[i].mUV.y );
+    }
+}
+
+// 量子化した位置の誤差は軸ごとに量子化の幅の半分まで
+TEST( VertexCompression, QuantizedPositionError )
+{
+    std::mt19937 rng( 2 );
+    auto halfSize = Vector3( 50.0f, 0.5f, 8.0f );
+    auto vertices = CreateVertices( 2000, Vector3( 100.0f, -20.0f, 3.0f ), halfSize, rng );
+    // AABBの端の頂点も含める
+    vertices[0].mPosition = Vector4( 50.0f, -20.5f, -5.0f, 1.0f );
+    vertices[1].mPosition = Vector4( 150.0f, -19.5f, 11.0f, 1.0f );
+
+    auto flags = MeshFlags::Required | MeshFlags::QuantizedPosition;
+    auto stride = VertexCompression::GetStride( flags );
+    std::vector<uint8_t> data;
+    Matrix4 dequantizeMat;
+    VertexCompression::Encode( flags, vertices, data, dequantizeMat );
+    EXPECT_EQ( data.size(), vertices.size() * stride );
+
+    // 量子化の幅の半分と、行列で戻すときの浮動小数の誤差
+    auto step = halfSize / VertexCompression::kSnorm16Max;
+    auto bound = step * 0.5f + Vector3( 1.0f, 1.0f, 1.0f ) * ( 150.0f * 4e-7f );
+    for( size_t i = 0; i < vertices.size(); ++i )
+    {
+        auto decoded = VertexCompression::Decode( flags, data.data() + i * stride, dequantizeMat );
+        EXPECT_TRUE( std::fabs( decoded.mPosition.x - vertices[i].mPosition.x ) <= bound.x );
+        EXPECT_TRUE( std::fabs( decoded.mPosition.y - vertices[i].mPosition.y ) <= bound.y );
+        EXPECT_TRUE( std::fabs( decoded.mPosition.z - vertices[i].mPosition.z ) <= bound.z );
+        EXPECT_NEAR( decoded.mPosition.w, 1.0f, 0.0f );
+    }
+}
+
+// 幅の無い軸も壊れない
+TEST( VertexCompression, QuantizedFlatAxis )
+{
+    std::vector<MeshVertex> vertices( 3 );
+    vertices[0].mPosition = Vector4( 0.0f, 2.0f, 0.0f, 1.0f );
+    vertices[1].mPosition = Vector4( 1.0f, 2.0f, 0.0f, 1.0f );
+    vertices[2].mPosition = Vector4( 0.0f, 2.0f, 1.0f, 1.0f );
+
+    auto flags = MeshFlags::Required | MeshFlags::QuantizedPosition;
+    auto stride = VertexCompression::GetStride( flags );
+    std::vector<uint8_t> data;
+    Matrix4 dequantizeMat;
+    VertexCompression::Encode( flags, vertices, data, dequantizeMat );
+    for( size_t i = 0; i < vertices.size(); ++i )
+    {
+        auto decoded = VertexCompression::Decode( flags, data.data() + i * stride, dequantizeMat );
+        EXPECT_NEAR( decoded.mPosition.x, vertices[i].mPosition.x, 1e-4f );
+        EXPECT_NEAR( decoded.mPosition.y, 2.0f, 1e-6f );
+        EXPECT_NEAR( decoded.mPosition.z, vertices[i].mPosition.z, 1e-4f );
+    }
+}
+
+// 八面体写像の法線の角度の誤差
+TEST( VertexCompression, OctahedralNormalError )
+{
+    // 各成分の誤差は量子化の幅の半分、zは|x|+|y|から決まるので3次元の誤差は√6倍まで
+    // 正規化で最大√3倍に広がる(八面体の面上の点は原点から1/√3以上離れている)
+    auto bound = std::sqrt( 18.0f ) * 0.5f / VertexCompression::kSnorm16Max + 1e-6f;
+
+    std::mt19937 rng( 3 );
+    auto maxError = 0.0f;
+    auto check = [&]( const Vector3& normal )
+    {
+        int16_t encoded[2] = {};
+        VertexCompression::EncodeOctahedral( normal, encoded );
+        auto decoded = VertexCompression::DecodeOctahedral( encoded );
+        EXPECT_NEAR( Length( decoded ), 1.0f, 1e-6f );
+        maxError = ( std::max )( maxError, AngleBetween( normal, decoded ) );
+    };
+    for( uint32_t i = 0; i < 20000; ++i )
+    {
+        check( RandomUnitVector( rng ) );
+    }
+    // 軸上と折り返しの境目
+    const Vector3 axes[] = {
+        Vector3( 1.0f, 0.0f, 0.0f ), Vector3( -1.0f, 0.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ),
+        Vector3( 0.0f, -1.0f, 0.0f ), Vector3( 0.0f, 0.0f, 1.0f ), Vector3( 0.0f, 0.0f, -1.0f ),
+        Normalize( Vector3( 1.0f, 1.0f, 0.0f ) ), Normalize( Vector3( -1.0f, 1.0f, -1e-7f ) ), Normalize( Vector3( 1.0f, -1.0f, -1.0f ) ),
+    };
+    for( const auto& axis : axes )
+    {
+        check( axis );
+    }
+    EXPECT_TRUE( maxError <= bound );
+}
+
+// 16bit浮動小数のUVの誤差
+TEST( VertexCompression, HalfUVError )
+{
+    // 半精度で表せる値はそのまま戻る
+    for( auto value : { 0.0f, 1.0f, -1.0f, 0.5f, 0.25f, 2048.0f, 65504.0f, std::ldexp( 1.0f, -24 ) } )
+    {
+        EXPECT_TRUE( VertexCompression::HalfToFloat( VertexCompression::FloatToHalf( value ) ) == value );
+    }
+    // 範囲外は無限大
+    EXPECT_TRUE( std::isinf( VertexCompression::HalfToFloat( VertexCompression::FloatToHalf( 70000.0f ) ) ) );
+
+    std::mt19937 rng( 4 );
+    std::uniform_real_distribution<float> dist( -8.0f, 8.0f );
+    std::uniform_real_distribution<float> exponentDist( -20.0f, 0.0f );
+    for( uint32_t i = 0; i < 20000; ++i )
+    {
+        // 大きな値と0付近の小さな値
+        auto value = i % 2 == 0 ? dist( rng ) : std::exp2( exponentDist( rng ) ) * ( dist( rng ) < 0.0f ? -1.0f : 1.0f );
+        auto decoded = VertexCompression::HalfToFloat( VertexCompression::FloatToHalf( value ) );
+        EXPECT_TRUE( std::fabs( decoded - value ) <= HalfError( value ) );
+    }
+}
+
+// 全ての圧縮を組み合わせても、それぞれの誤差に収まる
+TEST( VertexCompression, CompactVertexError )
+{
+    std::mt19937 rng( 5 );
+    auto halfSize = Vector3( 2.0f, 3.0f, 1.0f );
+    auto vertices = CreateVertices( 1000, Vector3( 0.0f, 1.0f, 0.0f ), halfSize, rng );
+
+    auto flags = MeshFlags::Required | MeshFlags::Compact;
+    auto stride = VertexCompression::GetStride( flags );
+    std::vector<uint8_t> data;
+    Matrix4 dequantizeMat;
+    VertexCompression::Encode( flags, vertices, data, dequantizeMat );
+    EXPECT_EQ( data.size(), vertices.size() * stride );
+
+    auto positionBound = Length( halfSize ) * ( 0.5f / VertexCompression::kSnorm16Max + 1e-6f );
+    auto normalBound = std::sqrt( 18.0f ) * 0.5f / VertexCompression::kSnorm16Max + 1e-6f;
+    for( size_t i = 0; i < vertices.size(); ++i )
+    {
+        const auto& src = vertices[i];
+        auto decoded = VertexCompression::Decode( flags, data.data() + i * stride, dequantizeMat );
+        auto d = Vector3( decoded.mPosition.x - src.mPosition.x, decoded.mPosition.y - src.mPosition.y, decoded.mPosition.z - src.mPosition.z );
+        EXPECT_TRUE( Length( d ) <= positionBound );
+        EXPECT_TRUE( AngleBetween( decoded.mNormal, src.mNormal ) <= normalBound );
+        EXPECT_TRUE( std::fabs( decoded.mUV.x - src.mUV.x ) <= HalfError( src.mUV.x ) );
+        EXPECT_TRUE( std::fabs( decoded.mUV.y - src.mUV.y ) <= HalfError( src.mUV.y ) );
+    }
+}